@@ -99,7 +99,9 @@ bool LifeCycle::StartComponents() {
                                               profile::Profile::instance()->message_frequency_count(),
                                               profile::Profile::instance()->malformed_message_filtering(),
                                               profile::Profile::instance()->malformed_frequency_time(),
-                                              profile::Profile::instance()->malformed_frequency_count());
+                                              profile::Profile::instance()->malformed_frequency_count(),
+                                              profile::Profile::instance()->inbound_workers_count(),
+                                              profile::Profile::instance()->outgoing_workers_count());
   DCHECK(protocol_handler_ != NULL);
 
   connection_handler_ =
@@ -119,7 +121,14 @@ bool LifeCycle::StartComponents() {
   DCHECK(hmi_handler_ != NULL)
 
 #ifdef ENABLE_SECURITY
-  security_manager_ = new security_manager::SecurityManagerImpl();
+  int32_t handshake_workers_count;
+  profile::Profile::instance()->ReadIntValue(
+        &handshake_workers_count,
+        security_manager::SecurityManagerImpl::kDefaultHandshakeWorkersCount,
+        security_manager::SecurityManagerImpl::ConfigSection(),
+        "HandshakeWorkersCount");
+  security_manager_ = new security_manager::SecurityManagerImpl(
+      handshake_workers_count > 0 ? handshake_workers_count : 1);
 
   // FIXME(EZamakhov): move to Config or in Sm initialization method
   std::string cert_filename;
@@ -42,6 +42,7 @@
 
 #include "application_manager/hmi_command_factory.h"
 #include "application_manager/application_manager.h"
+#include "application_manager/application_registry.h"
 #include "application_manager/hmi_capabilities.h"
 #include "application_manager/message.h"
 #include "application_manager/message_helper.h"
@@ -79,6 +80,7 @@
 #include "utils/lock.h"
 #include "utils/singleton.h"
 #include "utils/data_accessor.h"
+#include "utils/file_storage.h"
 
 namespace NsSmartDeviceLink {
 namespace NsSmartObjects {
@@ -183,6 +185,8 @@ class ApplicationManagerImpl
 
   friend class ResumeCtrl;
   friend class CommandImpl;
+  FRIEND_TEST(ApplicationManagerImplTest,
+              SendMessageToMobile_ResponseFailedToSerialize_RequestCompleted);
 
 public:
   ~ApplicationManagerImpl();
@@ -209,6 +213,13 @@ public:
   std::vector<ApplicationSharedPtr> applications_by_ivi(uint32_t vehicle_info);
   std::vector<ApplicationSharedPtr> applications_with_navi();
 
+  /**
+   * @brief Updates subscription indexes after application subscribed to or
+   * unsubscribed from vehicle data or button
+   * @param app_id id of application
+   */
+  void OnSubscriptionsChanged(uint32_t app_id);
+
   /**
    * @brief Returns media application with LIMITED HMI Level if exist.
    *
@@ -598,6 +609,18 @@ public:
   void SendMessageToMobile(const commands::MessageSharedPtr message,
                            bool final_message = false);
 
+  /**
+   * @brief Sends the same notification to several applications.
+   * Policy permissions are checked per application, but the message is
+   * serialized only once per protocol family and resulting bytes are
+   * shared by the messages to all connections
+   * @param message Notification without correlation id and binary data
+   * @param applications Recipients of notification
+   */
+  void MulticastNotificationToMobile(
+      const commands::MessageSharedPtr message,
+      const std::vector<ApplicationSharedPtr>& applications);
+
   /**
    * @brief TerminateRequest forces termination of request
    * @param connection_key - application id of request
@@ -803,6 +826,17 @@ public:
                                         const std::string &file_name,
                                         const int64_t offset);
 
+  /**
+   * @brief Delete file saved by SaveBinary
+   *
+   * @param file_path path of directory containing file
+   * @param file_name File name
+   *
+   * @return true if file was deleted
+   */
+  bool DeleteBinary(const std::string &file_path,
+                    const std::string &file_name);
+
   /**
    * @brief Get available app space
    * @param name of the app folder(make + mobile app id)
@@ -966,10 +1000,12 @@ public:
 
     void Erase(ApplicationSharedPtr app_to_remove) {
       ApplicationManagerImpl::instance()->applications_.erase(app_to_remove);
+      ApplicationManagerImpl::instance()->registry_.Erase(app_to_remove);
     }
 
     void Insert(ApplicationSharedPtr app_to_insert) {
       ApplicationManagerImpl::instance()->applications_.insert(app_to_insert);
+      ApplicationManagerImpl::instance()->registry_.Insert(app_to_insert);
     }
 
     bool Empty() {
@@ -982,14 +1018,6 @@ public:
 
   friend class ApplicationListAccessor;
 
-  struct AppIdPredicate {
-    uint32_t app_id_;
-    AppIdPredicate(uint32_t app_id) : app_id_(app_id) {}
-    bool operator()(const ApplicationSharedPtr app) const {
-      return app ? app_id_ == app->app_id() : false;
-    }
-  };
-
   struct HmiAppIdPredicate {
     uint32_t hmi_app_id_;
     HmiAppIdPredicate(uint32_t hmi_app_id) : hmi_app_id_(hmi_app_id) {}
@@ -998,24 +1026,6 @@ public:
     }
   };
 
-  struct MobileAppIdPredicate {
-    std::string policy_app_id_;
-    MobileAppIdPredicate(const std::string &policy_app_id)
-        : policy_app_id_(policy_app_id) {}
-    bool operator()(const ApplicationSharedPtr app) const {
-      return app ? policy_app_id_ == app->mobile_app_id() : false;
-    }
-  };
-
-  struct SubscribedToButtonPredicate {
-    mobile_apis::ButtonName::eType button_;
-    SubscribedToButtonPredicate(mobile_apis::ButtonName::eType button)
-        : button_(button) {}
-    bool operator()(const ApplicationSharedPtr app) const {
-      return app ? app->IsSubscribedToButton(button_) : false;
-    }
-  };
-
   struct AppV4DevicePredicate {
     connection_handler::DeviceHandle handle_;
     AppV4DevicePredicate(const connection_handler::DeviceHandle handle)
@@ -1037,15 +1047,6 @@ public:
     }
   };
 
-  struct SubscribedToIVIPredicate {
-    int32_t vehicle_info_;
-    SubscribedToIVIPredicate(int32_t vehicle_info)
-        : vehicle_info_(vehicle_info) {}
-    bool operator()(const ApplicationSharedPtr app) const {
-      return app ? app->IsSubscribedToIVI(vehicle_info_) : false;
-    }
-  };
-
   /**
    * @brief Sends UpdateAppList notification to HMI
    */
@@ -1107,6 +1108,15 @@ private:
                           smart_objects::SmartObject &output);
   bool ConvertSOtoMessage(const smart_objects::SmartObject &message,
                           Message &output);
+
+  /**
+   * @brief Serializes notification once and posts it to all recipients
+   * @param message Notification to serialize
+   * @param recipients Applications using protocol of the same family
+   */
+  void PostMulticastNotification(
+      const commands::MessageSharedPtr message,
+      const std::vector<ApplicationSharedPtr>& recipients);
   utils::SharedPtr<Message>
   ConvertRawMsgToMessage(const ::protocol_handler::RawMessagePtr message);
 
@@ -1305,6 +1315,12 @@ private:
   ApplictionSet applications_;
   AppsWaitRegistrationSet apps_to_register_;
 
+  /**
+   * @brief Indexes of applications list for lookups by ids and HMI level,
+   * changed together with applications list
+   */
+  ApplicationRegistry registry_;
+
   // Lock for applications list
   mutable sync_primitives::Lock applications_list_lock_;
   mutable sync_primitives::Lock apps_to_register_list_lock_;
@@ -1394,6 +1410,11 @@ private:
 
   timer::TimerThread<ApplicationManagerImpl> tts_global_properties_timer_;
 
+  // Writes binaries of PutFile chunks keeping descriptors of recent files
+  file_system::ChunkedFileWriter binary_writer_;
+  // Sizes of apps folders, updated on each saved and deleted binary
+  file_system::DirectorySizeCache storage_usage_;
+
   bool is_low_voltage_;
   volatile bool is_stopping_;
 
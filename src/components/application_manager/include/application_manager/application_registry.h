@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_APPLICATION_MANAGER_INCLUDE_APPLICATION_MANAGER_APPLICATION_REGISTRY_H_
+#define SRC_COMPONENTS_APPLICATION_MANAGER_INCLUDE_APPLICATION_MANAGER_APPLICATION_REGISTRY_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "application_manager/application.h"
+#include "utils/lock.h"
+#include "utils/macro.h"
+#include "utils/shared_ptr.h"
+
+namespace application_manager {
+
+/**
+ * @brief Indexes of registered applications.
+ * Readers take an immutable snapshot, so lookups do not wait for
+ * registration, unregistration or HMI level changes. Every change copies
+ * the current snapshot, modifies the copy and publishes it.
+ */
+class ApplicationRegistry {
+ public:
+  typedef std::map<uint32_t, ApplicationSharedPtr> AppIdIndex;
+  typedef std::map<std::string, ApplicationSharedPtr> PolicyAppIdIndex;
+  // Ordered by application id as applications list is
+  typedef std::map<uint32_t, ApplicationSharedPtr> AppsById;
+  // Vehicle data type or button name to subscribed applications
+  typedef std::map<uint32_t, AppsById> SubscriptionIndex;
+
+  struct Snapshot {
+    AppIdIndex by_app_id;
+    AppIdIndex by_hmi_app_id;
+    PolicyAppIdIndex by_policy_app_id;
+    ApplicationSharedPtr full_app;
+    AppsById limited_apps;
+    SubscriptionIndex by_vehicle_info;
+    SubscriptionIndex by_button;
+  };
+  typedef utils::SharedPtr<const Snapshot> SnapshotPtr;
+
+  ApplicationRegistry();
+
+  /**
+   * @brief Current snapshot, keeps being valid after later changes
+   */
+  SnapshotPtr snapshot() const;
+
+  ApplicationSharedPtr application(uint32_t app_id) const;
+  ApplicationSharedPtr application_by_hmi_app(uint32_t hmi_app_id) const;
+  ApplicationSharedPtr application_by_policy_id(
+      const std::string& policy_app_id) const;
+
+  /**
+   * @brief Application in HMI_FULL
+   */
+  ApplicationSharedPtr active_application() const;
+
+  /**
+   * @brief First application in HMI_LIMITED
+   */
+  ApplicationSharedPtr limited_application() const;
+  ApplicationSharedPtr limited_navi_application() const;
+  ApplicationSharedPtr limited_voice_application() const;
+
+  /**
+   * @brief Applications subscribed to vehicle data type
+   */
+  std::vector<ApplicationSharedPtr> applications_by_ivi(
+      uint32_t vehicle_info) const;
+
+  /**
+   * @brief Applications subscribed to button
+   */
+  std::vector<ApplicationSharedPtr> applications_by_button(
+      uint32_t button) const;
+
+  /**
+   * @brief Adds application to indexes, its ids must be already set
+   */
+  void Insert(ApplicationSharedPtr app);
+
+  /**
+   * @brief Removes application from indexes
+   */
+  void Erase(ApplicationSharedPtr app);
+
+  /**
+   * @brief Moves application to FULL/LIMITED slots according to its
+   * current HMI level
+   */
+  void OnHMILevelChanged(ApplicationSharedPtr app);
+
+  /**
+   * @brief Reindexes vehicle data and button subscriptions of application
+   * @param app_id id of application, ignored if it is not registered
+   */
+  void OnSubscriptionsChanged(uint32_t app_id);
+
+ private:
+  void Publish(Snapshot* snapshot);
+  static void UpdateHMILevel(ApplicationSharedPtr app, Snapshot* snapshot);
+  static void UpdateSubscriptions(ApplicationSharedPtr app,
+                                  Snapshot* snapshot);
+  static void RemoveSubscriptions(uint32_t app_id, Snapshot* snapshot);
+
+  // Serializes changes
+  sync_primitives::Lock update_lock_;
+  // Guards snapshot pointer copy only
+  mutable sync_primitives::SpinMutex snapshot_lock_;
+  SnapshotPtr snapshot_;
+
+  DISALLOW_COPY_AND_ASSIGN(ApplicationRegistry);
+};
+
+}  // namespace application_manager
+
+#endif  // SRC_COMPONENTS_APPLICATION_MANAGER_INCLUDE_APPLICATION_MANAGER_APPLICATION_REGISTRY_H_
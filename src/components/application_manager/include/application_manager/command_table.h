@@ -0,0 +1,88 @@
+/*
+ Copyright (c) 2015, Ford Motor Company
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following
+ disclaimer in the documentation and/or other materials provided with the
+ distribution.
+
+ Neither the name of the Ford Motor Company nor the names of its contributors
+ may be used to endorse or promote products derived from this software
+ without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_APPLICATION_MANAGER_INCLUDE_APPLICATION_MANAGER_COMMAND_TABLE_H_
+#define SRC_COMPONENTS_APPLICATION_MANAGER_INCLUDE_APPLICATION_MANAGER_COMMAND_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "application_manager/commands/command.h"
+
+namespace application_manager {
+
+typedef commands::Command* (*CommandCreator)(
+    const commands::MessageSharedPtr& message);
+
+template <typename CommandType>
+commands::Command* NewCommand(const commands::MessageSharedPtr& message) {
+  return new CommandType(message);
+}
+
+/**
+ * @brief Commands created for function per message type,
+ * NULL if function has no command for message type.
+ * Tables of them are generated from interface xml
+ * by tools/InterfaceGenerator/CommandTableGenerator.py
+ */
+struct FunctionCommands {
+  int32_t function_id;
+  CommandCreator request;
+  CommandCreator response;
+  // Used for notifications and messages of other types
+  CommandCreator other;
+};
+
+/**
+ * @brief Rows of command table for consecutive function ids
+ * starting from first_function_id
+ */
+struct FunctionCommandsRange {
+  int32_t first_function_id;
+  const FunctionCommands* first;
+  size_t size;
+};
+
+/**
+ * @brief Finds commands of function in command table
+ * @param function_id id of function
+ * @param ranges ranges of command table
+ * @param ranges_count count of ranges
+ * @return commands of function or NULL if table has no row for it
+ */
+const FunctionCommands* FindFunctionCommands(
+    int32_t function_id, const FunctionCommandsRange* ranges,
+    size_t ranges_count);
+
+}  // namespace application_manager
+
+#endif  // SRC_COMPONENTS_APPLICATION_MANAGER_INCLUDE_APPLICATION_MANAGER_COMMAND_TABLE_H_
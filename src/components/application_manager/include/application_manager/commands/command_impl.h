@@ -35,6 +35,7 @@
 
 #include "application_manager/commands/command.h"
 #include "utils/logger.h"
+#include "utils/memory_pool.h"
 
 namespace application_manager {
 
@@ -51,9 +52,12 @@ struct CommandParametersPermissions {
 namespace commands {
 
 /**
- * @brief Class is intended to encapsulate RPC as an object
+ * @brief Class is intended to encapsulate RPC as an object.
+ * Commands are created and destroyed for every message, so they are
+ * allocated from memory pool objects of their own size instead of
+ * system heap.
  **/
-class CommandImpl : public Command {
+class CommandImpl : public Command, public utils::SizedPooledObject {
  public:
   /**
    * @brief CommandImpl class constructor
@@ -39,6 +39,7 @@
 #include "utils/shared_ptr.h"
 #include "protocol/message_priority.h"
 #include "protocol/rpc_type.h"
+#include "protocol/raw_message.h"
 #include "smart_objects/smart_object.h"
 
 namespace smart_objects = NsSmartDeviceLink::NsSmartObjects;
@@ -90,6 +91,11 @@ class Message {
   size_t data_size() const;
   size_t payload_size() const;
   const smart_objects::SmartObject& smart_object() const;
+  // Payload serialized once for several connections, replaces json
+  // message and binary data when set
+  const protocol_handler::SharedPayload& serialized_payload() const;
+  bool has_serialized_payload() const;
+  bool serialized_payload_has_binary_data() const;
 
   //! --------------------------------------------------------------------------
   void set_function_id(int32_t id);
@@ -102,6 +108,8 @@ class Message {
   void set_smart_object(const smart_objects::SmartObject& object);
   void set_data_size(size_t data_size);
   void set_payload_size(size_t payload_size);
+  void set_serialized_payload(const protocol_handler::SharedPayload& payload,
+                              bool has_binary_data = false);
 
   protocol_handler::MessagePriority Priority() const { return priority_; }
 
@@ -123,6 +131,8 @@ class Message {
   size_t data_size_;
   size_t payload_size_;
   ProtocolVersion version_;
+  protocol_handler::SharedPayload serialized_payload_;
+  bool serialized_payload_has_binary_data_;
 };
 }  // namespace application_manager
 
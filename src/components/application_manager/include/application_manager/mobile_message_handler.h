@@ -46,6 +46,28 @@ class MobileMessageHandler {
 
     static protocol_handler::RawMessage* HandleOutgoingMessageProtocol(
       const MobileMessage& message);
+
+    /**
+     * @brief Serializes message into bytes passed to protocol handler,
+     * result can be shared by messages sent to several connections
+     * @param message Message with json and binary data to serialize
+     * @return Serialized payload or empty pointer if message is ill-formed
+     */
+    static protocol_handler::SharedPayload SerializeOutgoingMessage(
+      const MobileMessage& message);
+
+    /**
+     * @brief Serializes formatted json and binary data straight into payload,
+     * space for binary header is reserved in front of json, so each part
+     * is copied only once
+     * @param message Message with protocol version and binary header fields
+     * @param json Json part of the message
+     * @param binary_data Binary part of the message or NULL
+     * @return Serialized payload or empty pointer if message is ill-formed
+     */
+    static protocol_handler::SharedPayload SerializeOutgoingMessage(
+      const Message& message, const std::string& json,
+      const BinaryData* binary_data);
     //! -------------------------------------------------------------
   private:
     static application_manager::Message* HandleIncomingMessageProtocolV1(
@@ -56,11 +78,12 @@ class MobileMessageHandler {
 
 	//! -------------------------------------------------------------
 
-    static protocol_handler::RawMessage* HandleOutgoingMessageProtocolV1(
-      const MobileMessage& message);
+    static protocol_handler::SharedPayload SerializeOutgoingMessageV1(
+      const std::string& json);
 
-    static protocol_handler::RawMessage* HandleOutgoingMessageProtocolV2(
-      const MobileMessage& message);
+    static protocol_handler::SharedPayload SerializeOutgoingMessageV2(
+      const Message& message, const std::string& json,
+      const BinaryData* binary_data);
 
     DISALLOW_COPY_AND_ASSIGN(MobileMessageHandler);
 };
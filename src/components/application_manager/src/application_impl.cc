@@ -635,7 +635,11 @@ const AppFile* ApplicationImpl::GetFile(const std::string& file_name) {
 bool ApplicationImpl::SubscribeToButton(mobile_apis::ButtonName::eType btn_name) {
   size_t old_size = subscribed_buttons_.size();
   subscribed_buttons_.insert(btn_name);
-  return (subscribed_buttons_.size() == old_size + 1);
+  if (subscribed_buttons_.size() == old_size) {
+    return false;
+  }
+  ApplicationManagerImpl::instance()->OnSubscriptionsChanged(app_id());
+  return true;
 }
 
 bool ApplicationImpl::IsSubscribedToButton(mobile_apis::ButtonName::eType btn_name) {
@@ -646,13 +650,21 @@ bool ApplicationImpl::IsSubscribedToButton(mobile_apis::ButtonName::eType btn_na
 bool ApplicationImpl::UnsubscribeFromButton(mobile_apis::ButtonName::eType btn_name) {
   size_t old_size = subscribed_buttons_.size();
   subscribed_buttons_.erase(btn_name);
-  return (subscribed_buttons_.size() == old_size - 1);
+  if (subscribed_buttons_.size() == old_size) {
+    return false;
+  }
+  ApplicationManagerImpl::instance()->OnSubscriptionsChanged(app_id());
+  return true;
 }
 
 bool ApplicationImpl::SubscribeToIVI(uint32_t vehicle_info_type_) {
   size_t old_size = subscribed_vehicle_info_.size();
   subscribed_vehicle_info_.insert(vehicle_info_type_);
-  return (subscribed_vehicle_info_.size() == old_size + 1);
+  if (subscribed_vehicle_info_.size() == old_size) {
+    return false;
+  }
+  ApplicationManagerImpl::instance()->OnSubscriptionsChanged(app_id());
+  return true;
 }
 
 bool ApplicationImpl::IsSubscribedToIVI(uint32_t vehicle_info_type_) {
@@ -664,7 +676,11 @@ bool ApplicationImpl::IsSubscribedToIVI(uint32_t vehicle_info_type_) {
 bool ApplicationImpl::UnsubscribeFromIVI(uint32_t vehicle_info_type_) {
   size_t old_size = subscribed_vehicle_info_.size();
   subscribed_vehicle_info_.erase(vehicle_info_type_);
-  return (subscribed_vehicle_info_.size() == old_size - 1);
+  if (subscribed_vehicle_info_.size() == old_size) {
+    return false;
+  }
+  ApplicationManagerImpl::instance()->OnSubscriptionsChanged(app_id());
+  return true;
 }
 
 UsageStatistics& ApplicationImpl::usage_report() {
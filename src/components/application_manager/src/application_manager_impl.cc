@@ -61,9 +61,31 @@
 #include <time.h>
 
 namespace {
+// Count of files kept open for writing their next chunks
+const size_t kMaxOpenBinaryFiles = 8;
+
 int get_rand_from_range(uint32_t from = 0, int to = RAND_MAX) {
   return std::rand() % to + from;
 }
+
+application_manager::RPCParams CollectRPCParams(
+    const NsSmartDeviceLink::NsSmartObjects::SmartObject& msg_params) {
+  application_manager::RPCParams params;
+  if (NsSmartDeviceLink::NsSmartObjects::SmartType_Map ==
+      msg_params.getType()) {
+    NsSmartDeviceLink::NsSmartObjects::SmartMap::iterator iter =
+        msg_params.map_begin();
+    NsSmartDeviceLink::NsSmartObjects::SmartMap::iterator iter_end =
+        msg_params.map_end();
+
+    for (; iter != iter_end; ++iter) {
+      if (true == iter->second.asBool()) {
+        params.push_back(iter->first);
+      }
+    }
+  }
+  return params;
+}
 }
 
 namespace application_manager {
@@ -104,6 +126,7 @@ ApplicationManagerImpl::ApplicationManagerImpl()
       tts_global_properties_timer_(
           "TTSGLPRTimer", this,
           &ApplicationManagerImpl::OnTimerSendTTSGlobalProperties, true),
+      binary_writer_(kMaxOpenBinaryFiles),
       is_low_voltage_(false), is_stopping_(false) {
 
   std::srand(std::time(0));
@@ -175,80 +198,50 @@ bool ApplicationManagerImpl::Stop() {
 
 ApplicationSharedPtr
 ApplicationManagerImpl::application(uint32_t app_id) const {
-  AppIdPredicate finder(app_id);
-  ApplicationListAccessor accessor;
-  ApplicationSharedPtr app = accessor.Find(finder);
+  ApplicationSharedPtr app = registry_.application(app_id);
   LOG4CXX_DEBUG(logger_, " app_id << " << app_id << "Found = " << app);
   return app;
 }
 
 ApplicationSharedPtr
 ApplicationManagerImpl::application_by_hmi_app(uint32_t hmi_app_id) const {
-  HmiAppIdPredicate finder(hmi_app_id);
-  ApplicationListAccessor accessor;
-  ApplicationSharedPtr app = accessor.Find(finder);
+  ApplicationSharedPtr app = registry_.application_by_hmi_app(hmi_app_id);
   LOG4CXX_DEBUG(logger_, " hmi_app_id << " << hmi_app_id << "Found = " << app);
   return app;
 }
 
 ApplicationSharedPtr ApplicationManagerImpl::application_by_policy_id(
     const std::string &policy_app_id) const {
-  MobileAppIdPredicate finder(policy_app_id);
-  ApplicationListAccessor accessor;
-  ApplicationSharedPtr app = accessor.Find(finder);
+  ApplicationSharedPtr app = registry_.application_by_policy_id(policy_app_id);
   LOG4CXX_DEBUG(logger_, " policy_app_id << " << policy_app_id
                                               << "Found = " << app);
   return app;
 }
 
-bool ActiveAppPredicate(const ApplicationSharedPtr app) {
-  return app ? app->IsFullscreen() : false;
-}
-
 ApplicationSharedPtr ApplicationManagerImpl::active_application() const {
   // TODO(DK) : check driver distraction
-  ApplicationListAccessor accessor;
-  ApplicationSharedPtr app = accessor.Find(ActiveAppPredicate);
+  ApplicationSharedPtr app = registry_.active_application();
   LOG4CXX_DEBUG(logger_, " Found = " << app);
   return app;
 }
 
-bool LimitedAppPredicate(const ApplicationSharedPtr app) {
-  return app ? app->hmi_level() == mobile_api::HMILevel::HMI_LIMITED : false;
-}
-
 ApplicationSharedPtr
 ApplicationManagerImpl::get_limited_media_application() const {
-  ApplicationListAccessor accessor;
-  ApplicationSharedPtr app = accessor.Find(LimitedAppPredicate);
+  ApplicationSharedPtr app = registry_.limited_application();
   LOG4CXX_DEBUG(logger_, " Found = " << app);
   return app;
 }
 
-bool LimitedNaviAppPredicate(const ApplicationSharedPtr app) {
-  return app ? (app->is_navi() &&
-                app->hmi_level() == mobile_api::HMILevel::HMI_LIMITED)
-             : false;
-}
-
 ApplicationSharedPtr
 ApplicationManagerImpl::get_limited_navi_application() const {
-  ApplicationListAccessor accessor;
-  ApplicationSharedPtr app = accessor.Find(LimitedNaviAppPredicate);
+  ApplicationSharedPtr app = registry_.limited_navi_application();
   LOG4CXX_DEBUG(logger_, " Found = " << app);
   return app;
 }
 
-bool LimitedVoiceAppPredicate(const ApplicationSharedPtr app) {
-  return app ? (app->is_voice_communication_supported() &&
-                app->hmi_level() == mobile_api::HMILevel::HMI_LIMITED)
-             : false;
-}
-
 ApplicationSharedPtr
 ApplicationManagerImpl::get_limited_voice_application() const {
-  ApplicationListAccessor accessor;
-  ApplicationSharedPtr app = accessor.Find(LimitedVoiceAppPredicate);
+  ApplicationSharedPtr app = registry_.limited_voice_application();
   LOG4CXX_DEBUG(logger_, " Found = " << app);
   return app;
 }
@@ -266,14 +259,24 @@ ApplicationManagerImpl::applications_with_navi() {
 }
 std::vector<ApplicationSharedPtr>
 ApplicationManagerImpl::applications_by_button(uint32_t button) {
-  SubscribedToButtonPredicate finder(
-      static_cast<mobile_apis::ButtonName::eType>(button));
-  ApplicationListAccessor accessor;
-  std::vector<ApplicationSharedPtr> apps = accessor.FindAll(finder);
+  std::vector<ApplicationSharedPtr> apps =
+      registry_.applications_by_button(button);
   LOG4CXX_DEBUG(logger_, " Found count: " << apps.size());
   return apps;
 }
 
+std::vector<ApplicationSharedPtr>
+ApplicationManagerImpl::applications_by_ivi(uint32_t vehicle_info) {
+  std::vector<ApplicationSharedPtr> apps =
+      registry_.applications_by_ivi(vehicle_info);
+  LOG4CXX_DEBUG(logger_, " Found count: " << apps.size());
+  return apps;
+}
+
+void ApplicationManagerImpl::OnSubscriptionsChanged(uint32_t app_id) {
+  registry_.OnSubscriptionsChanged(app_id);
+}
+
 std::vector<ApplicationSharedPtr>
 ApplicationManagerImpl::IviInfoUpdated(VehicleDataType vehicle_info,
                                        int value) {
@@ -288,9 +291,8 @@ ApplicationManagerImpl::IviInfoUpdated(VehicleDataType vehicle_info,
     break;
   }
 
-  SubscribedToIVIPredicate finder(static_cast<int32_t>(vehicle_info));
-  ApplicationListAccessor accessor;
-  std::vector<ApplicationSharedPtr> apps = accessor.FindAll(finder);
+  std::vector<ApplicationSharedPtr> apps =
+      registry_.applications_by_ivi(static_cast<uint32_t>(vehicle_info));
   LOG4CXX_DEBUG(logger_, " vehicle_info << " << vehicle_info
                                              << "Found count: " << apps.size());
   return apps;
@@ -498,6 +500,7 @@ ApplicationSharedPtr ApplicationManagerImpl::RegisterApplication(
   applications_list_lock_.Acquire();
   application->MarkRegistered();
   applications_.insert(application);
+  registry_.Insert(application);
   applications_list_lock_.Release();
 
   policy::PolicyHandler::instance()->AddApplication(
@@ -1219,36 +1222,31 @@ void ApplicationManagerImpl::SendMessageToMobile(
   // Messages to mobile are not yet prioritized so use default priority value
   utils::SharedPtr<Message> message_to_send(
       new Message(protocol_handler::MessagePriority::kDefault));
-  if (!ConvertSOtoMessage((*message), (*message_to_send))) {
+  const bool converted = ConvertSOtoMessage((*message), (*message_to_send));
+
+  smart_objects::SmartObject &msg_to_mobile = *message;
+  const bool is_response =
+      msg_to_mobile[strings::params].keyExists(strings::correlation_id);
+  if (is_response) {
+    // Request is completed even if its response can't be sent
+    request_ctrl_.OnMobileResponse(
+        msg_to_mobile[strings::params][strings::correlation_id].asInt(),
+        msg_to_mobile[strings::params][strings::connection_key].asInt());
+  }
+
+  if (!converted) {
     LOG4CXX_WARN(logger_, "Can't send msg to Mobile: failed to create string");
     return;
   }
 
-  smart_objects::SmartObject &msg_to_mobile = *message;
   // If correlation_id is not present, it is from-HMI message which should be
   // checked against policy permissions
-  if (msg_to_mobile[strings::params].keyExists(strings::correlation_id)) {
-    request_ctrl_.OnMobileResponse(
-        msg_to_mobile[strings::params][strings::correlation_id].asInt(),
-        msg_to_mobile[strings::params][strings::connection_key].asInt());
-  } else if (app) {
+  if (!is_response && app) {
     mobile_apis::FunctionID::eType function_id =
         static_cast<mobile_apis::FunctionID::eType>(
             (*message)[strings::params][strings::function_id].asUInt());
-    RPCParams params;
-
-    const smart_objects::SmartObject &s_map = (*message)[strings::msg_params];
-    if (smart_objects::SmartType_Map == s_map.getType()) {
-      smart_objects::SmartMap::iterator iter = s_map.map_begin();
-      smart_objects::SmartMap::iterator iter_end = s_map.map_end();
-
-      for (; iter != iter_end; ++iter) {
-        if (true == iter->second.asBool()) {
-          LOG4CXX_INFO(logger_, "Request's param: " << iter->first);
-          params.push_back(iter->first);
-        }
-      }
-    }
+    const RPCParams params =
+        CollectRPCParams((*message)[strings::msg_params]);
     const mobile_apis::Result::eType check_result = CheckPolicyPermissions(
         app->mobile_app_id(), app->hmi_level(), function_id, params);
     if (mobile_apis::Result::SUCCESS != check_result) {
@@ -1271,14 +1269,127 @@ void ApplicationManagerImpl::SendMessageToMobile(
     }
   }
 
-  if (message_to_send->binary_data()) {
-    LOG4CXX_DEBUG(logger_, "Binary data size: "
-                               << message_to_send->binary_data()->size());
+  if (message_to_send->has_serialized_payload()) {
+    LOG4CXX_DEBUG(logger_, "Payload size: "
+                               << message_to_send->serialized_payload()->size());
   }
   messages_to_mobile_.PostMessage(
       impl::MessageToMobile(message_to_send, final_message));
 }
 
+void ApplicationManagerImpl::MulticastNotificationToMobile(
+    const commands::MessageSharedPtr message,
+    const std::vector<ApplicationSharedPtr>& applications) {
+  LOG4CXX_AUTO_TRACE(logger_);
+
+  if (!message) {
+    LOG4CXX_ERROR(logger_, "Null-pointer message received.");
+    NOTREACHED();
+    return;
+  }
+
+  if (!protocol_handler_) {
+    LOG4CXX_WARN(logger_, "No Protocol Handler set");
+    return;
+  }
+
+  if (IsLowVoltage()) {
+    LOG4CXX_WARN(logger_, "Low Voltage is active");
+    return;
+  }
+
+  smart_objects::SmartObject& msg_to_mobile = *message;
+  msg_to_mobile[strings::params][strings::protocol_type] =
+      commands::CommandImpl::mobile_protocol_type_;
+  msg_to_mobile[strings::params][strings::message_type] =
+      static_cast<int32_t>(application_manager::MessageType::kNotification);
+
+  const mobile_apis::FunctionID::eType function_id =
+      static_cast<mobile_apis::FunctionID::eType>(
+          msg_to_mobile[strings::params][strings::function_id].asUInt());
+  const RPCParams params =
+      CollectRPCParams(msg_to_mobile[strings::msg_params]);
+
+  // Protocol v1 has its own json format, later versions share the same one
+  std::vector<ApplicationSharedPtr> v1_recipients;
+  std::vector<ApplicationSharedPtr> recipients;
+  recipients.reserve(applications.size());
+
+  std::vector<ApplicationSharedPtr>::const_iterator it = applications.begin();
+  for (; applications.end() != it; ++it) {
+    const ApplicationSharedPtr app = *it;
+    if (!app) {
+      continue;
+    }
+    const mobile_apis::Result::eType check_result = CheckPolicyPermissions(
+        app->mobile_app_id(), app->hmi_level(), function_id, params);
+    if (mobile_apis::Result::SUCCESS != check_result) {
+      LOG4CXX_WARN(logger_, "Function #" << function_id
+                   << " not allowed by policy for application "
+                   << app->app_id());
+      continue;
+    }
+    if (ProtocolVersion::kV1 == app->protocol_version()) {
+      v1_recipients.push_back(app);
+    } else {
+      recipients.push_back(app);
+    }
+  }
+
+  PostMulticastNotification(message, v1_recipients);
+  PostMulticastNotification(message, recipients);
+}
+
+void ApplicationManagerImpl::PostMulticastNotification(
+    const commands::MessageSharedPtr message,
+    const std::vector<ApplicationSharedPtr>& recipients) {
+  if (recipients.empty()) {
+    return;
+  }
+
+  smart_objects::SmartObject& msg_to_mobile = *message;
+  const ApplicationSharedPtr first_recipient = recipients.front();
+  msg_to_mobile[strings::params][strings::connection_key] =
+      first_recipient->app_id();
+  msg_to_mobile[strings::params][strings::protocol_version] =
+      first_recipient->protocol_version();
+  mobile_so_factory().attachSchema(msg_to_mobile, false);
+
+  // Messages to mobile are not yet prioritized so use default priority value
+  utils::SharedPtr<Message> formatted_message(
+      new Message(protocol_handler::MessagePriority::kDefault));
+  if (!ConvertSOtoMessage(msg_to_mobile, *formatted_message)) {
+    LOG4CXX_WARN(logger_, "Can't send msg to Mobile: failed to create string");
+    return;
+  }
+  if (formatted_message->serialized_payload_has_binary_data()) {
+    LOG4CXX_ERROR(logger_, "Binary data can't be multicasted");
+    NOTREACHED();
+    return;
+  }
+
+  const protocol_handler::SharedPayload payload =
+      formatted_message->serialized_payload();
+  if (!payload) {
+    LOG4CXX_WARN(logger_, "Can't send msg to Mobile: failed to serialize");
+    return;
+  }
+
+  std::vector<ApplicationSharedPtr>::const_iterator it = recipients.begin();
+  for (; recipients.end() != it; ++it) {
+    utils::SharedPtr<Message> message_to_send(
+        new Message(protocol_handler::MessagePriority::kDefault));
+    message_to_send->set_function_id(formatted_message->function_id());
+    message_to_send->set_correlation_id(formatted_message->correlation_id());
+    message_to_send->set_message_type(formatted_message->type());
+    message_to_send->set_connection_key((*it)->app_id());
+    message_to_send->set_protocol_version((*it)->protocol_version());
+    message_to_send->set_serialized_payload(payload);
+    messages_to_mobile_.PostMessage(
+        impl::MessageToMobile(message_to_send, false));
+  }
+}
+
 void ApplicationManagerImpl::TerminateRequest(uint32_t connection_key,
                                               uint32_t corr_id) {
   request_ctrl_.terminateRequest(corr_id, connection_key, true);
@@ -1779,19 +1890,39 @@ bool ApplicationManagerImpl::ConvertSOtoMessage(
 
   // Currently formatter creates JSON = 3 bytes for empty SmartObject.
   // workaround for notification. JSON must be empty
-  if (mobile_apis::FunctionID::OnAudioPassThruID !=
+  if (mobile_apis::FunctionID::OnAudioPassThruID ==
       message.getElement(jhs::S_PARAMS)
           .getElement(strings::function_id)
           .asInt()) {
-    output.set_json_message(output_string);
+    output_string.clear();
   }
 
+  const BinaryData *binary_data = NULL;
   if (message.getElement(jhs::S_PARAMS).keyExists(strings::binary_data)) {
+    binary_data = &message.getElement(jhs::S_PARAMS)
+                       .getElement(strings::binary_data)
+                       .asBinary();
+  }
+
+  if (application_manager::kHMI != output.protocol_version()) {
+    // Message to mobile is serialized right here, json and binary data are
+    // copied once into payload which protocol handler takes as is
+    const protocol_handler::SharedPayload payload =
+        MobileMessageHandler::SerializeOutgoingMessage(output, output_string,
+                                                       binary_data);
+    if (!payload) {
+      LOG4CXX_ERROR(logger_, "Failed to serialize message to mobile");
+      return false;
+    }
+    output.set_serialized_payload(payload, NULL != binary_data);
+    LOG4CXX_INFO(logger_, "Successfully parsed smart object into message");
+    return true;
+  }
+
+  output.set_json_message(output_string);
+  if (binary_data) {
     application_manager::BinaryData *binaryData =
-        new application_manager::BinaryData(
-            message.getElement(jhs::S_PARAMS)
-                .getElement(strings::binary_data)
-                .asBinary());
+        new application_manager::BinaryData(*binary_data);
 
     if (NULL == binaryData) {
       LOG4CXX_ERROR(logger_, "Null pointer");
@@ -2691,6 +2822,9 @@ void ApplicationManagerImpl::OnHMILevelChanged(
   }
 
   ApplicationSharedPtr app = application(app_id);
+  if (app) {
+    registry_.OnHMILevelChanged(app);
+  }
   if (!app || !app->is_navi()) {
     LOG4CXX_ERROR(logger_, "Navi application not found");
     return;
@@ -2830,33 +2964,37 @@ mobile_apis::Result::eType ApplicationManagerImpl::SaveBinary(
   }
 
   const std::string full_file_path = file_path + "/" + file_name;
-  int64_t file_size = file_system::FileSize(full_file_path);
-  std::ofstream *file_stream;
-  if (offset != 0) {
-    if (file_size != offset) {
+  int64_t size_delta = 0;
+  // if offset == 0: rewrite file, otherwise offset has to match file size
+  const file_system::ChunkedFileWriter::WriteResult result =
+      binary_writer_.Write(full_file_path, binary_data.data(),
+                           binary_data.size(), offset, &size_delta);
+  storage_usage_.Update(file_path, size_delta);
+
+  switch (result) {
+    case file_system::ChunkedFileWriter::kWriteSuccess:
+      LOG4CXX_INFO(logger_, "Successfully write data to file");
+      return mobile_apis::Result::SUCCESS;
+    case file_system::ChunkedFileWriter::kWriteOffsetMismatch:
       LOG4CXX_INFO(logger_,
                    "ApplicationManagerImpl::SaveBinaryWithOffset offset"
                        << " does'n match existing file size");
       return mobile_apis::Result::INVALID_DATA;
-    }
-    file_stream = file_system::Open(full_file_path, std::ios_base::app);
-  } else {
-    LOG4CXX_INFO(
-        logger_,
-        "ApplicationManagerImpl::SaveBinaryWithOffset offset is 0, rewrite");
-    // if offset == 0: rewrite file
-    file_stream = file_system::Open(full_file_path, std::ios_base::out);
+    default:
+      return mobile_apis::Result::GENERIC_ERROR;
   }
+}
 
-  if (!file_system::Write(file_stream, binary_data.data(),
-                          binary_data.size())) {
-    file_system::Close(file_stream);
-    return mobile_apis::Result::GENERIC_ERROR;
+bool ApplicationManagerImpl::DeleteBinary(const std::string &file_path,
+                                          const std::string &file_name) {
+  const std::string full_file_path = file_path + "/" + file_name;
+  binary_writer_.Close(full_file_path);
+  const int64_t file_size = file_system::FileSize(full_file_path);
+  if (!file_system::DeleteFile(full_file_path)) {
+    return false;
   }
-
-  file_system::Close(file_stream);
-  LOG4CXX_INFO(logger_, "Successfully write data to file");
-  return mobile_apis::Result::SUCCESS;
+  storage_usage_.Update(file_path, -file_size);
+  return true;
 }
 
 uint32_t ApplicationManagerImpl::GetAvailableSpaceForApp(
@@ -2869,7 +3007,7 @@ uint32_t ApplicationManagerImpl::GetAvailableSpaceForApp(
   app_storage_path += folder_name;
 
   if (file_system::DirectoryExists(app_storage_path)) {
-    size_t size_of_directory = file_system::DirectorySize(app_storage_path);
+    const uint64_t size_of_directory = storage_usage_.Size(app_storage_path);
     if (app_quota < size_of_directory) {
       return 0;
     }
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "application_manager/application_registry.h"
+
+namespace application_manager {
+
+namespace {
+
+template <typename Key>
+void IndexApp(std::map<Key, ApplicationSharedPtr>* index,
+              const Key& key, ApplicationSharedPtr app) {
+  typename std::map<Key, ApplicationSharedPtr>::iterator it =
+      index->find(key);
+  if (index->end() == it) {
+    index->insert(std::make_pair(key, app));
+    return;
+  }
+  // Linear search used to return application with lowest id
+  if (app->app_id() < it->second->app_id()) {
+    it->second = app;
+  }
+}
+
+template <typename Key, typename KeyGetter>
+void UnindexApp(std::map<Key, ApplicationSharedPtr>* index,
+                const Key& key, ApplicationSharedPtr app,
+                const ApplicationRegistry::AppIdIndex& apps,
+                KeyGetter key_getter) {
+  typename std::map<Key, ApplicationSharedPtr>::iterator it =
+      index->find(key);
+  if (index->end() == it || it->second.get() != app.get()) {
+    return;
+  }
+  index->erase(it);
+  // Another application may share the key
+  for (ApplicationRegistry::AppIdIndex::const_iterator app_it = apps.begin();
+       apps.end() != app_it; ++app_it) {
+    if (key_getter(app_it->second) == key) {
+      IndexApp(index, key, app_it->second);
+    }
+  }
+}
+
+uint32_t HmiAppId(const ApplicationSharedPtr& app) {
+  return app->hmi_app_id();
+}
+
+std::string PolicyAppId(const ApplicationSharedPtr& app) {
+  return app->mobile_app_id();
+}
+
+std::vector<ApplicationSharedPtr> SubscribedApps(
+    const ApplicationRegistry::SubscriptionIndex& index, uint32_t key) {
+  std::vector<ApplicationSharedPtr> result;
+  ApplicationRegistry::SubscriptionIndex::const_iterator it = index.find(key);
+  if (index.end() == it) {
+    return result;
+  }
+  result.reserve(it->second.size());
+  for (ApplicationRegistry::AppsById::const_iterator app_it =
+           it->second.begin();
+       it->second.end() != app_it; ++app_it) {
+    result.push_back(app_it->second);
+  }
+  return result;
+}
+
+void Unsubscribe(ApplicationRegistry::SubscriptionIndex* index,
+                 uint32_t app_id) {
+  ApplicationRegistry::SubscriptionIndex::iterator it = index->begin();
+  while (index->end() != it) {
+    it->second.erase(app_id);
+    if (it->second.empty()) {
+      it = index->erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace
+
+ApplicationRegistry::ApplicationRegistry()
+    : snapshot_(new Snapshot) {
+}
+
+ApplicationRegistry::SnapshotPtr ApplicationRegistry::snapshot() const {
+  snapshot_lock_.Lock();
+  SnapshotPtr snapshot = snapshot_;
+  snapshot_lock_.Unlock();
+  return snapshot;
+}
+
+ApplicationSharedPtr ApplicationRegistry::application(uint32_t app_id) const {
+  const SnapshotPtr current = snapshot();
+  AppIdIndex::const_iterator it = current->by_app_id.find(app_id);
+  return current->by_app_id.end() != it ? it->second : ApplicationSharedPtr();
+}
+
+ApplicationSharedPtr ApplicationRegistry::application_by_hmi_app(
+    uint32_t hmi_app_id) const {
+  const SnapshotPtr current = snapshot();
+  AppIdIndex::const_iterator it = current->by_hmi_app_id.find(hmi_app_id);
+  return current->by_hmi_app_id.end() != it ? it->second
+                                            : ApplicationSharedPtr();
+}
+
+ApplicationSharedPtr ApplicationRegistry::application_by_policy_id(
+    const std::string& policy_app_id) const {
+  const SnapshotPtr current = snapshot();
+  PolicyAppIdIndex::const_iterator it =
+      current->by_policy_app_id.find(policy_app_id);
+  return current->by_policy_app_id.end() != it ? it->second
+                                               : ApplicationSharedPtr();
+}
+
+ApplicationSharedPtr ApplicationRegistry::active_application() const {
+  return snapshot()->full_app;
+}
+
+ApplicationSharedPtr ApplicationRegistry::limited_application() const {
+  const SnapshotPtr current = snapshot();
+  return current->limited_apps.empty() ? ApplicationSharedPtr()
+                                       : current->limited_apps.begin()->second;
+}
+
+ApplicationSharedPtr ApplicationRegistry::limited_navi_application() const {
+  const SnapshotPtr current = snapshot();
+  // There is at most one LIMITED application per HMI type
+  for (AppsById::const_iterator it = current->limited_apps.begin();
+       current->limited_apps.end() != it; ++it) {
+    if (it->second->is_navi()) {
+      return it->second;
+    }
+  }
+  return ApplicationSharedPtr();
+}
+
+ApplicationSharedPtr ApplicationRegistry::limited_voice_application() const {
+  const SnapshotPtr current = snapshot();
+  for (AppsById::const_iterator it = current->limited_apps.begin();
+       current->limited_apps.end() != it; ++it) {
+    if (it->second->is_voice_communication_supported()) {
+      return it->second;
+    }
+  }
+  return ApplicationSharedPtr();
+}
+
+std::vector<ApplicationSharedPtr> ApplicationRegistry::applications_by_ivi(
+    uint32_t vehicle_info) const {
+  return SubscribedApps(snapshot()->by_vehicle_info, vehicle_info);
+}
+
+std::vector<ApplicationSharedPtr> ApplicationRegistry::applications_by_button(
+    uint32_t button) const {
+  return SubscribedApps(snapshot()->by_button, button);
+}
+
+void ApplicationRegistry::Insert(ApplicationSharedPtr app) {
+  DCHECK_OR_RETURN_VOID(app);
+  sync_primitives::AutoLock lock(update_lock_);
+  Snapshot* updated = new Snapshot(*snapshot());
+  updated->by_app_id[app->app_id()] = app;
+  IndexApp(&updated->by_hmi_app_id, app->hmi_app_id(), app);
+  IndexApp(&updated->by_policy_app_id, app->mobile_app_id(), app);
+  UpdateHMILevel(app, updated);
+  UpdateSubscriptions(app, updated);
+  Publish(updated);
+}
+
+void ApplicationRegistry::Erase(ApplicationSharedPtr app) {
+  DCHECK_OR_RETURN_VOID(app);
+  sync_primitives::AutoLock lock(update_lock_);
+  Snapshot* updated = new Snapshot(*snapshot());
+  AppIdIndex::iterator it = updated->by_app_id.find(app->app_id());
+  if (updated->by_app_id.end() == it || it->second.get() != app.get()) {
+    delete updated;
+    return;
+  }
+  updated->by_app_id.erase(it);
+  UnindexApp(&updated->by_hmi_app_id, app->hmi_app_id(), app,
+             updated->by_app_id, HmiAppId);
+  UnindexApp(&updated->by_policy_app_id, app->mobile_app_id(), app,
+             updated->by_app_id, PolicyAppId);
+  if (updated->full_app.get() == app.get()) {
+    updated->full_app.reset();
+  }
+  updated->limited_apps.erase(app->app_id());
+  RemoveSubscriptions(app->app_id(), updated);
+  Publish(updated);
+}
+
+void ApplicationRegistry::OnHMILevelChanged(ApplicationSharedPtr app) {
+  DCHECK_OR_RETURN_VOID(app);
+  sync_primitives::AutoLock lock(update_lock_);
+  const SnapshotPtr current = snapshot();
+  AppIdIndex::const_iterator it = current->by_app_id.find(app->app_id());
+  if (current->by_app_id.end() == it || it->second.get() != app.get()) {
+    return;
+  }
+  Snapshot* updated = new Snapshot(*current);
+  UpdateHMILevel(app, updated);
+  Publish(updated);
+}
+
+void ApplicationRegistry::OnSubscriptionsChanged(uint32_t app_id) {
+  sync_primitives::AutoLock lock(update_lock_);
+  const SnapshotPtr current = snapshot();
+  AppIdIndex::const_iterator it = current->by_app_id.find(app_id);
+  if (current->by_app_id.end() == it) {
+    return;
+  }
+  Snapshot* updated = new Snapshot(*current);
+  UpdateSubscriptions(it->second, updated);
+  Publish(updated);
+}
+
+void ApplicationRegistry::Publish(Snapshot* snapshot) {
+  const SnapshotPtr published(snapshot);
+  snapshot_lock_.Lock();
+  // Previous snapshot is released out of the spin lock
+  const SnapshotPtr previous = snapshot_;
+  snapshot_ = published;
+  snapshot_lock_.Unlock();
+}
+
+void ApplicationRegistry::UpdateHMILevel(ApplicationSharedPtr app,
+                                         Snapshot* snapshot) {
+  const mobile_apis::HMILevel::eType hmi_level = app->hmi_level();
+  if (mobile_apis::HMILevel::HMI_FULL == hmi_level) {
+    snapshot->full_app = app;
+  } else if (snapshot->full_app.get() == app.get()) {
+    // Other application may be already activated
+    snapshot->full_app.reset();
+  }
+  if (mobile_apis::HMILevel::HMI_LIMITED == hmi_level) {
+    snapshot->limited_apps[app->app_id()] = app;
+  } else {
+    snapshot->limited_apps.erase(app->app_id());
+  }
+}
+
+void ApplicationRegistry::UpdateSubscriptions(ApplicationSharedPtr app,
+                                              Snapshot* snapshot) {
+  RemoveSubscriptions(app->app_id(), snapshot);
+
+  const std::set<uint32_t>& vehicle_info = app->SubscribesIVI();
+  for (std::set<uint32_t>::const_iterator it = vehicle_info.begin();
+       vehicle_info.end() != it; ++it) {
+    snapshot->by_vehicle_info[*it][app->app_id()] = app;
+  }
+  const std::set<mobile_apis::ButtonName::eType>& buttons =
+      app->SubscribedButtons();
+  for (std::set<mobile_apis::ButtonName::eType>::const_iterator it =
+           buttons.begin();
+       buttons.end() != it; ++it) {
+    snapshot->by_button[static_cast<uint32_t>(*it)][app->app_id()] = app;
+  }
+}
+
+void ApplicationRegistry::RemoveSubscriptions(uint32_t app_id,
+                                              Snapshot* snapshot) {
+  Unsubscribe(&snapshot->by_vehicle_info, app_id);
+  Unsubscribe(&snapshot->by_button, app_id);
+}
+
+}  // namespace application_manager
@@ -74,18 +74,17 @@ void OnDriverDistractionNotification::Run() {
   (*on_driver_distraction)[strings::msg_params][mobile_notification::state] =
       state;
 
-  ApplicationManagerImpl::ApplicationListAccessor accessor;
-  const ApplicationManagerImpl::ApplictionSet applications = accessor.applications();
-
-  ApplicationManagerImpl::ApplictionSetConstIt it = applications.begin();
-  for (; applications.end() != it; ++it) {
-    const ApplicationSharedPtr app = *it;
-    if (app) {
-      (*on_driver_distraction)[strings::params]
-                              [strings::connection_key] = app->app_id();
-      SendNotificationToMobile(on_driver_distraction);
-    }
+  std::vector<ApplicationSharedPtr> recipients;
+  {
+    ApplicationManagerImpl::ApplicationListAccessor accessor;
+    const ApplicationManagerImpl::ApplictionSet applications =
+        accessor.applications();
+    recipients.assign(applications.begin(), applications.end());
   }
+
+  // Notification is the same for all applications, so it is serialized once
+  ApplicationManagerImpl::instance()->MulticastNotificationToMobile(
+      on_driver_distraction, recipients);
 }
 
 }  // namespace hmi
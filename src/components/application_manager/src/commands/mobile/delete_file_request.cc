@@ -73,14 +73,14 @@ void DeleteFileRequest::Run() {
   const std::string& sync_file_name =
       (*message_)[strings::msg_params][strings::sync_file_name].asString();
 
-  std::string full_file_path =
+  std::string file_path =
       profile::Profile::instance()->app_storage_folder() + "/";
-  full_file_path += application->folder_name();
-  full_file_path += "/";
-  full_file_path += sync_file_name;
+  file_path += application->folder_name();
+  const std::string full_file_path = file_path + "/" + sync_file_name;
 
   if (file_system::FileExists(full_file_path)) {
-    if (file_system::DeleteFile(full_file_path)) {
+    if (ApplicationManagerImpl::instance()->DeleteBinary(file_path,
+                                                         sync_file_name)) {
       const AppFile* file = application->GetFile(full_file_path);
       if (file) {
         SendFileRemovedNotification(file);
@@ -31,6 +31,10 @@
  POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "application_manager/commands/mobile/on_vehicle_data_notification.h"
 #include "application_manager/application_manager_impl.h"
 #include "application_manager/application_impl.h"
@@ -52,10 +56,9 @@ OnVehicleDataNotification::~OnVehicleDataNotification() {
 void OnVehicleDataNotification::Run() {
   LOG4CXX_AUTO_TRACE(logger_);
 
-  std::vector<ApplicationSharedPtr> appNotification;
-  std::vector<ApplicationSharedPtr>::iterator appNotification_it =
-    appNotification.begin();
-  std::vector<smart_objects::SmartObject> appSO;
+  // Vehicle data keys received by each subscribed application
+  typedef std::map<ApplicationSharedPtr, std::vector<std::string> > AppKeys;
+  AppKeys app_keys;
 
   const VehicleData& vehicle_data = MessageHelper::vehicle_data();
   VehicleData::const_iterator it = vehicle_data.begin();
@@ -68,36 +71,42 @@ void OnVehicleDataNotification::Run() {
 
       std::vector<ApplicationSharedPtr>::const_iterator app_it = applications.begin();
       for (; applications.end() != app_it; ++app_it) {
-        const ApplicationSharedPtr app = *app_it;
-        DCHECK(app);
-
-        appNotification_it = find(appNotification.begin(), appNotification.end(), app);
-        if (appNotification_it == appNotification.end()) {
-          appNotification.push_back(app);
-          smart_objects::SmartObject msg_param = smart_objects::SmartObject(
-                                                   smart_objects::SmartType_Map);
-          msg_param[it->first] = (*message_)[strings::msg_params][it->first];
-          appSO.push_back(msg_param);
-        } else {
-          size_t idx = std::distance(appNotification.begin(), appNotification_it);
-          appSO[idx][it->first] = (*message_)[strings::msg_params][it->first];
-        }
+        DCHECK(*app_it);
+        app_keys[*app_it].push_back(it->first);
       }
     }
   }
 
   LOG4CXX_DEBUG(logger_, "Number of Notifications to be send: " <<
-                appNotification.size());
-
-  for (size_t idx = 0; idx < appNotification.size(); idx++) {
-    LOG4CXX_INFO(
-      logger_,
-      "Send OnVehicleData PRNDL notification to " << appNotification[idx]->name()
-      << " application id " << appNotification[idx]->app_id());
-    (*message_)[strings::params][strings::connection_key] =
-      appNotification[idx]->app_id();
-    (*message_)[strings::msg_params] = appSO[idx];
-    SendNotification();
+                app_keys.size());
+
+  // Applications subscribed to the same data share one payload
+  typedef std::map<std::vector<std::string>, std::vector<ApplicationSharedPtr> >
+      PayloadGroups;
+  PayloadGroups groups;
+  for (AppKeys::const_iterator app_it = app_keys.begin();
+       app_keys.end() != app_it; ++app_it) {
+    groups[app_it->second].push_back(app_it->first);
+  }
+
+  const smart_objects::SmartObject received_params =
+      (*message_)[strings::msg_params];
+  PayloadGroups::const_iterator group_it = groups.begin();
+  for (; groups.end() != group_it; ++group_it) {
+    const std::vector<std::string>& keys = group_it->first;
+    smart_objects::SmartObject msg_params =
+        smart_objects::SmartObject(smart_objects::SmartType_Map);
+    for (size_t idx = 0; idx < keys.size(); ++idx) {
+      msg_params[keys[idx]] = received_params[keys[idx]];
+    }
+    (*message_)[strings::msg_params] = msg_params;
+
+    const std::vector<ApplicationSharedPtr>& apps = group_it->second;
+    LOG4CXX_INFO(logger_, "Send OnVehicleData notification to "
+                 << apps.size() << " applications");
+    // Payload of group is serialized once for all its applications
+    ApplicationManagerImpl::instance()->MulticastNotificationToMobile(
+        message_, apps);
   }
 }
 
@@ -109,7 +109,8 @@ void PutFileRequest::Run() {
   file_type_ =
     static_cast<mobile_apis::FileType::eType>(
       (*message_)[strings::msg_params][strings::file_type].asInt());
-  const std::vector<uint8_t> binary_data =
+  // Binary is written straight from the message, without copying
+  const std::vector<uint8_t>& binary_data =
     (*message_)[strings::params][strings::binary_data].asBinary();
 
   // Policy table update in json format is currently to be received via PutFile
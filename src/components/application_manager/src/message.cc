@@ -64,7 +64,8 @@ Message::Message(protocol_handler::MessagePriority priority)
       binary_data_(NULL),
       data_size_(0),
       payload_size_(0),
-      version_(kUnknownProtocol) {
+      version_(kUnknownProtocol),
+      serialized_payload_has_binary_data_(false) {
 }
 
 Message::Message(const Message& message)
@@ -84,6 +85,9 @@ Message& Message::operator=(const Message& message) {
   }
   set_json_message(message.json_message_);
   set_protocol_version(message.protocol_version());
+  serialized_payload_ = message.serialized_payload_;
+  serialized_payload_has_binary_data_ =
+      message.serialized_payload_has_binary_data_;
   priority_ = message.priority_;
 
   return *this;
@@ -154,6 +158,18 @@ size_t Message::payload_size() const {
   return payload_size_;
 }
 
+const protocol_handler::SharedPayload& Message::serialized_payload() const {
+  return serialized_payload_;
+}
+
+bool Message::has_serialized_payload() const {
+  return serialized_payload_.valid();
+}
+
+bool Message::serialized_payload_has_binary_data() const {
+  return serialized_payload_has_binary_data_;
+}
+
 void Message::set_function_id(int32_t id) {
   function_id_ = id;
 }
@@ -206,4 +222,10 @@ void Message::set_data_size(size_t data_size) {
 void Message::set_payload_size(size_t payload_size) {
   payload_size_ = payload_size;
 }
+
+void Message::set_serialized_payload(
+    const protocol_handler::SharedPayload& payload, bool has_binary_data) {
+  serialized_payload_ = payload;
+  serialized_payload_has_binary_data_ = has_binary_data;
+}
 }  // namespace application_manager
@@ -34,23 +34,15 @@
 
 #include "utils/macro.h"
 #include "application_manager/mobile_message_handler.h"
+#include "protocol_handler/header_layout.h"
 #include "protocol_handler/protocol_payload.h"
 #include "protocol_handler/protocol_packet.h"
-#include "utils/bitstream.h"
 #include "utils/logger.h"
 
 #include <stdint.h>
 #include <memory>
 
-namespace {
-const uint8_t kRequest = 0x0;
-const uint8_t kResponse = 0x1;
-const uint8_t kNotification = 0x2;
-const uint8_t kUnknown = 0xF;
-}
-
 namespace application_manager {
-using protocol_handler::Extract;
 
 CREATE_LOGGERPTR_GLOBAL(logger_, "MobileMessageHandler")
 
@@ -67,17 +59,51 @@ application_manager::Message* MobileMessageHandler::HandleIncomingMessageProtoco
   return NULL;
 }
 
+protocol_handler::SharedPayload MobileMessageHandler::SerializeOutgoingMessage(
+  const MobileMessage& message) {
+  return MobileMessageHandler::SerializeOutgoingMessage(
+      *message, message->json_message(), message->binary_data());
+}
+
+protocol_handler::SharedPayload MobileMessageHandler::SerializeOutgoingMessage(
+  const Message& message, const std::string& json,
+  const BinaryData* binary_data) {
+  if (message.protocol_version() == application_manager::kV1) {
+    return MobileMessageHandler::SerializeOutgoingMessageV1(json);
+  }
+  if ((message.protocol_version() == application_manager::kV2) ||
+	  (message.protocol_version() == application_manager::kV3) ||
+	  (message.protocol_version() == application_manager::kV4)) {
+    return MobileMessageHandler::SerializeOutgoingMessageV2(message, json,
+                                                            binary_data);
+  }
+  return protocol_handler::SharedPayload();
+}
+
 protocol_handler::RawMessage* MobileMessageHandler::HandleOutgoingMessageProtocol(
   const MobileMessage& message) {
-  if (message->protocol_version() == application_manager::kV1) {
-    return MobileMessageHandler::HandleOutgoingMessageProtocolV1(message);
+  protocol_handler::SharedPayload payload = message->serialized_payload();
+  if (!payload) {
+    payload = SerializeOutgoingMessage(message);
   }
-  if ((message->protocol_version() == application_manager::kV2) ||
-	  (message->protocol_version() == application_manager::kV3) ||
-	  (message->protocol_version() == application_manager::kV4)) {
-    return MobileMessageHandler::HandleOutgoingMessageProtocolV2(message);
+  if (!payload) {
+    return NULL;
   }
-  return NULL;
+
+  // Default the service type to RPC Service
+  uint8_t type = protocol_handler::kRpc;
+  if (application_manager::kV1 != message->protocol_version() &&
+      (message->has_binary_data() ||
+       message->serialized_payload_has_binary_data())) {
+    // Change the service type to Hybrid Service
+    type = protocol_handler::kBulk;
+  }
+
+  // Payload bytes are referenced by raw message instead of being copied
+  return new protocol_handler::RawMessage(message->connection_key(),
+                                          message->protocol_version(),
+                                          payload,
+                                          type);
 }
 
 
@@ -118,13 +144,10 @@ MobileMessageHandler::HandleIncomingMessageProtocolV2(
   LOG4CXX_INFO(logger_,
                "MobileMessageHandler HandleIncomingMessageProtocolV2()");
 
-  utils::BitStream message_bytestream(message->data(), message->data_size());
   protocol_handler::ProtocolPayloadV2 payload;
-  protocol_handler::Extract(&message_bytestream, &payload,
-                            message->data_size());
-
   // Silently drop message if it wasn't parsed correctly
-  if (message_bytestream.IsBad()) {
+  if (!protocol_handler::ParsePayloadV2(message->data(), message->data_size(),
+                                        &payload)) {
     LOG4CXX_WARN(logger_,
                  "Drop ill-formed message from mobile, partially parsed: "
                  << payload);
@@ -155,105 +178,71 @@ MobileMessageHandler::HandleIncomingMessageProtocolV2(
   return outgoing_message.release();
 }
 
-protocol_handler::RawMessage*
-MobileMessageHandler::HandleOutgoingMessageProtocolV1(
-  const MobileMessage& message) {
+protocol_handler::SharedPayload
+MobileMessageHandler::SerializeOutgoingMessageV1(
+  const std::string& json) {
   LOG4CXX_INFO(logger_,
-               "MobileMessageHandler HandleOutgoingMessageProtocolV1()");
-  std::string messageString = message->json_message();
-  if (messageString.length() == 0) {
+               "MobileMessageHandler SerializeOutgoingMessageV1()");
+  if (json.length() == 0) {
     LOG4CXX_INFO(logger_,
                  "Drop ill-formed message from mobile");
-    return NULL;
+    return protocol_handler::SharedPayload();
   }
 
-  uint8_t* rawMessage = new uint8_t[messageString.length() + 1];
-  memcpy(rawMessage, messageString.c_str(), messageString.length() + 1);
-
-  protocol_handler::RawMessage* result = new protocol_handler::RawMessage(
-    message->connection_key(), 1, rawMessage, messageString.length() + 1);
-
-  delete [] rawMessage;
-
-  return result;
+  // Protocol v1 message is null-terminated json string
+  const char* json_data = json.c_str();
+  return protocol_handler::SharedPayload(
+      new std::vector<uint8_t>(json_data, json_data + json.length() + 1));
 }
 
-protocol_handler::RawMessage*
-MobileMessageHandler::HandleOutgoingMessageProtocolV2(
-  const MobileMessage& message) {
+protocol_handler::SharedPayload
+MobileMessageHandler::SerializeOutgoingMessageV2(
+  const Message& message, const std::string& json,
+  const BinaryData* binary_data) {
   LOG4CXX_INFO(logger_,
-               "MobileMessageHandler HandleOutgoingMessageProtocolV2()");
-  if (message->json_message().length() == 0) {
+               "MobileMessageHandler SerializeOutgoingMessageV2()");
+  if (json.length() == 0) {
     LOG4CXX_ERROR(logger_, "json string is empty.");
   }
-  uint32_t jsonSize = message->json_message().length();
+  uint32_t jsonSize = json.length();
   uint32_t binarySize = 0;
-  if (message->has_binary_data()) {
-    binarySize = message->binary_data()->size();
+  if (binary_data) {
+    binarySize = binary_data->size();
   }
 
-  const size_t dataForSendingSize =
-      protocol_handler::PROTOCOL_HEADER_V2_SIZE + jsonSize + binarySize;
-  uint8_t* dataForSending = new uint8_t[dataForSendingSize];
-  uint8_t offset = 0;
-
-  uint8_t rpcTypeFlag = 0;
-  switch (message->type()) {
+  protocol_handler::ProtocolPayloadHeaderV2 header;
+  switch (message.type()) {
     case application_manager::kRequest:
-      rpcTypeFlag = kRequest;
+      header.rpc_type = protocol_handler::kRpcTypeRequest;
       break;
     case application_manager::kResponse:
-      rpcTypeFlag = kResponse;
+      header.rpc_type = protocol_handler::kRpcTypeResponse;
       break;
     case application_manager::kNotification:
-      rpcTypeFlag = kNotification;
+      header.rpc_type = protocol_handler::kRpcTypeNotification;
       break;
     default:
       NOTREACHED();
+      header.rpc_type = protocol_handler::kRpcTypeRequest;
       break;
   }
-
-  uint32_t functionId = message->function_id();
-  dataForSending[offset++] = ((rpcTypeFlag << 4) & 0xF0) | (functionId >> 24);
-  dataForSending[offset++] = functionId >> 16;
-  dataForSending[offset++] = functionId >> 8;
-  dataForSending[offset++] = functionId;
-
-  uint32_t correlationId = message->correlation_id();
-  dataForSending[offset++] = correlationId >> 24;
-  dataForSending[offset++] = correlationId >> 16;
-  dataForSending[offset++] = correlationId >> 8;
-  dataForSending[offset++] = correlationId;
-
-  dataForSending[offset++] = jsonSize >> 24;
-  dataForSending[offset++] = jsonSize >> 16;
-  dataForSending[offset++] = jsonSize >> 8;
-  dataForSending[offset++] = jsonSize;
-
-  memcpy(dataForSending + offset, message->json_message().c_str(), jsonSize);
-  
-  // Default the service type to RPC Service
-  uint8_t type = 0x07;  
-    
-  if (message->has_binary_data()) {
-    // Change the service type to Hybrid Service
-    type = 0x0F;
-    const std::vector<uint8_t>& binaryData = *(message->binary_data());
-    uint8_t* currentPointer = dataForSending + offset + jsonSize;
-    for (uint32_t i = 0; i < binarySize; ++i) {
-      currentPointer[i] = binaryData[i];
-    }
+  header.rpc_function_id = message.function_id();
+  header.correlation_id = message.correlation_id();
+  header.json_size = jsonSize;
+
+  // Payload is allocated once with headroom for binary header,
+  // json and binary data are appended right after it
+  const size_t headerSize = protocol_handler::PayloadHeaderLayout::kSize;
+  std::vector<uint8_t>* dataForSending = new std::vector<uint8_t>();
+  dataForSending->reserve(headerSize + jsonSize + binarySize);
+  dataForSending->resize(headerSize);
+  dataForSending->insert(dataForSending->end(), json.begin(), json.end());
+  if (binarySize) {
+    dataForSending->insert(dataForSending->end(), binary_data->begin(),
+                           binary_data->end());
   }
+  protocol_handler::WritePayloadHeaderV2(header, &dataForSending->front());
 
-  protocol_handler::RawMessage* msgToProtocolHandler =
-    new protocol_handler::RawMessage(message->connection_key(),
-                                     message->protocol_version(),
-                                     dataForSending,
-                                     dataForSendingSize,
-                                     type);
-
-  delete [] dataForSending;
-
-  return msgToProtocolHandler;
+  return protocol_handler::SharedPayload(dataForSending);
 }
 }  // namespace application_manager
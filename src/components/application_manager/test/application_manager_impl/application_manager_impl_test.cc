@@ -0,0 +1,176 @@
+/*
+ Copyright (c) 2015, Ford Motor Company
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following
+ disclaimer in the documentation and/or other materials provided with the
+ distribution.
+
+ Neither the name of the Ford Motor Company nor the names of its contributors
+ may be used to endorse or promote products derived from this software
+ without specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "application_manager/application_impl.h"
+#include "application_manager/application_manager_impl.h"
+#include "application_manager/message.h"
+#include "application_manager/smart_object_keys.h"
+#include "config_profile/profile.h"
+#include "interfaces/MOBILE_API.h"
+#include "protocol_handler/protocol_handler.h"
+#include "utils/conditional_variable.h"
+#include "utils/lock.h"
+#include "utils/shared_ptr.h"
+
+namespace application_manager {
+
+namespace {
+const uint32_t kConnectionKey = 1;
+const uint32_t kCorrelationId = 2;
+const int32_t kWaitTimeoutMs = 1000;
+
+class ProtocolHandlerMock : public protocol_handler::ProtocolHandler {
+ public:
+  MOCK_METHOD2(SendMessageToMobileApp,
+               void(const protocol_handler::RawMessagePtr message,
+                    bool final_message));
+  MOCK_METHOD1(AddProtocolObserver,
+               void(protocol_handler::ProtocolObserver* observer));
+  MOCK_METHOD1(RemoveProtocolObserver,
+               void(protocol_handler::ProtocolObserver* observer));
+  MOCK_METHOD2(SendFramesNumber,
+               void(uint32_t connection_key, int32_t number_of_frames));
+  MOCK_METHOD2(SendHeartBeat, void(int32_t connection_id, uint8_t session_id));
+  MOCK_METHOD2(SendEndSession,
+               void(int32_t connection_id, uint8_t session_id));
+  MOCK_METHOD3(SendEndService, void(int32_t connection_id, uint8_t session_id,
+                                    uint8_t service_type));
+};
+
+/**
+ * @brief Request which reports when it is picked by request controller
+ * and when it is released by it
+ */
+class TestRequest : public commands::Command {
+ public:
+  TestRequest(sync_primitives::Lock* lock,
+              sync_primitives::ConditionalVariable* cond_var,
+              bool* started, bool* destroyed)
+      : lock_(lock), cond_var_(cond_var),
+        started_(started), destroyed_(destroyed) {}
+
+  ~TestRequest() {
+    sync_primitives::AutoLock auto_lock(*lock_);
+    *destroyed_ = true;
+    cond_var_->Broadcast();
+  }
+
+  // Called after request is added to requests waiting for response
+  bool CheckPermissions() {
+    sync_primitives::AutoLock auto_lock(*lock_);
+    *started_ = true;
+    cond_var_->Broadcast();
+    return false;
+  }
+
+  bool Init() { return true; }
+  void Run() {}
+  bool CleanUp() { return true; }
+  uint32_t default_timeout() const { return 10000; }
+  uint32_t correlation_id() const { return kCorrelationId; }
+  uint32_t connection_key() const { return kConnectionKey; }
+  int32_t function_id() const { return mobile_apis::FunctionID::ShowID; }
+  void onTimeOut() {}
+  bool AllowedToTerminate() { return true; }
+  void SetAllowedToTerminate(bool allowed) {}
+
+ private:
+  sync_primitives::Lock* lock_;
+  sync_primitives::ConditionalVariable* cond_var_;
+  bool* started_;
+  bool* destroyed_;
+};
+
+bool WaitFor(sync_primitives::Lock* lock,
+             sync_primitives::ConditionalVariable* cond_var,
+             const bool* flag) {
+  sync_primitives::AutoLock auto_lock(*lock);
+  while (!*flag) {
+    if (sync_primitives::ConditionalVariable::kTimeout ==
+        cond_var->WaitFor(auto_lock, kWaitTimeoutMs)) {
+      return *flag;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+TEST(ApplicationManagerImplTest,
+     SendMessageToMobile_ResponseFailedToSerialize_RequestCompleted) {
+  // Request controller of application manager takes size of its pool
+  profile::Profile::instance()->config_file_name("smartDeviceLink.ini");
+  ApplicationManagerImpl* app_manager = ApplicationManagerImpl::instance();
+  ProtocolHandlerMock protocol_handler;
+  app_manager->set_protocol_handler(&protocol_handler);
+
+  // Payload is serialized only for protocol versions from 1 to 4
+  ApplicationSharedPtr app(new ApplicationImpl(
+      kConnectionKey, "mobile_app_id", "app_name",
+      utils::SharedPtr<usage_statistics::StatisticsManager>()));
+  app->set_protocol_version(static_cast<ProtocolVersion>(kV4 + 1));
+  ApplicationManagerImpl::ApplicationListAccessor().Insert(app);
+
+  sync_primitives::Lock lock;
+  sync_primitives::ConditionalVariable cond_var;
+  bool started = false;
+  bool destroyed = false;
+  ASSERT_EQ(request_controller::RequestController::SUCCESS,
+            app_manager->request_ctrl_.addMobileRequest(
+                utils::SharedPtr<commands::Command>(new TestRequest(
+                    &lock, &cond_var, &started, &destroyed)),
+                mobile_apis::HMILevel::HMI_FULL));
+  ASSERT_TRUE(WaitFor(&lock, &cond_var, &started));
+
+  commands::MessageSharedPtr response(
+      new smart_objects::SmartObject(smart_objects::SmartType_Map));
+  (*response)[strings::params][strings::function_id] =
+      mobile_apis::FunctionID::ShowID;
+  (*response)[strings::params][strings::message_type] =
+      static_cast<int32_t>(kResponse);
+  (*response)[strings::params][strings::protocol_type] = 0;
+  (*response)[strings::params][strings::correlation_id] = kCorrelationId;
+  (*response)[strings::params][strings::connection_key] = kConnectionKey;
+  (*response)[strings::msg_params][strings::success] = true;
+  (*response)[strings::msg_params][strings::result_code] =
+      mobile_apis::Result::SUCCESS;
+  app_manager->SendMessageToMobile(response);
+
+  // Request controller releases completed request
+  EXPECT_TRUE(WaitFor(&lock, &cond_var, &destroyed));
+
+  ApplicationManagerImpl::ApplicationListAccessor().Erase(app);
+  app_manager->set_protocol_handler(NULL);
+}
+
+}  // namespace application_manager
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "application_manager/application_registry.h"
+#include "application_mock.h"
+
+namespace test {
+namespace components {
+namespace application_manager_test {
+
+using ::testing::NiceMock;
+namespace HMILevel = mobile_apis::HMILevel;
+
+namespace {
+const uint32_t kAppsCount = 100u;
+
+/*
+ * Application with ids and HMI level which are accessed in lookups
+ */
+class TestApplication : public NiceMock<ApplicationMock> {
+ public:
+  TestApplication(uint32_t app_id, uint32_t hmi_app_id,
+                  const std::string& policy_app_id)
+      : app_id_(app_id),
+        hmi_app_id_(hmi_app_id),
+        policy_app_id_(policy_app_id),
+        hmi_level_(HMILevel::HMI_NONE),
+        is_navi_(false) {}
+
+  uint32_t app_id() const { return app_id_; }
+  uint32_t hmi_app_id() const { return hmi_app_id_; }
+  std::string mobile_app_id() const { return policy_app_id_; }
+  const HMILevel::eType hmi_level() const { return hmi_level_; }
+  bool is_navi() const { return is_navi_; }
+  const std::set<uint32_t>& SubscribesIVI() const { return vehicle_info_; }
+  const std::set<mobile_apis::ButtonName::eType>& SubscribedButtons() const {
+    return buttons_;
+  }
+
+  void set_hmi_level(HMILevel::eType hmi_level) { hmi_level_ = hmi_level; }
+  void set_navi(bool is_navi) { is_navi_ = is_navi; }
+  std::set<uint32_t>& vehicle_info() { return vehicle_info_; }
+  std::set<mobile_apis::ButtonName::eType>& buttons() { return buttons_; }
+
+ private:
+  uint32_t app_id_;
+  uint32_t hmi_app_id_;
+  std::string policy_app_id_;
+  HMILevel::eType hmi_level_;
+  bool is_navi_;
+  std::set<uint32_t> vehicle_info_;
+  std::set<mobile_apis::ButtonName::eType> buttons_;
+};
+
+std::string PolicyAppId(uint32_t index) {
+  std::stringstream stream;
+  stream << "policy_app_" << index;
+  return stream.str();
+}
+
+struct AppIdSorter {
+  bool operator()(const am::ApplicationSharedPtr lhs,
+                  const am::ApplicationSharedPtr rhs) const {
+    return lhs->app_id() < rhs->app_id();
+  }
+};
+
+struct AppIdPredicate {
+  uint32_t app_id_;
+  explicit AppIdPredicate(uint32_t app_id) : app_id_(app_id) {}
+  bool operator()(const am::ApplicationSharedPtr app) const {
+    return app ? app_id_ == app->app_id() : false;
+  }
+};
+}  // namespace
+
+class ApplicationRegistryTest : public ::testing::Test {
+ protected:
+  utils::SharedPtr<TestApplication> AddApplication(
+      uint32_t app_id, const std::string& policy_app_id) {
+    utils::SharedPtr<TestApplication> app(
+        new TestApplication(app_id, app_id + 1000u, policy_app_id));
+    registry_.Insert(app);
+    return app;
+  }
+
+  am::ApplicationRegistry registry_;
+};
+
+TEST_F(ApplicationRegistryTest, Lookups_ByEveryId) {
+  utils::SharedPtr<TestApplication> app = AddApplication(1u, "policy_app");
+
+  EXPECT_EQ(app.get(), registry_.application(1u).get());
+  EXPECT_EQ(app.get(), registry_.application_by_hmi_app(1001u).get());
+  EXPECT_EQ(app.get(), registry_.application_by_policy_id("policy_app").get());
+  EXPECT_FALSE(registry_.application(2u));
+  EXPECT_FALSE(registry_.application_by_hmi_app(1u));
+  EXPECT_FALSE(registry_.application_by_policy_id("other_app"));
+
+  registry_.Erase(app);
+  EXPECT_FALSE(registry_.application(1u));
+  EXPECT_FALSE(registry_.application_by_hmi_app(1001u));
+  EXPECT_FALSE(registry_.application_by_policy_id("policy_app"));
+}
+
+TEST_F(ApplicationRegistryTest, PolicyIdOfTwoDevices_LowestAppIdFound) {
+  utils::SharedPtr<TestApplication> second = AddApplication(2u, "policy_app");
+  utils::SharedPtr<TestApplication> first = AddApplication(1u, "policy_app");
+  EXPECT_EQ(first.get(), registry_.application_by_policy_id("policy_app").get());
+
+  registry_.Erase(first);
+  EXPECT_EQ(second.get(),
+            registry_.application_by_policy_id("policy_app").get());
+}
+
+TEST_F(ApplicationRegistryTest, HMILevelChanged_SlotsUpdated) {
+  utils::SharedPtr<TestApplication> media = AddApplication(1u, "media");
+  utils::SharedPtr<TestApplication> navi = AddApplication(2u, "navi");
+  navi->set_navi(true);
+  EXPECT_FALSE(registry_.active_application());
+  EXPECT_FALSE(registry_.limited_application());
+
+  media->set_hmi_level(HMILevel::HMI_FULL);
+  registry_.OnHMILevelChanged(media);
+  EXPECT_EQ(media.get(), registry_.active_application().get());
+
+  navi->set_hmi_level(HMILevel::HMI_FULL);
+  registry_.OnHMILevelChanged(navi);
+  media->set_hmi_level(HMILevel::HMI_LIMITED);
+  registry_.OnHMILevelChanged(media);
+  EXPECT_EQ(navi.get(), registry_.active_application().get());
+  EXPECT_EQ(media.get(), registry_.limited_application().get());
+  EXPECT_FALSE(registry_.limited_navi_application());
+
+  navi->set_hmi_level(HMILevel::HMI_LIMITED);
+  registry_.OnHMILevelChanged(navi);
+  EXPECT_FALSE(registry_.active_application());
+  EXPECT_EQ(media.get(), registry_.limited_application().get());
+  EXPECT_EQ(navi.get(), registry_.limited_navi_application().get());
+
+  registry_.Erase(media);
+  EXPECT_EQ(navi.get(), registry_.limited_application().get());
+}
+
+TEST_F(ApplicationRegistryTest, SubscriptionsChanged_IndexesUpdated) {
+  const uint32_t kSpeed = 1u;
+  const uint32_t kGps = 2u;
+  utils::SharedPtr<TestApplication> first = AddApplication(1u, "first");
+  utils::SharedPtr<TestApplication> second = AddApplication(2u, "second");
+  EXPECT_TRUE(registry_.applications_by_ivi(kSpeed).empty());
+
+  second->vehicle_info().insert(kSpeed);
+  registry_.OnSubscriptionsChanged(2u);
+  first->vehicle_info().insert(kSpeed);
+  first->vehicle_info().insert(kGps);
+  first->buttons().insert(mobile_apis::ButtonName::OK);
+  registry_.OnSubscriptionsChanged(1u);
+
+  std::vector<am::ApplicationSharedPtr> apps =
+      registry_.applications_by_ivi(kSpeed);
+  ASSERT_EQ(2u, apps.size());
+  EXPECT_EQ(first.get(), apps[0].get());
+  EXPECT_EQ(second.get(), apps[1].get());
+  EXPECT_EQ(1u, registry_.applications_by_ivi(kGps).size());
+  EXPECT_EQ(1u, registry_.applications_by_button(
+      mobile_apis::ButtonName::OK).size());
+
+  first->vehicle_info().erase(kSpeed);
+  registry_.OnSubscriptionsChanged(1u);
+  apps = registry_.applications_by_ivi(kSpeed);
+  ASSERT_EQ(1u, apps.size());
+  EXPECT_EQ(second.get(), apps[0].get());
+
+  registry_.Erase(first);
+  EXPECT_TRUE(registry_.applications_by_ivi(kGps).empty());
+  EXPECT_TRUE(registry_.applications_by_button(
+      mobile_apis::ButtonName::OK).empty());
+  // Unregistered application is not indexed
+  registry_.OnSubscriptionsChanged(1u);
+  EXPECT_TRUE(registry_.applications_by_ivi(kGps).empty());
+}
+
+TEST_F(ApplicationRegistryTest, Snapshot_NotChangedByErase) {
+  utils::SharedPtr<TestApplication> app = AddApplication(1u, "policy_app");
+  const am::ApplicationRegistry::SnapshotPtr snapshot = registry_.snapshot();
+
+  registry_.Erase(app);
+  EXPECT_FALSE(registry_.application(1u));
+  EXPECT_EQ(1u, snapshot->by_app_id.size());
+  EXPECT_EQ(1u, snapshot->by_app_id.count(1u));
+}
+
+TEST_F(ApplicationRegistryTest, HundredApps_IndexFindsSameAppsAsScan) {
+  typedef std::set<am::ApplicationSharedPtr, AppIdSorter> Applications;
+  Applications applications;
+  for (uint32_t i = 0; i < kAppsCount; ++i) {
+    applications.insert(AddApplication(i + 1, PolicyAppId(i)));
+  }
+
+  for (uint32_t i = 0; i <= kAppsCount + 1; ++i) {
+    // Previous predicate scan over applications list
+    Applications::const_iterator it =
+        std::find_if(applications.begin(), applications.end(),
+                     AppIdPredicate(i));
+    const am::ApplicationSharedPtr expected =
+        applications.end() != it ? *it : am::ApplicationSharedPtr();
+    EXPECT_EQ(expected.get(), registry_.application(i).get());
+    EXPECT_EQ(expected.get(),
+              registry_.application_by_hmi_app(i + 1000u).get());
+    if (expected) {
+      EXPECT_EQ(expected.get(),
+                registry_.application_by_policy_id(PolicyAppId(i - 1)).get());
+    }
+  }
+}
+
+}  // namespace application_manager_test
+}  // namespace components
+}  // namespace test
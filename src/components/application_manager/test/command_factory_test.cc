@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2015, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <sys/time.h>
+
+#include <typeinfo>
+
+#include "gtest/gtest.h"
+#include "application_manager/hmi_command_factory.h"
+#include "application_manager/message.h"
+#include "application_manager/mobile_command_factory.h"
+#include "application_manager/commands/command_impl.h"
+#include "application_manager/commands/hmi/on_tts_started_notification.h"
+#include "application_manager/commands/hmi/ui_show_request.h"
+#include "application_manager/commands/hmi/ui_show_response.h"
+#include "application_manager/commands/mobile/generic_response.h"
+#include "application_manager/commands/mobile/on_hmi_status_notification.h"
+#include "application_manager/commands/mobile/on_hmi_status_notification_from_mobile.h"
+#include "application_manager/commands/mobile/register_app_interface_request.h"
+#include "application_manager/commands/mobile/register_app_interface_response.h"
+#include "application_manager/commands/mobile/show_request.h"
+#include "application_manager/commands/mobile/show_response.h"
+#include "application_manager/commands/mobile/system_request.h"
+#include "application_manager/smart_object_keys.h"
+#include "interfaces/HMI_API.h"
+#include "interfaces/MOBILE_API.h"
+#include "utils/memory_pool.h"
+#include "utils/shared_ptr.h"
+
+namespace application_manager {
+
+namespace {
+commands::MessageSharedPtr CreateMessage(
+    mobile_apis::FunctionID::eType function_id,
+    mobile_apis::messageType::eType message_type) {
+  commands::MessageSharedPtr message(
+      new smart_objects::SmartObject(smart_objects::SmartType_Map));
+  (*message)[strings::params][strings::function_id] = function_id;
+  (*message)[strings::params][strings::message_type] = message_type;
+  (*message)[strings::params][strings::connection_key] = 1;
+  return message;
+}
+
+CommandSharedPtr CreateCommand(
+    mobile_apis::FunctionID::eType function_id,
+    mobile_apis::messageType::eType message_type,
+    commands::Command::CommandOrigin origin = commands::Command::ORIGIN_SDL) {
+  return CommandSharedPtr(MobileCommandFactory::CreateCommand(
+      CreateMessage(function_id, message_type), origin));
+}
+
+CommandSharedPtr CreateHMICommand(hmi_apis::FunctionID::eType function_id,
+                                  MessageType message_type) {
+  commands::MessageSharedPtr message(
+      new smart_objects::SmartObject(smart_objects::SmartType_Map));
+  (*message)[strings::params][strings::function_id] = function_id;
+  (*message)[strings::params][strings::message_type] = message_type;
+  return HMICommandFactory::CreateCommand(message);
+}
+
+template <typename CommandType>
+bool IsCommandOf(const CommandSharedPtr& command) {
+  return NULL != dynamic_cast<CommandType*>(command.get());
+}
+
+void AddStatistics(const utils::MemoryPool::Statistics& statistics,
+                   utils::MemoryPool::Statistics* total) {
+  total->allocations += statistics.allocations;
+  total->thread_cache_hits += statistics.thread_cache_hits;
+  total->shared_hits += statistics.shared_hits;
+  total->system_allocations += statistics.system_allocations;
+  total->releases += statistics.releases;
+}
+
+utils::MemoryPool::Statistics PoolStatistics() {
+  utils::MemoryPool::Statistics total;
+  for (size_t i = 0; i < utils::MemoryPool::size_classes_count(); ++i) {
+    AddStatistics(utils::MemoryPool::statistics(i), &total);
+  }
+  for (size_t i = 0; i < utils::MemoryPool::object_classes_count(); ++i) {
+    AddStatistics(utils::MemoryPool::object_statistics(i), &total);
+  }
+  return total;
+}
+
+size_t ObjectClassOf(size_t size) {
+  size_t object_class = 0;
+  while (utils::MemoryPool::object_class_size(object_class) < size) {
+    ++object_class;
+  }
+  return object_class;
+}
+
+double MillisecondsSince(const timeval& start) {
+  timeval now;
+  gettimeofday(&now, NULL);
+  return (now.tv_sec - start.tv_sec) * 1000.0 +
+      (now.tv_usec - start.tv_usec) / 1000.0;
+}
+}  // namespace
+
+TEST(CommandFactoryTest, CreateCommand_RequestFunction_CommandPerMessageType) {
+  EXPECT_TRUE(IsCommandOf<commands::ShowRequest>(CreateCommand(
+      mobile_apis::FunctionID::ShowID, mobile_apis::messageType::request)));
+  EXPECT_TRUE(IsCommandOf<commands::ShowResponse>(CreateCommand(
+      mobile_apis::FunctionID::ShowID, mobile_apis::messageType::response)));
+  EXPECT_TRUE(IsCommandOf<commands::ShowRequest>(CreateCommand(
+      mobile_apis::FunctionID::ShowID,
+      mobile_apis::messageType::notification)));
+}
+
+TEST(CommandFactoryTest, CreateCommand_NotRequestToRegisterApp_Response) {
+  EXPECT_TRUE(IsCommandOf<commands::RegisterAppInterfaceRequest>(
+      CreateCommand(mobile_apis::FunctionID::RegisterAppInterfaceID,
+                    mobile_apis::messageType::request)));
+  EXPECT_TRUE(IsCommandOf<commands::RegisterAppInterfaceResponse>(
+      CreateCommand(mobile_apis::FunctionID::RegisterAppInterfaceID,
+                    mobile_apis::messageType::notification)));
+}
+
+TEST(CommandFactoryTest, CreateCommand_MapException_CommandFromMap) {
+  EXPECT_TRUE(IsCommandOf<commands::SystemRequest>(CreateCommand(
+      mobile_apis::FunctionID::SystemRequestID,
+      mobile_apis::messageType::request)));
+}
+
+TEST(CommandFactoryTest, CreateCommand_OnHMIStatus_NotificationPerOrigin) {
+  const CommandSharedPtr from_sdl =
+      CreateCommand(mobile_apis::FunctionID::OnHMIStatusID,
+                    mobile_apis::messageType::notification);
+  EXPECT_TRUE(IsCommandOf<commands::OnHMIStatusNotification>(from_sdl));
+  EXPECT_FALSE(
+      IsCommandOf<commands::OnHMIStatusNotificationFromMobile>(from_sdl));
+  EXPECT_TRUE(IsCommandOf<commands::OnHMIStatusNotificationFromMobile>(
+      CreateCommand(mobile_apis::FunctionID::OnHMIStatusID,
+                    mobile_apis::messageType::notification,
+                    commands::Command::ORIGIN_MOBILE)));
+}
+
+TEST(CommandFactoryTest, CreateCommand_UnknownFunction_GenericResponse) {
+  const mobile_apis::FunctionID::eType function_ids[] = {
+    mobile_apis::FunctionID::RESERVED,
+    mobile_apis::FunctionID::GenericResponseID,
+    mobile_apis::FunctionID::OnSyncPDataID
+  };
+  for (size_t i = 0; i < sizeof(function_ids) / sizeof(*function_ids); ++i) {
+    const commands::MessageSharedPtr message =
+        CreateMessage(function_ids[i], mobile_apis::messageType::request);
+    const CommandSharedPtr command(MobileCommandFactory::CreateCommand(
+        message, commands::Command::ORIGIN_SDL));
+    EXPECT_TRUE(IsCommandOf<commands::GenericResponse>(command));
+    EXPECT_EQ(mobile_apis::FunctionID::GenericResponseID,
+              (*message)[strings::params][strings::function_id].asInt());
+  }
+}
+
+TEST(CommandFactoryTest, CreateHMICommand_RequestFunction_CommandPerMessageType) {
+  EXPECT_TRUE(IsCommandOf<commands::UIShowRequest>(CreateHMICommand(
+      hmi_apis::FunctionID::UI_Show, MessageType::kRequest)));
+  EXPECT_TRUE(IsCommandOf<commands::UIShowResponse>(CreateHMICommand(
+      hmi_apis::FunctionID::UI_Show, MessageType::kResponse)));
+  EXPECT_TRUE(IsCommandOf<commands::UIShowResponse>(CreateHMICommand(
+      hmi_apis::FunctionID::UI_Show, MessageType::kErrorResponse)));
+  EXPECT_TRUE(IsCommandOf<commands::UIShowRequest>(CreateHMICommand(
+      hmi_apis::FunctionID::UI_Show, MessageType::kNotification)));
+}
+
+TEST(CommandFactoryTest, CreateHMICommand_NotificationFunction_SameCommand) {
+  EXPECT_TRUE(IsCommandOf<commands::OnTTSStartedNotification>(
+      CreateHMICommand(hmi_apis::FunctionID::TTS_Started,
+                       MessageType::kNotification)));
+  EXPECT_TRUE(IsCommandOf<commands::OnTTSStartedNotification>(
+      CreateHMICommand(hmi_apis::FunctionID::TTS_Started,
+                       MessageType::kResponse)));
+}
+
+TEST(CommandFactoryTest, CreateHMICommand_FunctionWithoutCommand_Stub) {
+  const CommandSharedPtr command = CreateHMICommand(
+      hmi_apis::FunctionID::UI_ShowCustomForm, MessageType::kRequest);
+  ASSERT_TRUE(command.valid());
+  EXPECT_TRUE(typeid(commands::CommandImpl) == typeid(*command));
+
+  const CommandSharedPtr unknown = CreateHMICommand(
+      static_cast<hmi_apis::FunctionID::eType>(-2), MessageType::kRequest);
+  ASSERT_TRUE(unknown.valid());
+  EXPECT_TRUE(typeid(commands::CommandImpl) == typeid(*unknown));
+}
+
+TEST(CommandFactoryTest, CreateCommand_Command_PooledByItsOwnSize) {
+  const size_t object_class = ObjectClassOf(sizeof(commands::ShowResponse));
+  CreateCommand(mobile_apis::FunctionID::ShowID,
+                mobile_apis::messageType::response);
+  const utils::MemoryPool::Statistics before =
+      utils::MemoryPool::object_statistics(object_class);
+
+  CreateCommand(mobile_apis::FunctionID::ShowID,
+                mobile_apis::messageType::response);
+  const utils::MemoryPool::Statistics after =
+      utils::MemoryPool::object_statistics(object_class);
+
+  EXPECT_EQ(before.allocations + 1, after.allocations);
+  EXPECT_EQ(before.releases + 1, after.releases);
+  EXPECT_EQ(before.system_allocations, after.system_allocations);
+}
+
+TEST(CommandFactoryTest, DISABLED_Benchmark_CreateAndDestroyCommands) {
+  const uint32_t iterations = 100000;
+  const commands::MessageSharedPtr messages[] = {
+    CreateMessage(mobile_apis::FunctionID::OnHMIStatusID,
+                  mobile_apis::messageType::notification),
+    CreateMessage(mobile_apis::FunctionID::ShowID,
+                  mobile_apis::messageType::response),
+    CreateMessage(mobile_apis::FunctionID::ShowID,
+                  mobile_apis::messageType::request)
+  };
+  const char* names[] = { "OnHMIStatus notification", "Show response",
+                          "Show request" };
+
+  for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); ++i) {
+    const utils::MemoryPool::Statistics before = PoolStatistics();
+    timeval start;
+    gettimeofday(&start, NULL);
+    for (uint32_t j = 0; j < iterations; ++j) {
+      utils::SharedPtr<commands::Command> command(
+          MobileCommandFactory::CreateCommand(
+              messages[i], commands::Command::ORIGIN_SDL));
+      ASSERT_TRUE(command.valid());
+    }
+    const double elapsed_ms = MillisecondsSince(start);
+    const utils::MemoryPool::Statistics after = PoolStatistics();
+
+    const uint32_t allocations = after.allocations - before.allocations;
+    const uint32_t system_allocations =
+        after.system_allocations - before.system_allocations;
+    printf("%s: %.0f commands created and destroyed per second, "
+           "%u of %u allocated from system heap\n",
+           names[i], iterations * 1000.0 / elapsed_ms,
+           system_allocations, allocations);
+    EXPECT_EQ(iterations, allocations);
+    EXPECT_EQ(allocations, after.releases - before.releases);
+    // Block released by previous command is reused by the next one
+    EXPECT_GE(1u, system_allocations);
+  }
+}
+
+}  // namespace application_manager
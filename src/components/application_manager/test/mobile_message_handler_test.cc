@@ -31,8 +31,18 @@
  */
 
 
+#include <stdio.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "application_manager/mobile_message_handler.h"
+#include "formatters/CFormatterJsonSDLRPCv2.hpp"
+#include "protocol_handler/protocol_payload.h"
+#include "interfaces/MOBILE_API.h"
+#include "utils/shared_ptr.h"
 
 
 using ::testing::_;
@@ -50,4 +60,303 @@ TEST(mobile_message_test, basic_test) {
   EXPECT_TRUE(message->has_binary_data());
 }
 
+namespace {
+const uint32_t kRecipientsCount = 50;
+
+smart_objects::SmartObject CreateOnDriverDistraction(uint32_t connection_key) {
+  smart_objects::SmartObject message(smart_objects::SmartType_Map);
+  message["params"]["function_id"] =
+      mobile_apis::FunctionID::OnDriverDistractionID;
+  message["params"]["message_type"] = mobile_apis::messageType::notification;
+  message["params"]["protocol_type"] = 0;
+  message["params"]["protocol_version"] = kV3;
+  message["params"]["connection_key"] = connection_key;
+  message["msg_params"]["state"] = mobile_apis::DriverDistractionState::DD_ON;
+  return message;
+}
+
+MobileMessage FormatMessage(const smart_objects::SmartObject& object) {
+  std::string json;
+  NsSmartDeviceLink::NsJSONHandler::Formatters::CFormatterJsonSDLRPCv2::
+      toString(object, json);
+  MobileMessage message = new Message(
+      protocol_handler::MessagePriority::kDefault);
+  message->set_function_id(object["params"]["function_id"].asInt());
+  message->set_message_type(kNotification);
+  message->set_connection_key(object["params"]["connection_key"].asInt());
+  message->set_protocol_version(kV3);
+  message->set_json_message(json);
+  return message;
+}
+
+MobileMessage CreateRecipientMessage(
+    const protocol_handler::SharedPayload& payload, uint32_t connection_key) {
+  MobileMessage message = new Message(
+      protocol_handler::MessagePriority::kDefault);
+  message->set_function_id(mobile_apis::FunctionID::OnDriverDistractionID);
+  message->set_message_type(kNotification);
+  message->set_connection_key(connection_key);
+  message->set_protocol_version(kV3);
+  message->set_serialized_payload(payload);
+  return message;
+}
+
+const size_t kBinaryResponseSize = 64 * 1024;
+
+smart_objects::SmartObject CreateOnHMIStatus() {
+  smart_objects::SmartObject message(smart_objects::SmartType_Map);
+  message["params"]["function_id"] = mobile_apis::FunctionID::OnHMIStatusID;
+  message["params"]["message_type"] = mobile_apis::messageType::notification;
+  message["params"]["protocol_type"] = 0;
+  message["params"]["protocol_version"] = kV3;
+  message["params"]["connection_key"] = 1;
+  message["msg_params"]["hmiLevel"] = mobile_apis::HMILevel::HMI_FULL;
+  message["msg_params"]["audioStreamingState"] =
+      mobile_apis::AudioStreamingState::AUDIBLE;
+  message["msg_params"]["systemContext"] =
+      mobile_apis::SystemContext::SYSCTXT_MAIN;
+  return message;
+}
+
+smart_objects::SmartObject CreateBinaryResponse() {
+  smart_objects::SmartObject message(smart_objects::SmartType_Map);
+  message["params"]["function_id"] = mobile_apis::FunctionID::SystemRequestID;
+  message["params"]["message_type"] = mobile_apis::messageType::response;
+  message["params"]["protocol_type"] = 0;
+  message["params"]["protocol_version"] = kV3;
+  message["params"]["connection_key"] = 1;
+  message["params"]["correlation_id"] = 7;
+  message["params"]["binary_data"] =
+      smart_objects::SmartObject(BinaryData(kBinaryResponseSize, 'X'));
+  message["msg_params"]["success"] = true;
+  message["msg_params"]["resultCode"] = mobile_apis::Result::SUCCESS;
+  return message;
+}
+
+void SetHeaderFields(const smart_objects::SmartObject& object,
+                     Message* message) {
+  message->set_function_id(object["params"]["function_id"].asInt());
+  message->set_correlation_id(object["params"]["correlation_id"].asInt());
+  message->set_message_type(static_cast<MessageType>(
+      object["params"]["message_type"].asInt()));
+  message->set_connection_key(object["params"]["connection_key"].asInt());
+  message->set_protocol_version(kV3);
+}
+
+const BinaryData* GetBinaryData(const smart_objects::SmartObject& object) {
+  if (!object["params"].keyExists("binary_data")) {
+    return NULL;
+  }
+  return &object["params"]["binary_data"].asBinary();
+}
+
+// Json and binary data are kept by message and copied from it into payload
+protocol_handler::SharedPayload SerializeThroughMessage(
+    const smart_objects::SmartObject& object, size_t* copied_bytes) {
+  std::string json;
+  NsSmartDeviceLink::NsJSONHandler::Formatters::CFormatterJsonSDLRPCv2::
+      toString(object, json);
+  MobileMessage message = new Message(
+      protocol_handler::MessagePriority::kDefault);
+  SetHeaderFields(object, message.get());
+  message->set_json_message(json);
+  *copied_bytes += json.size();
+  const BinaryData* binary_data = GetBinaryData(object);
+  if (binary_data) {
+    message->set_binary_data(new BinaryData(*binary_data));
+    *copied_bytes += binary_data->size();
+  }
+  const protocol_handler::SharedPayload payload =
+      MobileMessageHandler::SerializeOutgoingMessage(message);
+  *copied_bytes += payload->size();
+  return payload;
+}
+
+// Json and binary data are copied right into payload
+protocol_handler::SharedPayload SerializeOnce(
+    const smart_objects::SmartObject& object, size_t* copied_bytes) {
+  std::string json;
+  NsSmartDeviceLink::NsJSONHandler::Formatters::CFormatterJsonSDLRPCv2::
+      toString(object, json);
+  Message message(protocol_handler::MessagePriority::kDefault);
+  SetHeaderFields(object, &message);
+  const protocol_handler::SharedPayload payload =
+      MobileMessageHandler::SerializeOutgoingMessage(message, json,
+                                                     GetBinaryData(object));
+  *copied_bytes += payload->size();
+  return payload;
+}
+
+double MillisecondsSince(const timeval& start) {
+  timeval now;
+  gettimeofday(&now, NULL);
+  return (now.tv_sec - start.tv_sec) * 1000.0 +
+      (now.tv_usec - start.tv_usec) / 1000.0;
+}
+}  // namespace
+
+TEST(mobile_message_test, SharedPayload_SameBytesAsUnicast) {
+  const MobileMessage unicast = FormatMessage(CreateOnDriverDistraction(1));
+  utils::SharedPtr<protocol_handler::RawMessage> expected(
+      MobileMessageHandler::HandleOutgoingMessageProtocol(unicast));
+  ASSERT_TRUE(expected.valid());
+
+  const protocol_handler::SharedPayload payload =
+      MobileMessageHandler::SerializeOutgoingMessage(unicast);
+  ASSERT_TRUE(payload.valid());
+
+  for (uint32_t key = 1; key <= 3; ++key) {
+    utils::SharedPtr<protocol_handler::RawMessage> raw(
+        MobileMessageHandler::HandleOutgoingMessageProtocol(
+            CreateRecipientMessage(payload, key)));
+    ASSERT_TRUE(raw.valid());
+    EXPECT_EQ(key, raw->connection_key());
+    EXPECT_EQ(expected->service_type(), raw->service_type());
+    EXPECT_EQ(expected->protocol_version(), raw->protocol_version());
+    ASSERT_EQ(expected->data_size(), raw->data_size());
+    EXPECT_EQ(0, memcmp(expected->data(), raw->data(), raw->data_size()));
+    // Bytes are referenced, not copied
+    EXPECT_EQ(&payload->front(), raw->data());
+  }
+}
+
+TEST(mobile_message_test, SerializeV1_NullTerminatedJson) {
+  MobileMessage message = new Message(
+      protocol_handler::MessagePriority::kDefault);
+  message->set_protocol_version(kV1);
+  message->set_json_message("{}");
+
+  const protocol_handler::SharedPayload payload =
+      MobileMessageHandler::SerializeOutgoingMessage(message);
+  ASSERT_TRUE(payload.valid());
+  ASSERT_EQ(3u, payload->size());
+  EXPECT_EQ('\0', static_cast<char>(payload->back()));
+
+  message->set_json_message("");
+  EXPECT_FALSE(MobileMessageHandler::SerializeOutgoingMessage(message).valid());
+}
+
+TEST(mobile_message_test, DISABLED_Benchmark_OnDriverDistractionToFiftyApps) {
+  const uint32_t iterations = 200;
+  size_t unicast_bytes = 0;
+  size_t multicast_bytes = 0;
+
+  timeval start;
+  gettimeofday(&start, NULL);
+  for (uint32_t i = 0; i < iterations; ++i) {
+    for (uint32_t key = 1; key <= kRecipientsCount; ++key) {
+      const MobileMessage message =
+          FormatMessage(CreateOnDriverDistraction(key));
+      utils::SharedPtr<protocol_handler::RawMessage> raw(
+          MobileMessageHandler::HandleOutgoingMessageProtocol(message));
+      unicast_bytes += message->json_message().size() + raw->data_size();
+    }
+  }
+  const double unicast_ms = MillisecondsSince(start);
+
+  gettimeofday(&start, NULL);
+  for (uint32_t i = 0; i < iterations; ++i) {
+    const MobileMessage message = FormatMessage(CreateOnDriverDistraction(1));
+    const protocol_handler::SharedPayload payload =
+        MobileMessageHandler::SerializeOutgoingMessage(message);
+    multicast_bytes += message->json_message().size() + payload->size();
+    for (uint32_t key = 1; key <= kRecipientsCount; ++key) {
+      utils::SharedPtr<protocol_handler::RawMessage> raw(
+          MobileMessageHandler::HandleOutgoingMessageProtocol(
+              CreateRecipientMessage(payload, key)));
+      ASSERT_TRUE(raw.valid());
+    }
+  }
+  const double multicast_ms = MillisecondsSince(start);
+
+  printf("OnDriverDistraction to %u apps, %u times:\n"
+         "  formatted per app: %.1f ms, %zu bytes formatted\n"
+         "  formatted once:    %.1f ms, %zu bytes formatted\n",
+         kRecipientsCount, iterations,
+         unicast_ms, unicast_bytes, multicast_ms, multicast_bytes);
+  EXPECT_EQ(unicast_bytes, multicast_bytes * kRecipientsCount);
+}
+
+TEST(mobile_message_test, SerializeOnce_SameBytesAsThroughMessage) {
+  const smart_objects::SmartObject response = CreateBinaryResponse();
+  size_t copied_bytes = 0;
+  const protocol_handler::SharedPayload expected =
+      SerializeThroughMessage(response, &copied_bytes);
+  const protocol_handler::SharedPayload payload =
+      SerializeOnce(response, &copied_bytes);
+  ASSERT_TRUE(payload.valid());
+  ASSERT_EQ(expected->size(), payload->size());
+  EXPECT_TRUE(std::equal(expected->begin(), expected->end(),
+                         payload->begin()));
+
+  protocol_handler::ProtocolPayloadV2 parsed;
+  ASSERT_TRUE(protocol_handler::ParsePayloadV2(&payload->front(),
+                                               payload->size(), &parsed));
+  EXPECT_EQ(protocol_handler::kRpcTypeResponse, parsed.header.rpc_type);
+  EXPECT_EQ(7u, parsed.header.correlation_id);
+  EXPECT_EQ(kBinaryResponseSize, parsed.data.size());
 }
+
+TEST(mobile_message_test, SerializedPayloadWithBinaryData_SentAsBulk) {
+  size_t copied_bytes = 0;
+  MobileMessage message = new Message(
+      protocol_handler::MessagePriority::kDefault);
+  SetHeaderFields(CreateBinaryResponse(), message.get());
+  message->set_serialized_payload(
+      SerializeOnce(CreateBinaryResponse(), &copied_bytes), true);
+
+  utils::SharedPtr<protocol_handler::RawMessage> raw(
+      MobileMessageHandler::HandleOutgoingMessageProtocol(message));
+  ASSERT_TRUE(raw.valid());
+  EXPECT_EQ(protocol_handler::kBulk, raw->service_type());
+  EXPECT_EQ(&message->serialized_payload()->front(), raw->data());
+}
+
+TEST(mobile_message_test, SerializeOnce_BinaryResponse_FewerBytesCopied) {
+  const smart_objects::SmartObject response = CreateBinaryResponse();
+  size_t through_message_bytes = 0;
+  SerializeThroughMessage(response, &through_message_bytes);
+  size_t once_bytes = 0;
+  const protocol_handler::SharedPayload payload =
+      SerializeOnce(response, &once_bytes);
+
+  ASSERT_TRUE(payload.valid());
+  EXPECT_EQ(payload->size(), once_bytes);
+  // Json and binary data are not copied into message first
+  EXPECT_LT(once_bytes + kBinaryResponseSize, through_message_bytes);
+}
+
+TEST(mobile_message_test, DISABLED_Benchmark_BytesCopiedPerMessage) {
+  const uint32_t iterations = 1000;
+  const smart_objects::SmartObject messages[] = {
+    CreateOnHMIStatus(), CreateBinaryResponse()
+  };
+  const char* names[] = { "OnHMIStatus", "64 KB binary response" };
+
+  for (size_t i = 0; i < sizeof(messages) / sizeof(messages[0]); ++i) {
+    size_t through_message_bytes = 0;
+    timeval start;
+    gettimeofday(&start, NULL);
+    for (uint32_t j = 0; j < iterations; ++j) {
+      SerializeThroughMessage(messages[i], &through_message_bytes);
+    }
+    const double through_message_ms = MillisecondsSince(start);
+
+    size_t once_bytes = 0;
+    gettimeofday(&start, NULL);
+    for (uint32_t j = 0; j < iterations; ++j) {
+      SerializeOnce(messages[i], &once_bytes);
+    }
+    const double once_ms = MillisecondsSince(start);
+
+    printf("%s, %u times:\n"
+           "  copied through message: %.1f ms, %zu bytes per message\n"
+           "  copied once:            %.1f ms, %zu bytes per message\n",
+           names[i], iterations,
+           through_message_ms, through_message_bytes / iterations,
+           once_ms, once_bytes / iterations);
+    EXPECT_LT(once_bytes, through_message_bytes);
+  }
+}
+
+}  // namespace application_manager
@@ -0,0 +1 @@
+../../../../include/application_manager/application_registry.h
\ No newline at end of file
@@ -352,6 +352,22 @@ class Profile : public utils::Singleton<Profile> {
      */
     uint16_t transport_manager_tcp_adapter_port() const;
 
+    /**
+     * @brief Returns number of IN transfers kept submitted by USB connection
+     */
+    size_t usb_in_transfers_count() const;
+
+    /**
+     * @brief Returns buffer size of USB IN transfer
+     */
+    size_t usb_in_transfer_size() const;
+
+    /**
+     * @brief Returns limit of bytes of messages coalesced
+     * into one USB OUT transfer
+     */
+    size_t usb_out_transfer_size() const;
+
     /**
      * @brief Returns value of timeout after which sent
      * tts global properties for VCA
@@ -505,6 +521,33 @@ class Profile : public utils::Singleton<Profile> {
 
     size_t malformed_frequency_time() const;
 
+    /**
+     * @return milliseconds to wait for next frame of multiframe message
+     */
+    size_t multiframe_waiting_timeout() const;
+
+    /**
+     * @return bytes of incomplete multiframe messages of one connection
+     */
+    size_t multiframe_connection_buffer_size() const;
+
+    /**
+     * @return bytes of all incomplete multiframe messages
+     */
+    size_t multiframe_total_buffer_size() const;
+
+    /**
+     * @return count of threads processing incoming transport data,
+     * frames of one connection are always processed by the same thread
+     */
+    size_t inbound_workers_count() const;
+
+    /**
+     * @return count of threads sending outgoing frames,
+     * frames of one connection are always sent by the same thread
+     */
+    size_t outgoing_workers_count() const;
+
     uint16_t attempts_to_open_policy_db() const;
 
     uint16_t open_attempt_timeout_ms() const;
@@ -136,6 +136,9 @@ const char* kAppHmiLevelNoneRequestsTimeScaleKey =
 const char* kPendingRequestsAmoundKey = "PendingRequestsAmount";
 const char* kSupportedDiagModesKey = "SupportedDiagModes";
 const char* kTransportManagerDisconnectTimeoutKey = "DisconnectTimeout";
+const char* kUsbInTransfersCountKey = "UsbInTransfersCount";
+const char* kUsbInTransferSizeKey = "UsbInTransferSize";
+const char* kUsbOutTransferSizeKey = "UsbOutTransferSize";
 const char* kTTSDelimiterKey = "TTSDelimiter";
 const char* kRecordingFileNameKey = "RecordingFileName";
 const char* kRecordingFileSourceKey = "RecordingFileSource";
@@ -161,6 +164,12 @@ const char* kFrequencyTime = "FrequencyTime";
 const char* kMalformedMessageFiltering = "MalformedMessageFiltering";
 const char* kMalformedFrequencyCount = "MalformedFrequencyCount";
 const char* kMalformedFrequencyTime = "MalformedFrequencyTime";
+const char* kMultiFrameWaitingTimeoutKey = "MultiFrameWaitingTimeout";
+const char* kMultiFrameConnectionBufferSizeKey =
+    "MultiFrameConnectionBufferSize";
+const char* kMultiFrameTotalBufferSizeKey = "MultiFrameTotalBufferSize";
+const char* kInboundWorkersCountKey = "InboundWorkersCount";
+const char* kOutgoingWorkersCountKey = "OutgoingWorkersCount";
 const char* kHashStringSizeKey = "HashStringSize";
 
 #ifdef WEB_HMI
@@ -214,6 +223,9 @@ const uint32_t kDefaultAppHmiLevelNoneTimeScaleMaxRequests = 100;
 const uint32_t kDefaultAppHmiLevelNoneRequestsTimeScale = 10;
 const uint32_t kDefaultPendingRequestsAmount = 0;
 const uint32_t kDefaultTransportManagerDisconnectTimeout = 0;
+const size_t kDefaultUsbInTransfersCount = 4;
+const size_t kDefaultUsbInTransferSize = 16 * 1024;
+const size_t kDefaultUsbOutTransferSize = 64 * 1024;
 const uint32_t kDefaultApplicationListUpdateTimeout = 1;
 const std::pair<uint32_t, uint32_t> kReadDIDFrequency = { 5, 1 };
 const std::pair<uint32_t, uint32_t> kGetVehicleDataFrequency = { 5, 1 };
@@ -229,6 +241,11 @@ const size_t kDefaultFrequencyTime = 1000;
 const bool kDefaulMalformedMessageFiltering = true;
 const size_t kDefaultMalformedFrequencyCount = 10;
 const size_t kDefaultMalformedFrequencyTime = 1000;
+const size_t kDefaultMultiFrameWaitingTimeout = 10000;
+const size_t kDefaultMultiFrameConnectionBufferSize = 16 * 1024 * 1024;
+const size_t kDefaultMultiFrameTotalBufferSize = 64 * 1024 * 1024;
+const size_t kDefaultInboundWorkersCount = 4;
+const size_t kDefaultOutgoingWorkersCount = 4;
 const uint16_t kDefaultAttemptsToOpenPolicyDB = 5;
 const uint16_t kDefaultOpenAttemptTimeoutMsKey = 500;
 const uint32_t kDefaultAppIconsFolderMaxSize = 1048576;
@@ -669,6 +686,64 @@ size_t Profile::malformed_frequency_time() const {
   return malformed_frequency_time;
 }
 
+size_t Profile::multiframe_waiting_timeout() const {
+  size_t multiframe_waiting_timeout = 0;
+  ReadUIntValue(&multiframe_waiting_timeout, kDefaultMultiFrameWaitingTimeout,
+                kProtocolHandlerSection, kMultiFrameWaitingTimeoutKey);
+  return multiframe_waiting_timeout;
+}
+
+size_t Profile::multiframe_connection_buffer_size() const {
+  size_t multiframe_connection_buffer_size = 0;
+  ReadUIntValue(&multiframe_connection_buffer_size,
+                kDefaultMultiFrameConnectionBufferSize,
+                kProtocolHandlerSection, kMultiFrameConnectionBufferSizeKey);
+  return multiframe_connection_buffer_size;
+}
+
+size_t Profile::multiframe_total_buffer_size() const {
+  size_t multiframe_total_buffer_size = 0;
+  ReadUIntValue(&multiframe_total_buffer_size,
+                kDefaultMultiFrameTotalBufferSize,
+                kProtocolHandlerSection, kMultiFrameTotalBufferSizeKey);
+  return multiframe_total_buffer_size;
+}
+
+size_t Profile::usb_in_transfers_count() const {
+  size_t usb_in_transfers_count = 0;
+  ReadUIntValue(&usb_in_transfers_count, kDefaultUsbInTransfersCount,
+                kTransportManagerSection, kUsbInTransfersCountKey);
+  return usb_in_transfers_count;
+}
+
+size_t Profile::usb_in_transfer_size() const {
+  size_t usb_in_transfer_size = 0;
+  ReadUIntValue(&usb_in_transfer_size, kDefaultUsbInTransferSize,
+                kTransportManagerSection, kUsbInTransferSizeKey);
+  return usb_in_transfer_size;
+}
+
+size_t Profile::usb_out_transfer_size() const {
+  size_t usb_out_transfer_size = 0;
+  ReadUIntValue(&usb_out_transfer_size, kDefaultUsbOutTransferSize,
+                kTransportManagerSection, kUsbOutTransferSizeKey);
+  return usb_out_transfer_size;
+}
+
+size_t Profile::inbound_workers_count() const {
+  size_t inbound_workers_count = 0;
+  ReadUIntValue(&inbound_workers_count, kDefaultInboundWorkersCount,
+                kProtocolHandlerSection, kInboundWorkersCountKey);
+  return inbound_workers_count;
+}
+
+size_t Profile::outgoing_workers_count() const {
+  size_t outgoing_workers_count = 0;
+  ReadUIntValue(&outgoing_workers_count, kDefaultOutgoingWorkersCount,
+                kProtocolHandlerSection, kOutgoingWorkersCountKey);
+  return outgoing_workers_count;
+}
+
 uint16_t Profile::attempts_to_open_policy_db() const {
   return attempts_to_open_policy_db_;
 }
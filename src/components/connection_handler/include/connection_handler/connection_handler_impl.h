@@ -34,6 +34,7 @@
 #define SRC_COMPONENTS_CONNECTION_HANDLER_INCLUDE_CONNECTION_HANDLER_CONNECTION_HANDLER_IMPL_H_
 
 #include <map>
+#include <set>
 #include <list>
 #include <string>
 #include <vector>
@@ -418,6 +419,18 @@ class ConnectionHandlerImpl : public ConnectionHandler,
    **/
   void RemoveConnection(const ConnectionHandle connection_handle);
 
+  /**
+   * \brief Adds connection to connections list and device index,
+   * connection_list_lock_ shall be acquired for writing
+   */
+  void AddConnectionLocked(Connection* connection);
+
+  /**
+   * \brief Removes connection from connections list and device index,
+   * connection_list_lock_ shall be acquired for writing
+   */
+  void RemoveConnectionLocked(ConnectionList::iterator it);
+
   void OnConnectionEnded(
     const transport_manager::ConnectionUID &connection_id);
 
@@ -444,9 +457,17 @@ class ConnectionHandlerImpl : public ConnectionHandler,
   ConnectionList connection_list_;
 
   /**
-   *  \brief Lock for applications list
+   * \brief Connections of each device, secondary index of connection_list_
+   */
+  typedef std::map<DeviceHandle, std::set<ConnectionHandle> > DeviceConnections;
+  DeviceConnections device_connections_;
+
+  /**
+   * \brief Lock for connections list and device index.
+   * Lookups take it for reading, Connection guards its own sessions.
+   * Shall not be held during observer callbacks.
    */
-  mutable sync_primitives::Lock connection_list_lock_;
+  mutable sync_primitives::RWLock connection_list_lock_;
   mutable sync_primitives::RWLock connection_handler_observer_lock_;
 
   /**
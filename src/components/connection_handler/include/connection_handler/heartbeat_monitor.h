@@ -35,8 +35,6 @@
 #include <stdint.h>
 #include <map>
 
-#include "utils/threads/thread.h"
-#include "utils/threads/thread_delegate.h"
 #include "utils/date_time.h"
 #include "utils/macro.h"
 #include "utils/lock.h"
@@ -46,17 +44,14 @@ namespace connection_handler {
 class Connection;
 
 /*
- * Starts hearbeat timer for session and when it elapses closes it
+ * Starts hearbeat timer for session and when it elapses closes it.
+ * Deadlines of all monitors are served by HeartBeatScheduler thread.
  */
-class HeartBeatMonitor: public threads::ThreadDelegate {
+class HeartBeatMonitor {
  public:
   HeartBeatMonitor(int32_t heartbeat_timeout_seconds,
                    Connection *connection);
-
-  /**
-   * Thread procedure.
-   */
-  virtual void threadMain();
+  ~HeartBeatMonitor();
 
   /**
    * \brief add and remove session
@@ -65,16 +60,21 @@ class HeartBeatMonitor: public threads::ThreadDelegate {
   void RemoveSession(uint8_t session_id);
 
   /**
-  * \brief Resets timer preventing session from being killed
+  * \brief Resets timer preventing session from being killed.
+  * Only moves session expiration, scheduler is not touched.
    */
   void KeepAlive(uint8_t session_id);
 
+  void set_heartbeat_timeout_seconds(int32_t timeout, uint8_t session_id);
+
   /**
-   * \brief Thread exit procedure.
+   * \brief Handles expired deadline of session, called by HeartBeatScheduler
+   * \param deadline deadline which was scheduled, outdated ones are ignored
+   * \param next_deadline next deadline of session
+   * \return true if next_deadline shall be scheduled
    */
-  virtual void exitThreadMain();
-
-  void set_heartbeat_timeout_seconds(int32_t timeout, uint8_t session_id);
+  bool ProcessDeadline(uint8_t session_id, const TimevalStruct& deadline,
+                       TimevalStruct* next_deadline);
 
  private:
 
@@ -83,9 +83,6 @@ class HeartBeatMonitor: public threads::ThreadDelegate {
   // \brief Connection that must be closed when timeout elapsed
   Connection *connection_;
 
-  //Default HeartBeat cycle timeout (in miliseconds)
-  static const int32_t kDefaultCycleTimeout = 100;
-
   class SessionState {
     public:
       explicit SessionState(int32_t heartbeat_timeout_seconds = 0);
@@ -94,6 +91,9 @@ class HeartBeatMonitor: public threads::ThreadDelegate {
       bool IsReadyToClose() const;
       void KeepAlive();
       bool HasTimeoutElapsed();
+      const TimevalStruct& expiration() const;
+      // Deadline queued in scheduler, others are outdated
+      TimevalStruct scheduled_deadline;
     private:
       void RefreshExpiration();
 
@@ -109,13 +109,6 @@ class HeartBeatMonitor: public threads::ThreadDelegate {
   SessionMap sessions_;
 
   sync_primitives::Lock sessions_list_lock_; // recurcive
-  sync_primitives::Lock main_thread_lock_;
-  mutable sync_primitives::Lock heartbeat_timeout_seconds_lock_;
-  sync_primitives::ConditionalVariable heartbeat_monitor_;
-
-  volatile bool run_;
-
-  void Process();
 
   DISALLOW_COPY_AND_ASSIGN(HeartBeatMonitor);
 };
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_CONNECTION_HANDLER_INCLUDE_CONNECTION_HANDLER_HEARTBEAT_SCHEDULER_H_
+#define SRC_COMPONENTS_CONNECTION_HANDLER_INCLUDE_CONNECTION_HANDLER_HEARTBEAT_SCHEDULER_H_
+
+#include <stdint.h>
+#include <queue>
+#include <set>
+#include <vector>
+
+#include "utils/threads/thread.h"
+#include "utils/threads/thread_delegate.h"
+#include "utils/conditional_variable.h"
+#include "utils/date_time.h"
+#include "utils/lock.h"
+#include "utils/macro.h"
+#include "utils/singleton.h"
+
+namespace connection_handler {
+
+class HeartBeatMonitor;
+
+/*
+ * Single thread serving heartbeat deadlines of all connections.
+ * Thread sleeps until the earliest deadline, monitors are called only
+ * for expired deadlines and report the next one of the session.
+ */
+class HeartBeatScheduler : public utils::Singleton<HeartBeatScheduler> {
+ public:
+  ~HeartBeatScheduler();
+
+  /**
+   * \brief Adds deadline of monitor session, starts thread on first use
+   */
+  void Schedule(HeartBeatMonitor* monitor, uint8_t session_id,
+                const TimevalStruct& deadline);
+
+  /**
+   * \brief Drops all deadlines of monitor.
+   * Waits for monitor processing on scheduler thread to finish,
+   * so monitor can be deleted right after.
+   */
+  void Unregister(HeartBeatMonitor* monitor);
+
+  /**
+   * \brief Count of scheduler thread wake ups, for diagnostics
+   */
+  uint32_t wakeups_count() const;
+
+ private:
+  HeartBeatScheduler();
+
+  void Run();
+  void Stop();
+  void ProcessExpired(sync_primitives::AutoLock& auto_lock);
+
+  class Worker : public threads::ThreadDelegate {
+   public:
+    explicit Worker(HeartBeatScheduler* scheduler);
+    void threadMain() OVERRIDE;
+    void exitThreadMain() OVERRIDE;
+   private:
+    HeartBeatScheduler* scheduler_;
+    DISALLOW_COPY_AND_ASSIGN(Worker);
+  };
+
+  struct Deadline {
+    Deadline(const TimevalStruct& time, HeartBeatMonitor* monitor,
+             uint8_t session_id);
+    // Reversed order makes priority_queue top the earliest deadline
+    bool operator<(const Deadline& other) const;
+    TimevalStruct time;
+    HeartBeatMonitor* monitor;
+    uint8_t session_id;
+  };
+
+  std::priority_queue<Deadline, std::vector<Deadline> > deadlines_;
+  std::set<HeartBeatMonitor*> monitors_;
+  // Monitor processed on scheduler thread right now
+  HeartBeatMonitor* active_monitor_;
+  threads::PlatformThreadHandle worker_thread_id_;
+
+  mutable sync_primitives::Lock lock_;
+  sync_primitives::ConditionalVariable deadline_changed_;
+  sync_primitives::ConditionalVariable processing_finished_;
+
+  threads::Thread* thread_;
+  bool run_;
+  uint32_t wakeups_count_;
+
+  FRIEND_BASE_SINGLETON_CLASS(HeartBeatScheduler);
+  DISALLOW_COPY_AND_ASSIGN(HeartBeatScheduler);
+};
+
+}  // namespace connection_handler
+
+#endif  // SRC_COMPONENTS_CONNECTION_HANDLER_INCLUDE_CONNECTION_HANDLER_HEARTBEAT_SCHEDULER_H_
@@ -85,16 +85,11 @@ Connection::Connection(ConnectionHandle connection_handle,
   DCHECK(connection_handler_);
 
   heartbeat_monitor_ = new HeartBeatMonitor(heartbeat_timeout, this);
-  heart_beat_monitor_thread_ = threads::CreateThread("HeartBeatMonitor",
-                                                     heartbeat_monitor_);
-  heart_beat_monitor_thread_->start();
 }
 
 Connection::~Connection() {
   LOG4CXX_AUTO_TRACE(logger_);
-  heart_beat_monitor_thread_->join();
   delete heartbeat_monitor_;
-  threads::DeleteThread(heart_beat_monitor_thread_);
   sync_primitives::AutoLock lock(session_map_lock_);
   session_map_.clear();
 }
@@ -71,7 +71,7 @@ ConnectionHandlerImpl::ConnectionHandlerImpl()
   : connection_handler_observer_(NULL),
     transport_manager_(NULL),
     protocol_handler_(NULL),
-    connection_list_lock_(true),
+    connection_list_lock_(),
     connection_handler_observer_lock_(),
     connection_list_deleter_(&connection_list_) {
 }
@@ -82,10 +82,18 @@ ConnectionHandlerImpl::~ConnectionHandlerImpl() {
 
 void ConnectionHandlerImpl::Stop() {
   LOG4CXX_AUTO_TRACE(logger_);
-  ConnectionList::iterator itr = connection_list_.begin();
-  while (itr != connection_list_.end()) {
-    RemoveConnection(itr->second->connection_handle());
-    itr = connection_list_.begin();
+  std::vector<ConnectionHandle> connections_to_remove;
+  {
+    sync_primitives::AutoReadLock lock(connection_list_lock_);
+    for (ConnectionList::const_iterator it = connection_list_.begin();
+         it != connection_list_.end(); ++it) {
+      connections_to_remove.push_back(it->first);
+    }
+  }
+  std::vector<ConnectionHandle>::const_iterator it =
+      connections_to_remove.begin();
+  for (; it != connections_to_remove.end(); ++it) {
+    RemoveConnection(*it);
   }
 }
 
@@ -166,13 +174,11 @@ void ConnectionHandlerImpl::OnDeviceRemoved(
 
   std::vector<ConnectionHandle> connections_to_remove;
   {
-    sync_primitives::AutoLock lock(connection_list_lock_);
-    for (ConnectionList::iterator it = connection_list_.begin();
-         it != connection_list_.end(); ++it) {
-      if (device_info.device_handle() ==
-          (*it).second->connection_device_handle()) {
-        connections_to_remove.push_back((*it).first);
-      }
+    sync_primitives::AutoReadLock lock(connection_list_lock_);
+    DeviceConnections::const_iterator it =
+        device_connections_.find(device_info.device_handle());
+    if (device_connections_.end() != it) {
+      connections_to_remove.assign(it->second.begin(), it->second.end());
     }
   }
 
@@ -209,12 +215,10 @@ void ConnectionHandlerImpl::OnConnectionEstablished(
     return;
   }
   LOG4CXX_DEBUG(logger_, "Add Connection #" << connection_id << " to the list.");
-  sync_primitives::AutoLock lock(connection_list_lock_);
-  connection_list_.insert(
-      ConnectionList::value_type(
-          connection_id,
-          new Connection(connection_id, device_info.device_handle(), this,
-                         HeartBeatTimeout())));
+  sync_primitives::AutoWriteLock lock(connection_list_lock_);
+  AddConnectionLocked(
+      new Connection(connection_id, device_info.device_handle(), this,
+                     HeartBeatTimeout()));
 }
 
 void ConnectionHandlerImpl::OnConnectionFailed(
@@ -267,6 +271,33 @@ void ConnectionHandlerImpl::RemoveConnection(
   OnConnectionEnded(connection_handle);
 }
 
+void ConnectionHandlerImpl::AddConnectionLocked(Connection* connection) {
+  const std::pair<ConnectionList::iterator, bool> result =
+      connection_list_.insert(ConnectionList::value_type(
+          connection->connection_handle(), connection));
+  if (!result.second) {
+    LOG4CXX_ERROR(logger_, "Connection #" << connection->connection_handle()
+                  << " already exists");
+    delete connection;
+    return;
+  }
+  device_connections_[connection->connection_device_handle()].insert(
+      connection->connection_handle());
+}
+
+void ConnectionHandlerImpl::RemoveConnectionLocked(
+    ConnectionList::iterator it) {
+  DeviceConnections::iterator device_it =
+      device_connections_.find(it->second->connection_device_handle());
+  if (device_connections_.end() != device_it) {
+    device_it->second.erase(it->first);
+    if (device_it->second.empty()) {
+      device_connections_.erase(device_it);
+    }
+  }
+  connection_list_.erase(it);
+}
+
 #ifdef ENABLE_SECURITY
 namespace {
 bool AllowProtection(const protocol_handler::ServiceType &service_type,
@@ -313,49 +344,57 @@ uint32_t ConnectionHandlerImpl::OnSessionStartedCallback(
     return 0;
   }
 #endif  // ENABLE_SECURITY
-  sync_primitives::AutoLock lock(connection_list_lock_);
-  ConnectionList::iterator it = connection_list_.find(connection_handle);
-  if (connection_list_.end() == it) {
-    LOG4CXX_ERROR(logger_, "Unknown connection!");
-    return 0;
-  }
   uint32_t new_session_id = 0;
-
-  Connection *connection = it->second;
-  if ((0 == session_id) && (protocol_handler::kRpc == service_type)) {
-    new_session_id = connection->AddNewSession();
-    if (0 == new_session_id) {
-      LOG4CXX_ERROR(logger_, "Couldn't start new session!");
+  DeviceHandle device_handle = 0;
+  {
+    sync_primitives::AutoReadLock lock(connection_list_lock_);
+    ConnectionList::iterator it = connection_list_.find(connection_handle);
+    if (connection_list_.end() == it) {
+      LOG4CXX_ERROR(logger_, "Unknown connection!");
       return 0;
     }
-    if (hash_id) {
-      *hash_id = KeyFromPair(connection_handle, new_session_id);
-    }
-  } else {  // Could be create new service or protected exists one
-    if (!connection->AddNewService(session_id, service_type, is_protected)) {
-      LOG4CXX_ERROR(logger_, "Couldn't establish "
+
+    Connection *connection = it->second;
+    device_handle = connection->connection_device_handle();
+    if ((0 == session_id) && (protocol_handler::kRpc == service_type)) {
+      new_session_id = connection->AddNewSession();
+      if (0 == new_session_id) {
+        LOG4CXX_ERROR(logger_, "Couldn't start new session!");
+        return 0;
+      }
+      if (hash_id) {
+        *hash_id = KeyFromPair(connection_handle, new_session_id);
+      }
+    } else {  // Could be create new service or protected exists one
+      if (!connection->AddNewService(session_id, service_type, is_protected)) {
+        LOG4CXX_ERROR(logger_, "Couldn't establish "
 #ifdef ENABLE_SECURITY
-                    << (is_protected ? "protected" : "non-protected")
+                      << (is_protected ? "protected" : "non-protected")
 #endif  // ENABLE_SECURITY
-                    << " service " << static_cast<int>(service_type)
-                    << " for session " << static_cast<int>(session_id));
-      return 0;
-    }
-    new_session_id = session_id;
-    if (hash_id) {
-      *hash_id = protocol_handler::HASH_ID_NOT_SUPPORTED;
+                      << " service " << static_cast<int>(service_type)
+                      << " for session " << static_cast<int>(session_id));
+        return 0;
+      }
+      new_session_id = session_id;
+      if (hash_id) {
+        *hash_id = protocol_handler::HASH_ID_NOT_SUPPORTED;
+      }
     }
   }
   sync_primitives::AutoReadLock read_lock(connection_handler_observer_lock_);
   if (connection_handler_observer_) {
     const uint32_t session_key = KeyFromPair(connection_handle, new_session_id);
     const bool success = connection_handler_observer_->OnServiceStartedCallback(
-          connection->connection_device_handle(), session_key, service_type);
+          device_handle, session_key, service_type);
     if (!success) {
-      if (protocol_handler::kRpc == service_type) {
-        connection->RemoveSession(new_session_id);
-      } else {
-        connection->RemoveService(session_id, service_type);
+      sync_primitives::AutoReadLock lock(connection_list_lock_);
+      ConnectionList::iterator it = connection_list_.find(connection_handle);
+      if (connection_list_.end() != it) {
+        if (protocol_handler::kRpc == service_type) {
+          it->second->RemoveSession(new_session_id);
+        } else {
+          it->second->RemoveService(session_id, service_type);
+        }
       }
       return 0;
     }
@@ -399,42 +438,41 @@ uint32_t ConnectionHandlerImpl::OnSessionEndedCallback(
     const protocol_handler::ServiceType &service_type) {
   LOG4CXX_AUTO_TRACE(logger_);
 
-  connection_list_lock_.Acquire();
-  ConnectionList::iterator it = connection_list_.find(connection_handle);
-  if (connection_list_.end() == it) {
-    LOG4CXX_WARN(logger_, "Unknown connection!");
-    return 0;
-  }
-  std::pair<int32_t, Connection*> connection_item = *it;
-  connection_list_lock_.Release();
-
-  Connection *connection = connection_item.second;
   const uint32_t session_key = KeyFromPair(connection_handle, session_id);
-
-  if (protocol_handler::kRpc == service_type) {
-    LOG4CXX_INFO(logger_, "Session "  << static_cast<uint32_t>(session_id)
-                 << " to be removed");
-    // old version of protocol doesn't support hash
-    if (protocol_handler::HASH_ID_NOT_SUPPORTED != hashCode) {
-      if (protocol_handler::HASH_ID_WRONG == hashCode ||
-          session_key != hashCode) {
-        LOG4CXX_WARN(logger_, "Wrong hash_id for session "
+  {
+    sync_primitives::AutoReadLock lock(connection_list_lock_);
+    ConnectionList::iterator it = connection_list_.find(connection_handle);
+    if (connection_list_.end() == it) {
+      LOG4CXX_WARN(logger_, "Unknown connection!");
+      return 0;
+    }
+    Connection *connection = it->second;
+
+    if (protocol_handler::kRpc == service_type) {
+      LOG4CXX_INFO(logger_, "Session "  << static_cast<uint32_t>(session_id)
+                   << " to be removed");
+      // old version of protocol doesn't support hash
+      if (protocol_handler::HASH_ID_NOT_SUPPORTED != hashCode) {
+        if (protocol_handler::HASH_ID_WRONG == hashCode ||
+            session_key != hashCode) {
+          LOG4CXX_WARN(logger_, "Wrong hash_id for session "
+                       << static_cast<uint32_t>(session_id));
+          return 0;
+        }
+      }
+      if (!connection->RemoveSession(session_id)) {
+        LOG4CXX_WARN(logger_, "Couldn't remove session "
                      << static_cast<uint32_t>(session_id));
         return 0;
       }
-    }
-    if (!connection->RemoveSession(session_id)) {
-      LOG4CXX_WARN(logger_, "Couldn't remove session "
-                   << static_cast<uint32_t>(session_id));
-      return 0;
-    }
-  } else {
-    LOG4CXX_INFO(logger_, "Service "  << static_cast<uint32_t>(service_type)
-                 << " to be removed");
-    if (!connection->RemoveService(session_id, service_type)) {
-      LOG4CXX_WARN(logger_, "Couldn't remove service "
-                   << static_cast<uint32_t>(service_type));
-      return 0;
+    } else {
+      LOG4CXX_INFO(logger_, "Service "  << static_cast<uint32_t>(service_type)
+                   << " to be removed");
+      if (!connection->RemoveService(session_id, service_type)) {
+        LOG4CXX_WARN(logger_, "Couldn't remove service "
+                     << static_cast<uint32_t>(service_type));
+        return 0;
+      }
     }
   }
 
@@ -480,7 +518,8 @@ int32_t ConnectionHandlerImpl::GetDataOnSessionKey(
   transport_manager::ConnectionUID conn_handle = 0;
   uint8_t session_id = 0;
   PairFromKey(key, &conn_handle, &session_id);
-  ConnectionList::iterator it = connection_list_.find(conn_handle);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
+  ConnectionList::const_iterator it = connection_list_.find(conn_handle);
 
   if (connection_list_.end() == it) {
     LOG4CXX_ERROR(logger_, "Unknown connection!");
@@ -508,16 +547,15 @@ int32_t ConnectionHandlerImpl::GetDataOnSessionKey(
       *app_id = KeyFromPair(conn_handle, session_id);
     }
 
-    LOG4CXX_INFO(logger_, "Connection "
-                 << static_cast<int32_t>(conn_handle)
-                 << " has " << connection.session_map().size()
-                 << " sessions.");
-
     if (sessions_list) {
       const SessionMap session_map = connection.session_map();
+      LOG4CXX_INFO(logger_, "Connection "
+                   << static_cast<int32_t>(conn_handle)
+                   << " has " << session_map.size()
+                   << " sessions.");
       for (SessionMap::const_iterator session_it = session_map.begin();
            session_map.end() != session_it; ++session_it) {
-        sessions_list->push_back(KeyFromPair(conn_handle, it->first));
+        sessions_list->push_back(KeyFromPair(conn_handle, session_it->first));
       }
     }
 
@@ -572,11 +610,18 @@ int32_t ConnectionHandlerImpl::GetDataOnDeviceID(
   }
   if (applications_list) {
     applications_list->clear();
-    sync_primitives::AutoLock connection_list_lock(connection_list_lock_);
-    for (ConnectionList::iterator itr = connection_list_.begin();
-        itr != connection_list_.end(); ++itr) {
-      if (device_handle == (*itr).second->connection_device_handle()) {
-        const SessionMap &session_map = (itr->second)->session_map();
+    sync_primitives::AutoReadLock connection_list_lock(connection_list_lock_);
+    DeviceConnections::const_iterator device_it =
+        device_connections_.find(device_handle);
+    if (device_connections_.end() != device_it) {
+      const std::set<ConnectionHandle> &connections = device_it->second;
+      for (std::set<ConnectionHandle>::const_iterator handle_it =
+           connections.begin(); connections.end() != handle_it; ++handle_it) {
+        ConnectionList::const_iterator itr = connection_list_.find(*handle_it);
+        if (connection_list_.end() == itr) {
+          continue;
+        }
+        const SessionMap session_map = (itr->second)->session_map();
         for (SessionMap::const_iterator session_it = session_map.begin();
              session_map.end() != session_it; ++session_it) {
           const transport_manager::ConnectionUID &connection_handle = itr->first;
@@ -604,7 +649,7 @@ int ConnectionHandlerImpl::SetSSLContext(
   uint8_t session_id = 0;
   PairFromKey(key, &connection_handle, &session_id);
 
-  sync_primitives::AutoLock lock(connection_list_lock_);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
   ConnectionList::iterator it = connection_list_.find(connection_handle);
   if (connection_list_.end() == it) {
     LOG4CXX_ERROR(logger_, "Unknown connection!");
@@ -621,7 +666,7 @@ security_manager::SSLContext *ConnectionHandlerImpl::GetSSLContext(
   uint8_t session_id = 0;
   PairFromKey(key, &connection_handle, &session_id);
 
-  sync_primitives::AutoLock lock(connection_list_lock_);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
   ConnectionList::iterator it = connection_list_.find(connection_handle);
   if (connection_list_.end() == it) {
     LOG4CXX_ERROR(logger_, "Unknown connection!");
@@ -638,7 +683,7 @@ void ConnectionHandlerImpl::SetProtectionFlag(
   uint8_t session_id = 0;
   PairFromKey(key, &connection_handle, &session_id);
 
-  sync_primitives::AutoLock lock(connection_list_lock_);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
   ConnectionList::iterator it = connection_list_.find(connection_handle);
   if (connection_list_.end() == it) {
     LOG4CXX_ERROR(logger_, "Unknown connection!");
@@ -722,12 +767,12 @@ void ConnectionHandlerImpl::CloseConnection(
       ConnectionUIDFromHandle(connection_handle);
   transport_manager_->DisconnectForce(connection_uid);
 
-  sync_primitives::AutoLock connection_list_lock(connection_list_lock_);
+  sync_primitives::AutoWriteLock connection_list_lock(connection_list_lock_);
 
   ConnectionList::iterator connection_list_itr =
       connection_list_.find(connection_uid);
   if (connection_list_.end() != connection_list_itr) {
-    connection_list_.erase(connection_list_itr);
+    RemoveConnectionLocked(connection_list_itr);
   }
 }
 
@@ -737,7 +782,7 @@ uint32_t ConnectionHandlerImpl::GetConnectionSessionsCount(
   uint8_t session_id = 0;
   PairFromKey(connection_key, &connection_handle, &session_id);
 
-  sync_primitives::AutoLock lock(connection_list_lock_);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
   ConnectionList::iterator itr = connection_list_.find(connection_handle);
 
   if (connection_list_.end() != itr) {
@@ -773,7 +818,7 @@ void ConnectionHandlerImpl::CloseSession(ConnectionHandle connection_handle,
 
   SessionMap session_map;
   {
-    sync_primitives::AutoLock connection_list_lock(connection_list_lock_);
+    sync_primitives::AutoReadLock connection_list_lock(connection_list_lock_);
 
     ConnectionList::iterator connection_list_itr =
         connection_list_.find(connection_id);
@@ -829,7 +874,7 @@ void ConnectionHandlerImpl::CloseConnectionSessions(
   typedef std::vector<uint8_t> SessionIdVector;
   SessionIdVector session_id_vector;
   {
-    sync_primitives::AutoLock connection_list_lock(connection_list_lock_);
+    sync_primitives::AutoReadLock connection_list_lock(connection_list_lock_);
 
     ConnectionList::iterator connection_list_itr =
         connection_list_.find(connection_id);
@@ -871,7 +916,7 @@ void ConnectionHandlerImpl::StartSessionHeartBeat(uint32_t connection_key) {
   uint8_t session_id = 0;
   PairFromKey(connection_key, &connection_handle, &session_id);
 
-  sync_primitives::AutoLock lock(connection_list_lock_);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
   ConnectionList::iterator it = connection_list_.find(connection_handle);
   if (connection_list_.end() != it) {
     it->second->StartHeartBeat(session_id);
@@ -883,7 +928,7 @@ void ConnectionHandlerImpl::SetHeartBeatTimeout(uint32_t connection_key,
   uint32_t connection_handle = 0;
   uint8_t session_id = 0;
   PairFromKey(connection_key, &connection_handle, &session_id);
-  sync_primitives::AutoLock lock(connection_list_lock_);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
   ConnectionList::iterator it = connection_list_.find(connection_handle);
   if (connection_list_.end() != it) {
     it->second->SetHeartBeatTimeout(timeout, session_id);
@@ -901,7 +946,7 @@ void ConnectionHandlerImpl::SendHeartBeat(ConnectionHandle connection_handle,
 
 void ConnectionHandlerImpl::KeepConnectionAlive(uint32_t connection_key,
                                                 uint8_t session_id) {
-  sync_primitives::AutoLock lock(connection_list_lock_);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
 
   ConnectionList::iterator it = connection_list_.find(connection_key);
   if (connection_list_.end() != it) {
@@ -914,15 +959,17 @@ void ConnectionHandlerImpl::OnConnectionEnded(
   LOG4CXX_INFO(logger_, "Delete Connection: " << static_cast<int32_t>(connection_id)
                << " from the list.");
 
-  connection_list_lock_.Acquire();
-  ConnectionList::iterator itr = connection_list_.find(connection_id);
-  if (connection_list_.end() == itr) {
-    LOG4CXX_ERROR(logger_, "Connection not found!");
-    return;
+  std::auto_ptr<Connection> connection;
+  {
+    sync_primitives::AutoWriteLock lock(connection_list_lock_);
+    ConnectionList::iterator itr = connection_list_.find(connection_id);
+    if (connection_list_.end() == itr) {
+      LOG4CXX_ERROR(logger_, "Connection not found!");
+      return;
+    }
+    connection.reset(itr->second);
+    RemoveConnectionLocked(itr);
   }
-  std::auto_ptr<Connection> connection(itr->second);
-  connection_list_.erase(itr);
-  connection_list_lock_.Release();
 
   sync_primitives::AutoReadLock read_lock(connection_handler_observer_lock_);
   if (connection_handler_observer_ && connection.get() != NULL) {
@@ -948,7 +995,7 @@ void ConnectionHandlerImpl::BindProtocolVersionWithSession(
   uint8_t session_id = 0;
   PairFromKey(connection_key, &connection_handle, &session_id);
 
-  sync_primitives::AutoLock lock(connection_list_lock_);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
   ConnectionList::iterator it = connection_list_.find(connection_handle);
   if (connection_list_.end() != it) {
     it->second->UpdateProtocolVersionSession(session_id, protocol_version);
@@ -958,7 +1005,7 @@ void ConnectionHandlerImpl::BindProtocolVersionWithSession(
 bool ConnectionHandlerImpl::IsHeartBeatSupported(
     transport_manager::ConnectionUID connection_handle,uint8_t session_id) {
   LOG4CXX_AUTO_TRACE(logger_);
-  sync_primitives::AutoLock lock(connection_list_lock_);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
   uint32_t connection = static_cast<uint32_t>(connection_handle);
   ConnectionList::iterator it = connection_list_.find(connection);
   if (connection_list_.end() == it) {
@@ -971,7 +1018,7 @@ bool ConnectionHandlerImpl::IsHeartBeatSupported(
 bool ConnectionHandlerImpl::ProtocolVersionUsed(uint32_t connection_id,
           uint8_t session_id, uint8_t& protocol_version) {
   LOG4CXX_AUTO_TRACE(logger_);
-  sync_primitives::AutoLock lock(connection_list_lock_);
+  sync_primitives::AutoReadLock lock(connection_list_lock_);
   ConnectionList::iterator it = connection_list_.find(connection_id);
   if (connection_list_.end() != it) {
     return it->second->ProtocolVersion(session_id, protocol_version);
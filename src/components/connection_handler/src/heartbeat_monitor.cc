@@ -36,6 +36,7 @@
 
 #include "utils/logger.h"
 #include "connection_handler/connection.h"
+#include "connection_handler/heartbeat_scheduler.h"
 
 namespace connection_handler {
 
@@ -47,56 +48,73 @@ HeartBeatMonitor::HeartBeatMonitor(int32_t heartbeat_timeout_seconds,
                                    Connection *connection)
     : default_heartbeat_timeout_(heartbeat_timeout_seconds),
       connection_(connection),
-      sessions_list_lock_(true),
-      run_(true) {
+      sessions_list_lock_(true) {
 }
 
-void HeartBeatMonitor::Process() {
-  AutoLock auto_lock(sessions_list_lock_);
+HeartBeatMonitor::~HeartBeatMonitor() {
+  HeartBeatScheduler::instance()->Unregister(this);
+}
 
-  SessionMap::iterator it = sessions_.begin();
-  while (it != sessions_.end()) {
+bool HeartBeatMonitor::ProcessDeadline(uint8_t session_id,
+                                       const TimevalStruct& deadline,
+                                       TimevalStruct* next_deadline) {
+  bool close_session = false;
+  bool send_heartbeat = false;
+  {
+    AutoLock auto_lock(sessions_list_lock_);
+
+    SessionMap::iterator it = sessions_.find(session_id);
+    if (sessions_.end() == it) {
+      return false;
+    }
     SessionState &state = it->second;
+    if (!date_time::DateTime::Equal(state.scheduled_deadline, deadline)) {
+      // Session was rescheduled with another timeout
+      return false;
+    }
     if (state.HasTimeoutElapsed()) {
-      const uint8_t session_id = it->first;
-      if (state.IsReadyToClose()) {
-        LOG4CXX_WARN(logger_, "Will close session");
-        connection_->CloseSession(session_id);
-        it = sessions_.begin();
-        continue;
-      } else {
-        LOG4CXX_DEBUG(logger_,
-          "Send heart beat into session with id " << static_cast<int32_t>(session_id));
-        state.PrepareToClose();
-        connection_->SendHeartBeat(it->first);
-      }
+      // Retry closing after one more timeout if session is still there
+      close_session = state.IsReadyToClose();
+      send_heartbeat = !close_session;
+      state.PrepareToClose();
     }
-    ++it;
+    // Kept alive meanwhile or heartbeat sent, wait for new expiration
+    state.scheduled_deadline = state.expiration();
+    *next_deadline = state.scheduled_deadline;
   }
-}
 
-void HeartBeatMonitor::threadMain() {
-  AutoLock main_lock(main_thread_lock_);
-  LOG4CXX_DEBUG(
-      logger_,
-      "Start heart beat monitor. Timeout is " << default_heartbeat_timeout_);
-  while (run_) {
-    heartbeat_monitor_.WaitFor(main_lock, kDefaultCycleTimeout);
-    Process();
+  if (close_session) {
+    LOG4CXX_WARN(logger_, "Will close session");
+    // Closing may delete connection together with this monitor,
+    // scheduler does not reschedule deadlines of unregistered one
+    connection_->CloseSession(session_id);
+    return true;
+  }
+  if (send_heartbeat) {
+    LOG4CXX_DEBUG(logger_,
+      "Send heart beat into session with id " << static_cast<int32_t>(session_id));
+    connection_->SendHeartBeat(session_id);
   }
+  return true;
 }
 
 void HeartBeatMonitor::AddSession(uint8_t session_id) {
   LOG4CXX_DEBUG(logger_, "Add session with id " << static_cast<int32_t>(session_id));
-  AutoLock auto_lock(sessions_list_lock_);
-  if (sessions_.end() != sessions_.find(session_id)) {
-    LOG4CXX_WARN(
-        logger_,
-        "Session with id " << static_cast<int32_t>(session_id) << " already exists");
-    return;
+  TimevalStruct deadline;
+  {
+    AutoLock auto_lock(sessions_list_lock_);
+    if (sessions_.end() != sessions_.find(session_id)) {
+      LOG4CXX_WARN(
+          logger_,
+          "Session with id " << static_cast<int32_t>(session_id) << " already exists");
+      return;
+    }
+    SessionState state(default_heartbeat_timeout_);
+    state.scheduled_deadline = state.expiration();
+    deadline = state.scheduled_deadline;
+    sessions_.insert(std::make_pair(session_id, state));
   }
-  sessions_.insert(std::make_pair(session_id,
-                                  SessionState(default_heartbeat_timeout_)));
+  HeartBeatScheduler::instance()->Schedule(this, session_id, deadline);
   LOG4CXX_INFO(logger_, "Start heartbeat for session " << session_id);
 }
 
@@ -106,6 +124,7 @@ void HeartBeatMonitor::RemoveSession(uint8_t session_id) {
   LOG4CXX_DEBUG(logger_,
                "Remove session with id " << static_cast<int>(session_id));
 
+  // Queued deadline of session is ignored on expiration
   if (sessions_.erase(session_id) == 0) {
     LOG4CXX_WARN(logger_,
                  "Remove session with id " << static_cast<int>(session_id) <<
@@ -116,32 +135,33 @@ void HeartBeatMonitor::RemoveSession(uint8_t session_id) {
 void HeartBeatMonitor::KeepAlive(uint8_t session_id) {
   AutoLock auto_lock(sessions_list_lock_);
 
-  if (sessions_.end() != sessions_.find(session_id)) {
+  SessionMap::iterator it = sessions_.find(session_id);
+  if (sessions_.end() != it) {
     LOG4CXX_INFO( logger_, "Resetting heart beat timer for session with id " <<
                   static_cast<int32_t>(session_id));
 
-    sessions_[session_id].KeepAlive();
+    it->second.KeepAlive();
   }
 }
 
-void HeartBeatMonitor::exitThreadMain() {
-  // FIXME (dchmerev@luxoft.com): thread requested to stop should stop as soon as possible,
-  // not running one more iteration before actual stop
-  LOG4CXX_AUTO_TRACE(logger_);
-  AutoLock main_lock(main_thread_lock_);
-  run_ = false;
-  heartbeat_monitor_.NotifyOne();
-}
-
 void HeartBeatMonitor::set_heartbeat_timeout_seconds(int32_t timeout,
                                                      uint8_t session_id) {
   LOG4CXX_DEBUG(logger_, "Set new heart beat timeout " << timeout <<
                 "For session: " << session_id);
 
-  AutoLock session_locker(sessions_list_lock_);
-  if (sessions_.end() != sessions_.find(session_id)) {
-    sessions_[session_id].UpdateTimeout(timeout);
+  TimevalStruct deadline;
+  {
+    AutoLock session_locker(sessions_list_lock_);
+    SessionMap::iterator it = sessions_.find(session_id);
+    if (sessions_.end() == it) {
+      return;
+    }
+    // Timeout may become shorter, so new deadline is queued
+    it->second.UpdateTimeout(timeout);
+    it->second.scheduled_deadline = it->second.expiration();
+    deadline = it->second.scheduled_deadline;
   }
+  HeartBeatScheduler::instance()->Schedule(this, session_id, deadline);
 }
 
 HeartBeatMonitor::SessionState::SessionState(int32_t heartbeat_timeout_seconds)
@@ -149,6 +169,7 @@ HeartBeatMonitor::SessionState::SessionState(int32_t heartbeat_timeout_seconds)
     is_heartbeat_sent(false) {
   LOG4CXX_AUTO_TRACE(logger_);
   RefreshExpiration();
+  scheduled_deadline = heartbeat_expiration;
 }
 
 void HeartBeatMonitor::SessionState::RefreshExpiration () {
@@ -181,6 +202,10 @@ void HeartBeatMonitor::SessionState::KeepAlive() {
   RefreshExpiration();
 }
 
+const TimevalStruct& HeartBeatMonitor::SessionState::expiration() const {
+  return heartbeat_expiration;
+}
+
 bool HeartBeatMonitor::SessionState::HasTimeoutElapsed() {
   TimevalStruct now = date_time::DateTime::getCurrentTime();
   return date_time::DateTime::Greater(now, heartbeat_expiration);
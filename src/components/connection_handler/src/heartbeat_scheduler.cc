@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "connection_handler/heartbeat_scheduler.h"
+
+#include "utils/logger.h"
+#include "connection_handler/heartbeat_monitor.h"
+
+namespace connection_handler {
+
+using namespace sync_primitives;
+
+CREATE_LOGGERPTR_GLOBAL(logger_, "HeartBeatMonitor")
+
+HeartBeatScheduler::HeartBeatScheduler()
+    : active_monitor_(NULL),
+      worker_thread_id_(0),
+      thread_(NULL),
+      run_(true),
+      wakeups_count_(0) {
+}
+
+HeartBeatScheduler::~HeartBeatScheduler() {
+  if (thread_) {
+    thread_->join();
+    delete thread_->delegate();
+    threads::DeleteThread(thread_);
+    thread_ = NULL;
+  }
+}
+
+void HeartBeatScheduler::Schedule(HeartBeatMonitor* monitor,
+                                  uint8_t session_id,
+                                  const TimevalStruct& deadline) {
+  AutoLock auto_lock(lock_);
+  if (!thread_) {
+    thread_ = threads::CreateThread("HeartBeatMonitor", new Worker(this));
+    thread_->start();
+  }
+  monitors_.insert(monitor);
+  const bool is_earliest = deadlines_.empty() ||
+      date_time::DateTime::Less(deadline, deadlines_.top().time);
+  deadlines_.push(Deadline(deadline, monitor, session_id));
+  if (is_earliest) {
+    deadline_changed_.NotifyOne();
+  }
+}
+
+void HeartBeatScheduler::Unregister(HeartBeatMonitor* monitor) {
+  AutoLock auto_lock(lock_);
+  // Deadlines left in queue are skipped on expiration
+  monitors_.erase(monitor);
+  while (active_monitor_ == monitor &&
+         !pthread_equal(worker_thread_id_, threads::Thread::CurrentId())) {
+    processing_finished_.Wait(auto_lock);
+  }
+}
+
+uint32_t HeartBeatScheduler::wakeups_count() const {
+  AutoLock auto_lock(lock_);
+  return wakeups_count_;
+}
+
+void HeartBeatScheduler::Run() {
+  AutoLock auto_lock(lock_);
+  worker_thread_id_ = threads::Thread::CurrentId();
+  while (run_) {
+    if (deadlines_.empty()) {
+      deadline_changed_.Wait(auto_lock);
+    } else {
+      const int64_t wait_usecs =
+          date_time::DateTime::getuSecs(deadlines_.top().time) -
+          date_time::DateTime::getuSecs(date_time::DateTime::getCurrentTime());
+      if (wait_usecs > 0) {
+        // Round up, waking before deadline gives an empty cycle
+        deadline_changed_.WaitFor(auto_lock,
+                                  static_cast<int32_t>((wait_usecs + 999) / 1000));
+      }
+    }
+    if (!run_) {
+      break;
+    }
+    ++wakeups_count_;
+    ProcessExpired(auto_lock);
+  }
+}
+
+void HeartBeatScheduler::ProcessExpired(AutoLock& auto_lock) {
+  const TimevalStruct now = date_time::DateTime::getCurrentTime();
+  while (!deadlines_.empty() &&
+         !date_time::DateTime::Greater(deadlines_.top().time, now)) {
+    const Deadline deadline = deadlines_.top();
+    deadlines_.pop();
+    if (monitors_.end() == monitors_.find(deadline.monitor)) {
+      continue;
+    }
+    TimevalStruct next_deadline = {0, 0};
+    bool reschedule = false;
+    active_monitor_ = deadline.monitor;
+    {
+      // Monitor may close session or connection, even delete itself
+      AutoUnlock auto_unlock(auto_lock);
+      reschedule = deadline.monitor->ProcessDeadline(
+          deadline.session_id, deadline.time, &next_deadline);
+    }
+    active_monitor_ = NULL;
+    processing_finished_.Broadcast();
+    if (reschedule &&
+        monitors_.end() != monitors_.find(deadline.monitor)) {
+      deadlines_.push(
+          Deadline(next_deadline, deadline.monitor, deadline.session_id));
+    }
+  }
+}
+
+void HeartBeatScheduler::Stop() {
+  AutoLock auto_lock(lock_);
+  run_ = false;
+  deadline_changed_.NotifyOne();
+}
+
+HeartBeatScheduler::Worker::Worker(HeartBeatScheduler* scheduler)
+    : scheduler_(scheduler) {
+}
+
+void HeartBeatScheduler::Worker::threadMain() {
+  scheduler_->Run();
+}
+
+void HeartBeatScheduler::Worker::exitThreadMain() {
+  scheduler_->Stop();
+}
+
+HeartBeatScheduler::Deadline::Deadline(const TimevalStruct& time,
+                                       HeartBeatMonitor* monitor,
+                                       uint8_t session_id)
+    : time(time),
+      monitor(monitor),
+      session_id(session_id) {
+}
+
+bool HeartBeatScheduler::Deadline::operator<(const Deadline& other) const {
+  return date_time::DateTime::Greater(time, other.time);
+}
+
+}  // namespace connection_handler
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <vector>
+
+#include "connection_handler/connection_handler_impl.h"
+#include "protocol/common.h"
+#include "utils/date_time.h"
+
+namespace test {
+namespace components {
+namespace connection_handle_test {
+
+using namespace ::connection_handler;
+using namespace ::protocol_handler;
+
+namespace {
+const uint32_t kDevicesCount = 16u;
+const uint32_t kConnectionsPerDevice = 4u;
+const uint32_t kLookupsPerThread = 200000u;
+const uint32_t kCheckedLookupsPerThread = 1000u;
+const uint32_t kMaxThreadsCount = 8u;
+
+struct LookupTask {
+  ConnectionHandlerImpl* connection_handler;
+  const std::vector<uint32_t>* keys;
+  uint32_t lookups_count;
+  uint32_t failures;
+};
+
+void* LookupSessions(void* data) {
+  LookupTask* task = static_cast<LookupTask*>(data);
+  const std::vector<uint32_t>& keys = *task->keys;
+  uint32_t app_id = 0;
+  uint32_t device_id = 0;
+  for (uint32_t i = 0; i < task->lookups_count; ++i) {
+    const uint32_t key = keys[i % keys.size()];
+    if (0 != task->connection_handler->GetDataOnSessionKey(
+          key, &app_id, NULL, &device_id)) {
+      ++task->failures;
+    }
+#ifdef ENABLE_SECURITY
+    task->connection_handler->GetSSLContext(key, kMobileNav);
+#endif  // ENABLE_SECURITY
+  }
+  return NULL;
+}
+}  // namespace
+
+class ConnectionHandlerPerformanceTest : public ::testing::Test {
+ protected:
+  void SetUp() OVERRIDE {
+    connection_handler_ = ConnectionHandlerImpl::instance();
+    transport_manager::ConnectionUID uid = 1u;
+    for (uint32_t device = 0; device < kDevicesCount; ++device) {
+      const transport_manager::DeviceInfo device_info(
+          device, "test_address", "test_name", "BTMAC");
+      for (uint32_t i = 0; i < kConnectionsPerDevice; ++i, ++uid) {
+        connection_handler_->addDeviceConnection(device_info, uid);
+        const uint32_t session_id =
+            connection_handler_->OnSessionStartedCallback(
+                uid, 0, kRpc, PROTECTION_OFF, NULL);
+        ASSERT_NE(0u, session_id);
+        keys_.push_back(connection_handler_->KeyFromPair(uid, session_id));
+      }
+    }
+  }
+  void TearDown() OVERRIDE {
+    ConnectionHandlerImpl::destroy();
+  }
+
+  int64_t RunLookups(uint32_t threads_count, uint32_t lookups_count) {
+    std::vector<pthread_t> threads(threads_count);
+    std::vector<LookupTask> tasks(threads_count);
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    for (uint32_t i = 0; i < threads_count; ++i) {
+      tasks[i].connection_handler = connection_handler_;
+      tasks[i].keys = &keys_;
+      tasks[i].lookups_count = lookups_count;
+      tasks[i].failures = 0;
+      EXPECT_EQ(0, pthread_create(&threads[i], NULL,
+                                  &LookupSessions, &tasks[i]));
+    }
+    for (uint32_t i = 0; i < threads_count; ++i) {
+      pthread_join(threads[i], NULL);
+      EXPECT_EQ(0u, tasks[i].failures);
+    }
+    return date_time::DateTime::calculateTimeSpan(start);
+  }
+
+  ConnectionHandlerImpl* connection_handler_;
+  std::vector<uint32_t> keys_;
+};
+
+TEST_F(ConnectionHandlerPerformanceTest, ConcurrentSessionLookups) {
+  RunLookups(kMaxThreadsCount, kCheckedLookupsPerThread);
+}
+
+// Timing report only, run with --gtest_also_run_disabled_tests
+TEST_F(ConnectionHandlerPerformanceTest,
+       DISABLED_Benchmark_SessionLookupContention) {
+  for (uint32_t threads_count = 1; threads_count <= kMaxThreadsCount;
+       threads_count *= 2) {
+    const int64_t time_ms = RunLookups(threads_count, kLookupsPerThread);
+    printf("%u sessions, %u threads x %u lookups: %ld ms\n",
+           static_cast<uint32_t>(keys_.size()), threads_count,
+           kLookupsPerThread, static_cast<long>(time_ms));
+  }
+}
+
+TEST_F(ConnectionHandlerPerformanceTest, DeviceRemovedWithManyConnections) {
+  std::list<uint32_t> applications;
+  EXPECT_EQ(0, connection_handler_->GetDataOnDeviceID(0, NULL, &applications));
+  EXPECT_EQ(kConnectionsPerDevice, applications.size());
+
+  const transport_manager::DeviceInfo device_info(
+      0, "test_address", "test_name", "BTMAC");
+  connection_handler_->OnDeviceRemoved(device_info);
+  EXPECT_EQ((kDevicesCount - 1) * kConnectionsPerDevice,
+            connection_handler_->getConnectionList().size());
+  uint32_t app_id = 0;
+  EXPECT_EQ(-1, connection_handler_->GetDataOnSessionKey(keys_.front(), &app_id));
+
+  applications.clear();
+  EXPECT_EQ(0, connection_handler_->GetDataOnDeviceID(1, NULL, &applications));
+  EXPECT_EQ(kConnectionsPerDevice, applications.size());
+}
+
+}  // namespace connection_handle_test
+}  // namespace components
+}  // namespace test
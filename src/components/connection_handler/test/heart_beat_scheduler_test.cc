@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "connection_handler/connection.h"
+#include "connection_handler/heartbeat_scheduler.h"
+#include "connection_handler_mock.h"
+#include "utils/conditional_variable.h"
+#include "utils/lock.h"
+
+namespace test {
+namespace components {
+namespace connection_handler_test {
+
+using ::testing::_;
+using ::testing::NiceMock;
+
+namespace {
+const uint32_t kConnectionsCount = 100u;
+const int32_t kHeartBeatTimeoutSeconds = 1;
+const uint32_t kKeepAlivePeriodMs = 100u;
+// Just longer than heartbeat timeout, so each session expires once
+const uint32_t kTestDurationMs = 1200u;
+
+uint32_t ThreadsCount() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (0 == line.find("Threads:")) {
+      return atoi(line.c_str() + sizeof("Threads:"));
+    }
+  }
+  return 0;
+}
+
+class SessionClosedEvent {
+ public:
+  SessionClosedEvent() : is_closed_(false) {}
+  void Notify() {
+    sync_primitives::AutoLock auto_lock(lock_);
+    is_closed_ = true;
+    closed_.NotifyOne();
+  }
+  bool WaitFor(uint32_t timeout_ms) {
+    sync_primitives::AutoLock auto_lock(lock_);
+    while (!is_closed_) {
+      if (sync_primitives::ConditionalVariable::kTimeout ==
+          closed_.WaitFor(auto_lock, timeout_ms)) {
+        break;
+      }
+    }
+    return is_closed_;
+  }
+ private:
+  sync_primitives::Lock lock_;
+  sync_primitives::ConditionalVariable closed_;
+  bool is_closed_;
+};
+}  // namespace
+
+ACTION_P3(RemoveSessionAndNotify, conn, session_id, closed) {
+  conn->RemoveSession(session_id);
+  closed->Notify();
+}
+
+TEST(HeartBeatSchedulerTest, KeptAliveConnections_OneThreadFewWakeups) {
+  NiceMock<ConnectionHandlerMock> connection_handler_mock;
+  EXPECT_CALL(connection_handler_mock, SendHeartBeat(_, _)).Times(0);
+  EXPECT_CALL(connection_handler_mock, CloseSession(_, _, _)).Times(0);
+  EXPECT_CALL(connection_handler_mock, CloseConnection(_)).Times(0);
+
+  connection_handler::HeartBeatScheduler* scheduler =
+      connection_handler::HeartBeatScheduler::instance();
+  // Scheduler thread is started with first session
+  const uint32_t threads_before = ThreadsCount() + 1;
+  const uint32_t wakeups_before = scheduler->wakeups_count();
+
+  std::vector<connection_handler::Connection*> connections;
+  std::vector<uint8_t> sessions;
+  for (uint32_t i = 0; i < kConnectionsCount; ++i) {
+    connection_handler::Connection* connection =
+        new connection_handler::Connection(i + 1, 0, &connection_handler_mock,
+                                           kHeartBeatTimeoutSeconds);
+    const uint8_t session = connection->AddNewSession();
+    connection->StartHeartBeat(session);
+    connections.push_back(connection);
+    sessions.push_back(session);
+  }
+  EXPECT_GE(threads_before, ThreadsCount());
+
+  for (uint32_t time = 0; time < kTestDurationMs; time += kKeepAlivePeriodMs) {
+    usleep(kKeepAlivePeriodMs * 1000);
+    for (uint32_t i = 0; i < kConnectionsCount; ++i) {
+      connections[i]->KeepAlive(sessions[i]);
+    }
+  }
+
+  // Thread per connection polling every 100 ms would wake up
+  // kConnectionsCount * kTestDurationMs / 100 times
+  const uint32_t wakeups = scheduler->wakeups_count() - wakeups_before;
+  EXPECT_GE(2 * kConnectionsCount, wakeups);
+
+  for (uint32_t i = 0; i < kConnectionsCount; ++i) {
+    delete connections[i];
+  }
+}
+
+TEST(HeartBeatSchedulerTest, NotKeptAlive_HeartBeatThenClose) {
+  NiceMock<ConnectionHandlerMock> connection_handler_mock;
+  connection_handler::Connection* connection =
+      new connection_handler::Connection(1, 0, &connection_handler_mock,
+                                         kHeartBeatTimeoutSeconds);
+  const uint8_t session = connection->AddNewSession();
+
+  EXPECT_CALL(connection_handler_mock, SendHeartBeat(_, session));
+  SessionClosedEvent closed;
+  EXPECT_CALL(connection_handler_mock, CloseSession(_, session, _))
+      .WillOnce(RemoveSessionAndNotify(connection, session, &closed));
+
+  connection->StartHeartBeat(session);
+  // Heartbeat is sent after the first timeout, session is closed
+  // after the second one
+  EXPECT_TRUE(closed.WaitFor((2 * kHeartBeatTimeoutSeconds + 1) * 1000));
+  delete connection;
+}
+
+}  // namespace connection_handler_test
+}  // namespace components
+}  // namespace test
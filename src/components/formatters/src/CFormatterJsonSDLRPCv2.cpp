@@ -46,7 +46,13 @@ bool CFormatterJsonSDLRPCv2::toString(const smart_objects_ns::SmartObject& obj,
   try {
     Json::Value root(Json::objectValue);
 
-    smart_objects_ns::SmartObject formattedObj(obj);
+    // Only msg_params are written, so params with possibly large
+    // binary data are not copied
+    smart_objects_ns::SmartObject formattedObj(smart_objects_ns::SmartType_Map);
+    if (obj.keyExists(strings::S_MSG_PARAMS)) {
+      formattedObj[strings::S_MSG_PARAMS] = obj.getElement(strings::S_MSG_PARAMS);
+    }
+    formattedObj.setSchema(obj.getSchema());
     formattedObj.getSchema().unapplySchema(formattedObj);  // converts enums(as int32_t) to strings
 
     objToJsonValue(formattedObj.getElement(strings::S_MSG_PARAMS), root);
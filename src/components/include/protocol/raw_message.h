@@ -32,18 +32,29 @@
 #ifndef SRC_COMPONENTS_INCLUDE_PROTOCOL_RAW_MESSAGE_H_
 #define SRC_COMPONENTS_INCLUDE_PROTOCOL_RAW_MESSAGE_H_
 
+#include <vector>
+
 #include "utils/macro.h"
 #include "utils/shared_ptr.h"
+#include "utils/memory_pool.h"
 #include "protocol/service_type.h"
 #include "protocol/message_priority.h"
 
 namespace protocol_handler {
+/**
+ * \brief Serialized payload referenced by raw messages without copying.
+ * Outgoing payload may be referenced by several messages at once, e.g. one
+ * notification sent to many connections, and shall not be modified then.
+ * Reassembled incoming payload is referenced by its message only.
+ */
+typedef utils::SharedPtr<std::vector<uint8_t> > SharedPayload;
+
 /**
  * \class SmartDeviceLinkRawMessage
  * \brief Class-wrapper for information about message for interchanging
  * between components.
  */
-class RawMessage {
+class RawMessage : public utils::PooledObject {
  public:
   /**
    * \brief Constructor
@@ -58,6 +69,26 @@ class RawMessage {
              const uint8_t *const data_param, uint32_t data_size,
              uint8_t type = ServiceType::kRpc,
              uint32_t payload_size = 0);
+  /**
+   * \brief Constructor referencing shared payload without copying it
+   * \param connection_key Identifier of connection within which message
+   * is transferred
+   * \param protocol_version Version of protocol of the message
+   * \param payload Serialized message bytes, data() points to them
+   * \param type Service type of the message
+   */
+  RawMessage(uint32_t connection_key, uint32_t protocol_version,
+             const SharedPayload& payload,
+             uint8_t type = ServiceType::kRpc);
+  /**
+   * \brief Creates message with uninitialized buffer of data_size bytes
+   * to be filled through data()
+   * \return message, its data() is NULL if buffer could not be allocated
+   */
+  static RawMessage* CreateUninitialized(uint32_t connection_key,
+                                         uint32_t protocol_version,
+                                         uint32_t data_size,
+                                         uint8_t type = ServiceType::kRpc);
   /**
    * \brief Destructor
    */
@@ -79,6 +110,11 @@ class RawMessage {
    * \brief Getter for message size
    */
  size_t data_size() const;
+  /**
+   * \brief Shrinks message to its first data_size bytes, e.g. to the part
+   * of receive buffer filled by transport. Buffer itself is kept.
+   */
+  void Truncate(size_t data_size);
   /**
    * \brief Getter for actual data size
    */
@@ -105,6 +141,8 @@ class RawMessage {
  private:
   uint32_t connection_key_;
   uint8_t *data_;
+  // Keeps referenced bytes alive, data_ is not owned if it is set
+  SharedPayload shared_payload_;
   size_t data_size_;
   uint32_t protocol_version_;
   ServiceType service_type_;
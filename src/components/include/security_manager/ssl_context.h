@@ -55,6 +55,28 @@
  * \param in_data_size   [in]   size of data in \ref in_data buffer
  * \param out_data       [out]  response of SSL context if there is one. If not, equals NULL
  * \param out_data_size  [out]  length of response. On no response, equals 0
+ *
+ * \fn security_manager::SSLContext::EncryptBatch(Frame *frames,
+ *                                               size_t frames_count)
+ * \brief Encrypts a batch of frames into caller-provided buffers
+ * Each frame is protected as separate TLS record(s) in the batch order.
+ * Output buffer of each frame shall be at least
+ * \ref get_max_encrypted_size(in_data_size) bytes.
+ *
+ * \fn security_manager::SSLContext::DecryptBatch(Frame *frames,
+ *                                               size_t frames_count)
+ * \brief Decrypts a batch of frames into caller-provided buffers
+ * out_data could point to in_data for in place decryption.
+ * A TLS record split between frames is decrypted with the frame holding
+ * its last part, so plaintext of a frame could be longer than its
+ * ciphertext. In this case out_data is re-pointed to the buffer owned by
+ * SSLContext, which is valid up to the next Decrypt/DecryptBatch call.
+ * A frame holding only a part of a record is decrypted to 0 bytes.
+ *
+ * \return count of successfully processed frames.
+ * Result of each frame is set to \ref Frame::result. A frame rejected
+ * before reaching the TLS session does not stop the batch, after a
+ * session failure the rest of frames stay Frame_Result_NotProcessed.
  */
 
 namespace security_manager {
@@ -65,6 +87,28 @@ class SSLContext {
     Handshake_Result_Fail         = 0x1,
     Handshake_Result_AbnormalFail = 0x2
   };
+  enum FrameResult {
+    Frame_Result_Success      = 0x0,
+    // frame is invalid or does not fit the output buffer,
+    // TLS session state is not changed
+    Frame_Result_Rejected     = 0x1,
+    // TLS session failed on the frame
+    Frame_Result_Fail         = 0x2,
+    Frame_Result_NotProcessed = 0x3
+  };
+  /**
+   * \brief Frame description for batched Encrypt/Decrypt
+   */
+  struct Frame {
+    const uint8_t *in_data;
+    size_t in_data_size;
+    uint8_t *out_data;
+    size_t out_buffer_size;
+    // filled by SSLContext with size of produced data
+    size_t out_data_size;
+    // filled by SSLContext with result of the frame processing
+    FrameResult result;
+  };
   virtual HandshakeResult StartHandshake(const uint8_t** const out_data,
                                          size_t *out_data_size) = 0;
   virtual HandshakeResult DoHandshakeStep(const uint8_t *const in_data,
@@ -75,9 +119,12 @@ class SSLContext {
                        const uint8_t ** const out_data, size_t *out_data_size) = 0;
   virtual bool Decrypt(const uint8_t *const in_data,    size_t in_data_size,
                        const uint8_t ** const out_data, size_t *out_data_size) = 0;
+  virtual size_t EncryptBatch(Frame *frames, size_t frames_count) = 0;
+  virtual size_t DecryptBatch(Frame *frames, size_t frames_count) = 0;
   virtual bool  IsInitCompleted() const = 0;
   virtual bool  IsHandshakePending() const = 0;
   virtual size_t get_max_block_size(size_t mtu) const = 0;
+  virtual size_t get_max_encrypted_size(size_t data_size) const = 0;
   virtual std::string LastError() const = 0;
   virtual ~SSLContext() { }
 };
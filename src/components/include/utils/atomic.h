@@ -55,6 +55,24 @@
 #define atomic_post_dec(ptr) (*(ptr))--
 #endif
 
+#if defined(__QNXNTO__)
+#define atomic_post_add(ptr, value) atomic_add_value((ptr), (value))
+#elif defined(__GNUG__)
+#define atomic_post_add(ptr, value) __sync_fetch_and_add((ptr), (value))
+#else
+#warning "atomic_post_add() implementation is not atomic"
+#define atomic_post_add(ptr, value) ((*(ptr) += (value)) - (value))
+#endif
+
+#if defined(__QNXNTO__)
+// returns the previous value and leaves zero in place
+#define atomic_post_reset(ptr) atomic_clr_value((ptr), ~0u)
+#elif defined(__GNUG__)
+#define atomic_post_reset(ptr) __sync_fetch_and_and((ptr), 0)
+#else
+#error "atomic post reset operation not defined"
+#endif
+
 #if defined(__QNXNTO__)
 // on QNX pointer assignment is believed to be atomic
 #define atomic_pointer_assign(dst, src) (dst) = (src)
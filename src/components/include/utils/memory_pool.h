@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_INCLUDE_UTILS_MEMORY_POOL_H_
+#define SRC_COMPONENTS_INCLUDE_UTILS_MEMORY_POOL_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <new>
+
+namespace utils {
+
+/**
+ * @brief Size-classed block allocator for hot-path message buffers.
+ *
+ * Blocks are served from a per-thread cache first, then from a shared
+ * free list per size class, and only then from the system heap.
+ * Released blocks go back to the releasing thread's cache; overflowing
+ * caches hand half of their blocks back to the shared list, so buffers
+ * allocated on the transport thread and released on the protocol handler
+ * thread keep circulating instead of hitting malloc every time.
+ * Requests larger than the biggest size class bypass the pool.
+ *
+ * Objects of known size are pooled separately with 16-byte granularity,
+ * so they are not rounded up to size classes and their blocks carry
+ * no header. Types of equal rounded size share one free list.
+ */
+class MemoryPool {
+ public:
+  /**
+   * @brief Allocation counters of one size class
+   */
+  struct Statistics {
+    Statistics();
+    /**
+     * @brief Share of allocations served without touching the system heap
+     * @return value in range [0, 1]
+     */
+    double hit_rate() const;
+
+    uint32_t allocations;
+    uint32_t thread_cache_hits;
+    uint32_t shared_hits;
+    uint32_t system_allocations;
+    uint32_t releases;
+  };
+
+  /**
+   * @brief Allocates block of at least size bytes
+   * @param size requested size in bytes
+   * @return pointer to block or NULL if system is out of memory
+   */
+  static void* Allocate(size_t size);
+
+  /**
+   * @brief Returns block obtained from Allocate() back to the pool
+   * @param block pointer returned by Allocate(), NULL is ignored
+   */
+  static void Release(void* block);
+
+  /**
+   * @brief Allocates block for object of given size
+   * @param size object size in bytes
+   * @return pointer to block or NULL if system is out of memory
+   */
+  static void* AllocateObject(size_t size);
+
+  /**
+   * @brief Returns block obtained from AllocateObject() back to the pool
+   * @param object pointer returned by AllocateObject(), NULL is ignored
+   * @param size same size as passed to AllocateObject()
+   */
+  static void ReleaseObject(void* object, size_t size);
+
+  /**
+   * @brief Number of pooled size classes
+   */
+  static size_t size_classes_count();
+
+  /**
+   * @brief Usable size of blocks of size class
+   * @param size_class index in range [0, size_classes_count())
+   */
+  static size_t class_block_size(size_t size_class);
+
+  /**
+   * @brief Snapshot of counters of size class
+   * @param size_class index in range [0, size_classes_count())
+   */
+  static Statistics statistics(size_t size_class);
+
+  /**
+   * @brief Snapshot of counters of requests bypassing the pool
+   */
+  static Statistics oversized_statistics();
+
+  /**
+   * @brief Number of pooled object classes
+   */
+  static size_t object_classes_count();
+
+  /**
+   * @brief Size of blocks of object class
+   * @param object_class index in range [0, object_classes_count())
+   */
+  static size_t object_class_size(size_t object_class);
+
+  /**
+   * @brief Snapshot of counters of object class
+   * @param object_class index in range [0, object_classes_count())
+   */
+  static Statistics object_statistics(size_t object_class);
+
+ private:
+  MemoryPool();
+};
+
+/**
+ * @brief Base class routing operator new/delete of derived class
+ * to MemoryPool
+ */
+class PooledObject {
+ public:
+  static void* operator new(size_t size);
+  static void* operator new(size_t size, const std::nothrow_t&) throw();
+  static void operator delete(void* object);
+  static void operator delete(void* object, const std::nothrow_t&) throw();
+
+ protected:
+  PooledObject() {}
+  ~PooledObject() {}
+};
+
+/**
+ * @brief Base class routing operator new/delete of derived class
+ * to MemoryPool object classes.
+ * Derived classes deleted through base pointer must have virtual
+ * destructor, so operator delete gets size of the most derived type.
+ */
+class SizedPooledObject {
+ public:
+  static void* operator new(size_t size);
+  static void operator delete(void* object, size_t size);
+
+ protected:
+  SizedPooledObject() {}
+  ~SizedPooledObject() {}
+};
+
+}  // namespace utils
+
+#endif  // SRC_COMPONENTS_INCLUDE_UTILS_MEMORY_POOL_H_
@@ -33,8 +33,9 @@
 #ifndef SRC_COMPONENTS_INCLUDE_UTILS_MESSAGEMETER_H_
 #define SRC_COMPONENTS_INCLUDE_UTILS_MESSAGEMETER_H_
 
+#include <stdint.h>
 #include <cstddef>
-#include <set>
+#include <algorithm>
 #include <map>
 #include "utils/date_time.h"
 
@@ -42,7 +43,10 @@ namespace utils {
 /**
     @brief The MessageMeter class need to count message frequency
     Default time range value is 1 second
-    IncomingDataHandler methods are reentrant and not thread-safe
+    Messages are counted in a ring of buckets per identifier, so memory
+    does not depend on message rate; message is expired after time range
+    less up to one bucket (1/kBucketsCount of time range).
+    MessageMeter methods are reentrant and not thread-safe
     @tparam Id could be used for handling messages by session,
     connection or other identifier
  */
@@ -86,16 +90,37 @@ class MessageMeter {
   TimevalStruct time_range() const;
 
  private:
+  static const size_t kBucketsCount = 32;
+  struct Ring {
+    Ring();
+    int64_t last_bucket;
+    size_t total;
+    size_t counts[kBucketsCount];
+  };
+  /**
+     @brief Drops buckets expired till current bucket
+   */
+  void Advance(Ring* ring, const int64_t current_bucket) const;
+  int64_t CurrentBucket() const;
+
   TimevalStruct time_range_;
-  typedef std::multiset<TimevalStruct> Timings;
-  typedef std::map<Id, Timings> TimingMap;
-  TimingMap timing_map_;
+  int64_t bucket_usecs_;
+  typedef std::map<Id, Ring> RingMap;
+  RingMap rings_;
 };
 
+template <class Id>
+MessageMeter<Id>::Ring::Ring()
+  : last_bucket(0), total(0) {
+  std::fill(counts, counts + kBucketsCount, 0u);
+}
+
 template <class Id>
 MessageMeter<Id>::MessageMeter()
-  : time_range_(TimevalStruct {0, 0}) {
+  : time_range_(TimevalStruct {0, 0}),
+    bucket_usecs_(0) {
   time_range_.tv_sec = 1;
+  set_time_range(time_range_);
 }
 
 template <class Id>
@@ -106,41 +131,63 @@ size_t MessageMeter<Id>::TrackMessage(const Id& id) {
 template <class Id>
 size_t MessageMeter<Id>::TrackMessages(const Id& id,
                                   const size_t count) {
-  Timings& timings = timing_map_[id];
-  const TimevalStruct current_time = date_time::DateTime::getCurrentTime();
-  for (size_t i = 0; i < count; ++i) {
-    // Adding to the end is amortized constant
-    timings.insert(timings.end(), current_time);
+  if (0 == bucket_usecs_) {
+    return 0u;
   }
-  return Frequency(id);
+  Ring& ring = rings_[id];
+  const int64_t current_bucket = CurrentBucket();
+  Advance(&ring, current_bucket);
+  ring.counts[ring.last_bucket % kBucketsCount] += count;
+  ring.total += count;
+  return ring.total;
 }
 
 template <class Id>
 size_t MessageMeter<Id>::Frequency(const Id& id) {
-  typename TimingMap::iterator it = timing_map_.find(id);
-  if(it == timing_map_.end()) {
+  typename RingMap::iterator it = rings_.find(id);
+  if (it == rings_.end() || 0 == bucket_usecs_) {
     return 0u;
   }
-  Timings& timings = it->second;
-  if (timings.empty()) {
-    return 0u;
-  }
-  const TimevalStruct actual_begin_time =
-      date_time::DateTime::Sub(date_time::DateTime::getCurrentTime(),
-                               time_range_);
-  timings.erase(timings.begin(),
-                timings.upper_bound(actual_begin_time));
-  return timings.size();
+  Advance(&it->second, CurrentBucket());
+  return it->second.total;
 }
 
 template <class Id>
 void MessageMeter<Id>::RemoveIdentifier(const Id& id) {
-  timing_map_.erase(id);
+  rings_.erase(id);
 }
 
 template <class Id>
 void MessageMeter<Id>::ClearIdentifiers() {
-  timing_map_.clear();
+  rings_.clear();
+}
+
+template <class Id>
+void MessageMeter<Id>::Advance(Ring* ring,
+                               const int64_t current_bucket) const {
+  if (current_bucket - ring->last_bucket >=
+      static_cast<int64_t>(kBucketsCount)) {
+    std::fill(ring->counts, ring->counts + kBucketsCount, 0u);
+    ring->total = 0;
+    ring->last_bucket = current_bucket;
+    return;
+  }
+  // Time going backward keeps counting in the latest bucket
+  for (int64_t bucket = ring->last_bucket + 1; bucket <= current_bucket;
+       ++bucket) {
+    size_t& count = ring->counts[bucket % kBucketsCount];
+    ring->total -= count;
+    count = 0;
+  }
+  if (current_bucket > ring->last_bucket) {
+    ring->last_bucket = current_bucket;
+  }
+}
+
+template <class Id>
+int64_t MessageMeter<Id>::CurrentBucket() const {
+  return date_time::DateTime::getuSecs(
+      date_time::DateTime::getCurrentTime()) / bucket_usecs_;
 }
 
 template <class Id>
@@ -148,15 +195,24 @@ void MessageMeter<Id>::set_time_range(const size_t time_range_msecs) {
   // TODO(EZamakhov): move to date_time::DateTime
   const size_t secs =
       time_range_msecs / date_time::DateTime::MILLISECONDS_IN_SECOND;
-  time_range_.tv_sec = secs;
+  TimevalStruct time_range = {0, 0};
+  time_range.tv_sec = secs;
   const size_t mSecs =
       time_range_msecs % date_time::DateTime::MILLISECONDS_IN_SECOND;
-  time_range_.tv_usec =
+  time_range.tv_usec =
       mSecs * date_time::DateTime::MICROSECONDS_IN_MILLISECONDS;
+  set_time_range(time_range);
 }
 template <class Id>
 void MessageMeter<Id>::set_time_range(const TimevalStruct& time_range) {
   time_range_ = time_range;
+  const int64_t range_usecs = date_time::DateTime::getuSecs(time_range_);
+  bucket_usecs_ = range_usecs / static_cast<int64_t>(kBucketsCount);
+  if (0 == bucket_usecs_ && range_usecs > 0) {
+    bucket_usecs_ = 1;
+  }
+  // Counted buckets have different width now
+  ClearIdentifiers();
 }
 template <class Id>
 TimevalStruct MessageMeter<Id>::time_range() const {
@@ -171,6 +171,11 @@ class SharedPtr {
      */
     bool valid() const;
 
+    /**
+     * @return true if this is the only reference to mObject
+     */
+    bool unique() const;
+
   private:
     void reset_impl(ObjectType* other);
 
@@ -368,6 +373,11 @@ inline bool SharedPtr<ObjectType>::valid() const {
   return false;
 }
 
+template<typename ObjectType>
+inline bool SharedPtr<ObjectType>::unique() const {
+  return valid() && (1 == *mReferenceCounter);
+}
+
 }  // namespace utils
 
 #endif  // SRC_COMPONENTS_INCLUDE_UTILS_SHARED_PTR_H_
@@ -34,14 +34,17 @@
 #define SRC_COMPONENTS_POLICY_INCLUDE_CACHE_MANAGER_H_
 
 #include <map>
+#include <vector>
 
 #include "utils/shared_ptr.h"
 #include "policy/pt_representation.h"
 #include "policy/pt_ext_representation.h"
 #include "usage_statistics/statistics_manager.h"
+#include "usage_statistics/statistics_aggregator.h"
 #include "policy/cache_manager_interface.h"
 
 #include "utils/lock.h"
+#include "utils/macro.h"
 #include "utils/timer_thread.h"
 #include "utils/conditional_variable.h"
 
@@ -188,13 +191,29 @@ class CacheManager : public CacheManagerInterface {
   /**
    * @brief Get snapshot of Policy Table
    * including app_policies, functional_groups,
-   * device_info, statistics, excluding user messages
+   * device_info, statistics. Snapshot is the current table shared with
+   * the cache, which copies the table before next change, so it is taken
+   * in constant time and has to be left unchanged. User messages are
+   * excluded when snapshot is written by WriteSnapshot(). Snapshot is of
+   * PT_SNAPSHOT type to be checked by IsSnapshotValid().
    * @return Generated structure for obtaining Json string.
    */
   virtual utils::SharedPtr<policy_table::Table> GenerateSnapshot();
 
   /**
-   * Applies policy table to the current table
+   * @brief Gets current state of the policy table parts, which could be
+   * affected by update: policies of applications listed in update and
+   * functional groupings referenced by them. Unlike GenerateSnapshot
+   * copies the parts, so they could be changed.
+   * @param update_pt policy table update
+   * @return Partial copy of policy table
+   */
+  virtual utils::SharedPtr<policy_table::Table> GenerateUpdateSnapshot(
+      const policy_table::Table& update_pt);
+
+  /**
+   * Applies policy table to the current table. Only groups, applications and
+   * sections, which differ from the current ones, are replaced and stored.
    * @param update_pt policy table
    * @return true if successfully
    */
@@ -532,11 +551,29 @@ class CacheManager : public CacheManagerInterface {
 
   /**
    * @brief LoadFromFile allows to load policy cache from preloaded table.
+   * Table is stored in database by backup thread.
    * @param file_name preloaded
    * @return
    */
   bool LoadFromFile(const std::string& file_name);
 
+  /**
+   * @brief LoadFromImage allows to load policy cache from image of
+   * preloaded table made by policyCompiler. Table is stored in database
+   * by backup thread, so start is not delayed by filling the database.
+   * @param file_name Path to preloaded PT file image was made from
+   * @return true if image is found, is made from the file and is not damaged
+   */
+  bool LoadFromImage(const std::string& file_name);
+
+  /**
+   * @brief Caches valid preloaded table and marks database to be loaded
+   * from preloaded PT again till backup thread stores the table in it.
+   * @param table Preloaded table
+   * @return true if database is cleared for the table
+   */
+  bool SetPreloadedTable(const utils::SharedPtr<policy_table::Table>& table);
+
   /**
    * @brief Backup allows to save cache onto hard drive.
    */
@@ -581,15 +618,70 @@ private:
   long ConvertSecondsToMinute(int seconds);
 
   /**
-   * @brief Checks snapshot initialization and initializes to default values, if
-   * necessary
+   * @brief Copies the table if it is shared with reader, snapshot or
+   * backup, so they are not changed. Has to be called under cache_lock_
+   * before any change of the table, which has to be done under the same
+   * lock.
+   */
+  void DetachTable();
+
+  /**
+   * @brief Reference to the current table taken under cache_lock_.
+   * The table is read without the lock then: while it is referenced,
+   * writers change a copy made by DetachTable. Must not be used by
+   * methods holding cache_lock_.
    */
-  void CheckSnapshotInitialization();
+  class TableReader {
+   public:
+    explicit TableReader(const CacheManager* cache_manager);
+
+    policy_table::Table* operator->() const {
+      return table_.get();
+    }
+
+    policy_table::Table& operator*() const {
+      return *table_;
+    }
+
+   private:
+    utils::SharedPtr<policy_table::Table> table_;
+    DISALLOW_COPY_AND_ASSIGN(TableReader);
+  };
+  friend class TableReader;
 
   void PersistData();
 
+  /**
+   * @brief Schedules storing of changed policy table parts only.
+   * @param changes parts to store, merged with ones scheduled before
+   */
+  void BackupChanges(const PolicyTableChanges& changes);
+
+  /**
+   * @brief Stores changed policy table parts in one transaction.
+   * @param changes parts to store
+   */
+  void PersistChanges(const PolicyTableChanges& changes);
+
+  /**
+   * @brief Compares update with the current table.
+   * @param update_pt policy table update
+   * @param changes filled with groups, applications and sections
+   * which have to be replaced
+   */
+  void CollectChanges(const policy_table::Table& update_pt,
+                      PolicyTableChanges* changes) const;
+
+  /**
+   * @brief Stores usage statistics gathered since previous call
+   * in one transaction.
+   */
+  void FlushStatistics();
+
   void ResetCalculatedPermissions();
 
+  void ResetCalculatedPermissions(const std::set<std::string>& app_ids);
+
   void AddCalculatedPermissions(
       const std::string& device_id,
       const std::string& policy_app_id,
@@ -611,14 +703,13 @@ private:
 
 private:
   utils::SharedPtr<policy_table::Table> pt_;
-  utils::SharedPtr<policy_table::Table> snapshot_;
   utils::SharedPtr<PTRepresentation> backup_;
   utils::SharedPtr<PTExtRepresentation> ex_backup_;
   bool update_required;
   typedef std::set<std::string> UnpairedDevices;
   UnpairedDevices is_unpaired_;
 
-  sync_primitives::Lock cache_lock_;
+  mutable sync_primitives::Lock cache_lock_;
   sync_primitives::Lock unpaired_lock_;
 
   typedef std::map<std::string, Permissions> AppCalculatedPermissions;
@@ -626,6 +717,19 @@ private:
   CalculatedPermissions calculated_permissions_;
   sync_primitives::Lock calculated_permissions_lock_;
 
+  usage_statistics::StatisticsAggregator statistics_;
+
+  PolicyTableChanges pending_changes_;
+  bool is_full_backup_pending_;
+  sync_primitives::Lock pending_changes_lock_;
+  // False since table is loaded from preloaded PT and till it is
+  // stored in database by backup thread. Guarded by cache_lock_.
+  bool is_preloaded_pt_stored_;
+  // True when current table is of PT_SNAPSHOT type, which is read only by
+  // validation, so the type is set once and not under readers' feet.
+  // Guarded by cache_lock_.
+  bool is_snapshot_type_set_;
+
   class BackgroundBackuper: public threads::ThreadDelegate {
       friend class CacheManager;
     public:
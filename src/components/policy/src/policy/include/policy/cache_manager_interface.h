@@ -184,11 +184,25 @@ class CacheManagerInterface {
   /**
    * @brief Get snapshot of Policy Table
    * including app_policies, functional_groups,
-   * device_info, statistics, excluding user messages
+   * device_info, statistics. Snapshot is the current table shared with
+   * the cache, which copies the table before next change, so it is taken
+   * in constant time and has to be left unchanged. User messages are
+   * excluded when snapshot is written by WriteSnapshot().
    * @return Generated structure for obtaining Json string.
    */
   virtual utils::SharedPtr<policy_table::Table> GenerateSnapshot() = 0;
 
+  /**
+   * @brief Gets current state of the policy table parts, which could be
+   * affected by update: policies of applications listed in update and
+   * functional groupings referenced by them. Unlike GenerateSnapshot
+   * copies the parts, so they could be changed.
+   * @param update_pt policy table update
+   * @return Partial copy of policy table
+   */
+  virtual utils::SharedPtr<policy_table::Table> GenerateUpdateSnapshot(
+      const policy_table::Table& update_pt) = 0;
+
   /**
    * Applies policy table to the current table
    * @param update_pt policy table
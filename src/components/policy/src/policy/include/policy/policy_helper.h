@@ -238,6 +238,28 @@ FunctionalGroupIDs FindSame(const FunctionalGroupIDs& first,
  */
 bool UnwrapAppPolicies(policy_table::ApplicationPolicies& app_policies);
 
+/**
+ * @brief Writes snapshot of policy table, which is sent with PTU request.
+ * Snapshot has only version of consumer friendly messages and preloaded flag
+ * is false in it. Table is written as JSON directly, so it is neither copied
+ * nor changed and could be shared with the cache.
+ * Text is the same as Json::FastWriter writes for a copy of the table:
+ * members are sorted by name, and integers which were never set are
+ * written, since a copied rpc::Integer is always set.
+ * @param table Current policy table
+ * @param output String the snapshot is appended to
+ */
+void WriteSnapshot(const policy_table::Table& table, std::string* output);
+
+/**
+ * @brief Validates table as snapshot written from it by WriteSnapshot, i.e.
+ * without messages and with preloaded flag being false, so the table is
+ * neither copied nor written for that
+ * @param table Table of PT_SNAPSHOT type
+ * @return true, if snapshot is valid, otherwise - false
+ */
+bool IsSnapshotValid(const policy_table::Table& table);
+
 }
 
 #endif // SRC_COMPONENTS_POLICY_INCLUDE_POLICY_POLICY_HELPER_H_
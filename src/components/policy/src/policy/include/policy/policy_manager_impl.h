@@ -311,11 +311,6 @@ private:
    */
   timer::TimerThread<PolicyManagerImpl> timer_retry_sequence_;
 
-  /**
-   * Lock for guarding recording statistics
-   */
-  sync_primitives::Lock statistics_lock_;
-
   /**
    * @brief Device id, which is used during PTU handling for specific
    * application
@@ -306,6 +306,24 @@ typedef std::map<uint32_t, std::pair<std::string, std::string> > FunctionalGroup
  */
 typedef std::vector<std::string> DeviceIds;
 
+/**
+ * @brief Sections of policy table changed by update, used to apply
+ * and store only the data which differs from the current one
+ */
+struct PolicyTableChanges {
+    PolicyTableChanges()
+      : is_device_changed(false),
+        is_module_config_changed(false),
+        is_messages_changed(false) {}
+
+    std::set<std::string> updated_groups;  // added or changed groups names
+    std::set<std::string> removed_groups;
+    std::set<std::string> updated_apps;    // added, changed or revoked apps
+    bool is_device_changed;
+    bool is_module_config_changed;
+    bool is_messages_changed;
+};
+
 }  //  namespace policy
 
 #endif  //  SRC_COMPONENTS_POLICY_INCLUDE_POLICY_POLICY_TYPES_H_
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_POLICY_INCLUDE_POLICY_PRELOADED_PT_IMAGE_H_
+#define SRC_COMPONENTS_POLICY_INCLUDE_POLICY_PRELOADED_PT_IMAGE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+#include "utils/macro.h"
+#include "utils/shared_ptr.h"
+#include "policy/policy_types.h"
+#include "./types.h"
+
+namespace policy {
+
+namespace policy_table = rpc::policy_table_interface_base;
+
+/**
+ * @brief Precompiled preloaded policy table.
+ * Image is made from sdl_preloaded_pt.json at build time by policyCompiler
+ * tool, which validates the table, so it is not validated again on start.
+ * Image consists of versioned header followed by the table written as
+ * compact JSON. Header keeps size and hash of the source file, so image
+ * made from another preloaded PT is not used.
+ */
+class PreloadedPTImage {
+ public:
+  /**
+   * @brief Version of image layout, image of other version is not used
+   */
+  static const uint32_t kFormatVersion = 1;
+
+  /**
+   * @brief Gets name of image made for preloaded PT file,
+   * e.g. sdl_preloaded_pt.img for sdl_preloaded_pt.json
+   * @param preloaded_file Path to preloaded PT file
+   * @return path to image file
+   */
+  static std::string ImageFileName(const std::string& preloaded_file);
+
+  /**
+   * @brief Writes image of the table
+   * @param table Valid preloaded policy table
+   * @param source Contents of preloaded PT file table was parsed from
+   * @param image_file Path to image file, it is overwritten
+   * @return true if image was written
+   */
+  static bool Write(const policy_table::Table& table,
+                    const BinaryMessage& source,
+                    const std::string& image_file);
+
+  PreloadedPTImage();
+  ~PreloadedPTImage();
+
+  /**
+   * @brief Maps image file into memory and checks its header and contents
+   * @param image_file Path to image file
+   * @return true if image of known version is mapped and is not damaged
+   */
+  bool Open(const std::string& image_file);
+
+  /**
+   * @brief Checks if opened image was made from the preloaded PT file
+   * @param source Contents of preloaded PT file
+   */
+  bool IsMadeFrom(const BinaryMessage& source) const;
+
+  /**
+   * @brief Reads policy table right from the mapped image
+   * @return table or empty pointer if image is not opened or damaged
+   */
+  utils::SharedPtr<policy_table::Table> ReadTable() const;
+
+ private:
+  void Close();
+
+  const char* data_;
+  size_t size_;
+  uint32_t source_size_;
+  uint32_t source_hash_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreloadedPTImage);
+};
+
+}  //  namespace policy
+
+#endif  //  SRC_COMPONENTS_POLICY_INCLUDE_POLICY_PRELOADED_PT_IMAGE_H_
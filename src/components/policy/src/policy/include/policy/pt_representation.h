@@ -40,6 +40,10 @@
 
 namespace policy_table = rpc::policy_table_interface_base;
 
+namespace usage_statistics {
+struct Statistics;
+}  //  namespace usage_statistics
+
 namespace policy {
 
 /**
@@ -226,6 +230,16 @@ class PTRepresentation {
 
     virtual bool Save(const policy_table::Table& table) = 0;
 
+    /**
+     * @brief Stores only changed sections of policy table in one transaction.
+     * @param table contains at least all sections and entries listed
+     * in changes, entries absent in table are removed
+     * @param changes sections to store
+     * @return true, if all changes are stored, otherwise nothing is stored
+     */
+    virtual bool SaveChanges(const policy_table::Table& table,
+                             const PolicyTableChanges& changes) = 0;
+
     /**
      * Gets flag updateRequired
      * @return true if update is required
@@ -237,6 +251,13 @@ class PTRepresentation {
      */
     virtual void SaveUpdateRequired(bool value) = 0;
 
+    /**
+     * Saves flag isFirstRun, Init() reports SUCCESS for the table marked
+     * as first run, so it is loaded from preloaded PT again
+     * @param is_first_run true if stored table is not complete yet
+     */
+    virtual void SaveIsFirstRun(bool is_first_run) = 0;
+
     /*
      Retrieves data from app_policies about app on its registration:
      app_id - id of registered app; all outputs are filled in only if not null
@@ -303,6 +324,15 @@ class PTRepresentation {
                                            bool is_predata) = 0;
 
     virtual void WriteDb() = 0;
+
+    /**
+     * @brief Adds gathered usage statistics to stored one in one transaction.
+     * Stopwatches are expected to be converted to minutes already.
+     * @param statistics values to add
+     * @return true, if all values are stored, otherwise nothing is stored
+     */
+    virtual bool SaveStatistics(
+        const usage_statistics::Statistics& statistics) = 0;
 };
 
 }  //  namespace policy
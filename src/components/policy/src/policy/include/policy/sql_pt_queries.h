@@ -48,6 +48,7 @@ extern const std::string kSelectRpc;
 extern const std::string kSelectPreloaded;
 extern const std::string kIsFirstRun;
 extern const std::string kSetNotFirstRun;
+extern const std::string kUpdateIsFirstRun;
 extern const std::string kSelectEndpoint;
 extern const std::string kSelectLockScreenIcon;
 extern const std::string kSelectModuleConfig;
@@ -55,6 +56,7 @@ extern const std::string kSelectEndpoints;
 extern const std::string kSelectNotificationsPerMin;
 extern const std::string kSelectNotificationsPerPriority;
 extern const std::string kSelectAppLevels;
+extern const std::string kSelectGlobalCounters;
 extern const std::string kSelectDeviceData;
 extern const std::string kSelectFunctionalGroups;
 extern const std::string kSelectAllRpcs;
@@ -87,6 +89,7 @@ extern const std::string kInsertSecondsBetweenRetry;
 extern const std::string kInsertNotificationsByPriority;
 extern const std::string kInsertDeviceData;
 extern const std::string kInsertAppLevel;
+extern const std::string kInsertAppLevelIfAbsent;
 extern const std::string kDeleteSecondsBetweenRetries;
 extern const std::string kDeleteEndpoint;
 extern const std::string kDeleteAppLevel;
@@ -94,11 +97,21 @@ extern const std::string kDeleteMessageString;
 extern const std::string kDeleteFunctionalGroup;
 extern const std::string kDeleteRpc;
 extern const std::string kDeleteAppGroup;
+extern const std::string kDeleteRpcByFunctionalGroupId;
+extern const std::string kDeleteFunctionalGroupById;
+extern const std::string kDeleteAppGroupByFunctionalGroupId;
+extern const std::string kDeleteApplicationById;
+extern const std::string kDeleteRequestTypeByApplicationId;
+extern const std::string kDeleteNicknameByApplicationId;
+extern const std::string kDeleteAppTypeByApplicationId;
 extern const std::string kDeleteApplication;
 extern const std::string kDeleteRequestType;
 extern const std::string kDeleteDevice;
 extern const std::string kIncrementIgnitionCycles;
 extern const std::string kResetIgnitionCycles;
+extern const std::string kAddGlobalCounters;
+extern const std::string kUpdateGlobalCounters;
+extern const std::string kAddAppLevelStatistics;
 extern const std::string kUpdateFlagUpdateRequired;
 extern const std::string kSelectFlagUpdateRequired;
 extern const std::string kUpdateCountersSuccessfulUpdate;
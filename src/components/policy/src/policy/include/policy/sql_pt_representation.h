@@ -82,8 +82,12 @@ class SQLPTRepresentation : public virtual PTRepresentation {
     bool Clear();
     bool Drop();
     virtual void WriteDb();
+    virtual bool SaveStatistics(
+      const usage_statistics::Statistics& statistics);
     virtual utils::SharedPtr<policy_table::Table> GenerateSnapshot() const;
     virtual bool Save(const policy_table::Table& table);
+    virtual bool SaveChanges(const policy_table::Table& table,
+                             const PolicyTableChanges& changes);
     bool GetInitialAppData(const std::string& app_id, StringArray* nicknames =
                              NULL,
                            StringArray* app_hmi_types = NULL);
@@ -147,6 +151,7 @@ class SQLPTRepresentation : public virtual PTRepresentation {
   public:
     bool UpdateRequired() const;
     void SaveUpdateRequired(bool value);
+    void SaveIsFirstRun(bool is_first_run);
 
     bool IsApplicationRepresented(const std::string& app_id) const;
     bool CopyApplication(const std::string& source,
@@ -168,6 +173,10 @@ class SQLPTRepresentation : public virtual PTRepresentation {
     dbms::SQLDatabase* db_;
 
     bool SaveRpcs(int64_t group_id, const policy_table::Rpc& rpcs);
+    bool SaveFunctionalGroup(
+      const policy_table::FunctionalGroupings::value_type& group);
+    bool DeleteFunctionalGroup(const std::string& group_name);
+    bool DeleteApplication(const std::string& app_id);
     bool SaveServiceEndpoints(const policy_table::ServiceEndpoints& endpoints);
     bool SaveSecondsBetweenRetries(
       const policy_table::SecondsBetweenRetries& seconds);
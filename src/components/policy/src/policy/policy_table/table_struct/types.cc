@@ -28,11 +28,30 @@ PolicyBase::~PolicyBase() {}
 PolicyBase::PolicyBase(const Json::Value *value__)
     : CompositeType(InitHelper(value__, &Json::Value::isObject)),
       priority(impl::ValueMember(value__, "priority")) {}
+PolicyBase::PolicyBase(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "priority") {
+      impl::ReadJsonField(reader__, &priority);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value PolicyBase::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   impl::WriteJsonField("priority", priority, &result__);
   return result__;
 }
+void PolicyBase::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("priority", priority, writer__);
+  writer__->WriteObjectEnd();
+}
 bool PolicyBase::is_valid() const {
   if (!priority.is_valid()) {
     return false;
@@ -67,6 +86,8 @@ DevicePolicy::DevicePolicy() : PolicyBase() {}
 DevicePolicy::DevicePolicy(Priority priority) : PolicyBase(priority) {}
 DevicePolicy::~DevicePolicy() {}
 DevicePolicy::DevicePolicy(const Json::Value *value__) : PolicyBase(value__) {}
+DevicePolicy::DevicePolicy(JsonStreamReader *reader__)
+    : PolicyBase(reader__) {}
 
 // AppPoliciesSection methods
 ApplicationPoliciesSection::ApplicationPoliciesSection()
@@ -84,12 +105,55 @@ ApplicationPoliciesSection::ApplicationPoliciesSection(
   // device section
   apps.erase("device");
 }
+ApplicationPoliciesSection::ApplicationPoliciesSection(
+    JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!reader__ || !reader__->NextIsObject()) {
+    impl::ReadJsonField(reader__, &apps);
+    return;
+  }
+  reader__->TakeObjectStart();
+  apps.mark_initialized();
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    // "device" is kept in separate struct and is not added to apps
+    if (name__ == "device") {
+      impl::ReadJsonField(reader__, &device);
+    } else {
+      impl::ReadJsonMapItem(reader__, name__, &apps);
+    }
+  }
+}
 Json::Value ApplicationPoliciesSection::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   result__ = apps.ToJsonValue();
   impl::WriteJsonField("device", device, &result__);
   return result__;
 }
+void ApplicationPoliciesSection::ToJsonWriter(
+    JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  // Applications are members of the section along with device, all of them
+  // are written sorted by name as Json::Value keeps them
+  const std::string device_name = "device";
+  bool is_device_written = !device.is_initialized();
+  for (ApplicationPolicies::const_iterator app = apps.begin();
+       apps.end() != app; ++app) {
+    if (!is_device_written && app->first >= device_name) {
+      impl::WriteJsonField("device", device, writer__);
+      is_device_written = true;
+      if (device_name == app->first) {
+        continue;
+      }
+    }
+    writer__->WriteMemberName(app->first);
+    app->second.ToJsonWriter(writer__);
+  }
+  if (!is_device_written) {
+    impl::WriteJsonField("device", device, writer__);
+  }
+  writer__->WriteObjectEnd();
+}
 bool ApplicationPoliciesSection::is_valid() const {
   if (!device.is_valid()) {
     return false;
@@ -144,6 +208,39 @@ ApplicationParams::ApplicationParams(const Json::Value *value__)
       heart_beat_timeout_ms(
           impl::ValueMember(value__, "heart_beat_timeout_ms")),
       certificate(impl::ValueMember(value__, "certificate"), "not_specified") {}
+ApplicationParams::ApplicationParams(JsonStreamReader *reader__)
+    : PolicyBase(), memory_kb(Integer<uint16_t, 0, 65225>(static_cast<uint16_t>(0))),
+      certificate(String<0, 255>("not_specified")) {
+  // Defaults above are the ones Json::Value constructor uses for absent
+  // members, "priority" of the base struct is read here as well
+  initialization_state__ =
+      InitHelper(reader__, &JsonStreamReader::NextIsObject);
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "priority") {
+      impl::ReadJsonField(reader__, &priority);
+    } else if (name__ == "groups") {
+      impl::ReadJsonField(reader__, &groups);
+    } else if (name__ == "nicknames") {
+      impl::ReadJsonField(reader__, &nicknames);
+    } else if (name__ == "AppHMIType") {
+      impl::ReadJsonField(reader__, &AppHMIType);
+    } else if (name__ == "RequestType") {
+      impl::ReadJsonField(reader__, &RequestType);
+    } else if (name__ == "memory_kb") {
+      impl::ReadJsonField(reader__, &memory_kb);
+    } else if (name__ == "heart_beat_timeout_ms") {
+      impl::ReadJsonField(reader__, &heart_beat_timeout_ms);
+    } else {
+      // "certificate" keeps its default value as String(value, def_value)
+      // in Json::Value constructor does
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value ApplicationParams::ToJsonValue() const {
   Json::Value result__(PolicyBase::ToJsonValue());
   impl::WriteJsonField("groups", groups, &result__);
@@ -156,6 +253,19 @@ Json::Value ApplicationParams::ToJsonValue() const {
   impl::WriteJsonField("certificate", certificate, &result__);
   return result__;
 }
+void ApplicationParams::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("AppHMIType", AppHMIType, writer__);
+  impl::WriteJsonField("RequestType", RequestType, writer__);
+  impl::WriteJsonField("certificate", certificate, writer__);
+  impl::WriteJsonField("groups", groups, writer__);
+  impl::WriteJsonFieldAsCopied("heart_beat_timeout_ms", heart_beat_timeout_ms,
+                               writer__);
+  impl::WriteJsonFieldAsCopied("memory_kb", memory_kb, writer__);
+  impl::WriteJsonField("nicknames", nicknames, writer__);
+  impl::WriteJsonField("priority", priority, writer__);
+  writer__->WriteObjectEnd();
+}
 bool ApplicationParams::is_valid() const {
   // RequestType is not validated since there is high-level validation logic,
   // which takes into account information not available here.
@@ -261,12 +371,34 @@ RpcParameters::RpcParameters(const Json::Value *value__)
     : CompositeType(InitHelper(value__, &Json::Value::isObject)),
       hmi_levels(impl::ValueMember(value__, "hmi_levels")),
       parameters(impl::ValueMember(value__, "parameters")) {}
+RpcParameters::RpcParameters(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "hmi_levels") {
+      impl::ReadJsonField(reader__, &hmi_levels);
+    } else if (name__ == "parameters") {
+      impl::ReadJsonField(reader__, &parameters);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value RpcParameters::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   impl::WriteJsonField("hmi_levels", hmi_levels, &result__);
   impl::WriteJsonField("parameters", parameters, &result__);
   return result__;
 }
+void RpcParameters::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("hmi_levels", hmi_levels, writer__);
+  impl::WriteJsonField("parameters", parameters, writer__);
+  writer__->WriteObjectEnd();
+}
 bool RpcParameters::is_valid() const {
   if (!hmi_levels.is_valid()) {
     return false;
@@ -315,12 +447,34 @@ Rpcs::Rpcs(const Json::Value *value__)
     : CompositeType(InitHelper(value__, &Json::Value::isObject)),
       user_consent_prompt(impl::ValueMember(value__, "user_consent_prompt")),
       rpcs(impl::ValueMember(value__, "rpcs")) {}
+Rpcs::Rpcs(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "user_consent_prompt") {
+      impl::ReadJsonField(reader__, &user_consent_prompt);
+    } else if (name__ == "rpcs") {
+      impl::ReadJsonField(reader__, &rpcs);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value Rpcs::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   impl::WriteJsonField("user_consent_prompt", user_consent_prompt, &result__);
   impl::WriteJsonField("rpcs", rpcs, &result__);
   return result__;
 }
+void Rpcs::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("rpcs", rpcs, writer__);
+  impl::WriteJsonField("user_consent_prompt", user_consent_prompt, writer__);
+  writer__->WriteObjectEnd();
+}
 bool Rpcs::is_valid() const {
   if (!user_consent_prompt.is_valid()) {
     return false;
@@ -399,6 +553,40 @@ ModuleConfig::ModuleConfig(const Json::Value *value__)
       vehicle_make(impl::ValueMember(value__, "vehicle_make")),
       vehicle_model(impl::ValueMember(value__, "vehicle_model")),
       vehicle_year(impl::ValueMember(value__, "vehicle_year")) {}
+ModuleConfig::ModuleConfig(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "preloaded_pt") {
+      impl::ReadJsonField(reader__, &preloaded_pt);
+    } else if (name__ == "exchange_after_x_ignition_cycles") {
+      impl::ReadJsonField(reader__, &exchange_after_x_ignition_cycles);
+    } else if (name__ == "exchange_after_x_kilometers") {
+      impl::ReadJsonField(reader__, &exchange_after_x_kilometers);
+    } else if (name__ == "exchange_after_x_days") {
+      impl::ReadJsonField(reader__, &exchange_after_x_days);
+    } else if (name__ == "timeout_after_x_seconds") {
+      impl::ReadJsonField(reader__, &timeout_after_x_seconds);
+    } else if (name__ == "seconds_between_retries") {
+      impl::ReadJsonField(reader__, &seconds_between_retries);
+    } else if (name__ == "endpoints") {
+      impl::ReadJsonField(reader__, &endpoints);
+    } else if (name__ == "notifications_per_minute_by_priority") {
+      impl::ReadJsonField(reader__, &notifications_per_minute_by_priority);
+    } else if (name__ == "vehicle_make") {
+      impl::ReadJsonField(reader__, &vehicle_make);
+    } else if (name__ == "vehicle_model") {
+      impl::ReadJsonField(reader__, &vehicle_model);
+    } else if (name__ == "vehicle_year") {
+      impl::ReadJsonField(reader__, &vehicle_year);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 
 void ModuleConfig::SafeCopyFrom(const ModuleConfig &from) {
   //  device_certificates = from.device_certificates;  // According to the
@@ -438,6 +626,27 @@ Json::Value ModuleConfig::ToJsonValue() const {
   impl::WriteJsonField("vehicle_year", vehicle_year, &result__);
   return result__;
 }
+void ModuleConfig::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("endpoints", endpoints, writer__);
+  impl::WriteJsonFieldAsCopied("exchange_after_x_days", exchange_after_x_days,
+                               writer__);
+  impl::WriteJsonFieldAsCopied("exchange_after_x_ignition_cycles",
+                               exchange_after_x_ignition_cycles, writer__);
+  impl::WriteJsonFieldAsCopied("exchange_after_x_kilometers",
+                               exchange_after_x_kilometers, writer__);
+  impl::WriteJsonField("notifications_per_minute_by_priority",
+                       notifications_per_minute_by_priority, writer__);
+  impl::WriteJsonField("preloaded_pt", preloaded_pt, writer__);
+  impl::WriteJsonField("seconds_between_retries", seconds_between_retries,
+                       writer__);
+  impl::WriteJsonFieldAsCopied("timeout_after_x_seconds",
+                               timeout_after_x_seconds, writer__);
+  impl::WriteJsonField("vehicle_make", vehicle_make, writer__);
+  impl::WriteJsonField("vehicle_model", vehicle_model, writer__);
+  impl::WriteJsonField("vehicle_year", vehicle_year, writer__);
+  writer__->WriteObjectEnd();
+}
 bool ModuleConfig::is_valid() const {
   if (!preloaded_pt.is_valid()) {
     return false;
@@ -606,6 +815,28 @@ MessageString::MessageString(const Json::Value *value__)
       tts(impl::ValueMember(value__, "tts")),
       label(impl::ValueMember(value__, "label")),
       textBody(impl::ValueMember(value__, "textBody")) {}
+MessageString::MessageString(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "line1") {
+      impl::ReadJsonField(reader__, &line1);
+    } else if (name__ == "line2") {
+      impl::ReadJsonField(reader__, &line2);
+    } else if (name__ == "tts") {
+      impl::ReadJsonField(reader__, &tts);
+    } else if (name__ == "label") {
+      impl::ReadJsonField(reader__, &label);
+    } else if (name__ == "textBody") {
+      impl::ReadJsonField(reader__, &textBody);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value MessageString::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   impl::WriteJsonField("line1", line1, &result__);
@@ -615,6 +846,15 @@ Json::Value MessageString::ToJsonValue() const {
   impl::WriteJsonField("textBody", textBody, &result__);
   return result__;
 }
+void MessageString::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("label", label, writer__);
+  impl::WriteJsonField("line1", line1, writer__);
+  impl::WriteJsonField("line2", line2, writer__);
+  impl::WriteJsonField("textBody", textBody, writer__);
+  impl::WriteJsonField("tts", tts, writer__);
+  writer__->WriteObjectEnd();
+}
 bool MessageString::is_valid() const {
   if (struct_empty()) {
     return initialization_state__ == kInitialized && Validate();
@@ -697,11 +937,30 @@ MessageLanguages::~MessageLanguages() {}
 MessageLanguages::MessageLanguages(const Json::Value *value__)
     : CompositeType(InitHelper(value__, &Json::Value::isObject)),
       languages(impl::ValueMember(value__, "languages")) {}
+MessageLanguages::MessageLanguages(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "languages") {
+      impl::ReadJsonField(reader__, &languages);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value MessageLanguages::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   impl::WriteJsonField("languages", languages, &result__);
   return result__;
 }
+void MessageLanguages::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("languages", languages, writer__);
+  writer__->WriteObjectEnd();
+}
 bool MessageLanguages::is_valid() const {
   if (!languages.is_valid()) {
     return false;
@@ -751,12 +1010,34 @@ ConsumerFriendlyMessages::ConsumerFriendlyMessages(const Json::Value *value__)
     : CompositeType(InitHelper(value__, &Json::Value::isObject)),
       version(impl::ValueMember(value__, "version")),
       messages(impl::ValueMember(value__, "messages")) {}
+ConsumerFriendlyMessages::ConsumerFriendlyMessages(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "version") {
+      impl::ReadJsonField(reader__, &version);
+    } else if (name__ == "messages") {
+      impl::ReadJsonField(reader__, &messages);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value ConsumerFriendlyMessages::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   impl::WriteJsonField("version", version, &result__);
   impl::WriteJsonField("messages", messages, &result__);
   return result__;
 }
+void ConsumerFriendlyMessages::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("messages", messages, writer__);
+  impl::WriteJsonField("version", version, writer__);
+  writer__->WriteObjectEnd();
+}
 bool ConsumerFriendlyMessages::is_valid() const {
   if (!version.is_valid()) {
     return false;
@@ -812,10 +1093,20 @@ ModuleMeta::ModuleMeta() : CompositeType(kUninitialized) {}
 ModuleMeta::~ModuleMeta() {}
 ModuleMeta::ModuleMeta(const Json::Value *value__)
     : CompositeType(InitHelper(value__, &Json::Value::isObject)) {}
+ModuleMeta::ModuleMeta(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (reader__) {
+    reader__->SkipValue();
+  }
+}
 Json::Value ModuleMeta::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   return result__;
 }
+void ModuleMeta::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  writer__->WriteObjectEnd();
+}
 bool ModuleMeta::is_valid() const {
   if (struct_empty()) {
     return initialization_state__ == kInitialized && Validate();
@@ -836,21 +1127,232 @@ void ModuleMeta::ReportErrors(rpc::ValidationReport *report__) const {
 AppLevel::AppLevel() : CompositeType(kUninitialized) {}
 AppLevel::~AppLevel() {}
 AppLevel::AppLevel(const Json::Value *value__)
-    : CompositeType(InitHelper(value__, &Json::Value::isObject)) {}
+    : CompositeType(InitHelper(value__, &Json::Value::isObject)),
+      minutes_in_hmi_full(impl::ValueMember(value__, "minutes_in_hmi_full")),
+      minutes_in_hmi_limited(
+          impl::ValueMember(value__, "minutes_in_hmi_limited")),
+      minutes_in_hmi_background(
+          impl::ValueMember(value__, "minutes_in_hmi_background")),
+      minutes_in_hmi_none(impl::ValueMember(value__, "minutes_in_hmi_none")),
+      count_of_user_selections(
+          impl::ValueMember(value__, "count_of_user_selections")),
+      count_of_rejections_sync_out_of_memory(
+          impl::ValueMember(value__, "count_of_rejections_sync_out_of_memory")),
+      count_of_rejections_nickname_mismatch(
+          impl::ValueMember(value__, "count_of_rejections_nickname_mismatch")),
+      count_of_rejections_duplicate_name(
+          impl::ValueMember(value__, "count_of_rejections_duplicate_name")),
+      count_of_rejected_rpc_calls(
+          impl::ValueMember(value__, "count_of_rejected_rpc_calls")),
+      count_of_rpcs_sent_in_hmi_none(
+          impl::ValueMember(value__, "count_of_rpcs_sent_in_hmi_none")),
+      count_of_removals_for_bad_behavior(
+          impl::ValueMember(value__, "count_of_removals_for_bad_behavior")),
+      count_of_run_attempts_while_revoked(
+          impl::ValueMember(value__, "count_of_run_attempts_while_revoked")),
+      app_registration_language_gui(
+          impl::ValueMember(value__, "app_registration_language_gui")),
+      app_registration_language_vui(
+          impl::ValueMember(value__, "app_registration_language_vui")) {}
+AppLevel::AppLevel(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "minutes_in_hmi_full") {
+      impl::ReadJsonField(reader__, &minutes_in_hmi_full);
+    } else if (name__ == "minutes_in_hmi_limited") {
+      impl::ReadJsonField(reader__, &minutes_in_hmi_limited);
+    } else if (name__ == "minutes_in_hmi_background") {
+      impl::ReadJsonField(reader__, &minutes_in_hmi_background);
+    } else if (name__ == "minutes_in_hmi_none") {
+      impl::ReadJsonField(reader__, &minutes_in_hmi_none);
+    } else if (name__ == "count_of_user_selections") {
+      impl::ReadJsonField(reader__, &count_of_user_selections);
+    } else if (name__ == "count_of_rejections_sync_out_of_memory") {
+      impl::ReadJsonField(reader__, &count_of_rejections_sync_out_of_memory);
+    } else if (name__ == "count_of_rejections_nickname_mismatch") {
+      impl::ReadJsonField(reader__, &count_of_rejections_nickname_mismatch);
+    } else if (name__ == "count_of_rejections_duplicate_name") {
+      impl::ReadJsonField(reader__, &count_of_rejections_duplicate_name);
+    } else if (name__ == "count_of_rejected_rpc_calls") {
+      impl::ReadJsonField(reader__, &count_of_rejected_rpc_calls);
+    } else if (name__ == "count_of_rpcs_sent_in_hmi_none") {
+      impl::ReadJsonField(reader__, &count_of_rpcs_sent_in_hmi_none);
+    } else if (name__ == "count_of_removals_for_bad_behavior") {
+      impl::ReadJsonField(reader__, &count_of_removals_for_bad_behavior);
+    } else if (name__ == "count_of_run_attempts_while_revoked") {
+      impl::ReadJsonField(reader__, &count_of_run_attempts_while_revoked);
+    } else if (name__ == "app_registration_language_gui") {
+      impl::ReadJsonField(reader__, &app_registration_language_gui);
+    } else if (name__ == "app_registration_language_vui") {
+      impl::ReadJsonField(reader__, &app_registration_language_vui);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value AppLevel::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
+  impl::WriteJsonField("minutes_in_hmi_full", minutes_in_hmi_full, &result__);
+  impl::WriteJsonField("minutes_in_hmi_limited", minutes_in_hmi_limited,
+                       &result__);
+  impl::WriteJsonField("minutes_in_hmi_background", minutes_in_hmi_background,
+                       &result__);
+  impl::WriteJsonField("minutes_in_hmi_none", minutes_in_hmi_none, &result__);
+  impl::WriteJsonField("count_of_user_selections", count_of_user_selections,
+                       &result__);
+  impl::WriteJsonField("count_of_rejections_sync_out_of_memory",
+                       count_of_rejections_sync_out_of_memory, &result__);
+  impl::WriteJsonField("count_of_rejections_nickname_mismatch",
+                       count_of_rejections_nickname_mismatch, &result__);
+  impl::WriteJsonField("count_of_rejections_duplicate_name",
+                       count_of_rejections_duplicate_name, &result__);
+  impl::WriteJsonField("count_of_rejected_rpc_calls",
+                       count_of_rejected_rpc_calls, &result__);
+  impl::WriteJsonField("count_of_rpcs_sent_in_hmi_none",
+                       count_of_rpcs_sent_in_hmi_none, &result__);
+  impl::WriteJsonField("count_of_removals_for_bad_behavior",
+                       count_of_removals_for_bad_behavior, &result__);
+  impl::WriteJsonField("count_of_run_attempts_while_revoked",
+                       count_of_run_attempts_while_revoked, &result__);
+  impl::WriteJsonField("app_registration_language_gui",
+                       app_registration_language_gui, &result__);
+  impl::WriteJsonField("app_registration_language_vui",
+                       app_registration_language_vui, &result__);
   return result__;
 }
+void AppLevel::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("app_registration_language_gui",
+                       app_registration_language_gui, writer__);
+  impl::WriteJsonField("app_registration_language_vui",
+                       app_registration_language_vui, writer__);
+  impl::WriteJsonFieldAsCopied("count_of_rejected_rpc_calls",
+                               count_of_rejected_rpc_calls, writer__);
+  impl::WriteJsonFieldAsCopied("count_of_rejections_duplicate_name",
+                               count_of_rejections_duplicate_name, writer__);
+  impl::WriteJsonFieldAsCopied("count_of_rejections_nickname_mismatch",
+                               count_of_rejections_nickname_mismatch, writer__);
+  impl::WriteJsonFieldAsCopied("count_of_rejections_sync_out_of_memory",
+                               count_of_rejections_sync_out_of_memory,
+                               writer__);
+  impl::WriteJsonFieldAsCopied("count_of_removals_for_bad_behavior",
+                               count_of_removals_for_bad_behavior, writer__);
+  impl::WriteJsonFieldAsCopied("count_of_rpcs_sent_in_hmi_none",
+                               count_of_rpcs_sent_in_hmi_none, writer__);
+  impl::WriteJsonFieldAsCopied("count_of_run_attempts_while_revoked",
+                               count_of_run_attempts_while_revoked, writer__);
+  impl::WriteJsonFieldAsCopied("count_of_user_selections",
+                               count_of_user_selections, writer__);
+  impl::WriteJsonFieldAsCopied("minutes_in_hmi_background",
+                               minutes_in_hmi_background, writer__);
+  impl::WriteJsonFieldAsCopied("minutes_in_hmi_full", minutes_in_hmi_full,
+                               writer__);
+  impl::WriteJsonFieldAsCopied("minutes_in_hmi_limited", minutes_in_hmi_limited,
+                               writer__);
+  impl::WriteJsonFieldAsCopied("minutes_in_hmi_none", minutes_in_hmi_none,
+                               writer__);
+  writer__->WriteObjectEnd();
+}
 bool AppLevel::is_valid() const {
   if (struct_empty()) {
     return initialization_state__ == kInitialized && Validate();
   }
+  if (!minutes_in_hmi_full.is_valid()) {
+    return false;
+  }
+  if (!minutes_in_hmi_limited.is_valid()) {
+    return false;
+  }
+  if (!minutes_in_hmi_background.is_valid()) {
+    return false;
+  }
+  if (!minutes_in_hmi_none.is_valid()) {
+    return false;
+  }
+  if (!count_of_user_selections.is_valid()) {
+    return false;
+  }
+  if (!count_of_rejections_sync_out_of_memory.is_valid()) {
+    return false;
+  }
+  if (!count_of_rejections_nickname_mismatch.is_valid()) {
+    return false;
+  }
+  if (!count_of_rejections_duplicate_name.is_valid()) {
+    return false;
+  }
+  if (!count_of_rejected_rpc_calls.is_valid()) {
+    return false;
+  }
+  if (!count_of_rpcs_sent_in_hmi_none.is_valid()) {
+    return false;
+  }
+  if (!count_of_removals_for_bad_behavior.is_valid()) {
+    return false;
+  }
+  if (!count_of_run_attempts_while_revoked.is_valid()) {
+    return false;
+  }
+  if (!app_registration_language_gui.is_valid()) {
+    return false;
+  }
+  if (!app_registration_language_vui.is_valid()) {
+    return false;
+  }
   return Validate();
 }
 bool AppLevel::is_initialized() const {
   return (initialization_state__ != kUninitialized) || (!struct_empty());
 }
-bool AppLevel::struct_empty() const { return true; }
+bool AppLevel::struct_empty() const {
+  if (minutes_in_hmi_full.is_initialized()) {
+    return false;
+  }
+  if (minutes_in_hmi_limited.is_initialized()) {
+    return false;
+  }
+  if (minutes_in_hmi_background.is_initialized()) {
+    return false;
+  }
+  if (minutes_in_hmi_none.is_initialized()) {
+    return false;
+  }
+  if (count_of_user_selections.is_initialized()) {
+    return false;
+  }
+  if (count_of_rejections_sync_out_of_memory.is_initialized()) {
+    return false;
+  }
+  if (count_of_rejections_nickname_mismatch.is_initialized()) {
+    return false;
+  }
+  if (count_of_rejections_duplicate_name.is_initialized()) {
+    return false;
+  }
+  if (count_of_rejected_rpc_calls.is_initialized()) {
+    return false;
+  }
+  if (count_of_rpcs_sent_in_hmi_none.is_initialized()) {
+    return false;
+  }
+  if (count_of_removals_for_bad_behavior.is_initialized()) {
+    return false;
+  }
+  if (count_of_run_attempts_while_revoked.is_initialized()) {
+    return false;
+  }
+  if (app_registration_language_gui.is_initialized()) {
+    return false;
+  }
+  if (app_registration_language_vui.is_initialized()) {
+    return false;
+  }
+  return true;
+}
 void AppLevel::ReportErrors(rpc::ValidationReport *report__) const {
   if (struct_empty()) {
     rpc::CompositeType::ReportErrors(report__);
@@ -861,6 +1363,80 @@ void AppLevel::ReportErrors(rpc::ValidationReport *report__) const {
         ommited_validation_info + PolicyTableTypeToString(GetPolicyTableType());
     report__->set_validation_info(validation_info);
   }
+  if (!minutes_in_hmi_full.is_valid()) {
+    minutes_in_hmi_full.ReportErrors(
+        &report__->ReportSubobject("minutes_in_hmi_full"));
+  }
+  if (!minutes_in_hmi_limited.is_valid()) {
+    minutes_in_hmi_limited.ReportErrors(
+        &report__->ReportSubobject("minutes_in_hmi_limited"));
+  }
+  if (!minutes_in_hmi_background.is_valid()) {
+    minutes_in_hmi_background.ReportErrors(
+        &report__->ReportSubobject("minutes_in_hmi_background"));
+  }
+  if (!minutes_in_hmi_none.is_valid()) {
+    minutes_in_hmi_none.ReportErrors(
+        &report__->ReportSubobject("minutes_in_hmi_none"));
+  }
+  if (!count_of_user_selections.is_valid()) {
+    count_of_user_selections.ReportErrors(
+        &report__->ReportSubobject("count_of_user_selections"));
+  }
+  if (!count_of_rejections_sync_out_of_memory.is_valid()) {
+    count_of_rejections_sync_out_of_memory.ReportErrors(
+        &report__->ReportSubobject("count_of_rejections_sync_out_of_memory"));
+  }
+  if (!count_of_rejections_nickname_mismatch.is_valid()) {
+    count_of_rejections_nickname_mismatch.ReportErrors(
+        &report__->ReportSubobject("count_of_rejections_nickname_mismatch"));
+  }
+  if (!count_of_rejections_duplicate_name.is_valid()) {
+    count_of_rejections_duplicate_name.ReportErrors(
+        &report__->ReportSubobject("count_of_rejections_duplicate_name"));
+  }
+  if (!count_of_rejected_rpc_calls.is_valid()) {
+    count_of_rejected_rpc_calls.ReportErrors(
+        &report__->ReportSubobject("count_of_rejected_rpc_calls"));
+  }
+  if (!count_of_rpcs_sent_in_hmi_none.is_valid()) {
+    count_of_rpcs_sent_in_hmi_none.ReportErrors(
+        &report__->ReportSubobject("count_of_rpcs_sent_in_hmi_none"));
+  }
+  if (!count_of_removals_for_bad_behavior.is_valid()) {
+    count_of_removals_for_bad_behavior.ReportErrors(
+        &report__->ReportSubobject("count_of_removals_for_bad_behavior"));
+  }
+  if (!count_of_run_attempts_while_revoked.is_valid()) {
+    count_of_run_attempts_while_revoked.ReportErrors(
+        &report__->ReportSubobject("count_of_run_attempts_while_revoked"));
+  }
+  if (!app_registration_language_gui.is_valid()) {
+    app_registration_language_gui.ReportErrors(
+        &report__->ReportSubobject("app_registration_language_gui"));
+  }
+  if (!app_registration_language_vui.is_valid()) {
+    app_registration_language_vui.ReportErrors(
+        &report__->ReportSubobject("app_registration_language_vui"));
+  }
+}
+
+void AppLevel::SetPolicyTableType(PolicyTableType pt_type) {
+  CompositeType::SetPolicyTableType(pt_type);
+  minutes_in_hmi_full.SetPolicyTableType(pt_type);
+  minutes_in_hmi_limited.SetPolicyTableType(pt_type);
+  minutes_in_hmi_background.SetPolicyTableType(pt_type);
+  minutes_in_hmi_none.SetPolicyTableType(pt_type);
+  count_of_user_selections.SetPolicyTableType(pt_type);
+  count_of_rejections_sync_out_of_memory.SetPolicyTableType(pt_type);
+  count_of_rejections_nickname_mismatch.SetPolicyTableType(pt_type);
+  count_of_rejections_duplicate_name.SetPolicyTableType(pt_type);
+  count_of_rejected_rpc_calls.SetPolicyTableType(pt_type);
+  count_of_rpcs_sent_in_hmi_none.SetPolicyTableType(pt_type);
+  count_of_removals_for_bad_behavior.SetPolicyTableType(pt_type);
+  count_of_run_attempts_while_revoked.SetPolicyTableType(pt_type);
+  app_registration_language_gui.SetPolicyTableType(pt_type);
+  app_registration_language_vui.SetPolicyTableType(pt_type);
 }
 
 // UsageAndErrorCounts methods
@@ -869,16 +1445,68 @@ UsageAndErrorCounts::UsageAndErrorCounts() : CompositeType(kUninitialized) {}
 UsageAndErrorCounts::~UsageAndErrorCounts() {}
 UsageAndErrorCounts::UsageAndErrorCounts(const Json::Value *value__)
     : CompositeType(InitHelper(value__, &Json::Value::isObject)),
+      count_of_iap_buffer_full(
+          impl::ValueMember(value__, "count_of_iap_buffer_full")),
+      count_sync_out_of_memory(
+          impl::ValueMember(value__, "count_sync_out_of_memory")),
+      count_of_sync_reboots(
+          impl::ValueMember(value__, "count_of_sync_reboots")),
       app_level(impl::ValueMember(value__, "app_level")) {}
+UsageAndErrorCounts::UsageAndErrorCounts(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "count_of_iap_buffer_full") {
+      impl::ReadJsonField(reader__, &count_of_iap_buffer_full);
+    } else if (name__ == "count_sync_out_of_memory") {
+      impl::ReadJsonField(reader__, &count_sync_out_of_memory);
+    } else if (name__ == "count_of_sync_reboots") {
+      impl::ReadJsonField(reader__, &count_of_sync_reboots);
+    } else if (name__ == "app_level") {
+      impl::ReadJsonField(reader__, &app_level);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value UsageAndErrorCounts::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
+  impl::WriteJsonField("count_of_iap_buffer_full", count_of_iap_buffer_full,
+                       &result__);
+  impl::WriteJsonField("count_sync_out_of_memory", count_sync_out_of_memory,
+                       &result__);
+  impl::WriteJsonField("count_of_sync_reboots", count_of_sync_reboots,
+                       &result__);
   impl::WriteJsonField("app_level", app_level, &result__);
   return result__;
 }
+void UsageAndErrorCounts::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("app_level", app_level, writer__);
+  impl::WriteJsonFieldAsCopied("count_of_iap_buffer_full",
+                               count_of_iap_buffer_full, writer__);
+  impl::WriteJsonFieldAsCopied("count_of_sync_reboots", count_of_sync_reboots,
+                               writer__);
+  impl::WriteJsonFieldAsCopied("count_sync_out_of_memory",
+                               count_sync_out_of_memory, writer__);
+  writer__->WriteObjectEnd();
+}
 bool UsageAndErrorCounts::is_valid() const {
   if (struct_empty()) {
     return initialization_state__ == kInitialized && Validate();
   }
+  if (!count_of_iap_buffer_full.is_valid()) {
+    return false;
+  }
+  if (!count_sync_out_of_memory.is_valid()) {
+    return false;
+  }
+  if (!count_of_sync_reboots.is_valid()) {
+    return false;
+  }
   if (!app_level.is_valid()) {
     return false;
   }
@@ -888,6 +1516,15 @@ bool UsageAndErrorCounts::is_initialized() const {
   return (initialization_state__ != kUninitialized) || (!struct_empty());
 }
 bool UsageAndErrorCounts::struct_empty() const {
+  if (count_of_iap_buffer_full.is_initialized()) {
+    return false;
+  }
+  if (count_sync_out_of_memory.is_initialized()) {
+    return false;
+  }
+  if (count_of_sync_reboots.is_initialized()) {
+    return false;
+  }
   if (app_level.is_initialized()) {
     return false;
   }
@@ -903,6 +1540,18 @@ void UsageAndErrorCounts::ReportErrors(rpc::ValidationReport *report__) const {
         ommited_validation_info + PolicyTableTypeToString(GetPolicyTableType());
     report__->set_validation_info(validation_info);
   }
+  if (!count_of_iap_buffer_full.is_valid()) {
+    count_of_iap_buffer_full.ReportErrors(
+        &report__->ReportSubobject("count_of_iap_buffer_full"));
+  }
+  if (!count_sync_out_of_memory.is_valid()) {
+    count_sync_out_of_memory.ReportErrors(
+        &report__->ReportSubobject("count_sync_out_of_memory"));
+  }
+  if (!count_of_sync_reboots.is_valid()) {
+    count_of_sync_reboots.ReportErrors(
+        &report__->ReportSubobject("count_of_sync_reboots"));
+  }
   if (!app_level.is_valid()) {
     app_level.ReportErrors(&report__->ReportSubobject("app_level"));
   }
@@ -910,6 +1559,9 @@ void UsageAndErrorCounts::ReportErrors(rpc::ValidationReport *report__) const {
 
 void UsageAndErrorCounts::SetPolicyTableType(PolicyTableType pt_type) {
   CompositeType::SetPolicyTableType(pt_type);
+  count_of_iap_buffer_full.SetPolicyTableType(pt_type);
+  count_sync_out_of_memory.SetPolicyTableType(pt_type);
+  count_of_sync_reboots.SetPolicyTableType(pt_type);
   app_level.SetPolicyTableType(pt_type);
 }
 
@@ -918,10 +1570,20 @@ DeviceParams::DeviceParams() : CompositeType(kUninitialized) {}
 DeviceParams::~DeviceParams() {}
 DeviceParams::DeviceParams(const Json::Value *value__)
     : CompositeType(InitHelper(value__, &Json::Value::isObject)) {}
+DeviceParams::DeviceParams(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (reader__) {
+    reader__->SkipValue();
+  }
+}
 Json::Value DeviceParams::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   return result__;
 }
+void DeviceParams::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  writer__->WriteObjectEnd();
+}
 bool DeviceParams::is_valid() const {
   if (struct_empty()) {
     return initialization_state__ == kInitialized && Validate();
@@ -961,6 +1623,32 @@ PolicyTable::PolicyTable(const Json::Value *value__)
       usage_and_error_counts(
           impl::ValueMember(value__, "usage_and_error_counts")),
       device_data(impl::ValueMember(value__, "device_data")) {}
+PolicyTable::PolicyTable(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "app_policies") {
+      impl::ReadJsonField(reader__, &app_policies_section);
+    } else if (name__ == "functional_groupings") {
+      impl::ReadJsonField(reader__, &functional_groupings);
+    } else if (name__ == "consumer_friendly_messages") {
+      impl::ReadJsonField(reader__, &consumer_friendly_messages);
+    } else if (name__ == "module_config") {
+      impl::ReadJsonField(reader__, &module_config);
+    } else if (name__ == "module_meta") {
+      impl::ReadJsonField(reader__, &module_meta);
+    } else if (name__ == "usage_and_error_counts") {
+      impl::ReadJsonField(reader__, &usage_and_error_counts);
+    } else if (name__ == "device_data") {
+      impl::ReadJsonField(reader__, &device_data);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value PolicyTable::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   impl::WriteJsonField("app_policies", app_policies_section, &result__);
@@ -974,6 +1662,19 @@ Json::Value PolicyTable::ToJsonValue() const {
   impl::WriteJsonField("device_data", device_data, &result__);
   return result__;
 }
+void PolicyTable::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("app_policies", app_policies_section, writer__);
+  impl::WriteJsonField("consumer_friendly_messages", consumer_friendly_messages,
+                       writer__);
+  impl::WriteJsonField("device_data", device_data, writer__);
+  impl::WriteJsonField("functional_groupings", functional_groupings, writer__);
+  impl::WriteJsonField("module_config", module_config, writer__);
+  impl::WriteJsonField("module_meta", module_meta, writer__);
+  impl::WriteJsonFieldAsCopied("usage_and_error_counts", usage_and_error_counts,
+                               writer__);
+  writer__->WriteObjectEnd();
+}
 bool PolicyTable::is_valid() const {
   if (!app_policies_section.is_valid()) {
     return false;
@@ -1088,11 +1789,30 @@ Table::~Table() {}
 Table::Table(const Json::Value *value__)
     : CompositeType(InitHelper(value__, &Json::Value::isObject)),
       policy_table(impl::ValueMember(value__, "policy_table")) {}
+Table::Table(JsonStreamReader *reader__)
+    : CompositeType(InitHelper(reader__, &JsonStreamReader::NextIsObject)) {
+  if (!impl::TakeObjectStart(reader__)) {
+    return;
+  }
+  std::string name__;
+  while (reader__->NextMember(&name__)) {
+    if (name__ == "policy_table") {
+      impl::ReadJsonField(reader__, &policy_table);
+    } else {
+      reader__->SkipValue();
+    }
+  }
+}
 Json::Value Table::ToJsonValue() const {
   Json::Value result__(Json::objectValue);
   impl::WriteJsonField("policy_table", policy_table, &result__);
   return result__;
 }
+void Table::ToJsonWriter(JsonStreamWriter *writer__) const {
+  writer__->WriteObjectStart();
+  impl::WriteJsonField("policy_table", policy_table, writer__);
+  writer__->WriteObjectEnd();
+}
 bool Table::is_valid() const {
   if (!policy_table.is_valid()) {
     return false;
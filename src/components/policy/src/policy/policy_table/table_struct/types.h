@@ -45,6 +45,8 @@ typedef Map<MessageString, 0, 500> Languages;
 
 typedef Map<MessageLanguages, 0, 255> Messages;
 
+typedef Integer<int64_t, 0, 4294967296ll> UsageCounter;
+
 typedef Map<AppLevel, 0, 255> AppLevels;
 
 typedef Map<Stringifyable<Nullable<ApplicationParams>>, 1, 1000>
@@ -65,7 +67,9 @@ public:
   PolicyBase(Priority priority);
   virtual ~PolicyBase();
   explicit PolicyBase(const Json::Value *value__);
+  explicit PolicyBase(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -82,6 +86,7 @@ public:
   DevicePolicy(Priority priority);
   ~DevicePolicy();
   explicit DevicePolicy(const Json::Value *value__);
+  explicit DevicePolicy(JsonStreamReader *reader__);
 };
 
 struct ApplicationParams : PolicyBase {
@@ -99,7 +104,9 @@ public:
   ApplicationParams(const Strings &groups, Priority priority);
   ~ApplicationParams();
   explicit ApplicationParams(const Json::Value *value__);
+  explicit ApplicationParams(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -121,7 +128,9 @@ public:
                              const DevicePolicy &device);
   ~ApplicationPoliciesSection();
   explicit ApplicationPoliciesSection(const Json::Value *value__);
+  explicit ApplicationPoliciesSection(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -142,7 +151,9 @@ public:
   explicit RpcParameters(const HmiLevels &hmi_levels);
   ~RpcParameters();
   explicit RpcParameters(const Json::Value *value__);
+  explicit RpcParameters(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -163,7 +174,9 @@ public:
   explicit Rpcs(const Rpc &rpcs);
   ~Rpcs();
   explicit Rpcs(const Json::Value *value__);
+  explicit Rpcs(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -199,8 +212,10 @@ public:
                    notifications_per_minute_by_priority);
   ~ModuleConfig();
   explicit ModuleConfig(const Json::Value *value__);
+  explicit ModuleConfig(JsonStreamReader *reader__);
   void SafeCopyFrom(const ModuleConfig &from);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -223,7 +238,9 @@ public:
   MessageString();
   ~MessageString();
   explicit MessageString(const Json::Value *value__);
+  explicit MessageString(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -243,7 +260,9 @@ public:
   explicit MessageLanguages(const Languages &languages);
   ~MessageLanguages();
   explicit MessageLanguages(const Json::Value *value__);
+  explicit MessageLanguages(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -264,7 +283,9 @@ public:
   explicit ConsumerFriendlyMessages(const std::string &version);
   ~ConsumerFriendlyMessages();
   explicit ConsumerFriendlyMessages(const Json::Value *value__);
+  explicit ConsumerFriendlyMessages(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -281,7 +302,9 @@ public:
   ModuleMeta();
   ~ModuleMeta();
   explicit ModuleMeta(const Json::Value *value__);
+  explicit ModuleMeta(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -293,15 +316,33 @@ private:
 
 struct AppLevel : CompositeType {
 public:
+  Optional<UsageCounter> minutes_in_hmi_full;
+  Optional<UsageCounter> minutes_in_hmi_limited;
+  Optional<UsageCounter> minutes_in_hmi_background;
+  Optional<UsageCounter> minutes_in_hmi_none;
+  Optional<UsageCounter> count_of_user_selections;
+  Optional<UsageCounter> count_of_rejections_sync_out_of_memory;
+  Optional<UsageCounter> count_of_rejections_nickname_mismatch;
+  Optional<UsageCounter> count_of_rejections_duplicate_name;
+  Optional<UsageCounter> count_of_rejected_rpc_calls;
+  Optional<UsageCounter> count_of_rpcs_sent_in_hmi_none;
+  Optional<UsageCounter> count_of_removals_for_bad_behavior;
+  Optional<UsageCounter> count_of_run_attempts_while_revoked;
+  Optional<String<1, 25>> app_registration_language_gui;
+  Optional<String<1, 25>> app_registration_language_vui;
+
 public:
   AppLevel();
   ~AppLevel();
   explicit AppLevel(const Json::Value *value__);
+  explicit AppLevel(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
   void ReportErrors(rpc::ValidationReport *report__) const;
+  virtual void SetPolicyTableType(PolicyTableType pt_type);
 
 private:
   bool Validate() const;
@@ -309,13 +350,18 @@ private:
 
 struct UsageAndErrorCounts : CompositeType {
 public:
+  Optional<UsageCounter> count_of_iap_buffer_full;
+  Optional<UsageCounter> count_sync_out_of_memory;
+  Optional<UsageCounter> count_of_sync_reboots;
   Optional<AppLevels> app_level;
 
 public:
   UsageAndErrorCounts();
   ~UsageAndErrorCounts();
   explicit UsageAndErrorCounts(const Json::Value *value__);
+  explicit UsageAndErrorCounts(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -332,7 +378,9 @@ public:
   DeviceParams();
   ~DeviceParams();
   explicit DeviceParams(const Json::Value *value__);
+  explicit DeviceParams(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -360,7 +408,9 @@ public:
               const ModuleConfig &module_config);
   ~PolicyTable();
   explicit PolicyTable(const Json::Value *value__);
+  explicit PolicyTable(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
@@ -380,7 +430,9 @@ public:
   explicit Table(const PolicyTable &policy_table);
   ~Table();
   explicit Table(const Json::Value *value__);
+  explicit Table(JsonStreamReader *reader__);
   Json::Value ToJsonValue() const;
+  void ToJsonWriter(JsonStreamWriter *writer__) const;
   bool is_valid() const;
   bool is_initialized() const;
   bool struct_empty() const;
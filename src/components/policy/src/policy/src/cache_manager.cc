@@ -38,12 +38,14 @@
 #include <cmath>
 
 #include "utils/file_system.h"
-#include "json/reader.h"
-#include "json/features.h"
+#include "utils/memory_barrier.h"
 #include "json/writer.h"
+#include "rpc_base/json_stream_reader.h"
 #include "utils/logger.h"
 
+#include "policy/policy_helper.h"
 #include "policy/sql_pt_representation.h"
+#include "policy/preloaded_pt_image.h"
 
 namespace policy_table = rpc::policy_table_interface_base;
 
@@ -51,6 +53,148 @@ namespace policy {
 
 CREATE_LOGGERPTR_GLOBAL(logger_, "CacheManager")
 
+namespace {
+const int32_t kStatisticsFlushPeriodMs = 60000;
+const uint32_t kSecondsInMinute = 60u;
+
+template <typename T>
+bool IsEqual(const T &first, const T &second) {
+  return first.ToJsonValue() == second.ToJsonValue();
+}
+
+// Functional groupings are the biggest part of update, so they are compared
+// field by field instead of building of json values
+template <typename T, size_t minsize, size_t maxsize>
+bool IsEqual(const rpc::Array<rpc::Enum<T>, minsize, maxsize> &first,
+             const rpc::Array<rpc::Enum<T>, minsize, maxsize> &second) {
+  if (first.size() != second.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < first.size(); ++i) {
+    if (static_cast<T>(first[i]) != static_cast<T>(second[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsEqual(const policy_table::RpcParameters &first,
+             const policy_table::RpcParameters &second) {
+  if (!IsEqual(first.hmi_levels, second.hmi_levels) ||
+      first.parameters.is_initialized() !=
+          second.parameters.is_initialized()) {
+    return false;
+  }
+  return !first.parameters.is_initialized() ||
+         IsEqual(*first.parameters, *second.parameters);
+}
+
+bool IsEqual(const policy_table::Rpcs &first,
+             const policy_table::Rpcs &second) {
+  if (first.user_consent_prompt.is_initialized() !=
+          second.user_consent_prompt.is_initialized() ||
+      first.rpcs.is_null() != second.rpcs.is_null() ||
+      first.rpcs.size() != second.rpcs.size()) {
+    return false;
+  }
+  if (first.user_consent_prompt.is_initialized()) {
+    const std::string &first_prompt = *first.user_consent_prompt;
+    const std::string &second_prompt = *second.user_consent_prompt;
+    if (first_prompt != second_prompt) {
+      return false;
+    }
+  }
+  policy_table::Rpc::const_iterator first_rpc = first.rpcs.begin();
+  policy_table::Rpc::const_iterator second_rpc = second.rpcs.begin();
+  for (; first.rpcs.end() != first_rpc; ++first_rpc, ++second_rpc) {
+    if (first_rpc->first != second_rpc->first ||
+        !IsEqual(first_rpc->second, second_rpc->second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Policies, which are applied for the application from update: the reference
+// to the default section is replaced with the content of this section
+const policy_table::ApplicationPolicies::mapped_type *GetUpdatedAppPolicy(
+    const policy_table::ApplicationPolicies &update_apps,
+    const policy_table::ApplicationPolicies::value_type &app) {
+  if (app.second.is_null() || policy::kDefaultId != app.second.get_string()) {
+    return &app.second;
+  }
+  policy_table::ApplicationPolicies::const_iterator default_app =
+      update_apps.find(policy::kDefaultId);
+  return update_apps.end() == default_app ? NULL : &default_app->second;
+}
+
+void MergeChanges(const policy::PolicyTableChanges &from,
+                  policy::PolicyTableChanges *to) {
+  to->updated_groups.insert(from.updated_groups.begin(),
+                            from.updated_groups.end());
+  to->removed_groups.insert(from.removed_groups.begin(),
+                            from.removed_groups.end());
+  to->updated_apps.insert(from.updated_apps.begin(), from.updated_apps.end());
+  to->is_device_changed = to->is_device_changed || from.is_device_changed;
+  to->is_module_config_changed =
+      to->is_module_config_changed || from.is_module_config_changed;
+  to->is_messages_changed =
+      to->is_messages_changed || from.is_messages_changed;
+}
+
+void AddToCounter(int64_t value,
+                  rpc::Optional<policy_table::UsageCounter> *counter) {
+  if (value) {
+    // Counter which is not set yet holds its minimum, i.e. zero
+    **counter = static_cast<int64_t>(**counter) + value;
+  }
+}
+
+void AddStatistics(const usage_statistics::Statistics &statistics,
+                   policy_table::UsageAndErrorCounts *counts) {
+  using namespace usage_statistics;
+  const uint32_t *globals = statistics.global_counters;
+  AddToCounter(globals[IAP_BUFFER_FULL], &counts->count_of_iap_buffer_full);
+  AddToCounter(globals[SYNC_OUT_OF_MEMORY], &counts->count_sync_out_of_memory);
+  AddToCounter(globals[SYNC_REBOOTS], &counts->count_of_sync_reboots);
+
+  AppStatisticsMap::const_iterator it = statistics.apps.begin();
+  for (; statistics.apps.end() != it; ++it) {
+    const AppStatistics &app = it->second;
+    policy_table::AppLevel &level = (*counts->app_level)[it->first];
+    level.mark_initialized();
+    AddToCounter(app.stopwatches[SECONDS_HMI_FULL], &level.minutes_in_hmi_full);
+    AddToCounter(app.stopwatches[SECONDS_HMI_LIMITED],
+                 &level.minutes_in_hmi_limited);
+    AddToCounter(app.stopwatches[SECONDS_HMI_BACKGROUND],
+                 &level.minutes_in_hmi_background);
+    AddToCounter(app.stopwatches[SECONDS_HMI_NONE], &level.minutes_in_hmi_none);
+    AddToCounter(app.counters[USER_SELECTIONS],
+                 &level.count_of_user_selections);
+    AddToCounter(app.counters[REJECTIONS_SYNC_OUT_OF_MEMORY],
+                 &level.count_of_rejections_sync_out_of_memory);
+    AddToCounter(app.counters[REJECTIONS_NICKNAME_MISMATCH],
+                 &level.count_of_rejections_nickname_mismatch);
+    AddToCounter(app.counters[REJECTIONS_DUPLICATE_NAME],
+                 &level.count_of_rejections_duplicate_name);
+    AddToCounter(app.counters[REJECTED_RPC_CALLS],
+                 &level.count_of_rejected_rpc_calls);
+    AddToCounter(app.counters[RPCS_IN_HMI_NONE],
+                 &level.count_of_rpcs_sent_in_hmi_none);
+    AddToCounter(app.counters[REMOVALS_MISBEHAVED],
+                 &level.count_of_removals_for_bad_behavior);
+    AddToCounter(app.counters[RUN_ATTEMPTS_WHILE_REVOKED],
+                 &level.count_of_run_attempts_while_revoked);
+    if (!app.infos[LANGUAGE_GUI].empty()) {
+      *level.app_registration_language_gui = app.infos[LANGUAGE_GUI];
+    }
+    if (!app.infos[LANGUAGE_VUI].empty()) {
+      *level.app_registration_language_vui = app.infos[LANGUAGE_VUI];
+    }
+  }
+}
+}  // namespace
+
 #define CACHE_MANAGER_CHECK(return_value)                                      \
   {                                                                            \
     if (!pt_) {                                                                \
@@ -78,8 +222,10 @@ private:
 };
 
 CacheManager::CacheManager()
-    : CacheManagerInterface(), backup_(new SQLPTRepresentation()),
-      update_required(false) {
+    : CacheManagerInterface(),
+      backup_(new SQLPTRepresentation()), update_required(false),
+      is_full_backup_pending_(false), is_preloaded_pt_stored_(true),
+      is_snapshot_type_set_(false) {
 
   LOG4CXX_AUTO_TRACE(logger_);
   backuper_ = new BackgroundBackuper(this);
@@ -102,14 +248,14 @@ bool CacheManager::CanAppKeepContext(const std::string &app_id) {
 }
 
 uint16_t CacheManager::HeartBeatTimeout(const std::string &app_id) const {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(0);
   uint16_t result = 0;
-  if (AppExists(app_id)) {
-    if (pt_->policy_table.app_policies_section.apps[app_id]
-            .heart_beat_timeout_ms.is_initialized()) {
-      result = *(pt_->policy_table.app_policies_section.apps[app_id]
-                     .heart_beat_timeout_ms);
-    }
+  const policy_table::ApplicationPolicies &apps =
+      pt->policy_table.app_policies_section.apps;
+  policy_table::ApplicationPolicies::const_iterator app = apps.find(app_id);
+  if (apps.end() != app && app->second.heart_beat_timeout_ms.is_initialized()) {
+    result = *(app->second.heart_beat_timeout_ms);
   }
   return result;
 }
@@ -144,7 +290,7 @@ bool CacheManager::GetUserPermissionsForDevice(const std::string &device_id,
 
 void CacheManager::GetAllAppGroups(const std::string &app_id,
                                    FunctionalGroupIDs &all_group_ids) {
-
+  const TableReader pt(this);
   LOG4CXX_AUTO_TRACE(logger_);
   CACHE_MANAGER_CHECK_VOID();
   if (kDeviceId == app_id) {
@@ -153,9 +299,9 @@ void CacheManager::GetAllAppGroups(const std::string &app_id,
   }
 
   policy_table::ApplicationPolicies::const_iterator app_params_iter =
-      pt_->policy_table.app_policies_section.apps.find(app_id);
+      pt->policy_table.app_policies_section.apps.find(app_id);
 
-  if (pt_->policy_table.app_policies_section.apps.end() != app_params_iter) {
+  if (pt->policy_table.app_policies_section.apps.end() != app_params_iter) {
     policy_table::Strings::const_iterator iter =
         (*app_params_iter).second.groups.begin();
     policy_table::Strings::const_iterator iter_end =
@@ -200,56 +346,152 @@ bool CacheManager::ApplyUpdate(const policy_table::Table &update_pt) {
   LOG4CXX_AUTO_TRACE(logger_);
   CACHE_MANAGER_CHECK(false);
   sync_primitives::AutoLock auto_lock(cache_lock_);
-  pt_->policy_table.functional_groupings =
+  PolicyTableChanges changes;
+  CollectChanges(update_pt, &changes);
+  DetachTable();
+  LOG4CXX_DEBUG(logger_, "Update changes "
+                             << changes.updated_groups.size() << " groups, "
+                             << changes.updated_apps.size() << " apps, removes "
+                             << changes.removed_groups.size() << " groups");
+
+  policy_table::FunctionalGroupings &groups =
+      pt_->policy_table.functional_groupings;
+  const policy_table::FunctionalGroupings &update_groups =
       update_pt.policy_table.functional_groupings;
+  std::set<std::string>::const_iterator it = changes.removed_groups.begin();
+  for (; changes.removed_groups.end() != it; ++it) {
+    groups.erase(*it);
+  }
+  for (it = changes.updated_groups.begin();
+       changes.updated_groups.end() != it; ++it) {
+    groups[*it] = update_groups.find(*it)->second;
+  }
 
-  policy_table::ApplicationPolicies::const_iterator iter =
-      update_pt.policy_table.app_policies_section.apps.begin();
-  policy_table::ApplicationPolicies::const_iterator iter_end =
-      update_pt.policy_table.app_policies_section.apps.end();
-
-  for (; iter != iter_end; ++iter) {
-    if (iter->second.is_null()) {
-      pt_->policy_table.app_policies_section.apps[iter->first].set_to_null();
-      pt_->policy_table.app_policies_section.apps[iter->first].set_to_string(
-          "");
-    } else if (policy::kDefaultId == (iter->second).get_string()) {
-      policy_table::ApplicationPolicies::const_iterator iter_default =
-          update_pt.policy_table.app_policies_section.apps.find(kDefaultId);
-      if (update_pt.policy_table.app_policies_section.apps.end() ==
-          iter_default) {
-        LOG4CXX_ERROR(logger_, "The default section was not found in PTU");
-        continue;
-      }
-      pt_->policy_table.app_policies_section.apps[iter->first] =
-          iter_default->second;
+  policy_table::ApplicationPolicies &apps =
+      pt_->policy_table.app_policies_section.apps;
+  const policy_table::ApplicationPolicies &update_apps =
+      update_pt.policy_table.app_policies_section.apps;
+  for (it = changes.updated_apps.begin(); changes.updated_apps.end() != it;
+       ++it) {
+    const policy_table::ApplicationPolicies::mapped_type *params =
+        GetUpdatedAppPolicy(update_apps, *update_apps.find(*it));
+    if (params->is_null()) {
+      apps[*it].set_to_null();
+      apps[*it].set_to_string("");
     } else {
-      pt_->policy_table.app_policies_section.apps[iter->first] = iter->second;
+      apps[*it] = *params;
     }
   }
 
-  pt_->policy_table.app_policies_section.device =
-      update_pt.policy_table.app_policies_section.device;
+  if (changes.is_device_changed) {
+    pt_->policy_table.app_policies_section.device =
+        update_pt.policy_table.app_policies_section.device;
+  }
 
-  pt_->policy_table.module_config.SafeCopyFrom(
-      update_pt.policy_table.module_config);
+  if (changes.is_module_config_changed) {
+    pt_->policy_table.module_config.SafeCopyFrom(
+        update_pt.policy_table.module_config);
+  }
 
-  pt_->policy_table.consumer_friendly_messages.assign_if_valid(
-      update_pt.policy_table.consumer_friendly_messages);
+  if (changes.is_messages_changed) {
+    pt_->policy_table.consumer_friendly_messages.assign_if_valid(
+        update_pt.policy_table.consumer_friendly_messages);
+  }
 
-  ResetCalculatedPermissions();
-  Backup();
+  if (!changes.updated_groups.empty() || !changes.removed_groups.empty()) {
+    ResetCalculatedPermissions();
+  } else {
+    ResetCalculatedPermissions(changes.updated_apps);
+  }
+
+  // Rewriting of the whole table is cheaper than row by row replacement
+  // of the most part of it
+  const size_t changed_groups_count =
+      changes.updated_groups.size() + changes.removed_groups.size();
+  if (changed_groups_count > groups.size() / 2 ||
+      changes.updated_apps.size() > apps.size() / 2) {
+    Backup();
+  } else {
+    BackupChanges(changes);
+  }
   return true;
 }
 
+void CacheManager::CollectChanges(const policy_table::Table &update_pt,
+                                  PolicyTableChanges *changes) const {
+  const policy_table::FunctionalGroupings &groups =
+      pt_->policy_table.functional_groupings;
+  const policy_table::FunctionalGroupings &update_groups =
+      update_pt.policy_table.functional_groupings;
+
+  policy_table::FunctionalGroupings::const_iterator group =
+      update_groups.begin();
+  for (; update_groups.end() != group; ++group) {
+    policy_table::FunctionalGroupings::const_iterator current =
+        groups.find(group->first);
+    if (groups.end() == current || !IsEqual(current->second, group->second)) {
+      changes->updated_groups.insert(group->first);
+    }
+  }
+  for (group = groups.begin(); groups.end() != group; ++group) {
+    if (update_groups.end() == update_groups.find(group->first)) {
+      changes->removed_groups.insert(group->first);
+    }
+  }
+
+  const policy_table::ApplicationPolicies &apps =
+      pt_->policy_table.app_policies_section.apps;
+  const policy_table::ApplicationPolicies &update_apps =
+      update_pt.policy_table.app_policies_section.apps;
+  policy_table::ApplicationPolicies::const_iterator app = update_apps.begin();
+  for (; update_apps.end() != app; ++app) {
+    const policy_table::ApplicationPolicies::mapped_type *params =
+        GetUpdatedAppPolicy(update_apps, *app);
+    if (!params) {
+      LOG4CXX_ERROR(logger_, "The default section was not found in PTU");
+      continue;
+    }
+    policy_table::ApplicationPolicies::const_iterator current =
+        apps.find(app->first);
+    if (apps.end() == current || !IsEqual(current->second, *params)) {
+      changes->updated_apps.insert(app->first);
+    }
+  }
+
+  changes->is_device_changed =
+      !IsEqual(pt_->policy_table.app_policies_section.device,
+               update_pt.policy_table.app_policies_section.device);
+
+  policy_table::ModuleConfig module_config = pt_->policy_table.module_config;
+  module_config.SafeCopyFrom(update_pt.policy_table.module_config);
+  changes->is_module_config_changed =
+      !IsEqual(pt_->policy_table.module_config, module_config);
+
+  // Messages are identified by their version, so the whole list is compared
+  // only by version instead of thousands of strings
+  const rpc::Optional<policy_table::ConsumerFriendlyMessages> &messages =
+      pt_->policy_table.consumer_friendly_messages;
+  const rpc::Optional<policy_table::ConsumerFriendlyMessages> &
+      update_messages = update_pt.policy_table.consumer_friendly_messages;
+  if (update_messages.is_initialized()) {
+    const std::string &version = messages->version;
+    const std::string &update_version = update_messages->version;
+    changes->is_messages_changed =
+        !messages.is_initialized() || version != update_version ||
+        messages->messages.is_initialized() !=
+            update_messages->messages.is_initialized();
+  }
+}
+
 void CacheManager::GetHMIAppTypeAfterUpdate(
     std::map<std::string, StringArray> &app_hmi_types) {
+  const TableReader pt(this);
   LOG4CXX_AUTO_TRACE(logger_);
   CACHE_MANAGER_CHECK_VOID();
   policy_table::ApplicationPolicies::const_iterator policy_iter_begin =
-      pt_->policy_table.app_policies_section.apps.begin();
+      pt->policy_table.app_policies_section.apps.begin();
   policy_table::ApplicationPolicies::const_iterator policy_iter_end =
-      pt_->policy_table.app_policies_section.apps.end();
+      pt->policy_table.app_policies_section.apps.end();
   std::vector<std::string> transform_app_hmi_types;
   for (; policy_iter_begin != policy_iter_end; ++policy_iter_begin) {
     const policy_table::ApplicationParams &app_params =
@@ -267,6 +509,20 @@ void CacheManager::GetHMIAppTypeAfterUpdate(
 }
 
 void CacheManager::Backup() {
+  {
+    sync_primitives::AutoLock lock(pending_changes_lock_);
+    is_full_backup_pending_ = true;
+  }
+  sync_primitives::AutoLock lock(backuper_locker_);
+  DCHECK(backuper_);
+  backuper_->DoBackup();
+}
+
+void CacheManager::BackupChanges(const PolicyTableChanges &changes) {
+  {
+    sync_primitives::AutoLock lock(pending_changes_lock_);
+    MergeChanges(changes, &pending_changes_);
+  }
   sync_primitives::AutoLock lock(backuper_locker_);
   DCHECK(backuper_);
   backuper_->DoBackup();
@@ -334,12 +590,12 @@ bool CacheManager::ReactOnUserDevConsentForApp(const std::string &app_id,
 
 void CacheManager::GetGroupNameByHashID(const int32_t group_id,
                                         std::string &group_name) {
-
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK_VOID();
   policy_table::FunctionalGroupings::const_iterator fg_iter =
-      pt_->policy_table.functional_groupings.begin();
+      pt->policy_table.functional_groupings.begin();
   policy_table::FunctionalGroupings::const_iterator fg_iter_end =
-      pt_->policy_table.functional_groupings.end();
+      pt->policy_table.functional_groupings.end();
 
   for (; fg_iter != fg_iter_end; ++fg_iter) {
     const int32_t id = GenerateHash((*fg_iter).first);
@@ -362,15 +618,17 @@ bool CacheManager::UpdateRequired() const { return update_required; }
 
 void CacheManager::SaveUpdateRequired(bool status) {
   update_required = status;
-  Backup();
+  // Flag is stored along with any backup, so nothing else has to be stored
+  BackupChanges(PolicyTableChanges());
 }
 
 bool CacheManager::IsApplicationRevoked(const std::string &app_id) const {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(false);
   bool is_revoked = false;
-  if (pt_->policy_table.app_policies_section.apps.end() !=
-      pt_->policy_table.app_policies_section.apps.find(app_id)) {
-    is_revoked = pt_->policy_table.app_policies_section.apps[app_id].is_null();
+  if (pt->policy_table.app_policies_section.apps.end() !=
+      pt->policy_table.app_policies_section.apps.find(app_id)) {
+    is_revoked = pt->policy_table.app_policies_section.apps[app_id].is_null();
   }
 
   return is_revoked;
@@ -380,28 +638,29 @@ void CacheManager::CheckPermissions(const PTString &app_id,
                                     const PTString &hmi_level,
                                     const PTString &rpc,
                                     CheckPermissionResult &result) {
+  const TableReader pt(this);
   LOG4CXX_AUTO_TRACE(logger_);
   CACHE_MANAGER_CHECK_VOID();
 
-  if (pt_->policy_table.app_policies_section.apps.end() ==
-      pt_->policy_table.app_policies_section.apps.find(app_id)) {
+  if (pt->policy_table.app_policies_section.apps.end() ==
+      pt->policy_table.app_policies_section.apps.find(app_id)) {
     LOG4CXX_ERROR(logger_, "Application id " << app_id
                                              << " was not found in policy DB.");
     return;
   }
 
   policy_table::Strings::const_iterator app_groups_iter =
-      pt_->policy_table.app_policies_section.apps[app_id].groups.begin();
+      pt->policy_table.app_policies_section.apps[app_id].groups.begin();
 
   policy_table::Strings::const_iterator app_groups_iter_end =
-      pt_->policy_table.app_policies_section.apps[app_id].groups.end();
+      pt->policy_table.app_policies_section.apps[app_id].groups.end();
 
   policy_table::FunctionalGroupings::const_iterator concrete_group;
 
   for (; app_groups_iter != app_groups_iter_end; ++app_groups_iter) {
     concrete_group =
-        pt_->policy_table.functional_groupings.find(*app_groups_iter);
-    if (pt_->policy_table.functional_groupings.end() != concrete_group) {
+        pt->policy_table.functional_groupings.find(*app_groups_iter);
+    if (pt->policy_table.functional_groupings.end() != concrete_group) {
       const policy_table::Rpcs &rpcs = concrete_group->second;
 
       policy_table::Rpc::const_iterator rpc_iter = rpcs.rpcs.find(rpc);
@@ -434,15 +693,17 @@ void CacheManager::CheckPermissions(const PTString &app_id,
 }
 
 bool CacheManager::IsPTPreloaded() {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(false);
-  return *pt_->policy_table.module_config.preloaded_pt;
+  return *pt->policy_table.module_config.preloaded_pt;
 }
 
 int CacheManager::IgnitionCyclesBeforeExchange() {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(0);
   const uint8_t limit = std::max(
       static_cast<int>(
-          pt_->policy_table.module_config.exchange_after_x_ignition_cycles),
+          pt->policy_table.module_config.exchange_after_x_ignition_cycles),
       0);
   LOG4CXX_DEBUG(logger_, "IgnitionCyclesBeforeExchange limit:" << limit);
   uint8_t current = 0;
@@ -451,10 +712,11 @@ int CacheManager::IgnitionCyclesBeforeExchange() {
 }
 
 int CacheManager::KilometersBeforeExchange(int current) {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(0);
   const int limit =
       std::max(static_cast<int>(
-                   pt_->policy_table.module_config.exchange_after_x_kilometers),
+                   pt->policy_table.module_config.exchange_after_x_kilometers),
                0);
   LOG4CXX_DEBUG(logger_, "KilometersBeforeExchange limit:" << limit);
   int last = 0;
@@ -472,9 +734,10 @@ bool CacheManager::SetCountersPassedForSuccessfulUpdate(int kilometers,
 }
 
 int CacheManager::DaysBeforeExchange(int current) {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(0);
   const uint8_t limit = std::max(
-      static_cast<int>(pt_->policy_table.module_config.exchange_after_x_days),
+      static_cast<int>(pt->policy_table.module_config.exchange_after_x_days),
       0);
   LOG4CXX_DEBUG(logger_, "DaysBeforeExchange limit:" << limit);
   uint8_t last = 0;
@@ -495,19 +758,21 @@ void CacheManager::ResetIgnitionCycles() {
 }
 
 int CacheManager::TimeoutResponse() {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(0);
-  return pt_->policy_table.module_config.timeout_after_x_seconds;
+  return pt->policy_table.module_config.timeout_after_x_seconds;
 }
 
 bool CacheManager::SecondsBetweenRetries(std::vector<int> &seconds) {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(false);
   rpc::policy_table_interface_base::SecondsBetweenRetries::iterator iter =
-      pt_->policy_table.module_config.seconds_between_retries.begin();
+      pt->policy_table.module_config.seconds_between_retries.begin();
   rpc::policy_table_interface_base::SecondsBetweenRetries::iterator iter_end =
-      pt_->policy_table.module_config.seconds_between_retries.end();
+      pt->policy_table.module_config.seconds_between_retries.end();
 
   const std::size_t size =
-      pt_->policy_table.module_config.seconds_between_retries.size();
+      pt->policy_table.module_config.seconds_between_retries.size();
   seconds.reserve(size);
   for (; iter != iter_end; ++iter) {
     seconds.push_back(*iter);
@@ -523,17 +788,20 @@ VehicleData CacheManager::GetVehicleData() {
 std::vector<UserFriendlyMessage>
 CacheManager::GetUserFriendlyMsg(const std::vector<std::string> &msg_codes,
                                  const std::string &language) {
-
+  const TableReader reader(this);
   LOG4CXX_AUTO_TRACE(logger_);
   std::vector<UserFriendlyMessage> result;
   CACHE_MANAGER_CHECK(result);
 
+  const policy_table::Messages &messages =
+      *reader->policy_table.consumer_friendly_messages->messages;
   std::vector<std::string>::const_iterator it = msg_codes.begin();
   std::vector<std::string>::const_iterator it_end = msg_codes.end();
   for (; it != it_end; ++it) {
-
-    policy_table::MessageLanguages msg_languages =
-        (*pt_->policy_table.consumer_friendly_messages->messages)[*it];
+    policy_table::Messages::const_iterator message = messages.find(*it);
+    const policy_table::MessageLanguages msg_languages =
+        messages.end() != message ? message->second
+                                  : policy_table::MessageLanguages();
 
     policy_table::MessageString message_string;
 
@@ -575,6 +843,7 @@ CacheManager::GetUserFriendlyMsg(const std::vector<std::string> &msg_codes,
 
 void CacheManager::GetServiceUrls(const std::string &service_type,
                                   EndpointUrls &end_points) {
+  const TableReader pt(this);
   LOG4CXX_AUTO_TRACE(logger_);
   CACHE_MANAGER_CHECK_VOID();
   std::string search_value;
@@ -585,9 +854,9 @@ void CacheManager::GetServiceUrls(const std::string &service_type,
   LOG4CXX_DEBUG(logger_, "Search service value is: " << search_value);
 
   policy_table::ServiceEndpoints::const_iterator iter =
-      pt_->policy_table.module_config.endpoints.find(search_value);
+      pt->policy_table.module_config.endpoints.find(search_value);
 
-  if (pt_->policy_table.module_config.endpoints.end() != iter) {
+  if (pt->policy_table.module_config.endpoints.end() != iter) {
     policy_table::URLList::const_iterator url_list_iter =
         (*iter).second.begin();
     policy_table::URLList::const_iterator url_list_iter_end =
@@ -604,6 +873,20 @@ void CacheManager::GetServiceUrls(const std::string &service_type,
 }
 
 std::string CacheManager::GetLockScreenIconUrl() const {
+  sync_primitives::AutoLock lock(cache_lock_);
+  if (!is_preloaded_pt_stored_) {
+    // Database is not filled from preloaded PT yet
+    policy_table::ServiceEndpoints::const_iterator service =
+        pt_->policy_table.module_config.endpoints.find("lock_screen_icon_url");
+    if (pt_->policy_table.module_config.endpoints.end() != service) {
+      policy_table::URLList::const_iterator urls =
+          service->second.find(kDefaultId);
+      if (service->second.end() != urls && !urls->second.empty()) {
+        return urls->second.front();
+      }
+    }
+    return std::string("");
+  }
   if (backup_) {
     return backup_->GetLockScreenIconUrl();
   }
@@ -611,11 +894,12 @@ std::string CacheManager::GetLockScreenIconUrl() const {
 }
 
 int CacheManager::GetNotificationsNumber(const std::string &priority) {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(0);
   typedef rpc::policy_table_interface_base::NumberOfNotificationsPerMinute NNPM;
 
   const NNPM &nnpm =
-      pt_->policy_table.module_config.notifications_per_minute_by_priority;
+      pt->policy_table.module_config.notifications_per_minute_by_priority;
 
   NNPM::const_iterator priority_iter = nnpm.find(priority);
 
@@ -626,15 +910,16 @@ int CacheManager::GetNotificationsNumber(const std::string &priority) {
 
 bool CacheManager::GetPriority(const std::string &policy_app_id,
                                std::string &priority) {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(false);
   if (kDeviceId == policy_app_id) {
     priority = EnumToJsonString(
-        pt_->policy_table.app_policies_section.device.priority);
+        pt->policy_table.app_policies_section.device.priority);
     return true;
   }
 
   const policy_table::ApplicationPolicies &policies =
-      pt_->policy_table.app_policies_section.apps;
+      pt->policy_table.app_policies_section.apps;
 
   policy_table::ApplicationPolicies::const_iterator policy_iter =
       policies.find(policy_app_id);
@@ -646,71 +931,154 @@ bool CacheManager::GetPriority(const std::string &policy_app_id,
   return app_id_exists;
 }
 
-void CacheManager::CheckSnapshotInitialization() {
-  CACHE_MANAGER_CHECK_VOID();
-  if (!snapshot_) {
-    LOG4CXX_ERROR(logger_, "Snapshot pointer is not initialized");
+void CacheManager::DetachTable() {
+  // Parts added by the change have no snapshot type
+  is_snapshot_type_set_ = false;
+  // References are taken only under cache_lock_, so a table which is not
+  // shared now stays so till the change is done
+  if (pt_.unique()) {
+    // Reads of the last reader which dropped its reference are completed
+    // before the table is changed
+    utils::memory_barrier();
     return;
   }
+  LOG4CXX_DEBUG(logger_, "Policy table is shared, it is copied");
+  pt_ = new policy_table::Table(*pt_);
+}
 
-  *(snapshot_->policy_table.module_config.preloaded_pt) = false;
+CacheManager::TableReader::TableReader(const CacheManager *cache_manager) {
+  sync_primitives::AutoLock lock(cache_manager->cache_lock_);
+  table_ = cache_manager->pt_;
 }
 
 void CacheManager::PersistData() {
   LOG4CXX_AUTO_TRACE(logger_);
   if (backup_.valid()) {
     if (pt_.valid()) {
+      pending_changes_lock_.Acquire();
+      const bool is_full_backup = is_full_backup_pending_;
+      const PolicyTableChanges changes = pending_changes_;
+      is_full_backup_pending_ = false;
+      pending_changes_ = PolicyTableChanges();
+      pending_changes_lock_.Release();
+
+      if (!is_full_backup) {
+        PersistChanges(changes);
+        return;
+      }
 
+      // Table is shared instead of copying, cache copies it on change
       cache_lock_.Acquire();
-      policy_table::Table copy_pt(*pt_);
+      const utils::SharedPtr<policy_table::Table> stored_pt = pt_;
+      const bool is_preloaded_pt_stored = is_preloaded_pt_stored_;
       cache_lock_.Release();
 
-      backup_->Save(copy_pt);
+      const bool is_saved = backup_->Save(*stored_pt);
       backup_->SaveUpdateRequired(update_required);
 
+      const policy_table::ApplicationPolicies &apps =
+          stored_pt->policy_table.app_policies_section.apps;
       policy_table::ApplicationPolicies::const_iterator app_policy_iter =
-          copy_pt.policy_table.app_policies_section.apps.begin();
-      policy_table::ApplicationPolicies::const_iterator app_policy_iter_end =
-          copy_pt.policy_table.app_policies_section.apps.end();
-
-      bool is_revoked = false;
-      bool is_default_policy;
-      bool is_predata_policy;
-
-      for (; app_policy_iter != app_policy_iter_end; ++app_policy_iter) {
-
-        const std::string app_id = (*app_policy_iter).first;
-
-        if (copy_pt.policy_table.app_policies_section.apps.end() !=
-            copy_pt.policy_table.app_policies_section.apps.find(app_id)) {
-          is_revoked =
-              copy_pt.policy_table.app_policies_section.apps[app_id].is_null();
-        }
-
-        is_default_policy =
-            copy_pt.policy_table.app_policies_section.apps.end() !=
-                copy_pt.policy_table.app_policies_section.apps.find(app_id) &&
-            policy::kDefaultId ==
-                copy_pt.policy_table.app_policies_section.apps[app_id]
-                    .get_string();
-
+          apps.begin();
+      for (; apps.end() != app_policy_iter; ++app_policy_iter) {
+        const std::string &app_id = app_policy_iter->first;
+        const bool is_revoked = app_policy_iter->second.is_null();
+        const bool is_default_policy =
+            policy::kDefaultId == app_policy_iter->second.get_string();
         // TODO(AOleynik): Remove this field from DB
-        is_predata_policy =
-            copy_pt.policy_table.app_policies_section.apps.end() !=
-                copy_pt.policy_table.app_policies_section.apps.find(app_id) &&
-            policy::kPreDataConsentId ==
-                copy_pt.policy_table.app_policies_section.apps[app_id]
-                    .get_string();
+        const bool is_predata_policy =
+            policy::kPreDataConsentId == app_policy_iter->second.get_string();
 
         backup_->SaveApplicationCustomData(
             app_id, is_revoked, is_default_policy, is_predata_policy);
-        is_revoked = false;
       }
 
       // In case of extended policy the meta info should be backuped as well.
       backup_->WriteDb();
+
+      if (!is_preloaded_pt_stored && is_saved) {
+        LOG4CXX_INFO(logger_, "Preloaded PT is stored in database");
+        backup_->SaveIsFirstRun(false);
+        sync_primitives::AutoLock lock(cache_lock_);
+        is_preloaded_pt_stored_ = true;
+      }
+    }
+  }
+}
+
+void CacheManager::PersistChanges(const PolicyTableChanges &changes) {
+  LOG4CXX_AUTO_TRACE(logger_);
+  // Changes could be merged from several updates, so the stored state is
+  // taken from the cache
+  PolicyTableChanges stored_changes;
+  stored_changes.updated_apps = changes.updated_apps;
+  stored_changes.is_device_changed = changes.is_device_changed;
+  stored_changes.is_module_config_changed = changes.is_module_config_changed;
+  stored_changes.is_messages_changed = changes.is_messages_changed;
+
+  policy_table::Table changed_pt;
+  policy_table::FunctionalGroupings &groups =
+      changed_pt.policy_table.functional_groupings;
+  policy_table::ApplicationPolicies &apps =
+      changed_pt.policy_table.app_policies_section.apps;
+
+  std::set<std::string> group_names(changes.updated_groups);
+  group_names.insert(changes.removed_groups.begin(),
+                     changes.removed_groups.end());
+
+  cache_lock_.Acquire();
+  const policy_table::FunctionalGroupings &current_groups =
+      pt_->policy_table.functional_groupings;
+  std::set<std::string>::const_iterator it = group_names.begin();
+  for (; group_names.end() != it; ++it) {
+    policy_table::FunctionalGroupings::const_iterator group =
+        current_groups.find(*it);
+    if (current_groups.end() == group) {
+      stored_changes.removed_groups.insert(*it);
+    } else {
+      groups.insert(*group);
+      stored_changes.updated_groups.insert(*it);
     }
   }
+
+  const policy_table::ApplicationPolicies &current_apps =
+      pt_->policy_table.app_policies_section.apps;
+  for (it = changes.updated_apps.begin(); changes.updated_apps.end() != it;
+       ++it) {
+    policy_table::ApplicationPolicies::const_iterator app =
+        current_apps.find(*it);
+    if (current_apps.end() != app) {
+      apps.insert(*app);
+    }
+  }
+
+  if (changes.is_device_changed) {
+    changed_pt.policy_table.app_policies_section.device =
+        pt_->policy_table.app_policies_section.device;
+  }
+  if (changes.is_module_config_changed) {
+    changed_pt.policy_table.module_config = pt_->policy_table.module_config;
+  }
+  if (changes.is_messages_changed) {
+    changed_pt.policy_table.consumer_friendly_messages =
+        pt_->policy_table.consumer_friendly_messages;
+  }
+  cache_lock_.Release();
+
+  if (!backup_->SaveChanges(changed_pt, stored_changes)) {
+    LOG4CXX_ERROR(logger_, "Changes of policy table are not stored");
+  }
+  backup_->SaveUpdateRequired(update_required);
+
+  policy_table::ApplicationPolicies::const_iterator app = apps.begin();
+  for (; apps.end() != app; ++app) {
+    backup_->SaveApplicationCustomData(
+        app->first, app->second.is_null(),
+        policy::kDefaultId == app->second.get_string(),
+        policy::kPreDataConsentId == app->second.get_string());
+  }
+
+  backup_->WriteDb();
 }
 
 void CacheManager::ResetCalculatedPermissions() {
@@ -719,6 +1087,20 @@ void CacheManager::ResetCalculatedPermissions() {
   calculated_permissions_.clear();
 }
 
+void CacheManager::ResetCalculatedPermissions(
+    const std::set<std::string> &app_ids) {
+  LOG4CXX_TRACE(logger_, "ResetCalculatedPermissions for "
+                             << app_ids.size() << " apps");
+  sync_primitives::AutoLock lock(calculated_permissions_lock_);
+  CalculatedPermissions::iterator it = calculated_permissions_.begin();
+  for (; calculated_permissions_.end() != it; ++it) {
+    std::set<std::string>::const_iterator app_id = app_ids.begin();
+    for (; app_ids.end() != app_id; ++app_id) {
+      it->second.erase(*app_id);
+    }
+  }
+}
+
 void CacheManager::AddCalculatedPermissions(const std::string &device_id,
                                             const std::string &policy_app_id,
                                             const Permissions &permissions) {
@@ -775,39 +1157,70 @@ bool policy::CacheManager::IsNumberService(const std::string &input,
   return true;
 }
 
-utils::SharedPtr<policy_table::Table> CacheManager::GenerateSnapshot() {
-  CACHE_MANAGER_CHECK(snapshot_);
-  sync_primitives::AutoLock lock(cache_lock_);
+utils::SharedPtr<policy_table::Table> CacheManager::GenerateUpdateSnapshot(
+    const policy_table::Table &update_pt) {
+  CACHE_MANAGER_CHECK(utils::SharedPtr<policy_table::Table>());
+  utils::SharedPtr<policy_table::Table> snapshot = new policy_table::Table();
+  policy_table::ApplicationPolicies &snapshot_apps =
+      snapshot->policy_table.app_policies_section.apps;
+  policy_table::FunctionalGroupings &snapshot_groups =
+      snapshot->policy_table.functional_groupings;
 
-  snapshot_ = new policy_table::Table();
+  const policy_table::ApplicationPolicies &update_apps =
+      update_pt.policy_table.app_policies_section.apps;
+  std::set<std::string> group_names;
 
-  //Copy all members of policy table except messages in consumer friendly messages
-  snapshot_->policy_table.app_policies_section = pt_->policy_table.app_policies_section;
-  snapshot_->policy_table.functional_groupings = pt_->policy_table.functional_groupings;
-  snapshot_->policy_table.consumer_friendly_messages->version = pt_->policy_table.consumer_friendly_messages->version;
-  snapshot_->policy_table.consumer_friendly_messages->mark_initialized();
-  snapshot_->policy_table.module_config = pt_->policy_table.module_config;
-  snapshot_->policy_table.module_meta = pt_->policy_table.module_meta;
-  snapshot_->policy_table.usage_and_error_counts = pt_->policy_table.usage_and_error_counts;
-  snapshot_->policy_table.device_data = pt_->policy_table.device_data;
+  sync_primitives::AutoLock lock(cache_lock_);
+  const policy_table::ApplicationPolicies &apps =
+      pt_->policy_table.app_policies_section.apps;
+  policy_table::ApplicationPolicies::const_iterator app = update_apps.begin();
+  for (; update_apps.end() != app; ++app) {
+    group_names.insert(app->second.groups.begin(), app->second.groups.end());
+    policy_table::ApplicationPolicies::const_iterator current =
+        apps.find(app->first);
+    if (apps.end() != current) {
+      snapshot_apps.insert(*current);
+      group_names.insert(current->second.groups.begin(),
+                         current->second.groups.end());
+    }
+  }
+
+  const policy_table::FunctionalGroupings &groups =
+      pt_->policy_table.functional_groupings;
+  std::set<std::string>::const_iterator name = group_names.begin();
+  for (; group_names.end() != name; ++name) {
+    policy_table::FunctionalGroupings::const_iterator group =
+        groups.find(*name);
+    if (groups.end() != group) {
+      snapshot_groups.insert(*group);
+    }
+  }
+  return snapshot;
+}
 
-  //Set policy table type to Snapshot
-  snapshot_->SetPolicyTableType(rpc::policy_table_interface_base::PolicyTableType::PT_SNAPSHOT);
-  
-  CheckSnapshotInitialization();
-  return snapshot_;
+utils::SharedPtr<policy_table::Table> CacheManager::GenerateSnapshot() {
+  CACHE_MANAGER_CHECK(utils::SharedPtr<policy_table::Table>());
+  sync_primitives::AutoLock lock(cache_lock_);
+  if (!is_snapshot_type_set_) {
+    // Readers don't read the type, and snapshots which could be validated
+    // already share the table only after the type is set
+    pt_->SetPolicyTableType(policy_table::PT_SNAPSHOT);
+    is_snapshot_type_set_ = true;
+  }
+  // Table is shared, it is copied before the next change
+  return pt_;
 }
 
 bool CacheManager::GetInitialAppData(const std::string &app_id,
                                      StringArray &nicknames,
                                      StringArray &app_hmi_types) {
-
+  const TableReader pt(this);
   LOG4CXX_AUTO_TRACE(logger_);
   CACHE_MANAGER_CHECK(false);
   policy_table::ApplicationPolicies::const_iterator policy_iter =
-      pt_->policy_table.app_policies_section.apps.find(app_id);
+      pt->policy_table.app_policies_section.apps.find(app_id);
 
-  if (pt_->policy_table.app_policies_section.apps.end() != policy_iter) {
+  if (pt->policy_table.app_policies_section.apps.end() != policy_iter) {
     const policy_table::ApplicationParams &app_params = (*policy_iter).second;
 
     std::copy(app_params.nicknames->begin(), app_params.nicknames->end(),
@@ -821,11 +1234,11 @@ bool CacheManager::GetInitialAppData(const std::string &app_id,
 
 bool CacheManager::GetFunctionalGroupings(
     policy_table::FunctionalGroupings &groups) {
-
+  const TableReader pt(this);
   LOG4CXX_AUTO_TRACE(logger_);
   CACHE_MANAGER_CHECK(false);
   const policy_table::FunctionalGroupings &f_groupings =
-      pt_->policy_table.functional_groupings;
+      pt->policy_table.functional_groupings;
 
   groups.insert(f_groupings.begin(), f_groupings.end());
   return true;
@@ -845,6 +1258,8 @@ bool CacheManager::SetMetaInfo(const std::string &ccpu_version,
                                const std::string &language) {
   CACHE_MANAGER_CHECK(false);
 
+  sync_primitives::AutoLock lock(cache_lock_);
+  DetachTable();
   // We have to set preloaded flag as false in policy table on any response
   // of GetSystemInfo (SDLAQ-CRS-2365)
   *pt_->policy_table.module_config.preloaded_pt = false;
@@ -866,12 +1281,13 @@ bool CacheManager::SetSystemLanguage(const std::string &language) {
 }
 
 bool CacheManager::GetFunctionalGroupNames(FunctionalGroupNames &names) {
+  const TableReader pt(this);
   LOG4CXX_AUTO_TRACE(logger_);
   CACHE_MANAGER_CHECK(false);
   rpc::policy_table_interface_base::FunctionalGroupings::iterator iter =
-      pt_->policy_table.functional_groupings.begin();
+      pt->policy_table.functional_groupings.begin();
   rpc::policy_table_interface_base::FunctionalGroupings::iterator iter_end =
-      pt_->policy_table.functional_groupings.end();
+      pt->policy_table.functional_groupings.end();
 
   for (; iter != iter_end; ++iter) {
     const int32_t id = GenerateHash((*iter).first);
@@ -891,27 +1307,65 @@ bool CacheManager::CleanupUnpairedDevices() {
 }
 
 void CacheManager::Increment(usage_statistics::GlobalCounterId type) {
-  CACHE_MANAGER_CHECK_VOID();
-  Backup();
+  statistics_.Increment(type);
 }
 
 void CacheManager::Increment(const std::string &app_id,
                              usage_statistics::AppCounterId type) {
-  CACHE_MANAGER_CHECK_VOID();
-  Backup();
+  statistics_.Increment(app_id, type);
 }
 
 void CacheManager::Set(const std::string &app_id,
                        usage_statistics::AppInfoId type,
                        const std::string &value) {
-  CACHE_MANAGER_CHECK_VOID();
-  Backup();
+  statistics_.Set(app_id, type, value);
 }
 
 void CacheManager::Add(const std::string &app_id,
                        usage_statistics::AppStopwatchId type, int seconds) {
-  CACHE_MANAGER_CHECK_VOID();
-  Backup();
+  statistics_.Add(app_id, type, seconds);
+}
+
+void CacheManager::FlushStatistics() {
+  using namespace usage_statistics;
+  if (!backup_.valid()) {
+    return;
+  }
+  Statistics collected;
+  statistics_.Collect(&collected);
+  if (collected.empty()) {
+    return;
+  }
+  LOG4CXX_AUTO_TRACE(logger_);
+
+  // Database keeps whole minutes, the rest waits for the next flush
+  Statistics statistics(collected);
+  Statistics rest;
+  AppStatisticsMap::iterator it = statistics.apps.begin();
+  for (; statistics.apps.end() != it; ++it) {
+    uint32_t *stopwatches = it->second.stopwatches;
+    for (size_t i = 0; i < kAppStopwatchesCount; ++i) {
+      if (stopwatches[i] % kSecondsInMinute) {
+        rest.apps[it->first].stopwatches[i] =
+            stopwatches[i] % kSecondsInMinute;
+      }
+      stopwatches[i] /= kSecondsInMinute;
+    }
+  }
+
+  if (backup_->SaveStatistics(statistics)) {
+    statistics_.Restore(rest);
+    // Cached table is the source of snapshots and full backups,
+    // so it gets the same values as the database
+    sync_primitives::AutoLock lock(cache_lock_);
+    if (pt_.valid()) {
+      DetachTable();
+      AddStatistics(statistics, &*pt_->policy_table.usage_and_error_counts);
+    }
+  } else {
+    LOG4CXX_WARN(logger_, "Statistics are not saved, will retry later");
+    statistics_.Restore(collected);
+  }
 }
 
 long CacheManager::ConvertSecondsToMinute(int seconds) {
@@ -921,31 +1375,37 @@ long CacheManager::ConvertSecondsToMinute(int seconds) {
 
 bool CacheManager::SetDefaultPolicy(const std::string &app_id) {
   CACHE_MANAGER_CHECK(false);
+  sync_primitives::AutoLock lock(cache_lock_);
+  DetachTable();
   policy_table::ApplicationPolicies::const_iterator iter =
       pt_->policy_table.app_policies_section.apps.find(kDefaultId);
   if (pt_->policy_table.app_policies_section.apps.end() != iter) {
     pt_->policy_table.app_policies_section.apps[app_id] =
         pt_->policy_table.app_policies_section.apps[kDefaultId];
 
-    SetIsDefault(app_id);
+    pt_->policy_table.app_policies_section.apps[app_id].set_to_string(
+        kDefaultId);
   }
   Backup();
   return true;
 }
 
 bool CacheManager::IsDefaultPolicy(const std::string &app_id) {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(false);
   const bool result =
-      pt_->policy_table.app_policies_section.apps.end() !=
-          pt_->policy_table.app_policies_section.apps.find(app_id) &&
+      pt->policy_table.app_policies_section.apps.end() !=
+          pt->policy_table.app_policies_section.apps.find(app_id) &&
       policy::kDefaultId ==
-          pt_->policy_table.app_policies_section.apps[app_id].get_string();
+          pt->policy_table.app_policies_section.apps[app_id].get_string();
 
   return result;
 }
 
 bool CacheManager::SetIsDefault(const std::string &app_id) {
   CACHE_MANAGER_CHECK(false);
+  sync_primitives::AutoLock lock(cache_lock_);
+  DetachTable();
   policy_table::ApplicationPolicies::const_iterator iter =
       pt_->policy_table.app_policies_section.apps.find(app_id);
   if (pt_->policy_table.app_policies_section.apps.end() != iter) {
@@ -957,6 +1417,8 @@ bool CacheManager::SetIsDefault(const std::string &app_id) {
 
 bool CacheManager::SetPredataPolicy(const std::string &app_id) {
   CACHE_MANAGER_CHECK(false);
+  sync_primitives::AutoLock lock(cache_lock_);
+  DetachTable();
   policy_table::ApplicationPolicies::const_iterator iter =
       pt_->policy_table.app_policies_section.apps.find(kPreDataConsentId);
 
@@ -978,29 +1440,38 @@ bool CacheManager::SetPredataPolicy(const std::string &app_id) {
 }
 
 bool CacheManager::IsPredataPolicy(const std::string &app_id) {
+  const TableReader pt(this);
   // TODO(AOleynik): Maybe change for comparison with pre_DataConsent
   // permissions or check string value from get_string()
-  policy_table::ApplicationParams &pre_data_app =
-      pt_->policy_table.app_policies_section.apps[kPreDataConsentId];
-  policy_table::ApplicationParams &specific_app =
-      pt_->policy_table.app_policies_section.apps[app_id];
+  // Table could be shared with snapshot, so it is only searched here
+  policy_table::ApplicationPolicies &apps =
+      pt->policy_table.app_policies_section.apps;
+  policy_table::ApplicationPolicies::iterator pre_data_app =
+      apps.find(kPreDataConsentId);
+  policy_table::ApplicationPolicies::iterator specific_app =
+      apps.find(app_id);
+  if (apps.end() == pre_data_app || apps.end() == specific_app) {
+    return false;
+  }
 
   policy_table::Strings res;
-  std::set_intersection(pre_data_app.groups.begin(), pre_data_app.groups.end(),
-                        specific_app.groups.begin(), specific_app.groups.end(),
+  std::set_intersection(pre_data_app->second.groups.begin(),
+                        pre_data_app->second.groups.end(),
+                        specific_app->second.groups.begin(),
+                        specific_app->second.groups.end(),
                         std::back_inserter(res));
 
   bool is_marked_as_predata =
-      kPreDataConsentId ==
-      pt_->policy_table.app_policies_section.apps[app_id].get_string();
+      kPreDataConsentId == specific_app->second.get_string();
 
   return !res.empty() && is_marked_as_predata;
 }
 
 bool CacheManager::SetUnpairedDevice(const std::string &device_id,
                                      bool unpaired) {
-  const bool result = pt_->policy_table.device_data->end() !=
-                      pt_->policy_table.device_data->find(device_id);
+  const TableReader pt(this);
+  const bool result = pt->policy_table.device_data->end() !=
+                      pt->policy_table.device_data->find(device_id);
   if (!result) {
     LOG4CXX_DEBUG(logger_, "Couldn't set unpaired flag for device id "
                                << device_id << " , since it wasn't found.");
@@ -1026,13 +1497,14 @@ bool CacheManager::SetVINValue(const std::string &value) {
 }
 
 bool CacheManager::IsApplicationRepresented(const std::string &app_id) const {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(false);
   if (kDeviceId == app_id) {
     return true;
   }
   policy_table::ApplicationPolicies::const_iterator iter =
-      pt_->policy_table.app_policies_section.apps.find(app_id);
-  return pt_->policy_table.app_policies_section.apps.end() != iter;
+      pt->policy_table.app_policies_section.apps.find(app_id);
+  return pt->policy_table.app_policies_section.apps.end() != iter;
 }
 
 bool CacheManager::Init(const std::string &file_name) {
@@ -1048,17 +1520,14 @@ bool CacheManager::Init(const std::string &file_name) {
   } break;
   case InitResult::SUCCESS: {
     LOG4CXX_INFO(logger_, "Policy Table was inited successfully");
-    result = LoadFromFile(file_name);
-
-    utils::SharedPtr<policy_table::Table> snapshot = GenerateSnapshot();
-    result &= snapshot->is_valid();
-    LOG4CXX_DEBUG(logger_, "Check if snapshot is valid: " << std::boolalpha
-                                                          << result);
+    result = LoadFromImage(file_name) || LoadFromFile(file_name);
     if (!result) {
-      rpc::ValidationReport report("policy_table");
-      snapshot->ReportErrors(&report);
+      break;
     }
 
+    result = IsSnapshotValid(*GenerateSnapshot());
+    LOG4CXX_DEBUG(logger_, "Check if snapshot is valid: " << std::boolalpha
+                                                          << result);
   } break;
   default: {
     result = false;
@@ -1074,6 +1543,7 @@ void CacheManager::FillDeviceSpecificData() {}
 bool CacheManager::LoadFromBackup() {
   sync_primitives::AutoLock lock(cache_lock_);
   pt_ = backup_->GenerateSnapshot();
+  is_snapshot_type_set_ = false;
   update_required = backup_->UpdateRequired();
 
   FillDeviceSpecificData();
@@ -1089,35 +1559,81 @@ bool CacheManager::LoadFromFile(const std::string &file_name) {
     return false;
   }
 
-  Json::Value value;
-  Json::Reader reader(Json::Features::strictMode());
-  std::string json(json_string.begin(), json_string.end());
-  if (!reader.parse(json.c_str(), value)) {
-    LOG4CXX_FATAL(logger_, "Preloaded PT is corrupted: "
-                               << reader.getFormattedErrorMessages());
+  if (json_string.empty()) {
+    LOG4CXX_FATAL(logger_, "Preloaded PT is empty.");
     return false;
   }
 
+  // Table is read right from the file data without building Json::Value
   LOG4CXX_TRACE(logger_, "Start create PT");
-  sync_primitives::AutoLock locker(cache_lock_);
-  backup_->Clear();
+  const char* json = reinterpret_cast<const char*>(&json_string[0]);
+  rpc::JsonStreamReader reader(json, json + json_string.size());
+  utils::SharedPtr<policy_table::Table> table =
+      new policy_table::Table(&reader);
+  if (reader.has_failed()) {
+    LOG4CXX_FATAL(logger_, "Preloaded PT is corrupted: " << reader.error()
+                               << " at " << reader.error_offset());
+    return false;
+  }
 
-  pt_ = new policy_table::Table(&value);
-  if (pt_->is_valid()) {
-    if (backup_->Save(*pt_)) {
-      backup_->WriteDb();
-      return true;
-    } else {
-      LOG4CXX_FATAL(logger_, "Failed to save PT");
-      return false;
-    }
-  } else {
+  if (!table->is_valid()) {
     rpc::ValidationReport report("policy_table");
-    pt_->ReportErrors(&report);
+    table->ReportErrors(&report);
     LOG4CXX_FATAL(logger_, "Parsed table is not valid "
                                << rpc::PrettyFormat(report));
     return false;
   }
+
+  return SetPreloadedTable(table);
+}
+
+bool CacheManager::LoadFromImage(const std::string &file_name) {
+  LOG4CXX_AUTO_TRACE(logger_);
+  const std::string image_file = PreloadedPTImage::ImageFileName(file_name);
+  if (!file_system::FileExists(image_file)) {
+    LOG4CXX_DEBUG(logger_, "No preloaded PT image " << image_file);
+    return false;
+  }
+  BinaryMessage json_string;
+  if (!file_system::ReadBinaryFile(file_name, json_string)) {
+    LOG4CXX_WARN(logger_, "Failed to read pt file.");
+    return false;
+  }
+  PreloadedPTImage image;
+  if (!image.Open(image_file) || !image.IsMadeFrom(json_string)) {
+    LOG4CXX_WARN(logger_, "Preloaded PT image " << image_file
+                              << " is damaged or outdated, it is not used");
+    return false;
+  }
+  utils::SharedPtr<policy_table::Table> table = image.ReadTable();
+  if (!table) {
+    LOG4CXX_WARN(logger_, "Preloaded PT image " << image_file
+                              << " is corrupted, it is not used");
+    return false;
+  }
+
+  // Table was validated when the image was made
+  LOG4CXX_INFO(logger_, "PT is loaded from image " << image_file);
+  return SetPreloadedTable(table);
+}
+
+bool CacheManager::SetPreloadedTable(
+    const utils::SharedPtr<policy_table::Table> &table) {
+  // Database is filled by backup thread, so start is not delayed by it.
+  // Till then it is marked to be loaded from preloaded PT again.
+  {
+    sync_primitives::AutoLock locker(cache_lock_);
+    if (!backup_->Clear()) {
+      LOG4CXX_FATAL(logger_, "Failed to clear PT");
+      return false;
+    }
+    backup_->SaveIsFirstRun(true);
+    pt_ = table;
+    is_preloaded_pt_stored_ = false;
+    is_snapshot_type_set_ = false;
+  }
+  Backup();
+  return true;
 }
 
 bool CacheManager::ResetPT(const std::string &file_name) {
@@ -1127,13 +1643,14 @@ bool CacheManager::ResetPT(const std::string &file_name) {
 }
 
 bool CacheManager::AppExists(const std::string &app_id) const {
+  const TableReader pt(this);
   CACHE_MANAGER_CHECK(false);
   if (kDeviceId == app_id) {
     return true;
   }
   policy_table::ApplicationPolicies::iterator policy_iter =
-      pt_->policy_table.app_policies_section.apps.find(app_id);
-  return pt_->policy_table.app_policies_section.apps.end() != policy_iter;
+      pt->policy_table.app_policies_section.apps.find(app_id);
+  return pt->policy_table.app_policies_section.apps.end() != policy_iter;
 }
 
 int32_t CacheManager::GenerateHash(const std::string &str_to_hash) {
@@ -1155,11 +1672,12 @@ int32_t CacheManager::GenerateHash(const std::string &str_to_hash) {
 void CacheManager::GetAppRequestTypes(
     const std::string &policy_app_id,
     std::vector<std::string> &request_types) const {
+  const TableReader pt(this);
   LOG4CXX_AUTO_TRACE(logger_);
   CACHE_MANAGER_CHECK_VOID();
   policy_table::ApplicationPolicies::iterator policy_iter =
-      pt_->policy_table.app_policies_section.apps.find(policy_app_id);
-  if (pt_->policy_table.app_policies_section.apps.end() == policy_iter) {
+      pt->policy_table.app_policies_section.apps.find(policy_app_id);
+  if (pt->policy_table.app_policies_section.apps.end() == policy_iter) {
     LOG4CXX_DEBUG(logger_, "Can't find request types for app_id "
                                << policy_app_id);
     return;
@@ -1206,8 +1724,15 @@ void CacheManager::BackgroundBackuper::threadMain() {
       continue;
     }
     LOG4CXX_DEBUG(logger_, "Wait for a next backup");
-    backup_notifier_.Wait(need_backup_lock_);
+    backup_notifier_.WaitFor(lock, kStatisticsFlushPeriodMs);
+    need_backup_lock_.Release();
+    cache_manager_->FlushStatistics();
+    need_backup_lock_.Acquire();
   }
+  // Statistics gathered till shutdown (e.g. ignition off) must not be lost
+  need_backup_lock_.Release();
+  cache_manager_->FlushStatistics();
+  need_backup_lock_.Acquire();
 }
 
 void CacheManager::BackgroundBackuper::exitThreadMain() {
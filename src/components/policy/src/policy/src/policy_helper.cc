@@ -36,6 +36,8 @@
 #include "utils/logger.h"
 #include "policy/policy_helper.h"
 #include "policy/policy_manager_impl.h"
+#include "rpc_base/json_stream_writer.h"
+#include "rpc_base/rpc_base_json_inl.h"
 
 namespace policy {
 
@@ -793,4 +795,52 @@ bool UnwrapAppPolicies(policy_table::ApplicationPolicies& app_policies) {
   return true;
 }
 
+void WriteSnapshot(const policy_table::Table& table, std::string* output) {
+  const policy_table::PolicyTable& pt = table.policy_table;
+
+  policy_table::ConsumerFriendlyMessages messages;
+  messages.version = pt.consumer_friendly_messages->version;
+  messages.mark_initialized();
+
+  // Snapshot is always sent as not preloaded table
+  policy_table::ModuleConfig module_config = pt.module_config;
+  *module_config.preloaded_pt = false;
+
+  // Members are written sorted by name, as Json::Value keeps them
+  rpc::JsonStreamWriter writer(output);
+  writer.WriteObjectStart();
+  writer.WriteMemberName("policy_table");
+  writer.WriteObjectStart();
+  rpc::impl::WriteJsonField("app_policies", pt.app_policies_section, &writer);
+  rpc::impl::WriteJsonField("consumer_friendly_messages", messages, &writer);
+  rpc::impl::WriteJsonField("device_data", pt.device_data, &writer);
+  rpc::impl::WriteJsonField("functional_groupings", pt.functional_groupings,
+                            &writer);
+  rpc::impl::WriteJsonField("module_config", module_config, &writer);
+  rpc::impl::WriteJsonField("module_meta", pt.module_meta, &writer);
+  rpc::impl::WriteJsonFieldAsCopied("usage_and_error_counts",
+                                    pt.usage_and_error_counts, &writer);
+  writer.WriteObjectEnd();
+  writer.WriteObjectEnd();
+  // Json::FastWriter ends text with new line
+  output->push_back('\n');
+}
+
+bool IsSnapshotValid(const policy_table::Table& table) {
+  const policy_table::PolicyTable& pt = table.policy_table;
+
+  // Messages are left out of snapshot, only their version is checked
+  policy_table::ConsumerFriendlyMessages messages;
+  messages.version = pt.consumer_friendly_messages->version;
+  messages.mark_initialized();
+  messages.SetPolicyTableType(policy_table::PT_SNAPSHOT);
+
+  // Checks of the table and policy_table itself pass for snapshot
+  return pt.app_policies_section.is_valid() &&
+         pt.functional_groupings.is_valid() && messages.is_valid() &&
+         pt.module_config.is_valid() && pt.module_meta.is_valid() &&
+         pt.usage_and_error_counts.is_valid() &&
+         pt.device_data.is_valid();
+}
+
 }
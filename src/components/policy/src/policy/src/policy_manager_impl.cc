@@ -35,8 +35,7 @@
 #include <set>
 #include <queue>
 #include <iterator>
-#include "json/reader.h"
-#include "json/writer.h"
+#include "rpc_base/json_stream_reader.h"
 #include "policy/policy_table.h"
 #include "policy/pt_representation.h"
 #include "policy/policy_helper.h"
@@ -54,6 +53,43 @@ policy::PolicyManager *CreateManager() {
 
 namespace {
 const uint32_t kDefaultRetryTimeoutInSec = 60u;
+
+#ifndef USE_HMI_PTU_DECRYPTION
+/**
+ * @brief Moves reader to the first element of "data" array, which holds
+ * PT Update received from SDL Server
+ * @return false if there is no such element
+ */
+bool TakeFirstDataElement(rpc::JsonStreamReader* reader) {
+  if (!reader->NextIsObject()) {
+    return false;
+  }
+  reader->TakeObjectStart();
+  std::string name;
+  while (reader->NextMember(&name)) {
+    if ("data" == name && reader->NextIsArray()) {
+      reader->TakeArrayStart();
+      return reader->NextElement();
+    }
+    reader->SkipValue();
+  }
+  return false;
+}
+
+/**
+ * @brief Reads the rest of the containers the first "data" element is
+ * nested in, so syntax of the whole message is checked
+ */
+void SkipDataRest(rpc::JsonStreamReader* reader) {
+  while (reader->NextElement()) {
+    reader->SkipValue();
+  }
+  std::string name;
+  while (reader->NextMember(&name)) {
+    reader->SkipValue();
+  }
+}
+#endif  // USE_HMI_PTU_DECRYPTION
 } // namespace
 
 namespace policy {
@@ -77,35 +113,48 @@ void PolicyManagerImpl::set_listener(PolicyListener *listener) {
 
 utils::SharedPtr<policy_table::Table>
 PolicyManagerImpl::Parse(const BinaryMessage &pt_content) {
-  std::string json(pt_content.begin(), pt_content.end());
-  Json::Value value;
-  Json::Reader reader;
-  if (reader.parse(json.c_str(), value)) {
-    return new policy_table::Table(&value);
-  } else {
+  if (pt_content.empty()) {
     return utils::SharedPtr<policy_table::Table>();
   }
+  // Table is read right from the message without building Json::Value
+  const char* json = reinterpret_cast<const char*>(&pt_content[0]);
+  rpc::JsonStreamReader reader(json, json + pt_content.size());
+  utils::SharedPtr<policy_table::Table> table =
+      new policy_table::Table(&reader);
+  if (reader.has_failed()) {
+    LOG4CXX_WARN(logger_, "PT Update is corrupted: " << reader.error()
+                 << " at " << reader.error_offset());
+    return utils::SharedPtr<policy_table::Table>();
+  }
+  return table;
 }
 
 #else
 
 utils::SharedPtr<policy_table::Table>
 PolicyManagerImpl::ParseArray(const BinaryMessage &pt_content) {
-  std::string json(pt_content.begin(), pt_content.end());
-  Json::Value value;
-  Json::Reader reader;
-  if (reader.parse(json.c_str(), value)) {
+  if (pt_content.empty()) {
+    return utils::SharedPtr<policy_table::Table>();
+  }
+  // Table is read right from the message without building Json::Value
+  const char* json = reinterpret_cast<const char*>(&pt_content[0]);
+  rpc::JsonStreamReader reader(json, json + pt_content.size());
+  utils::SharedPtr<policy_table::Table> table;
+  if (TakeFirstDataElement(&reader)) {
     // For PT Update received from SDL Server.
-    if (value["data"].size() != 0) {
-      Json::Value data = value["data"];
-      // First Element in
-      return new policy_table::Table(&data[0]);
-    } else {
-      return new policy_table::Table(&value);
-    }
-  } else {
+    table = new policy_table::Table(&reader);
+    SkipDataRest(&reader);
+  } else if (!reader.has_failed()) {
+    // There is no "data" array, so the whole message is the table
+    reader = rpc::JsonStreamReader(json, json + pt_content.size());
+    table = new policy_table::Table(&reader);
+  }
+  if (reader.has_failed()) {
+    LOG4CXX_WARN(logger_, "PT Update is corrupted: " << reader.error()
+                 << " at " << reader.error_offset());
     return utils::SharedPtr<policy_table::Table>();
   }
+  return table;
 }
 
 #endif
@@ -159,40 +208,41 @@ bool PolicyManagerImpl::LoadPT(const std::string &file,
     timer_retry_sequence_.stop();
   }
 
-  apps_registration_lock_.Acquire();
-
-  // Get current DB data, since it could be updated during awaiting of PTU
-  utils::SharedPtr<policy_table::Table> policy_table_snapshot =
-      cache_->GenerateSnapshot();
-  if (!policy_table_snapshot) {
-    LOG4CXX_ERROR(logger_, "Failed to create snapshot of policy table");
-    return false;
-  }
+  {
+    sync_primitives::AutoLock lock(apps_registration_lock_);
 
-  // Checking of difference between PTU and current policy state
-  // Must to be done before PTU applying since it is possible, that functional
-  // groups, which had been present before are absent in PTU and will be
-  // removed after update. So in case of revoked groups system has to know
-  // names and ids of revoked groups before they will be removed.
-  CheckPermissionsChanges(pt_update, policy_table_snapshot);
+    // Get current DB data, since it could be updated during awaiting of PTU.
+    // Only applications from PTU and their groups are needed for comparison.
+    utils::SharedPtr<policy_table::Table> policy_table_snapshot =
+        cache_->GenerateUpdateSnapshot(*pt_update);
+    if (!policy_table_snapshot) {
+      LOG4CXX_ERROR(logger_, "Failed to create snapshot of policy table");
+      return false;
+    }
 
-  // Replace current data with updated
-  if (!cache_->ApplyUpdate(*pt_update)) {
-    LOG4CXX_WARN(logger_, "Unsuccessful save of updated policy table.");
-    return false;
-  }
+    // Checking of difference between PTU and current policy state
+    // Must to be done before PTU applying since it is possible, that
+    // functional groups, which had been present before are absent in PTU and
+    // will be removed after update. So in case of revoked groups system has
+    // to know names and ids of revoked groups before they will be removed.
+    CheckPermissionsChanges(pt_update, policy_table_snapshot);
+
+    // Replace current data with updated
+    if (!cache_->ApplyUpdate(*pt_update)) {
+      LOG4CXX_WARN(logger_, "Unsuccessful save of updated policy table.");
+      return false;
+    }
 
-  std::map<std::string, StringArray> app_hmi_types;
-  cache_->GetHMIAppTypeAfterUpdate(app_hmi_types);
-  if (!app_hmi_types.empty()) {
-    LOG4CXX_INFO(logger_, "app_hmi_types is full calling OnUpdateHMIAppType");
-    listener_->OnUpdateHMIAppType(app_hmi_types);
-  } else {
-    LOG4CXX_INFO(logger_, "app_hmi_types empty" << pt_content.size());
+    std::map<std::string, StringArray> app_hmi_types;
+    cache_->GetHMIAppTypeAfterUpdate(app_hmi_types);
+    if (!app_hmi_types.empty()) {
+      LOG4CXX_INFO(logger_, "app_hmi_types is full calling OnUpdateHMIAppType");
+      listener_->OnUpdateHMIAppType(app_hmi_types);
+    } else {
+      LOG4CXX_INFO(logger_, "app_hmi_types empty" << pt_content.size());
+    }
   }
 
-  apps_registration_lock_.Release();
-
   // If there was a user request for policy table update, it should be started
   // right after current update is finished
   if (update_status_manager_.IsUpdateRequired()) {
@@ -244,11 +294,15 @@ bool PolicyManagerImpl::RequestPTUpdate() {
     return false;
   }
 
-  IsPTValid(policy_table_snapshot, policy_table::PT_SNAPSHOT);
+  if (!IsSnapshotValid(*policy_table_snapshot)) {
+    LOG4CXX_ERROR(logger_, "Policy table snapshot is not valid.");
+  }
 
-  Json::Value value = policy_table_snapshot->ToJsonValue();
-  Json::FastWriter writer;
-  std::string message_string = writer.write(value);
+  // Snapshot is shared with the cache, so it is written as JSON right away
+  // without copying or changing it
+  std::string message_string;
+  WriteSnapshot(*policy_table_snapshot, &message_string);
+  policy_table_snapshot.reset();
 
   LOG4CXX_DEBUG(logger_, "Snapshot contents is : " << message_string);
 
@@ -775,28 +829,28 @@ void PolicyManagerImpl::PTUpdatedAt(int kilometers, int days_after_epoch) {
 }
 
 void PolicyManagerImpl::Increment(usage_statistics::GlobalCounterId type) {
-  LOG4CXX_INFO(logger_, "Increment without app id");
-  sync_primitives::AutoLock locker(statistics_lock_);
+  LOG4CXX_DEBUG(logger_, "Increment without app id");
+  cache_->Increment(type);
 }
 
 void PolicyManagerImpl::Increment(const std::string &app_id,
                                   usage_statistics::AppCounterId type) {
-  LOG4CXX_INFO(logger_, "Increment " << app_id);
-  sync_primitives::AutoLock locker(statistics_lock_);
+  LOG4CXX_DEBUG(logger_, "Increment " << app_id);
+  cache_->Increment(app_id, type);
 }
 
 void PolicyManagerImpl::Set(const std::string &app_id,
                             usage_statistics::AppInfoId type,
                             const std::string &value) {
-  LOG4CXX_INFO(logger_, "Set " << app_id);
-  sync_primitives::AutoLock locker(statistics_lock_);
+  LOG4CXX_DEBUG(logger_, "Set " << app_id);
+  cache_->Set(app_id, type, value);
 }
 
 void PolicyManagerImpl::Add(const std::string &app_id,
                             usage_statistics::AppStopwatchId type,
                             int32_t timespan_seconds) {
-  LOG4CXX_INFO(logger_, "Add " << app_id);
-  sync_primitives::AutoLock locker(statistics_lock_);
+  LOG4CXX_DEBUG(logger_, "Add " << app_id);
+  cache_->Add(app_id, type, timespan_seconds);
 }
 
 bool PolicyManagerImpl::IsApplicationRevoked(const std::string &app_id) const {
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "policy/preloaded_pt_image.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string.h>
+
+#include "json/writer.h"
+#include "rpc_base/json_stream_reader.h"
+#include "utils/file_system.h"
+
+namespace policy {
+
+namespace {
+
+const char kMagic[] = {'S', 'D', 'L', 'P', 'T', 'I', 'M', 'G'};
+const size_t kMagicSize = sizeof(kMagic);
+
+// Header: magic, format version, source size, source hash, payload size
+// and payload hash. Numbers are little-endian, so image made on the build
+// host is read on the target as is.
+const size_t kVersionOffset = kMagicSize;
+const size_t kSourceSizeOffset = kVersionOffset + sizeof(uint32_t);
+const size_t kSourceHashOffset = kSourceSizeOffset + sizeof(uint32_t);
+const size_t kPayloadSizeOffset = kSourceHashOffset + sizeof(uint32_t);
+const size_t kPayloadHashOffset = kPayloadSizeOffset + sizeof(uint32_t);
+const size_t kHeaderSize = kPayloadHashOffset + sizeof(uint32_t);
+
+const std::string kPreloadedExtension = ".json";
+const std::string kImageExtension = ".img";
+
+// FNV-1a, enough to detect damaged image or changed source file
+uint32_t Hash(const char* data, size_t size) {
+  uint32_t hash = 2166136261U;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+uint32_t Hash(const BinaryMessage& data) {
+  return data.empty() ? Hash(NULL, 0)
+                      : Hash(reinterpret_cast<const char*>(&data[0]),
+                             data.size());
+}
+
+void PutUInt32(uint32_t value, BinaryMessage* data) {
+  for (size_t i = 0; i < sizeof(value); ++i) {
+    data->push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+uint32_t GetUInt32(const char* data) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < sizeof(value); ++i) {
+    value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+  }
+  return value;
+}
+
+}  // namespace
+
+std::string PreloadedPTImage::ImageFileName(
+    const std::string& preloaded_file) {
+  const size_t extension_size = kPreloadedExtension.size();
+  if (preloaded_file.size() > extension_size &&
+      0 == preloaded_file.compare(preloaded_file.size() - extension_size,
+                                  extension_size, kPreloadedExtension)) {
+    return preloaded_file.substr(0, preloaded_file.size() - extension_size) +
+           kImageExtension;
+  }
+  return preloaded_file + kImageExtension;
+}
+
+bool PreloadedPTImage::Write(const policy_table::Table& table,
+                             const BinaryMessage& source,
+                             const std::string& image_file) {
+  const std::string payload = Json::FastWriter().write(table.ToJsonValue());
+
+  BinaryMessage image;
+  image.reserve(kHeaderSize + payload.size());
+  image.insert(image.end(), kMagic, kMagic + kMagicSize);
+  PutUInt32(kFormatVersion, &image);
+  PutUInt32(static_cast<uint32_t>(source.size()), &image);
+  PutUInt32(Hash(source), &image);
+  PutUInt32(static_cast<uint32_t>(payload.size()), &image);
+  PutUInt32(Hash(payload.data(), payload.size()), &image);
+  image.insert(image.end(), payload.begin(), payload.end());
+  return file_system::WriteBinaryFile(image_file, image);
+}
+
+PreloadedPTImage::PreloadedPTImage()
+    : data_(NULL), size_(0), source_size_(0), source_hash_(0) {}
+
+PreloadedPTImage::~PreloadedPTImage() {
+  Close();
+}
+
+bool PreloadedPTImage::Open(const std::string& image_file) {
+  Close();
+  const int fd = open(image_file.c_str(), O_RDONLY);
+  if (-1 == fd) {
+    return false;
+  }
+  struct stat file_info;
+  void* data = MAP_FAILED;
+  if (0 == fstat(fd, &file_info) &&
+      static_cast<size_t>(file_info.st_size) >= kHeaderSize) {
+    data = mmap(NULL, file_info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  // Mapping stays valid after the descriptor is closed
+  close(fd);
+  if (MAP_FAILED == data) {
+    return false;
+  }
+  data_ = static_cast<const char*>(data);
+  size_ = file_info.st_size;
+
+  const size_t payload_size = GetUInt32(data_ + kPayloadSizeOffset);
+  if (0 != memcmp(data_, kMagic, kMagicSize) ||
+      kFormatVersion != GetUInt32(data_ + kVersionOffset) ||
+      kHeaderSize + payload_size != size_ ||
+      GetUInt32(data_ + kPayloadHashOffset) !=
+          Hash(data_ + kHeaderSize, payload_size)) {
+    Close();
+    return false;
+  }
+  source_size_ = GetUInt32(data_ + kSourceSizeOffset);
+  source_hash_ = GetUInt32(data_ + kSourceHashOffset);
+  return true;
+}
+
+bool PreloadedPTImage::IsMadeFrom(const BinaryMessage& source) const {
+  return data_ && source_size_ == source.size() &&
+         source_hash_ == Hash(source);
+}
+
+utils::SharedPtr<policy_table::Table> PreloadedPTImage::ReadTable() const {
+  if (!data_) {
+    return utils::SharedPtr<policy_table::Table>();
+  }
+  rpc::JsonStreamReader reader(data_ + kHeaderSize, data_ + size_);
+  utils::SharedPtr<policy_table::Table> table =
+      new policy_table::Table(&reader);
+  if (reader.has_failed()) {
+    return utils::SharedPtr<policy_table::Table>();
+  }
+  return table;
+}
+
+void PreloadedPTImage::Close() {
+  if (data_) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = NULL;
+  size_ = 0;
+  source_size_ = 0;
+  source_hash_ = 0;
+}
+
+}  //  namespace policy
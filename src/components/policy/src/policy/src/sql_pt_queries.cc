@@ -463,6 +463,9 @@ const std::string kIsFirstRun = "SELECT `is_first_run` FROM `module_config` ";
 const std::string kSetNotFirstRun =
     "UPDATE `module_config` SET `is_first_run`= 0 ";
 
+const std::string kUpdateIsFirstRun =
+    "UPDATE `module_config` SET `is_first_run` = ? ";
+
 const std::string kSelectEndpoint =
     "SELECT `url`, `application_id` FROM `endpoint` WHERE `service` = ? ";
 
@@ -546,6 +549,9 @@ const std::string kInsertAppLevel =
     "`count_of_run_attempts_while_revoked`,`app_registration_language_gui`,"
     "`app_registration_language_vui`) VALUES(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)";
 
+const std::string kInsertAppLevelIfAbsent =
+    "INSERT OR IGNORE INTO `app_level` (`application_id`) VALUES (?)";
+
 const std::string kDeleteSecondsBetweenRetries =
     "DELETE FROM `seconds_between_retry`";
 
@@ -561,6 +567,27 @@ const std::string kDeleteRpc = "DELETE FROM `rpc`";
 
 const std::string kDeleteAppGroup = "DELETE FROM `app_group`";
 
+const std::string kDeleteRpcByFunctionalGroupId =
+    "DELETE FROM `rpc` WHERE `functional_group_id` = ?";
+
+const std::string kDeleteFunctionalGroupById =
+    "DELETE FROM `functional_group` WHERE `id` = ?";
+
+const std::string kDeleteAppGroupByFunctionalGroupId =
+    "DELETE FROM `app_group` WHERE `functional_group_id` = ?";
+
+const std::string kDeleteApplicationById =
+    "DELETE FROM `application` WHERE `id` = ?";
+
+const std::string kDeleteRequestTypeByApplicationId =
+    "DELETE FROM `request_type` WHERE `application_id` = ?";
+
+const std::string kDeleteNicknameByApplicationId =
+    "DELETE FROM `nickname` WHERE `application_id` = ?";
+
+const std::string kDeleteAppTypeByApplicationId =
+    "DELETE FROM `app_type` WHERE `application_id` = ?";
+
 const std::string kSelectModuleConfig =
     "SELECT `preloaded_pt`, `exchange_after_x_ignition_cycles`, "
     " `exchange_after_x_kilometers`, `exchange_after_x_days`, "
@@ -577,7 +604,21 @@ const std::string kSelectNotificationsPerMin =
 const std::string kSelectNotificationsPerPriority =
     "SELECT `value` FROM notifications_by_priority WHERE `priority_value` = ? ";
 
-const std::string kSelectAppLevels = "SELECT `application_id` FROM `app_level`";
+const std::string kSelectAppLevels =
+    "SELECT `application_id`, `minutes_in_hmi_full`, "
+    "  `minutes_in_hmi_limited`, `minutes_in_hmi_background`, "
+    "  `minutes_in_hmi_none`, `count_of_user_selections`, "
+    "  `count_of_rejections_sync_out_of_memory`, "
+    "  `count_of_rejections_nickname_mismatch`, "
+    "  `count_of_rejections_duplicate_name`, `count_of_rejected_rpcs_calls`, "
+    "  `count_of_rpcs_sent_in_hmi_none`, `count_of_removals_for_bad_behavior`, "
+    "  `count_of_run_attempts_while_revoked`, "
+    "  `app_registration_language_gui`, `app_registration_language_vui` "
+    "FROM `app_level`";
+
+const std::string kSelectGlobalCounters =
+    "SELECT `count_of_iap_buffer_full`, `count_sync_out_of_memory`, "
+    "  `count_of_sync_reboots` FROM `usage_and_error_count` LIMIT 1";
 
 const std::string kSelectDeviceData = "SELECT * FROM `device`";
 
@@ -637,6 +678,46 @@ const std::string kIncrementIgnitionCycles =
     "UPDATE `module_meta` SET `ignition_cycles_since_last_exchange` = 1 + "
     "  `ignition_cycles_since_last_exchange`";
 
+const std::string kAddGlobalCounters =
+    "UPDATE `usage_and_error_count` SET "
+    "  `count_of_iap_buffer_full` = IFNULL(`count_of_iap_buffer_full`, 0) + ?, "
+    "  `count_sync_out_of_memory` = IFNULL(`count_sync_out_of_memory`, 0) + ?, "
+    "  `count_of_sync_reboots` = IFNULL(`count_of_sync_reboots`, 0) + ?";
+
+const std::string kUpdateGlobalCounters =
+    "UPDATE `usage_and_error_count` SET `count_of_iap_buffer_full` = ?, "
+    "  `count_sync_out_of_memory` = ?, `count_of_sync_reboots` = ?";
+
+// Parameters go in order of AppStopwatchId, AppCounterId and AppInfoId.
+// Null language keeps the stored one.
+const std::string kAddAppLevelStatistics =
+    "UPDATE `app_level` SET "
+    "  `minutes_in_hmi_full` = IFNULL(`minutes_in_hmi_full`, 0) + ?, "
+    "  `minutes_in_hmi_limited` = IFNULL(`minutes_in_hmi_limited`, 0) + ?, "
+    "  `minutes_in_hmi_background` = "
+    "    IFNULL(`minutes_in_hmi_background`, 0) + ?, "
+    "  `minutes_in_hmi_none` = IFNULL(`minutes_in_hmi_none`, 0) + ?, "
+    "  `count_of_user_selections` = IFNULL(`count_of_user_selections`, 0) + ?, "
+    "  `count_of_rejections_sync_out_of_memory` = "
+    "    IFNULL(`count_of_rejections_sync_out_of_memory`, 0) + ?, "
+    "  `count_of_rejections_nickname_mismatch` = "
+    "    IFNULL(`count_of_rejections_nickname_mismatch`, 0) + ?, "
+    "  `count_of_rejections_duplicate_name` = "
+    "    IFNULL(`count_of_rejections_duplicate_name`, 0) + ?, "
+    "  `count_of_rejected_rpcs_calls` = "
+    "    IFNULL(`count_of_rejected_rpcs_calls`, 0) + ?, "
+    "  `count_of_rpcs_sent_in_hmi_none` = "
+    "    IFNULL(`count_of_rpcs_sent_in_hmi_none`, 0) + ?, "
+    "  `count_of_removals_for_bad_behavior` = "
+    "    IFNULL(`count_of_removals_for_bad_behavior`, 0) + ?, "
+    "  `count_of_run_attempts_while_revoked` = "
+    "    IFNULL(`count_of_run_attempts_while_revoked`, 0) + ?, "
+    "  `app_registration_language_gui` = "
+    "    IFNULL(?, `app_registration_language_gui`), "
+    "  `app_registration_language_vui` = "
+    "    IFNULL(?, `app_registration_language_vui`) "
+    "WHERE `application_id` = ?";
+
 const std::string kResetIgnitionCycles =
     "UPDATE `module_meta` SET `ignition_cycles_since_last_exchange` = 0";
 
@@ -43,6 +43,7 @@
 #include "policy/policy_helper.h"
 #include "policy/cache_manager.h"
 #include "config_profile/profile.h"
+#include "usage_statistics/statistics_aggregator.h"
 
 namespace policy {
 
@@ -58,6 +59,31 @@ template <typename T, typename K> void InsertUnique(K value, T *array) {
     array->push_back(value);
   }
 }
+
+void GatherCounter(const dbms::SQLQuery &query, int pos,
+                   rpc::Optional<policy_table::UsageCounter> *counter) {
+  if (!query.IsNull(pos)) {
+    **counter = static_cast<int64_t>(query.GetInteger(pos));
+  }
+}
+
+void BindCounter(const rpc::Optional<policy_table::UsageCounter> &counter,
+                 int pos, dbms::SQLQuery *query) {
+  if (counter.is_initialized()) {
+    query->Bind(pos, static_cast<int64_t>(*counter));
+  } else {
+    query->Bind(pos);
+  }
+}
+
+void BindLanguage(const rpc::Optional<rpc::String<1, 25> > &language, int pos,
+                  dbms::SQLQuery *query) {
+  if (language.is_initialized()) {
+    query->Bind(pos, static_cast<const std::string &>(*language));
+  } else {
+    query->Bind(pos);
+  }
+}
 } //  namespace
 
 const std::string SQLPTRepresentation::kDatabaseName = "policy";
@@ -529,12 +555,39 @@ void SQLPTRepresentation::GatherModuleConfig(
 bool SQLPTRepresentation::GatherUsageAndErrorCounts(
     policy_table::UsageAndErrorCounts *counts) const {
   LOG4CXX_INFO(logger_, "Gather Usage and Error Counts.");
+  dbms::SQLQuery global_query(db());
+  if (global_query.Prepare(sql_pt::kSelectGlobalCounters) &&
+      global_query.Next()) {
+    GatherCounter(global_query, 0, &counts->count_of_iap_buffer_full);
+    GatherCounter(global_query, 1, &counts->count_sync_out_of_memory);
+    GatherCounter(global_query, 2, &counts->count_of_sync_reboots);
+  }
+
   dbms::SQLQuery query(db());
   if (query.Prepare(sql_pt::kSelectAppLevels)) {
-    policy_table::AppLevel app_level_empty;
-    app_level_empty.mark_initialized();
     while (query.Next()) {
-      (*counts->app_level)[query.GetString(0)] = app_level_empty;
+      policy_table::AppLevel app_level;
+      app_level.mark_initialized();
+      GatherCounter(query, 1, &app_level.minutes_in_hmi_full);
+      GatherCounter(query, 2, &app_level.minutes_in_hmi_limited);
+      GatherCounter(query, 3, &app_level.minutes_in_hmi_background);
+      GatherCounter(query, 4, &app_level.minutes_in_hmi_none);
+      GatherCounter(query, 5, &app_level.count_of_user_selections);
+      GatherCounter(query, 6,
+                    &app_level.count_of_rejections_sync_out_of_memory);
+      GatherCounter(query, 7, &app_level.count_of_rejections_nickname_mismatch);
+      GatherCounter(query, 8, &app_level.count_of_rejections_duplicate_name);
+      GatherCounter(query, 9, &app_level.count_of_rejected_rpc_calls);
+      GatherCounter(query, 10, &app_level.count_of_rpcs_sent_in_hmi_none);
+      GatherCounter(query, 11, &app_level.count_of_removals_for_bad_behavior);
+      GatherCounter(query, 12, &app_level.count_of_run_attempts_while_revoked);
+      if (!query.IsNull(13)) {
+        *app_level.app_registration_language_gui = query.GetString(13);
+      }
+      if (!query.IsNull(14)) {
+        *app_level.app_registration_language_vui = query.GetString(14);
+      }
+      (*counts->app_level)[query.GetString(0)] = app_level;
     }
   }
   return true;
@@ -705,6 +758,89 @@ bool SQLPTRepresentation::Save(const policy_table::Table &table) {
   return true;
 }
 
+bool SQLPTRepresentation::SaveChanges(const policy_table::Table &table,
+                                      const PolicyTableChanges &changes) {
+  LOG4CXX_AUTO_TRACE(logger_);
+  const policy_table::FunctionalGroupings &groups =
+      table.policy_table.functional_groupings;
+  const policy_table::ApplicationPoliciesSection &policies =
+      table.policy_table.app_policies_section;
+
+  db_->BeginTransaction();
+  dbms::SQLQuery query(db());
+  std::set<std::string>::const_iterator it = changes.removed_groups.begin();
+  for (; changes.removed_groups.end() != it; ++it) {
+    if (!DeleteFunctionalGroup(*it) ||
+        !query.Prepare(sql_pt::kDeleteAppGroupByFunctionalGroupId)) {
+      db_->RollbackTransaction();
+      return false;
+    }
+    query.Bind(0, static_cast<int64_t>(abs(CacheManager::GenerateHash(*it))));
+    if (!query.Exec()) {
+      LOG4CXX_WARN(logger_, "Incorrect delete from app_group.");
+      db_->RollbackTransaction();
+      return false;
+    }
+  }
+
+  for (it = changes.updated_groups.begin();
+       changes.updated_groups.end() != it; ++it) {
+    policy_table::FunctionalGroupings::const_iterator group = groups.find(*it);
+    if (!DeleteFunctionalGroup(*it) ||
+        (groups.end() != group && !SaveFunctionalGroup(*group))) {
+      db_->RollbackTransaction();
+      return false;
+    }
+  }
+
+  // Predefined apps should be saved first, see
+  // SaveApplicationPoliciesSection
+  std::vector<std::string> app_ids;
+  const std::string predefined_ids[] = {kDefaultId, kPreDataConsentId};
+  for (size_t i = 0; i < sizeof(predefined_ids) / sizeof(predefined_ids[0]);
+       ++i) {
+    if (changes.updated_apps.count(predefined_ids[i])) {
+      app_ids.push_back(predefined_ids[i]);
+    }
+  }
+  for (it = changes.updated_apps.begin(); changes.updated_apps.end() != it;
+       ++it) {
+    if (kDefaultId != *it && kPreDataConsentId != *it) {
+      app_ids.push_back(*it);
+    }
+  }
+
+  std::vector<std::string>::const_iterator app_id = app_ids.begin();
+  for (; app_ids.end() != app_id; ++app_id) {
+    policy_table::ApplicationPolicies::const_iterator app =
+        policies.apps.find(*app_id);
+    if (!DeleteApplication(*app_id) ||
+        (policies.apps.end() != app && !SaveSpecificAppPolicy(*app))) {
+      db_->RollbackTransaction();
+      return false;
+    }
+  }
+
+  if (changes.is_device_changed && (!DeleteApplication(kDeviceId) ||
+                                    !SaveDevicePolicy(policies.device))) {
+    db_->RollbackTransaction();
+    return false;
+  }
+  if (changes.is_module_config_changed &&
+      !SaveModuleConfig(table.policy_table.module_config)) {
+    db_->RollbackTransaction();
+    return false;
+  }
+  if (changes.is_messages_changed &&
+      !SaveConsumerFriendlyMessages(
+          *table.policy_table.consumer_friendly_messages)) {
+    db_->RollbackTransaction();
+    return false;
+  }
+  db_->CommitTransaction();
+  return true;
+}
+
 bool SQLPTRepresentation::SaveFunctionalGroupings(
     const policy_table::FunctionalGroupings &groups) {
   dbms::SQLQuery query_delete(db());
@@ -718,35 +854,91 @@ bool SQLPTRepresentation::SaveFunctionalGroupings(
     LOG4CXX_WARN(logger_, "Incorrect delete from seconds between retries.");
     return false;
   }
+
+  policy_table::FunctionalGroupings::const_iterator it;
+
+  for (it = groups.begin(); it != groups.end(); ++it) {
+    if (!SaveFunctionalGroup(*it)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SQLPTRepresentation::SaveFunctionalGroup(
+    const policy_table::FunctionalGroupings::value_type &group) {
+  dbms::SQLQuery query(db());
   if (!query.Prepare(sql_pt::kInsertFunctionalGroup)) {
     LOG4CXX_WARN(logger_, "Incorrect insert statement for functional groups");
     return false;
   }
 
-  policy_table::FunctionalGroupings::const_iterator it;
+  // Since we uses this id in other tables, we have to be sure
+  // that id for certain group will be same in case when
+  // we drop records from the table and add them again.
+  // That's why we use hash as a primary key insted of
+  // simple auto incremental index.
+  const long int id = abs(CacheManager::GenerateHash(group.first));
+  // SQLite's Bind doesn support 'long' type
+  // So we need to explicitly cast it to int64_t
+  // to avoid ambiguity.
+  query.Bind(0, static_cast<int64_t>(id));
+  query.Bind(1, group.first);
+  group.second.user_consent_prompt.is_initialized()
+      ? query.Bind(2, *(group.second.user_consent_prompt))
+      : query.Bind(2);
 
-  for (it = groups.begin(); it != groups.end(); ++it) {
-    // Since we uses this id in other tables, we have to be sure
-    // that id for certain group will be same in case when
-    // we drop records from the table and add them again.
-    // That's why we use hash as a primary key insted of
-    // simple auto incremental index.
-    const long int id = abs(CacheManager::GenerateHash(it->first));
-    // SQLite's Bind doesn support 'long' type
-    // So we need to explicitly cast it to int64_t
-    // to avoid ambiguity.
-    query.Bind(0, static_cast<int64_t>(id));
-    query.Bind(1, it->first);
-    it->second.user_consent_prompt.is_initialized()
-        ? query.Bind(2, *(it->second.user_consent_prompt))
-        : query.Bind(2);
+  if (!query.Exec()) {
+    LOG4CXX_WARN(logger_, "Incorrect insert into functional groups");
+    return false;
+  }
 
-    if (!query.Exec() || !query.Reset()) {
-      LOG4CXX_WARN(logger_, "Incorrect insert into functional groups");
+  return SaveRpcs(query.LastInsertId(), group.second.rpcs);
+}
+
+bool SQLPTRepresentation::DeleteFunctionalGroup(const std::string &group_name) {
+  const int64_t id = abs(CacheManager::GenerateHash(group_name));
+  dbms::SQLQuery query(db());
+  if (!query.Prepare(sql_pt::kDeleteRpcByFunctionalGroupId)) {
+    LOG4CXX_WARN(logger_, "Incorrect delete statement for rpc");
+    return false;
+  }
+  query.Bind(0, id);
+  if (!query.Exec()) {
+    LOG4CXX_WARN(logger_, "Incorrect delete from rpc.");
+    return false;
+  }
+
+  if (!query.Prepare(sql_pt::kDeleteFunctionalGroupById)) {
+    LOG4CXX_WARN(logger_, "Incorrect delete statement for functional group");
+    return false;
+  }
+  query.Bind(0, id);
+  if (!query.Exec()) {
+    LOG4CXX_WARN(logger_, "Incorrect delete from functional group.");
+    return false;
+  }
+  return true;
+}
+
+bool SQLPTRepresentation::DeleteApplication(const std::string &app_id) {
+  const std::string queries[] = {sql_pt::kDeleteAppGroupByApplicationId,
+                                 sql_pt::kDeleteRequestTypeByApplicationId,
+                                 sql_pt::kDeleteNicknameByApplicationId,
+                                 sql_pt::kDeleteAppTypeByApplicationId,
+                                 sql_pt::kDeleteApplicationById};
+  const size_t queries_count = sizeof(queries) / sizeof(queries[0]);
+
+  dbms::SQLQuery query(db());
+  for (size_t i = 0; i < queries_count; ++i) {
+    if (!query.Prepare(queries[i])) {
+      LOG4CXX_WARN(logger_, "Incorrect delete statement for application "
+                                << app_id);
       return false;
     }
-
-    if (!SaveRpcs(query.LastInsertId(), it->second.rpcs)) {
+    query.Bind(0, app_id);
+    if (!query.Exec()) {
+      LOG4CXX_WARN(logger_, "Incorrect delete of application " << app_id);
       return false;
     }
   }
@@ -1257,6 +1449,19 @@ bool SQLPTRepresentation::SaveDeviceData(
 bool SQLPTRepresentation::SaveUsageAndErrorCounts(
     const policy_table::UsageAndErrorCounts &counts) {
   const_cast<policy_table::UsageAndErrorCounts &>(counts).mark_initialized();
+  dbms::SQLQuery global_query(db());
+  if (!global_query.Prepare(sql_pt::kUpdateGlobalCounters)) {
+    LOG4CXX_WARN(logger_, "Incorrect update statement for global counters.");
+    return false;
+  }
+  BindCounter(counts.count_of_iap_buffer_full, 0, &global_query);
+  BindCounter(counts.count_sync_out_of_memory, 1, &global_query);
+  BindCounter(counts.count_of_sync_reboots, 2, &global_query);
+  if (!global_query.Exec()) {
+    LOG4CXX_WARN(logger_, "Incorrect update of global counters.");
+    return false;
+  }
+
   dbms::SQLQuery query(db());
   if (!query.Exec(sql_pt::kDeleteAppLevel)) {
     LOG4CXX_WARN(logger_, "Incorrect delete from app level.");
@@ -1271,8 +1476,23 @@ bool SQLPTRepresentation::SaveUsageAndErrorCounts(
   const policy_table::AppLevels &app_levels = *counts.app_level;
   const_cast<policy_table::AppLevels &>(*counts.app_level).mark_initialized();
   for (it = app_levels.begin(); it != app_levels.end(); ++it) {
+    const policy_table::AppLevel &app_level = it->second;
     query.Bind(0, it->first);
-    if (!query.Exec()) {
+    BindCounter(app_level.minutes_in_hmi_full, 1, &query);
+    BindCounter(app_level.minutes_in_hmi_limited, 2, &query);
+    BindCounter(app_level.minutes_in_hmi_background, 3, &query);
+    BindCounter(app_level.minutes_in_hmi_none, 4, &query);
+    BindCounter(app_level.count_of_user_selections, 5, &query);
+    BindCounter(app_level.count_of_rejections_sync_out_of_memory, 6, &query);
+    BindCounter(app_level.count_of_rejections_nickname_mismatch, 7, &query);
+    BindCounter(app_level.count_of_rejections_duplicate_name, 8, &query);
+    BindCounter(app_level.count_of_rejected_rpc_calls, 9, &query);
+    BindCounter(app_level.count_of_rpcs_sent_in_hmi_none, 10, &query);
+    BindCounter(app_level.count_of_removals_for_bad_behavior, 11, &query);
+    BindCounter(app_level.count_of_run_attempts_while_revoked, 12, &query);
+    BindLanguage(app_level.app_registration_language_gui, 13, &query);
+    BindLanguage(app_level.app_registration_language_vui, 14, &query);
+    if (!query.Exec() || !query.Reset()) {
       LOG4CXX_WARN(logger_, "Incorrect insert into app level.");
       return false;
     }
@@ -1280,6 +1500,68 @@ bool SQLPTRepresentation::SaveUsageAndErrorCounts(
   return true;
 }
 
+bool SQLPTRepresentation::SaveStatistics(
+    const usage_statistics::Statistics &statistics) {
+  using namespace usage_statistics;
+  LOG4CXX_AUTO_TRACE(logger_);
+  db_->BeginTransaction();
+
+  dbms::SQLQuery global_query(db());
+  if (!global_query.Prepare(sql_pt::kAddGlobalCounters)) {
+    LOG4CXX_WARN(logger_, "Incorrect statement for global counters.");
+    db_->RollbackTransaction();
+    return false;
+  }
+  for (size_t i = 0; i < kGlobalCountersCount; ++i) {
+    global_query.Bind(i, static_cast<int64_t>(statistics.global_counters[i]));
+  }
+  if (!global_query.Exec()) {
+    LOG4CXX_WARN(logger_, "Failed adding global counters.");
+    db_->RollbackTransaction();
+    return false;
+  }
+
+  dbms::SQLQuery insert_query(db());
+  dbms::SQLQuery update_query(db());
+  if (!insert_query.Prepare(sql_pt::kInsertAppLevelIfAbsent) ||
+      !update_query.Prepare(sql_pt::kAddAppLevelStatistics)) {
+    LOG4CXX_WARN(logger_, "Incorrect statement for app level statistics.");
+    db_->RollbackTransaction();
+    return false;
+  }
+
+  AppStatisticsMap::const_iterator it = statistics.apps.begin();
+  for (; statistics.apps.end() != it; ++it) {
+    const AppStatistics &app = it->second;
+    insert_query.Bind(0, it->first);
+    int pos = 0;
+    for (size_t i = 0; i < kAppStopwatchesCount; ++i) {
+      update_query.Bind(pos++, static_cast<int64_t>(app.stopwatches[i]));
+    }
+    for (size_t i = 0; i < kAppCountersCount; ++i) {
+      update_query.Bind(pos++, static_cast<int64_t>(app.counters[i]));
+    }
+    for (size_t i = 0; i < kAppInfosCount; ++i) {
+      if (app.infos[i].empty()) {
+        update_query.Bind(pos++);
+      } else {
+        update_query.Bind(pos++, app.infos[i]);
+      }
+    }
+    update_query.Bind(pos, it->first);
+
+    if (!insert_query.Exec() || !insert_query.Reset() ||
+        !update_query.Exec() || !update_query.Reset()) {
+      LOG4CXX_WARN(logger_, "Failed adding statistics of " << it->first);
+      db_->RollbackTransaction();
+      return false;
+    }
+  }
+
+  db_->CommitTransaction();
+  return true;
+}
+
 void SQLPTRepresentation::IncrementIgnitionCycles() {
   dbms::SQLQuery query(db());
   if (!query.Exec(sql_pt::kIncrementIgnitionCycles)) {
@@ -1305,6 +1587,18 @@ bool SQLPTRepresentation::UpdateRequired() const {
   return query.GetBoolean(0);
 }
 
+void SQLPTRepresentation::SaveIsFirstRun(bool is_first_run) {
+  dbms::SQLQuery query(db());
+  if (!query.Prepare(sql_pt::kUpdateIsFirstRun)) {
+    LOG4CXX_WARN(logger_, "Incorrect update into module config (is_first_run)");
+    return;
+  }
+  query.Bind(0, is_first_run);
+  if (!query.Exec()) {
+    LOG4CXX_WARN(logger_, "Failed update module config (is_first_run)");
+  }
+}
+
 void SQLPTRepresentation::SaveUpdateRequired(bool value) {
   dbms::SQLQuery query(db());
   // TODO(AOleynik): Quick fix, will be reworked
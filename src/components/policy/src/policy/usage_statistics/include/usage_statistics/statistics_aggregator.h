@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_POLICY_INCLUDE_POLICY_USAGE_STATISTICS_STATISTICS_AGGREGATOR_H_
+#define SRC_COMPONENTS_POLICY_INCLUDE_POLICY_USAGE_STATISTICS_STATISTICS_AGGREGATOR_H_
+
+#include <stddef.h>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "usage_statistics/statistics_manager.h"
+#include "utils/lock.h"
+#include "utils/macro.h"
+
+namespace usage_statistics {
+
+const size_t kGlobalCountersCount = SYNC_REBOOTS + 1;
+const size_t kAppCountersCount = RUN_ATTEMPTS_WHILE_REVOKED + 1;
+const size_t kAppInfosCount = LANGUAGE_VUI + 1;
+const size_t kAppStopwatchesCount = SECONDS_HMI_NONE + 1;
+
+/**
+ * @brief Statistics of one application gathered since the last collection.
+ * Arrays are indexed by AppCounterId, AppStopwatchId and AppInfoId,
+ * an empty info means it was not set. Aggregator reports stopwatches
+ * in seconds.
+ */
+struct AppStatistics {
+  AppStatistics();
+  bool empty() const;
+
+  uint32_t counters[kAppCountersCount];
+  uint32_t stopwatches[kAppStopwatchesCount];
+  std::string infos[kAppInfosCount];
+};
+
+typedef std::map<std::string, AppStatistics> AppStatisticsMap;
+
+/**
+ * @brief Statistics gathered since the last collection
+ */
+struct Statistics {
+  Statistics();
+  bool empty() const;
+
+  uint32_t global_counters[kGlobalCountersCount];
+  AppStatisticsMap apps;
+};
+
+/**
+ * @brief In-memory statistics manager.
+ * Counters are changed by atomic operations and found without locking,
+ * so Increment and Add never block each other. A lock is only taken when an
+ * application is met first time and when an info is set.
+ * Collected values are meant to be stored later in one batch.
+ */
+class StatisticsAggregator : public StatisticsManager {
+ public:
+  StatisticsAggregator();
+  ~StatisticsAggregator();
+
+  virtual void Increment(GlobalCounterId type);
+  virtual void Increment(const std::string& app_id, AppCounterId type);
+  virtual void Set(const std::string& app_id, AppInfoId type,
+                   const std::string& value);
+  virtual void Add(const std::string& app_id,
+                   AppStopwatchId type,
+                   int32_t timespan_seconds);
+
+  /**
+   * @brief Moves values gathered since the last call to statistics
+   * and starts gathering from zero.
+   * @param statistics to be filled, previous content is replaced
+   */
+  void Collect(Statistics* statistics);
+
+  /**
+   * @brief Gives collected values back, e.g. if they failed to be stored.
+   * Values gathered meanwhile are kept, infos set meanwhile win.
+   * @param statistics previously collected values
+   */
+  void Restore(const Statistics& statistics);
+
+ private:
+  struct AppSlot {
+    AppSlot();
+    volatile uint32_t counters[kAppCountersCount];
+    volatile uint32_t seconds[kAppStopwatchesCount];
+  };
+  typedef std::map<std::string, AppSlot*> AppSlots;
+  typedef std::map<std::pair<std::string, AppInfoId>, std::string> AppInfos;
+
+  /**
+   * @brief Finds or creates counters of application.
+   * Slots live as long as aggregator, so returned pointer is used unlocked.
+   */
+  AppSlot* GetSlot(const std::string& app_id);
+
+  /**
+   * @brief Deletes replaced maps if no lookup is running,
+   * otherwise they wait for the next call.
+   * Must be called with app_slots_lock_ taken.
+   */
+  void DeleteReplacedSlots();
+
+  volatile uint32_t global_counters_[kGlobalCountersCount];
+
+  /**
+   * Slots are looked up without locking. A new application replaces the
+   * whole map by an extended copy. Replaced maps may still be read, so they
+   * are deleted once no lookup is counted in slots_readers_.
+   */
+  const AppSlots* volatile app_slots_;
+  volatile uint32_t slots_readers_;
+  std::vector<const AppSlots*> replaced_app_slots_;
+  sync_primitives::Lock app_slots_lock_;
+
+  AppInfos app_infos_;
+  sync_primitives::Lock app_infos_lock_;
+
+  DISALLOW_COPY_AND_ASSIGN(StatisticsAggregator);
+};
+
+}  //  namespace usage_statistics
+
+#endif  //  SRC_COMPONENTS_POLICY_INCLUDE_POLICY_USAGE_STATISTICS_STATISTICS_AGGREGATOR_H_
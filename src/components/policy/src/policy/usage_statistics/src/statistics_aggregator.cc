@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "usage_statistics/statistics_aggregator.h"
+
+#include "utils/atomic.h"
+#include "utils/logger.h"
+#include "utils/memory_barrier.h"
+
+namespace usage_statistics {
+
+AppStatistics::AppStatistics() {
+  for (size_t i = 0; i < kAppCountersCount; ++i) {
+    counters[i] = 0;
+  }
+  for (size_t i = 0; i < kAppStopwatchesCount; ++i) {
+    stopwatches[i] = 0;
+  }
+}
+
+bool AppStatistics::empty() const {
+  for (size_t i = 0; i < kAppCountersCount; ++i) {
+    if (counters[i]) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < kAppStopwatchesCount; ++i) {
+    if (stopwatches[i]) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < kAppInfosCount; ++i) {
+    if (!infos[i].empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Statistics::Statistics() {
+  for (size_t i = 0; i < kGlobalCountersCount; ++i) {
+    global_counters[i] = 0;
+  }
+}
+
+bool Statistics::empty() const {
+  for (size_t i = 0; i < kGlobalCountersCount; ++i) {
+    if (global_counters[i]) {
+      return false;
+    }
+  }
+  return apps.empty();
+}
+
+StatisticsAggregator::AppSlot::AppSlot() {
+  for (size_t i = 0; i < kAppCountersCount; ++i) {
+    counters[i] = 0;
+  }
+  for (size_t i = 0; i < kAppStopwatchesCount; ++i) {
+    seconds[i] = 0;
+  }
+}
+
+StatisticsAggregator::StatisticsAggregator()
+    : app_slots_(new AppSlots), slots_readers_(0) {
+  for (size_t i = 0; i < kGlobalCountersCount; ++i) {
+    global_counters_[i] = 0;
+  }
+}
+
+StatisticsAggregator::~StatisticsAggregator() {
+  for (AppSlots::const_iterator it = app_slots_->begin();
+       it != app_slots_->end(); ++it) {
+    delete it->second;
+  }
+  delete app_slots_;
+  for (size_t i = 0; i < replaced_app_slots_.size(); ++i) {
+    delete replaced_app_slots_[i];
+  }
+}
+
+void StatisticsAggregator::Increment(GlobalCounterId type) {
+  atomic_post_inc(&global_counters_[type]);
+}
+
+void StatisticsAggregator::Increment(const std::string& app_id,
+                                     AppCounterId type) {
+  atomic_post_inc(&GetSlot(app_id)->counters[type]);
+}
+
+void StatisticsAggregator::Set(const std::string& app_id, AppInfoId type,
+                               const std::string& value) {
+  sync_primitives::AutoLock lock(app_infos_lock_);
+  app_infos_[std::make_pair(app_id, type)] = value;
+}
+
+void StatisticsAggregator::Add(const std::string& app_id,
+                               AppStopwatchId type,
+                               int32_t timespan_seconds) {
+  if (timespan_seconds <= 0) {
+    return;
+  }
+  atomic_post_add(&GetSlot(app_id)->seconds[type],
+                  static_cast<uint32_t>(timespan_seconds));
+}
+
+void StatisticsAggregator::Collect(Statistics* statistics) {
+  DCHECK_OR_RETURN_VOID(statistics);
+  *statistics = Statistics();
+
+  for (size_t i = 0; i < kGlobalCountersCount; ++i) {
+    statistics->global_counters[i] = atomic_post_reset(&global_counters_[i]);
+  }
+
+  // Current map is only replaced and deleted under the lock
+  sync_primitives::AutoLock slots_lock(app_slots_lock_);
+  DeleteReplacedSlots();
+  const AppSlots* slots = app_slots_;
+  for (AppSlots::const_iterator it = slots->begin(); it != slots->end();
+       ++it) {
+    AppSlot* slot = it->second;
+    AppStatistics app;
+    for (size_t i = 0; i < kAppCountersCount; ++i) {
+      app.counters[i] = atomic_post_reset(&slot->counters[i]);
+    }
+    for (size_t i = 0; i < kAppStopwatchesCount; ++i) {
+      app.stopwatches[i] = atomic_post_reset(&slot->seconds[i]);
+    }
+    if (!app.empty()) {
+      statistics->apps[it->first] = app;
+    }
+  }
+
+  AppInfos infos;
+  {
+    sync_primitives::AutoLock lock(app_infos_lock_);
+    infos.swap(app_infos_);
+  }
+  for (AppInfos::const_iterator it = infos.begin(); it != infos.end(); ++it) {
+    statistics->apps[it->first.first].infos[it->first.second] = it->second;
+  }
+}
+
+void StatisticsAggregator::Restore(const Statistics& statistics) {
+  for (size_t i = 0; i < kGlobalCountersCount; ++i) {
+    if (statistics.global_counters[i]) {
+      atomic_post_add(&global_counters_[i], statistics.global_counters[i]);
+    }
+  }
+
+  for (AppStatisticsMap::const_iterator it = statistics.apps.begin();
+       it != statistics.apps.end(); ++it) {
+    const AppStatistics& app = it->second;
+    AppSlot* slot = GetSlot(it->first);
+    for (size_t i = 0; i < kAppCountersCount; ++i) {
+      if (app.counters[i]) {
+        atomic_post_add(&slot->counters[i], app.counters[i]);
+      }
+    }
+    for (size_t i = 0; i < kAppStopwatchesCount; ++i) {
+      if (app.stopwatches[i]) {
+        atomic_post_add(&slot->seconds[i], app.stopwatches[i]);
+      }
+    }
+
+    sync_primitives::AutoLock lock(app_infos_lock_);
+    for (size_t i = 0; i < kAppInfosCount; ++i) {
+      if (!app.infos[i].empty()) {
+        // insert() keeps a value which was set after collection
+        app_infos_.insert(std::make_pair(
+            std::make_pair(it->first, static_cast<AppInfoId>(i)),
+            app.infos[i]));
+      }
+    }
+  }
+}
+
+StatisticsAggregator::AppSlot* StatisticsAggregator::GetSlot(
+    const std::string& app_id) {
+  // Counted before the map is read, so a replaced map seen here
+  // is not deleted till the lookup ends
+  atomic_post_inc(&slots_readers_);
+  const AppSlots* slots = app_slots_;
+  AppSlots::const_iterator it = slots->find(app_id);
+  AppSlot* found_slot = slots->end() != it ? it->second : NULL;
+  atomic_post_dec(&slots_readers_);
+  if (found_slot) {
+    return found_slot;
+  }
+
+  sync_primitives::AutoLock lock(app_slots_lock_);
+  slots = app_slots_;
+  it = slots->find(app_id);
+  if (slots->end() != it) {
+    return it->second;
+  }
+  AppSlots* extended_slots = new AppSlots(*slots);
+  AppSlot* slot = new AppSlot;
+  extended_slots->insert(std::make_pair(app_id, slot));
+  // The map must be complete before other threads can see it
+  utils::memory_barrier();
+  atomic_pointer_assign(app_slots_, extended_slots);
+  replaced_app_slots_.push_back(slots);
+  DeleteReplacedSlots();
+  return slot;
+}
+
+void StatisticsAggregator::DeleteReplacedSlots() {
+  if (replaced_app_slots_.empty()) {
+    return;
+  }
+  // New map must be visible before readers are checked, a lookup which
+  // starts after this point reads the new map
+  utils::memory_barrier();
+  if (0 != slots_readers_) {
+    return;
+  }
+  for (size_t i = 0; i < replaced_app_slots_.size(); ++i) {
+    delete replaced_app_slots_[i];
+  }
+  replaced_app_slots_.clear();
+}
+
+}  //  namespace usage_statistics
@@ -84,6 +84,9 @@ class MockCacheManagerInterface : public CacheManagerInterface {
       bool(const std::string& file_name));
   MOCK_METHOD0(GenerateSnapshot,
       utils::SharedPtr<policy_table::Table>());
+  MOCK_METHOD1(GenerateUpdateSnapshot,
+      utils::SharedPtr<policy_table::Table>(
+          const policy_table::Table& update_pt));
   MOCK_METHOD1(ApplyUpdate,
       bool(const policy_table::Table& update_pt));
   MOCK_METHOD1(Save,
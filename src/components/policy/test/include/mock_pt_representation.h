@@ -38,6 +38,7 @@
 #include "gmock/gmock.h"
 
 #include "policy/pt_representation.h"
+#include "usage_statistics/statistics_aggregator.h"
 #include "rpc_base/rpc_base.h"
 #include "./types.h"
 
@@ -95,10 +96,15 @@ class MockPTRepresentation : virtual public PTRepresentation {
       utils::SharedPtr<policy_table::Table>());
   MOCK_METHOD1(Save,
       bool(const policy_table::Table& table));
+  MOCK_METHOD2(SaveChanges,
+      bool(const policy_table::Table& table,
+          const PolicyTableChanges& changes));
   MOCK_CONST_METHOD0(UpdateRequired,
       bool());
   MOCK_METHOD1(SaveUpdateRequired,
       void(bool value));
+  MOCK_METHOD1(SaveIsFirstRun,
+      void(bool is_first_run));
   MOCK_METHOD3(GetInitialAppData,
       bool(const std::string& app_id, StringArray* nicknames, StringArray* app_types));
 
@@ -115,6 +121,8 @@ class MockPTRepresentation : virtual public PTRepresentation {
   MOCK_CONST_METHOD1(IsDefaultPolicy, bool(const std::string& app_id));
   MOCK_METHOD1(SetDefaultPolicy, bool(const std::string& app_id));
   MOCK_CONST_METHOD1(IsPredataPolicy, bool(const std::string& app_id));
+  MOCK_METHOD1(SaveStatistics,
+      bool(const usage_statistics::Statistics& statistics));
 };
 
 }  // namespace policy
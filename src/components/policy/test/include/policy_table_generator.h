@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2015, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_POLICY_TEST_INCLUDE_POLICY_TABLE_GENERATOR_H_
+#define SRC_COMPONENTS_POLICY_TEST_INCLUDE_POLICY_TABLE_GENERATOR_H_
+
+#include <stddef.h>
+#include <string>
+
+#include "json/value.h"
+
+namespace test {
+namespace components {
+namespace policy {
+
+/**
+ * @brief Name of generated functional group: Group-<index>
+ */
+std::string TestGroupName(size_t index);
+
+/**
+ * @brief Id of generated application: app_<index>
+ */
+std::string TestAppId(size_t index);
+
+/**
+ * @brief Adds count copies of Base-4 functional group
+ * named TestGroupName(0)...TestGroupName(count - 1)
+ * @param table "policy_table" object
+ */
+void AddTestGroups(size_t count, Json::Value* table);
+
+/**
+ * @brief Adds count copies of default application policies
+ * named TestAppId(0)...TestAppId(count - 1)
+ * @param table "policy_table" object
+ */
+void AddTestApps(size_t count, Json::Value* table);
+
+/**
+ * @brief Adds copies of AppPermissions consumer friendly message
+ * named Message-<index> till compact json of root takes about size bytes
+ * @param root policy table document
+ */
+void PadWithMessages(size_t size, Json::Value* root);
+
+}  // namespace policy
+}  // namespace components
+}  // namespace test
+
+#endif  // SRC_COMPONENTS_POLICY_TEST_INCLUDE_POLICY_TABLE_GENERATOR_H_
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2015, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "policy_table_generator.h"
+
+#include <stdio.h>
+
+#include "json/writer.h"
+
+namespace test {
+namespace components {
+namespace policy {
+
+namespace {
+std::string IndexedName(const char* format, size_t index) {
+  char name[32];
+  snprintf(name, sizeof(name), format, static_cast<unsigned>(index));
+  return name;
+}
+}  // namespace
+
+std::string TestGroupName(size_t index) {
+  return IndexedName("Group-%u", index);
+}
+
+std::string TestAppId(size_t index) {
+  return IndexedName("app_%u", index);
+}
+
+void AddTestGroups(size_t count, Json::Value* table) {
+  Json::Value& groups = (*table)["functional_groupings"];
+  const Json::Value group = groups["Base-4"];
+  for (size_t i = 0; i < count; ++i) {
+    groups[TestGroupName(i)] = group;
+  }
+}
+
+void AddTestApps(size_t count, Json::Value* table) {
+  Json::Value& apps = (*table)["app_policies"];
+  const Json::Value app = apps["default"];
+  for (size_t i = 0; i < count; ++i) {
+    apps[TestAppId(i)] = app;
+  }
+}
+
+void PadWithMessages(size_t size, Json::Value* root) {
+  Json::Value& messages =
+      (*root)["policy_table"]["consumer_friendly_messages"]["messages"];
+  const Json::Value message = messages["AppPermissions"];
+  const size_t message_size = Json::FastWriter().write(message).size();
+  size_t current_size = Json::FastWriter().write(*root).size();
+  for (size_t i = 0; current_size < size;
+       ++i, current_size += message_size) {
+    messages[IndexedName("Message-%u", i)] = message;
+  }
+}
+
+}  // namespace policy
+}  // namespace components
+}  // namespace test
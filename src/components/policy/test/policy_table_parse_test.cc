@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "json/reader.h"
+#include "json/writer.h"
+#include "./types.h"
+#include "policy_table_generator.h"
+#include "rpc_base/json_stream_reader.h"
+#include "rpc_base/validation_report.h"
+#include "utils/date_time.h"
+#include "utils/file_system.h"
+#include "utils/shared_ptr.h"
+
+using rpc::JsonStreamReader;
+using rpc::policy_table_interface_base::Table;
+namespace policy_table = rpc::policy_table_interface_base;
+
+namespace test {
+namespace components {
+namespace policy {
+
+namespace {
+
+const size_t kBenchmarkIterations = 20;
+const size_t kEnlargedTableSize = 2 * 1024 * 1024;
+
+std::string ReadJson(const std::string& file_name) {
+  std::string json;
+  EXPECT_TRUE(file_system::ReadFile(file_name, json));
+  return json;
+}
+
+/**
+ * Makes preloaded table of about kEnlargedTableSize bytes, with 200 more
+ * applications and groups, the rest is taken by consumer friendly messages
+ */
+std::string EnlargedPreloadedJson() {
+  Json::Value root;
+  EXPECT_TRUE(Json::Reader().parse(ReadJson("sdl_preloaded_pt.json"), root));
+  AddTestGroups(200, &root["policy_table"]);
+  AddTestApps(200, &root["policy_table"]);
+  PadWithMessages(kEnlargedTableSize, &root);
+  return Json::StyledWriter().write(root);
+}
+
+utils::SharedPtr<Table> ParseWithJsonValue(const std::string& json) {
+  Json::Value value;
+  if (!Json::Reader().parse(json, value)) {
+    return utils::SharedPtr<Table>();
+  }
+  return new Table(&value);
+}
+
+utils::SharedPtr<Table> ParseWithStream(const std::string& json) {
+  JsonStreamReader reader(json.data(), json.data() + json.size());
+  utils::SharedPtr<Table> table = new Table(&reader);
+  return reader.has_failed() ? utils::SharedPtr<Table>() : table;
+}
+
+typedef utils::SharedPtr<Table> (*ParseFunction)(const std::string& json);
+
+void ExpectSameTables(const std::string& json,
+                      policy_table::PolicyTableType type) {
+  utils::SharedPtr<Table> from_value = ParseWithJsonValue(json);
+  utils::SharedPtr<Table> from_stream = ParseWithStream(json);
+  ASSERT_TRUE(from_value);
+  ASSERT_TRUE(from_stream);
+  from_value->SetPolicyTableType(type);
+  from_stream->SetPolicyTableType(type);
+  EXPECT_EQ(from_value->is_valid(), from_stream->is_valid());
+  Json::StyledWriter writer;
+  EXPECT_EQ(writer.write(from_value->ToJsonValue()),
+            writer.write(from_stream->ToJsonValue()));
+  rpc::ValidationReport value_report("policy_table");
+  from_value->ReportErrors(&value_report);
+  rpc::ValidationReport stream_report("policy_table");
+  from_stream->ReportErrors(&stream_report);
+  EXPECT_EQ(rpc::PrettyFormat(value_report), rpc::PrettyFormat(stream_report));
+}
+
+long ReadStatusKb(const char* field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (0 == line.compare(0, strlen(field), field)) {
+      return atol(line.c_str() + strlen(field));
+    }
+  }
+  return 0;
+}
+
+/**
+ * Parses table in the child process and returns growth of its peak
+ * resident memory, child starts with peak equal to the current size.
+ */
+long ParsePeakMemoryKb(ParseFunction parse, const std::string& json) {
+  int result_pipe[2];
+  if (0 != pipe(result_pipe)) {
+    return -1;
+  }
+  const pid_t pid = fork();
+  if (0 == pid) {
+    close(result_pipe[0]);
+    const long start_kb = ReadStatusKb("VmHWM:");
+    utils::SharedPtr<Table> table = parse(json);
+    long peak_kb = table ? ReadStatusKb("VmHWM:") - start_kb : -1;
+    const ssize_t written = write(result_pipe[1], &peak_kb, sizeof(peak_kb));
+    _exit(written == sizeof(peak_kb) ? 0 : 1);
+  }
+  close(result_pipe[1]);
+  long peak_kb = -1;
+  if (read(result_pipe[0], &peak_kb, sizeof(peak_kb)) != sizeof(peak_kb)) {
+    peak_kb = -1;
+  }
+  close(result_pipe[0]);
+  waitpid(pid, NULL, 0);
+  return peak_kb;
+}
+
+int64_t ParseTimeUs(ParseFunction parse, const std::string& json) {
+  int64_t min_time_us = 0;
+  for (size_t i = 0; i < kBenchmarkIterations; ++i) {
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    EXPECT_TRUE(parse(json));
+    const int64_t time_us =
+        date_time::DateTime::getuSecs(date_time::DateTime::getCurrentTime()) -
+        date_time::DateTime::getuSecs(start);
+    if (0 == i || time_us < min_time_us) {
+      min_time_us = time_us;
+    }
+  }
+  return min_time_us;
+}
+
+void ReportParsing(const char* name, const std::string& json) {
+  const long value_peak_kb = ParsePeakMemoryKb(&ParseWithJsonValue, json);
+  const long stream_peak_kb = ParsePeakMemoryKb(&ParseWithStream, json);
+  const long value_us = ParseTimeUs(&ParseWithJsonValue, json);
+  const long stream_us = ParseTimeUs(&ParseWithStream, json);
+  printf("%s, %u bytes: Json::Value parse %ld us, peak memory %ld KB; "
+         "stream parse %ld us, peak memory %ld KB\n",
+         name, static_cast<unsigned>(json.size()), value_us, value_peak_kb,
+         stream_us, stream_peak_kb);
+  EXPECT_GT(value_peak_kb, 0);
+  EXPECT_GT(stream_peak_kb, 0);
+}
+
+}  // namespace
+
+TEST(PolicyTableParseTest, PreloadedTable_StreamAndJsonValueGiveSameTable) {
+  ExpectSameTables(ReadJson("sdl_preloaded_pt.json"),
+                   policy_table::PT_PRELOADED);
+}
+
+TEST(PolicyTableParseTest, UpdateTable_StreamAndJsonValueGiveSameTable) {
+  ExpectSameTables(ReadJson("valid_sdl_pt_update.json"),
+                   policy_table::PT_UPDATE);
+}
+
+TEST(PolicyTableParseTest, InvalidValues_StreamAndJsonValueGiveSameErrors) {
+  Json::Value root;
+  ASSERT_TRUE(Json::Reader().parse(ReadJson("sdl_preloaded_pt.json"), root));
+  Json::Value& table = root["policy_table"];
+  table["app_policies"]["default"]["memory_kb"] = "wrong";
+  table["app_policies"]["default"]["groups"].append(5);
+  table["app_policies"]["pre_DataConsent"]["priority"] = "UNKNOWN";
+  table["app_policies"]["device"] = Json::Value::null;
+  table["app_policies"]["app_null"] = Json::Value::null;
+  table["app_policies"]["app_string"] = "default";
+  table["functional_groupings"]["Base-4"]["rpcs"] = Json::Value::null;
+  table["functional_groupings"]["Empty"] = Json::Value(Json::objectValue);
+  table["module_config"]["exchange_after_x_kilometers"] = -1;
+  table["module_config"]["seconds_between_retries"] = 5;
+  table["module_config"]["unknown_member"]["nested"] = true;
+  table.removeMember("consumer_friendly_messages");
+  const std::string json = Json::FastWriter().write(root);
+  ExpectSameTables(json, policy_table::PT_PRELOADED);
+  ExpectSameTables(json, policy_table::PT_UPDATE);
+}
+
+TEST(PolicyTableParseTest, MalformedJson_ExpectFailure) {
+  std::string json = ReadJson("sdl_preloaded_pt.json");
+  json.erase(json.rfind('}'));
+  EXPECT_FALSE(ParseWithJsonValue(json));
+  EXPECT_FALSE(ParseWithStream(json));
+}
+
+TEST(PolicyTableParseTest, EnlargedTable_StreamAndJsonValueGiveSameTable) {
+  ExpectSameTables(EnlargedPreloadedJson(), policy_table::PT_PRELOADED);
+}
+
+TEST(PolicyTableParseTest, DISABLED_Benchmark_ParsePreloadedTable) {
+  ReportParsing("Preloaded table", ReadJson("sdl_preloaded_pt.json"));
+  ReportParsing("Enlarged preloaded table", EnlargedPreloadedJson());
+}
+
+}  // namespace policy
+}  // namespace components
+}  // namespace test
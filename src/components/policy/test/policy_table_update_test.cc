@@ -0,0 +1,594 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <malloc.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "config_profile/profile.h"
+#include "json/reader.h"
+#include "json/writer.h"
+#include "mock_policy_listener.h"
+#include "policy/cache_manager.h"
+#include "policy/policy_helper.h"
+#include "policy/policy_manager_impl.h"
+#include "policy/sql_pt_representation.h"
+#include "policy_table_generator.h"
+#include "utils/date_time.h"
+#include "utils/file_system.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SaveArg;
+using ::testing::_;
+
+namespace test {
+namespace components {
+namespace policy {
+
+namespace {
+
+const std::string kDatabaseFile = "policy.sqlite";
+const size_t kAppsCount = 200;
+const size_t kGroupsCount = 200;
+const size_t kUpdateSize = 2 * 1024 * 1024;
+
+/**
+ * Builds an update of about kUpdateSize bytes from valid_sdl_pt_update.json
+ * with kAppsCount applications and kGroupsCount extra groups, the rest is
+ * taken by consumer friendly messages. Only groups and applications with
+ * index below changes_count differ from the update with changes_count = 0.
+ */
+::policy::BinaryMessage BuildUpdate(size_t changes_count) {
+  std::string json;
+  EXPECT_TRUE(file_system::ReadFile("valid_sdl_pt_update.json", json));
+  Json::Value root;
+  EXPECT_TRUE(Json::Reader().parse(json, root));
+  Json::Value& table = root["policy_table"];
+  Json::Value& groups = table["functional_groupings"];
+  Json::Value& apps = table["app_policies"];
+
+  AddTestGroups(kGroupsCount, &table);
+  for (size_t i = 0; i < changes_count && i < kGroupsCount; ++i) {
+    groups[TestGroupName(i)]["rpcs"].removeMember("Alert");
+  }
+
+  AddTestApps(kAppsCount, &table);
+  for (size_t i = 0; i < kAppsCount; ++i) {
+    Json::Value& app = apps[TestAppId(i)];
+    app["groups"] = Json::Value(Json::arrayValue);
+    app["groups"].append("Base-4");
+    for (size_t j = 0; j < 4; ++j) {
+      app["groups"].append(TestGroupName((i * 4 + j) % kGroupsCount));
+    }
+    if (i < changes_count) {
+      app["groups"].append("Emergency-1");
+    }
+    app["nicknames"] = Json::Value(Json::arrayValue);
+    app["nicknames"].append(TestAppId(i));
+  }
+
+  PadWithMessages(kUpdateSize, &root);
+
+  json = Json::FastWriter().write(root);
+  return ::policy::BinaryMessage(json.begin(), json.end());
+}
+
+utils::SharedPtr<policy_table::Table> ParseTable(
+    const ::policy::BinaryMessage& message) {
+  Json::Value root;
+  EXPECT_TRUE(
+      Json::Reader().parse(std::string(message.begin(), message.end()), root));
+  return new policy_table::Table(&root);
+}
+
+/**
+ * Snapshot as it was made before it was shared with the cache: sections
+ * are copied to the new table, which is written through Json::Value
+ */
+void WriteCopiedSnapshot(const policy_table::Table& table,
+                         std::string* output) {
+  const policy_table::PolicyTable& pt = table.policy_table;
+  policy_table::Table snapshot;
+  snapshot.policy_table.app_policies_section = pt.app_policies_section;
+  snapshot.policy_table.functional_groupings = pt.functional_groupings;
+  snapshot.policy_table.consumer_friendly_messages->version =
+      pt.consumer_friendly_messages->version;
+  snapshot.policy_table.consumer_friendly_messages->mark_initialized();
+  snapshot.policy_table.module_config = pt.module_config;
+  snapshot.policy_table.module_meta = pt.module_meta;
+  snapshot.policy_table.usage_and_error_counts = pt.usage_and_error_counts;
+  snapshot.policy_table.device_data = pt.device_data;
+  *snapshot.policy_table.module_config.preloaded_pt = false;
+  *output = Json::FastWriter().write(snapshot.ToJsonValue());
+}
+
+typedef void (*SnapshotFunction)(const policy_table::Table& table,
+                                 std::string* output);
+
+long ReadStatusKb(const char* field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (0 == line.compare(0, strlen(field), field)) {
+      return atol(line.c_str() + strlen(field));
+    }
+  }
+  return 0;
+}
+
+/**
+ * Makes snapshot message in the child process as PTU request does it and
+ * returns growth of child peak resident memory
+ */
+long SnapshotPeakMemoryKb(SnapshotFunction write_snapshot,
+                          const policy_table::Table& table) {
+  int result_pipe[2];
+  if (0 != pipe(result_pipe)) {
+    return -1;
+  }
+  const pid_t pid = fork();
+  if (0 == pid) {
+    close(result_pipe[0]);
+    // Memory freed by parent is returned to system and peak is reset to
+    // the current size, so only memory taken by snapshot is counted
+    malloc_trim(0);
+    std::ofstream("/proc/self/clear_refs") << "5";
+    const long start_kb = ReadStatusKb("VmHWM:");
+    std::string json;
+    write_snapshot(table, &json);
+    const ::policy::BinaryMessage message(json.begin(), json.end());
+    long peak_kb = ReadStatusKb("VmHWM:") - start_kb;
+    const ssize_t written = write(result_pipe[1], &peak_kb, sizeof(peak_kb));
+    _exit(written == sizeof(peak_kb) ? 0 : 1);
+  }
+  close(result_pipe[1]);
+  long peak_kb = -1;
+  if (read(result_pipe[0], &peak_kb, sizeof(peak_kb)) != sizeof(peak_kb)) {
+    peak_kb = -1;
+  }
+  close(result_pipe[0]);
+  waitpid(pid, NULL, 0);
+  return peak_kb;
+}
+
+int64_t SnapshotTimeUs(SnapshotFunction write_snapshot,
+                       const policy_table::Table& table) {
+  const TimevalStruct start = date_time::DateTime::getCurrentTime();
+  std::string json;
+  write_snapshot(table, &json);
+  const ::policy::BinaryMessage message(json.begin(), json.end());
+  return date_time::DateTime::getuSecs(date_time::DateTime::getCurrentTime()) -
+         date_time::DateTime::getuSecs(start);
+}
+
+struct RegistrationProbe {
+  ::policy::PolicyManagerImpl* manager;
+  volatile bool stop;
+  int64_t max_latency_ms;
+};
+
+void* RegisterApplications(void* data) {
+  RegistrationProbe* probe = static_cast<RegistrationProbe*>(data);
+  size_t index = 0;
+  while (!probe->stop) {
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    probe->manager->AddApplication(TestAppId(index++ % kAppsCount));
+    const int64_t latency = date_time::DateTime::calculateTimeSpan(start);
+    if (latency > probe->max_latency_ms) {
+      probe->max_latency_ms = latency;
+    }
+  }
+  return NULL;
+}
+
+struct GroupsReader {
+  ::policy::CacheManager* cache;
+  size_t default_groups_count;
+  volatile bool stop;
+  uint32_t inconsistent_count;
+};
+
+// Application has no groups till default policy is set for it,
+// then it has groups of default policy
+void* ReadAppGroups(void* data) {
+  GroupsReader* reader = static_cast<GroupsReader*>(data);
+  while (!reader->stop) {
+    for (size_t i = 0; i < kAppsCount; ++i) {
+      ::policy::FunctionalGroupIDs groups;
+      reader->cache->GetAllAppGroups(TestAppId(i), groups);
+      if (!groups.empty() && groups.size() != reader->default_groups_count) {
+        ++reader->inconsistent_count;
+      }
+    }
+  }
+  return NULL;
+}
+
+}  // namespace
+
+class PolicyTableUpdateTest : public ::testing::Test {
+ protected:
+  void SetUp() {
+    // Makes current directory the storage folder
+    profile::Profile::instance()->config_file_name("smartDeviceLink.ini");
+    file_system::DeleteFile(kDatabaseFile);
+    manager_ = new ::policy::PolicyManagerImpl();
+    ON_CALL(listener_, GetAppName(_)).WillByDefault(Return(std::string()));
+    manager_->set_listener(&listener_);
+    ASSERT_TRUE(manager_->InitPT("sdl_preloaded_pt.json"));
+    for (size_t i = 0; i < kAppsCount; ++i) {
+      manager_->AddApplication(TestAppId(i));
+    }
+  }
+
+  void TearDown() {
+    delete manager_;
+    file_system::DeleteFile(kDatabaseFile);
+  }
+
+  /**
+   * Loads update while another thread keeps registering applications
+   * @return time of LoadPT, the longest registration is stored to blocked_ms
+   */
+  int64_t LoadWithRegistrations(const ::policy::BinaryMessage& update,
+                                int64_t* blocked_ms) {
+    RegistrationProbe probe = {manager_, false, 0};
+    pthread_t thread;
+    EXPECT_EQ(0, pthread_create(&thread, NULL, &RegisterApplications, &probe));
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    EXPECT_TRUE(manager_->LoadPT("", update));
+    const int64_t load_ms = date_time::DateTime::calculateTimeSpan(start);
+    probe.stop = true;
+    pthread_join(thread, NULL);
+    *blocked_ms = probe.max_latency_ms;
+    return load_ms;
+  }
+
+  NiceMock< ::policy::MockPolicyListener> listener_;
+  ::policy::PolicyManagerImpl* manager_;
+};
+
+TEST_F(PolicyTableUpdateTest, LoadPT_ChangedGroupsOfApp_ExpectNewGroupsApplied) {
+  int64_t blocked_ms = 0;
+  LoadWithRegistrations(BuildUpdate(0), &blocked_ms);
+  LoadWithRegistrations(BuildUpdate(1), &blocked_ms);
+
+  const ::policy::RPCParams params;
+  ::policy::CheckPermissionResult result;
+  manager_->CheckPermissions(TestAppId(0), "FULL", "GetVehicleData", params,
+                             result);
+  EXPECT_EQ(::policy::kRpcAllowed, result.hmi_level_permitted);
+
+  ::policy::CheckPermissionResult unchanged_result;
+  manager_->CheckPermissions(TestAppId(1), "FULL", "GetVehicleData", params,
+                             unchanged_result);
+  EXPECT_EQ(::policy::kRpcDisallowed, unchanged_result.hmi_level_permitted);
+
+  // Stored changes are loaded after restart
+  delete manager_;
+  manager_ = new ::policy::PolicyManagerImpl();
+  manager_->set_listener(&listener_);
+  ASSERT_TRUE(manager_->InitPT("sdl_preloaded_pt.json"));
+  ::policy::CheckPermissionResult stored_result;
+  manager_->CheckPermissions(TestAppId(0), "FULL", "GetVehicleData", params,
+                             stored_result);
+  EXPECT_EQ(::policy::kRpcAllowed, stored_result.hmi_level_permitted);
+}
+
+TEST_F(PolicyTableUpdateTest, RequestPTUpdate_ExpectSnapshotOfCurrentTable) {
+  ::policy::BinaryMessage message;
+  EXPECT_CALL(listener_, OnSnapshotCreated(_)).WillOnce(SaveArg<0>(&message));
+  ASSERT_TRUE(manager_->RequestPTUpdate());
+
+  Json::Value snapshot;
+  ASSERT_TRUE(Json::Reader().parse(std::string(message.begin(), message.end()),
+                                   snapshot));
+  const Json::Value& table = snapshot["policy_table"];
+  EXPECT_TRUE(table["app_policies"].isMember(TestAppId(0)));
+  EXPECT_TRUE(table["consumer_friendly_messages"].isMember("version"));
+  EXPECT_FALSE(table["consumer_friendly_messages"].isMember("messages"));
+  EXPECT_FALSE(table["module_config"]["preloaded_pt"].asBool());
+}
+
+TEST_F(PolicyTableUpdateTest,
+       DISABLED_Benchmark_LoadPT_2MBUpdateWith200Apps) {
+  const ::policy::BinaryMessage first = BuildUpdate(0);
+  const ::policy::BinaryMessage second = BuildUpdate(5);
+
+  int64_t first_blocked_ms = 0;
+  const int64_t first_ms = LoadWithRegistrations(first, &first_blocked_ms);
+  // Lets background backup of the first update finish, as updates
+  // come rarely
+  sleep(1);
+  int64_t second_blocked_ms = 0;
+  const int64_t second_ms = LoadWithRegistrations(second, &second_blocked_ms);
+
+  printf("%u bytes update, %u apps: first LoadPT %ld ms "
+         "(registration blocked up to %ld ms), "
+         "update with 5 apps and 5 groups changed %ld ms "
+         "(registration blocked up to %ld ms)\n",
+         static_cast<unsigned>(first.size()),
+         static_cast<unsigned>(kAppsCount), static_cast<long>(first_ms),
+         static_cast<long>(first_blocked_ms), static_cast<long>(second_ms),
+         static_cast<long>(second_blocked_ms));
+}
+
+TEST(PolicySnapshotTest, WriteSnapshot_ExpectTableWithoutMessages) {
+  const utils::SharedPtr<policy_table::Table> table =
+      ParseTable(BuildUpdate(0));
+  std::string json;
+  ::policy::WriteSnapshot(*table, &json);
+
+  Json::Value snapshot;
+  ASSERT_TRUE(Json::Reader().parse(json, snapshot));
+  const Json::Value& messages =
+      snapshot["policy_table"]["consumer_friendly_messages"];
+  EXPECT_FALSE(messages.isMember("messages"));
+  EXPECT_EQ(Json::Value(static_cast<const std::string&>(
+                table->policy_table.consumer_friendly_messages->version)),
+            messages["version"]);
+  EXPECT_EQ(Json::Value(false),
+            snapshot["policy_table"]["module_config"]["preloaded_pt"]);
+}
+
+TEST(PolicySnapshotTest, WriteSnapshot_ExpectSameTextAsForCopiedTable) {
+  const utils::SharedPtr<policy_table::Table> table =
+      ParseTable(BuildUpdate(0));
+  std::string json;
+  ::policy::WriteSnapshot(*table, &json);
+
+  std::string copied_json;
+  WriteCopiedSnapshot(*table, &copied_json);
+  EXPECT_EQ(copied_json, json);
+
+  // Preloaded table has no usage statistics and device data
+  ::policy::BinaryMessage preloaded;
+  ASSERT_TRUE(file_system::ReadBinaryFile("sdl_preloaded_pt.json", preloaded));
+  const utils::SharedPtr<policy_table::Table> preloaded_table =
+      ParseTable(preloaded);
+  json.clear();
+  ::policy::WriteSnapshot(*preloaded_table, &json);
+  copied_json.clear();
+  WriteCopiedSnapshot(*preloaded_table, &copied_json);
+  EXPECT_EQ(copied_json, json);
+}
+
+TEST(PolicySnapshotTest, WriteSnapshot_IntegerNotSet_ExpectWrittenAsZero) {
+  const utils::SharedPtr<policy_table::Table> table =
+      ParseTable(BuildUpdate(0));
+  // Application added to the cache has no memory and heart beat limits
+  const std::string app_id = TestAppId(kAppsCount);
+  policy_table::ApplicationParams& params =
+      table->policy_table.app_policies_section.apps[app_id];
+  params.groups.push_back("Base-4");
+  params.priority = policy_table::P_NONE;
+  // Statistics of the application are not counted yet
+  (*table->policy_table.usage_and_error_counts->app_level)[app_id] =
+      policy_table::AppLevel();
+
+  std::string json;
+  ::policy::WriteSnapshot(*table, &json);
+  Json::Value snapshot;
+  ASSERT_TRUE(Json::Reader().parse(json, snapshot));
+  const Json::Value& written = snapshot["policy_table"]["app_policies"][app_id];
+  EXPECT_TRUE(written.isMember("groups"));
+  EXPECT_EQ(Json::Value(0), written["memory_kb"]);
+  EXPECT_EQ(Json::Value(0), written["heart_beat_timeout_ms"]);
+  const Json::Value& counts =
+      snapshot["policy_table"]["usage_and_error_counts"];
+  EXPECT_EQ(Json::Value(0), counts["count_of_sync_reboots"]);
+  EXPECT_EQ(Json::Value(0),
+            counts["app_level"][app_id]["minutes_in_hmi_full"]);
+
+  // Snapshot used to be written from a copy of the table, copied integers
+  // are set
+  std::string copied_json;
+  WriteCopiedSnapshot(*table, &copied_json);
+  EXPECT_EQ(copied_json, json);
+}
+
+TEST(PolicySnapshotTest, IsSnapshotValid_TableWithMessages_ExpectValid) {
+  const utils::SharedPtr<policy_table::Table> table =
+      ParseTable(BuildUpdate(0));
+  table->SetPolicyTableType(policy_table::PT_SNAPSHOT);
+  // Messages are not allowed in snapshot, but they are not written to it
+  ASSERT_TRUE(
+      table->policy_table.consumer_friendly_messages->messages
+          .is_initialized());
+  EXPECT_FALSE(table->is_valid());
+  EXPECT_TRUE(::policy::IsSnapshotValid(*table));
+
+  table->policy_table.app_policies_section.apps.erase(::policy::kDefaultId);
+  EXPECT_FALSE(::policy::IsSnapshotValid(*table));
+}
+
+TEST(PolicySnapshotTest, GenerateSnapshot_TableChanged_ExpectSnapshotUnchanged) {
+  profile::Profile::instance()->config_file_name("smartDeviceLink.ini");
+  file_system::DeleteFile(kDatabaseFile);
+  {
+    ::policy::CacheManager cache;
+    ASSERT_TRUE(cache.Init("sdl_preloaded_pt.json"));
+
+    // Snapshot is shared while table is not changed
+    const utils::SharedPtr<policy_table::Table> snapshot =
+        cache.GenerateSnapshot();
+    ASSERT_TRUE(snapshot);
+    EXPECT_TRUE(snapshot.get() == cache.GenerateSnapshot().get());
+
+    EXPECT_TRUE(cache.SetDefaultPolicy(TestAppId(0)));
+    EXPECT_EQ(0u, snapshot->policy_table.app_policies_section.apps.count(
+                      TestAppId(0)));
+    const utils::SharedPtr<policy_table::Table> changed =
+        cache.GenerateSnapshot();
+    EXPECT_FALSE(snapshot.get() == changed.get());
+    EXPECT_EQ(1u, changed->policy_table.app_policies_section.apps.count(
+                      TestAppId(0)));
+    EXPECT_TRUE(cache.IsDefaultPolicy(TestAppId(0)));
+  }
+  file_system::DeleteFile(kDatabaseFile);
+}
+
+TEST(PolicySnapshotTest, ReadWhileTableChanged_ExpectConsistentTables) {
+  profile::Profile::instance()->config_file_name("smartDeviceLink.ini");
+  file_system::DeleteFile(kDatabaseFile);
+  {
+    ::policy::CacheManager cache;
+    ASSERT_TRUE(cache.Init("sdl_preloaded_pt.json"));
+    ::policy::FunctionalGroupIDs default_groups;
+    cache.GetAllAppGroups(::policy::kDefaultId, default_groups);
+    ASSERT_FALSE(default_groups.empty());
+
+    GroupsReader reader = {&cache, default_groups.size(), false, 0u};
+    pthread_t thread;
+    ASSERT_EQ(0, pthread_create(&thread, NULL, &ReadAppGroups, &reader));
+    for (size_t i = 0; i < kAppsCount; ++i) {
+      EXPECT_TRUE(cache.SetDefaultPolicy(TestAppId(i)));
+      EXPECT_TRUE(cache.SetMetaInfo("ccpu_version", "wers_country_code",
+                                    "en-us"));
+    }
+    reader.stop = true;
+    pthread_join(thread, NULL);
+    EXPECT_EQ(0u, reader.inconsistent_count);
+  }
+  file_system::DeleteFile(kDatabaseFile);
+}
+
+TEST(PolicySnapshotTest, DISABLED_Benchmark_SnapshotOf2MBTableWith200Apps) {
+  const utils::SharedPtr<policy_table::Table> table =
+      ParseTable(BuildUpdate(0));
+  const long copied_kb = SnapshotPeakMemoryKb(&WriteCopiedSnapshot, *table);
+  const long shared_kb =
+      SnapshotPeakMemoryKb(&::policy::WriteSnapshot, *table);
+  const int64_t copied_us = SnapshotTimeUs(&WriteCopiedSnapshot, *table);
+  const int64_t shared_us = SnapshotTimeUs(&::policy::WriteSnapshot, *table);
+  printf("Snapshot for PTU request: copied table written through Json::Value "
+         "%ld us, peak memory %ld KB; shared table written as stream %ld us, "
+         "peak memory %ld KB\n",
+         static_cast<long>(copied_us), copied_kb,
+         static_cast<long>(shared_us), shared_kb);
+  EXPECT_GT(copied_kb, 0);
+  EXPECT_GE(shared_kb, 0);
+}
+
+TEST(PolicyTableSaveTest, SaveChanges_FiveAppsAndGroups_ExpectOnlyThemChanged) {
+  profile::Profile::instance()->config_file_name("smartDeviceLink.ini");
+  file_system::DeleteFile(kDatabaseFile);
+  ::policy::SQLPTRepresentation reps;
+  ASSERT_EQ(::policy::SUCCESS, reps.Init());
+
+  const size_t changes_count = 5;
+  ASSERT_TRUE(reps.Save(*ParseTable(BuildUpdate(0))));
+  ::policy::PolicyTableChanges changes;
+  for (size_t i = 0; i < changes_count; ++i) {
+    changes.updated_groups.insert(TestGroupName(i));
+    changes.updated_apps.insert(TestAppId(i));
+  }
+  ASSERT_TRUE(
+      reps.SaveChanges(*ParseTable(BuildUpdate(changes_count)), changes));
+
+  policy_table::Table stored = *reps.GenerateSnapshot();
+  EXPECT_EQ(6u, stored.policy_table.app_policies_section.apps[TestAppId(0)]
+                    .groups.size());
+  EXPECT_EQ(5u, stored.policy_table.app_policies_section.apps[TestAppId(5)]
+                    .groups.size());
+  EXPECT_EQ(0u, stored.policy_table.functional_groupings[TestGroupName(0)]
+                    .rpcs.count("Alert"));
+  EXPECT_EQ(1u, stored.policy_table.functional_groupings[TestGroupName(5)]
+                    .rpcs.count("Alert"));
+
+  reps.Close();
+  file_system::DeleteFile(kDatabaseFile);
+}
+
+TEST(PolicyTableSaveTest, DISABLED_Benchmark_SaveChanges_2MBTableWith200Apps) {
+  profile::Profile::instance()->config_file_name("smartDeviceLink.ini");
+  file_system::DeleteFile(kDatabaseFile);
+  ::policy::SQLPTRepresentation reps;
+  ASSERT_EQ(::policy::SUCCESS, reps.Init());
+
+  const size_t changes_count = 5;
+  const utils::SharedPtr<policy_table::Table> table = ParseTable(BuildUpdate(0));
+  const utils::SharedPtr<policy_table::Table> changed_table =
+      ParseTable(BuildUpdate(changes_count));
+  ::policy::PolicyTableChanges changes;
+  for (size_t i = 0; i < changes_count; ++i) {
+    changes.updated_groups.insert(TestGroupName(i));
+    changes.updated_apps.insert(TestAppId(i));
+  }
+
+  TimevalStruct start = date_time::DateTime::getCurrentTime();
+  ASSERT_TRUE(reps.Save(*table));
+  const int64_t save_ms = date_time::DateTime::calculateTimeSpan(start);
+
+  start = date_time::DateTime::getCurrentTime();
+  ASSERT_TRUE(reps.SaveChanges(*changed_table, changes));
+  const int64_t save_changes_ms = date_time::DateTime::calculateTimeSpan(start);
+
+  ::policy::PolicyTableChanges all_changes;
+  all_changes.is_messages_changed = true;
+  policy_table::FunctionalGroupings::const_iterator group =
+      table->policy_table.functional_groupings.begin();
+  for (; table->policy_table.functional_groupings.end() != group; ++group) {
+    all_changes.updated_groups.insert(group->first);
+  }
+  policy_table::ApplicationPolicies::const_iterator app =
+      table->policy_table.app_policies_section.apps.begin();
+  for (; table->policy_table.app_policies_section.apps.end() != app; ++app) {
+    all_changes.updated_apps.insert(app->first);
+  }
+  start = date_time::DateTime::getCurrentTime();
+  ASSERT_TRUE(reps.SaveChanges(*table, all_changes));
+  const int64_t save_all_changes_ms =
+      date_time::DateTime::calculateTimeSpan(start);
+
+  printf("Save of whole table %ld ms, of 5 apps and 5 groups %ld ms, "
+         "of all groups, apps and messages as changes %ld ms\n",
+         static_cast<long>(save_ms), static_cast<long>(save_changes_ms),
+         static_cast<long>(save_all_changes_ms));
+
+  reps.Close();
+  file_system::DeleteFile(kDatabaseFile);
+}
+
+}  // namespace policy
+}  // namespace components
+}  // namespace test
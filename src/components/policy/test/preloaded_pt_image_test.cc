@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "config_profile/profile.h"
+#include "json/writer.h"
+#include "mock_policy_listener.h"
+#include "policy/policy_manager_impl.h"
+#include "policy/preloaded_pt_image.h"
+#include "policy/sql_pt_representation.h"
+#include "rpc_base/json_stream_reader.h"
+#include "utils/date_time.h"
+#include "utils/file_system.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::_;
+
+namespace test {
+namespace components {
+namespace policy {
+
+namespace {
+
+const std::string kDatabaseFile = "policy.sqlite";
+const std::string kPreloadedFile = "preloaded_pt_image_test.json";
+const std::string kImageFile = "preloaded_pt_image_test.img";
+const std::string kAppId = "new_app";
+const std::string kLockScreenIconUrl = "http://example.com/lock_screen.png";
+const size_t kStartsCount = 5;
+
+::policy::BinaryMessage ReadFile(const std::string& file_name) {
+  ::policy::BinaryMessage data;
+  EXPECT_TRUE(file_system::ReadBinaryFile(file_name, data));
+  return data;
+}
+
+utils::SharedPtr<policy_table::Table> ParseTable(
+    const ::policy::BinaryMessage& json) {
+  const char* begin = reinterpret_cast<const char*>(&json[0]);
+  rpc::JsonStreamReader reader(begin, begin + json.size());
+  utils::SharedPtr<policy_table::Table> table =
+      new policy_table::Table(&reader);
+  EXPECT_FALSE(reader.has_failed());
+  return table;
+}
+
+std::string ToString(const policy_table::Table& table) {
+  return Json::StyledWriter().write(table.ToJsonValue());
+}
+
+}  // namespace
+
+class PreloadedPTImageTest : public ::testing::Test {
+ protected:
+  void SetUp() {
+    // Makes current directory the storage folder
+    profile::Profile::instance()->config_file_name("smartDeviceLink.ini");
+    file_system::DeleteFile(kDatabaseFile);
+    file_system::DeleteFile(kImageFile);
+    source_ = ReadFile("sdl_preloaded_pt.json");
+    ASSERT_TRUE(file_system::WriteBinaryFile(kPreloadedFile, source_));
+    ON_CALL(listener_, GetAppName(_)).WillByDefault(Return(std::string()));
+  }
+
+  void TearDown() {
+    file_system::DeleteFile(kDatabaseFile);
+    file_system::DeleteFile(kImageFile);
+    file_system::DeleteFile(kPreloadedFile);
+  }
+
+  /**
+   * Table which differs from the preloaded one in permissions of default
+   * application, so it is seen which of them is loaded
+   */
+  utils::SharedPtr<policy_table::Table> ChangedTable() {
+    utils::SharedPtr<policy_table::Table> table = ParseTable(source_);
+    table->policy_table.functional_groupings["Base-4"].rpcs.erase(
+        "AddCommand");
+    table->policy_table.module_config.endpoints["lock_screen_icon_url"]
+        [::policy::kDefaultId].push_back(kLockScreenIconUrl);
+    return table;
+  }
+
+  ::policy::PolicyManagerImpl* StartManager() {
+    ::policy::PolicyManagerImpl* manager = new ::policy::PolicyManagerImpl();
+    manager->set_listener(&listener_);
+    EXPECT_TRUE(manager->InitPT(kPreloadedFile));
+    manager->AddApplication(kAppId);
+    return manager;
+  }
+
+  ::policy::PermitResult AddCommandPermission(
+      ::policy::PolicyManagerImpl* manager) {
+    ::policy::CheckPermissionResult result;
+    manager->CheckPermissions(kAppId, "FULL", "AddCommand",
+                              ::policy::RPCParams(), result);
+    return result.hmi_level_permitted;
+  }
+
+  /**
+   * Measures first start of SDL with empty database, up to permissions
+   * check of the first registered application
+   * @return the shortest time of kStartsCount starts in microseconds
+   */
+  int64_t TimeToFirstRegistration() {
+    int64_t min_time = 0;
+    for (size_t i = 0; i < kStartsCount; ++i) {
+      file_system::DeleteFile(kDatabaseFile);
+      const TimevalStruct start = date_time::DateTime::getCurrentTime();
+      ::policy::PolicyManagerImpl* manager = StartManager();
+      EXPECT_EQ(::policy::kRpcAllowed, AddCommandPermission(manager));
+      const int64_t time =
+          date_time::DateTime::getuSecs(date_time::DateTime::getCurrentTime()) -
+          date_time::DateTime::getuSecs(start);
+      delete manager;
+      if (0 == i || time < min_time) {
+        min_time = time;
+      }
+    }
+    return min_time;
+  }
+
+  ::policy::BinaryMessage source_;
+  NiceMock< ::policy::MockPolicyListener> listener_;
+};
+
+TEST_F(PreloadedPTImageTest, ImageFileName_ExpectJsonExtensionReplaced) {
+  EXPECT_EQ("dir/sdl_preloaded_pt.img",
+            ::policy::PreloadedPTImage::ImageFileName(
+                "dir/sdl_preloaded_pt.json"));
+  EXPECT_EQ("sdl_preloaded_pt.img",
+            ::policy::PreloadedPTImage::ImageFileName("sdl_preloaded_pt"));
+}
+
+TEST_F(PreloadedPTImageTest, ReadTable_ExpectSameTableAsPreloadedFile) {
+  const utils::SharedPtr<policy_table::Table> table = ParseTable(source_);
+  ASSERT_TRUE(::policy::PreloadedPTImage::Write(*table, source_, kImageFile));
+
+  ::policy::PreloadedPTImage image;
+  ASSERT_TRUE(image.Open(kImageFile));
+  EXPECT_TRUE(image.IsMadeFrom(source_));
+  const utils::SharedPtr<policy_table::Table> image_table = image.ReadTable();
+  ASSERT_TRUE(image_table);
+  EXPECT_TRUE(image_table->is_valid());
+  EXPECT_EQ(ToString(*table), ToString(*image_table));
+}
+
+TEST_F(PreloadedPTImageTest, Open_DamagedImage_ExpectFalse) {
+  ASSERT_TRUE(::policy::PreloadedPTImage::Write(*ParseTable(source_), source_,
+                                                kImageFile));
+  const ::policy::BinaryMessage image_data = ReadFile(kImageFile);
+  ::policy::PreloadedPTImage image;
+
+  ::policy::BinaryMessage changed_payload = image_data;
+  changed_payload[changed_payload.size() / 2] ^= 1;
+  ASSERT_TRUE(file_system::WriteBinaryFile(kImageFile, changed_payload));
+  EXPECT_FALSE(image.Open(kImageFile));
+
+  ::policy::BinaryMessage changed_version = image_data;
+  // Format version follows 8 bytes of magic
+  changed_version[8] = ::policy::PreloadedPTImage::kFormatVersion + 1;
+  ASSERT_TRUE(file_system::WriteBinaryFile(kImageFile, changed_version));
+  EXPECT_FALSE(image.Open(kImageFile));
+
+  const ::policy::BinaryMessage truncated(image_data.begin(),
+                                          image_data.end() - 1);
+  ASSERT_TRUE(file_system::WriteBinaryFile(kImageFile, truncated));
+  EXPECT_FALSE(image.Open(kImageFile));
+  EXPECT_FALSE(image.ReadTable());
+
+  ASSERT_TRUE(file_system::WriteBinaryFile(kImageFile, image_data));
+  ASSERT_TRUE(image.Open(kImageFile));
+  ::policy::BinaryMessage changed_source = source_;
+  changed_source.push_back('\n');
+  EXPECT_FALSE(image.IsMadeFrom(changed_source));
+}
+
+TEST_F(PreloadedPTImageTest, InitPT_ImageOfPreloadedFile_ExpectImageLoaded) {
+  ASSERT_TRUE(
+      ::policy::PreloadedPTImage::Write(*ChangedTable(), source_, kImageFile));
+
+  ::policy::PolicyManagerImpl* manager = StartManager();
+  EXPECT_EQ(::policy::kRpcDisallowed, AddCommandPermission(manager));
+  // Served from the cache or from database, whether it is filled already
+  EXPECT_EQ(kLockScreenIconUrl, manager->GetLockScreenIconUrl());
+  delete manager;
+
+  // Table is loaded from database or from image again, if it was not
+  // stored before stop
+  manager = StartManager();
+  EXPECT_EQ(::policy::kRpcDisallowed, AddCommandPermission(manager));
+  EXPECT_EQ(kLockScreenIconUrl, manager->GetLockScreenIconUrl());
+  delete manager;
+}
+
+TEST_F(PreloadedPTImageTest, InitPT_NoImage_ExpectPreloadedFileLoaded) {
+  const std::string json = ToString(*ChangedTable());
+  ASSERT_TRUE(file_system::WriteBinaryFile(
+      kPreloadedFile, ::policy::BinaryMessage(json.begin(), json.end())));
+
+  ::policy::PolicyManagerImpl* manager = StartManager();
+  EXPECT_EQ(::policy::kRpcDisallowed, AddCommandPermission(manager));
+  EXPECT_EQ(kLockScreenIconUrl, manager->GetLockScreenIconUrl());
+  delete manager;
+
+  // Table is loaded from database or from preloaded file again, if it was
+  // not stored before stop
+  manager = StartManager();
+  EXPECT_EQ(::policy::kRpcDisallowed, AddCommandPermission(manager));
+  EXPECT_EQ(kLockScreenIconUrl, manager->GetLockScreenIconUrl());
+  delete manager;
+}
+
+TEST_F(PreloadedPTImageTest, InitPT_OutdatedImage_ExpectPreloadedFileLoaded) {
+  ::policy::BinaryMessage changed_source = source_;
+  changed_source.push_back('\n');
+  ASSERT_TRUE(::policy::PreloadedPTImage::Write(*ChangedTable(),
+                                                changed_source, kImageFile));
+
+  ::policy::PolicyManagerImpl* manager = StartManager();
+  EXPECT_EQ(::policy::kRpcAllowed, AddCommandPermission(manager));
+  delete manager;
+}
+
+TEST_F(PreloadedPTImageTest, SaveIsFirstRun_ExpectTableLoadedAgainOnInit) {
+  ::policy::SQLPTRepresentation reps;
+  ASSERT_EQ(::policy::SUCCESS, reps.Init());
+  reps.SaveIsFirstRun(true);
+  ASSERT_TRUE(reps.Close());
+
+  ::policy::SQLPTRepresentation restarted;
+  EXPECT_EQ(::policy::SUCCESS, restarted.Init());
+  ASSERT_TRUE(restarted.Close());
+
+  ::policy::SQLPTRepresentation restarted_again;
+  EXPECT_EQ(::policy::EXISTS, restarted_again.Init());
+  ASSERT_TRUE(restarted_again.Close());
+}
+
+TEST_F(PreloadedPTImageTest, DISABLED_Benchmark_TimeToFirstRegistration) {
+  const int64_t json_time = TimeToFirstRegistration();
+  ASSERT_TRUE(::policy::PreloadedPTImage::Write(*ParseTable(source_), source_,
+                                                kImageFile));
+  const int64_t image_time = TimeToFirstRegistration();
+
+  printf("Time to first registration on first start, %u bytes preloaded PT: "
+         "json file %ld us, image %ld us\n",
+         static_cast<unsigned>(source_.size()), static_cast<long>(json_time),
+         static_cast<long>(image_time));
+}
+
+}  // namespace policy
+}  // namespace components
+}  // namespace test
@@ -34,6 +34,7 @@
 #include "driver_dbms.h"
 #include "policy/sql_pt_representation.h"
 #include "policy/policy_types.h"
+#include "usage_statistics/statistics_aggregator.h"
 #include "json/writer.h"
 #include "json/reader.h"
 
@@ -599,6 +600,108 @@ TEST_F(SQLPTRepresentationTest,
             snapshot->ToJsonValue().toStyledString());
 }
 
+TEST_F(SQLPTRepresentationTest,
+       SaveStatistics_SaveTwice_ExpectValuesAddedToStoredOnes) {
+  // Arrange
+  ASSERT_TRUE(dbms->Exec("DELETE FROM `app_level`"));
+  ASSERT_TRUE(dbms->Exec(
+      "UPDATE `usage_and_error_count` SET `count_of_sync_reboots` = 1"));
+  usage_statistics::Statistics statistics;
+  statistics.global_counters[usage_statistics::SYNC_REBOOTS] = 2;
+  usage_statistics::AppStatistics& app = statistics.apps["12345"];
+  app.counters[usage_statistics::USER_SELECTIONS] = 3;
+  app.counters[usage_statistics::RUN_ATTEMPTS_WHILE_REVOKED] = 1;
+  app.stopwatches[usage_statistics::SECONDS_HMI_FULL] = 5;
+  app.infos[usage_statistics::LANGUAGE_GUI] = "EN-US";
+
+  // Act
+  ASSERT_TRUE(reps->SaveStatistics(statistics));
+  app.infos[usage_statistics::LANGUAGE_GUI].clear();
+  app.infos[usage_statistics::LANGUAGE_VUI] = "DE-DE";
+  ASSERT_TRUE(reps->SaveStatistics(statistics));
+
+  // Assert
+  EXPECT_EQ(5, dbms->FetchOneInt(
+      "SELECT `count_of_sync_reboots` FROM `usage_and_error_count`"));
+  EXPECT_EQ(0, dbms->FetchOneInt(
+      "SELECT `count_of_iap_buffer_full` FROM `usage_and_error_count`"));
+  EXPECT_EQ(6, dbms->FetchOneInt(
+      "SELECT `count_of_user_selections` FROM `app_level` "
+      "WHERE `application_id` = '12345'"));
+  EXPECT_EQ(2, dbms->FetchOneInt(
+      "SELECT `count_of_run_attempts_while_revoked` FROM `app_level` "
+      "WHERE `application_id` = '12345'"));
+  EXPECT_EQ(10, dbms->FetchOneInt(
+      "SELECT `minutes_in_hmi_full` FROM `app_level` "
+      "WHERE `application_id` = '12345'"));
+  EXPECT_EQ("EN-US", dbms->FetchOneString(
+      "SELECT `app_registration_language_gui` FROM `app_level` "
+      "WHERE `application_id` = '12345'"));
+  EXPECT_EQ("DE-DE", dbms->FetchOneString(
+      "SELECT `app_registration_language_vui` FROM `app_level` "
+      "WHERE `application_id` = '12345'"));
+}
+
+TEST_F(SQLPTRepresentationTest,
+       GenerateSnapshot_AfterSaveStatistics_ExpectCountersGathered) {
+  // Arrange
+  ASSERT_TRUE(dbms->Exec("DELETE FROM `app_level`"));
+  ASSERT_TRUE(dbms->Exec(
+      "UPDATE `usage_and_error_count` SET `count_of_sync_reboots` = 1"));
+  usage_statistics::Statistics statistics;
+  statistics.global_counters[usage_statistics::SYNC_REBOOTS] = 2;
+  usage_statistics::AppStatistics& app = statistics.apps["1234"];
+  app.counters[usage_statistics::REJECTED_RPC_CALLS] = 7;
+  app.stopwatches[usage_statistics::SECONDS_HMI_NONE] = 4;
+  app.infos[usage_statistics::LANGUAGE_VUI] = "DE-DE";
+  ASSERT_TRUE(reps->SaveStatistics(statistics));
+
+  // Act
+  utils::SharedPtr<policy_table::Table> snapshot = reps->GenerateSnapshot();
+
+  // Assert
+  const policy_table::UsageAndErrorCounts& counts =
+      *snapshot->policy_table.usage_and_error_counts;
+  EXPECT_EQ(3, static_cast<int64_t>(*counts.count_of_sync_reboots));
+  policy_table::AppLevels::const_iterator level =
+      counts.app_level->find("1234");
+  ASSERT_TRUE(counts.app_level->end() != level);
+  EXPECT_EQ(7,
+            static_cast<int64_t>(*level->second.count_of_rejected_rpc_calls));
+  EXPECT_EQ(4, static_cast<int64_t>(*level->second.minutes_in_hmi_none));
+  EXPECT_EQ("DE-DE", static_cast<const std::string&>(
+                         *level->second.app_registration_language_vui));
+  EXPECT_FALSE(level->second.app_registration_language_gui.is_initialized());
+}
+
+TEST_F(SQLPTRepresentationTest,
+       Save_GeneratedSnapshot_ExpectCountersKeptAndRemovedAppsDeleted) {
+  // Arrange
+  ASSERT_TRUE(dbms->Exec("DELETE FROM `app_level`"));
+  usage_statistics::Statistics statistics;
+  statistics.apps["1234"].counters[usage_statistics::REJECTED_RPC_CALLS] = 7;
+  statistics.apps["5678"].counters[usage_statistics::USER_SELECTIONS] = 1;
+  ASSERT_TRUE(reps->SaveStatistics(statistics));
+
+  Json::Value table(Json::objectValue);
+  PolicyTableUpdatePrepare(table);
+  policy_table::Table update(&table);
+  utils::SharedPtr<policy_table::Table> snapshot = reps->GenerateSnapshot();
+  update.policy_table.usage_and_error_counts =
+      snapshot->policy_table.usage_and_error_counts;
+  update.policy_table.usage_and_error_counts->app_level->erase("5678");
+
+  // Act
+  ASSERT_TRUE(reps->Save(update));
+
+  // Assert
+  EXPECT_EQ(7, dbms->FetchOneInt(
+      "SELECT `count_of_rejected_rpcs_calls` FROM `app_level` "
+      "WHERE `application_id` = '1234'"));
+  EXPECT_EQ(0, dbms->FetchOneInt(
+      "SELECT COUNT(*) FROM `app_level` WHERE `application_id` = '5678'"));
+}
+
 }  // namespace policy
 }  // namespace components
 }  // namespace test
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "usage_statistics/statistics_aggregator.h"
+#include "utils/date_time.h"
+#include "utils/lock.h"
+
+namespace usage_statistics {
+namespace test {
+
+TEST(StatisticsAggregatorTest, Collect_AfterChanges_ExpectAllValues) {
+  StatisticsAggregator aggregator;
+  aggregator.Increment(SYNC_REBOOTS);
+  aggregator.Increment(SYNC_REBOOTS);
+  aggregator.Increment("HelloApp", USER_SELECTIONS);
+  aggregator.Add("HelloApp", SECONDS_HMI_FULL, 30);
+  aggregator.Add("HelloApp", SECONDS_HMI_FULL, 45);
+  aggregator.Set("OtherApp", LANGUAGE_GUI, "EN-US");
+
+  Statistics statistics;
+  aggregator.Collect(&statistics);
+
+  EXPECT_EQ(2u, statistics.global_counters[SYNC_REBOOTS]);
+  EXPECT_EQ(0u, statistics.global_counters[IAP_BUFFER_FULL]);
+  ASSERT_EQ(2u, statistics.apps.size());
+  EXPECT_EQ(1u, statistics.apps["HelloApp"].counters[USER_SELECTIONS]);
+  EXPECT_EQ(75u, statistics.apps["HelloApp"].stopwatches[SECONDS_HMI_FULL]);
+  EXPECT_EQ("EN-US", statistics.apps["OtherApp"].infos[LANGUAGE_GUI]);
+  EXPECT_TRUE(statistics.apps["OtherApp"].infos[LANGUAGE_VUI].empty());
+}
+
+TEST(StatisticsAggregatorTest, Collect_Twice_ExpectSecondIsEmpty) {
+  StatisticsAggregator aggregator;
+  aggregator.Increment(IAP_BUFFER_FULL);
+  aggregator.Increment("HelloApp", REJECTED_RPC_CALLS);
+  aggregator.Set("HelloApp", LANGUAGE_VUI, "DE-DE");
+  aggregator.Add("HelloApp", SECONDS_HMI_NONE, -5);
+
+  Statistics statistics;
+  aggregator.Collect(&statistics);
+  EXPECT_FALSE(statistics.empty());
+
+  aggregator.Collect(&statistics);
+  EXPECT_TRUE(statistics.empty());
+}
+
+TEST(StatisticsAggregatorTest, Restore_AfterNewChanges_ExpectSumAndNewerInfo) {
+  StatisticsAggregator aggregator;
+  aggregator.Increment("HelloApp", RPCS_IN_HMI_NONE);
+  aggregator.Set("HelloApp", LANGUAGE_GUI, "EN-US");
+  aggregator.Set("HelloApp", LANGUAGE_VUI, "EN-US");
+  Statistics collected;
+  aggregator.Collect(&collected);
+
+  aggregator.Increment("HelloApp", RPCS_IN_HMI_NONE);
+  aggregator.Set("HelloApp", LANGUAGE_GUI, "FR-FR");
+  aggregator.Restore(collected);
+
+  Statistics statistics;
+  aggregator.Collect(&statistics);
+  EXPECT_EQ(2u, statistics.apps["HelloApp"].counters[RPCS_IN_HMI_NONE]);
+  EXPECT_EQ("FR-FR", statistics.apps["HelloApp"].infos[LANGUAGE_GUI]);
+  EXPECT_EQ("EN-US", statistics.apps["HelloApp"].infos[LANGUAGE_VUI]);
+}
+
+namespace {
+
+const uint32_t kIncrementsPerThread = 200000;
+const char* const kAppIds[] = {"app_1", "app_2", "app_3", "app_4"};
+const size_t kAppIdsCount = sizeof(kAppIds) / sizeof(kAppIds[0]);
+
+/**
+ * Keeps counters in a map under one lock,
+ * the way a straightforward statistics manager would do.
+ */
+class LockedStatisticsManager : public StatisticsManager {
+ public:
+  void Increment(GlobalCounterId type) {
+    sync_primitives::AutoLock lock(lock_);
+    ++global_counters_[type];
+  }
+  void Increment(const std::string& app_id, AppCounterId type) {
+    sync_primitives::AutoLock lock(lock_);
+    ++apps_[app_id].counters[type];
+  }
+  void Set(const std::string& app_id, AppInfoId type,
+           const std::string& value) {
+    sync_primitives::AutoLock lock(lock_);
+    apps_[app_id].infos[type] = value;
+  }
+  void Add(const std::string& app_id, AppStopwatchId type,
+           int32_t timespan_seconds) {
+    sync_primitives::AutoLock lock(lock_);
+    apps_[app_id].stopwatches[type] += timespan_seconds;
+  }
+
+ private:
+  std::map<GlobalCounterId, uint32_t> global_counters_;
+  AppStatisticsMap apps_;
+  sync_primitives::Lock lock_;
+};
+
+struct Worker {
+  StatisticsManager* manager;
+  size_t index;
+};
+
+void* IncrementCounters(void* data) {
+  Worker* worker = static_cast<Worker*>(data);
+  const std::string app_id = kAppIds[worker->index % kAppIdsCount];
+  for (uint32_t i = 0; i < kIncrementsPerThread; ++i) {
+    if (i % 8) {
+      worker->manager->Increment(app_id, REJECTED_RPC_CALLS);
+    } else {
+      worker->manager->Increment(IAP_BUFFER_FULL);
+    }
+  }
+  return NULL;
+}
+
+const uint32_t kNewAppsPerThread = 100;
+const uint32_t kIncrementsPerNewApp = 50;
+
+// Every thread meets its own new applications, so maps of slots are
+// replaced while other threads look them up
+void* IncrementNewApps(void* data) {
+  Worker* worker = static_cast<Worker*>(data);
+  char app_id[32];
+  for (uint32_t i = 0; i < kNewAppsPerThread; ++i) {
+    snprintf(app_id, sizeof(app_id), "app_%u_%u",
+             static_cast<unsigned>(worker->index), i);
+    for (uint32_t j = 0; j < kIncrementsPerNewApp; ++j) {
+      worker->manager->Increment(app_id, USER_SELECTIONS);
+    }
+  }
+  return NULL;
+}
+
+int64_t RunWorkers(StatisticsManager* manager, size_t threads_count,
+                   void* (*routine)(void*) = &IncrementCounters) {
+  std::vector<pthread_t> threads(threads_count);
+  std::vector<Worker> workers(threads_count);
+  const TimevalStruct start = date_time::DateTime::getCurrentTime();
+  for (size_t i = 0; i < threads_count; ++i) {
+    workers[i].manager = manager;
+    workers[i].index = i;
+    EXPECT_EQ(0, pthread_create(&threads[i], NULL,
+                                routine, &workers[i]));
+  }
+  for (size_t i = 0; i < threads_count; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+  return date_time::DateTime::calculateTimeSpan(start);
+}
+
+}  // namespace
+
+TEST(StatisticsAggregatorTest, Increment_FromManyThreads_ExpectNothingLost) {
+  const size_t threads_count = 8;
+  StatisticsAggregator aggregator;
+  RunWorkers(&aggregator, threads_count);
+
+  Statistics statistics;
+  aggregator.Collect(&statistics);
+  uint32_t app_counters = 0;
+  for (AppStatisticsMap::const_iterator it = statistics.apps.begin();
+       it != statistics.apps.end(); ++it) {
+    app_counters += it->second.counters[REJECTED_RPC_CALLS];
+  }
+  const uint32_t global_per_thread = (kIncrementsPerThread + 7) / 8;
+  EXPECT_EQ(threads_count * global_per_thread,
+            statistics.global_counters[IAP_BUFFER_FULL]);
+  EXPECT_EQ(threads_count * (kIncrementsPerThread - global_per_thread),
+            app_counters);
+}
+
+TEST(StatisticsAggregatorTest, Increment_NewAppsFromManyThreads_ExpectAllKept) {
+  const size_t threads_count = 8;
+  StatisticsAggregator aggregator;
+  RunWorkers(&aggregator, threads_count, &IncrementNewApps);
+
+  Statistics statistics;
+  aggregator.Collect(&statistics);
+  ASSERT_EQ(threads_count * kNewAppsPerThread, statistics.apps.size());
+  for (AppStatisticsMap::const_iterator it = statistics.apps.begin();
+       it != statistics.apps.end(); ++it) {
+    EXPECT_EQ(kIncrementsPerNewApp, it->second.counters[USER_SELECTIONS]);
+  }
+}
+
+TEST(StatisticsAggregatorTest,
+     DISABLED_Benchmark_IncrementsPerSecondUnderContention) {
+  const size_t threads_counts[] = {1, 4, 8};
+  for (size_t i = 0; i < sizeof(threads_counts) / sizeof(threads_counts[0]);
+       ++i) {
+    const size_t threads_count = threads_counts[i];
+    const double increments = 1.0 * threads_count * kIncrementsPerThread;
+
+    LockedStatisticsManager locked;
+    const int64_t locked_ms = RunWorkers(&locked, threads_count);
+    StatisticsAggregator aggregator;
+    const int64_t aggregator_ms = RunWorkers(&aggregator, threads_count);
+
+    printf("%u threads: single lock %.1f M/s (%ld ms), "
+           "aggregator %.1f M/s (%ld ms)\n",
+           static_cast<unsigned>(threads_count),
+           increments / 1000 / (locked_ms ? locked_ms : 1),
+           static_cast<long>(locked_ms),
+           increments / 1000 / (aggregator_ms ? aggregator_ms : 1),
+           static_cast<long>(aggregator_ms));
+  }
+}
+
+}  // namespace test
+}  // namespace usage_statistics
@@ -34,6 +34,8 @@
 
 #include <memory.h>
 
+#include "utils/memory_pool.h"
+
 namespace protocol_handler {
 
 RawMessage::RawMessage(uint32_t connection_key, uint32_t protocol_version,
@@ -41,19 +43,57 @@ RawMessage::RawMessage(uint32_t connection_key, uint32_t protocol_version,
                        uint8_t type, uint32_t payload_size)
   : connection_key_(connection_key),
     data_(NULL),
+    shared_payload_(),
     data_size_(data_sz),
     protocol_version_(protocol_version),
     service_type_(ServiceTypeFromByte(type)),
     payload_size_(payload_size),
     waiting_(false) {
   if (data_param && data_sz > 0) {
-    data_ = new uint8_t[data_sz];
-    memcpy(data_, data_param, sizeof(*data_) * data_sz);
+    data_ = static_cast<uint8_t*>(utils::MemoryPool::Allocate(data_sz));
+    if (!data_) {
+      data_size_ = 0;
+    } else {
+      memcpy(data_, data_param, sizeof(*data_) * data_sz);
+    }
+  }
+}
+
+RawMessage* RawMessage::CreateUninitialized(uint32_t connection_key,
+                                            uint32_t protocol_version,
+                                            uint32_t data_size,
+                                            uint8_t type) {
+  RawMessage* message =
+      new RawMessage(connection_key, protocol_version, NULL, 0, type);
+  if (data_size > 0) {
+    message->data_ =
+        static_cast<uint8_t*>(utils::MemoryPool::Allocate(data_size));
+    message->data_size_ = message->data_ ? data_size : 0;
+  }
+  return message;
+}
+
+RawMessage::RawMessage(uint32_t connection_key, uint32_t protocol_version,
+                       const SharedPayload& payload, uint8_t type)
+  : connection_key_(connection_key),
+    data_(NULL),
+    shared_payload_(payload),
+    data_size_(0),
+    protocol_version_(protocol_version),
+    service_type_(ServiceTypeFromByte(type)),
+    payload_size_(0),
+    waiting_(false) {
+  if (payload && !payload->empty()) {
+    data_ = &payload->front();
+    data_size_ = payload->size();
+    payload_size_ = data_size_;
   }
 }
 
 RawMessage::~RawMessage() {
-  delete[] data_;
+  if (!shared_payload_) {
+    utils::MemoryPool::Release(data_);
+  }
 }
 
 uint32_t RawMessage::connection_key() const {
@@ -76,6 +116,12 @@ size_t RawMessage::data_size() const {
   return data_size_;
 }
 
+void RawMessage::Truncate(size_t data_size) {
+  if (data_size < data_size_) {
+    data_size_ = data_size;
+  }
+}
+
 uint32_t RawMessage::protocol_version() const {
   return protocol_version_;
 }
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_PROTOCOL_HANDLER_INCLUDE_PROTOCOL_HANDLER_HEADER_LAYOUT_H_
+#define SRC_COMPONENTS_PROTOCOL_HANDLER_INCLUDE_PROTOCOL_HANDLER_HEADER_LAYOUT_H_
+
+#include <stdint.h>
+#include <cstddef>
+
+#include "protocol/common.h"
+
+namespace protocol_handler {
+
+/**
+ * \brief Reads big-endian 32 bit value byte per byte,
+ * so data does not need 4-byte alignment
+ */
+inline uint32_t ReadBigEndian32(const uint8_t *data) {
+  return (static_cast<uint32_t>(data[0]) << 24) |
+         (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) |
+          static_cast<uint32_t>(data[3]);
+}
+
+/**
+ * \brief Writes 32 bit value in big-endian order byte per byte
+ */
+inline void WriteBigEndian32(uint8_t *data, const uint32_t value) {
+  data[0] = static_cast<uint8_t>(value >> 24);
+  data[1] = static_cast<uint8_t>(value >> 16);
+  data[2] = static_cast<uint8_t>(value >> 8);
+  data[3] = static_cast<uint8_t>(value);
+}
+
+/**
+ * \brief Compile-time layout of frame header of protocol version.
+ * Versions 2-4 share layout of version 2, version 1 has no message id.
+ */
+template <uint8_t Version>
+struct FrameHeaderLayout {
+  enum {
+    kFlagsOffset = 0,
+    kServiceTypeOffset = 1,
+    kFrameDataOffset = 2,
+    kSessionIdOffset = 3,
+    kDataSizeOffset = 4,
+    kMessageIdOffset = 8,
+    kSize = PROTOCOL_HEADER_V2_SIZE
+  };
+};
+
+template <>
+struct FrameHeaderLayout<PROTOCOL_VERSION_1> {
+  enum {
+    kFlagsOffset = 0,
+    kServiceTypeOffset = 1,
+    kFrameDataOffset = 2,
+    kSessionIdOffset = 3,
+    kDataSizeOffset = 4,
+    kSize = PROTOCOL_HEADER_V1_SIZE
+  };
+};
+
+typedef FrameHeaderLayout<PROTOCOL_VERSION_1> FrameHeaderLayoutV1;
+typedef FrameHeaderLayout<PROTOCOL_VERSION_2> FrameHeaderLayoutV2;
+
+/**
+ * \brief Bit layout of first frame header byte
+ */
+struct FrameFlagsLayout {
+  enum {
+    kVersionShift = 4,
+    kProtectionMask = 0x08,
+    kFrameTypeMask = 0x07
+  };
+};
+
+/**
+ * \brief Size of frame header written for protocol version.
+ * Every version except 1 is written with message id.
+ */
+inline size_t FrameHeaderSize(const uint8_t version) {
+  return FrameHeaderLayoutV1::kSize +
+      static_cast<size_t>(version != PROTOCOL_VERSION_1) *
+      (FrameHeaderLayoutV2::kSize - FrameHeaderLayoutV1::kSize);
+}
+
+/**
+ * \brief Whether message id is read from frame header of protocol version
+ */
+inline bool HasMessageId(const uint8_t version) {
+  return static_cast<uint8_t>(version - PROTOCOL_VERSION_2) <=
+      PROTOCOL_VERSION_4 - PROTOCOL_VERSION_2;
+}
+
+/**
+ * \brief Compile-time layout of protocol payload binary header
+ * (RPC type, function id, correlation id and json size)
+ */
+struct PayloadHeaderLayout {
+  enum {
+    kRpcTypeOffset = 0,
+    kFunctionIdOffset = 0,
+    kCorrelationIdOffset = 4,
+    kJsonSizeOffset = 8,
+    kSize = 12,
+    kRpcTypeShift = 28
+  };
+  static const uint32_t kFunctionIdMask = 0x0FFFFFFFu;
+};
+
+}  // namespace protocol_handler
+
+#endif  // SRC_COMPONENTS_PROTOCOL_HANDLER_INCLUDE_PROTOCOL_HANDLER_HEADER_LAYOUT_H_
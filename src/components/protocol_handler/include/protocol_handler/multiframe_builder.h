@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef SRC_COMPONENTS_PROTOCOL_HANDLER_INCLUDE_PROTOCOL_HANDLER_MULTIFRAME_BUILDER_H_
+#define SRC_COMPONENTS_PROTOCOL_HANDLER_INCLUDE_PROTOCOL_HANDLER_MULTIFRAME_BUILDER_H_
+
+#include <map>
+#include <utility>
+#include <vector>
+#include "utils/macro.h"
+#include "utils/lock.h"
+#include "utils/date_time.h"
+#include "utils/shared_ptr.h"
+#include "protocol/raw_message.h"
+#include "protocol_handler/protocol_packet.h"
+
+namespace protocol_handler {
+
+/**
+ * \class MultiFrameBuilder
+ * \brief Reassembles multiframe messages from first and consecutive frames.
+ * Buffer of message is sized by total size of the first frame and drawn
+ * from a pool; memory of incomplete messages is limited per connection
+ * and in total, messages waiting for a next frame too long are dropped.
+ * MultiFrameBuilder methods are thread-safe
+ */
+class MultiFrameBuilder {
+ public:
+  /**
+   * \brief Constructor
+   * \param connection_buffer_size Maximum size of incomplete messages
+   * of one connection in bytes
+   * \param total_buffer_size Maximum size of all incomplete messages in bytes
+   * \param waiting_timeout Time in milliseconds to wait for a next frame
+   */
+  MultiFrameBuilder(size_t connection_buffer_size, size_t total_buffer_size,
+                    uint32_t waiting_timeout);
+  /**
+   * \brief Adds first or consecutive frame of multiframe message
+   * \param connection_id Identifier of connection the frame is received from
+   * \param connection_key Key of session the frame belongs to
+   * \param frame First or consecutive frame
+   * \param out_message Set to the complete message on its last frame
+   * \return RESULT_OK if frame is accepted;
+   * RESULT_FAIL if frame is unexpected, does not fit message or limits,
+   * incomplete message of the session is dropped then
+   */
+  RESULT_CODE AddFrame(const ConnectionID connection_id,
+                       const uint32_t connection_key,
+                       const ProtocolFramePtr frame,
+                       RawMessagePtr *out_message);
+  /**
+   * \brief Drops all incomplete messages of connection
+   */
+  void RemoveConnection(const ConnectionID connection_id);
+  /**
+   * \brief Drops messages waiting for a next frame longer than timeout
+   * \return count of dropped messages
+   */
+  size_t RemoveExpiredMessages();
+  /**
+   * \brief Count of messages waiting for next frames
+   */
+  size_t incomplete_messages_count() const;
+  /**
+   * \brief Size in bytes reserved for messages waiting for next frames
+   */
+  size_t incomplete_messages_size() const;
+
+ private:
+  typedef utils::SharedPtr<std::vector<uint8_t> > Buffer;
+  // Frames of one session come in order, so session has one message at once
+  typedef std::pair<ConnectionID, uint8_t> SessionKey;
+
+  struct IncompleteMessage {
+    uint32_t connection_key;
+    uint8_t protocol_version;
+    uint8_t service_type;
+    Buffer buffer;
+    size_t received_size;
+    TimevalStruct last_frame_time;
+  };
+  typedef std::map<SessionKey, IncompleteMessage> IncompleteMessages;
+  typedef std::map<ConnectionID, size_t> ConnectionsBufferSize;
+
+  RESULT_CODE AddFirstFrame(const SessionKey& key,
+                            const uint32_t connection_key,
+                            const ProtocolFramePtr frame);
+  RESULT_CODE AddConsecutiveFrame(const SessionKey& key,
+                                  const ProtocolFramePtr frame,
+                                  RawMessagePtr *out_message);
+  /**
+   * \brief Removes incomplete message and releases its reserved size
+   */
+  void Erase(const IncompleteMessages::iterator it);
+  /**
+   * \brief Returns buffer of required size, reusing pooled buffer which
+   * is not referenced by incomplete or reassembled messages anymore
+   */
+  Buffer AcquireBuffer(const size_t size);
+
+  const size_t connection_buffer_size_;
+  const size_t total_buffer_size_;
+  const uint32_t waiting_timeout_;
+
+  mutable sync_primitives::Lock messages_lock_;
+  IncompleteMessages messages_;
+  ConnectionsBufferSize connections_buffer_size_;
+  size_t messages_size_;
+  std::vector<Buffer> buffer_pool_;
+  DISALLOW_COPY_AND_ASSIGN(MultiFrameBuilder);
+};
+}  // namespace protocol_handler
+#endif  // SRC_COMPONENTS_PROTOCOL_HANDLER_INCLUDE_PROTOCOL_HANDLER_MULTIFRAME_BUILDER_H_
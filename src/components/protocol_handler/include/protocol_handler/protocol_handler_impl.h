@@ -37,17 +37,23 @@
 #include <memory>
 #include <set>
 #include <list>
+#include <queue>
+#include <vector>
 #include "utils/prioritized_queue.h"
 #include "utils/message_queue.h"
 #include "utils/threads/message_loop_thread.h"
 #include "utils/shared_ptr.h"
 #include "utils/messagemeter.h"
+#include "utils/timer_thread.h"
+#include "utils/date_time.h"
+#include "utils/lock.h"
 
 #include "protocol_handler/protocol_handler.h"
 #include "protocol_handler/protocol_packet.h"
 #include "protocol_handler/session_observer.h"
 #include "protocol_handler/protocol_observer.h"
 #include "protocol_handler/incoming_data_handler.h"
+#include "protocol_handler/multiframe_builder.h"
 #include "transport_manager/common.h"
 #include "transport_manager/transport_manager.h"
 #include "transport_manager/transport_manager_listener_empty.h"
@@ -74,6 +80,7 @@ using transport_manager::TransportManagerListenerEmpty;
 
 typedef std::multimap<int32_t, RawMessagePtr> MessagesOverNaviMap;
 typedef std::set<ProtocolObserver*> ProtocolObservers;
+typedef utils::SharedPtr<const ProtocolObservers> ProtocolObserversPtr;
 typedef transport_manager::ConnectionUID ConnectionID;
 
 namespace impl {
@@ -84,20 +91,28 @@ namespace impl {
  * TODO(ik): replace these with globally defined message types
  * when we have them.
  */
-struct RawFordMessageFromMobile: public ProtocolFramePtr {
-  explicit RawFordMessageFromMobile(const ProtocolFramePtr message)
-    : ProtocolFramePtr(message) {}
-  // PrioritizedQueue requires this method to decide which priority to assign
-  size_t PriorityOrder() const {
-    return MessagePriority::FromServiceType(
-             ServiceTypeFromByte(get()->service_type())).OrderingValue();
-  }
+struct RawFordMessageFromTransport: public RawMessagePtr {
+  enum Event {
+    kData,
+    kConnectionEstablished,
+    kConnectionClosed
+  };
+  explicit RawFordMessageFromTransport(const RawMessagePtr message)
+    : RawMessagePtr(message), event(kData),
+      connection_id(message->connection_key()) {}
+  RawFordMessageFromTransport(Event connection_event,
+                              ConnectionID connection)
+    : event(connection_event), connection_id(connection) {}
+  // Kind of transport notification, data is set only for kData
+  Event event;
+  ConnectionID connection_id;
 };
 
 struct RawFordMessageToMobile: public ProtocolFramePtr {
   explicit RawFordMessageToMobile(const ProtocolFramePtr message,
                                   bool final_message)
-    : ProtocolFramePtr(message), is_final(final_message) {}
+    : ProtocolFramePtr(message), is_final(final_message),
+      post_time(date_time::DateTime::getCurrentTime()) {}
   // PrioritizedQueue requires this method to decide which priority to assign
   size_t PriorityOrder() const {
     return MessagePriority::FromServiceType(
@@ -105,13 +120,68 @@ struct RawFordMessageToMobile: public ProtocolFramePtr {
   }
   // Signals whether connection to mobile must be closed after processing this message
   bool is_final;
+  // Time of posting to outgoing queue, used for shard latency metrics
+  TimevalStruct post_time;
 };
 
-// Short type names for prioritized message queues
+// Short type names for message queues
+// Incoming data is kept in order of receiving: frames of one connection
+// are parsed one after another and must not be reordered
 typedef threads::MessageLoopThread <
-  utils::PrioritizedQueue<RawFordMessageFromMobile> > FromMobileQueue;
+  std::queue<RawFordMessageFromTransport> > FromTransportQueue;
 typedef threads::MessageLoopThread <
   utils::PrioritizedQueue<RawFordMessageToMobile> > ToMobileQueue;
+
+/**
+ * \brief State of one incoming worker: all data of connections served
+ * by the worker is parsed, decrypted and handled on its thread only,
+ * so the state needs no locking
+ */
+struct InboundShard {
+  InboundShard(const std::string& name,
+               FromTransportQueue::Handler* handler,
+               const ProtocolPacket::ProtocolHeaderValidator* validator);
+  IncomingDataHandler incoming_data_handler;
+  // Use uint32_t as application identifier
+  utils::MessageMeter<uint32_t> message_meter;
+  // Use uint32_t as connection identifier
+  utils::MessageMeter<uint32_t> malformed_message_meter;
+  // Declared last to be destroyed first: thread is joined
+  // before the state it uses is gone
+  FromTransportQueue queue;
+ private:
+  DISALLOW_COPY_AND_ASSIGN(InboundShard);
+};
+}  // namespace impl
+
+/**
+ * \brief Latency of frames passed through one outgoing shard,
+ * measured from posting frame to the shard till its hand-off to transport
+ */
+struct OutgoingShardStatistics {
+  OutgoingShardStatistics()
+    : frames_count(0), total_latency_usecs(0), max_latency_usecs(0) {}
+  uint32_t frames_count;
+  int64_t total_latency_usecs;
+  int64_t max_latency_usecs;
+};
+
+namespace impl {
+/**
+ * \brief State of one outgoing worker: frames of connections served
+ * by the worker are sent on its thread only, statistics lock is taken
+ * by this thread and rare statistics readers
+ */
+struct OutgoingShard {
+  OutgoingShard(const std::string& name, ToMobileQueue::Handler* handler);
+  OutgoingShardStatistics statistics;
+  mutable sync_primitives::Lock statistics_lock;
+  // Declared last to be destroyed first: thread is joined
+  // before the state it uses is gone
+  ToMobileQueue queue;
+ private:
+  DISALLOW_COPY_AND_ASSIGN(OutgoingShard);
+};
 }  // namespace impl
 
 /**
@@ -125,7 +195,7 @@ typedef threads::MessageLoopThread <
 class ProtocolHandlerImpl
   : public ProtocolHandler,
     public TransportManagerListenerEmpty,
-    public impl::FromMobileQueue::Handler,
+    public impl::FromTransportQueue::Handler,
     public impl::ToMobileQueue::Handler {
  public:
   /**
@@ -138,6 +208,10 @@ class ProtocolHandlerImpl
    * \param malformed_message_frequency_time used as time for malformed flood filtering
    * \param malformed_message_frequency_count used as maximum value of malformed
    *        messages per message_frequency_time period
+   * \param inbound_workers_count count of threads processing incoming data,
+   *        connections are spread among them (at least one is created)
+   * \param outgoing_workers_count count of threads sending outgoing frames,
+   *        connections are spread among them (at least one is created)
    * message exchange.
    */
   explicit ProtocolHandlerImpl(
@@ -145,7 +219,9 @@ class ProtocolHandlerImpl
     size_t message_frequency_time, size_t message_frequency_count,
     bool malformed_message_filtering,
     size_t malformed_message_frequency_time,
-    size_t malformed_message_frequency_count);
+    size_t malformed_message_frequency_count,
+    size_t inbound_workers_count,
+    size_t outgoing_workers_count);
 
   /**
    * \brief Destructor
@@ -186,6 +262,22 @@ class ProtocolHandlerImpl
    */
   void Stop();
 
+  /**
+   * \brief Count of incoming shards, each with own queue and thread
+   */
+  size_t inbound_shards_count() const;
+
+  /**
+   * \brief Count of outgoing shards, each with own queue and thread
+   */
+  size_t outgoing_shards_count() const;
+
+  /**
+   * \brief Snapshot of latency statistics of outgoing shard
+   * \param shard index in range [0, outgoing_shards_count())
+   */
+  OutgoingShardStatistics outgoing_shard_statistics(size_t shard) const;
+
   /**
    * \brief Method for sending message to Mobile Application
    * \param message Message with params to be sent to Mobile App
@@ -337,8 +429,10 @@ class ProtocolHandlerImpl
     const transport_manager::DeviceInfo &device_info,
     const transport_manager::ConnectionUID &connection_id);
 
+  // Parameter is passed by value as in TransportManagerListener,
+  // otherwise the method would hide the listener one instead of overriding
   virtual void OnConnectionClosed(
-    const transport_manager::ConnectionUID &connection_id);
+    transport_manager::ConnectionUID connection_id);
 
   /**
    * @brief Notifies subscribers about message
@@ -429,6 +523,12 @@ class ProtocolHandlerImpl
     ConnectionID connection_id,
     const ProtocolFramePtr packet);
 
+  /**
+   * \brief Drops multiframe messages waiting for next frame too long,
+   * called by multiframe_timer_
+   */
+  void OnMultiFrameTimeout();
+
   /**
    * \brief Handles message received in single frame.
    * \param connection_handle Identifier of connection through which message
@@ -453,31 +553,91 @@ class ProtocolHandlerImpl
     const ProtocolPacket &packet);
 
   // threads::MessageLoopThread<*>::Handler implementations
-  // CALLED ON raw_ford_messages_from_mobile_ thread!
-  void Handle(const impl::RawFordMessageFromMobile message);
-  // CALLED ON raw_ford_messages_to_mobile_ thread!
+  // CALLED ON one of inbound_shards_ threads!
+  void Handle(const impl::RawFordMessageFromTransport message);
+  // CALLED ON one of outgoing_shards_ threads!
   void Handle(const impl::RawFordMessageToMobile message);
 
+  /**
+   * \brief Parses received data into frames, tracks malformed data
+   * and decrypts protected frames
+   * \param shard incoming shard serving connection of data
+   * \param tm_message data received from transport
+   * \return frames in order of receiving
+   */
+  std::list<ProtocolFramePtr> ProcessIncomingData(
+    impl::InboundShard *shard, const RawMessagePtr tm_message);
+
+  /**
+   * \brief Tracks frequency and handles one received frame
+   * \param shard incoming shard serving connection of frame
+   * \param frame received frame
+   */
+  void HandleIncomingFrame(impl::InboundShard *shard,
+                           const ProtocolFramePtr frame);
+
+  /**
+   * \brief Index of incoming shard serving connection
+   */
+  size_t InboundShardIndex(ConnectionID connection_id) const;
+
+  /**
+   * \brief Current set of observers, could be used without lock
+   * while set is modified
+   */
+  ProtocolObserversPtr protocol_observers() const;
+
+  /**
+   * \brief Returns next identifier of message sent in session
+   */
+  uint32_t NextMessageId(uint8_t session_id);
+
+  /**
+   * \brief Posts frame to outgoing shard of its connection
+   * \param frame frame to be sent
+   * \param is_final whether connection is closed after sending frame
+   */
+  void PostFrameToMobile(const ProtocolFramePtr frame, bool is_final);
+
+  /**
+   * \brief Index of outgoing shard serving connection
+   */
+  size_t OutgoingShardIndex(ConnectionID connection_id) const;
+
 #ifdef ENABLE_SECURITY
   /**
-   * \brief Encryption/Decryption methodes for SecureSecvice check
-   * \param packet frame of message to encrypted/decrypted
+   * \brief Encryption methode for SecureSecvice check
+   * \param packet frame of message to encrypted
    */
   RESULT_CODE EncryptFrame(ProtocolFramePtr packet);
-  RESULT_CODE DecryptFrame(ProtocolFramePtr packet);
+  /**
+   * \brief Decrypts protected frames in place, frames of the same service
+   * are decrypted by one batch
+   * \param frames received frames, failed frames are removed from list
+   */
+  void DecryptFrames(std::list<ProtocolFramePtr> *const frames);
+  bool GetDecryptionContext(const ProtocolFramePtr packet,
+                            security_manager::SSLContext **const context);
+  void DecryptBatch(security_manager::SSLContext *const context,
+                    const std::vector<ProtocolFramePtr> &batch,
+                    std::set<const ProtocolPacket*> *const failed_frames);
 #endif  // ENABLE_SECURITY
 
-  bool TrackMessage(const uint32_t &connection_key);
+  bool TrackMessage(utils::MessageMeter<uint32_t> *const meter,
+                    const uint32_t &connection_key);
 
-  bool TrackMalformedMessage(const uint32_t &connection_key,
+  bool TrackMalformedMessage(utils::MessageMeter<uint32_t> *const meter,
+                             const uint32_t &connection_key,
                              const size_t count);
 
  private:
   /**
    *\brief Pointer on instance of class implementing IProtocolObserver
    *\brief (JSON Handler)
+   * Set is never changed in place but replaced with modified copy,
+   * so notification does not block other shards and observers changes
    */
-  ProtocolObservers protocol_observers_;
+  ProtocolObserversPtr protocol_observers_;
 
   /**
    *\brief Pointer on instance of class implementing ISessionObserver
@@ -491,9 +651,9 @@ class ProtocolHandlerImpl
   transport_manager::TransportManager *transport_manager_;
 
   /**
-   *\brief Map of frames for messages received in multiple frames.
+   *\brief Reassembler of messages received in multiple frames.
    */
-  std::map<int32_t, ProtocolFramePtr> incomplete_multi_frame_messages_;
+  MultiFrameBuilder multiframe_builder_;
 
   /**
    * \brief Map of messages (frames) received over mobile nave session
@@ -512,6 +672,7 @@ class ProtocolHandlerImpl
    * Used ad unique message identifier
    */
   std::map<uint8_t, uint32_t> message_counters_;
+  sync_primitives::Lock message_counters_lock_;
 
   /**
    *\brief Counter of messages sent in each session.
@@ -522,6 +683,7 @@ class ProtocolHandlerImpl
    *\brief map for session last message.
    */
   std::map<uint8_t, uint32_t> sessions_last_message_id_;
+  sync_primitives::Lock sessions_last_message_id_lock_;
 
   /**
    *\brief Connections that must be closed after their last messages were sent
@@ -529,14 +691,9 @@ class ProtocolHandlerImpl
   std::list<uint32_t> ready_to_close_connections_;
 
   ProtocolPacket::ProtocolHeaderValidator protocol_header_validator_;
-  IncomingDataHandler incoming_data_handler_;
-  // Use uint32_t as application identifier
-  utils::MessageMeter<uint32_t> message_meter_;
   size_t message_max_frequency_;
   size_t message_frequency_time_;
   bool malformed_message_filtering_;
-  // Use uint32_t as connection identifier
-  utils::MessageMeter<uint32_t> malformed_message_meter_;
   size_t malformed_message_max_frequency_;
   size_t malformed_message_frequency_time_;
 
@@ -544,12 +701,19 @@ class ProtocolHandlerImpl
   security_manager::SecurityManager *security_manager_;
 #endif  // ENABLE_SECURITY
 
-  // Thread that pumps non-parsed messages coming from mobile side.
-  impl::FromMobileQueue raw_ford_messages_from_mobile_;
-  // Thread that pumps messages prepared to being sent to mobile side.
-  impl::ToMobileQueue raw_ford_messages_to_mobile_;
+  // Threads that pump non-parsed messages coming from mobile side.
+  // Data of one connection always goes through the same shard to keep
+  // its order, connections of different shards are handled in parallel.
+  std::vector<impl::InboundShard*> inbound_shards_;
+  // Threads that pump messages prepared to being sent to mobile side.
+  // Frames of one connection always go through the same shard to keep
+  // their order, busy connection does not delay other shards.
+  std::vector<impl::OutgoingShard*> outgoing_shards_;
+
+  // Periodically removes expired multiframe messages
+  timer::TimerThread<ProtocolHandlerImpl> multiframe_timer_;
 
-  sync_primitives::Lock protocol_observers_lock_;
+  mutable sync_primitives::Lock protocol_observers_lock_;
 
 #ifdef TIME_TESTER
   PHMetricObserver *metric_observer_;
@@ -34,6 +34,7 @@
 #define SRC_COMPONENTS_PROTOCOL_HANDLER_INCLUDE_PROTOCOL_HANDLER_PROTOCOL_PACKET_H_
 
 #include "utils/macro.h"
+#include "utils/memory_pool.h"
 #include "protocol/common.h"
 #include "transport_manager/common.h"
 
@@ -49,7 +50,7 @@ typedef transport_manager::ConnectionUID ConnectionID;
  * \brief Class for forming/parsing protocol headers of the message and
  * handling multiple frames of the message.
  */
-class ProtocolPacket {
+class ProtocolPacket : public utils::PooledObject {
  public:
   /**
    * \struct ProtocolData
@@ -83,6 +84,13 @@ class ProtocolPacket {
     uint32_t dataSize;
     uint32_t messageId;
     void deserialize(const uint8_t *message, const size_t messageSize);
+    /**
+     * \brief Writes header to buffer in one pass
+     * \param buffer Destination with at least PROTOCOL_HEADER_V2_SIZE bytes,
+     * message id is written for every version
+     * \return Size of header of current protocol version
+     */
+    size_t serialize(uint8_t *buffer) const;
   };
   /**
    * \class ProtocolHeaderValidator
@@ -173,6 +181,18 @@ class ProtocolPacket {
   RESULT_CODE deserializePacket(const uint8_t *message,
                                 const size_t messageSize);
 
+  /**
+   * \brief Initializes packet with already parsed protocol header
+   * \param header Header parsed from the beginning of message
+   * \param message Incoming message string containing both header and
+   * message body
+   * \param messageSize Incoming message size
+   * \return \saRESULT_CODE Status of serialization
+   */
+  RESULT_CODE deserializePacket(const ProtocolHeader &header,
+                                const uint8_t *message,
+                                const size_t messageSize);
+
   /**
    * \brief Getter of protocol version.
    */
@@ -234,6 +254,14 @@ class ProtocolPacket {
   void set_data(const uint8_t *const  new_data,
                 const size_t new_data_size);
 
+  /**
+   *\brief Setter for new data without copying
+   * Packet takes ownership of new_data allocated with utils::MemoryPool,
+   * new_data could point to the current packet data (in place processing)
+   */
+  void set_data_buffer(uint8_t *const new_data,
+                       const size_t new_data_size);
+
   /**
    *\brief Getter for size of multiframe message
    */
@@ -69,6 +69,15 @@ struct ProtocolPayloadV2 {
 void Extract(utils::BitStream *bs, ProtocolPayloadHeaderV2 *headerv2);
 void Extract(utils::BitStream *bs, ProtocolPayloadV2 *payload, size_t payload_size);
 
+// Parses protocol payload from contiguous buffer in a single pass
+// over the fixed header layout, returns false on ill-formed payload
+bool ParsePayloadV2(const uint8_t *data, size_t data_size,
+                    ProtocolPayloadV2 *payload);
+// Writes binary header to buffer of at least ProtocolPayloadV2SizeBits() / 8
+// bytes, returns count of written bytes
+size_t WritePayloadHeaderV2(const ProtocolPayloadHeaderV2 &header,
+                            uint8_t *buffer);
+
 std::ostream &operator<<(std::ostream &os, const ProtocolPayloadHeaderV2 &payload_header);
 std::ostream &operator<<(std::ostream &os, const ProtocolPayloadV2 &payload);
 
@@ -139,6 +139,7 @@ RESULT_CODE IncomingDataHandler::CreateFrame(
   std::vector<uint8_t>::iterator data_it = incoming_data.begin();
   size_t data_size = incoming_data.size();
   while (data_size >= MIN_HEADER_SIZE) {
+    // Header is parsed once and handed over to the frame below
     header_.deserialize(&*data_it, data_size);
     const RESULT_CODE validate_result =
       validator_ ? validator_->validate(header_) : RESULT_OK;
@@ -172,7 +173,7 @@ RESULT_CODE IncomingDataHandler::CreateFrame(
     }
     ProtocolFramePtr frame(new protocol_handler::ProtocolPacket(connection_id));
     const RESULT_CODE deserialize_result =
-      frame->deserializePacket(&*data_it, packet_size);
+      frame->deserializePacket(header_, &*data_it, packet_size);
     if (deserialize_result != RESULT_OK) {
       LOG4CXX_WARN(logger_, "Packet deserialization failed");
       incoming_data.erase(incoming_data.begin(), data_it);
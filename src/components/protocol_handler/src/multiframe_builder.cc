@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "protocol_handler/multiframe_builder.h"
+
+#include <string.h>
+
+#include "utils/logger.h"
+#include "utils/memory_barrier.h"
+
+namespace protocol_handler {
+
+CREATE_LOGGERPTR_GLOBAL(logger_, "ProtocolHandler")
+
+namespace {
+// Idle buffers kept for next messages
+const size_t kBufferPoolSize = 8;
+const size_t kMaxPooledBufferSize = 256 * 1024;
+}  // namespace
+
+MultiFrameBuilder::MultiFrameBuilder(size_t connection_buffer_size,
+                                     size_t total_buffer_size,
+                                     uint32_t waiting_timeout)
+  : connection_buffer_size_(connection_buffer_size),
+    total_buffer_size_(total_buffer_size),
+    waiting_timeout_(waiting_timeout),
+    messages_size_(0) {
+}
+
+RESULT_CODE MultiFrameBuilder::AddFrame(const ConnectionID connection_id,
+                                        const uint32_t connection_key,
+                                        const ProtocolFramePtr frame,
+                                        RawMessagePtr *out_message) {
+  DCHECK(out_message);
+  if (!frame) {
+    return RESULT_FAIL;
+  }
+  const SessionKey key(connection_id, frame->session_id());
+  sync_primitives::AutoLock lock(messages_lock_);
+  switch (frame->frame_type()) {
+    case FRAME_TYPE_FIRST:
+      return AddFirstFrame(key, connection_key, frame);
+    case FRAME_TYPE_CONSECUTIVE:
+      return AddConsecutiveFrame(key, frame, out_message);
+    default:
+      LOG4CXX_WARN(logger_, "Not a multiframe frame type "
+                   << static_cast<int>(frame->frame_type()));
+      return RESULT_FAIL;
+  }
+}
+
+void MultiFrameBuilder::RemoveConnection(const ConnectionID connection_id) {
+  sync_primitives::AutoLock lock(messages_lock_);
+  IncompleteMessages::iterator it = messages_.lower_bound(
+      SessionKey(connection_id, 0));
+  while (it != messages_.end() && it->first.first == connection_id) {
+    Erase(it++);
+  }
+  connections_buffer_size_.erase(connection_id);
+}
+
+size_t MultiFrameBuilder::RemoveExpiredMessages() {
+  sync_primitives::AutoLock lock(messages_lock_);
+  size_t removed_count = 0;
+  IncompleteMessages::iterator it = messages_.begin();
+  while (it != messages_.end()) {
+    if (date_time::DateTime::calculateTimeSpan(it->second.last_frame_time) >=
+        waiting_timeout_) {
+      LOG4CXX_WARN(logger_, "Multiframe message of connection key "
+                   << it->second.connection_key << " is expired, "
+                   << it->second.received_size << " of "
+                   << it->second.buffer->size() << " bytes received");
+      Erase(it++);
+      ++removed_count;
+    } else {
+      ++it;
+    }
+  }
+  return removed_count;
+}
+
+size_t MultiFrameBuilder::incomplete_messages_count() const {
+  sync_primitives::AutoLock lock(messages_lock_);
+  return messages_.size();
+}
+
+size_t MultiFrameBuilder::incomplete_messages_size() const {
+  sync_primitives::AutoLock lock(messages_lock_);
+  return messages_size_;
+}
+
+RESULT_CODE MultiFrameBuilder::AddFirstFrame(const SessionKey& key,
+                                             const uint32_t connection_key,
+                                             const ProtocolFramePtr frame) {
+  IncompleteMessages::iterator it = messages_.find(key);
+  if (it != messages_.end()) {
+    LOG4CXX_WARN(logger_, "First frame replaces incomplete message of "
+                 "connection key " << connection_key);
+    Erase(it);
+  }
+
+  const size_t total_size = frame->total_data_bytes();
+  if (0 == total_size) {
+    LOG4CXX_WARN(logger_, "First frame of empty multiframe message");
+    return RESULT_FAIL;
+  }
+  ConnectionsBufferSize::const_iterator connection_it =
+      connections_buffer_size_.find(key.first);
+  const size_t connection_size =
+      connection_it != connections_buffer_size_.end() ? connection_it->second
+                                                      : 0;
+  if (total_size > connection_buffer_size_ - connection_size ||
+      total_size > total_buffer_size_ - messages_size_) {
+    LOG4CXX_WARN(logger_, "Multiframe message of " << total_size
+                 << " bytes exceeds buffer limits, connection key "
+                 << connection_key);
+    return RESULT_FAIL;
+  }
+
+  IncompleteMessage message;
+  message.connection_key = connection_key;
+  message.protocol_version = frame->protocol_version();
+  message.service_type = frame->service_type();
+  message.buffer = AcquireBuffer(total_size);
+  message.received_size = 0;
+  message.last_frame_time = date_time::DateTime::getCurrentTime();
+  messages_.insert(std::make_pair(key, message));
+
+  connections_buffer_size_[key.first] += total_size;
+  messages_size_ += total_size;
+  return RESULT_OK;
+}
+
+RESULT_CODE MultiFrameBuilder::AddConsecutiveFrame(
+    const SessionKey& key, const ProtocolFramePtr frame,
+    RawMessagePtr *out_message) {
+  IncompleteMessages::iterator it = messages_.find(key);
+  if (it == messages_.end()) {
+    LOG4CXX_ERROR(logger_,
+                  "Frame of multiframe message for non-existing session id");
+    return RESULT_FAIL;
+  }
+
+  IncompleteMessage& message = it->second;
+  std::vector<uint8_t>& buffer = *message.buffer;
+  const size_t frame_size = frame->data() ? frame->data_size() : 0;
+  if (frame_size > buffer.size() - message.received_size) {
+    LOG4CXX_ERROR(logger_, "Frame exceeds size of multiframe message, "
+                  "connection key " << message.connection_key);
+    Erase(it);
+    return RESULT_FAIL;
+  }
+  if (frame_size) {
+    memcpy(&buffer[message.received_size], frame->data(), frame_size);
+    message.received_size += frame_size;
+  }
+  message.last_frame_time = date_time::DateTime::getCurrentTime();
+
+  if (FRAME_DATA_LAST_CONSECUTIVE != frame->frame_data()) {
+    return RESULT_OK;
+  }
+  if (message.received_size != buffer.size()) {
+    LOG4CXX_ERROR(logger_, "Last frame of truncated multiframe message, "
+                  << message.received_size << " of " << buffer.size()
+                  << " bytes received, connection key "
+                  << message.connection_key);
+    Erase(it);
+    return RESULT_FAIL;
+  }
+
+  // Reassembled buffer becomes message payload without copying
+  *out_message = new RawMessage(message.connection_key,
+                                message.protocol_version,
+                                SharedPayload(message.buffer),
+                                message.service_type);
+  Erase(it);
+  return RESULT_OK;
+}
+
+void MultiFrameBuilder::Erase(const IncompleteMessages::iterator it) {
+  const size_t size = it->second.buffer->size();
+  ConnectionsBufferSize::iterator connection_it =
+      connections_buffer_size_.find(it->first.first);
+  if (connection_it != connections_buffer_size_.end()) {
+    connection_it->second -= size;
+    if (0 == connection_it->second) {
+      connections_buffer_size_.erase(connection_it);
+    }
+  }
+  messages_size_ -= size;
+  messages_.erase(it);
+}
+
+MultiFrameBuilder::Buffer MultiFrameBuilder::AcquireBuffer(const size_t size) {
+  // Best fitting buffer without other references. References are taken
+  // only from the pool by this builder, so a buffer seen unique stays so
+  std::vector<Buffer>::iterator best = buffer_pool_.end();
+  for (std::vector<Buffer>::iterator it = buffer_pool_.begin();
+       it != buffer_pool_.end(); ++it) {
+    if ((*it).unique() && (*it)->capacity() >= size &&
+        (best == buffer_pool_.end() || (*it)->capacity() < (*best)->capacity())) {
+      best = it;
+    }
+  }
+  if (best != buffer_pool_.end()) {
+    // Writes of the last holder which dropped its reference are completed
+    // before the buffer is reused
+    utils::memory_barrier();
+    (*best)->resize(size);
+    return *best;
+  }
+
+  const Buffer buffer(new std::vector<uint8_t>(size));
+  if (size <= kMaxPooledBufferSize) {
+    if (buffer_pool_.size() < kBufferPoolSize) {
+      buffer_pool_.push_back(buffer);
+    } else {
+      // Replace an idle buffer smaller than the new one
+      for (std::vector<Buffer>::iterator it = buffer_pool_.begin();
+           it != buffer_pool_.end(); ++it) {
+        if ((*it).unique() && (*it)->capacity() < size) {
+          utils::memory_barrier();
+          *it = buffer;
+          break;
+        }
+      }
+    }
+  }
+  return buffer;
+}
+
+}  // namespace protocol_handler
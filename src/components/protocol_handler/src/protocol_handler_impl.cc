@@ -32,11 +32,13 @@
 
 #include "protocol_handler/protocol_handler_impl.h"
 #include <memory.h>
-#include <algorithm>    // std::find
+#include <algorithm>    // std::find, std::max
+#include <sstream>
 
 #include "connection_handler/connection_handler_impl.h"
 #include "config_profile/profile.h"
 #include "utils/byte_order.h"
+#include "utils/memory_pool.h"
 #include "protocol/common.h"
 
 #ifdef ENABLE_SECURITY
@@ -63,14 +65,35 @@ uint8_t SupportedSDLProtocolVersion();
 
 const size_t kStackSize = 32768;
 
+namespace impl {
+InboundShard::InboundShard(
+    const std::string& name,
+    FromTransportQueue::Handler* handler,
+    const ProtocolPacket::ProtocolHeaderValidator* validator)
+  : queue(name.c_str(), handler, threads::ThreadOptions(kStackSize)) {
+  incoming_data_handler.set_validator(validator);
+}
+
+OutgoingShard::OutgoingShard(const std::string& name,
+                             ToMobileQueue::Handler* handler)
+  : queue(name.c_str(), handler, threads::ThreadOptions(kStackSize)) {
+}
+}  // namespace impl
+
 ProtocolHandlerImpl::ProtocolHandlerImpl(
     transport_manager::TransportManager *transport_manager_param,
     size_t message_frequency_time, size_t message_frequency_count,
     bool malformed_message_filtering,
-    size_t malformed_message_frequency_time, size_t malformed_message_frequency_count)
-    : protocol_observers_(),
+    size_t malformed_message_frequency_time, size_t malformed_message_frequency_count,
+    size_t inbound_workers_count,
+    size_t outgoing_workers_count)
+    : protocol_observers_(new ProtocolObservers()),
       session_observer_(0),
       transport_manager_(transport_manager_param),
+      multiframe_builder_(
+          profile::Profile::instance()->multiframe_connection_buffer_size(),
+          profile::Profile::instance()->multiframe_total_buffer_size(),
+          profile::Profile::instance()->multiframe_waiting_timeout()),
       kPeriodForNaviAck(5),
       message_max_frequency_(message_frequency_count),
       message_frequency_time_(message_frequency_time),
@@ -80,32 +103,59 @@ ProtocolHandlerImpl::ProtocolHandlerImpl(
 #ifdef ENABLE_SECURITY
       security_manager_(NULL),
 #endif  // ENABLE_SECURITY
-      raw_ford_messages_from_mobile_("PH FromMobile", this,
-                                     threads::ThreadOptions(kStackSize)),
-      raw_ford_messages_to_mobile_("PH ToMobile", this,
-                                   threads::ThreadOptions(kStackSize))
+      multiframe_timer_("PH MultiFrame", this,
+                        &ProtocolHandlerImpl::OnMultiFrameTimeout, true)
 #ifdef TIME_TESTER
       , metric_observer_(NULL)
 #endif  // TIME_TESTER
 
 {
   LOG4CXX_AUTO_TRACE(logger_);
+  const size_t outgoing_shards_count = std::max(outgoing_workers_count,
+                                                static_cast<size_t>(1u));
+  for (size_t i = 0; i < outgoing_shards_count; ++i) {
+    std::stringstream name;
+    name << "PH ToMobile " << i;
+    outgoing_shards_.push_back(new impl::OutgoingShard(name.str(), this));
+  }
   protocol_header_validator_.set_max_payload_size(profile::Profile::instance()->maximum_payload_size());
-  incoming_data_handler_.set_validator(&protocol_header_validator_);
+  // Shards are created before the first transport notification, which
+  // could come only after this listener is added to transport manager
+  const size_t inbound_shards_count = std::max(inbound_workers_count,
+                                               static_cast<size_t>(1u));
+  for (size_t i = 0; i < inbound_shards_count; ++i) {
+    std::stringstream name;
+    name << "PH FromMobile " << i;
+    inbound_shards_.push_back(new impl::InboundShard(
+        name.str(), this, &protocol_header_validator_));
+  }
+  LOG4CXX_DEBUG(logger_, "Incoming data is processed by "
+                << inbound_shards_count << " thread(s)");
 
   if (message_frequency_time_ > 0u &&
       message_max_frequency_ > 0u) {
-    message_meter_.set_time_range(message_frequency_time_);
+    for (size_t i = 0; i < inbound_shards_.size(); ++i) {
+      inbound_shards_[i]->message_meter.set_time_range(message_frequency_time_);
+    }
     LOG4CXX_DEBUG(logger_, "Frequency meter is enabled ( " << message_max_frequency_
                   << " per " << message_frequency_time_ << " mSecond)");
   } else {
     LOG4CXX_WARN(logger_, "Frequency meter is disabled");
   }
 
+  // Timer granularity is a second, expired messages are checked twice
+  // per timeout to drop them not much later than expected
+  const uint32_t multiframe_timeout_seconds =
+      profile::Profile::instance()->multiframe_waiting_timeout() / 2000;
+  multiframe_timer_.start(std::max(multiframe_timeout_seconds, 1u));
+
   if (malformed_message_filtering_) {
     if(malformed_message_frequency_time_ > 0u &&
        malformed_message_max_frequency_ > 0u) {
-      malformed_message_meter_.set_time_range(malformed_message_frequency_time_);
+      for (size_t i = 0; i < inbound_shards_.size(); ++i) {
+        inbound_shards_[i]->malformed_message_meter.set_time_range(
+            malformed_message_frequency_time_);
+      }
       LOG4CXX_DEBUG(logger_, "Malformed frequency meter is enabled ( " << malformed_message_max_frequency_
                     << " per " << malformed_message_frequency_time_ << " mSecond)");
     } else {
@@ -118,11 +168,29 @@ ProtocolHandlerImpl::ProtocolHandlerImpl(
 }
 
 ProtocolHandlerImpl::~ProtocolHandlerImpl() {
-  sync_primitives::AutoLock lock(protocol_observers_lock_);
-  if (!protocol_observers_.empty()) {
+  if (!protocol_observers()->empty()) {
     LOG4CXX_WARN(logger_, "Not all observers have unsubscribed"
                  " from ProtocolHandlerImpl");
   }
+  for (size_t i = 0; i < inbound_shards_.size(); ++i) {
+    // Posted data is handled before shard thread is joined
+    delete inbound_shards_[i];
+  }
+  for (size_t i = 0; i < outgoing_shards_.size(); ++i) {
+    // Posted frames are sent before shard thread is joined
+    delete outgoing_shards_[i];
+  }
+#ifdef ENABLE_LOG
+  for (size_t i = 0; i < utils::MemoryPool::size_classes_count(); ++i) {
+    const utils::MemoryPool::Statistics stats =
+        utils::MemoryPool::statistics(i);
+    LOG4CXX_INFO(logger_, "Memory pool class "
+                 << utils::MemoryPool::class_block_size(i) << " bytes: "
+                 << stats.allocations << " allocations, "
+                 << stats.system_allocations << " from system, hit rate "
+                 << stats.hit_rate());
+  }
+#endif  // ENABLE_LOG
 }
 
 void ProtocolHandlerImpl::AddProtocolObserver(ProtocolObserver *observer) {
@@ -131,7 +199,9 @@ void ProtocolHandlerImpl::AddProtocolObserver(ProtocolObserver *observer) {
     return;
   }
   sync_primitives::AutoLock lock(protocol_observers_lock_);
-  protocol_observers_.insert(observer);
+  ProtocolObservers* observers = new ProtocolObservers(*protocol_observers_);
+  observers->insert(observer);
+  protocol_observers_ = ProtocolObserversPtr(observers);
 }
 
 void ProtocolHandlerImpl::RemoveProtocolObserver(ProtocolObserver* observer) {
@@ -141,7 +211,14 @@ void ProtocolHandlerImpl::RemoveProtocolObserver(ProtocolObserver* observer) {
     return;
   }
   sync_primitives::AutoLock lock(protocol_observers_lock_);
-  protocol_observers_.erase(observer);
+  ProtocolObservers* observers = new ProtocolObservers(*protocol_observers_);
+  observers->erase(observer);
+  protocol_observers_ = ProtocolObserversPtr(observers);
+}
+
+ProtocolObserversPtr ProtocolHandlerImpl::protocol_observers() const {
+  sync_primitives::AutoLock lock(protocol_observers_lock_);
+  return protocol_observers_;
 }
 
 void ProtocolHandlerImpl::set_session_observer(SessionObserver *observer) {
@@ -182,12 +259,11 @@ void ProtocolHandlerImpl::SendStartSessionAck(ConnectionID connection_id,
   ProtocolFramePtr ptr(new protocol_handler::ProtocolPacket(connection_id,
     protocolVersion, protection, FRAME_TYPE_CONTROL,
     service_type, FRAME_DATA_START_SERVICE_ACK, session_id,
-    0u, message_counters_[session_id]++));
+    0u, NextMessageId(session_id)));
 
   set_hash_id(hash_id, *ptr);
 
-  raw_ford_messages_to_mobile_.PostMessage(
-      impl::RawFordMessageToMobile(ptr, false));
+  PostFrameToMobile(ptr, false);
 
   LOG4CXX_DEBUG(logger_,
                "SendStartSessionAck() for connection " << connection_id
@@ -205,10 +281,9 @@ void ProtocolHandlerImpl::SendStartSessionNAck(ConnectionID connection_id,
   ProtocolFramePtr ptr(new protocol_handler::ProtocolPacket(connection_id,
       protocol_version, PROTECTION_OFF, FRAME_TYPE_CONTROL,
       service_type, FRAME_DATA_START_SERVICE_NACK,
-      session_id, 0u, message_counters_[session_id]++));
+      session_id, 0u, NextMessageId(session_id)));
 
-  raw_ford_messages_to_mobile_.PostMessage(
-      impl::RawFordMessageToMobile(ptr, false));
+  PostFrameToMobile(ptr, false);
 
   LOG4CXX_DEBUG(logger_,
                "SendStartSessionNAck() for connection " << connection_id
@@ -225,10 +300,9 @@ void ProtocolHandlerImpl::SendEndSessionNAck(ConnectionID connection_id,
   ProtocolFramePtr ptr(new protocol_handler::ProtocolPacket(connection_id,
       protocol_version, PROTECTION_OFF, FRAME_TYPE_CONTROL,
       service_type, FRAME_DATA_END_SERVICE_NACK,
-      session_id, 0u, message_counters_[session_id]++));
+      session_id, 0u, NextMessageId(session_id)));
 
-  raw_ford_messages_to_mobile_.PostMessage(
-      impl::RawFordMessageToMobile(ptr, false));
+  PostFrameToMobile(ptr, false);
 
   LOG4CXX_DEBUG(logger_, "SendEndSessionNAck() for connection " << connection_id
                << " for service_type " << static_cast<int32_t>(service_type)
@@ -244,10 +318,9 @@ void ProtocolHandlerImpl::SendEndSessionAck(ConnectionID connection_id,
   ProtocolFramePtr ptr(new protocol_handler::ProtocolPacket(connection_id,
       protocol_version, PROTECTION_OFF, FRAME_TYPE_CONTROL,
       service_type, FRAME_DATA_END_SERVICE_ACK, session_id,
-      0u, message_counters_[session_id]++));
+      0u, NextMessageId(session_id)));
 
-  raw_ford_messages_to_mobile_.PostMessage(
-      impl::RawFordMessageToMobile(ptr, false));
+  PostFrameToMobile(ptr, false);
 
   LOG4CXX_DEBUG(logger_,
                "SendEndSessionAck() for connection " << connection_id
@@ -266,10 +339,9 @@ void ProtocolHandlerImpl::SendEndServicePrivate(int32_t connection_id,
     ProtocolFramePtr ptr(new protocol_handler::ProtocolPacket(connection_id,
       protocol_version, PROTECTION_OFF, FRAME_TYPE_CONTROL,
       service_type, FRAME_DATA_END_SERVICE, session_id, 0,
-      message_counters_[session_id]++));
+      NextMessageId(session_id)));
 
-    raw_ford_messages_to_mobile_.PostMessage(
-      impl::RawFordMessageToMobile(ptr, false));
+    PostFrameToMobile(ptr, false);
     LOG4CXX_DEBUG(logger_, "SendEndSession() for connection " << connection_id
                    << " for service_type " << service_type
                    << " session_id " << static_cast<int32_t>(session_id));
@@ -302,8 +374,7 @@ RESULT_CODE ProtocolHandlerImpl::SendHeartBeatAck(ConnectionID connection_id,
 	    SERVICE_TYPE_CONTROL, FRAME_DATA_HEART_BEAT_ACK, session_id,
 	    0u, message_id));
 
-	raw_ford_messages_to_mobile_.PostMessage(
-	    impl::RawFordMessageToMobile(ptr, false));
+	PostFrameToMobile(ptr, false);
 	return RESULT_OK;
   }
   LOG4CXX_WARN(logger_, "SendHeartBeatAck is failed connection or session does not exist");
@@ -319,10 +390,9 @@ void ProtocolHandlerImpl::SendHeartBeat(int32_t connection_id,
     ProtocolFramePtr ptr(new protocol_handler::ProtocolPacket(connection_id,
 	    protocol_version, PROTECTION_OFF, FRAME_TYPE_CONTROL,
         SERVICE_TYPE_CONTROL, FRAME_DATA_HEART_BEAT, session_id,
-        0u, message_counters_[session_id]++));
+        0u, NextMessageId(session_id)));
 
-    raw_ford_messages_to_mobile_.PostMessage(
-        impl::RawFordMessageToMobile(ptr, false));
+    PostFrameToMobile(ptr, false);
     LOG4CXX_DEBUG(logger_, "SendHeartBeat finished successfully");
   } else {
     LOG4CXX_WARN(logger_, "SendHeartBeat is failed connection or session does not exist");
@@ -353,7 +423,11 @@ void ProtocolHandlerImpl::SendMessageToMobileApp(const RawMessagePtr message,
   session_observer_->PairFromKey(message->connection_key(), &connection_handle,
                                  &sessionID);
 #ifdef TIME_TESTER
-  uint32_t message_id = message_counters_[sessionID];
+  uint32_t message_id = 0;
+  {
+    sync_primitives::AutoLock lock(message_counters_lock_);
+    message_id = message_counters_[sessionID];
+  }
   if (metric_observer_) {
     metric_observer_->StartMessageProcess(message_id, start_time);
   }
@@ -440,11 +514,20 @@ void ProtocolHandlerImpl::OnTMMessageReceived(const RawMessagePtr tm_message) {
   LOG4CXX_DEBUG(logger_,
     "Received data from TM  with connection id " << connection_key <<
     " msg data_size "      << tm_message->data_size());
+  inbound_shards_[InboundShardIndex(connection_key)]->queue.PostMessage(
+      impl::RawFordMessageFromTransport(tm_message));
+}
+
+std::list<ProtocolFramePtr> ProtocolHandlerImpl::ProcessIncomingData(
+    impl::InboundShard *shard, const RawMessagePtr tm_message) {
+  LOG4CXX_AUTO_TRACE(logger_);
+  const uint32_t connection_key = tm_message->connection_key();
 
   RESULT_CODE result;
   size_t malformed_occurs = false;
-  const std::list<ProtocolFramePtr> protocol_frames =
-      incoming_data_handler_.ProcessData(*tm_message, &result, &malformed_occurs);
+  std::list<ProtocolFramePtr> protocol_frames =
+      shard->incoming_data_handler.ProcessData(*tm_message, &result,
+                                               &malformed_occurs);
   LOG4CXX_DEBUG(logger_, "Proccessed " << protocol_frames.size() << "frames");
   if (result != RESULT_OK) {
     if (result == RESULT_MALFORMED_OCCURS) {
@@ -457,7 +540,8 @@ void ProtocolHandlerImpl::OnTMMessageReceived(const RawMessagePtr tm_message) {
         }
       // For tracking only malformed occurrence check outpute
       } else if(!protocol_frames.empty()) {
-        TrackMalformedMessage(connection_key, malformed_occurs);
+        TrackMalformedMessage(&shard->malformed_message_meter,
+                              connection_key, malformed_occurs);
       }
     } else {
       LOG4CXX_ERROR(logger_, "Incoming data processing failed.");
@@ -465,28 +549,10 @@ void ProtocolHandlerImpl::OnTMMessageReceived(const RawMessagePtr tm_message) {
     }
   }
 
-  for (std::list<ProtocolFramePtr>::const_iterator it =
-       protocol_frames.begin(); it != protocol_frames.end(); ++it) {
-#ifdef TIME_TESTER
-    const TimevalStruct start_time = date_time::DateTime::getCurrentTime();
-#endif  // TIME_TESTER
-    ProtocolFramePtr frame = *it;
 #ifdef ENABLE_SECURITY
-    const RESULT_CODE result = DecryptFrame(frame);
-    if (result != RESULT_OK) {
-      LOG4CXX_WARN(logger_, "Error frame decryption. Frame skipped.");
-      continue;
-    }
+  DecryptFrames(&protocol_frames);
 #endif  // ENABLE_SECURITY
-    impl::RawFordMessageFromMobile msg(frame);
-#ifdef TIME_TESTER
-    if (metric_observer_) {
-      metric_observer_->StartMessageProcess(msg->message_id(), start_time);
-    }
-#endif  // TIME_TESTER
-
-    raw_ford_messages_from_mobile_.PostMessage(msg);
-  }
+  return protocol_frames;
 }
 
 void ProtocolHandlerImpl::OnTMMessageReceiveFailed(
@@ -497,9 +563,9 @@ void ProtocolHandlerImpl::OnTMMessageReceiveFailed(
 
 void ProtocolHandlerImpl::NotifySubscribers(const RawMessagePtr message) {
   LOG4CXX_AUTO_TRACE(logger_);
-  sync_primitives::AutoLock lock(protocol_observers_lock_);
-  for (ProtocolObservers::iterator it = protocol_observers_.begin();
-      protocol_observers_.end() != it; ++it) {
+  const ProtocolObserversPtr observers = protocol_observers();
+  for (ProtocolObservers::const_iterator it = observers->begin();
+      observers->end() != it; ++it) {
     (*it)->OnMessageReceived(message);
   }
 }
@@ -531,12 +597,20 @@ void ProtocolHandlerImpl::OnTMMessageSend(const RawMessagePtr message) {
     LOG4CXX_ERROR(logger_, "Error while message deserialization.");
     return;
   }
-  std::map<uint8_t, uint32_t>::iterator it =
-      sessions_last_message_id_.find(sent_message.session_id());
+  bool is_last_message = false;
+  uint32_t last_message_id = 0;
+  {
+    sync_primitives::AutoLock lock(sessions_last_message_id_lock_);
+    std::map<uint8_t, uint32_t>::iterator it =
+        sessions_last_message_id_.find(sent_message.session_id());
+    if (sessions_last_message_id_.end() != it) {
+      is_last_message = true;
+      last_message_id = it->second;
+      sessions_last_message_id_.erase(it);
+    }
+  }
 
-  if (sessions_last_message_id_.end() != it) {
-    uint32_t last_message_id = it->second;
-    sessions_last_message_id_.erase(it);
+  if (is_last_message) {
     if ((sent_message.message_id() ==  last_message_id) &&
         ((FRAME_TYPE_SINGLE == sent_message.frame_type()) ||
         ((FRAME_TYPE_CONSECUTIVE == sent_message.frame_type()) &&
@@ -545,9 +619,9 @@ void ProtocolHandlerImpl::OnTMMessageSend(const RawMessagePtr message) {
       SendEndSession(connection_handle, sent_message.session_id());
     }
   }
-  sync_primitives::AutoLock lock(protocol_observers_lock_);
-  for (ProtocolObservers::iterator it = protocol_observers_.begin();
-      protocol_observers_.end() != it; ++it) {
+  const ProtocolObserversPtr observers = protocol_observers();
+  for (ProtocolObservers::const_iterator it = observers->begin();
+      observers->end() != it; ++it) {
     (*it)->OnMobileMessageSent(message);
   }
 }
@@ -563,14 +637,20 @@ void ProtocolHandlerImpl::OnTMMessageSendFailed(
 void ProtocolHandlerImpl::OnConnectionEstablished(
     const transport_manager::DeviceInfo &device_info,
     const transport_manager::ConnectionUID &connection_id) {
-  incoming_data_handler_.AddConnection(connection_id);
+  inbound_shards_[InboundShardIndex(connection_id)]->queue.PostMessage(
+      impl::RawFordMessageFromTransport(
+          impl::RawFordMessageFromTransport::kConnectionEstablished,
+          connection_id));
 }
 
 void ProtocolHandlerImpl::OnConnectionClosed(
-    const transport_manager::ConnectionUID &connection_id) {
-  incoming_data_handler_.RemoveConnection(connection_id);
-  message_meter_.ClearIdentifiers();
-  malformed_message_meter_.ClearIdentifiers();
+    transport_manager::ConnectionUID connection_id) {
+  // Posted after all data of connection, so its frames are handled
+  // before connection state is removed
+  inbound_shards_[InboundShardIndex(connection_id)]->queue.PostMessage(
+      impl::RawFordMessageFromTransport(
+          impl::RawFordMessageFromTransport::kConnectionClosed,
+          connection_id));
 }
 
 RESULT_CODE ProtocolHandlerImpl::SendFrame(const ProtocolFramePtr packet) {
@@ -621,10 +701,9 @@ RESULT_CODE ProtocolHandlerImpl::SendSingleFrameMessage(
 
   ProtocolFramePtr ptr(new protocol_handler::ProtocolPacket(connection_id,
       protocol_version, PROTECTION_OFF, FRAME_TYPE_SINGLE, service_type, FRAME_DATA_SINGLE,
-      session_id, data_size, message_counters_[session_id]++, data));
+      session_id, data_size, NextMessageId(session_id), data));
 
-  raw_ford_messages_to_mobile_.PostMessage(
-      impl::RawFordMessageToMobile(ptr, is_final_message));
+  PostFrameToMobile(ptr, is_final_message);
   return RESULT_OK;
 }
 
@@ -667,15 +746,14 @@ RESULT_CODE ProtocolHandlerImpl::SendMultiFrameMessage(
   out_data[7] = frames_count;
 
   // TODO(EZamakhov): investigate message_id for CONSECUTIVE frames - APPLINK-9531
-  const uint8_t message_id = message_counters_[session_id]++;
+  const uint8_t message_id = NextMessageId(session_id);
   const ProtocolFramePtr firstPacket(
         new protocol_handler::ProtocolPacket(
           connection_id, protocol_version, PROTECTION_OFF, FRAME_TYPE_FIRST,
           service_type, FRAME_DATA_FIRST, session_id, FIRST_FRAME_DATA_SIZE,
           message_id, out_data));
 
-  raw_ford_messages_to_mobile_.PostMessage(
-      impl::RawFordMessageToMobile(firstPacket, false));
+  PostFrameToMobile(firstPacket, false);
   LOG4CXX_DEBUG(logger_, "First frame is sent.");
 
   for (uint32_t i = 0; i < frames_count; ++i) {
@@ -692,8 +770,7 @@ RESULT_CODE ProtocolHandlerImpl::SendMultiFrameMessage(
         service_type, data_type, session_id, frame_size, message_id,
         data + max_frame_size * i));
 
-    raw_ford_messages_to_mobile_.PostMessage(
-          impl::RawFordMessageToMobile(ptr, is_final_packet));
+    PostFrameToMobile(ptr, is_final_packet);
     LOG4CXX_DEBUG(logger_, '#' << i << " frame is sent.");
   }
   return RESULT_OK;
@@ -781,81 +858,49 @@ RESULT_CODE ProtocolHandlerImpl::HandleMultiFrameMessage(
       logger_,
       "Packet " << packet << "; session id " << static_cast<int32_t>(key));
 
-  if (packet->frame_type() == FRAME_TYPE_FIRST) {
-    LOG4CXX_DEBUG(logger_, "handleMultiFrameMessage() - FRAME_TYPE_FIRST "
-                 << packet->data_size());
-    incomplete_multi_frame_messages_[key] = packet;
-  } else {
-    LOG4CXX_DEBUG(logger_, "handleMultiFrameMessage() - Consecutive frame");
-
-    std::map<int32_t, ProtocolFramePtr>::iterator it =
-        incomplete_multi_frame_messages_.find(key);
-
-    if (it == incomplete_multi_frame_messages_.end()) {
-      LOG4CXX_ERROR(
-          logger_, "Frame of multiframe message for non-existing session id");
-      return RESULT_FAIL;
-    }
-
-    if (it->second->appendData(packet->data(), packet->data_size())
-        != RESULT_OK) {
-      LOG4CXX_ERROR(logger_,
-          "Failed to append frame for multiframe message.");
-      return RESULT_FAIL;
-    }
-
-    if (packet->frame_data() == FRAME_DATA_LAST_CONSECUTIVE) {
-      LOG4CXX_DEBUG(
-          logger_,
-          "Last frame of multiframe message size " << packet->data_size()
-              << "; connection key " << key);
-      {
-        sync_primitives::AutoLock lock(protocol_observers_lock_);
-        if (protocol_observers_.empty()) {
-          LOG4CXX_ERROR(
-              logger_,
-              "Cannot handle multiframe message: no IProtocolObserver is set.");
-          return RESULT_FAIL;
-        }
-      }
-
-      ProtocolFramePtr completePacket = it->second;
-      const uint32_t connection_key =
-          session_observer_->KeyFromPair(connection_id,
-                                         completePacket->session_id());
-      const RawMessagePtr rawMessage(
-            new RawMessage(connection_key,
-                           completePacket->protocol_version(),
-                           completePacket->data(),
-                           completePacket->total_data_bytes(),
-                           completePacket->service_type(),
-                           completePacket->payload_size()));
-
-      LOG4CXX_DEBUG(logger_,
-                    "total_data_bytes " << completePacket->total_data_bytes() <<
-                    " packet_size " << completePacket->packet_size() <<
-                    " data size " <<  completePacket->data_size() <<
-                    " payload_size " << completePacket->payload_size());
+  RawMessagePtr rawMessage;
+  if (multiframe_builder_.AddFrame(connection_id, key, packet,
+                                &rawMessage) != RESULT_OK) {
+    LOG4CXX_ERROR(logger_,
+        "Failed to append frame for multiframe message.");
+    return RESULT_FAIL;
+  }
+  if (!rawMessage) {
+    // Waiting for next frames of message
+    return RESULT_OK;
+  }
 
-      if (!rawMessage) {
-        return RESULT_FAIL;
-      }
+  LOG4CXX_DEBUG(
+      logger_,
+      "Last frame of multiframe message size " << packet->data_size()
+          << "; total size " << rawMessage->data_size()
+          << "; connection key " << key);
+  if (protocol_observers()->empty()) {
+    LOG4CXX_ERROR(
+        logger_,
+        "Cannot handle multiframe message: no IProtocolObserver is set.");
+    return RESULT_FAIL;
+  }
 
 #ifdef TIME_TESTER
-      if (metric_observer_) {
-        PHMetricObserver::MessageMetric *metric =
-            new PHMetricObserver::MessageMetric();
-        metric->raw_msg = rawMessage;
-        metric_observer_->EndMessageProcess(metric);
-      }
+  if (metric_observer_) {
+    PHMetricObserver::MessageMetric *metric =
+        new PHMetricObserver::MessageMetric();
+    metric->raw_msg = rawMessage;
+    metric_observer_->EndMessageProcess(metric);
+  }
 #endif  // TIME_TESTER
-      // TODO(EZamakhov): check service in session
-      NotifySubscribers(rawMessage);
+  // TODO(EZamakhov): check service in session
+  NotifySubscribers(rawMessage);
+  return RESULT_OK;
+}
 
-      incomplete_multi_frame_messages_.erase(it);
-    }
+void ProtocolHandlerImpl::OnMultiFrameTimeout() {
+  const size_t removed_count = multiframe_builder_.RemoveExpiredMessages();
+  if (removed_count) {
+    LOG4CXX_WARN(logger_, removed_count
+                 << " expired multiframe message(s) dropped");
   }
-  return RESULT_OK;
 }
 
 RESULT_CODE ProtocolHandlerImpl::HandleControlMessage(
@@ -921,6 +966,7 @@ RESULT_CODE ProtocolHandlerImpl::HandleControlMessageEndSession(
   if (session_key != 0) {
     SendEndSessionAck( connection_id, current_session_id,
                        packet.protocol_version(), service_type);
+    sync_primitives::AutoLock lock(message_counters_lock_);
     message_counters_.erase(current_session_id);
   } else {
     LOG4CXX_WARN(
@@ -1102,31 +1148,35 @@ RESULT_CODE ProtocolHandlerImpl::HandleControlMessageHeartBeat(
   }
 }
 
-bool ProtocolHandlerImpl::TrackMessage(const uint32_t& connection_key) {
+bool ProtocolHandlerImpl::TrackMessage(
+    utils::MessageMeter<uint32_t> *const meter,
+    const uint32_t& connection_key) {
   LOG4CXX_AUTO_TRACE(logger_);
   if (message_frequency_time_ > 0u &&
       message_max_frequency_ > 0u) {
-    const size_t message_frequency = message_meter_.TrackMessage(connection_key);
+    const size_t message_frequency = meter->TrackMessage(connection_key);
     LOG4CXX_DEBUG(logger_, "Frequency of " << connection_key << " is " << message_frequency);
     if (message_frequency > message_max_frequency_) {
       LOG4CXX_WARN(logger_, "Frequency of " << connection_key << " is marked as high.");
       if (session_observer_) {
         session_observer_->OnApplicationFloodCallBack(connection_key);
       }
-      message_meter_.RemoveIdentifier(connection_key);
+      meter->RemoveIdentifier(connection_key);
       return true;
     }
   }
   return false;
 }
 
-bool ProtocolHandlerImpl::TrackMalformedMessage(const uint32_t &connection_key,
-                                                const size_t count) {
+bool ProtocolHandlerImpl::TrackMalformedMessage(
+    utils::MessageMeter<uint32_t> *const meter,
+    const uint32_t &connection_key,
+    const size_t count) {
   LOG4CXX_AUTO_TRACE(logger_);
   if (malformed_message_frequency_time_ > 0u &&
       malformed_message_max_frequency_ > 0u) {
     const size_t malformed_message_frequency =
-        malformed_message_meter_.TrackMessages(connection_key, count);
+        meter->TrackMessages(connection_key, count);
     LOG4CXX_DEBUG(logger_, "Malformed frequency of " << connection_key
                   << " is " << malformed_message_frequency);
     if (!malformed_message_filtering_ ||
@@ -1136,7 +1186,7 @@ bool ProtocolHandlerImpl::TrackMalformedMessage(const uint32_t &connection_key,
       if (session_observer_) {
         session_observer_->OnMalformedMessageCallback(connection_key);
       }
-      malformed_message_meter_.RemoveIdentifier(connection_key);
+      meter->RemoveIdentifier(connection_key);
       return true;
     }
   }
@@ -1144,7 +1194,41 @@ bool ProtocolHandlerImpl::TrackMalformedMessage(const uint32_t &connection_key,
 }
 
 void ProtocolHandlerImpl::Handle(
-    const impl::RawFordMessageFromMobile message) {
+    const impl::RawFordMessageFromTransport message) {
+  LOG4CXX_AUTO_TRACE(logger_);
+  impl::InboundShard *shard =
+      inbound_shards_[InboundShardIndex(message.connection_id)];
+
+  switch (message.event) {
+    case impl::RawFordMessageFromTransport::kConnectionEstablished:
+      shard->incoming_data_handler.AddConnection(message.connection_id);
+      return;
+    case impl::RawFordMessageFromTransport::kConnectionClosed:
+      shard->incoming_data_handler.RemoveConnection(message.connection_id);
+      multiframe_builder_.RemoveConnection(message.connection_id);
+      shard->message_meter.ClearIdentifiers();
+      shard->malformed_message_meter.ClearIdentifiers();
+      return;
+    case impl::RawFordMessageFromTransport::kData:
+      break;
+  }
+
+  const std::list<ProtocolFramePtr> frames =
+      ProcessIncomingData(shard, message);
+  for (std::list<ProtocolFramePtr>::const_iterator it = frames.begin();
+       it != frames.end(); ++it) {
+#ifdef TIME_TESTER
+    if (metric_observer_) {
+      metric_observer_->StartMessageProcess(
+          (*it)->message_id(), date_time::DateTime::getCurrentTime());
+    }
+#endif  // TIME_TESTER
+    HandleIncomingFrame(shard, *it);
+  }
+}
+
+void ProtocolHandlerImpl::HandleIncomingFrame(
+    impl::InboundShard *shard, const ProtocolFramePtr message) {
   LOG4CXX_AUTO_TRACE(logger_);
 
   if (NULL == session_observer_) {
@@ -1159,21 +1243,20 @@ void ProtocolHandlerImpl::Handle(
     default: {
         const uint32_t connection_key = session_observer_->KeyFromPair(
               message->connection_id(), message->session_id());
-        if (TrackMessage(connection_key)) {
+        if (TrackMessage(&shard->message_meter, connection_key)) {
           return;
         }
       }
       break;
   }
 
-  connection_handler::ConnectionHandlerImpl *connection_handler =
-        connection_handler::ConnectionHandlerImpl::instance();
   LOG4CXX_DEBUG(logger_, "Message : " << message.get());
   const uint8_t c_id = message->connection_id();
   const uint32_t m_id = message->session_id();
 
   if (session_observer_->IsHeartBeatSupported(c_id, m_id)) {
-    connection_handler->KeepConnectionAlive(c_id, m_id);
+    connection_handler::ConnectionHandlerImpl::instance()->
+        KeepConnectionAlive(c_id, m_id);
   }
 
   // TODO(EZamakhov): remove dublication of IncomingDataHandler logic
@@ -1197,17 +1280,80 @@ void ProtocolHandlerImpl::Handle(const impl::RawFordMessageToMobile message) {
       " protocolVersion " << static_cast<int>(message->protocol_version()));
 
   if (message.is_final) {
+    sync_primitives::AutoLock lock(sessions_last_message_id_lock_);
     sessions_last_message_id_.insert(
         std::pair<uint8_t, uint32_t>(message->session_id(),
                                      message->message_id()));
   }
 
   SendFrame(message);
+
+  const int64_t latency_usecs = date_time::DateTime::getuSecs(
+      date_time::DateTime::Sub(date_time::DateTime::getCurrentTime(),
+                               message.post_time));
+  impl::OutgoingShard *shard =
+      outgoing_shards_[OutgoingShardIndex(message->connection_id())];
+  sync_primitives::AutoLock lock(shard->statistics_lock);
+  OutgoingShardStatistics& statistics = shard->statistics;
+  ++statistics.frames_count;
+  statistics.total_latency_usecs += latency_usecs;
+  statistics.max_latency_usecs =
+      std::max(statistics.max_latency_usecs, latency_usecs);
+}
+
+void ProtocolHandlerImpl::PostFrameToMobile(const ProtocolFramePtr frame,
+                                            bool is_final) {
+  outgoing_shards_[OutgoingShardIndex(frame->connection_id())]
+      ->queue.PostMessage(impl::RawFordMessageToMobile(frame, is_final));
+}
+
+size_t ProtocolHandlerImpl::OutgoingShardIndex(
+    ConnectionID connection_id) const {
+  return connection_id % outgoing_shards_.size();
+}
+
+size_t ProtocolHandlerImpl::InboundShardIndex(
+    ConnectionID connection_id) const {
+  return connection_id % inbound_shards_.size();
+}
+
+uint32_t ProtocolHandlerImpl::NextMessageId(uint8_t session_id) {
+  sync_primitives::AutoLock lock(message_counters_lock_);
+  return message_counters_[session_id]++;
 }
 
 void ProtocolHandlerImpl::Stop() {
-  raw_ford_messages_from_mobile_.Shutdown();
-  raw_ford_messages_to_mobile_.Shutdown();
+  for (size_t i = 0; i < inbound_shards_.size(); ++i) {
+    inbound_shards_[i]->queue.Shutdown();
+  }
+  for (size_t i = 0; i < outgoing_shards_.size(); ++i) {
+    outgoing_shards_[i]->queue.Shutdown();
+#ifdef ENABLE_LOG
+    const OutgoingShardStatistics statistics = outgoing_shard_statistics(i);
+    LOG4CXX_INFO(logger_, "Outgoing shard " << i << ": "
+                 << statistics.frames_count << " frames, latency average "
+                 << (statistics.frames_count ?
+                     statistics.total_latency_usecs / statistics.frames_count :
+                     0)
+                 << " us, max " << statistics.max_latency_usecs << " us");
+#endif  // ENABLE_LOG
+  }
+}
+
+size_t ProtocolHandlerImpl::inbound_shards_count() const {
+  return inbound_shards_.size();
+}
+
+size_t ProtocolHandlerImpl::outgoing_shards_count() const {
+  return outgoing_shards_.size();
+}
+
+OutgoingShardStatistics ProtocolHandlerImpl::outgoing_shard_statistics(
+    size_t shard) const {
+  DCHECK_OR_RETURN(shard < outgoing_shards_.size(),
+                   OutgoingShardStatistics());
+  sync_primitives::AutoLock lock(outgoing_shards_[shard]->statistics_lock);
+  return outgoing_shards_[shard]->statistics;
 }
 
 #ifdef ENABLE_SECURITY
@@ -1242,10 +1388,16 @@ RESULT_CODE ProtocolHandlerImpl::EncryptFrame(ProtocolFramePtr packet) {
   if (!context || !context->IsInitCompleted()) {
     return RESULT_OK;
   }
-  const uint8_t *out_data;
-  size_t out_data_size;
-  if (!context->Encrypt(packet->data(), packet->data_size(),
-                       &out_data, &out_data_size)) {
+  // Encrypt directly to the new packet payload buffer
+  const size_t out_buffer_size =
+      context->get_max_encrypted_size(packet->data_size());
+  uint8_t *out_buffer =
+      static_cast<uint8_t*>(utils::MemoryPool::Allocate(out_buffer_size));
+  security_manager::SSLContext::Frame frame =
+      {packet->data(), packet->data_size(), out_buffer, out_buffer_size, 0,
+       security_manager::SSLContext::Frame_Result_NotProcessed};
+  if (!out_buffer || 1u != context->EncryptBatch(&frame, 1u)) {
+    utils::MemoryPool::Release(out_buffer);
     const std::string error_text(context->LastError());
     LOG4CXX_ERROR(logger_, "Enryption failed: " << error_text);
     security_manager_->SendInternalError(connection_key,
@@ -1257,61 +1409,148 @@ RESULT_CODE ProtocolHandlerImpl::EncryptFrame(ProtocolFramePtr packet) {
     return RESULT_OK;
   };
   LOG4CXX_DEBUG(logger_, "Encrypted " << packet->data_size() << " bytes to "
-                << out_data_size << " bytes");
-  DCHECK(out_data);
-  DCHECK(out_data_size);
+                << frame.out_data_size << " bytes");
+  DCHECK(frame.out_data_size);
   packet->set_protection_flag(true);
-  packet->set_data(out_data, out_data_size);
+  packet->set_data_buffer(out_buffer, frame.out_data_size);
   return RESULT_OK;
 }
 
-RESULT_CODE ProtocolHandlerImpl::DecryptFrame(ProtocolFramePtr packet) {
-  DCHECK(packet);
-  if (!packet->protection_flag() ||
-     // Control frames and data over control service shall be unprotected
-     packet->service_type() == kControl ||
-     packet->frame_type() == FRAME_TYPE_CONTROL) {
-    return RESULT_OK;
+void ProtocolHandlerImpl::DecryptFrames(
+    std::list<ProtocolFramePtr> *const frames) {
+  DCHECK(frames);
+  std::set<const ProtocolPacket*> failed_frames;
+  // Sequential frames of the same protected service are decrypted at once
+  std::vector<ProtocolFramePtr> batch;
+  security_manager::SSLContext *batch_context = NULL;
+  for (std::list<ProtocolFramePtr>::const_iterator it = frames->begin();
+       it != frames->end(); ++it) {
+    const ProtocolFramePtr frame = *it;
+    if (!frame->protection_flag() ||
+        // Control frames and data over control service shall be unprotected
+        frame->service_type() == kControl ||
+        frame->frame_type() == FRAME_TYPE_CONTROL ||
+        // First frame payload holds sizes already read on deserialization
+        frame->frame_type() == FRAME_TYPE_FIRST) {
+      continue;
+    }
+    security_manager::SSLContext *context = NULL;
+    if (!GetDecryptionContext(frame, &context)) {
+      failed_frames.insert(frame.get());
+      continue;
+    }
+    if (context != batch_context) {
+      DecryptBatch(batch_context, batch, &failed_frames);
+      batch.clear();
+      batch_context = context;
+    }
+    batch.push_back(frame);
   }
+  DecryptBatch(batch_context, batch, &failed_frames);
+
+  if (failed_frames.empty()) {
+    return;
+  }
+  LOG4CXX_WARN(logger_, "Error frame decryption. "
+               << failed_frames.size() << " frame(s) skipped.");
+  std::list<ProtocolFramePtr>::iterator it = frames->begin();
+  while (it != frames->end()) {
+    if (failed_frames.end() != failed_frames.find(it->get())) {
+      it = frames->erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool ProtocolHandlerImpl::GetDecryptionContext(
+    const ProtocolFramePtr packet,
+    security_manager::SSLContext **const context) {
   if (!session_observer_) {
     LOG4CXX_WARN(logger_, "No session_observer_ set.");
-    return RESULT_FAIL;
+    return false;
   }
   if (!security_manager_) {
     LOG4CXX_WARN(logger_, "No security_manager_ set.");
-    return RESULT_FAIL;
+    return false;
   }
   const uint32_t connection_key = session_observer_->KeyFromPair(
         packet->connection_id(), packet->session_id());
-  security_manager::SSLContext *context = session_observer_->GetSSLContext(
+  *context = session_observer_->GetSSLContext(
         connection_key, ServiceTypeFromByte(packet->service_type()));
-  if (!context || !context->IsInitCompleted()) {
+  if (!*context || !(*context)->IsInitCompleted()) {
     const std::string error_text("Fail decryption for unprotected service ");
     LOG4CXX_ERROR(logger_, error_text << static_cast<int>(packet->service_type()));
     security_manager_->SendInternalError(connection_key,
           security_manager::SecurityManager::ERROR_SERVICE_NOT_PROTECTED, error_text);
-    return RESULT_ENCRYPTION_FAILED;
+    return false;
   }
-  const uint8_t *out_data;
-  size_t out_data_size;
-  if (!context->Decrypt(packet->data(), packet->data_size(),
-                       &out_data, &out_data_size)) {
-    const std::string error_text(context->LastError());
-    LOG4CXX_ERROR(logger_, "Decryption failed: " << error_text);
-    security_manager_->SendInternalError(connection_key,
-          security_manager::SecurityManager::ERROR_DECRYPTION_FAILED, error_text);
-    // Close session to prevent usage unprotected service/session
-    session_observer_->OnSessionEndedCallback(
-          packet->connection_id(), packet->session_id(),
-          packet->message_id(),    kRpc);
-    return RESULT_ENCRYPTION_FAILED;
-  };
-  LOG4CXX_DEBUG(logger_, "Decrypted " << packet->data_size() << " bytes to "
-                << out_data_size << " bytes");
-  DCHECK(out_data);
-  DCHECK(out_data_size);
-  packet->set_data(out_data, out_data_size);
-  return RESULT_OK;
+  return true;
+}
+
+void ProtocolHandlerImpl::DecryptBatch(
+    security_manager::SSLContext *const context,
+    const std::vector<ProtocolFramePtr> &batch,
+    std::set<const ProtocolPacket*> *const failed_frames) {
+  if (batch.empty()) {
+    return;
+  }
+  DCHECK(context);
+  // Frames are decrypted in place without additional buffers
+  std::vector<security_manager::SSLContext::Frame> ssl_frames(batch.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    security_manager::SSLContext::Frame &ssl_frame = ssl_frames[i];
+    ssl_frame.in_data = batch[i]->data();
+    ssl_frame.in_data_size = batch[i]->data_size();
+    ssl_frame.out_data = batch[i]->data();
+    ssl_frame.out_buffer_size = batch[i]->data_size();
+    ssl_frame.out_data_size = 0;
+    ssl_frame.result = security_manager::SSLContext::Frame_Result_NotProcessed;
+  }
+  context->DecryptBatch(&ssl_frames[0], ssl_frames.size());
+  const ProtocolFramePtr *failed = NULL;
+  for (size_t i = 0; i < batch.size(); ++i) {
+    const security_manager::SSLContext::Frame &ssl_frame = ssl_frames[i];
+    if (security_manager::SSLContext::Frame_Result_Success != ssl_frame.result) {
+      if (!failed &&
+          security_manager::SSLContext::Frame_Result_NotProcessed !=
+          ssl_frame.result) {
+        failed = &batch[i];
+      }
+      failed_frames->insert(batch[i].get());
+      continue;
+    }
+    LOG4CXX_DEBUG(logger_, "Decrypted " << batch[i]->data_size() << " bytes to "
+                  << ssl_frame.out_data_size << " bytes");
+    if (ssl_frame.out_data == batch[i]->data()) {
+      batch[i]->set_data_buffer(batch[i]->data(), ssl_frame.out_data_size);
+      continue;
+    }
+    // Plain data of a record split between frames is longer than
+    // the frame ciphertext and is held by SSLContext up to the next batch
+    uint8_t *out_buffer = static_cast<uint8_t*>(
+        utils::MemoryPool::Allocate(ssl_frame.out_data_size));
+    if (!out_buffer) {
+      failed_frames->insert(batch[i].get());
+      continue;
+    }
+    memcpy(out_buffer, ssl_frame.out_data, ssl_frame.out_data_size);
+    batch[i]->set_data_buffer(out_buffer, ssl_frame.out_data_size);
+  }
+  if (!failed) {
+    return;
+  }
+  const uint32_t connection_key = session_observer_->KeyFromPair(
+        (*failed)->connection_id(), (*failed)->session_id());
+  const std::string error_text(context->LastError());
+  LOG4CXX_ERROR(logger_, "Decryption failed: " << error_text);
+  security_manager_->SendInternalError(connection_key,
+        security_manager::SecurityManager::ERROR_DECRYPTION_FAILED, error_text);
+  // Close session to prevent usage unprotected service/session,
+  // the rest of batch could not be decrypted after session closing
+  session_observer_->OnSessionEndedCallback(
+        (*failed)->connection_id(), (*failed)->session_id(),
+        (*failed)->message_id(),    kRpc);
 }
 #endif  // ENABLE_SECURITY
 
@@ -1330,15 +1569,14 @@ void ProtocolHandlerImpl::SendFramesNumber(uint32_t connection_key,
     ProtocolFramePtr ptr(new protocol_handler::ProtocolPacket(connection_id,
 	  	  protocol_version, PROTECTION_OFF, FRAME_TYPE_CONTROL,
 	        SERVICE_TYPE_NAVI, FRAME_DATA_SERVICE_DATA_ACK,
-	        session_id, 0, message_counters_[session_id]++));
+	        session_id, 0, NextMessageId(session_id)));
 
     // Flow control data shall be 4 bytes according Ford Protocol
     DCHECK(sizeof(number_of_frames) == 4);
     number_of_frames = LE_TO_BE32(number_of_frames);
     ptr->set_data(reinterpret_cast<const uint8_t*>(&number_of_frames),
 	                  sizeof(number_of_frames));
-	raw_ford_messages_to_mobile_.PostMessage(
-	     impl::RawFordMessageToMobile(ptr, false));
+	PostFrameToMobile(ptr, false);
 	LOG4CXX_DEBUG(logger_, "SendFramesNumber finished successfully");
   } else {
 	  LOG4CXX_WARN(logger_, "SendFramesNumber is failed connection or session does not exist");
@@ -38,8 +38,10 @@
 
 #include "protocol/common.h"
 #include "protocol_handler/protocol_packet.h"
+#include "protocol_handler/header_layout.h"
 #include "utils/macro.h"
 #include "utils/byte_order.h"
+#include "utils/memory_pool.h"
 
 namespace protocol_handler {
 
@@ -47,7 +49,7 @@ ProtocolPacket::ProtocolData::ProtocolData()
   : data(NULL), totalDataBytes(0u) { }
 
 ProtocolPacket::ProtocolData::~ProtocolData() {
-  delete[] data;
+  utils::MemoryPool::Release(data);
 }
 
 ProtocolPacket::ProtocolHeader::ProtocolHeader()
@@ -74,50 +76,43 @@ ProtocolPacket::ProtocolHeader::ProtocolHeader(
     messageId(messageID) {
 }
 
-inline uint32_t read_be_uint32(const uint8_t* const data) {
-  // Int value read byte per byte
-  // reintercast for non-4 byte address alignment lead to UB on arm platform
-  uint32_t value = data[3];
-  value += (data[2] <<  8);
-  value += (data[1] << 16);
-  value += (data[0] << 24);
-  return value;
-}
-
 void ProtocolPacket::ProtocolHeader::deserialize(
     const uint8_t* message, const size_t messageSize) {
-  if (messageSize < PROTOCOL_HEADER_V1_SIZE) {
+  if (messageSize < FrameHeaderLayoutV1::kSize) {
     return;
   }
-  // first 4 bits
-  version = message[0] >> 4u;
-  // 5th bit
-  protection_flag = message[0] & 0x08u;
-  // 6-8 bits
-  frameType = message[0] & 0x07u;
+  const uint8_t flags = message[FrameHeaderLayoutV1::kFlagsOffset];
+  version = flags >> FrameFlagsLayout::kVersionShift;
+  protection_flag = flags & FrameFlagsLayout::kProtectionMask;
+  frameType = flags & FrameFlagsLayout::kFrameTypeMask;
 
-  serviceType = message[1];
-  frameData   = message[2];
-  sessionId   = message[3];
+  serviceType = message[FrameHeaderLayoutV1::kServiceTypeOffset];
+  frameData   = message[FrameHeaderLayoutV1::kFrameDataOffset];
+  sessionId   = message[FrameHeaderLayoutV1::kSessionIdOffset];
 
   // FIXME(EZamakhov): usage for FirstFrame message
-  dataSize = read_be_uint32(message + 4);
-  switch (version) {
-    case PROTOCOL_VERSION_2:
-    case PROTOCOL_VERSION_3:
-    case PROTOCOL_VERSION_4:{
-        if (messageSize < PROTOCOL_HEADER_V2_SIZE) {
-          return;
-        }
-        messageId = read_be_uint32(message + 8);
-      }
-      break;
-    default:
-      messageId = 0;
-      break;
+  dataSize = ReadBigEndian32(message + FrameHeaderLayoutV1::kDataSizeOffset);
+  messageId = 0;
+  if (HasMessageId(version) && messageSize >= FrameHeaderLayoutV2::kSize) {
+    messageId =
+        ReadBigEndian32(message + FrameHeaderLayoutV2::kMessageIdOffset);
   }
 }
 
+size_t ProtocolPacket::ProtocolHeader::serialize(uint8_t *buffer) const {
+  buffer[FrameHeaderLayoutV2::kFlagsOffset] =
+      (version << FrameFlagsLayout::kVersionShift) |
+      (protection_flag ? FrameFlagsLayout::kProtectionMask : 0) |
+      (frameType & FrameFlagsLayout::kFrameTypeMask);
+  buffer[FrameHeaderLayoutV2::kServiceTypeOffset] = serviceType;
+  buffer[FrameHeaderLayoutV2::kFrameDataOffset] = frameData;
+  buffer[FrameHeaderLayoutV2::kSessionIdOffset] = sessionId;
+  WriteBigEndian32(buffer + FrameHeaderLayoutV2::kDataSizeOffset, dataSize);
+  // Message id is always written, version 1 header size excludes it
+  WriteBigEndian32(buffer + FrameHeaderLayoutV2::kMessageIdOffset, messageId);
+  return FrameHeaderSize(version);
+}
+
 ProtocolPacket::ProtocolHeaderValidator::ProtocolHeaderValidator()
   : max_payload_size_(std::numeric_limits<size_t>::max()) {
 }
@@ -246,51 +241,24 @@ ProtocolPacket::ProtocolPacket(ConnectionID connection_id)
 
 // Serialization
 RawMessagePtr ProtocolPacket::serializePacket() const {
-  // TODO(EZamakhov): Move header serialization to ProtocolHeader
-  // version is low byte
-  const uint8_t version_byte = packet_header_.version << 4;
-  // protection is first bit of second byte
-  const uint8_t protection_byte = packet_header_.protection_flag ? (0x8) : 0x0;
-  // frame type is last 3 bits of second byte
-  const uint8_t frame_type_byte = packet_header_.frameType & 0x07;
-
-  uint8_t header[PROTOCOL_HEADER_V2_SIZE];
-  uint8_t offset = 0;
-  header[offset++] = version_byte | protection_byte | frame_type_byte;
-  header[offset++] = packet_header_.serviceType;
-  header[offset++] = packet_header_.frameData;
-  header[offset++] = packet_header_.sessionId;
-
-  header[offset++] = packet_header_.dataSize >> 24;
-  header[offset++] = packet_header_.dataSize >> 16;
-  header[offset++] = packet_header_.dataSize >> 8;
-  header[offset++] = packet_header_.dataSize;
-
-  if (packet_header_.version != PROTOCOL_VERSION_1) {
-    header[offset++] = packet_header_.messageId >> 24;
-    header[offset++] = packet_header_.messageId >> 16;
-    header[offset++] = packet_header_.messageId >> 8;
-    header[offset++] = packet_header_.messageId;
-  };
-
-  size_t total_packet_size = offset + (packet_data_.data ? packet_data_.totalDataBytes : 0);
-
-  uint8_t *packet = new (std::nothrow) uint8_t[total_packet_size];
+  uint8_t header[FrameHeaderLayoutV2::kSize];
+  const size_t header_size = packet_header_.serialize(header);
+  const size_t data_size =
+      packet_data_.data ? packet_data_.totalDataBytes : 0u;
+
+  // Header and payload are written straight into the message buffer
+  const RawMessagePtr out_message(
+      RawMessage::CreateUninitialized(connection_id(), packet_header_.version,
+                                      header_size + data_size,
+                                      packet_header_.serviceType));
+  uint8_t *packet = out_message->data();
   if (!packet) {
     return RawMessagePtr();
   }
-
-  memcpy(packet, header, offset);
-  if (packet_data_.data && packet_data_.totalDataBytes) {
-    memcpy(packet + offset, packet_data_.data, packet_data_.totalDataBytes);
+  memcpy(packet, header, header_size);
+  if (data_size) {
+    memcpy(packet + header_size, packet_data_.data, data_size);
   }
-
-  const RawMessagePtr out_message(
-        new RawMessage(
-          connection_id(), packet_header_.version,
-          packet, total_packet_size, packet_header_.serviceType) );
-
-  delete[] packet;
   return out_message;
 }
 
@@ -339,10 +307,16 @@ bool ProtocolPacket::operator==(const ProtocolPacket& other) const {
 
 RESULT_CODE ProtocolPacket::deserializePacket(
     const uint8_t *message, const size_t messageSize) {
-  packet_header_.deserialize(message, messageSize);
-  const uint8_t offset =
-      packet_header_.version == PROTOCOL_VERSION_1 ? PROTOCOL_HEADER_V1_SIZE
-                                                   : PROTOCOL_HEADER_V2_SIZE;
+  ProtocolHeader header;
+  header.deserialize(message, messageSize);
+  return deserializePacket(header, message, messageSize);
+}
+
+RESULT_CODE ProtocolPacket::deserializePacket(
+    const ProtocolHeader &header,
+    const uint8_t *message, const size_t messageSize) {
+  packet_header_ = header;
+  const size_t offset = FrameHeaderSize(packet_header_.version);
 
   packet_data_.totalDataBytes = packet_header_.dataSize;
 
@@ -354,7 +328,8 @@ RESULT_CODE ProtocolPacket::deserializePacket(
 
   uint8_t *data = NULL;
   if (dataPayloadSize) {
-    data = new (std::nothrow) uint8_t[dataPayloadSize];
+    data = static_cast<uint8_t*>(
+        utils::MemoryPool::Allocate(dataPayloadSize));
     if (!data) {
       return RESULT_FAIL;
     }
@@ -364,17 +339,17 @@ RESULT_CODE ProtocolPacket::deserializePacket(
 
   if (packet_header_.frameType == FRAME_TYPE_FIRST) {
     payload_size_ = 0;
-    const uint8_t *data = message + offset;
-    uint32_t total_data_bytes = data[0] << 24;
-    total_data_bytes |= data[1] << 16;
-    total_data_bytes |= data[2] << 8;
-    total_data_bytes |= data[3];
-    set_total_data_bytes(total_data_bytes);
-    if (0 == packet_data_.data) {
+    if (messageSize < offset + sizeof(uint32_t)) {
       return RESULT_FAIL;
     }
+    const uint32_t total_data_bytes = ReadBigEndian32(message + offset);
+    // Buffer for the whole message is allocated by MultiFrameBuilder
+    // within its limits, first frame only keeps the total size
+    utils::MemoryPool::Release(packet_data_.data);
+    packet_data_.data = NULL;
+    packet_data_.totalDataBytes = total_data_bytes;
   } else {
-    delete[] packet_data_.data;
+    utils::MemoryPool::Release(packet_data_.data);
     packet_data_.data = data;
   }
 
@@ -423,8 +398,9 @@ uint8_t *ProtocolPacket::data() const {
 
 void ProtocolPacket::set_total_data_bytes(size_t dataBytes) {
   if (dataBytes) {
-    delete[] packet_data_.data;
-    packet_data_.data = new (std::nothrow) uint8_t[dataBytes];
+    utils::MemoryPool::Release(packet_data_.data);
+    packet_data_.data =
+        static_cast<uint8_t*>(utils::MemoryPool::Allocate(dataBytes));
     packet_data_.totalDataBytes = packet_data_.data ? dataBytes : 0u;
   }
 }
@@ -433,8 +409,9 @@ void ProtocolPacket::set_data(
     const uint8_t *const new_data, const size_t new_data_size) {
   if (new_data_size && new_data) {
     packet_header_.dataSize = packet_data_.totalDataBytes = new_data_size;
-    delete[] packet_data_.data;
-    packet_data_.data = new (std::nothrow) uint8_t[packet_data_.totalDataBytes];
+    utils::MemoryPool::Release(packet_data_.data);
+    packet_data_.data = static_cast<uint8_t*>(
+        utils::MemoryPool::Allocate(packet_data_.totalDataBytes));
     if (packet_data_.data) {
       memcpy(packet_data_.data, new_data, packet_data_.totalDataBytes);
     } else {
@@ -444,6 +421,16 @@ void ProtocolPacket::set_data(
   }
 }
 
+void ProtocolPacket::set_data_buffer(
+    uint8_t *const new_data, const size_t new_data_size) {
+  if (new_data != packet_data_.data) {
+    utils::MemoryPool::Release(packet_data_.data);
+    packet_data_.data = new_data;
+  }
+  packet_header_.dataSize = packet_data_.totalDataBytes =
+      new_data ? new_data_size : 0u;
+}
+
 uint32_t ProtocolPacket::total_data_bytes() const {
   return packet_data_.totalDataBytes;
 }
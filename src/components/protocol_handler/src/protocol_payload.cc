@@ -33,6 +33,7 @@
 
 #include <climits>
 
+#include "protocol_handler/header_layout.h"
 #include "utils/bitstream.h"
 #include "utils/macro.h"
 
@@ -78,6 +79,49 @@ void Extract(utils::BitStream *bs, ProtocolPayloadV2 *payload,
   }
 }
 
+bool ParsePayloadV2(const uint8_t *data, size_t data_size,
+                    ProtocolPayloadV2 *payload) {
+  DCHECK_OR_RETURN(payload, false);
+  if (!data || data_size < PayloadHeaderLayout::kSize) {
+    return false;
+  }
+  ProtocolPayloadHeaderV2 &header = payload->header;
+  const uint32_t type_and_function =
+      ReadBigEndian32(data + PayloadHeaderLayout::kFunctionIdOffset);
+  header.rpc_type = RpcTypeFromByte(
+      type_and_function >> PayloadHeaderLayout::kRpcTypeShift);
+  header.rpc_function_id =
+      type_and_function & PayloadHeaderLayout::kFunctionIdMask;
+  header.correlation_id =
+      ReadBigEndian32(data + PayloadHeaderLayout::kCorrelationIdOffset);
+  header.json_size =
+      ReadBigEndian32(data + PayloadHeaderLayout::kJsonSizeOffset);
+  if (header.rpc_type == kRpcTypeReserved ||
+      header.json_size > data_size - PayloadHeaderLayout::kSize) {
+    return false;
+  }
+  const uint8_t *json = data + PayloadHeaderLayout::kSize;
+  const uint8_t *binary = json + header.json_size;
+  payload->json.assign(reinterpret_cast<const char*>(json), header.json_size);
+  payload->data.assign(binary, data + data_size);
+  return true;
+}
+
+size_t WritePayloadHeaderV2(const ProtocolPayloadHeaderV2 &header,
+                            uint8_t *buffer) {
+  const uint32_t type_and_function =
+      (static_cast<uint32_t>(RpcTypeToByte(header.rpc_type)) <<
+       PayloadHeaderLayout::kRpcTypeShift) |
+      (header.rpc_function_id & PayloadHeaderLayout::kFunctionIdMask);
+  WriteBigEndian32(buffer + PayloadHeaderLayout::kFunctionIdOffset,
+                   type_and_function);
+  WriteBigEndian32(buffer + PayloadHeaderLayout::kCorrelationIdOffset,
+                   header.correlation_id);
+  WriteBigEndian32(buffer + PayloadHeaderLayout::kJsonSizeOffset,
+                   header.json_size);
+  return PayloadHeaderLayout::kSize;
+}
+
 std::ostream &operator<<(std::ostream &os,
                          const ProtocolPayloadHeaderV2 &payload_header) {
   return os << "(ProtocolPayloadHeaderV2"     << "  rpc_type: "
@@ -0,0 +1,437 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "utils/atomic.h"
+#include "utils/date_time.h"
+#include "utils/lock.h"
+#include "utils/macro.h"
+#include "protocol_handler/protocol_handler_impl.h"
+#include "protocol_handler/protocol_observer.h"
+#include "protocol_handler/session_observer.h"
+#include "transport_manager/transport_manager.h"
+#ifdef ENABLE_SECURITY
+#include "security_manager/security_manager.h"
+#endif  // ENABLE_SECURITY
+
+namespace test {
+namespace components {
+namespace protocol_handler_test {
+using namespace protocol_handler;
+using transport_manager::ConnectionUID;
+using transport_manager::TransportManagerListener;
+
+namespace {
+const ConnectionUID kConnectionsCount = 8;
+const uint8_t kSessionId = 1u;
+const size_t kPayloadSize = 1024;
+const int64_t kWaitingTimeoutMs = 60000;
+const size_t kOutgoingWorkersCount = 4u;
+
+/*
+ * Transport manager which only counts forced disconnects,
+ * data from mobile is passed to protocol handler by test
+ */
+class FakeTransportManager : public transport_manager::TransportManager {
+ public:
+  FakeTransportManager() : disconnect_force_count_(0) {}
+  int Init() { return 0; }
+  int Reinit() { return 0; }
+  int SearchDevices() { return 0; }
+  int ConnectDevice(const transport_manager::DeviceHandle&) { return 0; }
+  int DisconnectDevice(const transport_manager::DeviceHandle&) { return 0; }
+  int Disconnect(const ConnectionUID&) { return 0; }
+  int DisconnectForce(const ConnectionUID&) {
+    atomic_post_inc(&disconnect_force_count_);
+    return 0;
+  }
+  int SendMessageToDevice(const RawMessagePtr) { return 0; }
+  int ReceiveEventFromDevice(
+      const transport_manager::TransportAdapterEvent&) { return 0; }
+  int AddTransportAdapter(
+      transport_manager::transport_adapter::TransportAdapter*) { return 0; }
+  int AddEventListener(TransportManagerListener*) { return 0; }
+  int Stop() { return 0; }
+  int RemoveDevice(const transport_manager::DeviceHandle&) { return 0; }
+  int Visibility(const bool&) const { return 0; }
+  uint32_t disconnect_force_count() const { return disconnect_force_count_; }
+
+ private:
+  volatile uint32_t disconnect_force_count_;
+};
+
+/*
+ * Transport manager which checks order of frames sent to each connection,
+ * frame payload starts with its number within connection
+ */
+class OrderCheckingTransportManager : public FakeTransportManager {
+ public:
+  OrderCheckingTransportManager()
+    : next_numbers_(kConnectionsCount + 1, 0),
+      sent_count_(0),
+      reordered_count_(0) {}
+  int SendMessageToDevice(const RawMessagePtr message) {
+    const uint8_t* data = message->data() + PROTOCOL_HEADER_V2_SIZE;
+    const uint32_t number = (data[0] << 24) | (data[1] << 16) |
+                            (data[2] << 8) | data[3];
+    sync_primitives::AutoLock auto_lock(lock_);
+    uint32_t& next_number = next_numbers_[message->connection_key()];
+    if (number != next_number) {
+      ++reordered_count_;
+    }
+    next_number = number + 1;
+    ++sent_count_;
+    return 0;
+  }
+  bool WaitForFrames(uint32_t count) const {
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    while (sent_count() < count) {
+      if (date_time::DateTime::calculateTimeSpan(start) > kWaitingTimeoutMs) {
+        return false;
+      }
+      usleep(1000);
+    }
+    return true;
+  }
+  uint32_t sent_count() const {
+    sync_primitives::AutoLock auto_lock(lock_);
+    return sent_count_;
+  }
+  uint32_t reordered_count() const {
+    sync_primitives::AutoLock auto_lock(lock_);
+    return reordered_count_;
+  }
+
+ private:
+  mutable sync_primitives::Lock lock_;
+  std::vector<uint32_t> next_numbers_;
+  uint32_t sent_count_;
+  uint32_t reordered_count_;
+};
+
+/*
+ * Session observer with connection handle used as connection key,
+ * lock-free to not serialize incoming workers
+ */
+class FakeSessionObserver : public SessionObserver {
+ public:
+  uint32_t OnSessionStartedCallback(const ConnectionUID&, const uint8_t,
+                                    const ServiceType&, const bool,
+                                    uint32_t*) { return 0; }
+  uint32_t OnSessionEndedCallback(const ConnectionUID&, const uint8_t,
+                                  const uint32_t&,
+                                  const ServiceType&) { return 0; }
+  void OnApplicationFloodCallBack(const uint32_t&) {}
+  void OnMalformedMessageCallback(const uint32_t&) {}
+  uint32_t KeyFromPair(ConnectionUID connection_handle, uint8_t) {
+    return connection_handle;
+  }
+  void PairFromKey(uint32_t key, ConnectionUID* connection_handle,
+                   uint8_t* session_id) {
+    *connection_handle = key;
+    *session_id = kSessionId;
+  }
+  int32_t GetDataOnSessionKey(uint32_t, uint32_t*, std::list<int32_t>*,
+                              uint32_t*) { return 0; }
+  int32_t GetDataOnDeviceID(uint32_t, std::string*, std::list<uint32_t>*,
+                            std::string*, std::string*) { return 0; }
+  bool IsHeartBeatSupported(ConnectionUID, uint8_t) { return false; }
+  bool ProtocolVersionUsed(uint32_t, uint8_t, uint8_t&) { return false; }
+#ifdef ENABLE_SECURITY
+  int SetSSLContext(const uint32_t&, security_manager::SSLContext*) {
+    return 0;
+  }
+  security_manager::SSLContext* GetSSLContext(const uint32_t&,
+                                              const ServiceType&) {
+    return NULL;
+  }
+  void SetProtectionFlag(const uint32_t&, const ServiceType&) {}
+#endif  // ENABLE_SECURITY
+};
+
+#ifdef ENABLE_SECURITY
+/*
+ * Security manager without SSL contexts, so frames are not protected
+ */
+class FakeSecurityManager : public security_manager::SecurityManager {
+ public:
+  void set_session_observer(SessionObserver*) {}
+  void set_protocol_handler(ProtocolHandler*) {}
+  void set_crypto_manager(security_manager::CryptoManager*) {}
+  void SendInternalError(const uint32_t, const uint8_t&, const std::string&,
+                         const uint32_t) {}
+  security_manager::SSLContext* CreateSSLContext(const uint32_t&) {
+    return NULL;
+  }
+  void StartHandshake(uint32_t) {}
+  void AddListener(security_manager::SecurityManagerListener* const) {}
+  void RemoveListener(security_manager::SecurityManagerListener* const) {}
+  void OnMessageReceived(const RawMessagePtr) {}
+  void OnMobileMessageSent(const RawMessagePtr) {}
+};
+#endif  // ENABLE_SECURITY
+
+/*
+ * Checks order of messages of each connection and emulates
+ * their processing by higher layer
+ */
+class OrderCheckingObserver : public ProtocolObserver {
+ public:
+  explicit OrderCheckingObserver(size_t work_rounds)
+    : work_rounds_(work_rounds),
+      next_numbers_(kConnectionsCount + 1, 0),
+      received_count_(0),
+      reordered_count_(0),
+      checksum_(0) {}
+
+  void OnMessageReceived(const RawMessagePtr message) {
+    // Messages of one connection come from one worker only
+    const uint32_t connection = message->connection_key();
+    const uint8_t* data = message->data();
+    const uint32_t number = (data[0] << 24) | (data[1] << 16) |
+                            (data[2] << 8) | data[3];
+    if (number != next_numbers_[connection]) {
+      atomic_post_inc(&reordered_count_);
+    }
+    next_numbers_[connection] = number + 1;
+    uint32_t checksum = 0;
+    for (size_t round = 0; round < work_rounds_; ++round) {
+      for (size_t i = 0; i < message->data_size(); ++i) {
+        checksum = checksum * 31 + data[i];
+      }
+    }
+    __sync_fetch_and_add(&checksum_, checksum);
+    atomic_post_inc(&received_count_);
+  }
+  void OnMobileMessageSent(const RawMessagePtr) {}
+
+  bool WaitForMessages(uint32_t count) const {
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    while (received_count_ < count) {
+      if (date_time::DateTime::calculateTimeSpan(start) > kWaitingTimeoutMs) {
+        return false;
+      }
+      usleep(1000);
+    }
+    return true;
+  }
+  uint32_t reordered_count() const { return reordered_count_; }
+
+ private:
+  const size_t work_rounds_;
+  std::vector<uint32_t> next_numbers_;
+  volatile uint32_t received_count_;
+  volatile uint32_t reordered_count_;
+  volatile uint32_t checksum_;
+};
+
+std::vector<RawMessagePtr> CreateTransportData(uint32_t messages_count) {
+  std::vector<RawMessagePtr> data;
+  std::vector<uint8_t> payload(kPayloadSize, 0x5A);
+  for (uint32_t number = 0; number < messages_count; ++number) {
+    payload[0] = number >> 24;
+    payload[1] = number >> 16;
+    payload[2] = number >> 8;
+    payload[3] = number;
+    // Messages of all connections are interleaved as transport delivers them
+    for (ConnectionID connection = 1; connection <= kConnectionsCount;
+         ++connection) {
+      // Message id shall be greater than zero
+      const ProtocolPacket packet(
+          connection, PROTOCOL_VERSION_2, PROTECTION_OFF, FRAME_TYPE_SINGLE,
+          kRpc, FRAME_DATA_SINGLE, kSessionId, payload.size(), number + 1,
+          &payload[0]);
+      data.push_back(packet.serializePacket());
+    }
+  }
+  return data;
+}
+
+/*
+ * Passes data of all connections through protocol handler
+ * \return milliseconds till the last message has been handled
+ */
+int64_t PassData(size_t workers_count, size_t work_rounds,
+                 const std::vector<RawMessagePtr>& data,
+                 uint32_t* reordered_count, uint32_t* disconnect_force_count) {
+  FakeTransportManager transport_manager;
+  FakeSessionObserver session_observer;
+  OrderCheckingObserver observer(work_rounds);
+  ProtocolHandlerImpl protocol_handler(&transport_manager, 0u, 0u, false,
+                                       0u, 0u, workers_count,
+                                       kOutgoingWorkersCount);
+  protocol_handler.set_session_observer(&session_observer);
+  protocol_handler.AddProtocolObserver(&observer);
+  TransportManagerListener* listener = &protocol_handler;
+  const transport_manager::DeviceInfo device_info(1u, "mac", "name", "USB");
+  for (ConnectionID connection = 1; connection <= kConnectionsCount;
+       ++connection) {
+    listener->OnConnectionEstablished(device_info, connection);
+  }
+
+  const TimevalStruct start = date_time::DateTime::getCurrentTime();
+  for (size_t i = 0; i < data.size(); ++i) {
+    listener->OnTMMessageReceived(data[i]);
+  }
+  EXPECT_TRUE(observer.WaitForMessages(data.size()));
+  const int64_t duration_ms = date_time::DateTime::calculateTimeSpan(start);
+
+  for (ConnectionID connection = 1; connection <= kConnectionsCount;
+       ++connection) {
+    listener->OnConnectionClosed(connection);
+  }
+  protocol_handler.RemoveProtocolObserver(&observer);
+  protocol_handler.Stop();
+  *reordered_count = observer.reordered_count();
+  *disconnect_force_count = transport_manager.disconnect_force_count();
+  return duration_ms;
+}
+}  // namespace
+
+TEST(InboundShardsTest, Create_ZeroWorkers_OneShardCreated) {
+  FakeTransportManager transport_manager;
+  ProtocolHandlerImpl protocol_handler(&transport_manager, 0u, 0u, false,
+                                       0u, 0u, 0u, kOutgoingWorkersCount);
+  EXPECT_EQ(1u, protocol_handler.inbound_shards_count());
+}
+
+TEST(OutgoingShardsTest, Create_ZeroWorkers_OneShardCreated) {
+  FakeTransportManager transport_manager;
+  ProtocolHandlerImpl protocol_handler(&transport_manager, 0u, 0u, false,
+                                       0u, 0u, 1u, 0u);
+  EXPECT_EQ(1u, protocol_handler.outgoing_shards_count());
+}
+
+TEST(InboundShardsTest, ManyConnections_MessagesOfConnectionKeepOrder) {
+  const std::vector<RawMessagePtr> data = CreateTransportData(500);
+  uint32_t reordered_count = 0;
+  uint32_t disconnect_force_count = 0;
+  PassData(3u, 1u, data, &reordered_count, &disconnect_force_count);
+  EXPECT_EQ(0u, reordered_count);
+  EXPECT_EQ(0u, disconnect_force_count);
+}
+
+TEST(InboundShardsTest, ConnectionClosed_DataOfNewConnectionProcessed) {
+  // Second pass reuses connection ids: data is parsed
+  // only if state of closed connections was removed and added again
+  const std::vector<RawMessagePtr> data = CreateTransportData(10);
+  for (size_t pass = 0; pass < 2; ++pass) {
+    uint32_t reordered_count = 0;
+    uint32_t disconnect_force_count = 0;
+    PassData(2u, 1u, data, &reordered_count, &disconnect_force_count);
+    EXPECT_EQ(0u, reordered_count);
+    EXPECT_EQ(0u, disconnect_force_count);
+  }
+}
+
+TEST(OutgoingShardsTest, ManyConnections_FramesOfConnectionKeepOrder) {
+  const uint32_t kMessagesPerConnection = 200;
+  OrderCheckingTransportManager transport_manager;
+  FakeSessionObserver session_observer;
+  ProtocolHandlerImpl protocol_handler(&transport_manager, 0u, 0u, false,
+                                       0u, 0u, 1u, kOutgoingWorkersCount);
+  protocol_handler.set_session_observer(&session_observer);
+#ifdef ENABLE_SECURITY
+  FakeSecurityManager security_manager;
+  protocol_handler.set_security_manager(&security_manager);
+#endif  // ENABLE_SECURITY
+
+  std::vector<uint8_t> payload(kPayloadSize, 0x5A);
+  for (uint32_t number = 0; number < kMessagesPerConnection; ++number) {
+    payload[0] = number >> 24;
+    payload[1] = number >> 16;
+    payload[2] = number >> 8;
+    payload[3] = number;
+    // Messages of all connections are interleaved
+    for (ConnectionID connection = 1; connection <= kConnectionsCount;
+         ++connection) {
+      protocol_handler.SendMessageToMobileApp(
+          RawMessagePtr(new RawMessage(connection, PROTOCOL_VERSION_2,
+                                       &payload[0], payload.size())),
+          false);
+    }
+  }
+  const uint32_t frames_count = kMessagesPerConnection * kConnectionsCount;
+  EXPECT_TRUE(transport_manager.WaitForFrames(frames_count));
+  protocol_handler.Stop();
+  EXPECT_EQ(0u, transport_manager.reordered_count());
+
+  // Frames of each connection went through the shard of connection only
+  ASSERT_LT(1u, protocol_handler.outgoing_shards_count());
+  uint32_t shards_frames_count = 0;
+  for (size_t shard = 0; shard < protocol_handler.outgoing_shards_count();
+       ++shard) {
+    uint32_t connections_count = 0;
+    for (ConnectionID connection = 1; connection <= kConnectionsCount;
+         ++connection) {
+      if (shard == connection % protocol_handler.outgoing_shards_count()) {
+        ++connections_count;
+      }
+    }
+    const OutgoingShardStatistics statistics =
+        protocol_handler.outgoing_shard_statistics(shard);
+    EXPECT_EQ(connections_count * kMessagesPerConnection,
+              statistics.frames_count);
+    shards_frames_count += statistics.frames_count;
+  }
+  EXPECT_EQ(frames_count, shards_frames_count);
+}
+
+TEST(InboundShardsTest, DISABLED_Benchmark_ThroughputOfManyConnections) {
+  const uint32_t kMessagesPerConnection = 2000;
+  const size_t kWorkRounds = 8;
+  const std::vector<RawMessagePtr> data =
+      CreateTransportData(kMessagesPerConnection);
+  const size_t kWorkersCounts[] = {1u, 2u, 4u};
+  for (size_t i = 0; i < ARRAYSIZE(kWorkersCounts); ++i) {
+    uint32_t reordered_count = 0;
+    uint32_t disconnect_force_count = 0;
+    const int64_t duration_ms = PassData(kWorkersCounts[i], kWorkRounds, data,
+                                         &reordered_count,
+                                         &disconnect_force_count);
+    printf("%u worker(s): %u messages of %u connections handled in %lld ms\n",
+           static_cast<unsigned>(kWorkersCounts[i]),
+           static_cast<unsigned>(data.size()),
+           static_cast<unsigned>(kConnectionsCount),
+           static_cast<long long>(duration_ms));
+    EXPECT_EQ(0u, reordered_count);
+  }
+}
+
+}  // namespace protocol_handler_test
+}  // namespace components
+}  // namespace test
@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "utils/macro.h"
+#include "protocol_handler/multiframe_builder.h"
+
+namespace test {
+namespace components {
+namespace protocol_handler_test {
+using namespace protocol_handler;
+
+namespace {
+typedef std::vector<uint8_t> Payload;
+typedef std::vector<ProtocolFramePtr> Frames;
+
+const size_t kConnectionBufferSize = 10000;
+const size_t kTotalBufferSize = 15000;
+const uint32_t kWaitingTimeout = 50;
+const size_t kMaxFrameSize = 1000;
+
+// Frame as it comes from IncomingDataHandler: serialized and parsed back
+ProtocolFramePtr ParseFrame(const ProtocolPacket& packet) {
+  const RawMessagePtr serialized = packet.serializePacket();
+  ProtocolFramePtr frame(new ProtocolPacket(packet.connection_id()));
+  EXPECT_EQ(RESULT_OK, frame->deserializePacket(serialized->data(),
+                                                serialized->data_size()));
+  return frame;
+}
+
+Frames CreateFrames(ConnectionID connection_id, uint8_t session_id,
+                    const Payload& payload) {
+  Frames frames;
+  const uint32_t frames_count =
+      (payload.size() + kMaxFrameSize - 1) / kMaxFrameSize;
+  const uint8_t first_frame_data[] = {
+    static_cast<uint8_t>(payload.size() >> 24),
+    static_cast<uint8_t>(payload.size() >> 16),
+    static_cast<uint8_t>(payload.size() >> 8),
+    static_cast<uint8_t>(payload.size()),
+    static_cast<uint8_t>(frames_count >> 24),
+    static_cast<uint8_t>(frames_count >> 16),
+    static_cast<uint8_t>(frames_count >> 8),
+    static_cast<uint8_t>(frames_count)
+  };
+  frames.push_back(ParseFrame(ProtocolPacket(
+      connection_id, PROTOCOL_VERSION_3, PROTECTION_OFF, FRAME_TYPE_FIRST,
+      kRpc, FRAME_DATA_FIRST, session_id, sizeof(first_frame_data), 0,
+      first_frame_data)));
+
+  for (uint32_t i = 0; i < frames_count; ++i) {
+    const bool is_last = (i + 1 == frames_count);
+    const size_t offset = i * kMaxFrameSize;
+    const size_t size = std::min(kMaxFrameSize, payload.size() - offset);
+    frames.push_back(ParseFrame(ProtocolPacket(
+        connection_id, PROTOCOL_VERSION_3, PROTECTION_OFF,
+        FRAME_TYPE_CONSECUTIVE, kRpc,
+        is_last ? FRAME_DATA_LAST_CONSECUTIVE
+                : (i % FRAME_DATA_MAX_CONSECUTIVE + 1),
+        session_id, size, 0, &payload[offset])));
+  }
+  return frames;
+}
+
+Payload CreatePayload(size_t size, uint8_t seed) {
+  Payload payload(size);
+  for (size_t i = 0; i < size; ++i) {
+    payload[i] = static_cast<uint8_t>(seed + i * 7);
+  }
+  return payload;
+}
+}  // namespace
+
+class MultiFrameBuilderTest : public ::testing::Test {
+ protected:
+  MultiFrameBuilderTest()
+    : builder(kConnectionBufferSize, kTotalBufferSize, kWaitingTimeout),
+      connection_id1(0x1234560),
+      connection_id2(0x1234561) {
+  }
+
+  RESULT_CODE AddFrame(uint32_t connection_key, const ProtocolFramePtr frame,
+                       RawMessagePtr* message) {
+    // Tests use connection keys of connection_id1 below 20
+    return builder.AddFrame(connection_key < 20 ? connection_id1
+                                                : connection_id2,
+                            connection_key, frame, message);
+  }
+
+  // Adds frames and expects last one only to complete message
+  RawMessagePtr AddFrames(uint32_t connection_key, const Frames& frames) {
+    RawMessagePtr message;
+    for (Frames::const_iterator it = frames.begin(); it != frames.end(); ++it) {
+      EXPECT_FALSE(message.valid());
+      EXPECT_EQ(RESULT_OK, AddFrame(connection_key, *it, &message));
+    }
+    return message;
+  }
+
+  static void ExpectPayload(const Payload& expected,
+                            const RawMessagePtr message) {
+    ASSERT_TRUE(message.valid());
+    ASSERT_EQ(expected.size(), message->data_size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), message->data()));
+  }
+
+  MultiFrameBuilder builder;
+  const ConnectionID connection_id1;
+  const ConnectionID connection_id2;
+};
+
+TEST_F(MultiFrameBuilderTest, AllFrames_MessageReassembled) {
+  const Payload payload = CreatePayload(2500, 1);
+  const RawMessagePtr message =
+      AddFrames(10, CreateFrames(connection_id1, 1, payload));
+
+  ExpectPayload(payload, message);
+  EXPECT_EQ(10u, message->connection_key());
+  EXPECT_EQ(PROTOCOL_VERSION_3, message->protocol_version());
+  EXPECT_EQ(kRpc, message->service_type());
+  EXPECT_EQ(0u, builder.incomplete_messages_count());
+  EXPECT_EQ(0u, builder.incomplete_messages_size());
+}
+
+TEST_F(MultiFrameBuilderTest, FirstFrame_SizeReserved) {
+  const Frames frames = CreateFrames(connection_id1, 1, CreatePayload(2500, 1));
+  RawMessagePtr message;
+  EXPECT_EQ(RESULT_OK, AddFrame(10, frames[0], &message));
+  EXPECT_FALSE(message.valid());
+  EXPECT_EQ(1u, builder.incomplete_messages_count());
+  EXPECT_EQ(2500u, builder.incomplete_messages_size());
+}
+
+TEST_F(MultiFrameBuilderTest, ConsecutiveWithoutFirst_Fail) {
+  const Frames frames = CreateFrames(connection_id1, 1, CreatePayload(2500, 1));
+  RawMessagePtr message;
+  EXPECT_EQ(RESULT_FAIL, AddFrame(10, frames[1], &message));
+  EXPECT_FALSE(message.valid());
+}
+
+TEST_F(MultiFrameBuilderTest, DuplicatedFrame_MessageDropped) {
+  Frames frames = CreateFrames(connection_id1, 1, CreatePayload(2500, 1));
+  frames.insert(frames.begin() + 2, frames[1]);
+  RawMessagePtr message;
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(RESULT_OK, AddFrame(10, frames[i], &message));
+  }
+  EXPECT_EQ(RESULT_FAIL, AddFrame(10, frames[3], &message));
+  EXPECT_EQ(RESULT_FAIL, AddFrame(10, frames[4], &message));
+  EXPECT_FALSE(message.valid());
+  EXPECT_EQ(0u, builder.incomplete_messages_size());
+}
+
+TEST_F(MultiFrameBuilderTest, TruncatedMessage_MessageDropped) {
+  Frames frames = CreateFrames(connection_id1, 1, CreatePayload(2500, 1));
+  frames.erase(frames.begin() + 2);
+  RawMessagePtr message;
+  EXPECT_EQ(RESULT_OK, AddFrame(10, frames[0], &message));
+  EXPECT_EQ(RESULT_OK, AddFrame(10, frames[1], &message));
+  EXPECT_EQ(RESULT_FAIL, AddFrame(10, frames[2], &message));
+  EXPECT_FALSE(message.valid());
+  EXPECT_EQ(0u, builder.incomplete_messages_count());
+}
+
+TEST_F(MultiFrameBuilderTest, InterleavedSessions_MessagesReassembled) {
+  const Payload payload1 = CreatePayload(3000, 1);
+  const Payload payload2 = CreatePayload(2000, 2);
+  const Frames frames1 = CreateFrames(connection_id1, 1, payload1);
+  const Frames frames2 = CreateFrames(connection_id2, 1, payload2);
+
+  RawMessagePtr message1, message2;
+  for (size_t i = 0; i < frames1.size(); ++i) {
+    EXPECT_EQ(RESULT_OK, AddFrame(10, frames1[i], &message1));
+    if (i < frames2.size()) {
+      EXPECT_EQ(RESULT_OK, AddFrame(20, frames2[i], &message2));
+    }
+  }
+  ExpectPayload(payload1, message1);
+  ExpectPayload(payload2, message2);
+  EXPECT_EQ(10u, message1->connection_key());
+  EXPECT_EQ(20u, message2->connection_key());
+}
+
+TEST_F(MultiFrameBuilderTest, ConnectionBufferExceeded_FirstFrameRejected) {
+  const Frames frames1 =
+      CreateFrames(connection_id1, 1, CreatePayload(6000, 1));
+  const Frames frames2 =
+      CreateFrames(connection_id1, 2, CreatePayload(6000, 2));
+  const Frames frames3 =
+      CreateFrames(connection_id2, 1, CreatePayload(6000, 3));
+
+  RawMessagePtr message;
+  EXPECT_EQ(RESULT_OK, AddFrame(10, frames1[0], &message));
+  EXPECT_EQ(RESULT_FAIL, AddFrame(11, frames2[0], &message));
+  EXPECT_EQ(RESULT_OK, AddFrame(20, frames3[0], &message));
+  EXPECT_EQ(12000u, builder.incomplete_messages_size());
+}
+
+TEST_F(MultiFrameBuilderTest, TotalBufferExceeded_FirstFrameRejected) {
+  const Frames frames1 =
+      CreateFrames(connection_id1, 1, CreatePayload(9000, 1));
+  const Frames frames2 =
+      CreateFrames(connection_id2, 1, CreatePayload(9000, 2));
+
+  RawMessagePtr message;
+  EXPECT_EQ(RESULT_OK, AddFrame(10, frames1[0], &message));
+  EXPECT_EQ(RESULT_FAIL, AddFrame(20, frames2[0], &message));
+
+  // Completed message releases its reserved size
+  EXPECT_TRUE(AddFrames(10, Frames(frames1.begin() + 1, frames1.end())).valid());
+  EXPECT_EQ(RESULT_OK, AddFrame(20, frames2[0], &message));
+}
+
+TEST_F(MultiFrameBuilderTest, NoNextFrame_MessageExpired) {
+  const Frames frames = CreateFrames(connection_id1, 1, CreatePayload(2500, 1));
+  RawMessagePtr message;
+  EXPECT_EQ(RESULT_OK, AddFrame(10, frames[0], &message));
+  EXPECT_EQ(RESULT_OK, AddFrame(10, frames[1], &message));
+  EXPECT_EQ(0u, builder.RemoveExpiredMessages());
+
+  usleep((kWaitingTimeout + 10) * 1000);
+  EXPECT_EQ(1u, builder.RemoveExpiredMessages());
+  EXPECT_EQ(0u, builder.incomplete_messages_size());
+  EXPECT_EQ(RESULT_FAIL, AddFrame(10, frames[2], &message));
+}
+
+TEST_F(MultiFrameBuilderTest, RemoveConnection_MessagesOfConnectionDropped) {
+  RawMessagePtr message;
+  EXPECT_EQ(RESULT_OK, AddFrame(
+      10, CreateFrames(connection_id1, 1, CreatePayload(2000, 1))[0], &message));
+  EXPECT_EQ(RESULT_OK, AddFrame(
+      11, CreateFrames(connection_id1, 2, CreatePayload(2000, 2))[0], &message));
+  EXPECT_EQ(RESULT_OK, AddFrame(
+      20, CreateFrames(connection_id2, 1, CreatePayload(3000, 3))[0], &message));
+
+  builder.RemoveConnection(connection_id1);
+  EXPECT_EQ(1u, builder.incomplete_messages_count());
+  EXPECT_EQ(3000u, builder.incomplete_messages_size());
+}
+
+TEST_F(MultiFrameBuilderTest, ReleasedBuffer_Reused) {
+  const Payload payload = CreatePayload(2500, 1);
+  const Frames frames = CreateFrames(connection_id1, 1, payload);
+
+  RawMessagePtr first = AddFrames(10, frames);
+  ASSERT_TRUE(first.valid());
+  const uint8_t* first_data = first->data();
+
+  // Buffer referenced by message is not reused
+  RawMessagePtr second = AddFrames(10, frames);
+  ASSERT_TRUE(second.valid());
+  EXPECT_NE(first_data, second->data());
+
+  first.reset();
+  RawMessagePtr third = AddFrames(10, frames);
+  ExpectPayload(payload, third);
+  EXPECT_EQ(first_data, third->data());
+}
+
+// Frames of several sessions are interleaved, some messages get duplicated,
+// dropped or truncated frames; only intact messages have to be reassembled
+TEST_F(MultiFrameBuilderTest, Fuzz_InterleavedCorruptedFrames) {
+  enum Corruption {
+    kIntact,
+    kDuplicatedFirstFrame,
+    kDuplicatedFrame,
+    kMissingFrame,
+    kMissingLastFrame,
+    kCorruptionsCount
+  };
+  struct Session {
+    uint32_t connection_key;
+    ConnectionID connection_id;
+    uint8_t session_id;
+  };
+  const Session sessions[] = {
+    {10, connection_id1, 1}, {11, connection_id1, 2},
+    {20, connection_id2, 1}, {21, connection_id2, 2}
+  };
+  const size_t sessions_count = ARRAYSIZE(sessions);
+  const size_t messages_per_session = 50;
+
+  srand(42);
+  std::vector<Frames> session_frames(sessions_count);
+  std::vector<std::vector<Payload> > expected(sessions_count);
+  for (size_t s = 0; s < sessions_count; ++s) {
+    for (size_t m = 0; m < messages_per_session; ++m) {
+      const Payload payload =
+          CreatePayload(1 + rand() % 3000, static_cast<uint8_t>(rand()));
+      Frames frames = CreateFrames(sessions[s].connection_id,
+                                   sessions[s].session_id, payload);
+      const size_t consecutive_count = frames.size() - 1;
+      switch (rand() % kCorruptionsCount) {
+        case kDuplicatedFirstFrame:
+          frames.insert(frames.begin() + 1, frames[0]);
+          expected[s].push_back(payload);
+          break;
+        case kDuplicatedFrame:
+          if (consecutive_count > 1) {
+            const size_t index = 1 + rand() % (consecutive_count - 1);
+            frames.insert(frames.begin() + index, frames[index]);
+          } else {
+            // Message is complete before duplicate of its only frame
+            frames.push_back(frames.back());
+            expected[s].push_back(payload);
+          }
+          break;
+        case kMissingFrame:
+          if (consecutive_count > 1) {
+            frames.erase(frames.begin() + 1 + rand() % (consecutive_count - 1));
+            break;
+          }
+          // Message of one frame can only miss the last frame,
+          // fall through
+        case kMissingLastFrame:
+          frames.pop_back();
+          break;
+        default:
+          expected[s].push_back(payload);
+          break;
+      }
+      session_frames[s].insert(session_frames[s].end(),
+                               frames.begin(), frames.end());
+    }
+  }
+
+  std::vector<size_t> next_frame(sessions_count, 0);
+  std::vector<std::vector<Payload> > received(sessions_count);
+  size_t frames_left = 0;
+  for (size_t s = 0; s < sessions_count; ++s) {
+    frames_left += session_frames[s].size();
+  }
+  while (frames_left > 0) {
+    const size_t s = rand() % sessions_count;
+    if (next_frame[s] == session_frames[s].size()) {
+      continue;
+    }
+    RawMessagePtr message;
+    AddFrame(sessions[s].connection_key,
+             session_frames[s][next_frame[s]++], &message);
+    --frames_left;
+    if (message) {
+      EXPECT_EQ(sessions[s].connection_key, message->connection_key());
+      received[s].push_back(
+          Payload(message->data(), message->data() + message->data_size()));
+    }
+    EXPECT_LE(builder.incomplete_messages_size(), kTotalBufferSize);
+  }
+
+  for (size_t s = 0; s < sessions_count; ++s) {
+    EXPECT_FALSE(expected[s].empty());
+    EXPECT_TRUE(expected[s] == received[s]) << "Session #" << s;
+  }
+  builder.RemoveConnection(connection_id1);
+  builder.RemoveConnection(connection_id2);
+  EXPECT_EQ(0u, builder.incomplete_messages_count());
+  EXPECT_EQ(0u, builder.incomplete_messages_size());
+}
+
+}  // namespace protocol_handler_test
+}  // namespace components
+}  // namespace test
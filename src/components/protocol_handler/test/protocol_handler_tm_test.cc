@@ -58,6 +58,10 @@ using ::testing::Le;
 using ::testing::_;
 using ::testing::Invoke;
 
+// One incoming worker keeps expectations order across connections
+const size_t kInboundWorkersCount = 1u;
+const size_t kOutgoingWorkersCount = 4u;
+
 class ProtocolHandlerImplTest : public ::testing::Test {
  protected:
   void InitProtocolHandlerImpl(
@@ -69,7 +73,9 @@ class ProtocolHandlerImplTest : public ::testing::Test {
         new ProtocolHandlerImpl(&transport_manager_mock,
                                 period_msec, max_messages,
                                 malformed_message_filtering,
-                                malformd_period_msec, malformd_max_messages));
+                                malformd_period_msec, malformd_max_messages,
+                                kInboundWorkersCount,
+                                kOutgoingWorkersCount));
     protocol_handler_impl->set_session_observer(&session_observer_mock);
     tm_listener = protocol_handler_impl.get();
   }
@@ -31,11 +31,15 @@
  */
 
 #include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
 #include <vector>
 #include <list>
 
 #include "utils/macro.h"
 #include "protocol_handler/protocol_packet.h"
+#include "protocol_handler/header_layout.h"
+#include "utils/date_time.h"
 
 namespace test {
 namespace components {
@@ -196,6 +200,80 @@ TEST_F(ProtocolPacketTest, DeserializeNonZeroPacket) {
   EXPECT_EQ(RESULT_OK, res);
 }
 
+TEST_F(ProtocolPacketTest, SerializeDeserialize_AllVersions_HeaderAndDataKept) {
+  const uint8_t data[] = {0xDE, 0xAD, 0xBE, 0xEF, 0x01};
+  for (uint8_t version = PROTOCOL_VERSION_1; version <= PROTOCOL_VERSION_4;
+       ++version) {
+    ProtocolPacket prot_packet(
+        some_connection_id, version, PROTECTION_ON, FRAME_TYPE_SINGLE, kRpc,
+        FRAME_DATA_SINGLE, 5u, sizeof(data), some_message_id, data);
+    const RawMessagePtr raw = prot_packet.serializePacket();
+    ASSERT_TRUE(raw.valid());
+    EXPECT_EQ(FrameHeaderSize(version) + sizeof(data), raw->data_size());
+
+    ProtocolPacket parsed(some_connection_id);
+    ASSERT_EQ(RESULT_OK,
+              parsed.deserializePacket(raw->data(), raw->data_size()));
+    EXPECT_EQ(version, parsed.protocol_version());
+    EXPECT_TRUE(parsed.protection_flag());
+    EXPECT_EQ(FRAME_TYPE_SINGLE, parsed.frame_type());
+    EXPECT_EQ(kRpc, parsed.service_type());
+    EXPECT_EQ(5u, parsed.session_id());
+    EXPECT_EQ(sizeof(data), parsed.data_size());
+    EXPECT_EQ(PROTOCOL_VERSION_1 == version ? 0u : some_message_id,
+              parsed.message_id());
+    EXPECT_EQ(0, memcmp(data, parsed.data(), sizeof(data)));
+  }
+}
+
+TEST_F(ProtocolPacketTest, SerializePacket_Version1SmallData_HeaderNotPadded) {
+  const uint8_t data[] = {0x7B};
+  ProtocolPacket prot_packet(
+      some_connection_id, PROTOCOL_VERSION_1, PROTECTION_OFF, FRAME_TYPE_SINGLE,
+      kRpc, FRAME_DATA_SINGLE, 1u, sizeof(data), 0u, data);
+  const RawMessagePtr raw = prot_packet.serializePacket();
+  ASSERT_EQ(PROTOCOL_HEADER_V1_SIZE + sizeof(data), raw->data_size());
+  EXPECT_EQ(data[0], raw->data()[PROTOCOL_HEADER_V1_SIZE]);
+}
+
+TEST_F(ProtocolPacketTest,
+       DISABLED_Benchmark_HeaderSerializeDeserializePerVersion) {
+  const size_t kIterations = 100000;
+  const std::vector<uint8_t> data(512, 0x5A);
+  for (uint8_t version = PROTOCOL_VERSION_1; version <= PROTOCOL_VERSION_4;
+       ++version) {
+    ProtocolPacket prot_packet(
+        some_connection_id, version, PROTECTION_OFF, FRAME_TYPE_SINGLE, kRpc,
+        FRAME_DATA_SINGLE, 1u, data.size(), some_message_id, &data[0]);
+    const RawMessagePtr raw = prot_packet.serializePacket();
+
+    TimevalStruct start = date_time::DateTime::getCurrentTime();
+    size_t serialized_bytes = 0;
+    for (size_t i = 0; i < kIterations; ++i) {
+      serialized_bytes += prot_packet.serializePacket()->data_size();
+    }
+    const int64_t serialize_ms = date_time::DateTime::calculateTimeSpan(start);
+
+    start = date_time::DateTime::getCurrentTime();
+    ProtocolPacket::ProtocolHeader header;
+    uint32_t checksum = 0;
+    for (size_t i = 0; i < kIterations; ++i) {
+      header.deserialize(raw->data(), raw->data_size());
+      checksum += header.messageId + header.dataSize;
+    }
+    const int64_t deserialize_ms =
+        date_time::DateTime::calculateTimeSpan(start);
+
+    printf("Protocol v%u: %u frames serialized in %lld ms (%u bytes), "
+           "headers parsed in %lld ms (checksum %u)\n",
+           static_cast<unsigned>(version), static_cast<unsigned>(kIterations),
+           static_cast<long long>(serialize_ms),
+           static_cast<unsigned>(serialized_bytes),
+           static_cast<long long>(deserialize_ms), checksum);
+    EXPECT_EQ(kIterations * raw->data_size(), serialized_bytes);
+  }
+}
+
 }  // namespace protocol_handler_test
 }  // namespace components
 }  // namespace test
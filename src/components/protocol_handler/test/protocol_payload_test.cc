@@ -265,6 +265,73 @@ TEST(ProtocolPayloadTest, ExtractProtocolWithJSONWithDataWithWrongPayloadSize) {
   delete[] data_for_sending;
 }
 
+TEST(ProtocolPayloadTest, ParsePayloadV2_SameAsBitStreamExtract) {
+  ProtocolPayloadV2 prot_payload_test;
+  prot_payload_test.header.correlation_id = 0x01020304;
+  prot_payload_test.header.rpc_function_id = 0x0ABCDEF;
+  prot_payload_test.header.rpc_type = kRpcTypeNotification;
+  prot_payload_test.json = "{\"name\":\"OnHMIStatus\"}";
+  prot_payload_test.header.json_size = prot_payload_test.json.length();
+  prot_payload_test.data = {1, 2, 3, 4};
+
+  std::vector<uint8_t> data_for_sending(PROTOCOL_HEADER_V2_SIZE +
+                                        prot_payload_test.json.length() +
+                                        prot_payload_test.data.size());
+  prepare_data(&data_for_sending[0], prot_payload_test);
+
+  BitStream bs(&data_for_sending[0], data_for_sending.size());
+  ProtocolPayloadV2 extracted;
+  Extract(&bs, &extracted, data_for_sending.size());
+  ASSERT_TRUE(bs.IsGood());
+
+  ProtocolPayloadV2 parsed;
+  ASSERT_TRUE(ParsePayloadV2(&data_for_sending[0], data_for_sending.size(),
+                             &parsed));
+  EXPECT_EQ(extracted.header.rpc_type, parsed.header.rpc_type);
+  EXPECT_EQ(extracted.header.rpc_function_id, parsed.header.rpc_function_id);
+  EXPECT_EQ(extracted.header.correlation_id, parsed.header.correlation_id);
+  EXPECT_EQ(extracted.header.json_size, parsed.header.json_size);
+  EXPECT_EQ(extracted.json, parsed.json);
+  EXPECT_EQ(extracted.data, parsed.data);
+}
+
+TEST(ProtocolPayloadTest, ParsePayloadV2_JsonSizeOverflow_Fail) {
+  ProtocolPayloadV2 prot_payload_test;
+  prot_payload_test.header.rpc_type = kRpcTypeRequest;
+  prot_payload_test.header.json_size = 100;
+
+  uint8_t data_for_sending[PROTOCOL_HEADER_V2_SIZE + 10] = {0};
+  prepare_data(data_for_sending, prot_payload_test);
+
+  ProtocolPayloadV2 parsed;
+  EXPECT_FALSE(ParsePayloadV2(data_for_sending, sizeof(data_for_sending),
+                              &parsed));
+  EXPECT_FALSE(ParsePayloadV2(data_for_sending,
+                              PROTOCOL_HEADER_V2_SIZE - 1, &parsed));
+}
+
+TEST(ProtocolPayloadTest, ParsePayloadV2_ReservedRpcType_Fail) {
+  uint8_t data_for_sending[PROTOCOL_HEADER_V2_SIZE] = {0xF0};
+  ProtocolPayloadV2 parsed;
+  EXPECT_FALSE(ParsePayloadV2(data_for_sending, sizeof(data_for_sending),
+                              &parsed));
+}
+
+TEST(ProtocolPayloadTest, WritePayloadHeaderV2_SameAsFieldByFieldWrite) {
+  ProtocolPayloadV2 prot_payload_test;
+  prot_payload_test.header.correlation_id = 0xA1B2C3D4;
+  prot_payload_test.header.rpc_function_id = 0x0123456;
+  prot_payload_test.header.rpc_type = kRpcTypeResponse;
+  prot_payload_test.header.json_size = 0;
+
+  uint8_t expected[PROTOCOL_HEADER_V2_SIZE];
+  prepare_data(expected, prot_payload_test);
+  uint8_t written[PROTOCOL_HEADER_V2_SIZE];
+  EXPECT_EQ(sizeof(written),
+            WritePayloadHeaderV2(prot_payload_test.header, written));
+  EXPECT_EQ(0, memcmp(expected, written, sizeof(written)));
+}
+
 }  // namespace protocol_handler_test
 }  // namespace components
 }  // namespace test
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_RPC_BASE_INCLUDE_RPC_BASE_JSON_STREAM_READER_H_
+#define SRC_COMPONENTS_RPC_BASE_INCLUDE_RPC_BASE_JSON_STREAM_READER_H_
+
+#include <stdint.h>
+#include <string>
+
+namespace rpc {
+
+/**
+ * @brief Pull reader of JSON text, lets rpc types to be initialized
+ * directly from the serialized data without building Json::Value tree.
+ * Values are classified and decoded exactly as Json::Reader does it,
+ * so the types get the same validation state on both paths.
+ * Input is read up to the end of the buffer or up to the first '\0'.
+ * Reader does not own the buffer, it must outlive the reader.
+ */
+class JsonStreamReader {
+ public:
+  JsonStreamReader(const char* begin, const char* end);
+
+  /**
+   * @brief Tells if reader met malformed JSON, all the subsequent
+   * type checks return false and containers look empty then
+   */
+  bool has_failed() const;
+  const std::string& error() const;
+  size_t error_offset() const;
+
+  // Type checkers of the next value, same semantics as Json::Value::isXxx()
+  // except that null is neither array nor object
+  bool NextIsNull() const;
+  bool NextIsBool() const;
+  bool NextIsInt() const;
+  bool NextIsUInt() const;
+  bool NextIsDouble() const;
+  bool NextIsString() const;
+  bool NextIsArray() const;
+  bool NextIsObject() const;
+
+  // Readers of the next value, reader fails if value has another type
+  void TakeNull();
+  bool TakeBool();
+  int64_t TakeInt64();
+  uint64_t TakeUInt64();
+  double TakeDouble();
+  std::string TakeString();
+
+  /**
+   * @brief Reads array start, elements are iterated with NextElement()
+   * @return false if next value is not an array
+   */
+  bool TakeArrayStart();
+  /**
+   * @brief Moves to the next array element
+   * @return false when array end is reached (and read)
+   */
+  bool NextElement();
+  /**
+   * @brief Reads object start, members are iterated with NextMember()
+   * @return false if next value is not an object
+   */
+  bool TakeObjectStart();
+  /**
+   * @brief Reads next member name, the member value is next then
+   * @return false when object end is reached (and read)
+   */
+  bool NextMember(std::string* name);
+
+  /**
+   * @brief Reads and drops the next value of any type
+   */
+  void SkipValue();
+
+ private:
+  enum NumberType {
+    kNotNumber,
+    kIntNumber,
+    kUIntNumber,
+    kRealNumber
+  };
+  NumberType NextNumberType() const;
+  const char* NumberEnd() const;
+  uint64_t TakeDigits();
+  bool NextIsValue() const;
+  bool TakeChar(char c);
+  bool TakeLiteral(const char* literal);
+  void TakeStringToken(std::string* value);
+  bool TakeUnicodeEscape(uint32_t* code_point);
+  bool NextElementOrMember(char end_char);
+  void SkipWhitespace();
+  void MarkFailed(const std::string& error);
+
+  const char* begin_;
+  const char* end_;
+  const char* current_;
+  // Container start has just been read, so neither ',' nor end is expected
+  bool container_started_;
+  std::string error_;
+};
+
+}  // namespace rpc
+
+#endif  // SRC_COMPONENTS_RPC_BASE_INCLUDE_RPC_BASE_JSON_STREAM_READER_H_
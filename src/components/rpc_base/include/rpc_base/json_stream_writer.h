@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_RPC_BASE_INCLUDE_RPC_BASE_JSON_STREAM_WRITER_H_
+#define SRC_COMPONENTS_RPC_BASE_INCLUDE_RPC_BASE_JSON_STREAM_WRITER_H_
+
+#include <stdint.h>
+#include <string>
+
+namespace rpc {
+
+/**
+ * @brief Writer of compact JSON text, lets rpc types to be serialized
+ * directly without building Json::Value tree. Values are formatted exactly
+ * as Json::FastWriter does it. Object members are written in the order
+ * they are added, no check for duplicated names is done.
+ * Text is appended to the string, writer does not own it.
+ */
+class JsonStreamWriter {
+ public:
+  explicit JsonStreamWriter(std::string* output);
+
+  void WriteNull();
+  void WriteBool(bool value);
+  void WriteInt64(int64_t value);
+  void WriteDouble(double value);
+  void WriteString(const std::string& value);
+
+  void WriteArrayStart();
+  void WriteArrayEnd();
+  void WriteObjectStart();
+  void WriteObjectEnd();
+  /**
+   * @brief Writes name of the object member, its value has to be next
+   */
+  void WriteMemberName(const std::string& name);
+
+ private:
+  void WriteSeparator();
+
+  std::string* output_;
+  // Value was written, so the next element or member needs a separator
+  bool value_written_;
+};
+
+}  // namespace rpc
+
+#endif  // SRC_COMPONENTS_RPC_BASE_INCLUDE_RPC_BASE_JSON_STREAM_WRITER_H_
@@ -48,6 +48,8 @@ class MessageWriter;
 }  // namespace dbus
 
 namespace rpc {
+class JsonStreamReader;
+class JsonStreamWriter;
 class ValidationReport;
 
 namespace policy_table_interface_base {
@@ -117,6 +119,8 @@ class PrimitiveType {
     static ValueState InitHelper(bool is_next);
     static ValueState InitHelper(const Json::Value* value,
                                  bool (Json::Value::*type_check)() const);
+    static ValueState InitHelper(const JsonStreamReader* reader,
+                                 bool (JsonStreamReader::*type_check)() const);
 
   protected:
     ValueState value_state_;
@@ -144,6 +148,9 @@ class CompositeType {
     static InitializationState InitHelper(bool is_next);
     static InitializationState InitHelper(const Json::Value* value,
                                           bool (Json::Value::*type_check)() const);
+    static InitializationState InitHelper(
+        const JsonStreamReader* reader,
+        bool (JsonStreamReader::*type_check)() const);
   protected:
     mutable InitializationState initialization_state__;
     policy_table_interface_base::PolicyTableType policy_table_type_;
@@ -163,10 +170,12 @@ class Boolean : public PrimitiveType {
     explicit Boolean(bool value);
     explicit Boolean(const Json::Value* value);
     explicit Boolean(dbus::MessageReader* reader);
+    explicit Boolean(JsonStreamReader* reader);
     Boolean(const Json::Value* value, bool def_value);
     Boolean& operator=(bool new_val);
     operator bool() const;
     Json::Value ToJsonValue() const;
+    void ToJsonWriter(JsonStreamWriter* writer) const;
     void ToDbusWriter(dbus::MessageWriter* writer) const;
 
   private:
@@ -186,6 +195,7 @@ class Integer : public PrimitiveType {
     Integer(const Integer& value);
     explicit Integer(const Json::Value* value);
     explicit Integer(dbus::MessageReader* reader);
+    explicit Integer(JsonStreamReader* reader);
     Integer(const Json::Value* value, IntType def_value);
     Integer& operator=(IntType new_val);
     Integer& operator=(const Integer& new_val);
@@ -193,6 +203,7 @@ class Integer : public PrimitiveType {
     Integer& operator+=(int value);
     operator IntType() const;
     Json::Value ToJsonValue() const;
+    void ToJsonWriter(JsonStreamWriter* writer) const;
     void ToDbusWriter(dbus::MessageWriter* writer) const;
 
   private:
@@ -208,10 +219,12 @@ class Float : public PrimitiveType {
     explicit Float(double value);
     explicit Float(const Json::Value* value);
     explicit Float(dbus::MessageReader* reader);
+    explicit Float(JsonStreamReader* reader);
     Float(const Json::Value* value, double def_value);
     Float& operator=(double new_val);
     operator double() const;
     Json::Value ToJsonValue() const;
+    void ToJsonWriter(JsonStreamWriter* writer) const;
     void ToDbusWriter(dbus::MessageWriter* writer) const;
 
   private:
@@ -228,6 +241,7 @@ class String : public PrimitiveType {
     explicit String(const char* value);
     explicit String(const Json::Value* value);
     explicit String(dbus::MessageReader* reader);
+    explicit String(JsonStreamReader* reader);
     String(const Json::Value* value, const std::string& def_value);
     bool operator<(String new_val);
     String& operator=(const std::string& new_val);
@@ -235,6 +249,7 @@ class String : public PrimitiveType {
     bool operator==(const String& rhs);
     operator const std::string& () const;
     Json::Value ToJsonValue() const;
+    void ToJsonWriter(JsonStreamWriter* writer) const;
     void ToDbusWriter(dbus::MessageWriter* writer) const;
 
   private:
@@ -253,10 +268,12 @@ class Enum : public PrimitiveType {
     explicit Enum(EnumType value);
     explicit Enum(const Json::Value* value);
     explicit Enum(dbus::MessageReader* reader);
+    explicit Enum(JsonStreamReader* reader);
     Enum(const Json::Value* value, EnumType def_value);
     Enum& operator=(EnumType new_val);
     operator EnumType() const;
     Json::Value ToJsonValue() const;
+    void ToJsonWriter(JsonStreamWriter* writer) const;
     void ToDbusWriter(dbus::MessageWriter* writer) const;
 
   private:
@@ -276,6 +293,7 @@ class Array : public std::vector<T>, public CompositeType {
     explicit Array(Json::Value* value);
     explicit Array(const Json::Value* value);
     explicit Array(dbus::MessageReader* reader);
+    explicit Array(JsonStreamReader* reader);
     template<typename U>
     explicit Array(const U& value);
     template<typename U>
@@ -284,6 +302,7 @@ class Array : public std::vector<T>, public CompositeType {
     template<typename U>
     void push_back(const U& value);
     Json::Value ToJsonValue() const;
+    void ToJsonWriter(JsonStreamWriter* writer) const;
     void ToDbusWriter(dbus::MessageWriter* writer) const;
 
     bool is_valid() const;
@@ -305,6 +324,7 @@ class Map : public std::map<std::string, T>, public CompositeType  {
     explicit Map(Json::Value* value);
     explicit Map(const Json::Value* value);
     explicit Map(dbus::MessageReader* reader);
+    explicit Map(JsonStreamReader* reader);
     template<typename U>
     explicit Map(const U& value);
     template<typename U>
@@ -313,6 +333,7 @@ class Map : public std::map<std::string, T>, public CompositeType  {
     template<typename U>
     void insert(const std::pair<std::string, U>& value);
     Json::Value ToJsonValue() const;
+    void ToJsonWriter(JsonStreamWriter* writer) const;
     void ToDbusWriter(dbus::MessageWriter* writer) const;
 
     bool is_valid() const;
@@ -327,6 +348,7 @@ class Nullable : public T {
     // Methods
     Nullable();
     explicit Nullable(dbus::MessageReader* reader);
+    explicit Nullable(JsonStreamReader* reader);
     // Need const and non-const versions to beat all-type accepting constructor
     explicit Nullable(Json::Value* value);
     explicit Nullable(const Json::Value* value);
@@ -337,6 +359,7 @@ class Nullable : public T {
     template<typename U>
     Nullable& operator=(const U& new_val);
     Json::Value ToJsonValue() const;
+    void ToJsonWriter(JsonStreamWriter* writer) const;
 
     bool is_valid() const;
     bool is_initialized() const;
@@ -353,6 +376,7 @@ class Stringifyable : public T {
     // Methods
     Stringifyable();
     explicit Stringifyable(dbus::MessageReader* reader);
+    explicit Stringifyable(JsonStreamReader* reader);
     // Need const and non-const versions to beat all-type accepting constructor
     explicit Stringifyable(Json::Value* value);
     explicit Stringifyable(const Json::Value* value);
@@ -363,6 +387,7 @@ class Stringifyable : public T {
     template<typename U>
     Stringifyable& operator=(const U& new_val);
     Json::Value ToJsonValue() const;
+    void ToJsonWriter(JsonStreamWriter* writer) const;
 
     bool is_valid() const;
     bool is_initialized() const;
@@ -385,6 +410,7 @@ class Optional {
     template<typename U>
     Optional(const Json::Value* value, const U& def_value);
     Json::Value ToJsonValue() const;
+    void ToJsonWriter(JsonStreamWriter* writer) const;
 
     void ToDbusWriter(dbus::MessageWriter* writer) const;
 
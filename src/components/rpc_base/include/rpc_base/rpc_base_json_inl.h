@@ -33,7 +33,11 @@
 #ifndef VALIDATED_TYPES_JSON_INL_H_
 #define VALIDATED_TYPES_JSON_INL_H_
 
+#include <new>
+
 #include "rpc_base/rpc_base.h"
+#include "rpc_base/json_stream_reader.h"
+#include "rpc_base/json_stream_writer.h"
 #include "json/value.h"
 
 namespace rpc {
@@ -51,6 +55,19 @@ inline PrimitiveType::ValueState PrimitiveType::InitHelper(
   }
 }
 
+// static
+inline PrimitiveType::ValueState PrimitiveType::InitHelper(
+  const JsonStreamReader* reader,
+  bool (JsonStreamReader::*type_check)() const) {
+  if (!reader) {
+    return kUninitialized;
+  } else if ((reader->*type_check)()) {
+    return kValid;
+  } else {
+    return kInvalid;
+  }
+}
+
 inline policy_table_interface_base::PolicyTableType PrimitiveType::GetPolicyTableType() const  {
   return policy_table_type_;
 }
@@ -77,6 +94,19 @@ inline CompositeType::InitializationState CompositeType::InitHelper(
   }
 }
 
+// static
+inline CompositeType::InitializationState CompositeType::InitHelper(
+  const JsonStreamReader* reader,
+  bool (JsonStreamReader::*type_check)() const) {
+  if (!reader) {
+    return kUninitialized;
+  } else if ((reader->*type_check)()) {
+    return kInitialized;
+  } else {
+    return kInvalidInitialized;
+  }
+}
+
 inline policy_table_interface_base::PolicyTableType CompositeType::GetPolicyTableType() const {
   return policy_table_type_;
 }
@@ -95,6 +125,49 @@ inline const Json::Value* ValueMember(const Json::Value* value,
   return NULL;
 }
 
+// Value that reader points to is consumed by constructors of the types
+// if it has expected type, otherwise it is skipped with this function.
+inline void SkipIfInvalid(bool is_valid, JsonStreamReader* reader) {
+  if (reader && !is_valid) {
+    reader->SkipValue();
+  }
+}
+
+// Starts reading of object members if reader points to the object,
+// skips any other value. Returns false if there are no members to read.
+inline bool TakeObjectStart(JsonStreamReader* reader) {
+  if (!reader) {
+    return false;
+  } else if (reader->NextIsObject()) {
+    return reader->TakeObjectStart();
+  } else {
+    reader->SkipValue();
+    return false;
+  }
+}
+
+// Field is constructed in place since copies of primitive types do not
+// keep their validation state, and copies of containers are expensive.
+template<class T>
+inline void ReadJsonField(JsonStreamReader* reader, T* field) {
+  field->~T();
+  new (field) T(reader);
+}
+
+// Item is copied into the map exactly as Map(const Json::Value*) does it,
+// so both parsers give the same validation state. Duplicated key overwrites
+// the item as it does in Json::Value.
+template<class M>
+inline void ReadJsonMapItem(JsonStreamReader* reader, const std::string& key,
+                            M* map) {
+  const typename M::mapped_type item(reader);
+  std::pair<typename M::iterator, bool> inserted =
+      map->insert(typename M::value_type(key, item));
+  if (!inserted.second) {
+    inserted.first->second = item;
+  }
+}
+
 template<class T>
 inline void WriteJsonField(const char* field_name,
                            const T& field,
@@ -104,6 +177,26 @@ inline void WriteJsonField(const char* field_name,
   }
 }
 
+template<class T>
+inline void WriteJsonField(const char* field_name,
+                           const T& field,
+                           JsonStreamWriter* writer) {
+  if (field.is_initialized()) {
+    writer->WriteMemberName(field_name);
+    field.ToJsonWriter(writer);
+  }
+}
+
+// Writes field even if it is not set, as it is written for a copy of it:
+// copied Integer is always set, so is struct which has Integer in it
+template<class T>
+inline void WriteJsonFieldAsCopied(const char* field_name,
+                                   const T& field,
+                                   JsonStreamWriter* writer) {
+  writer->WriteMemberName(field_name);
+  field.ToJsonWriter(writer);
+}
+
 }  // namespace impl
 
 inline Boolean::Boolean(const Json::Value* value)
@@ -120,10 +213,20 @@ inline Boolean::Boolean(const Json::Value* value, bool def_value)
   }
 }
 
+inline Boolean::Boolean(JsonStreamReader* reader)
+  : PrimitiveType(InitHelper(reader, &JsonStreamReader::NextIsBool)),
+    value_(is_valid() ? reader->TakeBool() : bool()) {
+  impl::SkipIfInvalid(is_valid(), reader);
+}
+
 inline Json::Value Boolean::ToJsonValue() const {
   return Json::Value(value_);
 }
 
+inline void Boolean::ToJsonWriter(JsonStreamWriter* writer) const {
+  writer->WriteBool(value_);
+}
+
 template<typename T, T minval, T maxval>
 Integer<T, minval, maxval>::Integer(const Json::Value* value)
   : PrimitiveType(InitHelper(value, &Json::Value::isInt)),
@@ -138,6 +241,21 @@ Integer<T, minval, maxval>::Integer(const Json::Value* value)
   }
 }
 
+template<typename T, T minval, T maxval>
+Integer<T, minval, maxval>::Integer(JsonStreamReader* reader)
+  : PrimitiveType(InitHelper(reader, &JsonStreamReader::NextIsInt)),
+    value_() {
+  impl::SkipIfInvalid(is_valid(), reader);
+  if (is_valid()) {
+    int64_t intval = reader->TakeInt64();
+    if (range_.Includes(intval)) {
+      value_ = IntType(intval);
+    } else {
+      value_state_ = kInvalid;
+    }
+  }
+}
+
 template<typename T, T minval, T maxval>
 Integer<T, minval, maxval>::Integer(const Integer& val)
   : PrimitiveType(range_.Includes(val.value_) ? kValid : kInvalid),
@@ -165,6 +283,11 @@ Json::Value Integer<T, minval, maxval>::ToJsonValue() const {
   return Json::Value(Json::Int64(value_));
 }
 
+template<typename T, T minval, T maxval>
+void Integer<T, minval, maxval>::ToJsonWriter(JsonStreamWriter* writer) const {
+  writer->WriteInt64(value_);
+}
+
 template<int64_t minnum, int64_t maxnum, int64_t minden, int64_t maxden>
 Float<minnum, maxnum, minden, maxden>::Float(const Json::Value* value)
   : PrimitiveType(InitHelper(value, &Json::Value::isDouble)),
@@ -175,6 +298,17 @@ Float<minnum, maxnum, minden, maxden>::Float(const Json::Value* value)
   }
 }
 
+template<int64_t minnum, int64_t maxnum, int64_t minden, int64_t maxden>
+Float<minnum, maxnum, minden, maxden>::Float(JsonStreamReader* reader)
+  : PrimitiveType(InitHelper(reader, &JsonStreamReader::NextIsDouble)),
+    value_() {
+  impl::SkipIfInvalid(is_valid(), reader);
+  if (is_valid()) {
+    value_ = reader->TakeDouble();
+    value_state_ = range_.Includes(value_) ? kValid : kInvalid;
+  }
+}
+
 template<int64_t minnum, int64_t maxnum, int64_t minden, int64_t maxden>
 Float<minnum, maxnum, minden, maxden>::Float(const Json::Value* value,
     double def_value)
@@ -193,6 +327,12 @@ Json::Value Float<minnum, maxnum, minden, maxden>::ToJsonValue() const {
   return Json::Value(value_);
 }
 
+template<int64_t minnum, int64_t maxnum, int64_t minden, int64_t maxden>
+void Float<minnum, maxnum, minden, maxden>::ToJsonWriter(
+    JsonStreamWriter* writer) const {
+  writer->WriteDouble(value_);
+}
+
 template<size_t minlen, size_t maxlen>
 String<minlen, maxlen>::String(const Json::Value* value)
   : PrimitiveType(InitHelper(value, &Json::Value::isString)),
@@ -202,6 +342,17 @@ String<minlen, maxlen>::String(const Json::Value* value)
   }
 }
 
+template<size_t minlen, size_t maxlen>
+String<minlen, maxlen>::String(JsonStreamReader* reader)
+  : PrimitiveType(InitHelper(reader, &JsonStreamReader::NextIsString)),
+    value_() {
+  impl::SkipIfInvalid(is_valid(), reader);
+  if (is_valid()) {
+    value_ = reader->TakeString();
+    value_state_ = length_range_.Includes(value_.length()) ? kValid : kInvalid;
+  }
+}
+
 template<size_t minlen, size_t maxlen>
 String<minlen, maxlen>::String(const Json::Value* value, const std::string& def_value)
   : PrimitiveType(InitHelper(value, &Json::Value::isString)),
@@ -218,6 +369,11 @@ Json::Value String<minlen, maxlen>::ToJsonValue() const {
   return Json::Value(value_);
 }
 
+template<size_t minlen, size_t maxlen>
+void String<minlen, maxlen>::ToJsonWriter(JsonStreamWriter* writer) const {
+  writer->WriteString(value_);
+}
+
 template<typename T>
 Enum<T>::Enum(const Json::Value* value)
   : PrimitiveType(InitHelper(value, &Json::Value::isString)),
@@ -228,6 +384,17 @@ Enum<T>::Enum(const Json::Value* value)
   }
 }
 
+template<typename T>
+Enum<T>::Enum(JsonStreamReader* reader)
+  : PrimitiveType(InitHelper(reader, &JsonStreamReader::NextIsString)),
+    value_(EnumType()) {
+  impl::SkipIfInvalid(is_valid(), reader);
+  if (is_valid()) {
+    value_state_ =
+      EnumFromJsonString(reader->TakeString(), &value_) ? kValid : kInvalid;
+  }
+}
+
 template<typename T>
 Enum<T>::Enum(const Json::Value* value, EnumType def_value)
   : PrimitiveType(InitHelper(value, &Json::Value::isString)),
@@ -245,6 +412,11 @@ Json::Value Enum<T>::ToJsonValue() const {
   return Json::Value(Json::StaticString(EnumToJsonString(value_)));
 }
 
+template<typename T>
+void Enum<T>::ToJsonWriter(JsonStreamWriter* writer) const {
+  writer->WriteString(EnumToJsonString(value_));
+}
+
 // Non-const version
 template<typename T, size_t minsize, size_t maxsize>
 Array<T, minsize, maxsize>::Array(Json::Value* value)
@@ -279,6 +451,21 @@ Array<T, minsize, maxsize>::Array(const Json::Value* value)
   }
 }
 
+template<typename T, size_t minsize, size_t maxsize>
+Array<T, minsize, maxsize>::Array(JsonStreamReader* reader)
+  : CompositeType(InitHelper(reader, &JsonStreamReader::NextIsArray)) {
+  if (reader) {
+    if (reader->NextIsArray()) {
+      reader->TakeArrayStart();
+      while (reader->NextElement()) {
+        ArrayType::push_back(T(reader));
+      }
+    } else {
+      reader->SkipValue();
+    }
+  }
+}
+
 template<typename T, size_t minsize, size_t maxsize>
 Json::Value Array<T, minsize, maxsize>::ToJsonValue() const {
   Json::Value array(Json::arrayValue);
@@ -289,6 +476,15 @@ Json::Value Array<T, minsize, maxsize>::ToJsonValue() const {
   return array;
 }
 
+template<typename T, size_t minsize, size_t maxsize>
+void Array<T, minsize, maxsize>::ToJsonWriter(JsonStreamWriter* writer) const {
+  writer->WriteArrayStart();
+  for (size_t i = 0; i != this->size(); ++i) {
+    (this->operator [](i)).ToJsonWriter(writer);
+  }
+  writer->WriteArrayEnd();
+}
+
 // Non-const version
 template<typename T, size_t minsize, size_t maxsize>
 Map<T, minsize, maxsize>::Map(Json::Value* value)
@@ -320,6 +516,22 @@ Map<T, minsize, maxsize>::Map(const Json::Value* value)
   }
 }
 
+template<typename T, size_t minsize, size_t maxsize>
+Map<T, minsize, maxsize>::Map(JsonStreamReader* reader)
+  : CompositeType(InitHelper(reader, &JsonStreamReader::NextIsObject)) {
+  if (reader) {
+    if (reader->NextIsObject()) {
+      reader->TakeObjectStart();
+      std::string key;
+      while (reader->NextMember(&key)) {
+        impl::ReadJsonMapItem(reader, key, this);
+      }
+    } else {
+      reader->SkipValue();
+    }
+  }
+}
+
 template<typename T, size_t minsize, size_t maxsize>
 Json::Value Map<T, minsize, maxsize>::ToJsonValue() const {
   Json::Value map(Json::objectValue);
@@ -329,6 +541,16 @@ Json::Value Map<T, minsize, maxsize>::ToJsonValue() const {
   return map;
 }
 
+template<typename T, size_t minsize, size_t maxsize>
+void Map<T, minsize, maxsize>::ToJsonWriter(JsonStreamWriter* writer) const {
+  writer->WriteObjectStart();
+  for (typename MapType::const_iterator i = this->begin(); i != this->end(); ++i) {
+    writer->WriteMemberName(i->first);
+    i->second.ToJsonWriter(writer);
+  }
+  writer->WriteObjectEnd();
+}
+
 template<typename T>
 Nullable<T>::Nullable(const Json::Value* value)
   : T(value),
@@ -341,6 +563,17 @@ Nullable<T>::Nullable(Json::Value* value)
     marked_null_(value != NULL&&  value->isNull()) {
 }
 
+// Null is not passed to T, so T stays uninitialized, it is not used
+// when value is marked as null
+template<typename T>
+Nullable<T>::Nullable(JsonStreamReader* reader)
+  : T(NULL != reader && !reader->NextIsNull() ? reader : NULL),
+    marked_null_(NULL != reader && reader->NextIsNull()) {
+  if (marked_null_) {
+    reader->TakeNull();
+  }
+}
+
 template<typename T>
 template<typename U>
 Nullable<T>::Nullable(const Json::Value* value, const U& def_value)
@@ -353,6 +586,15 @@ inline Json::Value Nullable<T>::ToJsonValue() const {
   return marked_null_ ? Json::Value::null : T::ToJsonValue();
 }
 
+template<typename T>
+inline void Nullable<T>::ToJsonWriter(JsonStreamWriter* writer) const {
+  if (marked_null_) {
+    writer->WriteNull();
+  } else {
+    T::ToJsonWriter(writer);
+  }
+}
+
 template<typename T>
 template<typename U>
 Optional<T>::Optional(const Json::Value* value, const U& def_value)
@@ -364,6 +606,11 @@ inline Json::Value Optional<T>::ToJsonValue() const {
   return value_.ToJsonValue();
 }
 
+template<typename T>
+inline void Optional<T>::ToJsonWriter(JsonStreamWriter* writer) const {
+  value_.ToJsonWriter(writer);
+}
+
 template<typename T>
 Stringifyable<T>::Stringifyable(const Json::Value* value)
   : T(NULL != value&&  !value->isString() ? value : NULL),
@@ -376,6 +623,13 @@ Stringifyable<T>::Stringifyable(Json::Value* value)
     predefined_string_(NULL != value&&   value->isString() ? value->asString() : "") {
 }
 
+template<typename T>
+Stringifyable<T>::Stringifyable(JsonStreamReader* reader)
+  : T(NULL != reader && !reader->NextIsString() ? reader : NULL),
+    predefined_string_(NULL != reader && reader->NextIsString() ?
+                       reader->TakeString() : "") {
+}
+
 template<typename T>
 template<typename U>
 Stringifyable<T>::Stringifyable(const Json::Value* value, const U& def_value)
@@ -388,6 +642,15 @@ inline Json::Value Stringifyable<T>::ToJsonValue() const {
   return predefined_string_.empty() ? T::ToJsonValue() : predefined_string_;
 }
 
+template<typename T>
+inline void Stringifyable<T>::ToJsonWriter(JsonStreamWriter* writer) const {
+  if (predefined_string_.empty()) {
+    T::ToJsonWriter(writer);
+  } else {
+    writer->WriteString(predefined_string_);
+  }
+}
+
 }  // namespace rpc
 
 #endif /* VALIDATED_TYPES_JSON_INL_H_ */
@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "rpc_base/json_stream_reader.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits>
+
+namespace {
+const int64_t kMaxInt = std::numeric_limits<int32_t>::max();
+
+bool IsNumberChar(char c) {
+  return (c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.' ||
+         c == 'e' || c == 'E';
+}
+
+void AppendUtf8(uint32_t code_point, std::string* value) {
+  if (code_point <= 0x7F) {
+    value->push_back(static_cast<char>(code_point));
+  } else if (code_point <= 0x7FF) {
+    value->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    value->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point <= 0xFFFF) {
+    value->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    value->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    value->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point <= 0x10FFFF) {
+    value->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    value->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    value->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    value->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+}  // namespace
+
+namespace rpc {
+
+JsonStreamReader::JsonStreamReader(const char* begin, const char* end)
+  : begin_(begin),
+    end_(end),
+    current_(begin),
+    container_started_(false) {
+  // Data is treated as C string, same as it was passed to Json::Reader
+  const void* terminator = memchr(begin_, '\0', end_ - begin_);
+  if (terminator) {
+    end_ = static_cast<const char*>(terminator);
+  }
+  SkipWhitespace();
+}
+
+bool JsonStreamReader::has_failed() const {
+  return !error_.empty();
+}
+
+const std::string& JsonStreamReader::error() const {
+  return error_;
+}
+
+size_t JsonStreamReader::error_offset() const {
+  return current_ - begin_;
+}
+
+bool JsonStreamReader::NextIsNull() const {
+  return current_ != end_ && *current_ == 'n' && !has_failed();
+}
+
+bool JsonStreamReader::NextIsBool() const {
+  return current_ != end_ && (*current_ == 't' || *current_ == 'f') &&
+         !has_failed();
+}
+
+bool JsonStreamReader::NextIsInt() const {
+  return NextNumberType() == kIntNumber;
+}
+
+bool JsonStreamReader::NextIsUInt() const {
+  return NextNumberType() == kUIntNumber;
+}
+
+bool JsonStreamReader::NextIsDouble() const {
+  return NextNumberType() == kRealNumber;
+}
+
+bool JsonStreamReader::NextIsString() const {
+  return current_ != end_ && *current_ == '"' && !has_failed();
+}
+
+bool JsonStreamReader::NextIsArray() const {
+  return current_ != end_ && *current_ == '[' && !has_failed();
+}
+
+bool JsonStreamReader::NextIsObject() const {
+  return current_ != end_ && *current_ == '{' && !has_failed();
+}
+
+void JsonStreamReader::TakeNull() {
+  TakeLiteral("null");
+}
+
+bool JsonStreamReader::TakeBool() {
+  if (NextIsBool() && *current_ == 't') {
+    return TakeLiteral("true");
+  }
+  TakeLiteral("false");
+  return false;
+}
+
+int64_t JsonStreamReader::TakeInt64() {
+  if (!NextIsInt()) {
+    MarkFailed("Integer value expected");
+    return 0;
+  }
+  const bool is_negative = *current_ == '-';
+  if (is_negative) {
+    ++current_;
+  }
+  const uint64_t value = TakeDigits();
+  return is_negative ? static_cast<int64_t>(0 - value)
+                     : static_cast<int64_t>(value);
+}
+
+uint64_t JsonStreamReader::TakeUInt64() {
+  if (!NextIsUInt()) {
+    MarkFailed("Unsigned integer value expected");
+    return 0;
+  }
+  return TakeDigits();
+}
+
+double JsonStreamReader::TakeDouble() {
+  if (NextNumberType() == kNotNumber) {
+    MarkFailed("Number expected");
+    return 0.0;
+  }
+  const char* number_end = NumberEnd();
+  // Number token is copied since buffer is not null-terminated
+  const std::string token(current_, number_end);
+  char* parsed_end = NULL;
+  const double value = strtod(token.c_str(), &parsed_end);
+  if (parsed_end == token.c_str()) {
+    MarkFailed("'" + token + "' is not a number.");
+    return 0.0;
+  }
+  current_ = number_end;
+  SkipWhitespace();
+  return value;
+}
+
+std::string JsonStreamReader::TakeString() {
+  std::string value;
+  TakeStringToken(&value);
+  SkipWhitespace();
+  return value;
+}
+
+bool JsonStreamReader::TakeArrayStart() {
+  if (!NextIsArray()) {
+    MarkFailed("Array expected");
+    return false;
+  }
+  ++current_;
+  container_started_ = true;
+  SkipWhitespace();
+  return true;
+}
+
+bool JsonStreamReader::NextElement() {
+  return NextElementOrMember(']');
+}
+
+bool JsonStreamReader::TakeObjectStart() {
+  if (!NextIsObject()) {
+    MarkFailed("Object expected");
+    return false;
+  }
+  ++current_;
+  container_started_ = true;
+  SkipWhitespace();
+  return true;
+}
+
+bool JsonStreamReader::NextMember(std::string* name) {
+  if (!NextElementOrMember('}')) {
+    return false;
+  }
+  if (!NextIsString()) {
+    MarkFailed("Missing '}' or object member name");
+    return false;
+  }
+  name->clear();
+  TakeStringToken(name);
+  SkipWhitespace();
+  if (!TakeChar(':')) {
+    MarkFailed("Missing ':' after object member name");
+    return false;
+  }
+  return !has_failed();
+}
+
+void JsonStreamReader::SkipValue() {
+  if (has_failed() || current_ == end_) {
+    MarkFailed("Value expected");
+    return;
+  }
+  switch (*current_) {
+    case '{': {
+      std::string name;
+      TakeObjectStart();
+      while (NextMember(&name)) {
+        SkipValue();
+      }
+      break;
+    }
+    case '[': {
+      TakeArrayStart();
+      while (NextElement()) {
+        SkipValue();
+      }
+      break;
+    }
+    case '"': {
+      // Strings are decoded anyway to validate escapes
+      TakeString();
+      break;
+    }
+    case 'n': {
+      TakeNull();
+      break;
+    }
+    case 't':
+    case 'f': {
+      TakeBool();
+      break;
+    }
+    default: {
+      TakeDouble();
+      break;
+    }
+  }
+}
+
+JsonStreamReader::NumberType JsonStreamReader::NextNumberType() const {
+  if (current_ == end_ || has_failed() ||
+      !((*current_ >= '0' && *current_ <= '9') || *current_ == '-')) {
+    return kNotNumber;
+  }
+  // Same classification as Json::Reader::decodeNumber() does
+  const char* number_end = NumberEnd();
+  for (const char* i = current_; i != number_end; ++i) {
+    if (*i == '.' || *i == 'e' || *i == 'E' || *i == '+' ||
+        (*i == '-' && i != current_)) {
+      return kRealNumber;
+    }
+  }
+  const bool is_negative = *current_ == '-';
+  const uint64_t max_value =
+    is_negative ? uint64_t(std::numeric_limits<int64_t>::max()) + 1
+                : std::numeric_limits<uint64_t>::max();
+  const uint64_t threshold = max_value / 10;
+  const uint64_t last_digit_threshold = max_value % 10;
+  uint64_t value = 0;
+  for (const char* i = current_ + (is_negative ? 1 : 0); i != number_end; ++i) {
+    const uint64_t digit = *i - '0';
+    if (value >= threshold &&
+        (i + 1 != number_end || digit > last_digit_threshold)) {
+      return kRealNumber;
+    }
+    value = value * 10 + digit;
+  }
+  if (is_negative || value <= uint64_t(kMaxInt)) {
+    return kIntNumber;
+  }
+  return kUIntNumber;
+}
+
+uint64_t JsonStreamReader::TakeDigits() {
+  // Overflow is already excluded by NextNumberType()
+  const char* number_end = NumberEnd();
+  uint64_t value = 0;
+  for (; current_ != number_end; ++current_) {
+    value = value * 10 + (*current_ - '0');
+  }
+  SkipWhitespace();
+  return value;
+}
+
+const char* JsonStreamReader::NumberEnd() const {
+  const char* number_end = current_;
+  while (number_end != end_ && IsNumberChar(*number_end)) {
+    ++number_end;
+  }
+  return number_end;
+}
+
+bool JsonStreamReader::NextIsValue() const {
+  return NextIsNull() || NextIsBool() || NextNumberType() != kNotNumber ||
+         NextIsString() || NextIsArray() || NextIsObject();
+}
+
+bool JsonStreamReader::TakeChar(char c) {
+  if (current_ == end_ || *current_ != c) {
+    return false;
+  }
+  ++current_;
+  SkipWhitespace();
+  return true;
+}
+
+bool JsonStreamReader::TakeLiteral(const char* literal) {
+  const size_t length = strlen(literal);
+  if (has_failed() || size_t(end_ - current_) < length ||
+      strncmp(current_, literal, length) != 0) {
+    MarkFailed(std::string("'") + literal + "' expected");
+    return false;
+  }
+  current_ += length;
+  SkipWhitespace();
+  return true;
+}
+
+void JsonStreamReader::TakeStringToken(std::string* value) {
+  if (!NextIsString()) {
+    MarkFailed("String expected");
+    return;
+  }
+  const char* i = current_ + 1;
+  while (i != end_ && *i != '"') {
+    // Unescaped parts are appended at once
+    const char* chunk_end = i;
+    while (chunk_end != end_ && *chunk_end != '"' && *chunk_end != '\\') {
+      ++chunk_end;
+    }
+    value->append(i, chunk_end);
+    i = chunk_end;
+    if (i == end_ || *i != '\\') {
+      continue;
+    }
+    if (++i == end_) {
+      break;
+    }
+    switch (*i++) {
+      case '"': value->push_back('"'); break;
+      case '/': value->push_back('/'); break;
+      case '\\': value->push_back('\\'); break;
+      case 'b': value->push_back('\b'); break;
+      case 'f': value->push_back('\f'); break;
+      case 'n': value->push_back('\n'); break;
+      case 'r': value->push_back('\r'); break;
+      case 't': value->push_back('\t'); break;
+      case 'u': {
+        current_ = i;
+        uint32_t code_point = 0;
+        if (!TakeUnicodeEscape(&code_point)) {
+          return;
+        }
+        AppendUtf8(code_point, value);
+        i = current_;
+        break;
+      }
+      default: {
+        current_ = i - 1;
+        MarkFailed("Bad escape sequence in string");
+        return;
+      }
+    }
+  }
+  if (i == end_) {
+    MarkFailed("Missing '\"' at the end of string");
+    return;
+  }
+  current_ = i + 1;
+}
+
+bool JsonStreamReader::TakeUnicodeEscape(uint32_t* code_point) {
+  // Reads hex digits of \uXXXX escape, and the pair of it for surrogates
+  *code_point = 0;
+  for (int escape = 0; escape < 2; ++escape) {
+    if (end_ - current_ < 4) {
+      MarkFailed("Bad unicode escape sequence in string");
+      return false;
+    }
+    uint32_t unit = 0;
+    for (int digit = 0; digit < 4; ++digit) {
+      const char c = *current_++;
+      unit *= 16;
+      if (c >= '0' && c <= '9') {
+        unit += c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        unit += c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        unit += c - 'A' + 10;
+      } else {
+        MarkFailed("Bad unicode escape sequence in string");
+        return false;
+      }
+    }
+    if (escape == 0) {
+      *code_point = unit;
+      if (unit < 0xD800 || unit > 0xDBFF) {
+        return true;
+      }
+      if (end_ - current_ < 2 || current_[0] != '\\' || current_[1] != 'u') {
+        MarkFailed("Expecting another \\u token to begin the second half of "
+                   "a unicode surrogate pair");
+        return false;
+      }
+      current_ += 2;
+    } else {
+      *code_point = 0x10000 + ((*code_point & 0x3FF) << 10) + (unit & 0x3FF);
+    }
+  }
+  return true;
+}
+
+bool JsonStreamReader::NextElementOrMember(char end_char) {
+  if (has_failed()) {
+    return false;
+  }
+  const bool is_first = container_started_;
+  container_started_ = false;
+  if (TakeChar(end_char)) {
+    return false;
+  }
+  if (!is_first && !TakeChar(',')) {
+    MarkFailed(std::string("Missing ',' or '") + end_char + "'");
+    return false;
+  }
+  if (!is_first && end_char == ']' && !NextIsValue()) {
+    MarkFailed("Value expected after ','");
+    return false;
+  }
+  return true;
+}
+
+void JsonStreamReader::SkipWhitespace() {
+  while (current_ != end_) {
+    const char c = *current_;
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      ++current_;
+    } else if (c == '/' && end_ - current_ > 1 && current_[1] == '/') {
+      // Comments are allowed, as Json::Reader does by default
+      while (current_ != end_ && *current_ != '\n' && *current_ != '\r') {
+        ++current_;
+      }
+    } else if (c == '/' && end_ - current_ > 1 && current_[1] == '*') {
+      const char* comment_end = current_ + 2;
+      while (comment_end != end_ &&
+             !(*comment_end == '*' && comment_end + 1 != end_ &&
+               comment_end[1] == '/')) {
+        ++comment_end;
+      }
+      current_ = comment_end == end_ ? end_ : comment_end + 2;
+    } else {
+      break;
+    }
+  }
+}
+
+void JsonStreamReader::MarkFailed(const std::string& error) {
+  if (error_.empty()) {
+    error_ = error;
+  }
+}
+
+}  // namespace rpc
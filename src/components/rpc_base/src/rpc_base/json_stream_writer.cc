@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "rpc_base/json_stream_writer.h"
+
+#include "json/writer.h"
+
+namespace rpc {
+
+JsonStreamWriter::JsonStreamWriter(std::string* output)
+  : output_(output),
+    value_written_(false) {
+}
+
+void JsonStreamWriter::WriteNull() {
+  WriteSeparator();
+  output_->append("null");
+  value_written_ = true;
+}
+
+void JsonStreamWriter::WriteBool(bool value) {
+  WriteSeparator();
+  output_->append(value ? "true" : "false");
+  value_written_ = true;
+}
+
+void JsonStreamWriter::WriteInt64(int64_t value) {
+  WriteSeparator();
+  output_->append(Json::valueToString(Json::LargestInt(value)));
+  value_written_ = true;
+}
+
+void JsonStreamWriter::WriteDouble(double value) {
+  WriteSeparator();
+  output_->append(Json::valueToString(value));
+  value_written_ = true;
+}
+
+void JsonStreamWriter::WriteString(const std::string& value) {
+  WriteSeparator();
+  output_->append(Json::valueToQuotedString(value.c_str()));
+  value_written_ = true;
+}
+
+void JsonStreamWriter::WriteArrayStart() {
+  WriteSeparator();
+  output_->push_back('[');
+  value_written_ = false;
+}
+
+void JsonStreamWriter::WriteArrayEnd() {
+  output_->push_back(']');
+  value_written_ = true;
+}
+
+void JsonStreamWriter::WriteObjectStart() {
+  WriteSeparator();
+  output_->push_back('{');
+  value_written_ = false;
+}
+
+void JsonStreamWriter::WriteObjectEnd() {
+  output_->push_back('}');
+  value_written_ = true;
+}
+
+void JsonStreamWriter::WriteMemberName(const std::string& name) {
+  WriteSeparator();
+  output_->append(Json::valueToQuotedString(name.c_str()));
+  output_->push_back(':');
+  // Member value follows the name without separator
+  value_written_ = false;
+}
+
+void JsonStreamWriter::WriteSeparator() {
+  if (value_written_) {
+    output_->push_back(',');
+  }
+}
+
+}  // namespace rpc
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string>
+#include "gtest/gtest.h"
+#include "json/reader.h"
+#include "json/value.h"
+#include "rpc_base/rpc_base.h"
+
+namespace test {
+using namespace rpc;
+
+namespace {
+enum TestEnum {
+  kValue0,
+  kValue1
+};
+
+bool EnumFromJsonString(const std::string& value, TestEnum* enm) {
+  if (value == "kValue0") {
+    *enm = kValue0;
+    return true;
+  } else if (value == "kValue1") {
+    *enm = kValue1;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+// Reader does not own the data, json string must outlive it
+JsonStreamReader StreamOf(const std::string& json) {
+  return JsonStreamReader(json.data(), json.data() + json.size());
+}
+
+}  // namespace
+
+TEST(JsonStreamReaderTest, ReadsScalars) {
+  const std::string json =
+      "[null, true, false, -42, 42, 4294967295, 1.5e3, \"text\"]";
+  JsonStreamReader reader = StreamOf(json);
+  ASSERT_TRUE(reader.TakeArrayStart());
+  ASSERT_TRUE(reader.NextElement());
+  ASSERT_TRUE(reader.NextIsNull());
+  reader.TakeNull();
+  ASSERT_TRUE(reader.NextElement());
+  EXPECT_TRUE(reader.TakeBool());
+  ASSERT_TRUE(reader.NextElement());
+  EXPECT_FALSE(reader.TakeBool());
+  ASSERT_TRUE(reader.NextElement());
+  ASSERT_TRUE(reader.NextIsInt());
+  EXPECT_EQ(-42, reader.TakeInt64());
+  ASSERT_TRUE(reader.NextElement());
+  ASSERT_TRUE(reader.NextIsInt());
+  EXPECT_EQ(42, reader.TakeInt64());
+  ASSERT_TRUE(reader.NextElement());
+  // Same as Json::Reader, integers above int range are unsigned
+  ASSERT_TRUE(reader.NextIsUInt());
+  EXPECT_EQ(4294967295u, reader.TakeUInt64());
+  ASSERT_TRUE(reader.NextElement());
+  ASSERT_TRUE(reader.NextIsDouble());
+  EXPECT_DOUBLE_EQ(1500.0, reader.TakeDouble());
+  ASSERT_TRUE(reader.NextElement());
+  ASSERT_TRUE(reader.NextIsString());
+  EXPECT_EQ("text", reader.TakeString());
+  EXPECT_FALSE(reader.NextElement());
+  EXPECT_FALSE(reader.has_failed());
+}
+
+TEST(JsonStreamReaderTest, DecodesStringEscapes) {
+  const std::string json =
+      "\"a\\\"b\\\\c\\/d\\n\\t\\u0041\\u00e9\\u20ac\\ud83d\\ude00\"";
+  JsonStreamReader reader = StreamOf(json);
+  EXPECT_EQ("a\"b\\c/d\n\tA\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80",
+            reader.TakeString());
+  EXPECT_FALSE(reader.has_failed());
+}
+
+TEST(JsonStreamReaderTest, IteratesObjectMembers) {
+  const std::string json =
+      "{ \"first\" : 1, /* comment */ \"second\": {\"nested\": [1, [2]]},\n"
+      "  // comment\n"
+      "  \"third\": \"value\" }";
+  JsonStreamReader reader = StreamOf(json);
+  std::string name;
+  ASSERT_TRUE(reader.TakeObjectStart());
+  ASSERT_TRUE(reader.NextMember(&name));
+  EXPECT_EQ("first", name);
+  reader.SkipValue();
+  ASSERT_TRUE(reader.NextMember(&name));
+  EXPECT_EQ("second", name);
+  reader.SkipValue();
+  ASSERT_TRUE(reader.NextMember(&name));
+  EXPECT_EQ("third", name);
+  EXPECT_EQ("value", reader.TakeString());
+  EXPECT_FALSE(reader.NextMember(&name));
+  EXPECT_FALSE(reader.has_failed());
+}
+
+TEST(JsonStreamReaderTest, FailsOnMalformedJson) {
+  const char* malformed[] = {
+    "",
+    "{\"a\": 1,}",
+    "{\"a\" 1}",
+    "[1 2]",
+    "[1,]",
+    "{\"a\": [1}",
+    "\"unterminated",
+    "\"bad \\x escape\"",
+    "\"\\ud800 lone surrogate\"",
+    "tru"
+  };
+  for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); ++i) {
+    const std::string json(malformed[i]);
+    JsonStreamReader reader = StreamOf(json);
+    reader.SkipValue();
+    EXPECT_TRUE(reader.has_failed()) << malformed[i];
+    Json::Value value;
+    EXPECT_FALSE(Json::Reader().parse(malformed[i], value)) << malformed[i];
+  }
+}
+
+TEST(JsonStreamReaderTest, StopsAtNullCharacter) {
+  const std::string json("{}\0garbage", 10);
+  JsonStreamReader reader = StreamOf(json);
+  reader.SkipValue();
+  EXPECT_FALSE(reader.has_failed());
+  EXPECT_EQ(2u, reader.error_offset());
+}
+
+TEST(ValidatedTypesJsonStream, PrimitivesFromStream) {
+  const std::string json =
+      "[true, 42, 500, 3.5, \"string\", \"kValue1\", \"kValue5\", 7]";
+  JsonStreamReader reader = StreamOf(json);
+  ASSERT_TRUE(reader.TakeArrayStart());
+  ASSERT_TRUE(reader.NextElement());
+  Boolean boolean(&reader);
+  EXPECT_TRUE(boolean.is_valid());
+  EXPECT_TRUE(boolean);
+  ASSERT_TRUE(reader.NextElement());
+  Integer<int32_t, -5, 192> integer(&reader);
+  EXPECT_TRUE(integer.is_valid());
+  EXPECT_EQ(42, integer);
+  ASSERT_TRUE(reader.NextElement());
+  Integer<int32_t, -5, 192> out_of_range(&reader);
+  EXPECT_TRUE(out_of_range.is_initialized());
+  EXPECT_FALSE(out_of_range.is_valid());
+  ASSERT_TRUE(reader.NextElement());
+  Float<1, 7> flt(&reader);
+  EXPECT_TRUE(flt.is_valid());
+  EXPECT_DOUBLE_EQ(3.5, flt);
+  ASSERT_TRUE(reader.NextElement());
+  String<1, 10> str(&reader);
+  EXPECT_TRUE(str.is_valid());
+  EXPECT_EQ("string", std::string(str));
+  ASSERT_TRUE(reader.NextElement());
+  Enum<TestEnum> enm(&reader);
+  EXPECT_TRUE(enm.is_valid());
+  EXPECT_EQ(kValue1, enm);
+  ASSERT_TRUE(reader.NextElement());
+  Enum<TestEnum> unknown_enm(&reader);
+  EXPECT_TRUE(unknown_enm.is_initialized());
+  EXPECT_FALSE(unknown_enm.is_valid());
+  ASSERT_TRUE(reader.NextElement());
+  // Value of wrong type is skipped
+  String<1, 10> wrong_type(&reader);
+  EXPECT_TRUE(wrong_type.is_initialized());
+  EXPECT_FALSE(wrong_type.is_valid());
+  EXPECT_FALSE(reader.NextElement());
+  EXPECT_FALSE(reader.has_failed());
+}
+
+TEST(ValidatedTypesJsonStream, AbsentValue) {
+  JsonStreamReader* novalue = NULL;
+  Integer<int32_t, -5, 192> integer(novalue);
+  EXPECT_FALSE(integer.is_initialized());
+  Array<Boolean, 0, 5> array(novalue);
+  EXPECT_FALSE(array.is_initialized());
+  Optional<Boolean> optional(novalue);
+  EXPECT_FALSE(optional.is_initialized());
+  EXPECT_TRUE(optional.is_valid());
+}
+
+TEST(ValidatedTypesJsonStream, ContainersFromStream) {
+  const std::string json =
+      "{\"a\": [\"kValue0\", \"kValue1\"], \"b\": [], \"c\": null,"
+      " \"d\": \"predefined\", \"a\": [\"kValue1\"]}";
+  JsonStreamReader reader = StreamOf(json);
+  Map<Stringifyable<Nullable<Array<Enum<TestEnum>, 0, 5> > >, 0, 5> map(
+      &reader);
+  ASSERT_FALSE(reader.has_failed());
+  EXPECT_TRUE(map.is_valid());
+  ASSERT_EQ(4u, map.size());
+  // Last of the duplicated members wins, as in Json::Value
+  ASSERT_EQ(1u, map["a"].size());
+  EXPECT_EQ(kValue1, map["a"][0]);
+  EXPECT_TRUE(map["b"].is_valid());
+  EXPECT_TRUE(map["b"].empty());
+  EXPECT_TRUE(map["c"].is_null());
+  EXPECT_TRUE(map["d"].is_string());
+  EXPECT_EQ("predefined", map["d"].get_string());
+}
+
+TEST(ValidatedTypesJsonStream, SameStateAsJsonValue) {
+  const char* jsons[] = {
+    "[]", "[1, 2]", "[1, \"2\"]", "{}", "null", "\"str\"", "5", "[1, 2, 3, 4]"
+  };
+  for (size_t i = 0; i < sizeof(jsons) / sizeof(jsons[0]); ++i) {
+    Json::Value value;
+    ASSERT_TRUE(Json::Reader().parse(jsons[i], value)) << jsons[i];
+    Array<Integer<int8_t, 0, 5>, 1, 3> from_value(&value);
+    const std::string json(jsons[i]);
+    JsonStreamReader reader = StreamOf(json);
+    Array<Integer<int8_t, 0, 5>, 1, 3> from_stream(&reader);
+    EXPECT_FALSE(reader.has_failed()) << jsons[i];
+    EXPECT_EQ(from_value.is_initialized(), from_stream.is_initialized())
+        << jsons[i];
+    EXPECT_EQ(from_value.is_valid(), from_stream.is_valid()) << jsons[i];
+    EXPECT_EQ(from_value.ToJsonValue(), from_stream.ToJsonValue())
+        << jsons[i];
+  }
+}
+
+}  // namespace test
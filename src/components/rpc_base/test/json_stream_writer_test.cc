@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string>
+#include "gtest/gtest.h"
+#include "json/value.h"
+#include "json/writer.h"
+#include "rpc_base/rpc_base.h"
+
+namespace test {
+using namespace rpc;
+
+namespace {
+enum TestEnum {
+  kValue0,
+  kValue1
+};
+
+bool IsValidEnum(TestEnum val) {
+  return val == kValue0 || val == kValue1;
+}
+
+const char* EnumToJsonString(TestEnum enm) {
+  switch(enm) {
+    case kValue0: return "kValue0";
+    case kValue1: return "kValue1";
+    default: return "UNKNOWN";
+  }
+}
+
+// FastWriter terminates the document with a new line, stream writer doesn't
+std::string FastWrite(const Json::Value& value) {
+  std::string json = Json::FastWriter().write(value);
+  json.erase(json.size() - 1);
+  return json;
+}
+
+template<typename T>
+std::string StreamWrite(const T& value) {
+  std::string json;
+  JsonStreamWriter writer(&json);
+  value.ToJsonWriter(&writer);
+  return json;
+}
+
+}  // namespace
+
+TEST(JsonStreamWriterTest, WritesScalarsAndContainers) {
+  std::string json;
+  JsonStreamWriter writer(&json);
+  writer.WriteObjectStart();
+  writer.WriteMemberName("null");
+  writer.WriteNull();
+  writer.WriteMemberName("array");
+  writer.WriteArrayStart();
+  writer.WriteBool(true);
+  writer.WriteInt64(-42);
+  writer.WriteDouble(1.5);
+  writer.WriteArrayStart();
+  writer.WriteArrayEnd();
+  writer.WriteObjectStart();
+  writer.WriteObjectEnd();
+  writer.WriteArrayEnd();
+  writer.WriteMemberName("text");
+  writer.WriteString("a\"b\\c\n");
+  writer.WriteObjectEnd();
+  // Numbers are formatted by jsoncpp, as FastWriter does it
+  EXPECT_EQ("{\"null\":null,\"array\":[true,-42," + Json::valueToString(1.5) +
+            ",[],{}],\"text\":\"a\\\"b\\\\c\\n\"}", json);
+}
+
+TEST(ValidatedTypesJsonStream, PrimitivesToStream) {
+  const Boolean boolean(true);
+  EXPECT_EQ(FastWrite(boolean.ToJsonValue()), StreamWrite(boolean));
+  const Integer<int64_t, -5000000000, 5000000000> integer(-4000000000);
+  EXPECT_EQ(FastWrite(integer.ToJsonValue()), StreamWrite(integer));
+  const Float<-10, 10> real(3.25);
+  EXPECT_EQ(FastWrite(real.ToJsonValue()), StreamWrite(real));
+  const String<0, 100> text("Text with \"quotes\"\t\x01");
+  EXPECT_EQ(FastWrite(text.ToJsonValue()), StreamWrite(text));
+  const Enum<TestEnum> enm(kValue1);
+  EXPECT_EQ(FastWrite(enm.ToJsonValue()), StreamWrite(enm));
+}
+
+TEST(ValidatedTypesJsonStream, ContainersToStream) {
+  typedef Map<Array<Integer<int8_t, 0, 100>, 0, 5>, 0, 5> MapOfArrays;
+  MapOfArrays map;
+  map["b"].push_back(1);
+  map["b"].push_back(2);
+  map["a"];
+  EXPECT_EQ("{\"a\":[],\"b\":[1,2]}", StreamWrite(map));
+  EXPECT_EQ(FastWrite(map.ToJsonValue()), StreamWrite(map));
+
+  Nullable<Integer<int8_t, 0, 100> > nullable(5);
+  EXPECT_EQ("5", StreamWrite(nullable));
+  nullable.set_to_null();
+  EXPECT_EQ("null", StreamWrite(nullable));
+
+  Stringifyable<Nullable<Integer<int8_t, 0, 100> > > stringifyable(5);
+  EXPECT_EQ("5", StreamWrite(stringifyable));
+  stringifyable.set_to_string("default");
+  EXPECT_EQ("\"default\"", StreamWrite(stringifyable));
+}
+
+TEST(ValidatedTypesJsonStream, OptionalFieldIsSkippedIfAbsent) {
+  Optional<Integer<int8_t, 0, 100> > absent;
+  Optional<Integer<int8_t, 0, 100> > present(7);
+  std::string json;
+  JsonStreamWriter writer(&json);
+  writer.WriteObjectStart();
+  impl::WriteJsonField("absent", absent, &writer);
+  impl::WriteJsonField("present", present, &writer);
+  writer.WriteObjectEnd();
+  EXPECT_EQ("{\"present\":7}", json);
+}
+
+}  // namespace test
@@ -39,6 +39,8 @@
 #include <openssl/err.h>
 #include <string>
 #include <map>
+#include <list>
+#include <vector>
 
 #include "security_manager/crypto_manager.h"
 #include "security_manager/ssl_context.h"
@@ -61,22 +63,38 @@ class CryptoManagerImpl : public CryptoManager {
                          const uint8_t ** const out_data, size_t *out_data_size);
     virtual bool Decrypt(const uint8_t *const in_data,    size_t in_data_size,
                          const uint8_t ** const out_data, size_t *out_data_size);
+    virtual size_t EncryptBatch(Frame *frames, size_t frames_count);
+    virtual size_t DecryptBatch(Frame *frames, size_t frames_count);
     virtual bool IsInitCompleted() const;
     virtual bool IsHandshakePending() const;
     virtual size_t get_max_block_size(size_t mtu) const;
+    virtual size_t get_max_encrypted_size(size_t data_size) const;
     virtual std::string LastError() const;
     virtual ~SSLContextImpl();
 
    private:
     typedef size_t(*BlockSizeGetter)(size_t);
     void EnsureBufferSizeEnough(size_t size);
+    /**
+     * \brief Encrypts/decrypts one frame and sets its result,
+     * bio_locker shall be acquired
+     */
+    void EncryptFrame(Frame *frame);
+    void DecryptFrame(Frame *frame);
+    /**
+     * \brief Moves decrypted data of the frame to the overflow buffer
+     * with enough space for the rest of plain data
+     */
+    void GrowDecryptedFrame(Frame *frame);
     SSL *connection_;
     BIO *bioIn_;
     BIO *bioOut_;
-    BIO *bioFilter_;
     mutable sync_primitives::Lock bio_locker;
     size_t buffer_size_;
     uint8_t *buffer_;
+    // Decrypted data which does not fit the frames buffers,
+    // list keeps buffers addresses for the whole batch
+    std::list<std::vector<uint8_t> > overflow_buffers_;
     bool is_handshake_pending_;
     Mode mode_;
     BlockSizeGetter max_block_size_;
@@ -99,8 +117,15 @@ class CryptoManagerImpl : public CryptoManager {
   virtual std::string LastError() const;
 
  private:
+  /**
+   * \brief Keeps the last client session for handshake resumption
+   * on reconnect, called by OpenSSL on new session creation
+   */
+  static int OnNewClientSession(SSL *ssl, SSL_SESSION *session);
   SSL_CTX *context_;
   Mode mode_;
+  SSL_SESSION *client_session_;
+  sync_primitives::Lock client_session_lock_;
   static uint32_t instance_count_;
   DISALLOW_COPY_AND_ASSIGN(CryptoManagerImpl);
 };
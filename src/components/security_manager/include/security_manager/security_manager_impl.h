@@ -34,9 +34,13 @@
 #define SRC_COMPONENTS_SECURITY_MANAGER_INCLUDE_SECURITY_MANAGER_SECURITY_MANAGER_IMPL_H_
 
 #include <list>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "utils/macro.h"
+#include "utils/lock.h"
+#include "utils/date_time.h"
 #include "utils/message_queue.h"
 #include "utils/threads/message_loop_thread.h"
 
@@ -71,8 +75,12 @@ class SecurityManagerImpl
  public:
   /**
    * \brief Constructor
+   * \param handshake_workers_count count of threads processing handshakes,
+   * handshakes of different connections are processed in parallel
    */
-  SecurityManagerImpl();
+  explicit SecurityManagerImpl(
+      const size_t handshake_workers_count = kDefaultHandshakeWorkersCount);
+  ~SecurityManagerImpl();
   /**
    * \brief Add received from Mobile Application message
    * Overriden ProtocolObserver::OnMessageReceived method
@@ -149,12 +157,28 @@ class SecurityManagerImpl
    */
   void NotifyListenersOnHandshakeDone(const uint32_t &connection_key,
                                       const bool success);
+  /**
+   * \brief Handshake latency percentile over the last
+   * kHandshakeLatencySamples handshakes
+   * \param percentile value from 0 to 100
+   * \return latency in milliseconds, 0 if there were no handshakes
+   */
+  uint32_t HandshakeLatencyPercentile(const uint8_t percentile) const;
   /**
    * @brief SecurityConfigSection
    * @return Session name in config file
    */
   static const char *ConfigSection();
+
+  static const size_t kDefaultHandshakeWorkersCount = 2u;
+  static const size_t kHandshakeLatencySamples = 256u;
  private:
+  /**
+   * \brief Handshake latency measurement from the first handshake step
+   * till listeners notification
+   */
+  void StartHandshakeMetric(const uint32_t connection_key);
+  void FinishHandshakeMetric(const uint32_t connection_key);
   /**
    * \brief Sends Handshake binary data to mobile application
    * \param connection_key Unique key used by other components as session identifier
@@ -185,8 +209,9 @@ class SecurityManagerImpl
    */
   void SendQuery(const SecurityQuery &query, const uint32_t connection_key);
 
-  // Thread that pumps handshake data
-  SecurityMessageLoop security_messages_;
+  // Threads that pump handshake data, messages of one connection key
+  // are always processed by the same thread
+  std::vector<SecurityMessageLoop*> security_messages_;
 
   /**
    *\brief Pointer on instance of class implementing SessionObserver
@@ -204,6 +229,15 @@ class SecurityManagerImpl
    *\brief List of listeners for notify handshake done result
    */
   std::list<SecurityManagerListener *> listeners_;
+  // Recursive, as listeners could be (un)subscribed on notification
+  sync_primitives::Lock listeners_lock_;
+
+  // Handshake start time by connection key
+  std::map<uint32_t, TimevalStruct> handshake_start_times_;
+  // Ring of the last handshakes latencies in milliseconds
+  std::vector<uint32_t> handshake_latencies_;
+  size_t handshake_latency_index_;
+  mutable sync_primitives::Lock handshake_metric_lock_;
   DISALLOW_COPY_AND_ASSIGN(SecurityManagerImpl);
 };
 }  // namespace security_manager
@@ -40,6 +40,7 @@
 
 #define TLS1_1_MINIMAL_VERSION            0x1000103fL
 #define CONST_SSL_METHOD_MINIMAL_VERSION  0x00909000L
+#define THREAD_SAFE_MINIMAL_VERSION       0x10100000L
 
 namespace security_manager {
 
@@ -47,8 +48,44 @@ CREATE_LOGGERPTR_GLOBAL(logger_, "CryptoManagerImpl")
 
 uint32_t CryptoManagerImpl::instance_count_ = 0;
 
+namespace {
+// Sessions count and lifetime (in seconds) for handshake resumption
+const long kSessionCacheSize = 128;
+const long kSessionTimeout = 24 * 60 * 60;
+const unsigned char kSessionIdContext[] = "SDL";
+
+#if OPENSSL_VERSION_NUMBER < THREAD_SAFE_MINIMAL_VERSION
+// Old OpenSSL requires locking callbacks for the usage from several threads
+// (handshakes are processed by several SecurityManager threads)
+sync_primitives::Lock *ssl_locks = NULL;
+
+void LockingCallback(int mode, int lock_id, const char*, int) {
+  if (mode & CRYPTO_LOCK) {
+    ssl_locks[lock_id].Acquire();
+  } else {
+    ssl_locks[lock_id].Release();
+  }
+}
+#endif  // OPENSSL_VERSION_NUMBER < THREAD_SAFE_MINIMAL_VERSION
+}  // namespace
+
 CryptoManagerImpl::CryptoManagerImpl()
-    : context_(NULL), mode_(CLIENT) {
+    : context_(NULL), mode_(CLIENT), client_session_(NULL) {
+}
+
+int CryptoManagerImpl::OnNewClientSession(SSL *ssl, SSL_SESSION *session) {
+  CryptoManagerImpl *manager = static_cast<CryptoManagerImpl*>(
+      SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+  if (!manager) {
+    return 0;
+  }
+  sync_primitives::AutoLock locker(manager->client_session_lock_);
+  if (manager->client_session_) {
+    SSL_SESSION_free(manager->client_session_);
+  }
+  manager->client_session_ = session;
+  // Session reference is kept by manager
+  return 1;
 }
 
 bool CryptoManagerImpl::Init(Mode mode,
@@ -62,6 +99,10 @@ bool CryptoManagerImpl::Init(Mode mode,
     ERR_load_BIO_strings();
     OpenSSL_add_all_algorithms();
     SSL_library_init();
+#if OPENSSL_VERSION_NUMBER < THREAD_SAFE_MINIMAL_VERSION
+    ssl_locks = new sync_primitives::Lock[CRYPTO_num_locks()];
+    CRYPTO_set_locking_callback(&LockingCallback);
+#endif  // OPENSSL_VERSION_NUMBER < THREAD_SAFE_MINIMAL_VERSION
   }
 
   mode_ = mode;
@@ -117,6 +158,20 @@ bool CryptoManagerImpl::Init(Mode mode,
   // Disable SSL2 as deprecated
   SSL_CTX_set_options(context_, SSL_OP_NO_SSLv2);
 
+  // Cache sessions to skip full handshake on device reconnection:
+  // by session ID/ticket on server side, by the last session on client side
+  SSL_CTX_set_app_data(context_, this);
+  SSL_CTX_set_session_cache_mode(context_,
+      is_server ? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_CLIENT);
+  SSL_CTX_sess_set_cache_size(context_, kSessionCacheSize);
+  SSL_CTX_set_timeout(context_, kSessionTimeout);
+  if (is_server) {
+    SSL_CTX_set_session_id_context(context_, kSessionIdContext,
+                                   sizeof(kSessionIdContext) - 1);
+  } else {
+    SSL_CTX_sess_set_new_cb(context_, &CryptoManagerImpl::OnNewClientSession);
+  }
+
   if (cert_filename.empty()) {
     LOG4CXX_WARN(logger_, "Empty certificate path");
   } else {
@@ -163,8 +218,20 @@ bool CryptoManagerImpl::Init(Mode mode,
 }
 
 void CryptoManagerImpl::Finish() {
+  {
+    sync_primitives::AutoLock locker(client_session_lock_);
+    if (client_session_) {
+      SSL_SESSION_free(client_session_);
+      client_session_ = NULL;
+    }
+  }
   SSL_CTX_free(context_);
   if (atomic_post_dec(&instance_count_) == 1) {
+#if OPENSSL_VERSION_NUMBER < THREAD_SAFE_MINIMAL_VERSION
+    CRYPTO_set_locking_callback(NULL);
+    delete[] ssl_locks;
+    ssl_locks = NULL;
+#endif  // OPENSSL_VERSION_NUMBER < THREAD_SAFE_MINIMAL_VERSION
     EVP_cleanup();
     ERR_free_strings();
   }
@@ -183,6 +250,11 @@ SSLContext* CryptoManagerImpl::CreateSSLContext() {
     SSL_set_accept_state(conn);
   } else {
     SSL_set_connect_state(conn);
+    sync_primitives::AutoLock locker(client_session_lock_);
+    if (client_session_) {
+      // Try to resume the last session, full handshake is done on refuse
+      SSL_set_session(conn, client_session_);
+    }
   }
   return new SSLContextImpl(conn, mode_);
 }
@@ -31,6 +31,8 @@
  */
 
 #include "security_manager/security_manager_impl.h"
+#include <algorithm>
+#include <sstream>
 #include "security_manager/crypto_manager_impl.h"
 #include "protocol_handler/protocol_packet.h"
 #include "utils/logger.h"
@@ -44,9 +46,26 @@ CREATE_LOGGERPTR_GLOBAL(logger_, "SecurityManager")
 static const char* kErrId = "id";
 static const char* kErrText = "text";
 
-SecurityManagerImpl::SecurityManagerImpl()
-  : security_messages_("SecurityManager", this),
-  session_observer_(NULL), crypto_manager_(NULL), protocol_handler_(NULL) {
+const size_t SecurityManagerImpl::kDefaultHandshakeWorkersCount;
+const size_t SecurityManagerImpl::kHandshakeLatencySamples;
+
+SecurityManagerImpl::SecurityManagerImpl(const size_t handshake_workers_count)
+  : session_observer_(NULL), crypto_manager_(NULL), protocol_handler_(NULL),
+    listeners_lock_(true), handshake_latency_index_(0) {
+  const size_t workers_count = std::max<size_t>(handshake_workers_count, 1u);
+  for (size_t i = 0; i < workers_count; ++i) {
+    std::stringstream name;
+    name << "SecurityManager" << i;
+    security_messages_.push_back(new SecurityMessageLoop(name.str(), this));
+  }
+  handshake_latencies_.reserve(kHandshakeLatencySamples);
+}
+
+SecurityManagerImpl::~SecurityManagerImpl() {
+  for (std::vector<SecurityMessageLoop*>::iterator it =
+       security_messages_.begin(); it != security_messages_.end(); ++it) {
+    delete *it;
+  }
 }
 
 void SecurityManagerImpl::OnMessageReceived(
@@ -66,10 +85,13 @@ void SecurityManagerImpl::OnMessageReceived(
                       ERROR_INVALID_QUERY_SIZE, error_text);
     return;
   }
-  securityMessagePtr->set_connection_key(message->connection_key());
+  const uint32_t connection_key = message->connection_key();
+  securityMessagePtr->set_connection_key(connection_key);
 
-  // Post message to message query for next processing in thread
-  security_messages_.PostMessage(securityMessagePtr);
+  // Post message to message query for next processing in thread,
+  // handshake of each connection is always handled by the same thread
+  security_messages_[connection_key % security_messages_.size()]->
+      PostMessage(securityMessagePtr);
 }
 
 void SecurityManagerImpl::OnMobileMessageSent(
@@ -190,6 +212,7 @@ void SecurityManagerImpl::StartHandshake(uint32_t connection_key) {
     NotifyListenersOnHandshakeDone(connection_key, true);
     return;
   }
+  StartHandshakeMetric(connection_key);
   size_t data_size = 0;
   const uint8_t *data = NULL;
   const security_manager::SSLContext::HandshakeResult result =
@@ -211,6 +234,7 @@ void SecurityManagerImpl::AddListener(SecurityManagerListener *const listener) {
     LOG4CXX_ERROR(logger_, "Invalid (NULL) pointer to SecurityManagerListener.");
     return;
   }
+  sync_primitives::AutoLock lock(listeners_lock_);
   listeners_.push_back(listener);
 }
 void SecurityManagerImpl::RemoveListener(SecurityManagerListener *const listener) {
@@ -218,11 +242,17 @@ void SecurityManagerImpl::RemoveListener(SecurityManagerListener *const listener
     LOG4CXX_ERROR(logger_, "Invalid (NULL) pointer to SecurityManagerListener.");
     return;
   }
+  sync_primitives::AutoLock lock(listeners_lock_);
   listeners_.remove(listener);
 }
 void SecurityManagerImpl::NotifyListenersOnHandshakeDone(const uint32_t &connection_key,
                                                      const bool success) {
   LOG4CXX_TRACE(logger_, "NotifyListenersOnHandshakeDone");
+  FinishHandshakeMetric(connection_key);
+  // Listeners are notified under lock, as handshakes of different
+  // connections are done in parallel and listener deletes itself
+  // on the notification
+  sync_primitives::AutoLock lock(listeners_lock_);
   std::list<SecurityManagerListener*>::iterator it = listeners_.begin();
   while (it != listeners_.end()) {
     if ((*it)->OnHandshakeDone(connection_key, success)) {
@@ -234,6 +264,55 @@ void SecurityManagerImpl::NotifyListenersOnHandshakeDone(const uint32_t &connect
   }
 }
 
+uint32_t SecurityManagerImpl::HandshakeLatencyPercentile(
+    const uint8_t percentile) const {
+  std::vector<uint32_t> latencies;
+  {
+    sync_primitives::AutoLock lock(handshake_metric_lock_);
+    latencies = handshake_latencies_;
+  }
+  if (latencies.empty()) {
+    return 0u;
+  }
+  const size_t index = std::min<size_t>(percentile, 100u) *
+      (latencies.size() - 1) / 100u;
+  std::nth_element(latencies.begin(), latencies.begin() + index,
+                   latencies.end());
+  return latencies[index];
+}
+
+void SecurityManagerImpl::StartHandshakeMetric(const uint32_t connection_key) {
+  sync_primitives::AutoLock lock(handshake_metric_lock_);
+  // Keep the first step time for handshakes started by mobile side
+  handshake_start_times_.insert(std::make_pair(
+      connection_key, date_time::DateTime::getCurrentTime()));
+}
+
+void SecurityManagerImpl::FinishHandshakeMetric(const uint32_t connection_key) {
+  {
+    sync_primitives::AutoLock lock(handshake_metric_lock_);
+    std::map<uint32_t, TimevalStruct>::iterator it =
+        handshake_start_times_.find(connection_key);
+    if (handshake_start_times_.end() == it) {
+      return;
+    }
+    const uint32_t latency = static_cast<uint32_t>(
+        date_time::DateTime::calculateTimeSpan(it->second));
+    handshake_start_times_.erase(it);
+    if (handshake_latencies_.size() < kHandshakeLatencySamples) {
+      handshake_latencies_.push_back(latency);
+    } else {
+      handshake_latencies_[handshake_latency_index_] = latency;
+    }
+    handshake_latency_index_ =
+        (handshake_latency_index_ + 1) % kHandshakeLatencySamples;
+  }
+  LOG4CXX_DEBUG(logger_, "Handshake latency (ms) p50: "
+                << HandshakeLatencyPercentile(50)
+                << ", p90: " << HandshakeLatencyPercentile(90)
+                << ", p99: " << HandshakeLatencyPercentile(99));
+}
+
 bool SecurityManagerImpl::ProccessHandshakeData(const SecurityMessage &inMessage) {
   LOG4CXX_INFO(logger_, "SendHandshakeData processing");
   DCHECK(inMessage);
@@ -263,6 +342,7 @@ bool SecurityManagerImpl::ProccessHandshakeData(const SecurityMessage &inMessage
     NotifyListenersOnHandshakeDone(connection_key, false);
     return false;
   }
+  StartHandshakeMetric(connection_key);
   size_t out_data_size;
   const uint8_t *out_data;
   const SSLContext::HandshakeResult handshake_result =
@@ -36,6 +36,7 @@
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 #include <memory.h>
+#include <algorithm>
 #include <map>
 
 #include "utils/macro.h"
@@ -46,7 +47,6 @@ CryptoManagerImpl::SSLContextImpl::SSLContextImpl(SSL *conn, Mode mode)
   : connection_(conn),
     bioIn_(BIO_new(BIO_s_mem())),
     bioOut_(BIO_new(BIO_s_mem())),
-    bioFilter_(NULL),
     // TODO(EZamakhov): get MTU by parameter (from transport)
     // default buffer size is TCP MTU
     buffer_size_(1500),
@@ -157,9 +157,6 @@ DoHandshakeStep(const uint8_t*  const in_data,  size_t in_data_size,
   const int handshake_result = SSL_do_handshake(connection_);
   if (handshake_result == 1) {
     // Handshake is successful
-    bioFilter_ = BIO_new(BIO_f_ssl());
-    BIO_set_ssl(bioFilter_, connection_, BIO_NOCLOSE);
-
     const SSL_CIPHER *cipher = SSL_get_current_cipher(connection_);
     max_block_size_ = max_block_sizes[SSL_CIPHER_get_name(cipher)];
     is_handshake_pending_ = false;
@@ -203,18 +200,14 @@ bool CryptoManagerImpl::SSLContextImpl::Encrypt(
     return false;
   }
 
-  BIO_write(bioFilter_, in_data, in_data_size);
-  const size_t len = BIO_ctrl_pending(bioOut_);
-
-  EnsureBufferSizeEnough(len);
-  const int read_size = BIO_read(bioOut_, buffer_, len);
-  DCHECK(len == static_cast<size_t>(read_size));
-  if (read_size <= 0) {
-    // Reset filter and connection deinitilization instead
-    BIO_ctrl(bioFilter_, BIO_CTRL_RESET, 0, NULL);
+  EnsureBufferSizeEnough(get_max_encrypted_size(in_data_size));
+  Frame frame = {in_data, in_data_size, buffer_, buffer_size_, 0,
+                 Frame_Result_NotProcessed};
+  EncryptFrame(&frame);
+  if (Frame_Result_Success != frame.result) {
     return false;
   }
-  *out_data_size = read_size;
+  *out_data_size = frame.out_data_size;
   *out_data = buffer_;
 
   return true;
@@ -232,26 +225,144 @@ bool CryptoManagerImpl::SSLContextImpl::Decrypt(
   if (!in_data || !in_data_size) {
     return false;
   }
-  BIO_write(bioIn_, in_data, in_data_size);
-  int len = BIO_ctrl_pending(bioFilter_);
-  ptrdiff_t offset = 0;
+  overflow_buffers_.clear();
+  EnsureBufferSizeEnough(in_data_size);
+  Frame frame = {in_data, in_data_size, buffer_, buffer_size_, 0,
+                 Frame_Result_NotProcessed};
+  DecryptFrame(&frame);
+  if (Frame_Result_Success != frame.result) {
+    return false;
+  }
+  *out_data_size = frame.out_data_size;
+  *out_data = frame.out_data;
+  return true;
+}
 
-  *out_data_size = 0;
-  while (len) {
-    EnsureBufferSizeEnough(len + offset);
-    len = BIO_read(bioFilter_, buffer_ + offset, len);
-    // TODO(EZamakhov): investigate BIO_read return 0, -1 and -2 meanings
-    if (len <= 0) {
-      // Reset filter and connection deinitilization instead
-      BIO_ctrl(bioFilter_, BIO_CTRL_RESET, 0, NULL);
-      return false;
+size_t CryptoManagerImpl::SSLContextImpl::EncryptBatch(
+    Frame *frames, size_t frames_count) {
+  DCHECK(frames || !frames_count);
+  for (size_t i = 0; i < frames_count; ++i) {
+    frames[i].out_data_size = 0;
+    frames[i].result = Frame_Result_NotProcessed;
+  }
+  sync_primitives::AutoLock locker(bio_locker);
+  if (!SSL_is_init_finished(connection_)) {
+    return 0;
+  }
+  size_t processed = 0;
+  for (size_t i = 0; i < frames_count; ++i) {
+    EncryptFrame(frames + i);
+    if (Frame_Result_Success == frames[i].result) {
+      ++processed;
+    } else if (Frame_Result_Fail == frames[i].result) {
+      break;
     }
-    *out_data_size += len;
-    offset += len;
-    len = BIO_ctrl_pending(bioFilter_);
   }
-  *out_data = buffer_;
-  return true;
+  return processed;
+}
+
+size_t CryptoManagerImpl::SSLContextImpl::DecryptBatch(
+    Frame *frames, size_t frames_count) {
+  DCHECK(frames || !frames_count);
+  for (size_t i = 0; i < frames_count; ++i) {
+    frames[i].out_data_size = 0;
+    frames[i].result = Frame_Result_NotProcessed;
+  }
+  sync_primitives::AutoLock locker(bio_locker);
+  if (!SSL_is_init_finished(connection_)) {
+    return 0;
+  }
+  overflow_buffers_.clear();
+  size_t processed = 0;
+  for (size_t i = 0; i < frames_count; ++i) {
+    DecryptFrame(frames + i);
+    if (Frame_Result_Success == frames[i].result) {
+      ++processed;
+    } else if (Frame_Result_Fail == frames[i].result) {
+      break;
+    }
+  }
+  return processed;
+}
+
+void CryptoManagerImpl::SSLContextImpl::EncryptFrame(Frame *frame) {
+  frame->out_data_size = 0;
+  frame->result = Frame_Result_Rejected;
+  if (!frame->in_data || !frame->in_data_size || !frame->out_data) {
+    return;
+  }
+  // Records are checked to fit the output buffer before SSL_write,
+  // after writing the record sequence number could not be rolled back
+  const size_t pending = BIO_ctrl_pending(bioOut_);
+  if (pending + get_max_encrypted_size(frame->in_data_size) >
+      frame->out_buffer_size) {
+    return;
+  }
+  frame->result = Frame_Result_Fail;
+  // SSL_write puts records straight to the memory BIO without
+  // intermediate copying by BIO_f_ssl filter
+  const int write_size =
+      SSL_write(connection_, frame->in_data, frame->in_data_size);
+  if (write_size != static_cast<int>(frame->in_data_size)) {
+    return;
+  }
+  const int read_size = BIO_read(bioOut_, frame->out_data,
+                                 BIO_ctrl_pending(bioOut_));
+  if (read_size <= 0) {
+    return;
+  }
+  frame->out_data_size = read_size;
+  frame->result = Frame_Result_Success;
+}
+
+void CryptoManagerImpl::SSLContextImpl::DecryptFrame(Frame *frame) {
+  frame->out_data_size = 0;
+  frame->result = Frame_Result_Rejected;
+  if (!frame->in_data || !frame->in_data_size || !frame->out_data) {
+    return;
+  }
+  frame->result = Frame_Result_Fail;
+  const int write_size =
+      BIO_write(bioIn_, frame->in_data, frame->in_data_size);
+  if (write_size != static_cast<int>(frame->in_data_size)) {
+    return;
+  }
+  // Input data is already copied to the memory BIO,
+  // so output buffer could be the same as the input one
+  while (true) {
+    if (frame->out_data_size == frame->out_buffer_size) {
+      // Record is longer than the frame, e.g. it was split between frames
+      GrowDecryptedFrame(frame);
+    }
+    const int read_size = SSL_read(connection_,
+                                   frame->out_data + frame->out_data_size,
+                                   frame->out_buffer_size - frame->out_data_size);
+    if (read_size <= 0) {
+      // All received records are processed, the last one could be
+      // not complete and is left in BIO up to the next frame
+      if (SSL_ERROR_WANT_READ == SSL_get_error(connection_, read_size)) {
+        frame->result = Frame_Result_Success;
+      }
+      return;
+    }
+    frame->out_data_size += read_size;
+  }
+}
+
+void CryptoManagerImpl::SSLContextImpl::GrowDecryptedFrame(Frame *frame) {
+  // Room for the rest of current record and the next one
+  const size_t required_size = frame->out_data_size +
+      SSL_pending(connection_) + SSL3_RT_MAX_PLAIN_LENGTH;
+  const bool is_overflow_buffer = !overflow_buffers_.empty() &&
+      &overflow_buffers_.back()[0] == frame->out_data;
+  if (!is_overflow_buffer) {
+    overflow_buffers_.push_back(std::vector<uint8_t>(
+        frame->out_data, frame->out_data + frame->out_data_size));
+  }
+  std::vector<uint8_t> &overflow = overflow_buffers_.back();
+  overflow.resize(required_size);
+  frame->out_data = &overflow[0];
+  frame->out_buffer_size = overflow.size();
 }
 
 size_t CryptoManagerImpl::SSLContextImpl::get_max_block_size(size_t mtu) const {
@@ -264,6 +375,15 @@ size_t CryptoManagerImpl::SSLContextImpl::get_max_block_size(size_t mtu) const {
   return max_block_size_(mtu);
 }
 
+size_t CryptoManagerImpl::SSLContextImpl::get_max_encrypted_size(
+    size_t data_size) const {
+  // Each TLS record carries up to SSL3_RT_MAX_PLAIN_LENGTH bytes of data,
+  // additional record reserved for CBC 1/n-1 record splitting
+  const size_t records_count = data_size / SSL3_RT_MAX_PLAIN_LENGTH + 2;
+  return data_size + records_count *
+      (SSL3_RT_HEADER_LENGTH + SSL3_RT_MAX_ENCRYPTED_OVERHEAD);
+}
+
 bool CryptoManagerImpl::SSLContextImpl::IsHandshakePending() const {
   return is_handshake_pending_;
 }
@@ -276,10 +396,13 @@ CryptoManagerImpl::SSLContextImpl::~SSLContextImpl() {
 
 void CryptoManagerImpl::SSLContextImpl::EnsureBufferSizeEnough(size_t size) {
   if (buffer_size_ < size) {
-    delete[] buffer_;
-    buffer_ = new(std::nothrow) uint8_t[size];
-    if (buffer_) {
-      buffer_size_ = size;
+    // Grow geometrically to avoid reallocation on each bigger frame
+    const size_t new_size = std::max(size, buffer_size_ * 2);
+    uint8_t *new_buffer = new(std::nothrow) uint8_t[new_size];
+    if (new_buffer) {
+      delete[] buffer_;
+      buffer_ = new_buffer;
+      buffer_size_ = new_size;
     }
   }
 }
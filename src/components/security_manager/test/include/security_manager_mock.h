@@ -210,7 +210,12 @@ class SSLContextMock : public security_manager::SSLContext {
   MOCK_METHOD4(Decrypt,
       bool (const uint8_t* const, size_t,
           const uint8_t** const, size_t*));
+  MOCK_METHOD2(EncryptBatch,
+      size_t (security_manager::SSLContext::Frame*, size_t));
+  MOCK_METHOD2(DecryptBatch,
+      size_t (security_manager::SSLContext::Frame*, size_t));
   MOCK_CONST_METHOD1(get_max_block_size, size_t (size_t));
+  MOCK_CONST_METHOD1(get_max_encrypted_size, size_t (size_t));
   MOCK_CONST_METHOD0(IsInitCompleted, bool());
   MOCK_CONST_METHOD0(IsHandshakePending, bool());
   MOCK_CONST_METHOD0(LastError,
@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "security_manager/crypto_manager.h"
+#include "security_manager/crypto_manager_impl.h"
+#include "security_manager/ssl_context.h"
+#include "utils/date_time.h"
+
+#ifdef __QNXNTO__
+#include <openssl/ssl3.h>
+#define FORD_CIPHER   SSL3_TXT_RSA_DES_192_CBC3_SHA
+#else
+#include <openssl/tls1.h>
+#define FORD_CIPHER   TLS1_TXT_RSA_WITH_AES_256_GCM_SHA384
+#endif
+
+namespace test {
+namespace components {
+namespace security_manager_test {
+
+using security_manager::SSLContext;
+
+namespace {
+// Video frame payload size for default transport MTU
+const size_t kFrameSize = 1400u;
+const size_t kFramesCount = 20000u;
+const size_t kBatchSize = 16u;
+const size_t kHandshakesCount = 50u;
+
+double Throughput(const size_t bytes, const TimevalStruct &start) {
+  const int64_t usecs = date_time::DateTime::calculateTimeSpan(start) *
+      date_time::DateTime::MICROSECONDS_IN_MILLISECONDS;
+  return usecs > 0 ? static_cast<double>(bytes) / usecs : 0.0;
+}
+}  // namespace
+
+class SSLContextPerformanceTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    server_manager_ = new security_manager::CryptoManagerImpl();
+    ASSERT_TRUE(server_manager_->Init(
+        security_manager::SERVER, security_manager::TLSv1_2,
+        "mycert.pem", "mykey.pem", FORD_CIPHER, false));
+    client_manager_ = new security_manager::CryptoManagerImpl();
+    ASSERT_TRUE(client_manager_->Init(
+        security_manager::CLIENT, security_manager::TLSv1_2,
+        "", "", FORD_CIPHER, false));
+    server_ctx_ = server_manager_->CreateSSLContext();
+    client_ctx_ = client_manager_->CreateSSLContext();
+    ASSERT_TRUE(server_ctx_ != NULL);
+    ASSERT_TRUE(client_ctx_ != NULL);
+  }
+
+  virtual void TearDown() {
+    server_manager_->ReleaseSSLContext(server_ctx_);
+    client_manager_->ReleaseSSLContext(client_ctx_);
+    server_manager_->Finish();
+    client_manager_->Finish();
+    delete server_manager_;
+    delete client_manager_;
+  }
+
+  bool Handshake() {
+    const uint8_t *client_buf = NULL;
+    size_t client_buf_len = 0;
+    const uint8_t *server_buf = NULL;
+    size_t server_buf_len = 0;
+    if (SSLContext::Handshake_Result_Success !=
+        client_ctx_->StartHandshake(&client_buf, &client_buf_len)) {
+      return false;
+    }
+    while (!client_ctx_->IsInitCompleted() ||
+           !server_ctx_->IsInitCompleted()) {
+      if (SSLContext::Handshake_Result_Success !=
+          server_ctx_->DoHandshakeStep(client_buf, client_buf_len,
+                                       &server_buf, &server_buf_len)) {
+        return false;
+      }
+      if (SSLContext::Handshake_Result_Success !=
+          client_ctx_->DoHandshakeStep(server_buf, server_buf_len,
+                                       &client_buf, &client_buf_len)) {
+        return false;
+      }
+      if (!client_buf_len && !server_buf_len) {
+        break;
+      }
+    }
+    return client_ctx_->IsInitCompleted() && server_ctx_->IsInitCompleted();
+  }
+
+  security_manager::CryptoManager *server_manager_;
+  security_manager::CryptoManager *client_manager_;
+  SSLContext *server_ctx_;
+  SSLContext *client_ctx_;
+};
+
+TEST_F(SSLContextPerformanceTest, Handshake_ContextsRecreated_Succeeds) {
+  // The first handshake is full, the next ones resume cached session
+  ASSERT_TRUE(Handshake());
+  for (size_t i = 0; i < 2u; ++i) {
+    server_manager_->ReleaseSSLContext(server_ctx_);
+    client_manager_->ReleaseSSLContext(client_ctx_);
+    server_ctx_ = server_manager_->CreateSSLContext();
+    client_ctx_ = client_manager_->CreateSSLContext();
+    ASSERT_TRUE(server_ctx_ != NULL);
+    ASSERT_TRUE(client_ctx_ != NULL);
+    EXPECT_TRUE(Handshake());
+  }
+}
+
+TEST_F(SSLContextPerformanceTest, DISABLED_Benchmark_ResumedHandshakeTime) {
+  // The first handshake is full, the next ones resume cached session
+  ASSERT_TRUE(Handshake());
+  TimevalStruct start = date_time::DateTime::getCurrentTime();
+  for (size_t i = 0; i < kHandshakesCount; ++i) {
+    server_manager_->ReleaseSSLContext(server_ctx_);
+    client_manager_->ReleaseSSLContext(client_ctx_);
+    server_ctx_ = server_manager_->CreateSSLContext();
+    client_ctx_ = client_manager_->CreateSSLContext();
+    ASSERT_TRUE(Handshake());
+  }
+  const int64_t resumed_time = date_time::DateTime::calculateTimeSpan(start);
+  printf("%u resumed handshakes: %ld ms\n",
+         static_cast<unsigned>(kHandshakesCount),
+         static_cast<long>(resumed_time));
+}
+
+TEST_F(SSLContextPerformanceTest, EncryptBatchDecryptBatch_SameFrames) {
+  ASSERT_TRUE(Handshake());
+
+  const size_t frames_count = 3u;
+  std::vector<uint8_t> video_frame(kFrameSize);
+  for (size_t i = 0; i < kFrameSize; ++i) {
+    video_frame[i] = static_cast<uint8_t>(i);
+  }
+  const size_t buffer_size = server_ctx_->get_max_encrypted_size(kFrameSize);
+  std::vector<uint8_t> pool(buffer_size * frames_count);
+  SSLContext::Frame frames[frames_count];
+  for (size_t i = 0; i < frames_count; ++i) {
+    SSLContext::Frame frame = {&video_frame[0], kFrameSize,
+                               &pool[i * buffer_size], buffer_size, 0,
+                               SSLContext::Frame_Result_NotProcessed};
+    frames[i] = frame;
+  }
+  ASSERT_EQ(frames_count, server_ctx_->EncryptBatch(frames, frames_count));
+  for (size_t i = 0; i < frames_count; ++i) {
+    EXPECT_EQ(SSLContext::Frame_Result_Success, frames[i].result);
+    EXPECT_LT(kFrameSize, frames[i].out_data_size);
+    frames[i].in_data = frames[i].out_data;
+    frames[i].in_data_size = frames[i].out_data_size;
+    frames[i].out_buffer_size = frames[i].out_data_size;
+  }
+
+  ASSERT_EQ(frames_count, client_ctx_->DecryptBatch(frames, frames_count));
+  for (size_t i = 0; i < frames_count; ++i) {
+    EXPECT_EQ(SSLContext::Frame_Result_Success, frames[i].result);
+    ASSERT_EQ(kFrameSize, frames[i].out_data_size);
+    EXPECT_EQ(0, memcmp(frames[i].out_data, &video_frame[0], kFrameSize));
+  }
+}
+
+TEST_F(SSLContextPerformanceTest, DISABLED_Benchmark_ProtectedVideoThroughput) {
+  ASSERT_TRUE(Handshake());
+
+  std::vector<uint8_t> video_frame(kFrameSize);
+  for (size_t i = 0; i < kFrameSize; ++i) {
+    video_frame[i] = static_cast<uint8_t>(i);
+  }
+  // Pooled buffers reused for each batch
+  const size_t buffer_size = server_ctx_->get_max_encrypted_size(kFrameSize);
+  std::vector<uint8_t> pool(buffer_size * kBatchSize);
+  std::vector<SSLContext::Frame> frames(kBatchSize);
+
+  // Plain video: only payload copying to the frame buffers
+  TimevalStruct start = date_time::DateTime::getCurrentTime();
+  for (size_t sent = 0; sent < kFramesCount; sent += kBatchSize) {
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      memcpy(&pool[i * buffer_size], &video_frame[0], kFrameSize);
+    }
+  }
+  const double plain_throughput =
+      Throughput(kFramesCount * kFrameSize, start);
+
+  // Protected video: batched encryption and in place decryption
+  start = date_time::DateTime::getCurrentTime();
+  for (size_t sent = 0; sent < kFramesCount; sent += kBatchSize) {
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      SSLContext::Frame &frame = frames[i];
+      frame.in_data = &video_frame[0];
+      frame.in_data_size = kFrameSize;
+      frame.out_data = &pool[i * buffer_size];
+      frame.out_buffer_size = buffer_size;
+      frame.out_data_size = 0;
+      frame.result = SSLContext::Frame_Result_NotProcessed;
+    }
+    ASSERT_EQ(kBatchSize, server_ctx_->EncryptBatch(&frames[0], kBatchSize));
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      SSLContext::Frame &frame = frames[i];
+      frame.in_data = frame.out_data;
+      frame.in_data_size = frame.out_data_size;
+      frame.out_buffer_size = frame.out_data_size;
+    }
+    ASSERT_EQ(kBatchSize, client_ctx_->DecryptBatch(&frames[0], kBatchSize));
+  }
+  const double protected_throughput =
+      Throughput(kFramesCount * kFrameSize, start);
+
+  for (size_t i = 0; i < kBatchSize; ++i) {
+    ASSERT_EQ(kFrameSize, frames[i].out_data_size);
+    EXPECT_EQ(0, memcmp(frames[i].out_data, &video_frame[0], kFrameSize));
+  }
+  printf("Video frames %u x %u bytes, batch %u: "
+         "plain %.2f MB/s, protected %.2f MB/s\n",
+         static_cast<unsigned>(kFramesCount), static_cast<unsigned>(kFrameSize),
+         static_cast<unsigned>(kBatchSize),
+         plain_throughput, protected_throughput);
+}
+
+TEST_F(SSLContextPerformanceTest, DecryptBatch_RecordSplitBetweenFrames) {
+  ASSERT_TRUE(Handshake());
+
+  std::vector<uint8_t> message(4000u);
+  for (size_t i = 0; i < message.size(); ++i) {
+    message[i] = static_cast<uint8_t>(i);
+  }
+  const uint8_t *encrypted = NULL;
+  size_t encrypted_size = 0;
+  ASSERT_TRUE(server_ctx_->Encrypt(&message[0], message.size(),
+                                   &encrypted, &encrypted_size));
+  // The last frame carries much less ciphertext than the record plain data
+  const size_t last_frame_size = 16u;
+  ASSERT_GT(encrypted_size, last_frame_size);
+  std::vector<uint8_t> first(encrypted, encrypted + encrypted_size -
+                             last_frame_size);
+  std::vector<uint8_t> last(encrypted + first.size(),
+                            encrypted + encrypted_size);
+
+  SSLContext::Frame frames[2] = {
+    {&first[0], first.size(), &first[0], first.size(), 0,
+     SSLContext::Frame_Result_NotProcessed},
+    {&last[0], last.size(), &last[0], last.size(), 0,
+     SSLContext::Frame_Result_NotProcessed}
+  };
+  ASSERT_EQ(2u, client_ctx_->DecryptBatch(frames, 2u));
+
+  EXPECT_EQ(SSLContext::Frame_Result_Success, frames[0].result);
+  EXPECT_EQ(0u, frames[0].out_data_size);
+  EXPECT_EQ(SSLContext::Frame_Result_Success, frames[1].result);
+  ASSERT_EQ(message.size(), frames[1].out_data_size);
+  EXPECT_NE(&last[0], frames[1].out_data);
+  EXPECT_EQ(0, memcmp(frames[1].out_data, &message[0], message.size()));
+}
+
+TEST_F(SSLContextPerformanceTest, DecryptBatch_InPlace) {
+  ASSERT_TRUE(Handshake());
+
+  const size_t frames_count = 3u;
+  const std::string messages[frames_count] = {"first", "second", "third"};
+  std::vector<uint8_t> buffers[frames_count];
+  SSLContext::Frame frames[frames_count];
+  for (size_t i = 0; i < frames_count; ++i) {
+    const uint8_t *encrypted = NULL;
+    size_t encrypted_size = 0;
+    ASSERT_TRUE(server_ctx_->Encrypt(
+        reinterpret_cast<const uint8_t*>(messages[i].data()),
+        messages[i].size(), &encrypted, &encrypted_size));
+    buffers[i].assign(encrypted, encrypted + encrypted_size);
+    SSLContext::Frame frame = {&buffers[i][0], buffers[i].size(),
+                               &buffers[i][0], buffers[i].size(), 0,
+                               SSLContext::Frame_Result_NotProcessed};
+    frames[i] = frame;
+  }
+  ASSERT_EQ(frames_count, client_ctx_->DecryptBatch(frames, frames_count));
+
+  for (size_t i = 0; i < frames_count; ++i) {
+    EXPECT_EQ(SSLContext::Frame_Result_Success, frames[i].result);
+    EXPECT_EQ(&buffers[i][0], frames[i].out_data);
+    EXPECT_EQ(messages[i],
+              std::string(reinterpret_cast<const char*>(frames[i].out_data),
+                          frames[i].out_data_size));
+  }
+}
+
+TEST_F(SSLContextPerformanceTest, EncryptBatch_SmallBufferRejectsOnlyFrame) {
+  ASSERT_TRUE(Handshake());
+
+  const size_t frames_count = 3u;
+  const std::string message("protected message");
+  const uint8_t *data = reinterpret_cast<const uint8_t*>(message.data());
+  const size_t buffer_size =
+      server_ctx_->get_max_encrypted_size(message.size());
+  std::vector<uint8_t> buffers[frames_count];
+  SSLContext::Frame frames[frames_count];
+  for (size_t i = 0; i < frames_count; ++i) {
+    buffers[i].resize(buffer_size);
+    SSLContext::Frame frame = {data, message.size(),
+                               &buffers[i][0], buffer_size, 0,
+                               SSLContext::Frame_Result_NotProcessed};
+    frames[i] = frame;
+  }
+  // Records of the second frame do not fit its buffer
+  frames[1].out_buffer_size = message.size();
+  EXPECT_EQ(2u, server_ctx_->EncryptBatch(frames, frames_count));
+  EXPECT_EQ(SSLContext::Frame_Result_Success, frames[0].result);
+  EXPECT_EQ(SSLContext::Frame_Result_Rejected, frames[1].result);
+  EXPECT_EQ(0u, frames[1].out_data_size);
+  EXPECT_EQ(SSLContext::Frame_Result_Success, frames[2].result);
+
+  // Session is not broken by the rejected frame
+  for (size_t i = 0; i < frames_count; i += 2) {
+    const uint8_t *decrypted = NULL;
+    size_t decrypted_size = 0;
+    ASSERT_TRUE(client_ctx_->Decrypt(frames[i].out_data,
+                                     frames[i].out_data_size,
+                                     &decrypted, &decrypted_size));
+    EXPECT_EQ(message,
+              std::string(reinterpret_cast<const char*>(decrypted),
+                          decrypted_size));
+  }
+}
+
+TEST_F(SSLContextPerformanceTest, DecryptBatch_StopsOnCorruptedFrame) {
+  ASSERT_TRUE(Handshake());
+
+  const size_t frames_count = 3u;
+  const std::string message("protected message");
+  std::vector<uint8_t> buffers[frames_count];
+  SSLContext::Frame frames[frames_count];
+  for (size_t i = 0; i < frames_count; ++i) {
+    const uint8_t *encrypted = NULL;
+    size_t encrypted_size = 0;
+    ASSERT_TRUE(server_ctx_->Encrypt(
+        reinterpret_cast<const uint8_t*>(message.data()), message.size(),
+        &encrypted, &encrypted_size));
+    buffers[i].assign(encrypted, encrypted + encrypted_size);
+    SSLContext::Frame frame = {&buffers[i][0], buffers[i].size(),
+                               &buffers[i][0], buffers[i].size(), 0,
+                               SSLContext::Frame_Result_NotProcessed};
+    frames[i] = frame;
+  }
+  // Break authentication tag of the second record
+  buffers[1].back() ^= 0xFF;
+  EXPECT_EQ(1u, client_ctx_->DecryptBatch(frames, frames_count));
+  EXPECT_EQ(SSLContext::Frame_Result_Success, frames[0].result);
+  EXPECT_EQ(message.size(), frames[0].out_data_size);
+  EXPECT_EQ(SSLContext::Frame_Result_Fail, frames[1].result);
+  EXPECT_EQ(SSLContext::Frame_Result_NotProcessed, frames[2].result);
+  EXPECT_EQ(0u, frames[2].out_data_size);
+}
+
+}  // namespace security_manager_test
+}  // namespace components
+}  // namespace test
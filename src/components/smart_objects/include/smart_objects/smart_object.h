@@ -469,9 +469,9 @@ class SmartObject FINAL {
   /**
    * @brief Returns current object converted to binary
    *
-   * @return SmartBinary
+   * @return SmartBinary, reference stays valid until object is changed
    **/
-  SmartBinary asBinary() const;
+  const SmartBinary& asBinary() const;
 
   /**
    * @brief Returns current object converted to array
@@ -640,7 +640,7 @@ class SmartObject FINAL {
    *
    * @return CSmartSchema
    **/
-  CSmartSchema getSchema();
+  CSmartSchema getSchema() const;
 
   /**
    * @brief Returns current object type
@@ -819,7 +819,7 @@ class SmartObject FINAL {
    *
    * @return int32_t Converted value or invalid_binary_value if conversion not possible
    **/
-  inline SmartBinary convert_binary() const;
+  inline const SmartBinary& convert_binary() const;
 
   /**
    * @brief Returns SmartObject from internal array data by it's index
@@ -536,7 +536,7 @@ SmartObject::SmartObject(const SmartBinary& InitialValue)
   set_value_binary(InitialValue);
 }
 
-SmartBinary SmartObject::asBinary() const {
+const SmartBinary& SmartObject::asBinary() const {
   return convert_binary();
 }
 
@@ -555,7 +555,7 @@ SmartObject& SmartObject::operator=(const SmartBinary& NewValue) {
 }
 
 bool SmartObject::operator==(const SmartBinary& Value) const {
-  const SmartBinary comp = convert_binary();
+  const SmartBinary& comp = convert_binary();
   if (comp == invalid_binary_value) {
     return false;
   }
@@ -569,7 +569,7 @@ void SmartObject::set_value_binary(const SmartBinary& NewValue) {
   m_data.binary_value = new SmartBinary(NewValue);
 }
 
-SmartBinary SmartObject::convert_binary() const {
+const SmartBinary& SmartObject::convert_binary() const {
   switch (m_type) {
     case SmartType_Binary:
       return *(m_data.binary_value);
@@ -872,7 +872,7 @@ void SmartObject::setSchema(const CSmartSchema& schema) {
   m_schema = schema;
 }
 
-CSmartSchema SmartObject::getSchema() {
+CSmartSchema SmartObject::getSchema() const {
   return m_schema;
 }
 
@@ -47,6 +47,7 @@ class ApplicationManagerMetricWrapper: public MetricWrapper {
 
   public:
     utils::SharedPtr<application_manager::AMMetricObserver::MessageMetric> message_metric;
+    virtual bool FillRecord(MetricRecord* record);
 
   protected:
     virtual Json::Value GetJsonMetric();
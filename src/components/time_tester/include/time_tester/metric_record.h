@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_TIME_TESTER_INCLUDE_TIME_TESTER_METRIC_RECORD_H_
+#define SRC_COMPONENTS_TIME_TESTER_INCLUDE_TIME_TESTER_METRIC_RECORD_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace time_tester {
+
+/**
+ * \brief Stream header magic ("SDLT") and format version.
+ * Header is sent once per client connection before any record.
+ */
+const uint8_t kMetricStreamMagic[] = {'S', 'D', 'L', 'T'};
+const uint8_t kMetricStreamVersion = 1;
+
+/**
+ * \brief Fixed layout metric record.
+ * Producers fill it without any allocation, streamer encodes records
+ * by the schema below:
+ *  - type             : 1 byte
+ *  - begin            : zigzag varint, delta to previous record begin (usec)
+ *  - kApplicationManager : duration, correlation_id, zigzag connection_key
+ *  - kTransportManager   : duration, data_size
+ *  - kProtocolHandler    : duration, message_id, zigzag connection_key
+ *  - kResources          : zigzag utime, stime, memory, dropped
+ * All unsigned fields are LEB128 varints.
+ */
+struct MetricRecord {
+  enum Type {
+    kUnknown = 0,
+    kApplicationManager = 1,
+    kTransportManager = 2,
+    kProtocolHandler = 3,
+    kResources = 4
+  };
+  uint8_t type;
+  /**
+   * \brief Usecs since epoch, sample time for kResources
+   */
+  int64_t begin;
+  int64_t end;
+  /**
+   * \brief Correlation id for kApplicationManager, message id
+   * for kProtocolHandler
+   */
+  uint32_t id;
+  int32_t connection_key;
+  uint32_t data_size;
+  int64_t utime;
+  int64_t stime;
+  int64_t memory;
+  /**
+   * \brief Records dropped on full rings since previous kResources record
+   */
+  uint32_t dropped;
+};
+
+/**
+ * \brief Sets all fields of record to zero
+ */
+void ClearMetricRecord(MetricRecord* record);
+
+/**
+ * \brief Encodes records into a byte buffer
+ */
+class MetricRecordWriter {
+ public:
+  MetricRecordWriter();
+  /**
+   * \brief Starts new stream: clears buffer, writes header and
+   * resets timestamp base
+   */
+  void WriteHeader();
+  void Write(const MetricRecord& record);
+  const std::vector<uint8_t>& data() const;
+  /**
+   * \brief Drops encoded data, timestamp base is kept
+   */
+  void Clear();
+
+ private:
+  void WriteVarint(uint64_t value);
+  void WriteSignedVarint(int64_t value);
+  std::vector<uint8_t> buffer_;
+  int64_t last_begin_;
+};
+
+/**
+ * \brief Decodes records produced by MetricRecordWriter
+ */
+class MetricRecordReader {
+ public:
+  MetricRecordReader(const uint8_t* data, size_t size);
+  /**
+   * \brief Reads and checks stream header
+   * \return false on wrong magic or unsupported version
+   */
+  bool ReadHeader();
+  /**
+   * \brief Reads next record
+   * \return false on end of data or malformed record, see is_failed()
+   */
+  bool Read(MetricRecord* record);
+  bool is_failed() const;
+
+ private:
+  bool ReadVarint(uint64_t* value);
+  bool ReadSignedVarint(int64_t* value);
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_;
+  int64_t last_begin_;
+  bool failed_;
+};
+
+}  // namespace time_tester
+#endif  // SRC_COMPONENTS_TIME_TESTER_INCLUDE_TIME_TESTER_METRIC_RECORD_H_
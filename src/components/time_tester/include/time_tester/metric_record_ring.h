@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_TIME_TESTER_INCLUDE_TIME_TESTER_METRIC_RECORD_RING_H_
+#define SRC_COMPONENTS_TIME_TESTER_INCLUDE_TIME_TESTER_METRIC_RECORD_RING_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "utils/macro.h"
+#include "metric_record.h"
+
+namespace time_tester {
+
+/**
+ * \brief Lock-free single producer/single consumer ring of metric records.
+ * Each producing thread owns its ring, so Push never blocks: records are
+ * dropped and counted when the streamer does not keep up.
+ */
+class MetricRecordRing {
+ public:
+  /**
+   * \param capacity ring size, rounded up to power of two
+   */
+  explicit MetricRecordRing(uint32_t capacity);
+  /**
+   * \brief Adds record, called from owner thread only
+   * \return false if ring is full and record was dropped
+   */
+  bool Push(const MetricRecord& record);
+  /**
+   * \brief Takes oldest record, called from consumer thread only
+   * \return false if ring is empty
+   */
+  bool Pop(MetricRecord* record);
+  /**
+   * \brief Returns count of records dropped since previous call,
+   * called from consumer thread only
+   */
+  uint32_t TakeDropped();
+
+ private:
+  std::vector<MetricRecord> records_;
+  const uint32_t mask_;
+  // Written by consumer only
+  volatile uint32_t head_;
+  // Written by producer only
+  volatile uint32_t tail_;
+  // Written by producer only
+  volatile uint32_t dropped_;
+  uint32_t reported_dropped_;
+  DISALLOW_COPY_AND_ASSIGN(MetricRecordRing);
+};
+
+}  // namespace time_tester
+#endif  // SRC_COMPONENTS_TIME_TESTER_INCLUDE_TIME_TESTER_METRIC_RECORD_RING_H_
@@ -36,6 +36,7 @@
 #include <string>
 #include "utils/resource_usage.h"
 #include "json/json.h"
+#include "metric_record.h"
 
 namespace time_tester {
 
@@ -48,6 +49,11 @@ class MetricWrapper {
      */
     bool grabResources();
     virtual std::string GetStyledString();
+    /*
+     * @brief fill compact binary record of metric
+     * @return false if metric has no binary representation
+     */
+    virtual bool FillRecord(MetricRecord* record);
     virtual ~MetricWrapper();
   protected:
     virtual Json::Value GetJsonMetric();
@@ -44,6 +44,7 @@ class ProtocolHandlerMecticWrapper: public MetricWrapper {
 
   public:
     utils::SharedPtr<protocol_handler::PHMetricObserver::MessageMetric> message_metric;
+    virtual bool FillRecord(MetricRecord* record);
   protected:
     virtual Json::Value GetJsonMetric();
 };
@@ -33,14 +33,19 @@
 #ifndef SRC_COMPONENTS_TIME_MANAGER_INCLUDE_TIME_MANAGER_MEDIA_MANAGER_H_
 #define SRC_COMPONENTS_TIME_MANAGER_INCLUDE_TIME_MANAGER_MEDIA_MANAGER_H_
 
+#include <pthread.h>
 #include <string>
+#include <vector>
 
 #include "utils/shared_ptr.h"
-#include "utils/message_queue.h"
+#include "utils/lock.h"
+#include "utils/conditional_variable.h"
 #include "utils/threads/thread.h"
 #include "utils/singleton.h"
 #include "utils/threads/thread_delegate.h"
 #include "metric_wrapper.h"
+#include "metric_record.h"
+#include "metric_record_ring.h"
 #include "application_manager_observer.h"
 #include "application_manager/application_manager_impl.h"
 #include "transport_manager_observer.h"
@@ -50,16 +55,40 @@
 
 namespace time_tester {
 
-using ::utils::MessageQueue;
-
 class TimeManager {
  public:
   TimeManager();
   ~TimeManager();
   void Init(protocol_handler::ProtocolHandlerImpl* ph);
   void Stop();
+  /*
+   * @brief Stores binary record of metric in ring of calling thread,
+   * never blocks. Record is dropped if no client connected or ring is full
+   */
   void SendMetric(utils::SharedPtr<MetricWrapper> metric);
  private:
+  /*
+   * @brief Ring owned by producer thread till it exits
+   */
+  struct ThreadRing {
+    ThreadRing(TimeManager* owner, uint32_t capacity);
+    TimeManager* const owner;
+    MetricRecordRing records;
+  };
+  /*
+   * @brief Returns ring of calling thread, takes free ring or creates one
+   * on first use
+   */
+  MetricRecordRing* GetThreadRing();
+  /*
+   * @brief Thread specific data destructor, returns ring of exiting thread
+   * to free rings. Its pending records are still drained by streamer
+   */
+  static void ReleaseThreadRing(void* value);
+  /*
+   * @brief Moves all pending records and resources sample to writer
+   */
+  void DrainRecords(MetricRecordWriter* writer);
 
   class Streamer : public threads::ThreadDelegate {
    public:
@@ -70,16 +99,20 @@ class TimeManager {
     bool IsReady() const;
     void Start();
     void Stop();
-    bool Send(const std::string &msg);
-    void PushMessage(utils::SharedPtr<MetricWrapper> metric);
+    bool Send(const std::vector<uint8_t>& data);
     volatile bool is_client_connected_;
     private:
     void ShutDownAndCloseSocket(int32_t socket_fd);
+    /*
+     * @brief Waits batch period or stop
+     */
+    void WaitBatch();
     TimeManager* const server_;
     int32_t server_socket_fd_;
     int32_t client_socket_fd_;
     volatile bool stop_flag_;
-    MessageQueue<utils::SharedPtr<MetricWrapper> > messages_;
+    sync_primitives::Lock stop_lock_;
+    sync_primitives::ConditionalVariable stop_cv_;
     DISALLOW_COPY_AND_ASSIGN(Streamer);
   };
 
@@ -91,6 +124,11 @@ class TimeManager {
   ApplicationManagerObserver app_observer;
   TransportManagerObserver tm_observer;
   ProtocolHandlerObserver ph_observer;
+  pthread_key_t thread_ring_key_;
+  // All rings, both owned by threads and free ones
+  std::vector<ThreadRing*> rings_;
+  std::vector<ThreadRing*> free_rings_;
+  sync_primitives::Lock rings_lock_;
 
   DISALLOW_COPY_AND_ASSIGN(TimeManager);
 };
@@ -42,6 +42,7 @@ namespace time_tester {
 class TransportManagerMecticWrapper: public MetricWrapper {
  public:
   utils::SharedPtr<transport_manager::TMMetricObserver::MessageMetric> message_metric;
+  virtual bool FillRecord(MetricRecord* record);
   protected:
     virtual Json::Value GetJsonMetric();
 };
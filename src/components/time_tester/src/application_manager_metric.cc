@@ -51,4 +51,18 @@ Json::Value ApplicationManagerMetricWrapper::GetJsonMetric() {
       params[application_manager::strings::connection_key].asInt();
   return result;
 }
+
+bool ApplicationManagerMetricWrapper::FillRecord(MetricRecord* record) {
+  ClearMetricRecord(record);
+  record->type = MetricRecord::kApplicationManager;
+  record->begin = date_time::DateTime::getuSecs(message_metric->begin);
+  record->end = date_time::DateTime::getuSecs(message_metric->end);
+  const NsSmartDeviceLink::NsSmartObjects::SmartObject& params =
+      message_metric->message->getElement(application_manager::strings::params);
+  record->id =
+      params[application_manager::strings::correlation_id].asUInt();
+  record->connection_key =
+      params[application_manager::strings::connection_key].asInt();
+  return true;
+}
 }  // namespace time_tester
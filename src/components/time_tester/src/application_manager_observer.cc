@@ -43,7 +43,6 @@ ApplicationManagerObserver::ApplicationManagerObserver(TimeManager* time_manager
 void ApplicationManagerObserver::OnMessage(utils::SharedPtr<MessageMetric> metric) {
   ApplicationManagerMetricWrapper* m = new ApplicationManagerMetricWrapper();
   m->message_metric = metric;
-  m->grabResources();
   time_manager_->SendMetric(m);
 }
 }  // namespace time_tester
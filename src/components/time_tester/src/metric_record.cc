@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "metric_record.h"
+
+#include <string.h>
+
+namespace time_tester {
+
+namespace {
+const size_t kMaxVarintSize = 10;
+
+uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+      static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+}  // namespace
+
+void ClearMetricRecord(MetricRecord* record) {
+  memset(record, 0, sizeof(*record));
+}
+
+MetricRecordWriter::MetricRecordWriter()
+  : last_begin_(0) {
+}
+
+void MetricRecordWriter::WriteHeader() {
+  buffer_.clear();
+  buffer_.insert(buffer_.end(), kMetricStreamMagic,
+                 kMetricStreamMagic + sizeof(kMetricStreamMagic));
+  buffer_.push_back(kMetricStreamVersion);
+  last_begin_ = 0;
+}
+
+void MetricRecordWriter::Write(const MetricRecord& record) {
+  buffer_.push_back(record.type);
+  WriteSignedVarint(record.begin - last_begin_);
+  last_begin_ = record.begin;
+  const uint64_t duration = record.end > record.begin ?
+      static_cast<uint64_t>(record.end - record.begin) : 0u;
+  switch (record.type) {
+    case MetricRecord::kApplicationManager:
+    case MetricRecord::kProtocolHandler:
+      WriteVarint(duration);
+      WriteVarint(record.id);
+      WriteSignedVarint(record.connection_key);
+      break;
+    case MetricRecord::kTransportManager:
+      WriteVarint(duration);
+      WriteVarint(record.data_size);
+      break;
+    case MetricRecord::kResources:
+      WriteSignedVarint(record.utime);
+      WriteSignedVarint(record.stime);
+      WriteSignedVarint(record.memory);
+      WriteVarint(record.dropped);
+      break;
+    default:
+      break;
+  }
+}
+
+const std::vector<uint8_t>& MetricRecordWriter::data() const {
+  return buffer_;
+}
+
+void MetricRecordWriter::Clear() {
+  buffer_.clear();
+}
+
+void MetricRecordWriter::WriteVarint(uint64_t value) {
+  while (value >= 0x80u) {
+    buffer_.push_back(static_cast<uint8_t>(value | 0x80u));
+    value >>= 7;
+  }
+  buffer_.push_back(static_cast<uint8_t>(value));
+}
+
+void MetricRecordWriter::WriteSignedVarint(int64_t value) {
+  WriteVarint(ZigZagEncode(value));
+}
+
+MetricRecordReader::MetricRecordReader(const uint8_t* data, size_t size)
+  : data_(data),
+    size_(size),
+    offset_(0),
+    last_begin_(0),
+    failed_(false) {
+}
+
+bool MetricRecordReader::ReadHeader() {
+  const size_t header_size = sizeof(kMetricStreamMagic) + 1;
+  if (size_ - offset_ < header_size ||
+      0 != memcmp(data_ + offset_, kMetricStreamMagic,
+                  sizeof(kMetricStreamMagic)) ||
+      kMetricStreamVersion != data_[offset_ + sizeof(kMetricStreamMagic)]) {
+    failed_ = true;
+    return false;
+  }
+  offset_ += header_size;
+  last_begin_ = 0;
+  return true;
+}
+
+bool MetricRecordReader::Read(MetricRecord* record) {
+  if (failed_ || offset_ >= size_) {
+    return false;
+  }
+  ClearMetricRecord(record);
+  record->type = data_[offset_++];
+  int64_t begin_delta = 0;
+  if (!ReadSignedVarint(&begin_delta)) {
+    return false;
+  }
+  record->begin = last_begin_ + begin_delta;
+  last_begin_ = record->begin;
+  record->end = record->begin;
+
+  uint64_t duration = 0;
+  uint64_t value = 0;
+  int64_t signed_value = 0;
+  switch (record->type) {
+    case MetricRecord::kApplicationManager:
+    case MetricRecord::kProtocolHandler:
+      if (!ReadVarint(&duration) || !ReadVarint(&value) ||
+          !ReadSignedVarint(&signed_value)) {
+        return false;
+      }
+      record->end = record->begin + static_cast<int64_t>(duration);
+      record->id = static_cast<uint32_t>(value);
+      record->connection_key = static_cast<int32_t>(signed_value);
+      return true;
+    case MetricRecord::kTransportManager:
+      if (!ReadVarint(&duration) || !ReadVarint(&value)) {
+        return false;
+      }
+      record->end = record->begin + static_cast<int64_t>(duration);
+      record->data_size = static_cast<uint32_t>(value);
+      return true;
+    case MetricRecord::kResources:
+      if (!ReadSignedVarint(&record->utime) ||
+          !ReadSignedVarint(&record->stime) ||
+          !ReadSignedVarint(&record->memory) ||
+          !ReadVarint(&value)) {
+        return false;
+      }
+      record->dropped = static_cast<uint32_t>(value);
+      return true;
+    default:
+      failed_ = true;
+      return false;
+  }
+}
+
+bool MetricRecordReader::is_failed() const {
+  return failed_;
+}
+
+bool MetricRecordReader::ReadVarint(uint64_t* value) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < kMaxVarintSize; ++i) {
+    if (offset_ >= size_) {
+      break;
+    }
+    const uint8_t byte = data_[offset_++];
+    result |= static_cast<uint64_t>(byte & 0x7Fu) << (7 * i);
+    if (0 == (byte & 0x80u)) {
+      *value = result;
+      return true;
+    }
+  }
+  failed_ = true;
+  return false;
+}
+
+bool MetricRecordReader::ReadSignedVarint(int64_t* value) {
+  uint64_t encoded = 0;
+  if (!ReadVarint(&encoded)) {
+    return false;
+  }
+  *value = ZigZagDecode(encoded);
+  return true;
+}
+
+}  // namespace time_tester
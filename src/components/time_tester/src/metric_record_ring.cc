@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "metric_record_ring.h"
+
+#include "utils/memory_barrier.h"
+
+namespace time_tester {
+
+namespace {
+uint32_t RoundUpToPowerOfTwo(uint32_t value) {
+  uint32_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+}  // namespace
+
+MetricRecordRing::MetricRecordRing(uint32_t capacity)
+  : records_(RoundUpToPowerOfTwo(capacity)),
+    mask_(RoundUpToPowerOfTwo(capacity) - 1),
+    head_(0),
+    tail_(0),
+    dropped_(0),
+    reported_dropped_(0) {
+}
+
+bool MetricRecordRing::Push(const MetricRecord& record) {
+  const uint32_t tail = tail_;
+  if (tail - head_ > mask_) {
+    dropped_ = dropped_ + 1;
+    return false;
+  }
+  records_[tail & mask_] = record;
+  // Record must be visible before consumer sees new tail
+  utils::memory_barrier();
+  tail_ = tail + 1;
+  return true;
+}
+
+bool MetricRecordRing::Pop(MetricRecord* record) {
+  const uint32_t head = head_;
+  if (head == tail_) {
+    return false;
+  }
+  utils::memory_barrier();
+  *record = records_[head & mask_];
+  // Slot must be read before producer may reuse it
+  utils::memory_barrier();
+  head_ = head + 1;
+  return true;
+}
+
+uint32_t MetricRecordRing::TakeDropped() {
+  const uint32_t dropped = dropped_;
+  const uint32_t result = dropped - reported_dropped_;
+  reported_dropped_ = dropped;
+  return result;
+}
+
+}  // namespace time_tester
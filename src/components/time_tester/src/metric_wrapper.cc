@@ -22,6 +22,10 @@ std::string MetricWrapper::GetStyledString() {
   return GetJsonMetric().toStyledString();
 }
 
+bool MetricWrapper::FillRecord(MetricRecord* record) {
+  return false;
+}
+
 Json::Value MetricWrapper::GetJsonMetric() {
   Json::Value result;
   if (resources) {
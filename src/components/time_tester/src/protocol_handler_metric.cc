@@ -48,4 +48,14 @@ Json::Value ProtocolHandlerMecticWrapper::GetJsonMetric() {
   return result;
 }
 
+bool ProtocolHandlerMecticWrapper::FillRecord(MetricRecord* record) {
+  ClearMetricRecord(record);
+  record->type = MetricRecord::kProtocolHandler;
+  record->begin = date_time::DateTime::getuSecs(message_metric->begin);
+  record->end = date_time::DateTime::getuSecs(message_metric->end);
+  record->id = message_metric->message_id;
+  record->connection_key = message_metric->connection_key;
+  return true;
+}
+
 }  // namespace time_tester
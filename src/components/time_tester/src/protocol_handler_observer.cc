@@ -66,7 +66,6 @@ void ProtocolHandlerObserver::EndMessageProcess(utils::SharedPtr<MessageMetric>
   m->end = date_time::DateTime::getCurrentTime();
   ProtocolHandlerMecticWrapper* metric = new ProtocolHandlerMecticWrapper();
   metric->message_metric = m;
-  metric->grabResources();
   time_manager_->SendMetric(metric);
 }
 }  //namespace time_tester
@@ -44,17 +44,30 @@
 #include "transport_manager/transport_manager_default.h"
 #include "config_profile/profile.h"
 #include "utils/resource_usage.h"
+#include "utils/date_time.h"
 
 namespace time_tester {
 
 CREATE_LOGGERPTR_GLOBAL(logger_, "TimeManager")
 
+namespace {
+// Per producer thread, enough for a batch period under heavy load
+const uint32_t kRingCapacity = 4096u;
+const int32_t kBatchPeriodMs = 100;
+}  // namespace
+
+TimeManager::ThreadRing::ThreadRing(TimeManager* owner, uint32_t capacity)
+  : owner(owner),
+    records(capacity) {
+}
+
 TimeManager::TimeManager():
   thread_(NULL),
   streamer_(NULL),
   app_observer(this),
   tm_observer(this),
   ph_observer(this) {
+    pthread_key_create(&thread_ring_key_, &TimeManager::ReleaseThreadRing);
     ip_ = profile::Profile::instance()->server_address();
     port_ = profile::Profile::instance()->time_testing_port();
     streamer_ = new Streamer(this);
@@ -63,6 +76,15 @@ TimeManager::TimeManager():
 
 TimeManager::~TimeManager() {
   Stop();
+  // Rings of threads still running are not released to this manager anymore
+  pthread_key_delete(thread_ring_key_);
+  sync_primitives::AutoLock lock(rings_lock_);
+  for (std::vector<ThreadRing*>::iterator it = rings_.begin();
+       rings_.end() != it; ++it) {
+    delete *it;
+  }
+  rings_.clear();
+  free_rings_.clear();
 }
 
 void TimeManager::Init(protocol_handler::ProtocolHandlerImpl* ph) {
@@ -86,9 +108,73 @@ void TimeManager::Stop() {
 }
 
 void TimeManager::SendMetric(utils::SharedPtr<MetricWrapper> metric) {
-  if ((NULL != streamer_ )&& streamer_->is_client_connected_) {
-    streamer_->PushMessage(metric);
+  if ((NULL == streamer_) || !streamer_->is_client_connected_) {
+    return;
+  }
+  MetricRecord record;
+  if (metric->FillRecord(&record)) {
+    GetThreadRing()->Push(record);
+  }
+}
+
+MetricRecordRing* TimeManager::GetThreadRing() {
+  ThreadRing* ring =
+      static_cast<ThreadRing*>(pthread_getspecific(thread_ring_key_));
+  if (!ring) {
+    // Threads come and go with connections, rings are reused
+    // so memory stays bounded by count of simultaneous producers
+    sync_primitives::AutoLock lock(rings_lock_);
+    if (free_rings_.empty()) {
+      ring = new ThreadRing(this, kRingCapacity);
+      rings_.push_back(ring);
+    } else {
+      ring = free_rings_.back();
+      free_rings_.pop_back();
+    }
+    pthread_setspecific(thread_ring_key_, ring);
+  }
+  return &ring->records;
+}
+
+void TimeManager::ReleaseThreadRing(void* value) {
+  ThreadRing* ring = static_cast<ThreadRing*>(value);
+  sync_primitives::AutoLock lock(ring->owner->rings_lock_);
+  ring->owner->free_rings_.push_back(ring);
+}
+
+void TimeManager::DrainRecords(MetricRecordWriter* writer) {
+  MetricRecord record;
+  uint32_t dropped = 0;
+  {
+    sync_primitives::AutoLock lock(rings_lock_);
+    for (std::vector<ThreadRing*>::iterator it = rings_.begin();
+         rings_.end() != it; ++it) {
+      MetricRecordRing& records = (*it)->records;
+      while (records.Pop(&record)) {
+        writer->Write(record);
+      }
+      dropped += records.TakeDropped();
+    }
+  }
+  if (dropped) {
+    LOG4CXX_WARN(logger_, "Dropped metric records: " << dropped);
+  }
+
+  // Single resources sample per batch instead of reading /proc per metric
+  ClearMetricRecord(&record);
+  record.type = MetricRecord::kResources;
+  record.begin =
+      date_time::DateTime::getuSecs(date_time::DateTime::getCurrentTime());
+  record.dropped = dropped;
+  utils::ResourseUsage* resources =
+      utils::Resources::getCurrentResourseUsage();
+  if (NULL != resources) {
+    record.utime = resources->utime;
+    record.stime = resources->stime;
+    record.memory = resources->memory;
+    delete resources;
   }
+  writer->Write(record);
 }
 
 TimeManager::Streamer::Streamer(
@@ -118,27 +204,30 @@ void TimeManager::Streamer::threadMain() {
     }
     LOG4CXX_INFO(logger_, "Client connected");
 
-    is_client_connected_ = true;
-    while (is_client_connected_) {
-      while (!messages_.empty()) {
-        utils::SharedPtr<MetricWrapper> metric = messages_.pop();
-        is_client_connected_ = Send(metric->GetStyledString());
-      }
-
-      if (!IsReady()) {
-        LOG4CXX_INFO(logger_, "Client disconnected.");
-        break;
-      }
-
-      messages_.wait();
+    MetricRecordWriter writer;
+    writer.WriteHeader();
+    is_client_connected_ = Send(writer.data());
+    while (is_client_connected_ && !stop_flag_) {
+      WaitBatch();
+      writer.Clear();
+      server_->DrainRecords(&writer);
+      is_client_connected_ = Send(writer.data());
     }
+    LOG4CXX_INFO(logger_, "Client disconnected.");
+    is_client_connected_ = false;
+  }
+}
+
+void TimeManager::Streamer::WaitBatch() {
+  sync_primitives::AutoLock lock(stop_lock_);
+  if (!stop_flag_) {
+    stop_cv_.WaitFor(lock, kBatchPeriodMs);
   }
 }
 
 void TimeManager::Streamer::exitThreadMain() {
   LOG4CXX_AUTO_TRACE(logger_);
   Stop();
-  messages_.Shutdown();
 }
 
 void TimeManager::Streamer::Start() {
@@ -198,8 +287,11 @@ void TimeManager::Streamer::Stop() {
     LOG4CXX_WARN(logger_, "Already Stopped");
     return;
   }
-  stop_flag_ = true;
-  messages_.Reset();
+  {
+    sync_primitives::AutoLock lock(stop_lock_);
+    stop_flag_ = true;
+    stop_cv_.NotifyOne();
+  }
   LOG4CXX_WARN(logger_, "Stop server_socket_fd_");
   ShutDownAndCloseSocket(server_socket_fd_);
   server_socket_fd_ = -1;
@@ -232,22 +324,18 @@ bool TimeManager::Streamer::IsReady() const {
   return result;
 }
 
-bool TimeManager::Streamer::Send(const std::string& msg) {
+bool TimeManager::Streamer::Send(const std::vector<uint8_t>& data) {
   LOG4CXX_AUTO_TRACE(logger_);
   if (!IsReady()) {
     LOG4CXX_ERROR_EXT(logger_, " Socket is not ready");
     return false;
   }
 
-  if (-1 == ::send(client_socket_fd_, msg.c_str(),
-                   msg.size(), MSG_NOSIGNAL)) {
+  if (-1 == ::send(client_socket_fd_, &data[0],
+                   data.size(), MSG_NOSIGNAL)) {
     LOG4CXX_ERROR_EXT(logger_, " Unable to send");
     return false;
   }
   return true;
 }
-
-void TimeManager::Streamer::PushMessage(utils::SharedPtr<MetricWrapper> metric) {
-  messages_.push(metric);
-}
 }  // namespace time_tester
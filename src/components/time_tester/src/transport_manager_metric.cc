@@ -48,4 +48,13 @@ Json::Value TransportManagerMecticWrapper::GetJsonMetric() {
   return result;
 }
 
+bool TransportManagerMecticWrapper::FillRecord(MetricRecord* record) {
+  ClearMetricRecord(record);
+  record->type = MetricRecord::kTransportManager;
+  record->begin = date_time::DateTime::getuSecs(message_metric->begin);
+  record->end = date_time::DateTime::getuSecs(message_metric->end);
+  record->data_size = static_cast<uint32_t>(message_metric->data_size);
+  return true;
+}
+
 }  // namespace time_tester
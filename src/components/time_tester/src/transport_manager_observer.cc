@@ -55,7 +55,6 @@ void TransportManagerObserver::StopRawMsg(const protocol_handler::RawMessage* pt
       m->message_metric->begin = it->second;
       m->message_metric->end = date_time::DateTime::getCurrentTime();
       m->message_metric->data_size = ptr->data_size();
-      m->grabResources();
       time_manager_->SendMetric(m);
     }
 }
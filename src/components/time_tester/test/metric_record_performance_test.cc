@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+
+#include "gtest/gtest.h"
+#include "metric_record.h"
+#include "metric_record_ring.h"
+#include "protocol_handler_metric.h"
+#include "utils/date_time.h"
+
+namespace test {
+namespace components {
+namespace time_tester_test {
+
+using namespace ::time_tester;
+
+namespace {
+const uint32_t kMetricsCount = 20000u;
+const uint32_t kBatchSize = 1024u;
+
+utils::SharedPtr<ProtocolHandlerMecticWrapper> MakeMetric(uint32_t id) {
+  utils::SharedPtr<ProtocolHandlerMecticWrapper> metric =
+      new ProtocolHandlerMecticWrapper();
+  metric->message_metric =
+      new protocol_handler::PHMetricObserver::MessageMetric();
+  metric->message_metric->message_id = id;
+  metric->message_metric->connection_key = 1;
+  metric->message_metric->begin = date_time::DateTime::getCurrentTime();
+  metric->message_metric->end = metric->message_metric->begin;
+  return metric;
+}
+}  // namespace
+
+TEST(MetricRecordPerformanceTest, DISABLED_Benchmark_OverheadPerMetric) {
+  std::vector<utils::SharedPtr<ProtocolHandlerMecticWrapper> > metrics;
+  for (uint32_t i = 0; i < kMetricsCount; ++i) {
+    metrics.push_back(MakeMetric(i + 1));
+  }
+
+  // Previous stream: /proc sample and styled JSON per metric
+  size_t json_bytes = 0;
+  TimevalStruct start = date_time::DateTime::getCurrentTime();
+  for (uint32_t i = 0; i < kMetricsCount; ++i) {
+    metrics[i]->grabResources();
+    json_bytes += metrics[i]->GetStyledString().size();
+  }
+  const int64_t json_usecs = date_time::DateTime::getuSecs(
+      date_time::DateTime::getCurrentTime()) -
+      date_time::DateTime::getuSecs(start);
+
+  // Binary stream: record to thread ring, encoded by batches
+  MetricRecordRing ring(kBatchSize);
+  MetricRecordWriter writer;
+  writer.WriteHeader();
+  size_t binary_bytes = writer.data().size();
+  MetricRecord record;
+  start = date_time::DateTime::getCurrentTime();
+  for (uint32_t i = 0; i < kMetricsCount; ++i) {
+    metrics[i]->FillRecord(&record);
+    ring.Push(record);
+    if (0 == (i + 1) % kBatchSize || kMetricsCount == i + 1) {
+      writer.Clear();
+      while (ring.Pop(&record)) {
+        writer.Write(record);
+      }
+      binary_bytes += writer.data().size();
+    }
+  }
+  const int64_t binary_usecs = date_time::DateTime::getuSecs(
+      date_time::DateTime::getCurrentTime()) -
+      date_time::DateTime::getuSecs(start);
+  EXPECT_EQ(0u, ring.TakeDropped());
+
+  printf("%u metrics: JSON %.3f us/metric, %.1f bytes/metric; "
+         "binary %.3f us/metric, %.1f bytes/metric\n",
+         kMetricsCount,
+         static_cast<double>(json_usecs) / kMetricsCount,
+         static_cast<double>(json_bytes) / kMetricsCount,
+         static_cast<double>(binary_usecs) / kMetricsCount,
+         static_cast<double>(binary_bytes) / kMetricsCount);
+  EXPECT_LT(binary_bytes, json_bytes);
+}
+
+}  // namespace time_tester_test
+}  // namespace components
+}  // namespace test
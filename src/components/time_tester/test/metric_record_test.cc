@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "gtest/gtest.h"
+#include "metric_record.h"
+#include "metric_record_ring.h"
+
+namespace test {
+namespace components {
+namespace time_tester_test {
+
+using namespace ::time_tester;
+
+namespace {
+MetricRecord MakeRecord(MetricRecord::Type type, int64_t begin) {
+  MetricRecord record;
+  ClearMetricRecord(&record);
+  record.type = type;
+  record.begin = begin;
+  record.end = begin + 1500;
+  return record;
+}
+}  // namespace
+
+TEST(MetricRecordTest, WriteRead_AllTypes_SameRecords) {
+  std::vector<MetricRecord> records;
+  MetricRecord record =
+      MakeRecord(MetricRecord::kApplicationManager, 1431000000000000ll);
+  record.id = 300000;
+  record.connection_key = 65537;
+  records.push_back(record);
+  // Records of several threads are not ordered by begin
+  record = MakeRecord(MetricRecord::kTransportManager, 1430999999999000ll);
+  record.data_size = 1400;
+  records.push_back(record);
+  record = MakeRecord(MetricRecord::kProtocolHandler, 1431000000000100ll);
+  record.id = 7;
+  record.connection_key = -1;
+  records.push_back(record);
+  record = MakeRecord(MetricRecord::kResources, 1431000000000200ll);
+  record.end = record.begin;
+  record.utime = 123;
+  record.stime = 45;
+  record.memory = 1 << 20;
+  record.dropped = 3;
+  records.push_back(record);
+
+  MetricRecordWriter writer;
+  writer.WriteHeader();
+  for (size_t i = 0; i < records.size(); ++i) {
+    writer.Write(records[i]);
+  }
+
+  const std::vector<uint8_t>& data = writer.data();
+  MetricRecordReader reader(&data[0], data.size());
+  ASSERT_TRUE(reader.ReadHeader());
+  for (size_t i = 0; i < records.size(); ++i) {
+    MetricRecord result;
+    ASSERT_TRUE(reader.Read(&result));
+    EXPECT_EQ(records[i].type, result.type);
+    EXPECT_EQ(records[i].begin, result.begin);
+    EXPECT_EQ(records[i].end, result.end);
+    EXPECT_EQ(records[i].id, result.id);
+    EXPECT_EQ(records[i].connection_key, result.connection_key);
+    EXPECT_EQ(records[i].data_size, result.data_size);
+    EXPECT_EQ(records[i].utime, result.utime);
+    EXPECT_EQ(records[i].stime, result.stime);
+    EXPECT_EQ(records[i].memory, result.memory);
+    EXPECT_EQ(records[i].dropped, result.dropped);
+  }
+  MetricRecord result;
+  EXPECT_FALSE(reader.Read(&result));
+  EXPECT_FALSE(reader.is_failed());
+}
+
+TEST(MetricRecordTest, Write_SequentialMetrics_CompactEncoding) {
+  MetricRecordWriter writer;
+  writer.WriteHeader();
+  const size_t header_size = writer.data().size();
+  writer.Write(MakeRecord(MetricRecord::kProtocolHandler, 1431000000000000ll));
+  const size_t first_size = writer.data().size() - header_size;
+  writer.Write(MakeRecord(MetricRecord::kProtocolHandler, 1431000000000500ll));
+  const size_t second_size = writer.data().size() - header_size - first_size;
+  // Only delta to previous begin is written for second record
+  EXPECT_LT(second_size, first_size);
+  EXPECT_GE(8u, second_size);
+}
+
+TEST(MetricRecordTest, ReadHeader_WrongMagic_Fail) {
+  const uint8_t data[] = {'J', 'S', 'O', 'N', kMetricStreamVersion};
+  MetricRecordReader reader(data, sizeof(data));
+  EXPECT_FALSE(reader.ReadHeader());
+  EXPECT_TRUE(reader.is_failed());
+}
+
+TEST(MetricRecordTest, Read_TruncatedRecord_Fail) {
+  MetricRecordWriter writer;
+  writer.WriteHeader();
+  writer.Write(MakeRecord(MetricRecord::kTransportManager, 1431000000000000ll));
+  const std::vector<uint8_t>& data = writer.data();
+  MetricRecordReader reader(&data[0], data.size() - 1);
+  ASSERT_TRUE(reader.ReadHeader());
+  MetricRecord result;
+  EXPECT_FALSE(reader.Read(&result));
+  EXPECT_TRUE(reader.is_failed());
+}
+
+TEST(MetricRecordRingTest, PushPop_Fifo) {
+  MetricRecordRing ring(4);
+  for (int64_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(ring.Push(MakeRecord(MetricRecord::kProtocolHandler, i)));
+  }
+  MetricRecord record;
+  for (int64_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(ring.Pop(&record));
+    EXPECT_EQ(i, record.begin);
+  }
+  EXPECT_FALSE(ring.Pop(&record));
+}
+
+TEST(MetricRecordRingTest, Push_Full_DroppedAndCounted) {
+  MetricRecordRing ring(3);  // rounded up to 4
+  for (int64_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(ring.Push(MakeRecord(MetricRecord::kProtocolHandler, i)));
+  }
+  EXPECT_FALSE(ring.Push(MakeRecord(MetricRecord::kProtocolHandler, 4)));
+  EXPECT_FALSE(ring.Push(MakeRecord(MetricRecord::kProtocolHandler, 5)));
+  EXPECT_EQ(2u, ring.TakeDropped());
+  EXPECT_EQ(0u, ring.TakeDropped());
+
+  MetricRecord record;
+  ASSERT_TRUE(ring.Pop(&record));
+  EXPECT_EQ(0, record.begin);
+  EXPECT_TRUE(ring.Push(MakeRecord(MetricRecord::kProtocolHandler, 6)));
+}
+
+}  // namespace time_tester_test
+}  // namespace components
+}  // namespace test
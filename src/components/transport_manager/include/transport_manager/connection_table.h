@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_TRANSPORT_MANAGER_INCLUDE_TRANSPORT_MANAGER_CONNECTION_TABLE_H_
+#define SRC_COMPONENTS_TRANSPORT_MANAGER_INCLUDE_TRANSPORT_MANAGER_CONNECTION_TABLE_H_
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "transport_manager/common.h"
+#include "utils/macro.h"
+#include "utils/rwlock.h"
+#include "utils/shared_ptr.h"
+
+namespace transport_manager {
+
+/**
+ * @brief Key of connection within transport adapter
+ */
+typedef std::pair<DeviceUID, ApplicationHandle> DeviceApplicationKey;
+
+/**
+ * @brief Connections indexed by ConnectionUID and by device and application.
+ * Connections are held by shared pointers, so connection found by reader
+ * stays valid after it is erased from table. Lookups may run concurrently,
+ * changes are exclusive.
+ *
+ * ConnectionType must provide id, device and application fields.
+ */
+template <typename ConnectionType>
+class ConnectionTable {
+ public:
+  typedef utils::SharedPtr<ConnectionType> ConnectionPtr;
+
+  ConnectionTable() {}
+
+  /**
+   * @brief Adds connection, existing connection with same id is kept
+   * @return true if connection was added
+   */
+  bool Insert(const ConnectionPtr& connection) {
+    sync_primitives::AutoWriteLock lock(lock_);
+    if (!by_id_.insert(std::make_pair(connection->id, connection)).second) {
+      return false;
+    }
+    by_device_application_[DeviceApplicationKey(
+        connection->device, connection->application)] = connection;
+    return true;
+  }
+
+  /**
+   * @brief Removes connection
+   * @return removed connection or invalid pointer if it was not found
+   */
+  ConnectionPtr Erase(ConnectionUID id) {
+    sync_primitives::AutoWriteLock lock(lock_);
+    typename IdIndex::iterator it = by_id_.find(id);
+    if (by_id_.end() == it) {
+      return ConnectionPtr();
+    }
+    const ConnectionPtr connection = it->second;
+    by_id_.erase(it);
+    typename DeviceApplicationIndex::iterator key_it =
+        by_device_application_.find(DeviceApplicationKey(
+            connection->device, connection->application));
+    // Newer connection of same device and application may own the key
+    if (by_device_application_.end() != key_it &&
+        key_it->second.get() == connection.get()) {
+      by_device_application_.erase(key_it);
+    }
+    return connection;
+  }
+
+  ConnectionPtr Find(ConnectionUID id) const {
+    sync_primitives::AutoReadLock lock(lock_);
+    typename IdIndex::const_iterator it = by_id_.find(id);
+    return by_id_.end() == it ? ConnectionPtr() : it->second;
+  }
+
+  ConnectionPtr Find(const DeviceUID& device,
+                     const ApplicationHandle& application) const {
+    sync_primitives::AutoReadLock lock(lock_);
+    typename DeviceApplicationIndex::const_iterator it =
+        by_device_application_.find(DeviceApplicationKey(device, application));
+    return by_device_application_.end() == it ? ConnectionPtr() : it->second;
+  }
+
+  size_t size() const {
+    sync_primitives::AutoReadLock lock(lock_);
+    return by_id_.size();
+  }
+
+ private:
+  typedef std::map<ConnectionUID, ConnectionPtr> IdIndex;
+  typedef std::map<DeviceApplicationKey, ConnectionPtr> DeviceApplicationIndex;
+
+  mutable sync_primitives::RWLock lock_;
+  IdIndex by_id_;
+  DeviceApplicationIndex by_device_application_;
+  DISALLOW_COPY_AND_ASSIGN(ConnectionTable);
+};
+
+}  // namespace transport_manager
+
+#endif  // SRC_COMPONENTS_TRANSPORT_MANAGER_INCLUDE_TRANSPORT_MANAGER_CONNECTION_TABLE_H_
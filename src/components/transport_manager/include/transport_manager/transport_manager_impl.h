@@ -39,8 +39,10 @@
 #include <algorithm>
 
 #include "utils/timer_thread.h"
+#include "utils/lock.h"
 
 #include "transport_manager/transport_manager.h"
+#include "transport_manager/connection_table.h"
 #include "transport_manager/transport_manager_listener.h"
 #include "transport_manager/transport_adapter/transport_adapter_listener_impl.h"
 #include "protocol/common.h"
@@ -86,6 +88,8 @@ class TransportManagerImpl : public TransportManager,
                        const DeviceHandle& device_handle);
     void DisconnectFailedRoutine();
   };
+  typedef ConnectionTable<ConnectionInternal>::ConnectionPtr
+      ConnectionInternalPtr;
  public:
 
   /**
@@ -165,6 +169,21 @@ class TransportManagerImpl : public TransportManager,
    **/
   virtual int ReceiveEventFromDevice(const TransportAdapterEvent& event);
 
+  /**
+   * @brief Deliver data received by transport adapter.
+   *
+   * Data of established connection is passed to listeners right on the
+   * calling (adapter receive) thread, unless earlier data of the same
+   * connection still waits in the event queue. In that case, as well as for
+   * not yet established connection, data is posted to the event queue to keep
+   * the order of frames.
+   *
+   * @param event ON_RECEIVED_DONE event.
+   *
+   * @return Code error.
+   **/
+  virtual int ReceiveDataFromDevice(const TransportAdapterEvent& event);
+
   /**
    * @brief Post listener to the container of transport manager listeners.
    *
@@ -310,9 +329,32 @@ class TransportManagerImpl : public TransportManager,
    */
   Handle2GUIDConverter converter_;
 
+  /**
+   * @brief Receive path of data from device to listeners.
+   */
+  struct ReceiveRoute {
+    ReceiveRoute()
+      : connection_id(0),
+        established(false),
+        queued_data_count(0) {
+    }
+    ConnectionUID connection_id;
+    /** Connection was announced to listeners, data may be passed directly */
+    bool established;
+    /** Number of data events of connection pending in event queue */
+    size_t queued_data_count;
+  };
+  typedef std::map<DeviceApplicationKey, ReceiveRoute> ReceiveRouteMap;
+
   explicit TransportManagerImpl(const TransportManagerImpl&);
   int connection_id_counter_;
-  std::vector<ConnectionInternal> connections_;
+  /**
+   * @brief Routes of received data, accessed from adapters threads
+   * and from event queue thread.
+   */
+  ReceiveRouteMap receive_routes_;
+  sync_primitives::Lock receive_routes_lock_;
+  ConnectionTable<ConnectionInternal> connections_;
   std::map<DeviceUID, TransportAdapter*> device_to_adapter_map_;
   std::vector<TransportAdapter*> transport_adapters_;
   /** For keep listeners which were add TMImpl */
@@ -325,11 +367,27 @@ class TransportManagerImpl : public TransportManager,
   DeviceInfoList;
   DeviceInfoList device_list_;
 
-  void AddConnection(const ConnectionInternal& c);
+  void AddConnection(const ConnectionInternalPtr& c);
+  /**
+   * @brief Allows direct delivery of received data of connection.
+   */
+  void OpenReceiveRoute(const DeviceUID& device,
+                        const ApplicationHandle& application,
+                        ConnectionUID id);
+  /**
+   * @brief Makes received data of connection go through the event queue.
+   */
+  void CloseReceiveRoute(const DeviceUID& device,
+                         const ApplicationHandle& application);
+  /**
+   * @brief Accounts data event of connection taken from event queue.
+   */
+  void OnQueuedDataHandled(const DeviceUID& device,
+                           const ApplicationHandle& application);
   void RemoveConnection(uint32_t id);
-  ConnectionInternal* GetConnection(const ConnectionUID& id);
-  ConnectionInternal* GetConnection(const DeviceUID& device,
-                                    const ApplicationHandle& application);
+  ConnectionInternalPtr GetConnection(const ConnectionUID& id);
+  ConnectionInternalPtr GetConnection(const DeviceUID& device,
+                                      const ApplicationHandle& application);
 
   void AddDataToContainer(
       ConnectionUID id,
@@ -34,6 +34,7 @@
 #define SRC_COMPONENTS_TRANSPORT_MANAGER_INCLUDE_TRANSPORT_MANAGER_USB_LIBUSB_USB_CONNECTION_H_
 
 #include <list>
+#include <vector>
 
 #include "utils/lock.h"
 
@@ -46,10 +47,19 @@ namespace transport_adapter {
 
 class UsbConnection : public Connection {
  public:
+  /**
+   * @param in_transfers_count number of IN transfers kept submitted
+   * @param in_transfer_size size of buffer of each IN transfer, rounded up
+   * to whole packets
+   * @param out_transfer_size limit of bytes of queued messages coalesced
+   * into one OUT transfer
+   */
   UsbConnection(const DeviceUID& device_uid,
                 const ApplicationHandle& app_handle,
                 TransportAdapterController* controller,
-                const UsbHandlerSptr usb_handler, PlatformUsbDevice* device);
+                const UsbHandlerSptr usb_handler, PlatformUsbDevice* device,
+                size_t in_transfers_count, size_t in_transfer_size,
+                size_t out_transfer_size);
   bool Init();
   virtual ~UsbConnection();
 
@@ -58,9 +68,23 @@ class UsbConnection : public Connection {
   virtual TransportAdapter::Error Disconnect();
 
  private:
-  void PopOutMessage();
-  bool PostInTransfer();
+  /**
+   * @brief IN transfer and the message its buffer belongs to,
+   * message is passed further when transfer completes
+   */
+  struct InTransfer {
+    explicit InTransfer(libusb_transfer* transfer)
+      : transfer(transfer) {
+    }
+    libusb_transfer* transfer;
+    protocol_handler::RawMessagePtr buffer;
+  };
+
+  bool PostInTransfer(InTransfer* in_transfer);
+  InTransfer* FindInTransfer(const libusb_transfer* transfer);
+  bool StartOutTransfer();
   bool PostOutTransfer();
+  void FailSendingMessages();
   void OnInTransfer(struct libusb_transfer*);
   void OnOutTransfer(struct libusb_transfer*);
   void Finalise();
@@ -77,16 +101,24 @@ class UsbConnection : public Connection {
   uint16_t in_endpoint_max_packet_size_;
   uint8_t out_endpoint_;
   uint16_t out_endpoint_max_packet_size_;
-  unsigned char* in_buffer_;
-  libusb_transfer* in_transfer_;
+  const size_t in_transfers_count_;
+  size_t in_transfer_size_;
+  const size_t out_transfer_size_;
+  std::vector<InTransfer> in_transfers_;
+  volatile uint32_t in_transfers_in_flight_;
   libusb_transfer* out_transfer_;
 
   std::list<protocol_handler::RawMessagePtr> out_messages_;
-  protocol_handler::RawMessagePtr current_out_message_;
+  // Messages sent by current OUT transfer
+  std::vector<protocol_handler::RawMessagePtr> sending_messages_;
+  // Coalesced data of several messages
+  std::vector<uint8_t> out_buffer_;
+  uint8_t* out_data_;
+  size_t out_data_size_;
   sync_primitives::Lock out_messages_mutex_;
   size_t bytes_sent_;
+  bool out_transfer_in_flight_;
   bool disconnecting_;
-  bool waiting_in_transfer_cancel_;
   bool waiting_out_transfer_cancel_;
   friend void InTransferCallback(struct libusb_transfer*);
   friend void OutTransferCallback(struct libusb_transfer*);
@@ -182,7 +182,7 @@ void TransportAdapterListenerImpl::OnDataReceiveDone(
     transport_adapter_, device, app_id, data_container,
     BaseErrorPtr(new BaseError()));
   if (transport_manager::E_SUCCESS
-      != transport_manager_impl_->ReceiveEventFromDevice(event)) {
+      != transport_manager_impl_->ReceiveDataFromDevice(event)) {
     LOG4CXX_WARN(logger_, "Failed to receive event from device");
   }
   LOG4CXX_TRACE(logger_, "exit");
@@ -155,8 +155,8 @@ int TransportManagerImpl::Disconnect(const ConnectionUID& cid) {
     return E_TM_IS_NOT_INITIALIZED;
   }
 
-  ConnectionInternal* connection = GetConnection(cid);
-  if (NULL == connection) {
+  const ConnectionInternalPtr connection = GetConnection(cid);
+  if (!connection.valid()) {
     LOG4CXX_ERROR(logger_, "TransportManagerImpl::Disconnect: Connection does not exist.");
     LOG4CXX_TRACE(logger_, "exit with E_INVALID_HANDLE. Condition: NULL == connection");
     return E_INVALID_HANDLE;
@@ -201,8 +201,8 @@ int TransportManagerImpl::DisconnectForce(const ConnectionUID& cid) {
                   "exit with E_TM_IS_NOT_INITIALIZED. Condition: false == this->is_initialized_");
     return E_TM_IS_NOT_INITIALIZED;
   }
-  const ConnectionInternal* connection = GetConnection(cid);
-  if (NULL == connection) {
+  const ConnectionInternalPtr connection = GetConnection(cid);
+  if (!connection.valid()) {
     LOG4CXX_ERROR(
       logger_,
       "TransportManagerImpl::DisconnectForce: Connection does not exist.");
@@ -257,6 +257,10 @@ int TransportManagerImpl::Stop() {
     return E_TM_IS_NOT_INITIALIZED;
   }
 
+  {
+    sync_primitives::AutoLock lock(receive_routes_lock_);
+    receive_routes_.clear();
+  }
   message_queue_.Shutdown();
   event_queue_.Shutdown();
 
@@ -278,9 +282,9 @@ int TransportManagerImpl::SendMessageToDevice(const ::protocol_handler::RawMessa
     return E_TM_IS_NOT_INITIALIZED;
   }
 
-  const ConnectionInternal* connection =
+  const ConnectionInternalPtr connection =
     GetConnection(message->connection_key());
-  if (NULL == connection) {
+  if (!connection.valid()) {
     LOG4CXX_ERROR(logger_, "Connection with id " << message->connection_key()
                   << " does not exist.");
     LOG4CXX_TRACE(logger_, "exit with E_INVALID_HANDLE. Condition: NULL == connection");
@@ -316,6 +320,46 @@ int TransportManagerImpl::ReceiveEventFromDevice(const TransportAdapterEvent& ev
   return E_SUCCESS;
 }
 
+int TransportManagerImpl::ReceiveDataFromDevice(
+    const TransportAdapterEvent& event) {
+  LOG4CXX_TRACE(logger_, "enter. TransportAdapterEvent: " << &event);
+  if (!is_initialized_) {
+    LOG4CXX_ERROR(logger_, "TM is not initialized.");
+    LOG4CXX_TRACE(logger_,
+                  "exit with E_TM_IS_NOT_INITIALIZED. Condition: false == this->is_initialized_");
+    return E_TM_IS_NOT_INITIALIZED;
+  }
+  ConnectionUID connection_id = 0;
+  bool deliver_directly = false;
+  {
+    sync_primitives::AutoLock lock(receive_routes_lock_);
+    ReceiveRoute& route = receive_routes_[
+        std::make_pair(event.device_uid, event.application_id)];
+    deliver_directly = route.established && 0 == route.queued_data_count;
+    if (deliver_directly) {
+      connection_id = route.connection_id;
+    } else {
+      ++route.queued_data_count;
+    }
+  }
+  if (!deliver_directly) {
+    this->PostEvent(event);
+    LOG4CXX_TRACE(logger_, "exit with E_SUCCESS. Data is queued");
+    return E_SUCCESS;
+  }
+  // Each connection is received by single adapter thread, so nothing can
+  // overtake this data once it is passed to listeners here
+  event.event_data->set_connection_key(connection_id);
+#ifdef TIME_TESTER
+  if (metric_observer_) {
+    metric_observer_->StopRawMsg(event.event_data.get());
+  }
+#endif  // TIME_TESTER
+  RaiseEvent(&TransportManagerListener::OnTMMessageReceived, event.event_data);
+  LOG4CXX_TRACE(logger_, "exit with E_SUCCESS");
+  return E_SUCCESS;
+}
+
 int TransportManagerImpl::RemoveDevice(const DeviceHandle& device_handle) {
   LOG4CXX_TRACE(logger_, "enter. DeviceHandle: " << &device_handle);
   DeviceUID device_id = converter_.HandleToUid(device_handle);
@@ -516,51 +560,73 @@ void TransportManagerImpl::PostEvent(const TransportAdapterEvent& event) {
   event_queue_.PostMessage(event);
 }
 
-void TransportManagerImpl::AddConnection(const ConnectionInternal& c) {
-  LOG4CXX_TRACE(logger_, "enter ConnectionInternal: " << &c);
-  connections_.push_back(c);
+void TransportManagerImpl::AddConnection(const ConnectionInternalPtr& c) {
+  LOG4CXX_TRACE(logger_, "enter ConnectionInternal: " << c.get());
+  connections_.Insert(c);
   LOG4CXX_TRACE(logger_, "exit");
 }
 
 void TransportManagerImpl::RemoveConnection(uint32_t id) {
   LOG4CXX_TRACE(logger_, "enter Id: " << id);
-  for (std::vector<ConnectionInternal>::iterator it = connections_.begin();
-       it != connections_.end(); ++it) {
-    if (it->id == id) {
-      connections_.erase(it);
-      break;
-    }
-  }
+  connections_.Erase(id);
   LOG4CXX_TRACE(logger_, "exit");
 }
 
-TransportManagerImpl::ConnectionInternal* TransportManagerImpl::GetConnection(
+void TransportManagerImpl::OpenReceiveRoute(
+    const DeviceUID& device, const ApplicationHandle& application,
+    ConnectionUID id) {
+  sync_primitives::AutoLock lock(receive_routes_lock_);
+  ReceiveRoute& route = receive_routes_[std::make_pair(device, application)];
+  route.connection_id = id;
+  route.established = true;
+}
+
+void TransportManagerImpl::CloseReceiveRoute(
+    const DeviceUID& device, const ApplicationHandle& application) {
+  sync_primitives::AutoLock lock(receive_routes_lock_);
+  ReceiveRouteMap::iterator it =
+      receive_routes_.find(std::make_pair(device, application));
+  if (receive_routes_.end() == it) {
+    return;
+  }
+  if (0 == it->second.queued_data_count) {
+    receive_routes_.erase(it);
+  } else {
+    it->second.established = false;
+  }
+}
+
+void TransportManagerImpl::OnQueuedDataHandled(
+    const DeviceUID& device, const ApplicationHandle& application) {
+  sync_primitives::AutoLock lock(receive_routes_lock_);
+  ReceiveRouteMap::iterator it =
+      receive_routes_.find(std::make_pair(device, application));
+  if (receive_routes_.end() == it || 0 == it->second.queued_data_count) {
+    return;
+  }
+  if (0 == --it->second.queued_data_count && !it->second.established) {
+    receive_routes_.erase(it);
+  }
+}
+
+TransportManagerImpl::ConnectionInternalPtr TransportManagerImpl::GetConnection(
   const ConnectionUID& id) {
   LOG4CXX_TRACE(logger_, "enter. ConnectionUID: " << &id);
-  for (std::vector<ConnectionInternal>::iterator it = connections_.begin();
-       it != connections_.end(); ++it) {
-    if (it->id == id) {
-      LOG4CXX_TRACE(logger_, "exit with ConnectionInternal. It's address: " << &*it);
-      return &*it;
-    }
-  }
-  LOG4CXX_TRACE(logger_, "exit with NULL");
-  return NULL;
+  const ConnectionInternalPtr connection = connections_.Find(id);
+  LOG4CXX_TRACE(logger_, "exit with ConnectionInternal. It's address: "
+                << connection.get());
+  return connection;
 }
 
-TransportManagerImpl::ConnectionInternal* TransportManagerImpl::GetConnection(
+TransportManagerImpl::ConnectionInternalPtr TransportManagerImpl::GetConnection(
   const DeviceUID& device, const ApplicationHandle& application) {
   LOG4CXX_TRACE(logger_, "enter DeviceUID: " << &device << "ApplicationHandle: " <<
                 &application);
-  for (std::vector<ConnectionInternal>::iterator it = connections_.begin();
-       it != connections_.end(); ++it) {
-    if (it->device == device && it->application == application) {
-      LOG4CXX_TRACE(logger_, "exit with ConnectionInternal. It's address: " << &*it);
-      return &*it;
-    }
-  }
-  LOG4CXX_TRACE(logger_, "exit with NULL");
-  return NULL;
+  const ConnectionInternalPtr connection =
+    connections_.Find(device, application);
+  LOG4CXX_TRACE(logger_, "exit with ConnectionInternal. It's address: "
+                << connection.get());
+  return connection;
 }
 
 void TransportManagerImpl::OnDeviceListUpdated(TransportAdapter* ta) {
@@ -586,7 +652,8 @@ void TransportManagerImpl::OnDeviceListUpdated(TransportAdapter* ta) {
 
 void TransportManagerImpl::Handle(TransportAdapterEvent event) {
   LOG4CXX_TRACE(logger_, "enter");
-  ConnectionInternal* connection = GetConnection(event.device_uid, event.application_id);
+  const ConnectionInternalPtr connection =
+    GetConnection(event.device_uid, event.application_id);
   switch (event.event_type) {
     case TransportAdapterListenerImpl::EventTypeEnum::ON_SEARCH_DONE: {
       RaiseEvent(&TransportManagerListener::OnScanDevicesFinished);
@@ -612,14 +679,20 @@ void TransportManagerImpl::Handle(TransportAdapterEvent event) {
     }
     case TransportAdapterListenerImpl::EventTypeEnum::ON_CONNECT_DONE: {
       const DeviceHandle device_handle = converter_.UidToHandle(event.device_uid);
-      AddConnection(ConnectionInternal(this, event.transport_adapter, ++connection_id_counter_,
-                                       event.device_uid, event.application_id,
-                                       device_handle));
+      AddConnection(ConnectionInternalPtr(
+                      new ConnectionInternal(this, event.transport_adapter,
+                                             ++connection_id_counter_,
+                                             event.device_uid,
+                                             event.application_id,
+                                             device_handle)));
       RaiseEvent(&TransportManagerListener::OnConnectionEstablished,
                  DeviceInfo(device_handle, event.device_uid,
                                 event.transport_adapter->DeviceName(event.device_uid),
                                 event.transport_adapter->GetConnectionType()),
                  connection_id_counter_);
+      // Listeners know the connection now, so its data may bypass the queue
+      OpenReceiveRoute(event.device_uid, event.application_id,
+                       connection_id_counter_);
       LOG4CXX_DEBUG(logger_, "event_type = ON_CONNECT_DONE");
       break;
     }
@@ -633,12 +706,13 @@ void TransportManagerImpl::Handle(TransportAdapterEvent event) {
       break;
     }
     case TransportAdapterListenerImpl::EventTypeEnum::ON_DISCONNECT_DONE: {
-      if (NULL == connection) {
+      if (!connection.valid()) {
         LOG4CXX_ERROR(logger_, "Connection not found");
         LOG4CXX_DEBUG(logger_,
                       "event_type = ON_DISCONNECT_DONE && NULL == connection");
         break;
       }
+      CloseReceiveRoute(connection->device, connection->application);
       RaiseEvent(&TransportManagerListener::OnConnectionClosed,
                  connection->id);
       RemoveConnection(connection->id);
@@ -658,7 +732,7 @@ void TransportManagerImpl::Handle(TransportAdapterEvent event) {
         metric_observer_->StopRawMsg(event.event_data.get());
       }
 #endif  // TIME_TESTER
-      if (connection == NULL) {
+      if (!connection.valid()) {
         LOG4CXX_ERROR(logger_, "Connection ('" << event.device_uid << ", "
                       << event.application_id
                       << ") not found");
@@ -680,7 +754,7 @@ void TransportManagerImpl::Handle(TransportAdapterEvent event) {
         metric_observer_->StopRawMsg(event.event_data.get());
       }
 #endif  // TIME_TESTER
-      if (connection == NULL) {
+      if (!connection.valid()) {
         LOG4CXX_ERROR(logger_, "Connection ('" << event.device_uid << ", "
                       << event.application_id
                       << ") not found");
@@ -702,11 +776,12 @@ void TransportManagerImpl::Handle(TransportAdapterEvent event) {
       break;
     }
     case TransportAdapterListenerImpl::EventTypeEnum::ON_RECEIVED_DONE: {
-      if (connection == NULL) {
+      if (!connection.valid()) {
         LOG4CXX_ERROR(logger_, "Connection ('" << event.device_uid << ", "
                       << event.application_id
                       << ") not found");
         LOG4CXX_DEBUG(logger_, "event_type = ON_RECEIVED_DONE. Condition: NULL == connection");
+        OnQueuedDataHandled(event.device_uid, event.application_id);
         break;
       }
       event.event_data->set_connection_key(connection->id);
@@ -716,12 +791,14 @@ void TransportManagerImpl::Handle(TransportAdapterEvent event) {
       }
 #endif  // TIME_TESTER
       RaiseEvent(&TransportManagerListener::OnTMMessageReceived, event.event_data);
+      // Only after data is passed further next data may go directly
+      OnQueuedDataHandled(event.device_uid, event.application_id);
       LOG4CXX_DEBUG(logger_, "event_type = ON_RECEIVED_DONE");
       break;
     }
     case TransportAdapterListenerImpl::EventTypeEnum::ON_RECEIVED_FAIL: {
       LOG4CXX_DEBUG(logger_, "Event ON_RECEIVED_FAIL");
-      if (connection == NULL) {
+      if (!connection.valid()) {
         LOG4CXX_ERROR(logger_, "Connection ('" << event.device_uid << ", "
                       << event.application_id
                       << ") not found");
@@ -739,6 +816,7 @@ void TransportManagerImpl::Handle(TransportAdapterEvent event) {
     }
     case TransportAdapterListenerImpl::EventTypeEnum::ON_UNEXPECTED_DISCONNECT: {
       if (connection) {
+        CloseReceiveRoute(connection->device, connection->application);
         RaiseEvent(&TransportManagerListener::OnUnexpectedDisconnect,
                    connection->id,
                    *static_cast<CommunicationError*>(event.event_error.get()));
@@ -763,8 +841,9 @@ void TransportManagerImpl::SetTimeMetricObserver(TMMetricObserver* observer) {
 
 void TransportManagerImpl::Handle(::protocol_handler::RawMessagePtr msg) {
   LOG4CXX_TRACE(logger_, "enter");
-  ConnectionInternal* connection = GetConnection(msg->connection_key());
-  if (connection == NULL) {
+  const ConnectionInternalPtr connection =
+    GetConnection(msg->connection_key());
+  if (!connection.valid()) {
     LOG4CXX_WARN(logger_, "Connection " << msg->connection_key() << " not found");
     RaiseEvent(&TransportManagerListener::OnTMMessageSendFailed,
                DataSendTimeoutError(), msg);
@@ -32,15 +32,13 @@
 
 #include <pthread.h>
 #include <unistd.h>
-#include <iomanip>
 
 #include <libusb/libusb.h>
 
-#include <sstream>
-
 #include "transport_manager/usb/libusb/usb_connection.h"
 #include "transport_manager/transport_adapter/transport_adapter_impl.h"
 
+#include "utils/atomic.h"
 #include "utils/logger.h"
 
 namespace transport_manager {
@@ -48,12 +46,20 @@ namespace transport_adapter {
 
 CREATE_LOGGERPTR_GLOBAL(logger_, "TransportManager")
 
+namespace {
+// Received data filling less than this part of transfer buffer is copied
+// out, so queued small frames do not hold whole transfer buffers
+const int kCopiedDataRatio = 4;
+}  // namespace
 
 UsbConnection::UsbConnection(const DeviceUID& device_uid,
                              const ApplicationHandle& app_handle,
                              TransportAdapterController* controller,
                              const UsbHandlerSptr usb_handler,
-                             PlatformUsbDevice* device)
+                             PlatformUsbDevice* device,
+                             size_t in_transfers_count,
+                             size_t in_transfer_size,
+                             size_t out_transfer_size)
   : device_uid_(device_uid),
     app_handle_(app_handle),
     controller_(controller),
@@ -64,22 +70,31 @@ UsbConnection::UsbConnection(const DeviceUID& device_uid,
     in_endpoint_max_packet_size_(0),
     out_endpoint_(0),
     out_endpoint_max_packet_size_(0),
-    in_buffer_(NULL),
-    in_transfer_(NULL),
-    out_transfer_(0),
+    in_transfers_count_(in_transfers_count > 0 ? in_transfers_count : 1),
+    in_transfer_size_(in_transfer_size),
+    out_transfer_size_(out_transfer_size),
+    in_transfers_(),
+    in_transfers_in_flight_(0),
+    out_transfer_(NULL),
     out_messages_(),
-    current_out_message_(),
+    sending_messages_(),
+    out_buffer_(),
+    out_data_(NULL),
+    out_data_size_(0),
     bytes_sent_(0),
+    out_transfer_in_flight_(false),
     disconnecting_(false),
-    waiting_in_transfer_cancel_(false),
     waiting_out_transfer_cancel_(false) {
 }
 
 UsbConnection::~UsbConnection() {
   LOG4CXX_TRACE(logger_, "enter with this" << this);
   Finalise();
-  libusb_free_transfer(in_transfer_);
-  delete[] in_buffer_;
+  for (std::vector<InTransfer>::iterator it = in_transfers_.begin();
+       it != in_transfers_.end(); ++it) {
+    libusb_free_transfer(it->transfer);
+  }
+  libusb_free_transfer(out_transfer_);
   LOG4CXX_TRACE(logger_, "exit");
 }
 
@@ -92,12 +107,23 @@ void OutTransferCallback(libusb_transfer* transfer) {
   static_cast<UsbConnection*>(transfer->user_data)->OnOutTransfer(transfer);
 }
 
-bool UsbConnection::PostInTransfer() {
+bool UsbConnection::PostInTransfer(InTransfer* in_transfer) {
   LOG4CXX_TRACE(logger_, "enter");
-  libusb_fill_bulk_transfer(in_transfer_, device_handle_, in_endpoint_,
-                            in_buffer_, in_endpoint_max_packet_size_,
+  if (!in_transfer->buffer.valid()) {
+    // Buffer of completed transfer was passed further with received data
+    in_transfer->buffer = protocol_handler::RawMessagePtr(
+        protocol_handler::RawMessage::CreateUninitialized(
+            0, 0, in_transfer_size_));
+  }
+  if (NULL == in_transfer->buffer->data()) {
+    LOG4CXX_ERROR(logger_, "Failed to allocate buffer of USB incoming transfer");
+    LOG4CXX_TRACE(logger_, "exit with FALSE. Condition: NULL == data()");
+    return false;
+  }
+  libusb_fill_bulk_transfer(in_transfer->transfer, device_handle_, in_endpoint_,
+                            in_transfer->buffer->data(), in_transfer_size_,
                             InTransferCallback, this, 0);
-  const int libusb_ret = libusb_submit_transfer(in_transfer_);
+  const int libusb_ret = libusb_submit_transfer(in_transfer->transfer);
   if (LIBUSB_SUCCESS != libusb_ret) {
     LOG4CXX_ERROR(logger_, "libusb_submit_transfer failed: "
                   << libusb_error_name(libusb_ret));
@@ -109,24 +135,46 @@ bool UsbConnection::PostInTransfer() {
   return true;
 }
 
-std::string hex_data(const unsigned char* const buffer, const int actual_length) {
-  std::ostringstream hexdata;
-  for (int i = 0; i < actual_length; ++i) {
-    hexdata << " " << std::hex << std::setw(2) << std::setfill('0')
-            << int(buffer[i]);
+UsbConnection::InTransfer* UsbConnection::FindInTransfer(
+  const libusb_transfer* transfer) {
+  for (std::vector<InTransfer>::iterator it = in_transfers_.begin();
+       it != in_transfers_.end(); ++it) {
+    if (it->transfer == transfer) {
+      return &*it;
+    }
   }
-  return hexdata.str();
+  return NULL;
 }
 
 void UsbConnection::OnInTransfer(libusb_transfer* transfer) {
   LOG4CXX_TRACE(logger_, "enter with Libusb_transfer*: " << transfer);
+  InTransfer* in_transfer = FindInTransfer(transfer);
+  if (NULL == in_transfer) {
+    LOG4CXX_ERROR(logger_, "Unknown USB incoming transfer " << transfer);
+    LOG4CXX_TRACE(logger_, "exit. Condition: NULL == in_transfer");
+    return;
+  }
   if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
     LOG4CXX_DEBUG(logger_,
-                  "USB incoming transfer, size:" << transfer->actual_length
-                  << ", data:" << hex_data(transfer->buffer, transfer->actual_length));
-    ::protocol_handler::RawMessagePtr data(new protocol_handler::RawMessage(
-                         0, 0, in_buffer_, transfer->actual_length));
-    controller_->DataReceiveDone(device_uid_, app_handle_, data);
+                  "USB incoming transfer, size:" << transfer->actual_length);
+    if (transfer->actual_length > 0) {
+      // Transfers of endpoint complete in order of submission,
+      // so data keeps its order
+      ::protocol_handler::RawMessagePtr data;
+      if (static_cast<size_t>(transfer->actual_length) * kCopiedDataRatio <
+          in_transfer_size_) {
+        // Buffer is kept for the next transfer
+        data = ::protocol_handler::RawMessagePtr(
+            new ::protocol_handler::RawMessage(
+                0, 0, in_transfer->buffer->data(), transfer->actual_length));
+      } else {
+        // Buffer is passed without copying
+        data = in_transfer->buffer;
+        in_transfer->buffer.reset();
+        data->Truncate(transfer->actual_length);
+      }
+      controller_->DataReceiveDone(device_uid_, app_handle_, data);
+    }
   } else {
     LOG4CXX_ERROR(logger_, "USB incoming transfer failed: "
                   << libusb_error_name(transfer->status));
@@ -134,9 +182,11 @@ void UsbConnection::OnInTransfer(libusb_transfer* transfer) {
                                    DataReceiveError());
   }
   if (disconnecting_) {
-    waiting_in_transfer_cancel_ = false;
-  } else {
-    if (!PostInTransfer()) {
+    atomic_post_dec(&in_transfers_in_flight_);
+  } else if (!PostInTransfer(in_transfer)) {
+    // Connection is aborted by last transfer only, others would be waited
+    // for on this very thread otherwise
+    if (1 == atomic_post_dec(&in_transfers_in_flight_)) {
       LOG4CXX_ERROR(logger_, "USB incoming transfer failed with "
                     << "LIBUSB_TRANSFER_NO_DEVICE. Abort connection.");
       AbortConnection();
@@ -145,66 +195,101 @@ void UsbConnection::OnInTransfer(libusb_transfer* transfer) {
   LOG4CXX_TRACE(logger_, "exit");
 }
 
-void UsbConnection::PopOutMessage() {
+bool UsbConnection::StartOutTransfer() {
   LOG4CXX_TRACE(logger_, "enter");
-  bytes_sent_ = 0;
-  if (out_messages_.empty()) {
-    current_out_message_.reset();
-  } else {
-    current_out_message_ = out_messages_.front();
-    out_messages_.pop_front();
-    PostOutTransfer();
+  while (!out_messages_.empty()) {
+    sending_messages_.clear();
+    out_data_size_ = 0;
+    // Queued messages are coalesced into one transfer of up to
+    // out_transfer_size_ bytes, bigger message is sent alone
+    while (!out_messages_.empty() &&
+           (sending_messages_.empty() ||
+            out_data_size_ + out_messages_.front()->data_size() <=
+            out_transfer_size_)) {
+      out_data_size_ += out_messages_.front()->data_size();
+      sending_messages_.push_back(out_messages_.front());
+      out_messages_.pop_front();
+    }
+    if (1 == sending_messages_.size()) {
+      out_data_ = sending_messages_.front()->data();
+    } else {
+      out_buffer_.clear();
+      for (std::vector<protocol_handler::RawMessagePtr>::const_iterator it =
+             sending_messages_.begin(); it != sending_messages_.end(); ++it) {
+        out_buffer_.insert(out_buffer_.end(), (*it)->data(),
+                           (*it)->data() + (*it)->data_size());
+      }
+      out_data_ = &out_buffer_[0];
+    }
+    bytes_sent_ = 0;
+    if (PostOutTransfer()) {
+      LOG4CXX_TRACE(logger_, "exit with TRUE");
+      return true;
+    }
+    FailSendingMessages();
   }
-  LOG4CXX_TRACE(logger_, "exit");
+  LOG4CXX_TRACE(logger_, "exit with FALSE. Condition: out_messages_.empty()");
+  return false;
 }
 
 bool UsbConnection::PostOutTransfer() {
   LOG4CXX_TRACE(logger_, "enter");
-  out_transfer_ = libusb_alloc_transfer(0);
-  if (0 == out_transfer_) {
-    LOG4CXX_ERROR(logger_, "libusb_alloc_transfer failed");
-    LOG4CXX_TRACE(logger_, "exit with FALSE. Condition: 0 == out_transfer_");
-    return false;
-  }
   libusb_fill_bulk_transfer(out_transfer_, device_handle_, out_endpoint_,
-                            current_out_message_->data() + bytes_sent_,
-                            current_out_message_->data_size() - bytes_sent_,
+                            out_data_ + bytes_sent_,
+                            out_data_size_ - bytes_sent_,
                             OutTransferCallback, this, 0);
   const int libusb_ret = libusb_submit_transfer(out_transfer_);
   if (LIBUSB_SUCCESS != libusb_ret) {
     LOG4CXX_ERROR(logger_, "libusb_submit_transfer failed: "
-                  << libusb_error_name(libusb_ret) << ". Abort connection.");
-    AbortConnection();
+                  << libusb_error_name(libusb_ret));
     LOG4CXX_TRACE(logger_, "exit with FALSE. Condition: "
-                  << "LIBUSB_SUCCESS != libusb_fill_bulk_transfer");
+                  << "LIBUSB_SUCCESS != libusb_submit_transfer");
     return false;
   }
+  out_transfer_in_flight_ = true;
   LOG4CXX_TRACE(logger_, "exit with TRUE");
   return true;
 }
 
+void UsbConnection::FailSendingMessages() {
+  for (std::vector<protocol_handler::RawMessagePtr>::const_iterator it =
+         sending_messages_.begin(); it != sending_messages_.end(); ++it) {
+    controller_->DataSendFailed(device_uid_, app_handle_, *it,
+                                DataSendError());
+  }
+  sending_messages_.clear();
+}
+
 void UsbConnection::OnOutTransfer(libusb_transfer* transfer) {
   LOG4CXX_TRACE(logger_, "enter with  Libusb_transfer*: " << transfer);
   sync_primitives::AutoLock locker(out_messages_mutex_);
+  out_transfer_in_flight_ = false;
   if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
     bytes_sent_ += transfer->actual_length;
-    if (bytes_sent_ == current_out_message_->data_size()) {
-      LOG4CXX_DEBUG(logger_, "USB out transfer, data sent: "
-                    << current_out_message_.get());
-      controller_->DataSendDone(device_uid_, app_handle_, current_out_message_);
-      PopOutMessage();
+    if (bytes_sent_ < out_data_size_) {
+      if (!disconnecting_ && PostOutTransfer()) {
+        LOG4CXX_TRACE(logger_, "exit. Rest of data is posted");
+        return;
+      }
+      FailSendingMessages();
+    } else {
+      LOG4CXX_DEBUG(logger_, "USB out transfer, messages sent: "
+                    << sending_messages_.size());
+      for (std::vector<protocol_handler::RawMessagePtr>::const_iterator it =
+             sending_messages_.begin(); it != sending_messages_.end(); ++it) {
+        controller_->DataSendDone(device_uid_, app_handle_, *it);
+      }
+      sending_messages_.clear();
     }
   } else {
     LOG4CXX_ERROR(logger_, "USB out transfer failed: "
                   << libusb_error_name(transfer->status));
-    controller_->DataSendFailed(device_uid_, app_handle_, current_out_message_,
-                                DataSendError());
-    PopOutMessage();
+    FailSendingMessages();
   }
-  if (!current_out_message_.valid()) {
-    libusb_free_transfer(transfer);
-    out_transfer_ = NULL;
+  if (disconnecting_) {
     waiting_out_transfer_cancel_ = false;
+  } else {
+    StartOutTransfer();
   }
   LOG4CXX_TRACE(logger_, "exit");
 }
@@ -217,16 +302,11 @@ TransportAdapter::Error UsbConnection::SendData(::protocol_handler::RawMessagePt
     return TransportAdapter::BAD_STATE;
   }
   sync_primitives::AutoLock locker(out_messages_mutex_);
-  if (current_out_message_.valid()) {
-    out_messages_.push_back(message);
-  } else {
-    current_out_message_ = message;
-    if (!PostOutTransfer()) {
-      controller_->DataSendFailed(device_uid_, app_handle_, message,
-                                  DataSendError());
-      LOG4CXX_TRACE(logger_, "exit with TransportAdapter::FAIL. Condition: !PostOutTransfer()");
-      return TransportAdapter::FAIL;
-    }
+  out_messages_.push_back(message);
+  // Messages queued while transfer is in flight are sent by its completion
+  if (!out_transfer_in_flight_ && !StartOutTransfer()) {
+    LOG4CXX_TRACE(logger_, "exit with TransportAdapter::FAIL. Condition: !StartOutTransfer()");
+    return TransportAdapter::FAIL;
   }
   LOG4CXX_TRACE(logger_, "exit with TransportAdapter::OK.");
   return TransportAdapter::OK;
@@ -238,24 +318,24 @@ void UsbConnection::Finalise() {
   {
     sync_primitives::AutoLock locker(out_messages_mutex_);
     disconnecting_ = true;
-    if (out_transfer_) {
+    if (out_transfer_in_flight_) {
       waiting_out_transfer_cancel_ = true;
       if ( LIBUSB_SUCCESS != libusb_cancel_transfer(out_transfer_)) {
         waiting_out_transfer_cancel_ = false;
       }
     }
-    if (in_transfer_) {
-      waiting_in_transfer_cancel_ = true;
-      if ( LIBUSB_SUCCESS != libusb_cancel_transfer(in_transfer_)) {
-        waiting_in_transfer_cancel_ = false;
-      }
+    // Cancelled as well as just completed transfers are accounted
+    // by OnInTransfer
+    for (std::vector<InTransfer>::iterator it = in_transfers_.begin();
+         it != in_transfers_.end(); ++it) {
+      libusb_cancel_transfer(it->transfer);
     }
     for (std::list<protocol_handler::RawMessagePtr>::iterator it = out_messages_.begin();
          it != out_messages_.end(); it = out_messages_.erase(it)) {
       controller_->DataSendFailed(device_uid_, app_handle_, *it, DataSendError());
     }
   }
-  while (waiting_in_transfer_cancel_ || waiting_out_transfer_cancel_) {
+  while (in_transfers_in_flight_ > 0 || waiting_out_transfer_cancel_) {
     pthread_yield();
   }
   LOG4CXX_TRACE(logger_, "exit");
@@ -281,22 +361,50 @@ bool UsbConnection::Init() {
     LOG4CXX_TRACE(logger_, "exit with FALSE. Condition: !FindEndpoints()");
     return false;
   }
-  in_buffer_ = new unsigned char[in_endpoint_max_packet_size_];
-  in_transfer_ = libusb_alloc_transfer(0);
-  if (NULL == in_transfer_) {
+  // Buffer of whole packets, short packet of device completes transfer
+  // before buffer is full
+  if (in_endpoint_max_packet_size_ > 0) {
+    const size_t packets = (in_transfer_size_ + in_endpoint_max_packet_size_ - 1)
+                           / in_endpoint_max_packet_size_;
+    in_transfer_size_ = (packets > 0 ? packets : 1) * in_endpoint_max_packet_size_;
+  }
+  out_buffer_.reserve(out_transfer_size_);
+  out_transfer_ = libusb_alloc_transfer(0);
+  if (NULL == out_transfer_) {
     LOG4CXX_ERROR(logger_, "libusb_alloc_transfer failed");
-    LOG4CXX_TRACE(logger_, "exit with FALSE. Condition: NULL == in_transfer_");
+    LOG4CXX_TRACE(logger_, "exit with FALSE. Condition: NULL == out_transfer_");
     return false;
   }
+  in_transfers_.reserve(in_transfers_count_);
+  for (size_t i = 0; i < in_transfers_count_; ++i) {
+    libusb_transfer* transfer = libusb_alloc_transfer(0);
+    if (NULL == transfer) {
+      LOG4CXX_ERROR(logger_, "libusb_alloc_transfer failed");
+      LOG4CXX_TRACE(logger_, "exit with FALSE. Condition: NULL == transfer");
+      return false;
+    }
+    in_transfers_.push_back(InTransfer(transfer));
+  }
 
   controller_->ConnectDone(device_uid_, app_handle_);
-  if (!PostInTransfer()) {
+  for (std::vector<InTransfer>::iterator it = in_transfers_.begin();
+       it != in_transfers_.end(); ++it) {
+    // Counted before submission as transfer may complete at once
+    atomic_post_inc(&in_transfers_in_flight_);
+    if (!PostInTransfer(&*it)) {
+      atomic_post_dec(&in_transfers_in_flight_);
+      break;
+    }
+  }
+  if (0 == in_transfers_in_flight_) {
     LOG4CXX_ERROR(logger_, "PostInTransfer failed. Call ConnectionAborted");
     controller_->ConnectionAborted(device_uid_, app_handle_,
                                    CommunicationError());
     LOG4CXX_TRACE(logger_, "exit with FALSE. Condition: !PostInTransfer()");
     return false;
   }
+  LOG4CXX_DEBUG(logger_, in_transfers_in_flight_ << " incoming transfers of "
+                << in_transfer_size_ << " bytes are posted");
 
   LOG4CXX_TRACE(logger_, "exit with TRUE");
   return true;
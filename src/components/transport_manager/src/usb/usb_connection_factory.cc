@@ -34,6 +34,7 @@
 #include "transport_manager/usb/usb_device.h"
 #include "transport_manager/transport_adapter/transport_adapter_impl.h"
 #include "utils/logger.h"
+#include "config_profile/profile.h"
 
 #if defined(__QNXNTO__)
 #include "transport_manager/usb/qnx/usb_connection.h"
@@ -71,9 +72,19 @@ TransportAdapter::Error UsbConnectionFactory::CreateConnection(
   }
 
   UsbDevice* usb_device = static_cast<UsbDevice*>(device.get());
+#if defined(__QNXNTO__)
   UsbConnection* usb_connection =
     new UsbConnection(device_uid, app_handle, controller_, usb_handler_,
                       usb_device->usb_device());
+#else
+  const profile::Profile& profile = *profile::Profile::instance();
+  UsbConnection* usb_connection =
+    new UsbConnection(device_uid, app_handle, controller_, usb_handler_,
+                      usb_device->usb_device(),
+                      profile.usb_in_transfers_count(),
+                      profile.usb_in_transfer_size(),
+                      profile.usb_out_transfer_size());
+#endif
 
   controller_->ConnectionCreated(usb_connection, device_uid, app_handle);
 
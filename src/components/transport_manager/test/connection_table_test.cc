@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "transport_manager/connection_table.h"
+#include "utils/date_time.h"
+
+namespace test {
+namespace components {
+namespace transport_manager_test {
+
+using namespace ::transport_manager;
+
+namespace {
+struct TestConnection {
+  TestConnection(ConnectionUID id, const DeviceUID& device,
+                 ApplicationHandle application)
+    : id(id),
+      device(device),
+      application(application) {}
+  ConnectionUID id;
+  DeviceUID device;
+  ApplicationHandle application;
+};
+
+typedef ConnectionTable<TestConnection> TestConnectionTable;
+typedef TestConnectionTable::ConnectionPtr TestConnectionPtr;
+
+DeviceUID DeviceName(ConnectionUID id) {
+  char name[64];
+  snprintf(name, sizeof(name), "device_%u_with_long_bluetooth_address", id);
+  return name;
+}
+}  // namespace
+
+TEST(ConnectionTableTest, FindByBothKeys) {
+  TestConnectionTable table;
+  const TestConnectionPtr connection(new TestConnection(1u, "device", 2));
+  EXPECT_TRUE(table.Insert(connection));
+  EXPECT_EQ(connection.get(), table.Find(1u).get());
+  EXPECT_EQ(connection.get(), table.Find("device", 2).get());
+  EXPECT_FALSE(table.Find(2u).valid());
+  EXPECT_FALSE(table.Find("device", 1).valid());
+  EXPECT_EQ(1u, table.size());
+}
+
+TEST(ConnectionTableTest, InsertSameIdTwice_FirstConnectionKept) {
+  TestConnectionTable table;
+  const TestConnectionPtr connection(new TestConnection(1u, "device", 2));
+  EXPECT_TRUE(table.Insert(connection));
+  EXPECT_FALSE(table.Insert(TestConnectionPtr(
+      new TestConnection(1u, "other", 3))));
+  EXPECT_EQ(connection.get(), table.Find(1u).get());
+  EXPECT_FALSE(table.Find("other", 3).valid());
+}
+
+TEST(ConnectionTableTest, FoundConnectionSurvivesErase) {
+  TestConnectionTable table;
+  table.Insert(TestConnectionPtr(new TestConnection(1u, "device", 2)));
+  const TestConnectionPtr found = table.Find(1u);
+  const TestConnectionPtr erased = table.Erase(1u);
+  EXPECT_EQ(found.get(), erased.get());
+  EXPECT_EQ("device", found->device);
+  EXPECT_FALSE(table.Find(1u).valid());
+  EXPECT_FALSE(table.Find("device", 2).valid());
+  EXPECT_FALSE(table.Erase(1u).valid());
+  EXPECT_EQ(0u, table.size());
+}
+
+TEST(ConnectionTableTest, EraseOfOldConnection_NewerConnectionOfSameAppKept) {
+  TestConnectionTable table;
+  table.Insert(TestConnectionPtr(new TestConnection(1u, "device", 2)));
+  const TestConnectionPtr newer(new TestConnection(2u, "device", 2));
+  table.Insert(newer);
+  table.Erase(1u);
+  EXPECT_EQ(newer.get(), table.Find("device", 2).get());
+}
+
+TEST(ConnectionTableTest, ManyConnections_AllFoundByBothKeys) {
+  const ConnectionUID kConnectionsCount = 64;
+  TestConnectionTable table;
+  for (ConnectionUID id = 1; id <= kConnectionsCount; ++id) {
+    table.Insert(TestConnectionPtr(
+        new TestConnection(id, DeviceName(id), id)));
+  }
+  for (ConnectionUID id = 1; id <= kConnectionsCount; ++id) {
+    const TestConnectionPtr by_id = table.Find(id);
+    ASSERT_TRUE(by_id.valid());
+    EXPECT_EQ(id, by_id->id);
+    EXPECT_EQ(by_id.get(), table.Find(DeviceName(id), id).get());
+  }
+  EXPECT_FALSE(table.Find(kConnectionsCount + 1).valid());
+}
+
+TEST(ConnectionTableTest, DISABLED_Benchmark_LookupOf64Connections) {
+  const ConnectionUID kConnectionsCount = 64;
+  const uint32_t kRounds = 20000;
+  TestConnectionTable table;
+  std::vector<TestConnection> vector;
+  for (ConnectionUID id = 1; id <= kConnectionsCount; ++id) {
+    table.Insert(TestConnectionPtr(
+        new TestConnection(id, DeviceName(id), id)));
+    vector.push_back(TestConnection(id, DeviceName(id), id));
+  }
+  std::vector<DeviceUID> names;
+  for (ConnectionUID id = 1; id <= kConnectionsCount; ++id) {
+    names.push_back(DeviceName(id));
+  }
+
+  // Former linear search of std::vector<ConnectionInternal>
+  size_t found_count = 0;
+  TimevalStruct start = date_time::DateTime::getCurrentTime();
+  for (uint32_t round = 0; round < kRounds; ++round) {
+    for (ConnectionUID id = 1; id <= kConnectionsCount; ++id) {
+      for (std::vector<TestConnection>::const_iterator it = vector.begin();
+           it != vector.end(); ++it) {
+        if (it->id == id) {
+          ++found_count;
+          break;
+        }
+      }
+      for (std::vector<TestConnection>::const_iterator it = vector.begin();
+           it != vector.end(); ++it) {
+        if (it->device == names[id - 1] &&
+            it->application == static_cast<ApplicationHandle>(id)) {
+          ++found_count;
+          break;
+        }
+      }
+    }
+  }
+  const int64_t linear_ms = date_time::DateTime::calculateTimeSpan(start);
+  EXPECT_EQ(2u * kRounds * kConnectionsCount, found_count);
+
+  found_count = 0;
+  start = date_time::DateTime::getCurrentTime();
+  for (uint32_t round = 0; round < kRounds; ++round) {
+    for (ConnectionUID id = 1; id <= kConnectionsCount; ++id) {
+      found_count += table.Find(id).valid();
+      found_count += table.Find(names[id - 1], id).valid();
+    }
+  }
+  const int64_t table_ms = date_time::DateTime::calculateTimeSpan(start);
+  EXPECT_EQ(2u * kRounds * kConnectionsCount, found_count);
+
+  printf("%u lookups by both keys of %u connections: "
+         "linear search %lld ms, connection table %lld ms\n",
+         static_cast<unsigned>(kRounds * kConnectionsCount),
+         static_cast<unsigned>(kConnectionsCount),
+         static_cast<long long>(linear_ms), static_cast<long long>(table_ms));
+}
+
+}  // namespace transport_manager_test
+}  // namespace components
+}  // namespace test
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "include/fake_libusb.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <list>
+#include <set>
+
+#include <libusb/libusb.h>
+
+#include "utils/lock.h"
+
+namespace fake_libusb {
+
+namespace {
+sync_primitives::Lock lock;
+uint16_t max_packet_size = 512;
+std::list<libusb_transfer*> submitted;
+std::list<libusb_transfer*> cancelled;
+std::deque<std::vector<uint8_t> > device_writes;
+size_t device_write_offset = 0;
+std::vector<uint8_t> device_received;
+std::set<const unsigned char*> in_buffers;
+size_t in_completed = 0;
+size_t out_completed = 0;
+}  // namespace
+
+void Reset(uint16_t packet_size) {
+  sync_primitives::AutoLock auto_lock(lock);
+  max_packet_size = packet_size;
+  submitted.clear();
+  cancelled.clear();
+  device_writes.clear();
+  device_write_offset = 0;
+  device_received.clear();
+  in_buffers.clear();
+  in_completed = 0;
+  out_completed = 0;
+}
+
+void DeviceWrite(const uint8_t* data, size_t size) {
+  sync_primitives::AutoLock auto_lock(lock);
+  device_writes.push_back(std::vector<uint8_t>(data, data + size));
+}
+
+size_t HandleEvents() {
+  std::vector<libusb_transfer*> completed;
+  {
+    sync_primitives::AutoLock auto_lock(lock);
+    for (std::list<libusb_transfer*>::iterator it = cancelled.begin();
+         it != cancelled.end(); it = cancelled.erase(it)) {
+      (*it)->status = LIBUSB_TRANSFER_CANCELLED;
+      (*it)->actual_length = 0;
+      completed.push_back(*it);
+    }
+    std::list<libusb_transfer*>::iterator it = submitted.begin();
+    while (it != submitted.end()) {
+      libusb_transfer* transfer = *it;
+      if (kOutEndpoint == transfer->endpoint) {
+        device_received.insert(device_received.end(), transfer->buffer,
+                               transfer->buffer + transfer->length);
+        transfer->actual_length = transfer->length;
+        ++out_completed;
+      } else if (!device_writes.empty()) {
+        const std::vector<uint8_t>& write = device_writes.front();
+        const size_t size =
+            std::min(write.size() - device_write_offset,
+                     static_cast<size_t>(transfer->length));
+        memcpy(transfer->buffer, &write[device_write_offset], size);
+        transfer->actual_length = size;
+        device_write_offset += size;
+        if (device_write_offset == write.size()) {
+          device_writes.pop_front();
+          device_write_offset = 0;
+        }
+        ++in_completed;
+      } else {
+        // Waits for device data
+        ++it;
+        continue;
+      }
+      transfer->status = LIBUSB_TRANSFER_COMPLETED;
+      completed.push_back(transfer);
+      it = submitted.erase(it);
+    }
+  }
+  for (std::vector<libusb_transfer*>::iterator it = completed.begin();
+       it != completed.end(); ++it) {
+    (*it)->callback(*it);
+  }
+  return completed.size();
+}
+
+std::vector<uint8_t> device_received_data() {
+  sync_primitives::AutoLock auto_lock(lock);
+  return device_received;
+}
+
+size_t in_transfer_buffers_count() {
+  sync_primitives::AutoLock auto_lock(lock);
+  return in_buffers.size();
+}
+
+size_t completed_in_transfers_count() {
+  sync_primitives::AutoLock auto_lock(lock);
+  return in_completed;
+}
+
+size_t completed_out_transfers_count() {
+  sync_primitives::AutoLock auto_lock(lock);
+  return out_completed;
+}
+
+size_t pending_device_bytes() {
+  sync_primitives::AutoLock auto_lock(lock);
+  size_t bytes = 0;
+  for (std::deque<std::vector<uint8_t> >::const_iterator it =
+           device_writes.begin(); it != device_writes.end(); ++it) {
+    bytes += it->size();
+  }
+  return bytes - device_write_offset;
+}
+
+}  // namespace fake_libusb
+
+extern "C" {
+
+libusb_transfer* LIBUSB_CALL libusb_alloc_transfer(int) {
+  return static_cast<libusb_transfer*>(calloc(1, sizeof(libusb_transfer)));
+}
+
+void LIBUSB_CALL libusb_free_transfer(libusb_transfer* transfer) {
+  free(transfer);
+}
+
+int LIBUSB_CALL libusb_submit_transfer(libusb_transfer* transfer) {
+  sync_primitives::AutoLock auto_lock(fake_libusb::lock);
+  fake_libusb::submitted.push_back(transfer);
+  if (fake_libusb::kInEndpoint == transfer->endpoint) {
+    fake_libusb::in_buffers.insert(transfer->buffer);
+  }
+  return LIBUSB_SUCCESS;
+}
+
+int LIBUSB_CALL libusb_cancel_transfer(libusb_transfer* transfer) {
+  sync_primitives::AutoLock auto_lock(fake_libusb::lock);
+  std::list<libusb_transfer*>::iterator it =
+      std::find(fake_libusb::submitted.begin(), fake_libusb::submitted.end(),
+                transfer);
+  if (fake_libusb::submitted.end() == it) {
+    return LIBUSB_ERROR_NOT_FOUND;
+  }
+  fake_libusb::submitted.erase(it);
+  fake_libusb::cancelled.push_back(transfer);
+  return LIBUSB_SUCCESS;
+}
+
+const char* LIBUSB_CALL libusb_error_name(int) {
+  return "FAKE_LIBUSB_ERROR";
+}
+
+int LIBUSB_CALL libusb_get_active_config_descriptor(
+    libusb_device*, libusb_config_descriptor** config) {
+  libusb_endpoint_descriptor* endpoints =
+      static_cast<libusb_endpoint_descriptor*>(
+          calloc(2, sizeof(libusb_endpoint_descriptor)));
+  endpoints[0].bEndpointAddress = fake_libusb::kInEndpoint;
+  endpoints[0].wMaxPacketSize = fake_libusb::max_packet_size;
+  endpoints[1].bEndpointAddress = fake_libusb::kOutEndpoint;
+  endpoints[1].wMaxPacketSize = fake_libusb::max_packet_size;
+  libusb_interface_descriptor* altsetting =
+      static_cast<libusb_interface_descriptor*>(
+          calloc(1, sizeof(libusb_interface_descriptor)));
+  altsetting->bNumEndpoints = 2;
+  altsetting->endpoint = endpoints;
+  libusb_interface* interface =
+      static_cast<libusb_interface*>(calloc(1, sizeof(libusb_interface)));
+  interface->num_altsetting = 1;
+  interface->altsetting = altsetting;
+  *config = static_cast<libusb_config_descriptor*>(
+      calloc(1, sizeof(libusb_config_descriptor)));
+  (*config)->bNumInterfaces = 1;
+  (*config)->interface = interface;
+  return LIBUSB_SUCCESS;
+}
+
+void LIBUSB_CALL libusb_free_config_descriptor(
+    libusb_config_descriptor* config) {
+  free(const_cast<libusb_endpoint_descriptor*>(
+      config->interface->altsetting->endpoint));
+  free(const_cast<libusb_interface_descriptor*>(
+      config->interface->altsetting));
+  free(const_cast<libusb_interface*>(config->interface));
+  free(config);
+}
+
+// Used by device handling code linked with connection, never called by tests
+
+int LIBUSB_CALL libusb_get_string_descriptor_ascii(libusb_device_handle*,
+                                                   uint8_t, unsigned char*,
+                                                   int) {
+  return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+int LIBUSB_CALL libusb_init(libusb_context**) {
+  return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+void LIBUSB_CALL libusb_exit(libusb_context*) {}
+
+int LIBUSB_CALL libusb_has_capability(uint32_t) {
+  return 0;
+}
+
+int LIBUSB_CALL libusb_open(libusb_device*, libusb_device_handle**) {
+  return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+void LIBUSB_CALL libusb_close(libusb_device_handle*) {}
+
+int LIBUSB_CALL libusb_set_configuration(libusb_device_handle*, int) {
+  return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+int LIBUSB_CALL libusb_get_configuration(libusb_device_handle*, int*) {
+  return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+int LIBUSB_CALL libusb_claim_interface(libusb_device_handle*, int) {
+  return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+int LIBUSB_CALL libusb_release_interface(libusb_device_handle*, int) {
+  return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+uint8_t LIBUSB_CALL libusb_get_bus_number(libusb_device*) {
+  return 0;
+}
+
+uint8_t LIBUSB_CALL libusb_get_device_address(libusb_device*) {
+  return 0;
+}
+
+int LIBUSB_CALL libusb_get_device_descriptor(libusb_device*,
+                                             libusb_device_descriptor*) {
+  return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+int LIBUSB_CALL libusb_handle_events_completed(libusb_context*, int*) {
+  return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+int LIBUSB_CALL libusb_hotplug_register_callback(
+    libusb_context*, libusb_hotplug_event, libusb_hotplug_flag, int, int, int,
+    libusb_hotplug_callback_fn, void*, libusb_hotplug_callback_handle*) {
+  return LIBUSB_ERROR_NOT_SUPPORTED;
+}
+
+void LIBUSB_CALL libusb_hotplug_deregister_callback(
+    libusb_context*, libusb_hotplug_callback_handle) {}
+
+}  // extern "C"
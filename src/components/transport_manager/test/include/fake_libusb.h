@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_TRANSPORT_MANAGER_TEST_INCLUDE_FAKE_LIBUSB_H_
+#define SRC_COMPONENTS_TRANSPORT_MANAGER_TEST_INCLUDE_FAKE_LIBUSB_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/*
+ * Replaces libusb for tests: the device side of one bulk IN and one bulk OUT
+ * endpoint is emulated in memory, transfers complete only in HandleEvents().
+ */
+namespace fake_libusb {
+
+const unsigned char kInEndpoint = 0x81;
+const unsigned char kOutEndpoint = 0x01;
+
+/**
+ * @brief Drops all device data and transfers, sets endpoints packet size
+ */
+void Reset(uint16_t max_packet_size);
+
+/**
+ * @brief Queues data written by device to IN endpoint. Like on real bus,
+ * transfer completes at the end of write, so it gets at most one write.
+ */
+void DeviceWrite(const uint8_t* data, size_t size);
+
+/**
+ * @brief Completes submitted transfers as one round trip of host
+ * controller does, callbacks are called from caller thread.
+ * @return number of completed transfers
+ */
+size_t HandleEvents();
+
+/**
+ * @brief Bytes received by device from OUT endpoint
+ */
+std::vector<uint8_t> device_received_data();
+
+/**
+ * @brief Number of distinct buffers submitted for IN transfers
+ */
+size_t in_transfer_buffers_count();
+
+size_t completed_in_transfers_count();
+size_t completed_out_transfers_count();
+size_t pending_device_bytes();
+
+}  // namespace fake_libusb
+
+#endif  // SRC_COMPONENTS_TRANSPORT_MANAGER_TEST_INCLUDE_FAKE_LIBUSB_H_
@@ -45,6 +45,7 @@ using namespace ::transport_manager;
 class TransportManagerImplMock : public TransportManagerImpl {
  public:
   MOCK_METHOD1(ReceiveEventFromDevice, int(const TransportAdapterEvent& event));
+  MOCK_METHOD1(ReceiveDataFromDevice, int(const TransportAdapterEvent& event));
 };
 
 }  // namespace transport_manager
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "include/transport_adapter_mock.h"
+#include "transport_manager/transport_manager_impl.h"
+#include "transport_manager/transport_manager_listener_empty.h"
+#include "transport_manager/transport_adapter/transport_adapter_listener_impl.h"
+#include "utils/date_time.h"
+#include "utils/lock.h"
+#include "utils/threads/message_loop_thread.h"
+
+namespace test {
+namespace components {
+namespace transport_manager_test {
+
+using ::testing::NiceMock;
+using ::testing::Return;
+using namespace ::transport_manager;
+using ::protocol_handler::RawMessage;
+using ::protocol_handler::RawMessagePtr;
+
+namespace {
+const ApplicationHandle kApplication = 1;
+const char kDevice[] = "device_id";
+const int64_t kWaitingTimeoutMs = 10000;
+
+/*
+ * Stands for protocol handler: data and connection events are posted
+ * to the inbound queue and their arrival is stamped by its thread
+ */
+class InboundQueueListener
+    : public TransportManagerListenerEmpty,
+      public threads::MessageLoopThread<std::queue<RawMessagePtr> >::Handler {
+ public:
+  explicit InboundQueueListener(size_t expected_count)
+    : expected_count_(expected_count),
+      connection_established_(false),
+      connection_id_(0),
+      data_before_connection_(false),
+      reordered_(false),
+      connection_id_mismatch_(false),
+      latency_sum_us_(0),
+      queue_("Test Inbound", this) {}
+
+  ~InboundQueueListener() {
+    queue_.Shutdown();
+  }
+
+  void OnConnectionEstablished(const DeviceInfo&, const ConnectionUID& id) {
+    sync_primitives::AutoLock lock(lock_);
+    connection_established_ = true;
+    connection_id_ = id;
+  }
+
+  void OnTMMessageReceived(const RawMessagePtr message) {
+    queue_.PostMessage(message);
+  }
+
+  void Handle(const RawMessagePtr message) {
+    const int64_t now_us =
+        date_time::DateTime::getuSecs(date_time::DateTime::getCurrentTime());
+    uint32_t number = 0;
+    memcpy(&number, message->data(), sizeof(number));
+    sync_primitives::AutoLock lock(lock_);
+    data_before_connection_ |= !connection_established_;
+    connection_id_mismatch_ |= message->connection_key() != connection_id_;
+    reordered_ |= number != received_.size();
+    if (number < send_times_us_.size()) {
+      latency_sum_us_ += now_us - send_times_us_[number];
+    }
+    received_.push_back(number);
+  }
+
+  void SetSendTime(uint32_t number) {
+    const int64_t now_us =
+        date_time::DateTime::getuSecs(date_time::DateTime::getCurrentTime());
+    sync_primitives::AutoLock lock(lock_);
+    send_times_us_.resize(number + 1);
+    send_times_us_[number] = now_us;
+  }
+
+  bool WaitAll() {
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    while (date_time::DateTime::calculateTimeSpan(start) < kWaitingTimeoutMs) {
+      {
+        sync_primitives::AutoLock lock(lock_);
+        if (received_.size() >= expected_count_) {
+          return true;
+        }
+      }
+      usleep(1000);
+    }
+    return false;
+  }
+
+  bool data_before_connection() const { return data_before_connection_; }
+  bool reordered() const { return reordered_; }
+  size_t received_count() {
+    sync_primitives::AutoLock lock(lock_);
+    return received_.size();
+  }
+  bool connection_id_mismatch() const { return connection_id_mismatch_; }
+  int64_t average_latency_us() const {
+    return received_.empty() ? 0 : latency_sum_us_ / received_.size();
+  }
+
+ private:
+  const size_t expected_count_;
+  sync_primitives::Lock lock_;
+  bool connection_established_;
+  ConnectionUID connection_id_;
+  bool data_before_connection_;
+  bool reordered_;
+  bool connection_id_mismatch_;
+  std::vector<uint32_t> received_;
+  std::vector<int64_t> send_times_us_;
+  int64_t latency_sum_us_;
+  threads::MessageLoopThread<std::queue<RawMessagePtr> > queue_;
+  DISALLOW_COPY_AND_ASSIGN(InboundQueueListener);
+};
+
+RawMessagePtr CreateData(uint32_t number) {
+  uint8_t data[64] = {0};
+  memcpy(data, &number, sizeof(number));
+  return RawMessagePtr(new RawMessage(0, 0, data, sizeof(data)));
+}
+
+TransportAdapterEvent CreateEvent(int type,
+                                  transport_adapter::TransportAdapter* adapter,
+                                  const RawMessagePtr data) {
+  return TransportAdapterEvent(type, adapter, kDevice, kApplication, data,
+                               BaseErrorPtr(new BaseError()));
+}
+
+class ReceivePathTest : public ::testing::Test {
+ protected:
+  ReceivePathTest() : adapter_listener_(&tm_, &adapter_) {}
+
+  void SetUp() {
+    ON_CALL(adapter_, DeviceName(::testing::_))
+        .WillByDefault(Return(std::string(kDevice)));
+    tm_.Init();
+  }
+
+  void TearDown() {
+    tm_.Stop();
+  }
+
+  void Connect() {
+    tm_.ReceiveEventFromDevice(CreateEvent(
+        TransportAdapterListenerImpl::EventTypeEnum::ON_CONNECT_DONE,
+        &adapter_, RawMessagePtr()));
+  }
+
+  NiceMock<TransportAdapterMock> adapter_;
+  TransportManagerImpl tm_;
+  TransportAdapterListenerImpl adapter_listener_;
+};
+}  // namespace
+
+TEST_F(ReceivePathTest, DataRacingConnectionKeepsOrder) {
+  const uint32_t kFramesCount = 1000;
+  InboundQueueListener listener(kFramesCount);
+  tm_.AddEventListener(&listener);
+
+  Connect();
+  // Part of frames is queued behind connection event, others go directly
+  for (uint32_t i = 0; i < kFramesCount; ++i) {
+    adapter_listener_.OnDataReceiveDone(&adapter_, kDevice, kApplication,
+                                        CreateData(i));
+  }
+  ASSERT_TRUE(listener.WaitAll());
+  EXPECT_FALSE(listener.data_before_connection());
+  EXPECT_FALSE(listener.connection_id_mismatch());
+  EXPECT_FALSE(listener.reordered());
+}
+
+TEST_F(ReceivePathTest, DataOfClosedConnectionIsNotPassedDirectly) {
+  InboundQueueListener listener(1);
+  tm_.AddEventListener(&listener);
+
+  Connect();
+  adapter_listener_.OnDataReceiveDone(&adapter_, kDevice, kApplication,
+                                      CreateData(0));
+  ASSERT_TRUE(listener.WaitAll());
+
+  tm_.ReceiveEventFromDevice(CreateEvent(
+      TransportAdapterListenerImpl::EventTypeEnum::ON_DISCONNECT_DONE,
+      &adapter_, RawMessagePtr()));
+  // Waits while event queue handles the disconnection
+  usleep(100000);
+  adapter_listener_.OnDataReceiveDone(&adapter_, kDevice, kApplication,
+                                      CreateData(1));
+  usleep(100000);
+  EXPECT_EQ(1u, listener.received_count());
+}
+
+TEST_F(ReceivePathTest, DISABLED_Benchmark_LatencyFromAdapterToInboundQueue) {
+  const uint32_t kFramesCount = 10000;
+  const char* kPathNames[] = {"event queue", "direct"};
+  for (size_t path = 0; path < ARRAYSIZE(kPathNames); ++path) {
+    TransportManagerImpl tm;
+    TransportAdapterListenerImpl adapter_listener(&tm, &adapter_);
+    InboundQueueListener listener(kFramesCount);
+    tm.Init();
+    tm.AddEventListener(&listener);
+    tm.ReceiveEventFromDevice(CreateEvent(
+        TransportAdapterListenerImpl::EventTypeEnum::ON_CONNECT_DONE,
+        &adapter_, RawMessagePtr()));
+    // Lets connection become established before measurement
+    usleep(100000);
+
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    for (uint32_t i = 0; i < kFramesCount; ++i) {
+      const RawMessagePtr data = CreateData(i);
+      listener.SetSendTime(i);
+      if (0 == path) {
+        tm.ReceiveEventFromDevice(CreateEvent(
+            TransportAdapterListenerImpl::EventTypeEnum::ON_RECEIVED_DONE,
+            &adapter_, data));
+      } else {
+        adapter_listener.OnDataReceiveDone(&adapter_, kDevice, kApplication,
+                                           data);
+      }
+    }
+    ASSERT_TRUE(listener.WaitAll());
+    const int64_t duration_ms = date_time::DateTime::calculateTimeSpan(start);
+    printf("%s path: %u frames in %lld ms, average latency %lld us\n",
+           kPathNames[path], static_cast<unsigned>(kFramesCount),
+           static_cast<long long>(duration_ms),
+           static_cast<long long>(listener.average_latency_us()));
+    EXPECT_FALSE(listener.reordered());
+    tm.Stop();
+  }
+}
+
+}  // namespace transport_manager_test
+}  // namespace components
+}  // namespace test
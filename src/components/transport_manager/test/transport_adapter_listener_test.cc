@@ -103,7 +103,7 @@ TEST_F(TransportAdapterListenerTest, OnDataReceiveDone) {
   ::protocol_handler::RawMessagePtr data_container;
 
   EXPECT_CALL(tr_mock,
-              ReceiveEventFromDevice(IsEvent(
+              ReceiveDataFromDevice(IsEvent(
                   TransportAdapterListenerImpl::EventTypeEnum::ON_RECEIVED_DONE,
                   &adapter_mock, dev_id, app_handle, data_container)))
       .WillOnce(Return(E_SUCCESS));
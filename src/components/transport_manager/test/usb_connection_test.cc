@@ -0,0 +1,429 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/fake_libusb.h"
+#include "transport_manager/usb/libusb/usb_connection.h"
+#include "transport_manager/transport_adapter/transport_adapter_controller.h"
+#include "utils/date_time.h"
+#include "utils/lock.h"
+#include "utils/macro.h"
+
+namespace test {
+namespace components {
+namespace transport_manager_test {
+
+using namespace ::transport_manager;
+using namespace ::transport_manager::transport_adapter;
+using ::protocol_handler::RawMessage;
+using ::protocol_handler::RawMessagePtr;
+
+namespace {
+const uint16_t kMaxPacketSize = 512;
+// High speed USB microframe
+const useconds_t kRoundTripUs = 125;
+const int64_t kWaitingTimeoutMs = 60000;
+const char kDevice[] = "usb_device";
+const ApplicationHandle kApplication = 0;
+
+/*
+ * Collects data and results of transfers reported by connection
+ */
+class RecordingController : public TransportAdapterController {
+ public:
+  RecordingController()
+    : send_done_count_(0),
+      send_failed_count_(0),
+      disconnect_done_(false) {}
+
+  DeviceSptr AddDevice(DeviceSptr device) { return device; }
+  void SearchDeviceDone(const DeviceVector&) {}
+  void ApplicationListUpdated(const DeviceUID&) {}
+  void FindNewApplicationsRequest() {}
+  void SearchDeviceFailed(const SearchDeviceError&) {}
+  DeviceSptr FindDevice(const DeviceUID&) const { return DeviceSptr(); }
+  void ConnectionCreated(ConnectionSPtr, const DeviceUID&,
+                         const ApplicationHandle&) {}
+  void ConnectDone(const DeviceUID&, const ApplicationHandle&) {}
+  void ConnectFailed(const DeviceUID&, const ApplicationHandle&,
+                     const ConnectError&) {}
+  void ConnectionFinished(const DeviceUID&, const ApplicationHandle&) {}
+  void ConnectionAborted(const DeviceUID&, const ApplicationHandle&,
+                         const CommunicationError&) {}
+  void DeviceDisconnected(const DeviceUID&, const DisconnectDeviceError&) {}
+  void DisconnectDone(const DeviceUID&, const ApplicationHandle&) {
+    sync_primitives::AutoLock lock(lock_);
+    disconnect_done_ = true;
+  }
+  void DataReceiveDone(const DeviceUID&, const ApplicationHandle&,
+                       RawMessagePtr message) {
+    sync_primitives::AutoLock lock(lock_);
+    received_.insert(received_.end(), message->data(),
+                     message->data() + message->data_size());
+    // Keeps buffers alive, so new buffers get new addresses
+    messages_.push_back(message);
+  }
+  void DataReceiveFailed(const DeviceUID&, const ApplicationHandle&,
+                         const DataReceiveError&) {}
+  void DataSendDone(const DeviceUID&, const ApplicationHandle&,
+                    RawMessagePtr) {
+    sync_primitives::AutoLock lock(lock_);
+    ++send_done_count_;
+  }
+  void DataSendFailed(const DeviceUID&, const ApplicationHandle&,
+                      RawMessagePtr, const DataSendError&) {
+    sync_primitives::AutoLock lock(lock_);
+    ++send_failed_count_;
+  }
+
+  std::vector<uint8_t> received() {
+    sync_primitives::AutoLock lock(lock_);
+    return received_;
+  }
+  size_t received_size() {
+    sync_primitives::AutoLock lock(lock_);
+    return received_.size();
+  }
+  size_t received_messages_count() {
+    sync_primitives::AutoLock lock(lock_);
+    return messages_.size();
+  }
+  size_t send_done_count() {
+    sync_primitives::AutoLock lock(lock_);
+    return send_done_count_;
+  }
+  size_t send_failed_count() {
+    sync_primitives::AutoLock lock(lock_);
+    return send_failed_count_;
+  }
+  bool disconnect_done() {
+    sync_primitives::AutoLock lock(lock_);
+    return disconnect_done_;
+  }
+
+ private:
+  sync_primitives::Lock lock_;
+  std::vector<uint8_t> received_;
+  std::vector<RawMessagePtr> messages_;
+  size_t send_done_count_;
+  size_t send_failed_count_;
+  bool disconnect_done_;
+};
+
+/*
+ * Plays libusb event handling thread
+ */
+class EventThread {
+ public:
+  EventThread() : stop_(false), started_(false) {}
+  ~EventThread() {
+    Stop();
+  }
+  void Start() {
+    stop_ = false;
+    started_ = 0 == pthread_create(&thread_, NULL, &EventThread::Run, this);
+  }
+  void Stop() {
+    if (started_) {
+      stop_ = true;
+      pthread_join(thread_, NULL);
+      started_ = false;
+    }
+  }
+
+ private:
+  static void* Run(void* data) {
+    EventThread* self = static_cast<EventThread*>(data);
+    while (!self->stop_) {
+      fake_libusb::HandleEvents();
+      usleep(kRoundTripUs);
+    }
+    return NULL;
+  }
+  volatile bool stop_;
+  bool started_;
+  pthread_t thread_;
+};
+
+std::vector<uint8_t> CreateData(size_t size, uint8_t seed) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + seed);
+  }
+  return data;
+}
+
+RawMessagePtr CreateMessage(const std::vector<uint8_t>& data) {
+  return RawMessagePtr(new RawMessage(0, 0, &data[0], data.size()));
+}
+
+class UsbConnectionTest : public ::testing::Test {
+ protected:
+  UsbConnectionTest()
+    : device_(0, 0, libusb_device_descriptor(), NULL, NULL),
+      connection_(NULL) {}
+
+  void SetUp() {
+    fake_libusb::Reset(kMaxPacketSize);
+  }
+
+  void TearDown() {
+    // Transfers are cancelled by connection and completed by event thread
+    event_thread_.Start();
+    delete connection_;
+    event_thread_.Stop();
+  }
+
+  bool Connect(size_t in_transfers_count, size_t in_transfer_size,
+               size_t out_transfer_size) {
+    connection_ = new UsbConnection(kDevice, kApplication, &controller_,
+                                    UsbHandlerSptr(), &device_,
+                                    in_transfers_count, in_transfer_size,
+                                    out_transfer_size);
+    return connection_->Init();
+  }
+
+  bool WaitReceived(size_t size) {
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    while (controller_.received_size() < size) {
+      if (date_time::DateTime::calculateTimeSpan(start) > kWaitingTimeoutMs) {
+        return false;
+      }
+      usleep(1000);
+    }
+    return true;
+  }
+
+  bool WaitSent(size_t count) {
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    while (controller_.send_done_count() + controller_.send_failed_count() <
+           count) {
+      if (date_time::DateTime::calculateTimeSpan(start) > kWaitingTimeoutMs) {
+        return false;
+      }
+      usleep(1000);
+    }
+    return true;
+  }
+
+  PlatformUsbDevice device_;
+  RecordingController controller_;
+  EventThread event_thread_;
+  UsbConnection* connection_;
+};
+}  // namespace
+
+TEST_F(UsbConnectionTest, ReceivedDataKeepsOrder) {
+  ASSERT_TRUE(Connect(4u, 16 * 1024, 64 * 1024));
+  std::vector<uint8_t> written;
+  for (size_t i = 0; i < 300; ++i) {
+    const std::vector<uint8_t> data = CreateData((i * 997) % 40000 + 1, i);
+    fake_libusb::DeviceWrite(&data[0], data.size());
+    written.insert(written.end(), data.begin(), data.end());
+  }
+  event_thread_.Start();
+  ASSERT_TRUE(WaitReceived(written.size()));
+  event_thread_.Stop();
+  EXPECT_TRUE(written == controller_.received());
+}
+
+TEST_F(UsbConnectionTest, SmallReceivedData_CopiedAndBufferReused) {
+  const size_t kWritesCount = 10;
+  ASSERT_TRUE(Connect(1u, 16 * 1024, 64 * 1024));
+  std::vector<uint8_t> written;
+  for (size_t i = 0; i < kWritesCount; ++i) {
+    const std::vector<uint8_t> data = CreateData(100, i);
+    fake_libusb::DeviceWrite(&data[0], data.size());
+    written.insert(written.end(), data.begin(), data.end());
+  }
+  event_thread_.Start();
+  ASSERT_TRUE(WaitReceived(written.size()));
+  event_thread_.Stop();
+  EXPECT_TRUE(written == controller_.received());
+  EXPECT_EQ(kWritesCount, controller_.received_messages_count());
+  EXPECT_EQ(1u, fake_libusb::in_transfer_buffers_count());
+}
+
+TEST_F(UsbConnectionTest, BigReceivedData_BufferPassedWithoutCopy) {
+  const size_t kWritesCount = 10;
+  ASSERT_TRUE(Connect(1u, 16 * 1024, 64 * 1024));
+  std::vector<uint8_t> written;
+  for (size_t i = 0; i < kWritesCount; ++i) {
+    const std::vector<uint8_t> data = CreateData(8 * 1024, i);
+    fake_libusb::DeviceWrite(&data[0], data.size());
+    written.insert(written.end(), data.begin(), data.end());
+  }
+  event_thread_.Start();
+  ASSERT_TRUE(WaitReceived(written.size()));
+  event_thread_.Stop();
+  EXPECT_TRUE(written == controller_.received());
+  // Each received buffer is replaced by new one
+  EXPECT_EQ(kWritesCount + 1, fake_libusb::in_transfer_buffers_count());
+}
+
+TEST_F(UsbConnectionTest, QueuedMessagesAreCoalesced) {
+  const size_t kMessagesCount = 100;
+  ASSERT_TRUE(Connect(1u, kMaxPacketSize, 64 * 1024));
+  std::vector<uint8_t> sent;
+  for (size_t i = 0; i < kMessagesCount; ++i) {
+    const std::vector<uint8_t> data = CreateData(100, i);
+    EXPECT_EQ(TransportAdapter::OK,
+              static_cast<Connection*>(connection_)->SendData(
+                  CreateMessage(data)));
+    sent.insert(sent.end(), data.begin(), data.end());
+  }
+  event_thread_.Start();
+  ASSERT_TRUE(WaitSent(kMessagesCount));
+  event_thread_.Stop();
+  EXPECT_EQ(kMessagesCount, controller_.send_done_count());
+  // First message is posted at once, the rest waits for it
+  EXPECT_EQ(2u, fake_libusb::completed_out_transfers_count());
+  EXPECT_TRUE(sent == fake_libusb::device_received_data());
+}
+
+TEST_F(UsbConnectionTest, MessageBiggerThanTransferLimitIsSentAlone) {
+  ASSERT_TRUE(Connect(1u, kMaxPacketSize, 1024));
+  const std::vector<uint8_t> big = CreateData(3000, 1);
+  const std::vector<uint8_t> small = CreateData(10, 2);
+  Connection* connection = connection_;
+  EXPECT_EQ(TransportAdapter::OK, connection->SendData(CreateMessage(small)));
+  EXPECT_EQ(TransportAdapter::OK, connection->SendData(CreateMessage(big)));
+  EXPECT_EQ(TransportAdapter::OK, connection->SendData(CreateMessage(small)));
+  event_thread_.Start();
+  ASSERT_TRUE(WaitSent(3u));
+  event_thread_.Stop();
+  EXPECT_EQ(3u, controller_.send_done_count());
+  EXPECT_EQ(3u, fake_libusb::completed_out_transfers_count());
+  std::vector<uint8_t> sent(small);
+  sent.insert(sent.end(), big.begin(), big.end());
+  sent.insert(sent.end(), small.begin(), small.end());
+  EXPECT_TRUE(sent == fake_libusb::device_received_data());
+}
+
+TEST_F(UsbConnectionTest, Disconnect_QueuedMessagesFailed) {
+  ASSERT_TRUE(Connect(4u, 16 * 1024, 64 * 1024));
+  Connection* connection = connection_;
+  const std::vector<uint8_t> data = CreateData(100, 0);
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(TransportAdapter::OK, connection->SendData(CreateMessage(data)));
+  }
+  event_thread_.Start();
+  EXPECT_EQ(TransportAdapter::OK, connection->Disconnect());
+  event_thread_.Stop();
+  EXPECT_TRUE(controller_.disconnect_done());
+  EXPECT_EQ(3u, controller_.send_done_count() +
+                controller_.send_failed_count());
+  EXPECT_EQ(TransportAdapter::BAD_STATE,
+            connection->SendData(CreateMessage(data)));
+}
+
+TEST_F(UsbConnectionTest, DISABLED_Benchmark_InThroughput) {
+  const size_t kWriteSize = 16 * 1024;
+  const size_t kWritesCount = 128;
+  const struct {
+    size_t transfers_count;
+    size_t transfer_size;
+  } kConfigs[] = {{1u, kMaxPacketSize}, {4u, 16 * 1024}, {8u, 64 * 1024}};
+  const std::vector<uint8_t> data = CreateData(kWriteSize, 0);
+  for (size_t i = 0; i < ARRAYSIZE(kConfigs); ++i) {
+    fake_libusb::Reset(kMaxPacketSize);
+    RecordingController controller;
+    UsbConnection* connection = new UsbConnection(
+        kDevice, kApplication, &controller, UsbHandlerSptr(), &device_,
+        kConfigs[i].transfers_count, kConfigs[i].transfer_size, 64 * 1024);
+    ASSERT_TRUE(connection->Init());
+    for (size_t j = 0; j < kWritesCount; ++j) {
+      fake_libusb::DeviceWrite(&data[0], data.size());
+    }
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    event_thread_.Start();
+    while (controller.received_size() < kWriteSize * kWritesCount &&
+           date_time::DateTime::calculateTimeSpan(start) < kWaitingTimeoutMs) {
+      usleep(1000);
+    }
+    const int64_t duration_ms = date_time::DateTime::calculateTimeSpan(start);
+    EXPECT_EQ(kWriteSize * kWritesCount, controller.received_size());
+    printf("%u IN transfer(s) of %u bytes: %u KB received by %u transfers "
+           "in %lld ms\n",
+           static_cast<unsigned>(kConfigs[i].transfers_count),
+           static_cast<unsigned>(kConfigs[i].transfer_size),
+           static_cast<unsigned>(kWriteSize * kWritesCount / 1024),
+           static_cast<unsigned>(fake_libusb::completed_in_transfers_count()),
+           static_cast<long long>(duration_ms));
+    delete connection;
+    event_thread_.Stop();
+  }
+}
+
+TEST_F(UsbConnectionTest, DISABLED_Benchmark_OutThroughput) {
+  const size_t kMessageSize = 1000;
+  const size_t kMessagesCount = 2000;
+  // Zero limit sends every message by own transfer as before
+  const size_t kOutTransferSizes[] = {0u, 16 * 1024, 64 * 1024};
+  const std::vector<uint8_t> data = CreateData(kMessageSize, 0);
+  for (size_t i = 0; i < ARRAYSIZE(kOutTransferSizes); ++i) {
+    fake_libusb::Reset(kMaxPacketSize);
+    RecordingController controller;
+    UsbConnection* connection = new UsbConnection(
+        kDevice, kApplication, &controller, UsbHandlerSptr(), &device_,
+        1u, kMaxPacketSize, kOutTransferSizes[i]);
+    ASSERT_TRUE(connection->Init());
+    const TimevalStruct start = date_time::DateTime::getCurrentTime();
+    event_thread_.Start();
+    for (size_t j = 0; j < kMessagesCount; ++j) {
+      static_cast<Connection*>(connection)->SendData(CreateMessage(data));
+    }
+    while (controller.send_done_count() < kMessagesCount &&
+           date_time::DateTime::calculateTimeSpan(start) < kWaitingTimeoutMs) {
+      usleep(1000);
+    }
+    const int64_t duration_ms = date_time::DateTime::calculateTimeSpan(start);
+    EXPECT_EQ(kMessagesCount, controller.send_done_count());
+    printf("OUT transfer limit %u bytes: %u messages sent by %u transfers "
+           "in %lld ms\n",
+           static_cast<unsigned>(kOutTransferSizes[i]),
+           static_cast<unsigned>(kMessagesCount),
+           static_cast<unsigned>(fake_libusb::completed_out_transfers_count()),
+           static_cast<long long>(duration_ms));
+    delete connection;
+    event_thread_.Stop();
+  }
+}
+
+}  // namespace transport_manager_test
+}  // namespace components
+}  // namespace test
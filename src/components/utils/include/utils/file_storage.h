@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SRC_COMPONENTS_UTILS_INCLUDE_UTILS_FILE_STORAGE_H_
+#define SRC_COMPONENTS_UTILS_INCLUDE_UTILS_FILE_STORAGE_H_
+
+#include <stdint.h>
+#include <time.h>
+#include <list>
+#include <map>
+#include <string>
+
+#include "utils/lock.h"
+#include "utils/macro.h"
+
+namespace file_system {
+
+/**
+ * @brief Writes files received in chunks with offset.
+ *
+ * Descriptors of recently written files stay open, so the next chunk of a
+ * file is written with a single pwrite at its offset instead of opening
+ * and closing a stream per chunk. A descriptor of a file removed from
+ * disk meanwhile is detected and reopened.
+ */
+class ChunkedFileWriter {
+ public:
+  enum WriteResult {
+    kWriteSuccess,
+    // Offset of chunk is not equal to current size of file
+    kWriteOffsetMismatch,
+    kWriteFailed
+  };
+
+  /**
+   * @param max_open_files count of descriptors kept open,
+   * the least recently written file is closed first
+   */
+  explicit ChunkedFileWriter(size_t max_open_files);
+  ~ChunkedFileWriter();
+
+  /**
+   * @brief Writes chunk of file
+   * @param file_path path to file, it is created if it doesn't exist
+   * @param data chunk to write
+   * @param data_size size of chunk
+   * @param offset position of chunk in file: 0 rewrites the file,
+   * otherwise it must be equal to current file size
+   * @param size_delta returns the change of file size in bytes
+   * @return kWriteSuccess if the whole chunk was written
+   */
+  WriteResult Write(const std::string& file_path,
+                    const uint8_t* data,
+                    size_t data_size,
+                    int64_t offset,
+                    int64_t* size_delta);
+
+  /**
+   * @brief Closes descriptor of file if it is open,
+   * should be called before file is deleted
+   */
+  void Close(const std::string& file_path);
+
+  /**
+   * @brief Count of currently open descriptors
+   */
+  size_t open_files_count() const;
+
+ private:
+  struct OpenFile {
+    int fd;
+    std::list<std::string>::iterator lru_position;
+  };
+  typedef std::map<std::string, OpenFile> OpenFiles;
+
+  /**
+   * @brief Returns descriptor of file and its current size
+   * @param create whether missing file has to be created
+   * @return -1 if file could not be opened
+   */
+  int Acquire(const std::string& file_path, bool create, int64_t* size);
+  void CloseFile(OpenFiles::iterator it);
+
+  const size_t max_open_files_;
+  OpenFiles open_files_;
+  // Most recently written files are at the front
+  std::list<std::string> lru_;
+  mutable sync_primitives::Lock lock_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkedFileWriter);
+};
+
+/**
+ * @brief Keeps sizes of directories to avoid walking them on each request.
+ *
+ * Cached size is changed by owner on each write to existing file
+ * through Update(). The size is counted again if the directory
+ * modification time shows that files were created or deleted, by owner
+ * or by someone else. Rewrite of existing file does not change the
+ * directory modification time, so only rewrites reported through
+ * Update() are accounted. Changes in subdirectories must be reported
+ * through Update() too.
+ */
+class DirectorySizeCache {
+ public:
+  DirectorySizeCache();
+
+  /**
+   * @brief Size of all files in directory
+   * @return 0 if directory doesn't exist
+   */
+  uint64_t Size(const std::string& path);
+
+  /**
+   * @brief Changes cached size of directory after its file was written
+   * or deleted, nothing is done if directory size is not cached yet.
+   * Cached size is dropped if directory was modified since it was counted.
+   * @param path directory of the changed file
+   * @param size_delta change of file size in bytes
+   */
+  void Update(const std::string& path, int64_t size_delta);
+
+ private:
+  struct Entry {
+    uint64_t size;
+    struct timespec modification_time;
+  };
+  typedef std::map<std::string, Entry> Entries;
+
+  Entries entries_;
+  sync_primitives::Lock lock_;
+
+  DISALLOW_COPY_AND_ASSIGN(DirectorySizeCache);
+};
+
+}  // namespace file_system
+
+#endif  // SRC_COMPONENTS_UTILS_INCLUDE_UTILS_FILE_STORAGE_H_
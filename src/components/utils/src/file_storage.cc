@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "utils/file_storage.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "utils/file_system.h"
+#include "utils/logger.h"
+
+CREATE_LOGGERPTR_GLOBAL(logger_, "Utils")
+
+namespace {
+// Mode of created files, same as of files created by std::ofstream
+const mode_t kCreatedFileMode = S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP |
+                                S_IROTH | S_IWOTH;
+
+bool WriteAll(int fd, const uint8_t* data, size_t data_size, int64_t offset,
+              size_t* written) {
+  *written = 0;
+  while (*written < data_size) {
+    const ssize_t result = pwrite(fd, data + *written, data_size - *written,
+                                  offset + *written);
+    if (result < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return false;
+    }
+    *written += result;
+  }
+  return true;
+}
+
+struct timespec ModificationTime(const struct stat& status) {
+#ifdef __QNXNTO__
+  struct timespec time = { status.st_mtime, 0 };
+  return time;
+#else
+  return status.st_mtim;
+#endif
+}
+
+bool operator==(const struct timespec& lhs, const struct timespec& rhs) {
+  return lhs.tv_sec == rhs.tv_sec && lhs.tv_nsec == rhs.tv_nsec;
+}
+}  // namespace
+
+namespace file_system {
+
+ChunkedFileWriter::ChunkedFileWriter(size_t max_open_files)
+  : max_open_files_(max_open_files > 0 ? max_open_files : 1) {
+}
+
+ChunkedFileWriter::~ChunkedFileWriter() {
+  sync_primitives::AutoLock lock(lock_);
+  while (!open_files_.empty()) {
+    CloseFile(open_files_.begin());
+  }
+}
+
+ChunkedFileWriter::WriteResult ChunkedFileWriter::Write(
+    const std::string& file_path, const uint8_t* data, size_t data_size,
+    int64_t offset, int64_t* size_delta) {
+  DCHECK(size_delta);
+  *size_delta = 0;
+  sync_primitives::AutoLock lock(lock_);
+  int64_t file_size = 0;
+  // Chunk with offset continues existing file, so it is never created
+  const int fd = Acquire(file_path, 0 == offset, &file_size);
+  if (0 != offset && file_size != offset) {
+    LOG4CXX_WARN(logger_, "Offset " << offset << " doesn't match size "
+                 << file_size << " of " << file_path);
+    return kWriteOffsetMismatch;
+  }
+  if (-1 == fd) {
+    return kWriteFailed;
+  }
+  if (0 == offset && file_size > 0) {
+    if (0 != ftruncate(fd, 0)) {
+      LOG4CXX_ERROR(logger_, "Can't truncate " << file_path);
+      return kWriteFailed;
+    }
+    *size_delta = -file_size;
+  }
+  size_t written = 0;
+  const bool success = WriteAll(fd, data, data_size, offset, &written);
+  *size_delta += written;
+  if (!success) {
+    LOG4CXX_ERROR(logger_, "Can't write " << data_size << " bytes to "
+                  << file_path << ", errno " << errno);
+    CloseFile(open_files_.find(file_path));
+    return kWriteFailed;
+  }
+  return kWriteSuccess;
+}
+
+void ChunkedFileWriter::Close(const std::string& file_path) {
+  sync_primitives::AutoLock lock(lock_);
+  const OpenFiles::iterator it = open_files_.find(file_path);
+  if (open_files_.end() != it) {
+    CloseFile(it);
+  }
+}
+
+size_t ChunkedFileWriter::open_files_count() const {
+  sync_primitives::AutoLock lock(lock_);
+  return open_files_.size();
+}
+
+int ChunkedFileWriter::Acquire(const std::string& file_path, bool create,
+                               int64_t* size) {
+  *size = 0;
+  struct stat status;
+  OpenFiles::iterator it = open_files_.find(file_path);
+  if (open_files_.end() != it) {
+    // Descriptor of deleted file would write to unreachable data
+    if (0 == fstat(it->second.fd, &status) && status.st_nlink > 0) {
+      lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+      *size = status.st_size;
+      return it->second.fd;
+    }
+    CloseFile(it);
+  }
+
+  const int flags = O_WRONLY | (create ? O_CREAT : 0);
+  const int fd = open(file_path.c_str(), flags, kCreatedFileMode);
+  if (-1 == fd) {
+    if (ENOENT != errno || create) {
+      LOG4CXX_ERROR(logger_, "Can't open " << file_path << ", errno "
+                    << errno);
+    }
+    return -1;
+  }
+  if (0 != fstat(fd, &status)) {
+    close(fd);
+    return -1;
+  }
+  *size = status.st_size;
+
+  if (open_files_.size() >= max_open_files_) {
+    CloseFile(open_files_.find(lru_.back()));
+  }
+  lru_.push_front(file_path);
+  OpenFile& open_file = open_files_[file_path];
+  open_file.fd = fd;
+  open_file.lru_position = lru_.begin();
+  return fd;
+}
+
+void ChunkedFileWriter::CloseFile(OpenFiles::iterator it) {
+  DCHECK_OR_RETURN_VOID(open_files_.end() != it);
+  close(it->second.fd);
+  lru_.erase(it->second.lru_position);
+  open_files_.erase(it);
+}
+
+DirectorySizeCache::DirectorySizeCache() {
+}
+
+uint64_t DirectorySizeCache::Size(const std::string& path) {
+  sync_primitives::AutoLock lock(lock_);
+  struct stat status;
+  if (0 != stat(path.c_str(), &status) || !S_ISDIR(status.st_mode)) {
+    entries_.erase(path);
+    return 0;
+  }
+  const struct timespec modification_time = ModificationTime(status);
+  Entries::iterator it = entries_.find(path);
+  if (entries_.end() != it &&
+      it->second.modification_time == modification_time) {
+    return it->second.size;
+  }
+  LOG4CXX_DEBUG(logger_, "Counting size of " << path);
+  Entry& entry = entries_[path];
+  entry.size = DirectorySize(path);
+  entry.modification_time = modification_time;
+  return entry.size;
+}
+
+void DirectorySizeCache::Update(const std::string& path, int64_t size_delta) {
+  sync_primitives::AutoLock lock(lock_);
+  Entries::iterator it = entries_.find(path);
+  if (entries_.end() == it) {
+    return;
+  }
+  struct stat status;
+  if (0 != stat(path.c_str(), &status)) {
+    entries_.erase(it);
+    return;
+  }
+  // Creation or deletion of a file, by owner or by someone else, changes
+  // modification time, directory is counted again on next request
+  if (!(it->second.modification_time == ModificationTime(status))) {
+    LOG4CXX_DEBUG(logger_, "Size of " << path << " is invalidated");
+    entries_.erase(it);
+    return;
+  }
+  if (size_delta < 0 &&
+      static_cast<uint64_t>(-size_delta) > it->second.size) {
+    it->second.size = 0;
+  } else {
+    it->second.size += size_delta;
+  }
+}
+
+}  // namespace file_system
@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "utils/memory_pool.h"
+
+#include <pthread.h>
+
+#include "utils/atomic.h"
+#include "utils/lock.h"
+#include "utils/macro.h"
+
+namespace utils {
+
+namespace {
+
+const size_t kBlockSizes[] = {64, 256, 1536, 4096, 65536, 1048576};
+const size_t kSizeClassesCount = ARRAYSIZE(kBlockSizes);
+// Maximum count of free blocks kept by one thread per size class
+const uint32_t kThreadCacheLimits[kSizeClassesCount] = {256, 128, 64,
+                                                        32, 4, 1};
+// Maximum count of free blocks kept in shared list per size class
+const uint32_t kSharedListLimits[kSizeClassesCount] = {4096, 2048, 1024,
+                                                       256, 32, 4};
+
+// Objects are pooled by their size rounded up to the alignment, so they
+// are not rounded up to size classes. Bigger objects are served by classes.
+const size_t kObjectAlignment = 16;
+const size_t kObjectClassesCount = 64;
+const uint32_t kObjectThreadCacheLimit = 64;
+const uint32_t kObjectSharedListLimit = 512;
+
+// Precedes every block handed out, keeps user data 16-byte aligned
+union BlockHeader {
+  uint32_t size_class;
+  uint8_t alignment[16];
+};
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct FreeList {
+  FreeList() : head(NULL), count(0) {}
+  FreeBlock* head;
+  uint32_t count;
+
+  void Push(FreeBlock* block) {
+    block->next = head;
+    head = block;
+    ++count;
+  }
+
+  FreeBlock* Pop() {
+    FreeBlock* block = head;
+    if (block) {
+      head = block->next;
+      --count;
+    }
+    return block;
+  }
+};
+
+struct SharedList {
+  sync_primitives::Lock lock;
+  FreeList blocks;
+};
+
+struct ThreadCache {
+  FreeList lists[kSizeClassesCount];
+  FreeList object_lists[kObjectClassesCount];
+};
+
+struct Counters {
+  uint32_t allocations;
+  uint32_t thread_cache_hits;
+  uint32_t shared_hits;
+  uint32_t system_allocations;
+  uint32_t releases;
+};
+
+// Shared lists are never destroyed: blocks may be released by
+// threads still running during static destruction
+SharedList* shared_lists = NULL;
+SharedList* shared_object_lists = NULL;
+// Last item holds counters of requests bypassing the pool
+Counters counters[kSizeClassesCount + 1];
+Counters object_counters[kObjectClassesCount];
+pthread_key_t thread_cache_key;
+pthread_once_t init_once = PTHREAD_ONCE_INIT;
+
+void DeleteBlock(FreeBlock* block) {
+  delete[] reinterpret_cast<uint8_t*>(block);
+}
+
+// Moves up to count blocks to shared list, the rest is given back to
+// the system
+void FlushToShared(SharedList* shared, uint32_t shared_limit,
+                   FreeList* list, uint32_t count) {
+  sync_primitives::AutoLock auto_lock(shared->lock);
+  for (uint32_t i = 0; i < count; ++i) {
+    FreeBlock* block = list->Pop();
+    if (!block) {
+      break;
+    }
+    if (shared->blocks.count < shared_limit) {
+      shared->blocks.Push(block);
+    } else {
+      DeleteBlock(block);
+    }
+  }
+}
+
+void FlushToShared(size_t size_class, FreeList* list, uint32_t count) {
+  FlushToShared(&shared_lists[size_class], kSharedListLimits[size_class],
+                list, count);
+}
+
+void FlushObjectsToShared(size_t object_class, FreeList* list,
+                          uint32_t count) {
+  FlushToShared(&shared_object_lists[object_class], kObjectSharedListLimit,
+                list, count);
+}
+
+void DestroyThreadCache(void* value) {
+  ThreadCache* cache = static_cast<ThreadCache*>(value);
+  for (size_t i = 0; i < kSizeClassesCount; ++i) {
+    FlushToShared(i, &cache->lists[i], cache->lists[i].count);
+  }
+  for (size_t i = 0; i < kObjectClassesCount; ++i) {
+    FlushObjectsToShared(i, &cache->object_lists[i],
+                         cache->object_lists[i].count);
+  }
+  delete cache;
+}
+
+void InitPool() {
+  shared_lists = new SharedList[kSizeClassesCount];
+  shared_object_lists = new SharedList[kObjectClassesCount];
+  pthread_key_create(&thread_cache_key, &DestroyThreadCache);
+}
+
+ThreadCache* GetThreadCache() {
+  pthread_once(&init_once, &InitPool);
+  ThreadCache* cache =
+      static_cast<ThreadCache*>(pthread_getspecific(thread_cache_key));
+  if (!cache) {
+    cache = new (std::nothrow) ThreadCache();
+    if (cache && 0 != pthread_setspecific(thread_cache_key, cache)) {
+      delete cache;
+      cache = NULL;
+    }
+  }
+  return cache;
+}
+
+void* ToUserBlock(void* raw, uint32_t size_class) {
+  BlockHeader* header = static_cast<BlockHeader*>(raw);
+  header->size_class = size_class;
+  return header + 1;
+}
+
+void* AllocateFromSystem(size_t size, uint32_t size_class) {
+  uint8_t* raw = new (std::nothrow) uint8_t[sizeof(BlockHeader) + size];
+  if (!raw) {
+    return NULL;
+  }
+  atomic_post_inc(&counters[size_class].system_allocations);
+  return ToUserBlock(raw, size_class);
+}
+
+// Takes block from thread cache list, refilling it from shared list,
+// NULL if both are empty
+FreeBlock* TakeBlock(FreeList* list, SharedList* shared, uint32_t batch,
+                     Counters* block_counters) {
+  FreeBlock* block = list->Pop();
+  if (block) {
+    atomic_post_inc(&block_counters->thread_cache_hits);
+    return block;
+  }
+
+  {
+    // Refill cache by batch to take shared lock once per several blocks
+    sync_primitives::AutoLock auto_lock(shared->lock);
+    for (uint32_t i = 0; i < batch; ++i) {
+      FreeBlock* shared_block = shared->blocks.Pop();
+      if (!shared_block) {
+        break;
+      }
+      list->Push(shared_block);
+    }
+  }
+  block = list->Pop();
+  if (block) {
+    atomic_post_inc(&block_counters->shared_hits);
+  }
+  return block;
+}
+
+size_t ObjectClassOf(size_t size) {
+  return 0 == size ? 0 : (size - 1) / kObjectAlignment;
+}
+
+void CopyCounters(const Counters& from, MemoryPool::Statistics* to) {
+  to->allocations = from.allocations;
+  to->thread_cache_hits = from.thread_cache_hits;
+  to->shared_hits = from.shared_hits;
+  to->system_allocations = from.system_allocations;
+  to->releases = from.releases;
+}
+
+}  // namespace
+
+MemoryPool::Statistics::Statistics()
+    : allocations(0)
+    , thread_cache_hits(0)
+    , shared_hits(0)
+    , system_allocations(0)
+    , releases(0) {}
+
+double MemoryPool::Statistics::hit_rate() const {
+  if (0 == allocations) {
+    return 0.0;
+  }
+  return static_cast<double>(thread_cache_hits + shared_hits) / allocations;
+}
+
+void* MemoryPool::Allocate(size_t size) {
+  uint32_t size_class = 0;
+  while (size_class < kSizeClassesCount && kBlockSizes[size_class] < size) {
+    ++size_class;
+  }
+  atomic_post_inc(&counters[size_class].allocations);
+  if (kSizeClassesCount == size_class) {
+    return AllocateFromSystem(size, size_class);
+  }
+
+  ThreadCache* cache = GetThreadCache();
+  if (!cache) {
+    return AllocateFromSystem(kBlockSizes[size_class], size_class);
+  }
+  FreeBlock* block = TakeBlock(&cache->lists[size_class],
+                               &shared_lists[size_class],
+                               kThreadCacheLimits[size_class] / 2 + 1,
+                               &counters[size_class]);
+  if (block) {
+    return ToUserBlock(block, size_class);
+  }
+  return AllocateFromSystem(kBlockSizes[size_class], size_class);
+}
+
+void MemoryPool::Release(void* block) {
+  if (!block) {
+    return;
+  }
+  BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+  const uint32_t size_class = header->size_class;
+  atomic_post_inc(&counters[size_class].releases);
+  FreeBlock* free_block = reinterpret_cast<FreeBlock*>(header);
+  if (kSizeClassesCount == size_class) {
+    DeleteBlock(free_block);
+    return;
+  }
+
+  ThreadCache* cache = GetThreadCache();
+  if (!cache) {
+    FreeList list;
+    list.Push(free_block);
+    FlushToShared(size_class, &list, 1);
+    return;
+  }
+  FreeList& list = cache->lists[size_class];
+  list.Push(free_block);
+  if (list.count > kThreadCacheLimits[size_class]) {
+    FlushToShared(size_class, &list, list.count / 2 + 1);
+  }
+}
+
+void* MemoryPool::AllocateObject(size_t size) {
+  const size_t object_class = ObjectClassOf(size);
+  if (kObjectClassesCount <= object_class) {
+    return Allocate(size);
+  }
+  Counters& object_class_counters = object_counters[object_class];
+  atomic_post_inc(&object_class_counters.allocations);
+
+  ThreadCache* cache = GetThreadCache();
+  if (cache) {
+    FreeBlock* block = TakeBlock(&cache->object_lists[object_class],
+                                 &shared_object_lists[object_class],
+                                 kObjectThreadCacheLimit / 2 + 1,
+                                 &object_class_counters);
+    if (block) {
+      return block;
+    }
+  }
+  // Object blocks have no header, size is given back on release
+  void* object = new (std::nothrow)
+      uint8_t[(object_class + 1) * kObjectAlignment];
+  if (object) {
+    atomic_post_inc(&object_class_counters.system_allocations);
+  }
+  return object;
+}
+
+void MemoryPool::ReleaseObject(void* object, size_t size) {
+  if (!object) {
+    return;
+  }
+  const size_t object_class = ObjectClassOf(size);
+  if (kObjectClassesCount <= object_class) {
+    Release(object);
+    return;
+  }
+  atomic_post_inc(&object_counters[object_class].releases);
+  FreeBlock* free_block = static_cast<FreeBlock*>(object);
+
+  ThreadCache* cache = GetThreadCache();
+  if (!cache) {
+    FreeList list;
+    list.Push(free_block);
+    FlushObjectsToShared(object_class, &list, 1);
+    return;
+  }
+  FreeList& list = cache->object_lists[object_class];
+  list.Push(free_block);
+  if (list.count > kObjectThreadCacheLimit) {
+    FlushObjectsToShared(object_class, &list, list.count / 2 + 1);
+  }
+}
+
+size_t MemoryPool::size_classes_count() {
+  return kSizeClassesCount;
+}
+
+size_t MemoryPool::class_block_size(size_t size_class) {
+  DCHECK_OR_RETURN(size_class < kSizeClassesCount, 0);
+  return kBlockSizes[size_class];
+}
+
+MemoryPool::Statistics MemoryPool::statistics(size_t size_class) {
+  Statistics result;
+  DCHECK_OR_RETURN(size_class < kSizeClassesCount, result);
+  CopyCounters(counters[size_class], &result);
+  return result;
+}
+
+MemoryPool::Statistics MemoryPool::oversized_statistics() {
+  Statistics result;
+  CopyCounters(counters[kSizeClassesCount], &result);
+  return result;
+}
+
+size_t MemoryPool::object_classes_count() {
+  return kObjectClassesCount;
+}
+
+size_t MemoryPool::object_class_size(size_t object_class) {
+  DCHECK_OR_RETURN(object_class < kObjectClassesCount, 0);
+  return (object_class + 1) * kObjectAlignment;
+}
+
+MemoryPool::Statistics MemoryPool::object_statistics(size_t object_class) {
+  Statistics result;
+  DCHECK_OR_RETURN(object_class < kObjectClassesCount, result);
+  CopyCounters(object_counters[object_class], &result);
+  return result;
+}
+
+void* PooledObject::operator new(size_t size) {
+  void* object = MemoryPool::Allocate(size);
+  if (!object) {
+    throw std::bad_alloc();
+  }
+  return object;
+}
+
+void* PooledObject::operator new(size_t size,
+                                 const std::nothrow_t&) throw() {
+  return MemoryPool::Allocate(size);
+}
+
+void PooledObject::operator delete(void* object) {
+  MemoryPool::Release(object);
+}
+
+void PooledObject::operator delete(void* object,
+                                   const std::nothrow_t&) throw() {
+  MemoryPool::Release(object);
+}
+
+void* SizedPooledObject::operator new(size_t size) {
+  void* object = MemoryPool::AllocateObject(size);
+  if (!object) {
+    throw std::bad_alloc();
+  }
+  return object;
+}
+
+void SizedPooledObject::operator delete(void* object, size_t size) {
+  MemoryPool::ReleaseObject(object, size);
+}
+
+}  // namespace utils
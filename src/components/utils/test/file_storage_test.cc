@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sys/time.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/file_storage.h"
+#include "utils/file_system.h"
+
+namespace test {
+namespace components {
+namespace utils {
+
+using ::file_system::ChunkedFileWriter;
+using ::file_system::DirectorySizeCache;
+
+namespace {
+const std::string kStorage = "./file_storage_test";
+
+std::string FilePath(size_t index) {
+  std::stringstream path;
+  path << kStorage << "/file_" << index;
+  return path.str();
+}
+
+std::vector<uint8_t> ReadFile(const std::string& path) {
+  std::vector<uint8_t> content;
+  ::file_system::ReadBinaryFile(path, content);
+  return content;
+}
+
+void SetOldModificationTime(const std::string& path) {
+  struct timeval times[2] = {{0, 0}, {0, 0}};
+  ASSERT_EQ(0, utimes(path.c_str(), times));
+}
+
+class FileStorageTest : public ::testing::Test {
+ protected:
+  void SetUp() OVERRIDE {
+    ::file_system::RemoveDirectory(kStorage, true);
+    ASSERT_TRUE(::file_system::CreateDirectoryRecursively(kStorage));
+  }
+  void TearDown() OVERRIDE {
+    ::file_system::RemoveDirectory(kStorage, true);
+  }
+};
+}  // namespace
+
+TEST_F(FileStorageTest, Write_ZeroOffset_FileCreatedAndRewritten) {
+  ChunkedFileWriter writer(4u);
+  const std::vector<uint8_t> data(100, 0x11);
+  int64_t size_delta = 0;
+  EXPECT_EQ(ChunkedFileWriter::kWriteSuccess,
+            writer.Write(FilePath(0), &data[0], data.size(), 0, &size_delta));
+  EXPECT_EQ(100, size_delta);
+  EXPECT_EQ(data, ReadFile(FilePath(0)));
+
+  const std::vector<uint8_t> new_data(40, 0x22);
+  EXPECT_EQ(ChunkedFileWriter::kWriteSuccess,
+            writer.Write(FilePath(0), &new_data[0], new_data.size(), 0,
+                         &size_delta));
+  EXPECT_EQ(-60, size_delta);
+  EXPECT_EQ(new_data, ReadFile(FilePath(0)));
+}
+
+TEST_F(FileStorageTest, Write_ChunksWithOffset_FileAppended) {
+  ChunkedFileWriter writer(4u);
+  std::vector<uint8_t> expected;
+  int64_t size_delta = 0;
+  for (uint8_t chunk = 0; chunk < 3; ++chunk) {
+    const std::vector<uint8_t> data(10, chunk);
+    EXPECT_EQ(ChunkedFileWriter::kWriteSuccess,
+              writer.Write(FilePath(0), &data[0], data.size(),
+                           expected.size(), &size_delta));
+    EXPECT_EQ(10, size_delta);
+    expected.insert(expected.end(), data.begin(), data.end());
+  }
+  EXPECT_EQ(expected, ReadFile(FilePath(0)));
+  EXPECT_EQ(1u, writer.open_files_count());
+}
+
+TEST_F(FileStorageTest, Write_WrongOffset_OffsetMismatch) {
+  ChunkedFileWriter writer(4u);
+  const std::vector<uint8_t> data(10, 0x33);
+  int64_t size_delta = 0;
+  EXPECT_EQ(ChunkedFileWriter::kWriteOffsetMismatch,
+            writer.Write(FilePath(0), &data[0], data.size(), 5, &size_delta));
+  EXPECT_FALSE(::file_system::FileExists(FilePath(0)));
+
+  writer.Write(FilePath(0), &data[0], data.size(), 0, &size_delta);
+  EXPECT_EQ(ChunkedFileWriter::kWriteOffsetMismatch,
+            writer.Write(FilePath(0), &data[0], data.size(), 5, &size_delta));
+  EXPECT_EQ(0, size_delta);
+  EXPECT_EQ(data, ReadFile(FilePath(0)));
+}
+
+TEST_F(FileStorageTest, Write_OpenFileDeleted_FileReopened) {
+  ChunkedFileWriter writer(4u);
+  const std::vector<uint8_t> data(10, 0x44);
+  int64_t size_delta = 0;
+  writer.Write(FilePath(0), &data[0], data.size(), 0, &size_delta);
+  ASSERT_TRUE(::file_system::DeleteFile(FilePath(0)));
+
+  // Next chunk of deleted file is not written to its old descriptor
+  EXPECT_EQ(ChunkedFileWriter::kWriteOffsetMismatch,
+            writer.Write(FilePath(0), &data[0], data.size(), data.size(),
+                         &size_delta));
+  EXPECT_EQ(ChunkedFileWriter::kWriteSuccess,
+            writer.Write(FilePath(0), &data[0], data.size(), 0, &size_delta));
+  EXPECT_EQ(10, size_delta);
+  EXPECT_EQ(data, ReadFile(FilePath(0)));
+}
+
+TEST_F(FileStorageTest, Write_ManyFiles_OpenFilesLimited) {
+  ChunkedFileWriter writer(3u);
+  const std::vector<uint8_t> data(10, 0x55);
+  int64_t size_delta = 0;
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(ChunkedFileWriter::kWriteSuccess,
+              writer.Write(FilePath(i), &data[0], data.size(), 0,
+                           &size_delta));
+  }
+  EXPECT_EQ(3u, writer.open_files_count());
+  writer.Close(FilePath(9));
+  EXPECT_EQ(2u, writer.open_files_count());
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(data, ReadFile(FilePath(i)));
+  }
+}
+
+TEST_F(FileStorageTest, DirectorySize_UpdatedAndExternalChangeDetected) {
+  DirectorySizeCache cache;
+  EXPECT_EQ(0u, cache.Size(kStorage + "/missing"));
+  EXPECT_EQ(0u, cache.Size(kStorage));
+
+  ChunkedFileWriter writer(4u);
+  const std::vector<uint8_t> data(100, 0x66);
+  int64_t size_delta = 0;
+  writer.Write(FilePath(0), &data[0], data.size(), 0, &size_delta);
+  cache.Update(kStorage, size_delta);
+  EXPECT_EQ(100u, cache.Size(kStorage));
+
+  // Modification time could be not changed within a clock tick
+  SetOldModificationTime(kStorage);
+  EXPECT_EQ(100u, cache.Size(kStorage));
+  ASSERT_TRUE(::file_system::Write(FilePath(1), data));
+  EXPECT_EQ(200u, cache.Size(kStorage));
+
+  SetOldModificationTime(kStorage);
+  EXPECT_EQ(200u, cache.Size(kStorage));
+  ASSERT_TRUE(::file_system::DeleteFile(FilePath(0)));
+  EXPECT_EQ(100u, cache.Size(kStorage));
+}
+
+TEST_F(FileStorageTest, DirectorySize_ExternalChangeBeforeUpdate_Detected) {
+  DirectorySizeCache cache;
+  ChunkedFileWriter writer(4u);
+  const std::vector<uint8_t> data(100, 0x66);
+  int64_t size_delta = 0;
+  writer.Write(FilePath(0), &data[0], data.size(), 0, &size_delta);
+  SetOldModificationTime(kStorage);
+  EXPECT_EQ(100u, cache.Size(kStorage));
+
+  // File created by someone else is not hidden by own append
+  ASSERT_TRUE(::file_system::Write(FilePath(1), data));
+  writer.Write(FilePath(0), &data[0], data.size(), data.size(), &size_delta);
+  cache.Update(kStorage, size_delta);
+  EXPECT_EQ(300u, cache.Size(kStorage));
+}
+
+TEST_F(FileStorageTest, DirectorySize_PutFileChunks_EqualsDirectoryWalk) {
+  const size_t kExistingFiles = 20;
+  const size_t kPutFiles = 10;
+  const size_t kChunksPerFile = 4;
+  const std::vector<uint8_t> existing(1024, 0x77);
+  for (size_t i = 0; i < kExistingFiles; ++i) {
+    ASSERT_TRUE(::file_system::Write(FilePath(i), existing));
+  }
+  const std::vector<uint8_t> chunk(8 * 1024, 0x88);
+
+  // Quota check and write of each chunk, as done by PutFile
+  DirectorySizeCache cache;
+  ChunkedFileWriter writer(8u);
+  for (size_t file = 0; file < kPutFiles; ++file) {
+    const std::string path = FilePath(kExistingFiles + file);
+    for (size_t i = 0; i < kChunksPerFile; ++i) {
+      ASSERT_EQ(::file_system::DirectorySize(kStorage), cache.Size(kStorage));
+      int64_t size_delta = 0;
+      ASSERT_EQ(ChunkedFileWriter::kWriteSuccess,
+                writer.Write(path, &chunk[0], chunk.size(), i * chunk.size(),
+                             &size_delta));
+      cache.Update(kStorage, size_delta);
+    }
+  }
+  EXPECT_EQ(kExistingFiles * existing.size() +
+            kPutFiles * kChunksPerFile * chunk.size(),
+            cache.Size(kStorage));
+}
+
+}  // namespace utils
+}  // namespace components
+}  // namespace test
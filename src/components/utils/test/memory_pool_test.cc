@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/memory_pool.h"
+#include "utils/date_time.h"
+
+namespace test {
+namespace components {
+namespace utils {
+
+using ::utils::MemoryPool;
+
+namespace {
+
+const size_t kPacketSize = 1500;
+
+struct PooledPacket : public ::utils::PooledObject {
+  uint8_t header[12];
+  uint32_t size;
+};
+
+class SizedBase : public ::utils::SizedPooledObject {
+ public:
+  virtual ~SizedBase() {}
+};
+
+class SizedDerived : public SizedBase {
+ public:
+  uint8_t payload[200];
+};
+
+void* ReleaseBlocks(void* data) {
+  std::vector<void*>* blocks = static_cast<std::vector<void*>*>(data);
+  for (size_t i = 0; i < blocks->size(); ++i) {
+    MemoryPool::Release((*blocks)[i]);
+  }
+  return NULL;
+}
+
+size_t ObjectClassOf(size_t size) {
+  size_t object_class = 0;
+  while (MemoryPool::object_class_size(object_class) < size) {
+    ++object_class;
+  }
+  return object_class;
+}
+
+size_t SizeClassOf(size_t size) {
+  size_t size_class = 0;
+  while (MemoryPool::class_block_size(size_class) < size) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+}  // namespace
+
+TEST(MemoryPoolTest, Allocate_AnySize_BlockIsAlignedAndWritable) {
+  const size_t sizes[] = {1, 64, 65, 1500, 4096, 65536, 1048576, 2000000};
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i) {
+    uint8_t* block = static_cast<uint8_t*>(MemoryPool::Allocate(sizes[i]));
+    ASSERT_TRUE(NULL != block);
+    EXPECT_EQ(0u, reinterpret_cast<size_t>(block) % 16);
+    memset(block, 0xAB, sizes[i]);
+    MemoryPool::Release(block);
+  }
+}
+
+TEST(MemoryPoolTest, Release_Null_Ignored) {
+  MemoryPool::Release(NULL);
+}
+
+TEST(MemoryPoolTest, ReleaseThenAllocate_SameThread_BlockReusedFromCache) {
+  const size_t size_class = SizeClassOf(kPacketSize);
+  void* first = MemoryPool::Allocate(kPacketSize);
+  MemoryPool::Release(first);
+  const MemoryPool::Statistics before = MemoryPool::statistics(size_class);
+
+  void* second = MemoryPool::Allocate(kPacketSize);
+  const MemoryPool::Statistics after = MemoryPool::statistics(size_class);
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(before.allocations + 1, after.allocations);
+  EXPECT_EQ(before.thread_cache_hits + 1, after.thread_cache_hits);
+  EXPECT_EQ(before.system_allocations, after.system_allocations);
+  MemoryPool::Release(second);
+}
+
+TEST(MemoryPoolTest, ReleaseOnOtherThread_AfterThreadExit_BlocksReused) {
+  const size_t kBlocksCount = 16;
+  const size_t size = 40000;
+  const size_t size_class = SizeClassOf(size);
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < kBlocksCount; ++i) {
+    blocks.push_back(MemoryPool::Allocate(size));
+  }
+
+  pthread_t thread;
+  ASSERT_EQ(0, pthread_create(&thread, NULL, &ReleaseBlocks, &blocks));
+  ASSERT_EQ(0, pthread_join(thread, NULL));
+
+  // Exited thread hands its cached blocks to the shared list
+  const MemoryPool::Statistics before = MemoryPool::statistics(size_class);
+  std::vector<void*> reused;
+  for (size_t i = 0; i < kBlocksCount; ++i) {
+    reused.push_back(MemoryPool::Allocate(size));
+  }
+  const MemoryPool::Statistics after = MemoryPool::statistics(size_class);
+
+  EXPECT_LT(before.shared_hits, after.shared_hits);
+  EXPECT_GT(before.system_allocations + kBlocksCount,
+            after.system_allocations);
+  ReleaseBlocks(&reused);
+}
+
+TEST(MemoryPoolTest, Allocate_Oversized_BypassesPool) {
+  const MemoryPool::Statistics before = MemoryPool::oversized_statistics();
+  void* block = MemoryPool::Allocate(
+      MemoryPool::class_block_size(MemoryPool::size_classes_count() - 1) + 1);
+  MemoryPool::Release(block);
+  const MemoryPool::Statistics after = MemoryPool::oversized_statistics();
+
+  EXPECT_EQ(before.allocations + 1, after.allocations);
+  EXPECT_EQ(before.system_allocations + 1, after.system_allocations);
+  EXPECT_EQ(before.releases + 1, after.releases);
+  EXPECT_EQ(0.0, after.hit_rate());
+}
+
+TEST(MemoryPoolTest, PooledObject_NewDelete_ServedByPool) {
+  const size_t size_class = SizeClassOf(sizeof(PooledPacket));
+  delete new PooledPacket();
+  const MemoryPool::Statistics before = MemoryPool::statistics(size_class);
+
+  PooledPacket* packet = new PooledPacket();
+  packet->size = kPacketSize;
+  delete packet;
+  const MemoryPool::Statistics after = MemoryPool::statistics(size_class);
+
+  EXPECT_EQ(before.thread_cache_hits + 1, after.thread_cache_hits);
+  EXPECT_EQ(before.releases + 1, after.releases);
+  EXPECT_LT(0.0, after.hit_rate());
+}
+
+TEST(MemoryPoolTest, ReleaseObjectThenAllocate_SameSize_BlockReused) {
+  const size_t size = 100;
+  const size_t object_class = ObjectClassOf(size);
+  EXPECT_EQ(112u, MemoryPool::object_class_size(object_class));
+  void* first = MemoryPool::AllocateObject(size);
+  ASSERT_TRUE(NULL != first);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(first) % 16);
+  MemoryPool::ReleaseObject(first, size);
+  const MemoryPool::Statistics before =
+      MemoryPool::object_statistics(object_class);
+
+  void* second = MemoryPool::AllocateObject(size);
+  const MemoryPool::Statistics after =
+      MemoryPool::object_statistics(object_class);
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(before.thread_cache_hits + 1, after.thread_cache_hits);
+  EXPECT_EQ(before.system_allocations, after.system_allocations);
+  MemoryPool::ReleaseObject(second, size);
+}
+
+TEST(MemoryPoolTest, AllocateObject_BiggerThanObjectClasses_UsesSizeClass) {
+  const size_t size = MemoryPool::object_class_size(
+      MemoryPool::object_classes_count() - 1) + 1;
+  const size_t size_class = SizeClassOf(size);
+  const MemoryPool::Statistics before = MemoryPool::statistics(size_class);
+  void* object = MemoryPool::AllocateObject(size);
+  MemoryPool::ReleaseObject(object, size);
+  const MemoryPool::Statistics after = MemoryPool::statistics(size_class);
+
+  EXPECT_EQ(before.allocations + 1, after.allocations);
+  EXPECT_EQ(before.releases + 1, after.releases);
+}
+
+TEST(MemoryPoolTest, SizedPooledObject_DeleteThroughBase_ReleasedBySize) {
+  const size_t object_class = ObjectClassOf(sizeof(SizedDerived));
+  ASSERT_NE(ObjectClassOf(sizeof(SizedBase)), object_class);
+  const MemoryPool::Statistics before =
+      MemoryPool::object_statistics(object_class);
+
+  SizedBase* object = new SizedDerived();
+  delete object;
+  const MemoryPool::Statistics after =
+      MemoryPool::object_statistics(object_class);
+
+  EXPECT_EQ(before.allocations + 1, after.allocations);
+  EXPECT_EQ(before.releases + 1, after.releases);
+}
+
+TEST(MemoryPoolTest, DISABLED_Benchmark_PacketBuffersChurn) {
+  const size_t kIterations = 200000;
+  const size_t kInFlight = 32;
+  std::vector<void*> in_flight(kInFlight, static_cast<void*>(NULL));
+
+  TimevalStruct start = date_time::DateTime::getCurrentTime();
+  for (size_t i = 0; i < kIterations; ++i) {
+    uint8_t*& slot = reinterpret_cast<uint8_t*&>(in_flight[i % kInFlight]);
+    delete[] slot;
+    slot = new uint8_t[kPacketSize];
+    slot[0] = static_cast<uint8_t>(i);
+  }
+  const int64_t heap_ms = date_time::DateTime::calculateTimeSpan(start);
+  for (size_t i = 0; i < kInFlight; ++i) {
+    delete[] static_cast<uint8_t*>(in_flight[i]);
+    in_flight[i] = NULL;
+  }
+
+  start = date_time::DateTime::getCurrentTime();
+  for (size_t i = 0; i < kIterations; ++i) {
+    void*& slot = in_flight[i % kInFlight];
+    MemoryPool::Release(slot);
+    slot = MemoryPool::Allocate(kPacketSize);
+    static_cast<uint8_t*>(slot)[0] = static_cast<uint8_t>(i);
+  }
+  const int64_t pool_ms = date_time::DateTime::calculateTimeSpan(start);
+  ReleaseBlocks(&in_flight);
+
+  const MemoryPool::Statistics stats =
+      MemoryPool::statistics(SizeClassOf(kPacketSize));
+  printf("%u packet buffers: heap %lld ms, pool %lld ms, hit rate %.3f\n",
+         static_cast<unsigned>(kIterations), static_cast<long long>(heap_ms),
+         static_cast<long long>(pool_ms), stats.hit_rate());
+  EXPECT_LT(0.9, stats.hit_rate());
+}
+
+}  // namespace utils
+}  // namespace components
+}  // namespace test
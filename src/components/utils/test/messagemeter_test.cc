@@ -31,6 +31,8 @@
 */
 
 #include <unistd.h>
+#include <algorithm>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -274,6 +276,37 @@ TEST_P(MessageMeterTest, ClearIds) {
             meter.Frequency(id3));
 }
 
+TEST(MessageMeterTest, ClearIdentifiers_TrackedAgain_CountedFromScratch) {
+  ::utils::MessageMeter<int> meter;
+  const int id = 1;
+  EXPECT_EQ(1u, meter.TrackMessage(id));
+  EXPECT_EQ(2u, meter.TrackMessage(id));
+  meter.ClearIdentifiers();
+  EXPECT_EQ(0u, meter.Frequency(id));
+  EXPECT_EQ(1u, meter.TrackMessage(id));
+}
+
+TEST(MessageMeterTest, TrackMessage_32ConnectionKeys_CountedSeparately) {
+  const int kKeysCount = 32;
+  const size_t kMessagesCount = 10000;
+  ::utils::MessageMeter<uint32_t> meter;
+  // Nothing expires during the test
+  meter.set_time_range(3600u * date_time::DateTime::MILLISECONDS_IN_SECOND);
+  std::vector<size_t> expected(kKeysCount, 0u);
+
+  for (size_t round = 0; round < 3; ++round) {
+    meter.ClearIdentifiers();
+    std::fill(expected.begin(), expected.end(), 0u);
+    for (size_t i = 0; i < kMessagesCount; ++i) {
+      const uint32_t key = i % kKeysCount;
+      ASSERT_EQ(++expected[key], meter.TrackMessage(key));
+    }
+  }
+  for (int key = 0; key < kKeysCount; ++key) {
+    EXPECT_EQ(expected[key], meter.Frequency(key));
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(MessageMeterTestCase,
                         MessageMeterTest,
                         ::testing::ValuesIn(testing_time_pairs));
@@ -0,0 +1,112 @@
+"""
+Generator application that generates command table of application manager
+command factory from xml description and command map
+
+usage: CommandTableGenerator.py [-h] --parser-type {sdlrpcv2,jsonrpc}
+                                source-xml namespace command-map output-file
+
+Command table generator
+
+positional arguments:
+  source-xml
+  namespace
+  command-map
+  output-file
+
+optional arguments:
+  -h, --help            show this help message and exit
+  --parser-type {sdlrpcv2,jsonrpc}
+"""
+
+import os.path
+import argparse
+import errno
+import sys
+
+import generator.parsers.SDLRPCV2
+import generator.parsers.JSONRPC
+import generator.generators.CommandTable
+
+from generator.parsers.RPCBase import ParseError
+from generator.generators.CommandTable import GenerateError
+
+SUPPORTED_FORMATS = {
+    "sdlrpcv2": generator.parsers.SDLRPCV2.Parser,
+    "jsonrpc": generator.parsers.JSONRPC.Parser
+}
+
+
+def _create_parser():
+    """Create parser for parsing command-line arguments.
+
+    Returns an instance of argparse.ArgumentParser
+
+    """
+
+    parser = argparse.ArgumentParser(
+        description="Command table generator"
+    )
+    parser.add_argument("source-xml")
+    parser.add_argument("namespace")
+    parser.add_argument("command-map")
+    parser.add_argument("output-file")
+    parser.add_argument("--parser-type",
+                        choices=SUPPORTED_FORMATS.keys(),
+                        required=True)
+    return parser
+
+
+def _handle_fatal_error(error):
+    """Handle fatal error during parsing or code generation.
+
+    Keyword arguments:
+    error -- base exception to handle.
+
+    """
+
+    print(error.message)
+    print
+    sys.exit(errno.EINVAL)
+
+
+def main():
+    """Main function of the generator that does actual work."""
+
+    args = vars(_create_parser().parse_args())
+
+    src_xml = args["source-xml"]
+    command_map = args["command-map"]
+    output_file = args["output-file"]
+
+    print("""
+Generating command table with following parameters:
+    Source xml      : {0}
+    Namespace       : {1}
+    Command map     : {2}
+    Output file     : {3}
+""".format(src_xml, args["namespace"], command_map, output_file))
+
+    parser = SUPPORTED_FORMATS[args["parser_type"]]()
+    code_generator = generator.generators.CommandTable.CodeGenerator()
+
+    # Convert incoming xml to internal model
+    try:
+        interface = parser.parse(src_xml)
+    except ParseError as error:
+        _handle_fatal_error(error)
+
+    # Generate command table from internal model and command map
+    try:
+        code_generator.generate(
+            interface,
+            generator.generators.CommandTable.parse_command_map(command_map),
+            os.path.basename(src_xml),
+            args["namespace"],
+            output_file)
+    except GenerateError as error:
+        _handle_fatal_error(error)
+
+    print("Done.")
+
+if __name__ == '__main__':
+    main()
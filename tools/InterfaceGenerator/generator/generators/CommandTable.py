@@ -0,0 +1,292 @@
+"""Command table code generator.
+
+Generates table of commands which command factory of application manager
+creates for functions of the interface. Command of every function and
+message type is taken from command map.
+
+Command map is a text file. Every line of it has function name pattern,
+message type and command class separated by spaces. Lines starting with '#'
+and empty lines are skipped. Function name is the name used in the xml,
+prefixed with interface name and '.' for JSON RPC: "UI.AddCommand". Pattern
+can contain shell-style wildcards. Message type is "request", "response",
+"notification" or "other". Command class can contain placeholders {name}
+for function name without interface and {function_id} for function id enum
+element. Class "-" means that function has no command for message type.
+
+First matching line gives command of a function, so exceptions go before
+wildcards. Messages of other types than request and response use command of
+notification or of request, unless command of "other" type is given.
+
+"""
+import codecs
+import fnmatch
+import os
+import string
+
+
+class GenerateError(Exception):
+
+    """Generate error.
+
+    This exception is raised when generator is unable to create command table
+    from given model and command map.
+
+    """
+
+    pass
+
+
+class CommandMapEntry(object):
+
+    """Command map entry.
+
+    Instance variables:
+    pattern -- function name pattern
+    message_type -- message type
+    command -- command class or None if function has no command
+
+    """
+
+    def __init__(self, pattern, message_type, command):
+        self.pattern = pattern
+        self.message_type = message_type
+        self.command = command
+
+
+MESSAGE_TYPES = ("request", "response", "notification", "other")
+
+
+def parse_command_map(file_name):
+    """Parse command map file.
+
+    Keyword arguments:
+    file_name -- name of command map file.
+
+    Returns list of CommandMapEntry in order of the file.
+
+    """
+
+    entries = []
+    with codecs.open(file_name, encoding="utf-8", mode="r") as f_map:
+        for number, line in enumerate(f_map, 1):
+            line = line.strip()
+            if not line or line.startswith(u"#"):
+                continue
+            fields = line.split()
+            if len(fields) != 3:
+                raise GenerateError(
+                    "{0}:{1}: expected function, message type and command, "
+                    "got '{2}'".format(file_name, number, line))
+            if fields[1] not in MESSAGE_TYPES:
+                raise GenerateError(
+                    "{0}:{1}: unknown message type '{2}'".format(
+                        file_name, number, fields[1]))
+            command = None if fields[2] == u"-" else fields[2]
+            entries.append(CommandMapEntry(fields[0], fields[1], command))
+    return entries
+
+
+class CodeGenerator(object):
+
+    """Command table generator.
+
+    Generates header file with table of commands for functions of given
+    interface model. Rows of the table are ordered by function id and
+    grouped into ranges of consecutive function ids.
+
+    """
+
+    def generate(self, interface, command_map, filename, namespace,
+                 destination_file):
+        """Generate command table header.
+
+        Keyword arguments:
+        interface -- model of the interface to generate table for.
+        command_map -- list of CommandMapEntry.
+        filename -- name of initial XML file.
+        namespace -- namespace of generated interface enums.
+        destination_file -- header file to create.
+
+        """
+
+        if interface is None:
+            raise GenerateError("Given interface is None.")
+        if "FunctionID" not in interface.enums:
+            raise GenerateError("Interface has no FunctionID enum.")
+
+        functions = {}
+        for function in interface.functions.values():
+            functions.setdefault(function.function_id.primary_name,
+                                 []).append(function)
+
+        rows = []
+        ranges = []
+        value = -1
+        for element in interface.enums["FunctionID"].elements.values():
+            value = element.value if element.value is not None else value + 1
+            if not ranges or ranges[-1][1] + ranges[-1][2] != value:
+                ranges.append([element.primary_name, value, 0, len(rows)])
+            ranges[-1][2] += 1
+            rows.append(self._gen_row(
+                element, functions.get(element.primary_name, []),
+                command_map, namespace))
+
+        ranges_code = u"\n".join(
+            [self._range_template.substitute(
+                namespace=namespace, function_id=first_id, first_row=first_row,
+                size=size)
+             for first_id, _, size, first_row in ranges])
+
+        guard = u"SRC_COMPONENTS_APPLICATION_MANAGER_{0}_".format(
+            os.path.basename(destination_file).upper().replace(u".", u"_"))
+
+        destination_dir = os.path.dirname(destination_file)
+        if destination_dir and not os.path.exists(destination_dir):
+            os.makedirs(destination_dir)
+
+        with codecs.open(destination_file, encoding="utf-8",
+                         mode="w") as f_h:
+            f_h.write(self._h_file_template.substitute(
+                guard=guard,
+                xml_file=filename,
+                namespace=namespace,
+                rows=u"\n".join(rows),
+                ranges=ranges_code))
+
+    def _gen_row(self, element, functions, command_map, namespace):
+        """Generate table row of a function id.
+
+        Keyword arguments:
+        element -- element of FunctionID enum.
+        functions -- functions of the interface with this function id.
+        command_map -- list of CommandMapEntry.
+        namespace -- namespace of generated interface enums.
+
+        Returns string with row initializer.
+
+        """
+
+        commands = {}
+        for function in functions:
+            commands[function.message_type.name] = self._find_command(
+                function, function.message_type.name, command_map)
+
+        notification = commands.get("notification")
+        request = commands.get("request", notification)
+        response = commands.get("response", notification)
+        other = notification if "notification" in commands else request
+        if functions:
+            entry = self._find_entry(functions[0], "other", command_map)
+            if entry is not None:
+                other = self._format_command(functions[0], entry.command)
+
+        return self._row_template.substitute(
+            namespace=namespace,
+            function_id=element.primary_name,
+            request=self._gen_creator(request),
+            response=self._gen_creator(response),
+            other=self._gen_creator(other))
+
+    @staticmethod
+    def _function_names(function):
+        """Provide full and short name of function.
+
+        Returns tuple of the name used in command map and the name without
+        interface.
+
+        """
+
+        if function.function_id.internal_name is not None:
+            full_name = function.function_id.name
+        else:
+            full_name = function.name
+        return full_name, full_name.split(u".", 1)[-1]
+
+    def _find_entry(self, function, message_type, command_map):
+        """Find first command map entry matching function and message type.
+
+        Returns CommandMapEntry or None.
+
+        """
+
+        full_name = self._function_names(function)[0]
+        for entry in command_map:
+            if entry.message_type == message_type and \
+                    fnmatch.fnmatchcase(full_name, entry.pattern):
+                return entry
+        return None
+
+    def _find_command(self, function, message_type, command_map):
+        """Find command class of function for message type.
+
+        Returns command class or None if function has no command.
+
+        """
+
+        entry = self._find_entry(function, message_type, command_map)
+        if entry is None:
+            raise GenerateError(
+                "No command for {0} {1} in command map".format(
+                    self._function_names(function)[0], message_type))
+        return self._format_command(function, entry.command)
+
+    def _format_command(self, function, command):
+        """Substitute placeholders of command class.
+
+        Returns command class or None.
+
+        """
+
+        if command is None:
+            return None
+        return command.format(
+            name=self._function_names(function)[1],
+            function_id=function.function_id.primary_name)
+
+    @staticmethod
+    def _gen_creator(command):
+        """Generate command creator of table row.
+
+        Returns pointer to creator function or NULL.
+
+        """
+
+        if command is None:
+            return u"NULL"
+        return u"&NewCommand<{0} >".format(command) if command.endswith(
+            u">") else u"&NewCommand<{0}>".format(command)
+
+    _row_template = string.Template(
+        u'''  {${namespace}::FunctionID::${function_id},\n'''
+        u'''   ${request},\n'''
+        u'''   ${response},\n'''
+        u'''   ${other}},''')
+
+    _range_template = string.Template(
+        u'''  {${namespace}::FunctionID::${function_id}, '''
+        u'''&kFunctionCommands[${first_row}], ${size}},''')
+
+    _h_file_template = string.Template(
+        u'''// This file is generated from ${xml_file}\n'''
+        u'''// by CommandTableGenerator.py, do not edit\n'''
+        u'''#ifndef ${guard}\n'''
+        u'''#define ${guard}\n'''
+        u'''\n'''
+        u'''#include "application_manager/command_table.h"\n'''
+        u'''\n'''
+        u'''// Included by command factory after headers of the commands\n'''
+        u'''namespace application_manager {\n'''
+        u'''namespace {\n'''
+        u'''\n'''
+        u'''const FunctionCommands kFunctionCommands[] = {\n'''
+        u'''${rows}\n'''
+        u'''};\n'''
+        u'''\n'''
+        u'''const FunctionCommandsRange kFunctionCommandsRanges[] = {\n'''
+        u'''${ranges}\n'''
+        u'''};\n'''
+        u'''\n'''
+        u'''}  // namespace\n'''
+        u'''}  // namespace application_manager\n'''
+        u'''\n'''
+        u'''#endif  // ${guard}\n''')
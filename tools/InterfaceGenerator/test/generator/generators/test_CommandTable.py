@@ -0,0 +1,163 @@
+"""Test for command table generator.
+
+Verifies command map parsing and produced table.
+
+"""
+import codecs
+import collections
+import os
+import shutil
+import tempfile
+import unittest
+
+from generator.generators import CommandTable
+from generator import Model
+
+
+COMMAND_MAP = u"""# Comment
+
+Test.Special  request       commands::SpecialRequestCommand
+Test.Special  response      -
+Test.Template request       commands::Template<ns::FunctionID::{function_id}>
+Test.*        request       commands::{name}Request
+Test.*        response      commands::{name}Response
+Test.Remote   other         commands::RemoteOther
+*             notification  commands::{name}Notification
+"""
+
+EXPECTED_TABLE = u"""// This file is generated from test.xml
+// by CommandTableGenerator.py, do not edit
+#ifndef SRC_COMPONENTS_APPLICATION_MANAGER_TABLE_H_
+#define SRC_COMPONENTS_APPLICATION_MANAGER_TABLE_H_
+
+#include "application_manager/command_table.h"
+
+// Included by command factory after headers of the commands
+namespace application_manager {
+namespace {
+
+const FunctionCommands kFunctionCommands[] = {
+  {ns::FunctionID::Test_Special,
+   &NewCommand<commands::SpecialRequestCommand>,
+   NULL,
+   &NewCommand<commands::SpecialRequestCommand>},
+  {ns::FunctionID::Test_Template,
+   &NewCommand<commands::Template<ns::FunctionID::Test_Template> >,
+   &NewCommand<commands::TemplateResponse>,
+   &NewCommand<commands::Template<ns::FunctionID::Test_Template> >},
+  {ns::FunctionID::Test_OnEvent,
+   &NewCommand<commands::OnEventNotification>,
+   &NewCommand<commands::OnEventNotification>,
+   &NewCommand<commands::OnEventNotification>},
+  {ns::FunctionID::Test_Remote,
+   &NewCommand<commands::RemoteRequest>,
+   &NewCommand<commands::RemoteResponse>,
+   &NewCommand<commands::RemoteOther>},
+  {ns::FunctionID::Test_Unused,
+   NULL,
+   NULL,
+   NULL},
+};
+
+const FunctionCommandsRange kFunctionCommandsRanges[] = {
+  {ns::FunctionID::Test_Special, &kFunctionCommands[0], 3},
+  {ns::FunctionID::Test_Remote, &kFunctionCommands[3], 2},
+};
+
+}  // namespace
+}  // namespace application_manager
+
+#endif  // SRC_COMPONENTS_APPLICATION_MANAGER_TABLE_H_
+"""
+
+
+class Test(unittest.TestCase):
+
+    """Test for command table generator.
+
+    This class holds tests for command map parsing and generated table.
+
+    """
+
+    def setUp(self):
+        """Create temporary directory for map and table files."""
+        self.tmp_dir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        """Remove temporary directory."""
+        shutil.rmtree(self.tmp_dir)
+
+    def _write_map(self, content):
+        """Write command map to temporary file and return its name."""
+        file_name = os.path.join(self.tmp_dir, "test.map")
+        with codecs.open(file_name, encoding="utf-8", mode="w") as f_map:
+            f_map.write(content)
+        return file_name
+
+    def test_parse_command_map(self):
+        """Test parsing of command map."""
+        entries = CommandTable.parse_command_map(
+            self._write_map(COMMAND_MAP))
+
+        self.assertEqual(len(entries), 7)
+        self.assertEqual(entries[0].pattern, u"Test.Special")
+        self.assertEqual(entries[0].message_type, u"request")
+        self.assertEqual(entries[0].command,
+                         u"commands::SpecialRequestCommand")
+        self.assertIsNone(entries[1].command)
+        self.assertEqual(entries[5].message_type, u"other")
+
+    def test_parse_command_map_errors(self):
+        """Test parsing of invalid command map."""
+        self.assertRaises(
+            CommandTable.GenerateError, CommandTable.parse_command_map,
+            self._write_map(u"Test.* request\n"))
+        self.assertRaises(
+            CommandTable.GenerateError, CommandTable.parse_command_map,
+            self._write_map(u"Test.* event commands::Event\n"))
+
+    def test_generate(self):
+        """Test generation of command table."""
+        function_id = Model.Enum(name=u"FunctionID")
+        message_type = Model.Enum(name=u"messageType")
+        for name in [u"request", u"response", u"notification"]:
+            message_type.elements[name] = Model.EnumElement(name=name)
+        for name, value in [(u"Special", 1), (u"Template", 2),
+                            (u"OnEvent", 3), (u"Remote", 10),
+                            (u"Unused", 11)]:
+            function_id.elements[u"Test." + name] = Model.EnumElement(
+                name=u"Test." + name, internal_name=u"Test_" + name,
+                value=value)
+
+        functions = collections.OrderedDict()
+        for name, types in [(u"Special", [u"request", u"response"]),
+                            (u"Template", [u"request", u"response"]),
+                            (u"OnEvent", [u"notification"]),
+                            (u"Remote", [u"request", u"response"])]:
+            for type_name in types:
+                functions[(name, type_name)] = Model.Function(
+                    name=name,
+                    function_id=function_id.elements[u"Test." + name],
+                    message_type=message_type.elements[type_name])
+
+        interface = Model.Interface(
+            enums=collections.OrderedDict([(u"FunctionID", function_id),
+                                           (u"messageType", message_type)]),
+            functions=functions)
+
+        command_map = CommandTable.parse_command_map(
+            self._write_map(COMMAND_MAP))
+        table_file = os.path.join(self.tmp_dir, "table.h")
+        CommandTable.CodeGenerator().generate(
+            interface, command_map, "test.xml", "ns", table_file)
+
+        with codecs.open(table_file, encoding="utf-8", mode="r") as f_h:
+            self.assertMultiLineEqual(f_h.read(), EXPECTED_TABLE)
+
+        self.assertRaises(
+            CommandTable.GenerateError,
+            CommandTable.CodeGenerator().generate,
+            interface, command_map[:3], "test.xml", "ns", table_file)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include "policy_table/table_struct/types.h"
+#include "policy/preloaded_pt_image.h"
+
+#include "rpc_base/json_stream_reader.h"
+#include "utils/file_system.h"
+
+namespace policy_table = rpc::policy_table_interface_base;
+
+enum ResultCode {
+  SUCCES = 0,
+  MISSED_FILE_NAME,
+  READ_ERROR,
+  PARSE_ERROR,
+  VALIDATION_ERROR,
+  WRITE_ERROR
+};
+
+void help() {
+  std::cout << "Usage:" << std::endl <<
+               "./policyCompiler {preloaded_pt_file} [image_file]" << std::endl;
+  std::cout << "Validates preloaded policy table and writes its image, "
+               "by default next to the preloaded file, e.g. "
+               "sdl_preloaded_pt.img for sdl_preloaded_pt.json" << std::endl;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2 && argc != 3) {
+    help();
+    exit(MISSED_FILE_NAME);
+  }
+  const std::string file_name = argv[1];
+  const std::string image_file_name = argc == 3 ?
+      argv[2] : policy::PreloadedPTImage::ImageFileName(file_name);
+
+  policy::BinaryMessage json_string;
+  if (!file_system::ReadBinaryFile(file_name, json_string) ||
+      json_string.empty()) {
+    std::cout << "Read file error: " << file_name << std::endl;
+    exit(READ_ERROR);
+  }
+
+  const char* json = reinterpret_cast<const char*>(&json_string[0]);
+  rpc::JsonStreamReader reader(json, json + json_string.size());
+  policy_table::Table table(&reader);
+  if (reader.has_failed()) {
+    std::cout << "Json parse fails: " << reader.error() << " at "
+              << reader.error_offset() << std::endl;
+    exit(PARSE_ERROR);
+  }
+
+  // Image is used without validation, so the table has to pass both the
+  // check made for preloaded PT file on start and the one of its type
+  bool is_valid = table.is_valid();
+  if (is_valid) {
+    table.SetPolicyTableType(policy_table::PT_PRELOADED);
+    is_valid = table.is_valid();
+  }
+  if (!is_valid) {
+    std::cout << "Table is not valid" << std::endl;
+    rpc::ValidationReport report("policy_table");
+    table.ReportErrors(&report);
+    std::cout << "Errors: " << std::endl << rpc::PrettyFormat(report)
+              << std::endl;
+    exit(VALIDATION_ERROR);
+  }
+
+  if (!policy::PreloadedPTImage::Write(table, json_string, image_file_name)) {
+    std::cout << "Write file error: " << image_file_name << std::endl;
+    exit(WRITE_ERROR);
+  }
+  std::cout << "Image is written to " << image_file_name << std::endl;
+  return SUCCES;
+}
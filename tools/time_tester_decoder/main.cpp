@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2014, Ford Motor Company
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ * Neither the name of the Ford Motor Company nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "metric_record.h"
+#include "json_keys.h"
+
+namespace {
+
+enum ResultCode {
+  SUCCES = 0,
+  MISSED_FILE_NAME,
+  READ_ERROR,
+  FORMAT_ERROR
+};
+
+using time_tester::MetricRecord;
+namespace strings = time_tester::strings;
+
+void help() {
+  std::cout << "Usage:" << std::endl <<
+               "./timeTesterDecoder [--json] {capture_file}" << std::endl;
+  std::cout << "Converts binary TimeTester capture to CSV "
+               "(default) or JSON lines" << std::endl;
+}
+
+const char* LoggerName(uint8_t type) {
+  switch (type) {
+    case MetricRecord::kApplicationManager:
+      return "ApplicationManager";
+    case MetricRecord::kTransportManager:
+      return "TransportManager";
+    case MetricRecord::kProtocolHandler:
+      return "ProtocolHandler";
+    case MetricRecord::kResources:
+      return "Resources";
+    default:
+      return "Unknown";
+  }
+}
+
+void PrintCsvHeader() {
+  std::cout << strings::logger << ',' << strings::begin << ','
+            << strings::end << ",id," << strings::connection_key << ','
+            << strings::data_size << ',' << strings::utime << ','
+            << strings::stime << ',' << strings::memory << ",dropped"
+            << std::endl;
+}
+
+void PrintCsv(const MetricRecord& record) {
+  std::cout << LoggerName(record.type) << ',' << record.begin << ','
+            << record.end << ',' << record.id << ','
+            << record.connection_key << ',' << record.data_size << ','
+            << record.utime << ',' << record.stime << ','
+            << record.memory << ',' << record.dropped << std::endl;
+}
+
+void PrintJson(const MetricRecord& record) {
+  std::cout << "{\"" << strings::logger << "\":\""
+            << LoggerName(record.type) << "\",\""
+            << strings::begin << "\":" << record.begin;
+  switch (record.type) {
+    case MetricRecord::kApplicationManager:
+      std::cout << ",\"" << strings::end << "\":" << record.end
+                << ",\"" << strings::correlation_id << "\":" << record.id
+                << ",\"" << strings::connection_key << "\":"
+                << record.connection_key;
+      break;
+    case MetricRecord::kTransportManager:
+      std::cout << ",\"" << strings::end << "\":" << record.end
+                << ",\"" << strings::data_size << "\":" << record.data_size;
+      break;
+    case MetricRecord::kProtocolHandler:
+      std::cout << ",\"" << strings::end << "\":" << record.end
+                << ",\"" << strings::message_id << "\":" << record.id
+                << ",\"" << strings::connection_key << "\":"
+                << record.connection_key;
+      break;
+    case MetricRecord::kResources:
+      std::cout << ",\"" << strings::utime << "\":" << record.utime
+                << ",\"" << strings::stime << "\":" << record.stime
+                << ",\"" << strings::memory << "\":" << record.memory
+                << ",\"dropped\":" << record.dropped;
+      break;
+    default:
+      break;
+  }
+  std::cout << '}' << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    help();
+    exit(MISSED_FILE_NAME);
+  }
+  const bool json_output = (3 == argc) && (std::string("--json") == argv[1]);
+  const std::string file_name = argv[argc - 1];
+
+  std::ifstream file(file_name.c_str(), std::ios::binary);
+  if (!file.is_open()) {
+    std::cout << "Read file error: " << file_name << std::endl;
+    exit(READ_ERROR);
+  }
+  const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                                  std::istreambuf_iterator<char>());
+  if (data.empty()) {
+    std::cout << "Empty capture: " << file_name << std::endl;
+    exit(FORMAT_ERROR);
+  }
+
+  time_tester::MetricRecordReader reader(&data[0], data.size());
+  if (!reader.ReadHeader()) {
+    std::cout << "Not a TimeTester capture: " << file_name << std::endl;
+    exit(FORMAT_ERROR);
+  }
+  if (!json_output) {
+    PrintCsvHeader();
+  }
+  MetricRecord record;
+  while (reader.Read(&record)) {
+    if (json_output) {
+      PrintJson(record);
+    } else {
+      PrintCsv(record);
+    }
+  }
+  if (reader.is_failed()) {
+    std::cerr << "Capture is truncated or corrupted" << std::endl;
+    return FORMAT_ERROR;
+  }
+  return SUCCES;
+}